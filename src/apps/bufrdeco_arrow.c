@@ -0,0 +1,283 @@
+/***************************************************************************
+ *   Copyright (C) 2013-2026 by Guillermo Ballester Valor                  *
+ *   gbv@ogimet.com                                                        *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.             *
+ ***************************************************************************/
+/*! \file bufrdeco_arrow.c
+    \brief This file includes the code to export the decoded subsets of BUFR files as an Apache Arrow IPC stream
+
+    Every subset is a row, with the index of message and subset and a column for every selected descriptor. The
+    stream can be read by any Arrow implementation, as pyarrow.ipc.open_stream(), without parsing text
+*/
+#ifndef CONFIG_H
+#include "config.h"
+#define CONFIG_H
+#endif
+
+#include <dirent.h>
+#include "bufrdeco.h"
+
+struct bufrdeco BUFR; /*!< The decoder */
+struct bufrdeco_arrow_writer ARROW; /*!< The writer of stream */
+char BUFRTABLES_DIR[BUFRDECO_PATH_LENGTH]; /*!< Directory for BUFR tables set by user */
+char LISTOFFILES[BUFRDECO_PATH_LENGTH]; /*!< Pathname of a file with a list of files */
+char OUTPUTFILE[BUFRDECO_PATH_LENGTH]; /*!< Pathname of output file. Empty for stdout */
+char *COLUMNS; /*!< List of descriptors to export. NULL for all the data of first subset */
+buf_t BATCH_ROWS; /*!< Rows of every record batch */
+uint64_t MESSAGES; /*!< Messages exported */
+uint64_t ERRORS; /*!< Messages which could not be decoded */
+
+/*!
+  \fn void print_usage(void)
+  \brief Print usage help message to stdout
+*/
+void print_usage ( void )
+{
+  printf ( "Usage: \n" );
+  printf ( "bufrdeco_arrow [-t bufrtable_dir] [-d descriptors] [-o output] [-n rows] [-I list_of_files] [-h] file_or_dir [file_or_dir ...]\n" );
+  printf ( "   -d descriptors. Columns to export, separated by commas, as '001001,001002,012101'. A suffix '_n'\n" );
+  printf ( "      selects the n-th occurrence in subset, as '007004_2'. Default is every data of the first subset\n" );
+  printf ( "   -h Print this help\n" );
+  printf ( "   -I list_of_files. Pathname of a file with the list of files to export, one filename per line\n" );
+  printf ( "   -n rows. Rows of every record batch. Default is %u\n", BUFRDECO_ARROW_BATCH_ROWS );
+  printf ( "   -o output. Pathname of Arrow IPC stream. Default is stdout\n" );
+  printf ( "   -t bufrtable_dir. Pathname of bufr tables directory. Ended with '/'\n" );
+  printf ( "   Every directory in arguments adds all its regular files\n" );
+}
+
+/*!
+  \fn int read_args( int _argc, char * _argv[])
+  \brief read the arguments from stdio
+  \param [in] _argc number of arguments passed
+  \param [in] _argv array of arguments
+
+  Returns 1 if succcess, -1 othewise
+*/
+int read_args ( int _argc, char * _argv[] )
+{
+  int iopt;
+
+  // Default values
+  BUFRTABLES_DIR[0] = '\0';
+  LISTOFFILES[0] = '\0';
+  OUTPUTFILE[0] = '\0';
+  COLUMNS = NULL;
+  BATCH_ROWS = BUFRDECO_ARROW_BATCH_ROWS;
+
+  while ( ( iopt = getopt ( _argc, _argv, "d:hI:n:o:t:" ) ) !=-1 )
+    switch ( iopt )
+      {
+      case 'd':
+        COLUMNS = optarg;
+        break;
+
+      case 'I':
+        if ( strlen ( optarg ) < BUFRDECO_PATH_LENGTH )
+          strcpy ( LISTOFFILES, optarg );
+        break;
+
+      case 'n':
+        if ( atoi ( optarg ) > 0 )
+          BATCH_ROWS = ( buf_t ) atoi ( optarg );
+        break;
+
+      case 'o':
+        if ( strlen ( optarg ) < BUFRDECO_PATH_LENGTH )
+          strcpy ( OUTPUTFILE, optarg );
+        break;
+
+      case 't':
+        if ( strlen ( optarg ) < BUFRDECO_PATH_LENGTH )
+          {
+            strcpy ( BUFRTABLES_DIR, optarg );
+          }
+        break;
+
+      case 'h':
+      default:
+        print_usage();
+        exit ( EXIT_SUCCESS );
+      }
+
+  if ( LISTOFFILES[0] == '\0' && optind >= _argc )
+    {
+      printf ( "read_args(): No input. Use -I option or add files or directories as arguments\n" );
+      return -1;
+    }
+  return 1;
+}
+
+/*!
+  \fn void export_file(const char *path)
+  \brief Export the subsets of every BUFR message in a file
+  \param [in] path pathname of file
+
+  A file can have several messages, maybe with GTS headers among them. Every sequence of bytes from 'BUFR' with the
+  length declared in sec0 and ending with '7777' is a message.
+*/
+void export_file ( const char *path )
+{
+  FILE *fp;
+  struct stat st;
+  uint8_t *buf;
+  size_t n, i, len;
+
+  if ( stat ( path, &st ) || ! S_ISREG ( st.st_mode ) || st.st_size < 8 )
+    return;
+
+  if ( ( buf = ( uint8_t * ) malloc ( st.st_size ) ) == NULL )
+    return;
+
+  if ( ( fp = fopen ( path, "rb" ) ) == NULL )
+    {
+      free ( buf );
+      return;
+    }
+  n = fread ( buf, 1, st.st_size, fp );
+  fclose ( fp );
+
+  for ( i = 0; i + 8 <= n; i++ )
+    {
+      if ( memcmp ( buf + i, "BUFR", 4 ) )
+        continue;
+      len = three_bytes_to_uint32 ( buf + i + 4 );
+      if ( len < 8 || i + len > n || memcmp ( buf + i + len - 4, "7777", 4 ) )
+        continue;
+
+      if ( bufrdeco_read_buffer ( &BUFR, buf + i, len ) ||
+           bufrdeco_parse_tree ( &BUFR ) ||
+           bufrdeco_arrow_add_bufr ( &ARROW, &BUFR ) )
+        {
+          fprintf ( stderr, "# %s: %s", path, BUFR.error );
+          ERRORS++;
+        }
+      else
+        MESSAGES++;
+      bufrdeco_reset ( &BUFR );
+      i += len - 1;
+    }
+  free ( buf );
+}
+
+/*!
+  \fn void export_path(const char *path)
+  \brief Export a file or all the regular files in a directory
+  \param [in] path pathname of file or directory
+*/
+void export_path ( const char *path )
+{
+  struct dirent **list;
+  char aux[BUFRDECO_PATH_LENGTH * 2];
+  struct stat st;
+  int i, n;
+
+  if ( stat ( path, &st ) )
+    return;
+
+  if ( ! S_ISDIR ( st.st_mode ) )
+    {
+      export_file ( path );
+      return;
+    }
+
+  if ( ( n = scandir ( path, &list, NULL, alphasort ) ) < 0 )
+    return;
+  for ( i = 0; i < n; i++ )
+    {
+      if ( list[i]->d_name[0] != '.' )
+        {
+          snprintf ( aux, sizeof ( aux ), "%s/%s", path, list[i]->d_name );
+          export_file ( aux );
+        }
+      free ( list[i] );
+    }
+  free ( list );
+}
+
+/*!
+  \fn int main(int argc, char *argv[])
+  \brief Main function for bufrdeco_arrow program
+  \param [in] argc number of arguments
+  \param [in] argv array of argument strings
+  \return EXIT_SUCCESS if success, EXIT_FAILURE otherwise
+*/
+int main ( int argc, char *argv[] )
+{
+  FILE *out, *fl;
+  char aux[BUFRDECO_PATH_LENGTH], *c;
+  int res = EXIT_SUCCESS;
+
+  if ( read_args ( argc, argv ) < 0 )
+    exit ( EXIT_FAILURE );
+
+  if ( OUTPUTFILE[0] == '\0' )
+    out = stdout;
+  else if ( ( out = fopen ( OUTPUTFILE, "wb" ) ) == NULL )
+    {
+      fprintf ( stderr, "# Cannot open '%s'\n", OUTPUTFILE );
+      exit ( EXIT_FAILURE );
+    }
+
+  if ( bufrdeco_init ( &BUFR ) || bufrdeco_arrow_init ( &ARROW, out ) )
+    {
+      fprintf ( stderr, "# Cannot init the decoder or the writer\n" );
+      exit ( EXIT_FAILURE );
+    }
+  ARROW.batch_rows = BATCH_ROWS;
+  if ( COLUMNS != NULL && bufrdeco_arrow_add_columns ( &ARROW, COLUMNS ) )
+    {
+      fprintf ( stderr, "# Bad list of descriptors '%s'\n", COLUMNS );
+      exit ( EXIT_FAILURE );
+    }
+  BUFR.mask |= BUFRDECO_USE_TABLES_CACHE;
+  bufrdeco_set_tables_dir ( &BUFR, BUFRTABLES_DIR );
+
+  // Files from list
+  if ( LISTOFFILES[0] )
+    {
+      if ( ( fl = fopen ( LISTOFFILES, "r" ) ) == NULL )
+        {
+          fprintf ( stderr, "# Cannot open '%s'\n", LISTOFFILES );
+          exit ( EXIT_FAILURE );
+        }
+      while ( fgets ( aux, sizeof ( aux ), fl ) )
+        {
+          if ( ( c = strrchr ( aux, '\n' ) ) != NULL )
+            *c = '\0';
+          if ( aux[0] )
+            export_path ( aux );
+        }
+      fclose ( fl );
+    }
+
+  // Files and directories as arguments
+  for ( ; optind < argc; optind++ )
+    export_path ( argv[optind] );
+
+  if ( bufrdeco_arrow_close ( &ARROW ) )
+    {
+      fprintf ( stderr, "# Cannot write the Arrow stream\n" );
+      res = EXIT_FAILURE;
+    }
+  fprintf ( stderr, "# %" PRIu64 " messages exported in %" PRIu64 " rows and %" PRIu64 " record batches. %" PRIu64 " errors\n",
+            MESSAGES, ARROW.rows, ARROW.batches, ERRORS );
+
+  if ( out != stdout )
+    fclose ( out );
+  bufrdeco_close ( &BUFR );
+  exit ( res );
+}
@@ -0,0 +1,455 @@
+/***************************************************************************
+ *   Copyright (C) 2013-2026 by Guillermo Ballester Valor                  *
+ *   gbv@ogimet.com                                                        *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.             *
+ ***************************************************************************/
+/*! \file bufrdeco_bench.c
+    \brief This file includes the code to measure the decoding throughput of bufrdeco library
+
+    All the files of corpus are loaded in memory at start, then every message is decoded N times in the same
+    process with bufrdeco_read_buffer(), bufrdeco_parse_tree() and bufrdeco_get_target_subset_sequence_data() for
+    all subsets. The results are split for compressed and uncompressed messages, using the runtime statistics of
+    struct \ref bufrdeco for the breakdown by phase.
+*/
+#ifndef CONFIG_H
+#include "config.h"
+#define CONFIG_H
+#endif
+
+#include <dirent.h>
+#include "bufrdeco.h"
+
+/*!
+  \struct bench_message
+  \brief A BUFR message of the corpus loaded in memory
+*/
+struct bench_message
+{
+  char *path; /*!< Pathname of source file */
+  uint8_t *data; /*!< The BUFR message, from 'BUFR' to '7777' */
+  buf_t size; /*!< Size of message in bytes */
+};
+
+/*!
+  \struct bench_result
+  \brief Accumulated results for a class of messages
+*/
+struct bench_result
+{
+  struct bufrdeco_stats stats; /*!< Sum of stats deltas for every decoded message */
+  uint64_t errors; /*!< Messages which could not be decoded */
+};
+
+struct bufrdeco BUFR; /*!< The decoder */
+struct bench_message *CORPUS; /*!< Array of messages in corpus */
+size_t NCORPUS; /*!< Number of messages in CORPUS */
+size_t DCORPUS; /*!< Allocated dimension of CORPUS */
+char BUFRTABLES_DIR[BUFRDECO_PATH_LENGTH]; /*!< Directory for BUFR tables set by user */
+char LISTOFFILES[BUFRDECO_PATH_LENGTH]; /*!< Pathname of a file with a list of files */
+int REPEAT; /*!< Times the corpus is decoded */
+int JSON; /*!< If != 0 then output is in json format */
+int NO_CACHE; /*!< If != 0 then do not use cache of tables */
+
+/*!
+  \fn void print_usage(void)
+  \brief Print usage help message to stdout
+*/
+void print_usage ( void )
+{
+  printf ( "Usage: \n" );
+  printf ( "bufrdeco_bench [-t bufrtable_dir] [-n times] [-I list_of_files] [-j] [-N] [-h] file_or_dir [file_or_dir ...]\n" );
+  printf ( "   -h Print this help\n" );
+  printf ( "   -I list_of_files. Pathname of a file with the list of files of corpus, one filename per line\n" );
+  printf ( "   -j. Output in json format, in a single line\n" );
+  printf ( "   -n times. Number of times the corpus is decoded. Default is 10\n" );
+  printf ( "   -N. Do not use cache of tables\n" );
+  printf ( "   -t bufrtable_dir. Pathname of bufr tables directory. Ended with '/'\n" );
+  printf ( "   Every directory in arguments adds all its regular files to corpus\n" );
+}
+
+/*!
+  \fn int bench_add_file(const char *path)
+  \brief Load the BUFR messages of a file in corpus
+  \param [in] path pathname of file
+  \return the number of messages added
+
+  A file can have several messages, maybe with GTS headers among them. Every sequence of bytes from 'BUFR' with the
+  length declared in sec0 and ending with '7777' is added as a message.
+*/
+int bench_add_file ( const char *path )
+{
+  FILE *fp;
+  struct stat st;
+  uint8_t *buf;
+  size_t n, i, len;
+  int added = 0;
+
+  if ( stat ( path, &st ) || ! S_ISREG ( st.st_mode ) || st.st_size < 8 )
+    return 0;
+
+  if ( ( buf = ( uint8_t * ) malloc ( st.st_size ) ) == NULL )
+    return 0;
+
+  if ( ( fp = fopen ( path, "rb" ) ) == NULL )
+    {
+      free ( buf );
+      return 0;
+    }
+  n = fread ( buf, 1, st.st_size, fp );
+  fclose ( fp );
+
+  for ( i = 0; i + 8 <= n; i++ )
+    {
+      if ( memcmp ( buf + i, "BUFR", 4 ) )
+        continue;
+      len = three_bytes_to_uint32 ( buf + i + 4 );
+      if ( len < 8 || i + len > n || memcmp ( buf + i + len - 4, "7777", 4 ) )
+        continue;
+
+      if ( NCORPUS == DCORPUS )
+        {
+          DCORPUS = DCORPUS ? 2 * DCORPUS : 64;
+          if ( ( CORPUS = ( struct bench_message * ) realloc ( CORPUS, DCORPUS * sizeof ( struct bench_message ) ) ) == NULL )
+            {
+              fprintf ( stderr, "%s(): Cannot allocate memory\n", __func__ );
+              exit ( EXIT_FAILURE );
+            }
+        }
+      if ( ( CORPUS[NCORPUS].data = ( uint8_t * ) malloc ( len ) ) == NULL )
+        break;
+      memcpy ( CORPUS[NCORPUS].data, buf + i, len );
+      CORPUS[NCORPUS].size = len;
+      CORPUS[NCORPUS].path = strdup ( path );
+      NCORPUS++;
+      added++;
+      i += len - 1;
+    }
+  free ( buf );
+  return added;
+}
+
+/*!
+  \fn int bench_add_path(const char *path)
+  \brief Add a file or all the regular files in a directory to corpus
+  \param [in] path pathname of file or directory
+  \return the number of messages added
+*/
+int bench_add_path ( const char *path )
+{
+  struct dirent **list;
+  char aux[BUFRDECO_PATH_LENGTH * 2];
+  struct stat st;
+  int i, n, added = 0;
+
+  if ( stat ( path, &st ) )
+    return 0;
+
+  if ( ! S_ISDIR ( st.st_mode ) )
+    return bench_add_file ( path );
+
+  if ( ( n = scandir ( path, &list, NULL, alphasort ) ) < 0 )
+    return 0;
+  for ( i = 0; i < n; i++ )
+    {
+      if ( list[i]->d_name[0] != '.' )
+        {
+          snprintf ( aux, sizeof ( aux ), "%s/%s", path, list[i]->d_name );
+          added += bench_add_file ( aux );
+        }
+      free ( list[i] );
+    }
+  free ( list );
+  return added;
+}
+
+/*!
+  \fn int read_args( int _argc, char * _argv[])
+  \brief read the arguments from stdio
+  \param [in] _argc number of arguments passed
+  \param [in] _argv array of arguments
+
+  Returns 1 if succcess, -1 othewise
+*/
+int read_args ( int _argc, char * _argv[] )
+{
+  int iopt;
+  FILE *fl;
+  char aux[BUFRDECO_PATH_LENGTH], *c;
+
+  // Default values
+  REPEAT = 10;
+  JSON = 0;
+  NO_CACHE = 0;
+  BUFRTABLES_DIR[0] = '\0';
+  LISTOFFILES[0] = '\0';
+
+  while ( ( iopt = getopt ( _argc, _argv, "hI:jn:Nt:" ) ) !=-1 )
+    switch ( iopt )
+      {
+      case 'I':
+        if ( strlen ( optarg ) < BUFRDECO_PATH_LENGTH )
+          strcpy ( LISTOFFILES, optarg );
+        break;
+
+      case 'j':
+        JSON = 1;
+        break;
+
+      case 'n':
+        REPEAT = atoi ( optarg );
+        break;
+
+      case 'N':
+        NO_CACHE = 1;
+        break;
+
+      case 't':
+        if ( strlen ( optarg ) < BUFRDECO_PATH_LENGTH )
+          {
+            strcpy ( BUFRTABLES_DIR, optarg );
+          }
+        break;
+
+      case 'h':
+      default:
+        print_usage();
+        exit ( EXIT_SUCCESS );
+      }
+
+  // Files from list
+  if ( LISTOFFILES[0] )
+    {
+      if ( ( fl = fopen ( LISTOFFILES, "r" ) ) == NULL )
+        {
+          printf ( "read_args(): Cannot open '%s'\n", LISTOFFILES );
+          return -1;
+        }
+      while ( fgets ( aux, sizeof ( aux ), fl ) )
+        {
+          if ( ( c = strrchr ( aux, '\n' ) ) != NULL )
+            *c = '\0';
+          if ( aux[0] )
+            bench_add_path ( aux );
+        }
+      fclose ( fl );
+    }
+
+  // Files and directories as arguments
+  for ( ; optind < _argc; optind++ )
+    bench_add_path ( _argv[optind] );
+
+  if ( NCORPUS == 0 || REPEAT <= 0 )
+    {
+      printf ( "read_args(): No BUFR messages in corpus. Use -I option or add files or directories as arguments\n" );
+      return -1;
+    }
+  return 1;
+}
+
+/*!
+  \fn void bench_stats_accumulate(struct bufrdeco_stats *acc, const struct bufrdeco_stats *after, const struct bufrdeco_stats *before)
+  \brief Add to acc the difference between two stats of struct \ref bufrdeco
+  \param [in,out] acc the accumulated stats
+  \param [in] after stats after decoding a message
+  \param [in] before stats before decoding the message
+*/
+void bench_stats_accumulate ( struct bufrdeco_stats *acc, const struct bufrdeco_stats *after, const struct bufrdeco_stats *before )
+{
+  int i;
+
+  for ( i = 0; i < BUFRDECO_STATS_PHASES; i++ )
+    {
+      acc->calls[i] += after->calls[i] - before->calls[i];
+      acc->ns[i] += after->ns[i] - before->ns[i];
+    }
+  acc->messages += after->messages - before->messages;
+  acc->bytes += after->bytes - before->bytes;
+  acc->subsets += after->subsets - before->subsets;
+  acc->cache_hits += after->cache_hits - before->cache_hits;
+  acc->cache_misses += after->cache_misses - before->cache_misses;
+  acc->cache_evictions += after->cache_evictions - before->cache_evictions;
+}
+
+/*!
+  \fn int bench_decode_message(const struct bench_message *m)
+  \brief Decode a message and all its subsets
+  \param [in] m pointer to the message
+  \return 0 if succeeded, 1 otherwise
+*/
+int bench_decode_message ( const struct bench_message *m )
+{
+  buf_t subset;
+
+  if ( bufrdeco_read_buffer ( &BUFR, m->data, m->size ) ||
+       bufrdeco_parse_tree ( &BUFR ) )
+    return 1;
+
+  for ( subset = 0; subset < BUFR.sec3.subsets ; subset++ )
+    {
+      if ( bufrdeco_get_target_subset_sequence_data ( subset, &BUFR ) == NULL )
+        return 1;
+    }
+  return 0;
+}
+
+/*!
+  \fn void bench_print_result_json(const char *name, const struct bench_result *r)
+  \brief Print a result as a json member
+  \param [in] name name of member
+  \param [in] r pointer to the result
+*/
+void bench_print_result_json ( const char *name, const struct bench_result *r )
+{
+  uint64_t ns = 0;
+  double sec;
+  int i;
+
+  for ( i = 0; i < BUFRDECO_STATS_PHASES; i++ )
+    ns += r->stats.ns[i];
+  sec = ( double ) ns * 1e-9;
+
+  printf ( "\"%s\":{\"Messages\":%" PRIu64 ",\"Subsets\":%" PRIu64 ",\"Bytes\":%" PRIu64 ",\"Errors\":%" PRIu64 ",\"Seconds\":%.6lf",
+           name, r->stats.messages, r->stats.subsets, r->stats.bytes, r->errors, sec );
+  printf ( ",\"Messages per second\":%.1lf,\"Subsets per second\":%.1lf,\"MB per second\":%.3lf",
+           sec > 0.0 ? r->stats.messages / sec : 0.0, sec > 0.0 ? r->stats.subsets / sec : 0.0,
+           sec > 0.0 ? r->stats.bytes / sec * 1e-6 : 0.0 );
+  printf ( ",\"Cache hits\":%" PRIu64 ",\"Cache misses\":%" PRIu64 ",\"Cache evictions\":%" PRIu64, r->stats.cache_hits,
+           r->stats.cache_misses, r->stats.cache_evictions );
+  printf ( ",\"Phases\":{" );
+  for ( i = 0; i < BUFRDECO_STATS_PHASES; i++ )
+    printf ( "%s\"%s\":{\"Calls\":%" PRIu64 ",\"Seconds\":%.6lf}", i ? "," : "", bufrdeco_stats_phase_name ( i ),
+             r->stats.calls[i], ( double ) r->stats.ns[i] * 1e-9 );
+  printf ( "}}" );
+}
+
+/*!
+  \fn void bench_print_result(const char *name, const struct bench_result *r)
+  \brief Print a result as human readable text
+  \param [in] name name of class of messages
+  \param [in] r pointer to the result
+*/
+void bench_print_result ( const char *name, const struct bench_result *r )
+{
+  uint64_t ns = 0;
+  double sec;
+  int i;
+
+  for ( i = 0; i < BUFRDECO_STATS_PHASES; i++ )
+    ns += r->stats.ns[i];
+  sec = ( double ) ns * 1e-9;
+
+  printf ( "%-12s messages=%" PRIu64 " subsets=%" PRIu64 " bytes=%" PRIu64 " errors=%" PRIu64 " seconds=%.6lf\n",
+           name, r->stats.messages, r->stats.subsets, r->stats.bytes, r->errors, sec );
+  if ( sec <= 0.0 )
+    return;
+  printf ( "%-12s cache_hits=%" PRIu64 " cache_misses=%" PRIu64 " cache_evictions=%" PRIu64 "\n", "", r->stats.cache_hits,
+           r->stats.cache_misses, r->stats.cache_evictions );
+  printf ( "%-12s %.1lf messages/s  %.1lf subsets/s  %.3lf MB/s\n", "", r->stats.messages / sec, r->stats.subsets / sec,
+           r->stats.bytes / sec * 1e-6 );
+  for ( i = 0; i < BUFRDECO_STATS_PHASES; i++ )
+    if ( r->stats.calls[i] )
+      printf ( "%-12s   %-10s calls=%-10" PRIu64 " seconds=%.6lf (%.1lf%%)\n", "", bufrdeco_stats_phase_name ( i ),
+               r->stats.calls[i], ( double ) r->stats.ns[i] * 1e-9, 100.0 * r->stats.ns[i] / ns );
+}
+
+/*!
+  \fn int main(int argc, char *argv[])
+  \brief Main function for bufrdeco_bench program
+  \param [in] argc number of arguments
+  \param [in] argv array of argument strings
+  \return EXIT_SUCCESS if success, EXIT_FAILURE otherwise
+*/
+int main ( int argc, char *argv[] )
+{
+  struct bench_result res[3]; // 0 = uncompressed, 1 = compressed, 2 = total
+  struct bufrdeco_stats before;
+  char version[16];
+  uint64_t t0, wall;
+  size_t i;
+  int r, c;
+
+  if ( read_args ( argc, argv ) < 0 )
+    exit ( EXIT_FAILURE );
+
+  if ( bufrdeco_init ( &BUFR ) )
+    {
+      printf ( "# %s", BUFR.error );
+      exit ( EXIT_FAILURE );
+    }
+  BUFR.mask |= BUFRDECO_COLLECT_STATS;
+  if ( NO_CACHE == 0 )
+    BUFR.mask |= BUFRDECO_USE_TABLES_CACHE;
+  bufrdeco_set_tables_dir ( &BUFR, BUFRTABLES_DIR );
+  bufrdeco_clean_stats ( &BUFR );
+  memset ( res, 0, sizeof ( res ) );
+
+  t0 = bufrdeco_stats_clock ( &BUFR );
+  for ( r = 0; r < REPEAT; r++ )
+    {
+      for ( i = 0; i < NCORPUS; i++ )
+        {
+          memcpy ( &before, &BUFR.stats, sizeof ( struct bufrdeco_stats ) );
+          if ( bench_decode_message ( &CORPUS[i] ) )
+            {
+              if ( r == 0 )
+                fprintf ( stderr, "# %s: %s", CORPUS[i].path, BUFR.error );
+              res[BUFR.sec3.compressed ? 1 : 0].errors++;
+            }
+          c = BUFR.sec3.compressed ? 1 : 0;
+          bench_stats_accumulate ( &res[c].stats, &BUFR.stats, &before );
+          bufrdeco_reset ( &BUFR );
+        }
+    }
+  wall = bufrdeco_stats_clock ( &BUFR ) - t0;
+
+  // Total
+  memset ( &before, 0, sizeof ( before ) );
+  for ( c = 0; c < 2; c++ )
+    {
+      bench_stats_accumulate ( &res[2].stats, &res[c].stats, &before );
+      res[2].errors += res[c].errors;
+    }
+
+  bufrdeco_get_version ( version, sizeof ( version ), NULL, 0, NULL, 0, NULL, NULL, NULL );
+  if ( JSON )
+    {
+      printf ( "{\"Bench\":{\"Version\":\"%s\",\"Repeat\":%d,\"Corpus messages\":%zu,\"Tables cache\":%d,\"Wall seconds\":%.6lf,",
+               version, REPEAT, NCORPUS, NO_CACHE ? 0 : 1, ( double ) wall * 1e-9 );
+      bench_print_result_json ( "Total", &res[2] );
+      printf ( "," );
+      bench_print_result_json ( "Compressed", &res[1] );
+      printf ( "," );
+      bench_print_result_json ( "Uncompressed", &res[0] );
+      printf ( "}}\n" );
+    }
+  else
+    {
+      printf ( "# bufrdeco %s. %zu messages decoded %d times in %.6lf s\n", version, NCORPUS, REPEAT, ( double ) wall * 1e-9 );
+      bench_print_result ( "Total", &res[2] );
+      bench_print_result ( "Compressed", &res[1] );
+      bench_print_result ( "Uncompressed", &res[0] );
+    }
+
+  bufrdeco_close ( &BUFR );
+  for ( i = 0; i < NCORPUS; i++ )
+    {
+      free ( CORPUS[i].data );
+      free ( CORPUS[i].path );
+    }
+  free ( CORPUS );
+  exit ( EXIT_SUCCESS );
+}
@@ -0,0 +1,363 @@
+/***************************************************************************
+ *   Copyright (C) 2013-2026 by Guillermo Ballester Valor                  *
+ *   gbv@ogimet.com                                                        *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.             *
+ ***************************************************************************/
+/*! \file bufrdeco_gen.c
+    \brief This file includes the code to generate synthetic BUFR messages for benchmarks and load tests
+
+    Messages are encoded with \ref bufrdeco_encode_synthetic for a template of descriptors. With option -V every message
+    is decoded again and the decoded values are checked against the encoded ones.
+*/
+#ifndef CONFIG_H
+#include "config.h"
+#define CONFIG_H
+#endif
+
+#include "bufrdeco.h"
+
+struct bufrdeco BUFR; /*!< The decoder, also used by encoder for tables and tree */
+struct bufrdeco_encode ENCODE; /*!< Options of encoder and expected values */
+uint8_t MESSAGE[BUFR_LEN]; /*!< The current encoded message */
+char BUFRTABLES_DIR[BUFRDECO_PATH_LENGTH]; /*!< Directory for BUFR tables set by user */
+char OUTPUTFILE[BUFRDECO_PATH_LENGTH]; /*!< Pathname of output file with all messages. Empty for stdout */
+char OUTPUTDIR[BUFRDECO_PATH_LENGTH]; /*!< Directory where to write a file for every message */
+unsigned long NMESSAGES; /*!< Number of messages to generate */
+int CATEGORY_SET; /*!< If != 0 then category has been set by user */
+int VERIFY; /*!< If != 0 then every message is decoded and checked */
+int VERBOSE; /*!< If != 0 then print a line for every message to stderr */
+
+/*!
+  \fn void print_usage(void)
+  \brief Print usage help message to stdout
+*/
+void print_usage ( void )
+{
+  printf ( "Usage: \n" );
+  printf ( "bufrdeco_gen -T template [-t bufrtable_dir] [-n messages] [-s subsets] [-c] [-e edition] [-m master_version]\n" );
+  printf ( "             [-C category] [-r max_replications] [-M missing_percent] [-S seed] [-o output | -d dir] [-V] [-v] [-h]\n" );
+  printf ( "   -c. Compressed data\n" );
+  printf ( "   -C category. Data category in sec1. Default is guessed from template\n" );
+  printf ( "   -d dir. Write every message in a file 'dir/synthetic_NNNNNNNN.bufr'\n" );
+  printf ( "   -e edition. BUFR edition, 3 or 4. Default is 4\n" );
+  printf ( "   -h Print this help\n" );
+  printf ( "   -m master_version. Master table version. Default is %d\n", BUFRDECO_ENCODE_MASTER_VERSION );
+  printf ( "   -M missing_percent. Percent of missing values. Default is 5\n" );
+  printf ( "   -n messages. Number of messages. Default is 1\n" );
+  printf ( "   -o output. Pathname of output file with all messages. Default is stdout\n" );
+  printf ( "   -r max_replications. Max value of delayed replication factors. Default is 4\n" );
+  printf ( "   -s subsets. Subsets per message. Default is 1\n" );
+  printf ( "   -S seed. Seed of pseudo-random generator. Default is 1\n" );
+  printf ( "   -t bufrtable_dir. Pathname of bufr tables directory. Ended with '/'\n" );
+  printf ( "   -T template. Descriptors of sec3 separated by commas, as 307080 for SYNOP, 309052 for TEMP or 315009 for BUOY\n" );
+  printf ( "   -v. Verbose, a line for every message to stderr\n" );
+  printf ( "   -V. Decode every message and verify the decoded values\n" );
+}
+
+/*!
+  \fn int read_args( int _argc, char * _argv[])
+  \brief read the arguments from stdio
+  \param [in] _argc number of arguments passed
+  \param [in] _argv array of arguments
+
+  Returns 1 if succcess, -1 othewise
+*/
+int read_args ( int _argc, char * _argv[] )
+{
+  int iopt;
+  char *c, *s;
+  unsigned long v;
+
+  // Default values
+  bufrdeco_init_encode ( &ENCODE );
+  NMESSAGES = 1;
+  CATEGORY_SET = 0;
+  VERIFY = 0;
+  VERBOSE = 0;
+  BUFRTABLES_DIR[0] = '\0';
+  OUTPUTFILE[0] = '\0';
+  OUTPUTDIR[0] = '\0';
+
+  while ( ( iopt = getopt ( _argc, _argv, "cC:d:e:hm:M:n:o:r:s:S:t:T:vV" ) ) !=-1 )
+    switch ( iopt )
+      {
+      case 'c':
+        ENCODE.compressed = 1;
+        break;
+
+      case 'C':
+        ENCODE.category = ( uint8_t ) atoi ( optarg );
+        CATEGORY_SET = 1;
+        break;
+
+      case 'd':
+        if ( strlen ( optarg ) < BUFRDECO_PATH_LENGTH - 32 )
+          strcpy ( OUTPUTDIR, optarg );
+        break;
+
+      case 'e':
+        ENCODE.edition = ( uint8_t ) atoi ( optarg );
+        break;
+
+      case 'm':
+        ENCODE.master_version = ( uint8_t ) atoi ( optarg );
+        break;
+
+      case 'M':
+        ENCODE.missing_percent = ( uint8_t ) atoi ( optarg );
+        break;
+
+      case 'n':
+        NMESSAGES = strtoul ( optarg, NULL, 10 );
+        break;
+
+      case 'o':
+        if ( strlen ( optarg ) < BUFRDECO_PATH_LENGTH )
+          strcpy ( OUTPUTFILE, optarg );
+        break;
+
+      case 'r':
+        ENCODE.max_replications = ( uint8_t ) atoi ( optarg );
+        break;
+
+      case 's':
+        ENCODE.subsets = ( buf_t ) atoi ( optarg );
+        break;
+
+      case 'S':
+        ENCODE.seed = strtoull ( optarg, NULL, 10 );
+        break;
+
+      case 't':
+        if ( strlen ( optarg ) < BUFRDECO_PATH_LENGTH )
+          {
+            strcpy ( BUFRTABLES_DIR, optarg );
+          }
+        break;
+
+      case 'T':
+        for ( s = optarg; *s && ENCODE.ndesc < BUFR_LEN_UNEXPANDED_DESCRIPTOR; s = c )
+          {
+            v = strtoul ( s, &c, 10 );
+            if ( c == s )
+              {
+                printf ( "read_args(): Bad template '%s'\n", optarg );
+                return -1;
+              }
+            uint32_t_to_descriptor ( &ENCODE.unexpanded[ENCODE.ndesc++], ( uint32_t ) v );
+            if ( *c == ',' )
+              c++;
+          }
+        break;
+
+      case 'v':
+        VERBOSE = 1;
+        break;
+
+      case 'V':
+        VERIFY = 1;
+        break;
+
+      case 'h':
+      default:
+        print_usage();
+        exit ( EXIT_SUCCESS );
+      }
+
+  if ( ENCODE.ndesc == 0 )
+    {
+      printf ( "read_args(): A template is needed. Use -T option\n" );
+      return -1;
+    }
+
+  if ( ENCODE.subsets == 0 || ENCODE.subsets > BUFR_MAX_SUBSETS )
+    {
+      printf ( "read_args(): Subsets must be in range 1..%u\n", BUFR_MAX_SUBSETS );
+      return -1;
+    }
+
+  // Guess category from first sequence of template, as in table A
+  if ( CATEGORY_SET == 0 && ENCODE.unexpanded[0].f == 3 )
+    {
+      switch ( ENCODE.unexpanded[0].x )
+        {
+        case 7:
+          ENCODE.category = 0; // Surface data - land
+          break;
+        case 8:
+        case 15:
+          ENCODE.category = 1; // Surface data - sea
+          break;
+        case 9:
+          ENCODE.category = 2; // Vertical soundings (other than satellite)
+          break;
+        default:
+          ENCODE.category = 255;
+          break;
+        }
+    }
+  return 1;
+}
+
+/*!
+  \fn int verify_message(buf_t size, unsigned long nmsg)
+  \brief Decode the current message and check the values against the encoded ones
+  \param [in] size bytes of message
+  \param [in] nmsg index of message, for the reports
+  \return number of differences found, or 1 if the message cannot be decoded
+*/
+int verify_message ( buf_t size, unsigned long nmsg )
+{
+  struct bufrdeco_subset_sequence_data *s;
+  const struct bufrdeco_encode_value *v;
+  const struct bufr_atom_data *a;
+  buf_t subset, i, n;
+  int errors = 0;
+
+  bufrdeco_reset ( &BUFR );
+  if ( bufrdeco_read_buffer ( &BUFR, MESSAGE, size ) || bufrdeco_parse_tree ( &BUFR ) )
+    {
+      fprintf ( stderr, "# Message %lu: %s", nmsg, BUFR.error );
+      return 1;
+    }
+
+  for ( subset = 0; subset < BUFR.sec3.subsets; subset++ )
+    {
+      if ( ( s = bufrdeco_get_target_subset_sequence_data ( subset, &BUFR ) ) == NULL )
+        {
+          fprintf ( stderr, "# Message %lu subset %u: %s", nmsg, subset, BUFR.error );
+          return errors + 1;
+        }
+
+      n = bufrdeco_encode_values_in_subset ( &ENCODE, subset );
+      if ( s->nd != n )
+        {
+          fprintf ( stderr, "# Message %lu subset %u: decoded %u values and %u were encoded\n", nmsg, subset, s->nd, n );
+          errors++;
+          if ( s->nd < n )
+            n = s->nd;
+        }
+
+      for ( i = 0; i < n; i++ )
+        {
+          a = & ( s->sequence[i] );
+          v = bufrdeco_encode_get_value ( &ENCODE, subset, i );
+          if ( v->mask & DESCRIPTOR_VALUE_MISSING )
+            {
+              if ( ( a->mask & DESCRIPTOR_VALUE_MISSING ) == 0 )
+                {
+                  fprintf ( stderr, "# Message %lu subset %u data %u '%s': expected missing\n", nmsg, subset, i, a->desc.c );
+                  errors++;
+                }
+            }
+          else if ( v->mask & DESCRIPTOR_HAVE_STRING_VALUE )
+            {
+              if ( ( a->mask & DESCRIPTOR_HAVE_STRING_VALUE ) == 0 || bufrdeco_encode_string_hash ( a->cval ) != v->hash )
+                {
+                  fprintf ( stderr, "# Message %lu subset %u data %u '%s': unexpected string '%s'\n", nmsg, subset, i, a->desc.c, a->cval );
+                  errors++;
+                }
+            }
+          else if ( ( a->mask & DESCRIPTOR_VALUE_MISSING ) || fabs ( a->val - v->val ) > 1e-9 * ( fabs ( v->val ) > 1.0 ? fabs ( v->val ) : 1.0 ) )
+            {
+              fprintf ( stderr, "# Message %lu subset %u data %u '%s': decoded %.10g and expected %.10g\n", nmsg, subset, i, a->desc.c,
+                        ( a->mask & DESCRIPTOR_VALUE_MISSING ) ? MISSING_REAL : a->val, v->val );
+              errors++;
+            }
+        }
+    }
+  return errors;
+}
+
+/*!
+  \fn int main(int argc, char *argv[])
+  \brief Main function for bufrdeco_gen program
+  \param [in] argc number of arguments
+  \param [in] argv array of argument strings
+  \return EXIT_SUCCESS if success, EXIT_FAILURE otherwise
+*/
+int main ( int argc, char *argv[] )
+{
+  char aux[BUFRDECO_PATH_LENGTH];
+  FILE *out = stdout, *f;
+  unsigned long nmsg, bad = 0;
+  unsigned long long bytes = 0;
+  buf_t size;
+  int errors;
+
+  if ( read_args ( argc, argv ) < 0 )
+    exit ( EXIT_FAILURE );
+
+  if ( bufrdeco_init ( &BUFR ) )
+    {
+      printf ( "# %s", BUFR.error );
+      exit ( EXIT_FAILURE );
+    }
+  BUFR.mask |= BUFRDECO_USE_TABLES_CACHE;
+  bufrdeco_set_tables_dir ( &BUFR, BUFRTABLES_DIR );
+
+  if ( OUTPUTFILE[0] && ( out = fopen ( OUTPUTFILE, "wb" ) ) == NULL )
+    {
+      printf ( "# Cannot open '%s'\n", OUTPUTFILE );
+      exit ( EXIT_FAILURE );
+    }
+
+  for ( nmsg = 0; nmsg < NMESSAGES; nmsg++ )
+    {
+      bufrdeco_reset ( &BUFR );
+      if ( bufrdeco_encode_synthetic ( &BUFR, &ENCODE, MESSAGE, sizeof ( MESSAGE ), &size ) )
+        {
+          fprintf ( stderr, "# Message %lu: %s", nmsg, BUFR.error );
+          bad++;
+          break;
+        }
+
+      if ( OUTPUTDIR[0] )
+        {
+          snprintf ( aux, sizeof ( aux ), "%s/synthetic_%08lu.bufr", OUTPUTDIR, nmsg );
+          if ( ( f = fopen ( aux, "wb" ) ) == NULL )
+            {
+              fprintf ( stderr, "# Cannot open '%s'\n", aux );
+              bad++;
+              break;
+            }
+          fwrite ( MESSAGE, 1, size, f );
+          fclose ( f );
+        }
+      else
+        fwrite ( MESSAGE, 1, size, out );
+      bytes += size;
+
+      errors = 0;
+      if ( VERIFY && ( errors = verify_message ( size, nmsg ) ) != 0 )
+        bad++;
+
+      if ( VERBOSE )
+        fprintf ( stderr, "# Message %lu: %u bytes, %u subsets, %u values%s\n", nmsg, size, ENCODE.subsets, ENCODE.nv,
+                  VERIFY ? ( errors ? ", verify FAILED" : ", verify OK" ) : "" );
+    }
+
+  if ( out != stdout )
+    fclose ( out );
+
+  if ( VERIFY || VERBOSE )
+    fprintf ( stderr, "# %lu messages, %llu bytes, %lu with errors\n", nmsg, bytes, bad );
+
+  bufrdeco_free_encode ( &ENCODE );
+  bufrdeco_close ( &BUFR );
+  exit ( bad ? EXIT_FAILURE : EXIT_SUCCESS );
+}
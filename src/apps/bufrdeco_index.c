@@ -0,0 +1,275 @@
+/***************************************************************************
+ *   Copyright (C) 2013-2026 by Guillermo Ballester Valor                  *
+ *   gbv@ogimet.com                                                        *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.             *
+ ***************************************************************************/
+/*! \file bufrdeco_index.c
+    \brief This file includes the code to build an index of an archive of BUFR messages and to find subsets with it
+
+    With -b the index of the archive is built. Otherwise the subsets of a station in a time interval are found in
+    the index and, with -L, decoded from the archive and printed as flat json objects
+*/
+#ifndef CONFIG_H
+#include "config.h"
+#define CONFIG_H
+#endif
+
+#include "bufrdeco.h"
+
+struct bufrdeco BUFR; /*!< The decoder */
+struct bufrdeco_index INDEX; /*!< The index */
+char ARCHIVE[BUFRDECO_PATH_LENGTH]; /*!< Pathname of archive */
+char INDEXFILE[BUFRDECO_PATH_LENGTH + 8]; /*!< Pathname of index file */
+char BUFRTABLES_DIR[BUFRDECO_PATH_LENGTH]; /*!< Directory for BUFR tables set by user */
+char IDENT[BUFRDECO_INDEX_IDENT_LENGTH]; /*!< Station or platform to find */
+int64_t FROM; /*!< First time to find */
+int64_t TO; /*!< Last time to find */
+int BUILD; /*!< If != 0 then build the index */
+int DECODE; /*!< If != 0 then decode the found subsets and print them as flat json */
+int MEANINGS; /*!< If != 0 then add the meanings of code and flag tables in flat json */
+
+/*!
+  \fn void print_usage(void)
+  \brief Print usage help message to stdout
+*/
+void print_usage ( void )
+{
+  printf ( "Usage: \n" );
+  printf ( "bufrdeco_index -a archive [-i index_file] [-b] [-t bufrtable_dir] [-s ident [-d time[..time]]] [-L] [-m] [-h]\n" );
+  printf ( "   -a archive. Pathname of a file with many BUFR messages\n" );
+  printf ( "   -b. Build the index of archive\n" );
+  printf ( "   -d time[..time]. Find only the subsets with time (YYYYMMDDHHMM, UTC) in interval. Default is any time\n" );
+  printf ( "   -h Print this help\n" );
+  printf ( "   -i index_file. Pathname of index file. Default is archive name with '.idx' added\n" );
+  printf ( "   -L. Decode the subsets found and print them as flat json objects, one per line\n" );
+  printf ( "   -m. With -L, add the meanings of code and flag tables\n" );
+  printf ( "   -s ident. Find the subsets of station or platform 'ident', as '08221'\n" );
+  printf ( "   -t bufrtable_dir. Pathname of bufr tables directory. Ended with '/'\n" );
+  printf ( "   Without -s all the subsets in index are listed\n" );
+}
+
+/*!
+  \fn static int index_parse_time(int64_t *t, const char *val)
+  \brief Parse a time as YYYYMMDDHHMM[SS] in UTC
+  \param [out] t result as seconds since epoch
+  \param [in] val string with the time
+  \return 0 if succeeded, 1 otherwise
+*/
+static int index_parse_time ( int64_t *t, const char *val )
+{
+  struct tm tim;
+
+  memset ( &tim, 0, sizeof ( tim ) );
+  if ( sscanf ( val, "%4d%2d%2d%2d%2d%2d", &tim.tm_year, &tim.tm_mon, &tim.tm_mday, &tim.tm_hour,
+                &tim.tm_min, &tim.tm_sec ) < 5 )
+    return 1;
+  tim.tm_year -= 1900;
+  tim.tm_mon -= 1;
+  *t = ( int64_t ) timegm ( &tim );
+  return 0;
+}
+
+/*!
+  \fn int read_args( int _argc, char * _argv[])
+  \brief read the arguments from stdio
+  \param [in] _argc number of arguments passed
+  \param [in] _argv array of arguments
+
+  Returns 1 if succcess, -1 othewise
+*/
+int read_args ( int _argc, char * _argv[] )
+{
+  int iopt;
+  char *c;
+
+  // Default values
+  ARCHIVE[0] = '\0';
+  INDEXFILE[0] = '\0';
+  BUFRTABLES_DIR[0] = '\0';
+  IDENT[0] = '\0';
+  FROM = INT64_MIN;
+  TO = INT64_MAX;
+  BUILD = 0;
+  DECODE = 0;
+  MEANINGS = 0;
+
+  while ( ( iopt = getopt ( _argc, _argv, "a:bd:hi:Lms:t:" ) ) !=-1 )
+    switch ( iopt )
+      {
+      case 'a':
+        if ( strlen ( optarg ) < BUFRDECO_PATH_LENGTH )
+          strcpy ( ARCHIVE, optarg );
+        break;
+
+      case 'b':
+        BUILD = 1;
+        break;
+
+      case 'd':
+        if ( index_parse_time ( &FROM, optarg ) )
+          {
+            printf ( "read_args(): Bad time '%s'\n", optarg );
+            return -1;
+          }
+        TO = FROM;
+        if ( ( c = strstr ( optarg, ".." ) ) != NULL && index_parse_time ( &TO, c + 2 ) )
+          {
+            printf ( "read_args(): Bad time '%s'\n", c + 2 );
+            return -1;
+          }
+        break;
+
+      case 'i':
+        if ( strlen ( optarg ) < BUFRDECO_PATH_LENGTH )
+          strcpy ( INDEXFILE, optarg );
+        break;
+
+      case 'L':
+        DECODE = 1;
+        break;
+
+      case 'm':
+        MEANINGS = 1;
+        break;
+
+      case 's':
+        if ( strlen ( optarg ) < BUFRDECO_INDEX_IDENT_LENGTH )
+          strcpy ( IDENT, optarg );
+        break;
+
+      case 't':
+        if ( strlen ( optarg ) < BUFRDECO_PATH_LENGTH )
+          strcpy ( BUFRTABLES_DIR, optarg );
+        break;
+
+      case 'h':
+      default:
+        print_usage();
+        exit ( EXIT_SUCCESS );
+      }
+
+  if ( ARCHIVE[0] == '\0' )
+    {
+      printf ( "read_args(): It is needed an archive. Use -a option\n" );
+      return -1;
+    }
+  if ( INDEXFILE[0] == '\0' )
+    snprintf ( INDEXFILE, sizeof ( INDEXFILE ), "%s.idx", ARCHIVE );
+  return 1;
+}
+
+/*!
+  \fn void print_subset(const struct bufrdeco_index_subset *s)
+  \brief Print a line with the keys of a subset of index
+  \param [in] s pointer to the subset
+*/
+void print_subset ( const struct bufrdeco_index_subset *s )
+{
+  const struct bufrdeco_index_message *m = &INDEX.msg[s->message];
+  struct tm tim;
+  time_t t = ( time_t ) s->time;
+  char aux[32];
+
+  gmtime_r ( &t, &tim );
+  strftime ( aux, sizeof ( aux ), "%Y%m%d%H%M%S", &tim );
+  printf ( "%-12s %s message=%u offset=%" PRIu64 " length=%u subset=%u bit_offset=%u centre=%u category=%u template=%08x\n",
+           s->ident[0] ? s->ident : "-", aux, s->message, m->offset, m->length, s->subset, s->bit_offset, m->centre,
+           m->category, m->template_hash );
+}
+
+/*!
+  \fn int main(int argc, char *argv[])
+  \brief Main function for bufrdeco_index program
+  \param [in] argc number of arguments
+  \param [in] argv array of argument strings
+  \return EXIT_SUCCESS if success, EXIT_FAILURE otherwise
+*/
+int main ( int argc, char *argv[] )
+{
+  uint64_t i, first, count;
+  int res = EXIT_SUCCESS;
+
+  if ( read_args ( argc, argv ) < 0 )
+    exit ( EXIT_FAILURE );
+
+  if ( bufrdeco_init ( &BUFR ) )
+    {
+      printf ( "# %s", BUFR.error );
+      exit ( EXIT_FAILURE );
+    }
+  BUFR.mask |= BUFRDECO_USE_TABLES_CACHE;
+  bufrdeco_set_tables_dir ( &BUFR, BUFRTABLES_DIR );
+
+  if ( BUILD )
+    {
+      if ( bufrdeco_index_build ( &BUFR, ARCHIVE, INDEXFILE ) )
+        {
+          printf ( "# %s", BUFR.error );
+          bufrdeco_close ( &BUFR );
+          exit ( EXIT_FAILURE );
+        }
+    }
+
+  if ( bufrdeco_index_open ( &INDEX, INDEXFILE, DECODE ? ARCHIVE : NULL ) )
+    {
+      printf ( "# Cannot open index '%s' or it is not valid for archive '%s'. Build it with -b\n", INDEXFILE, ARCHIVE );
+      bufrdeco_close ( &BUFR );
+      exit ( EXIT_FAILURE );
+    }
+
+  if ( BUILD )
+    {
+      printf ( "# %u messages and %" PRIu64 " subsets indexed in '%s'\n", INDEX.header->nmessages, INDEX.header->nsubsets, INDEXFILE );
+    }
+  else
+    {
+      if ( IDENT[0] )
+        {
+          if ( bufrdeco_index_find ( &INDEX, IDENT, FROM, TO, &first, &count ) )
+            res = EXIT_FAILURE;
+        }
+      else
+        {
+          first = 0;
+          count = INDEX.header->nsubsets;
+        }
+
+      if ( DECODE )
+        {
+          BUFR.mask |= BUFRDECO_OUTPUT_NDJSON_SUBSET_DATA;
+          if ( MEANINGS )
+            BUFR.mask |= BUFRDECO_OUTPUT_NDJSON_MEANINGS;
+        }
+
+      for ( i = first; i < first + count; i++ )
+        {
+          if ( IDENT[0] == '\0' && ( INDEX.sub[i].time < FROM || INDEX.sub[i].time > TO ) )
+            continue;
+          if ( DECODE == 0 )
+            print_subset ( &INDEX.sub[i] );
+          else if ( bufrdeco_index_get_subset ( &BUFR, &INDEX, &INDEX.sub[i] ) == NULL )
+            {
+              printf ( "# %s", BUFR.error );
+              res = EXIT_FAILURE;
+            }
+        }
+    }
+
+  bufrdeco_index_close ( &INDEX );
+  bufrdeco_close ( &BUFR );
+  exit ( res );
+}
@@ -31,8 +31,11 @@ int PRINT_JSON_SEC2; /*!< If != 0 Prints Sec 2 information in json format */
 int PRINT_JSON_SEC3; /*!< If != 0 Prints Sec 3 information in json format */
 int PRINT_JSON_SEC4; /*!< If != 0 Prints Sec 4 data in json format */
 int PRINT_JSON_EXPANDED_TREE; /*!< If != 0 Prints expanded tree in json format */
+int PRINT_NDJSON; /*!< If != 0 Prints every subset data as a flat json object in a line */
+int PRINT_NDJSON_MEANINGS; /*!< If != 0 Adds the meanings of code and flag tables to flat json objects */
 int FIRST_SUBSET; /*!< First subset to parse */
 int LAST_SUBSET; /*!< Last subset to parse */
+char SNAPSHOT[256]; /*!< Pathname of a snapshot file to print instead of decoding a BUFR file */
 
 /*!
   \fn void print_usage(void)
@@ -45,8 +48,11 @@ void print_usage ( void )
   printf ( "   -h Print this help\n" );
   printf ( "   -i Input file. Complete input path file for bufr file\n" );
   printf ( "   -J. Information, tree and data in json format. Equivalent to option -E01234\n" );
+  printf ( "   -L. Print every subset data as a flat json object in a single line ('f xx yyy':value pairs)\n" );
+  printf ( "   -m. With -L, add the meanings of code and flag tables\n" );
   printf ( "   -S first..last . Print only results for subsets in range first..last (First subset available is 0). Default is all subsets\n" );
   printf ( "   -T. Print expanded tree in json format\n" );
+  printf ( "   -z snapshot. Print the decoded subsets of a snapshot file written by 'bufrtotac -Z', without decoding\n" );
   printf ( "   -X. Extract first BUFR buffer found in input file (from first 'BUFR' item to next '7777')\n" );
   printf ( "   -0. Prints BUFR Sec 0 information in json format\n" );
   printf ( "   -1. Prints BUFR Sec 1 information in json format\n" );
@@ -76,11 +82,14 @@ int read_args ( int _argc, char * _argv[] )
   PRINT_JSON_SEC2 = 0;
   PRINT_JSON_SEC3 = 0;
   PRINT_JSON_EXPANDED_TREE = 0;
+  PRINT_NDJSON = 0;
+  PRINT_NDJSON_MEANINGS = 0;
+  SNAPSHOT[0] = '\0';
 
   /*
      Read input options
   */
-  while ( ( iopt = getopt ( _argc, _argv, "hi:JXT01234" ) ) !=-1 )
+  while ( ( iopt = getopt ( _argc, _argv, "hi:JLmXT01234z:" ) ) !=-1 )
     switch ( iopt )
       {
       case 'X':
@@ -111,6 +120,14 @@ int read_args ( int _argc, char * _argv[] )
         PRINT_JSON_EXPANDED_TREE = 1;
         break;
 
+      case 'L':
+        PRINT_NDJSON = 1;
+        break;
+
+      case 'm':
+        PRINT_NDJSON_MEANINGS = 1;
+        break;
+
       case 'J':
         PRINT_JSON_SEC0 = 1;
         PRINT_JSON_SEC1 = 1;
@@ -151,13 +168,18 @@ int read_args ( int _argc, char * _argv[] )
           strcpy_safe ( ENTRADA, optarg );
         break;
 
+      case 'z':
+        if ( strlen ( optarg ) < sizeof ( SNAPSHOT ) )
+          strcpy_safe ( SNAPSHOT, optarg );
+        break;
+
       case 'h':
       default:
         print_usage();
         exit ( EXIT_SUCCESS );
       }
 
-  if ( ENTRADA[0] == '\0' )
+  if ( ENTRADA[0] == '\0' && SNAPSHOT[0] == '\0' )
     {
       printf ( "read_args(): It is needed an input file. Use -i option\n" );
       return -1;
@@ -192,9 +214,45 @@ int set_bufrdeco_mask ( struct bufrdeco *b )
   if ( PRINT_JSON_EXPANDED_TREE )
     b->mask |= BUFRDECO_OUTPUT_JSON_EXPANDED_TREE;
 
+  if ( PRINT_NDJSON )
+    b->mask |= BUFRDECO_OUTPUT_NDJSON_SUBSET_DATA;
+
+  if ( PRINT_NDJSON_MEANINGS )
+    b->mask |= BUFRDECO_OUTPUT_NDJSON_MEANINGS;
+
   return 0;
 }
 
+/*!
+  \fn int print_snapshot(void)
+  \brief Print the decoded subsets of the snapshot file SNAPSHOT
+  \return 0 if succeeded, 1 otherwise
+*/
+int print_snapshot ( void )
+{
+  struct bufrdeco_snapshot sn;
+  struct bufrdeco_subset_sequence_data s;
+  buf_t i, n;
+
+  if ( bufrdeco_snapshot_open ( &sn, SNAPSHOT ) )
+    {
+      printf ( "print_snapshot(): Cannot open '%s' or it is not a valid snapshot\n", SNAPSHOT );
+      return 1;
+    }
+
+  memset ( &s, 0, sizeof ( s ) );
+  n = sn.header->nsubsets;
+  for ( i = 0; i < n; i++ )
+    {
+      if ( bufrdeco_snapshot_get_subset ( &sn, i, &s ) == NULL )
+        break;
+      bufrdeco_print_subset_sequence_data ( &s );
+    }
+  bufrdeco_free_subset_sequence_data ( &s );
+  bufrdeco_snapshot_close ( &sn );
+  return i < n;
+}
+
 /*!
   \fn int main(int argc, char *argv[])
   \brief Main function for bufrdeco_json program
@@ -209,6 +267,9 @@ int main ( int argc, char *argv[] )
   if ( read_args ( argc, argv ) < 0 )
     exit ( EXIT_FAILURE );
 
+  if ( SNAPSHOT[0] )
+    exit ( print_snapshot () ? EXIT_FAILURE : EXIT_SUCCESS );
+
   bufrdeco_init ( &BUFR );
 
   // sets the bit mask according to readed args
@@ -209,6 +209,9 @@ struct stat INSTAT;
 char OWN[] = "bufrnoaa";
 char SEP[] = "\r\r\n";
 char FINAL_SEP[4];
+int DEDUP; /*!< if != 0 then skip the messages already seen (arguments -d and -D) */
+char DEDUP_FILE[256]; /*!< File where the hashes of messages already seen are kept among runs (argument -D) */
+struct bufrdeco_dedup SEEN; /*!< Hashes of messages already seen */
 
 /*!
   \fn int main(int argc, char *argv[])
@@ -222,12 +225,13 @@ char FINAL_SEP[4];
 */
 int main ( int argc, char *argv[] )
 {
-  size_t nb = 0, nc, nx = 0, nbuf = 0, nsel = 0, nerr = 0, i, nh = 0, nw;
+  size_t nb = 0, nc, nx = 0, nbuf = 0, nsel = 0, nerr = 0, ndup = 0, i, nh = 0, nw;
   FILE* ficin;
   FILE* ficout = NULL;
   FILE* ficol = NULL;
   unsigned char b[5], header[256];
   unsigned int expected = 0;
+  int sel;
   char name[256], namex[512], namec[512];
   struct timeval tini, tfin, tt;
 
@@ -240,6 +244,10 @@ int main ( int argc, char *argv[] )
       exit ( EXIT_FAILURE );
     }
 
+  // The messages seen in previous runs. The file does not exist in the first one
+  if ( DEDUP_FILE[0] )
+    bufrdeco_read_dedup ( &SEEN, DEDUP_FILE );
+
   // Check input
   if ( stat ( ENTRADA, &INSTAT ) )
     {
@@ -424,7 +432,14 @@ int main ( int argc, char *argv[] )
                       nbuf++;
                       if ( LISTF )
                         printf ( "%s\n", name );
-                      if ( bufr_is_selected ( name ) )
+                      sel = bufr_is_selected ( name );
+                      if ( sel && DEDUP && bufrdeco_dedup_check ( &SEEN, bufrdeco_buffer_hash ( BUFR, nb ) ) )
+                        {
+                          // the same message already got, maybe with other header or by other route
+                          ndup++;
+                          sel = 0;
+                        }
+                      if ( sel )
                         {
                           nsel++;
                           if ( INDIVIDUAL )
@@ -509,11 +524,17 @@ int main ( int argc, char *argv[] )
   gettimeofday ( &tfin, NULL );
   fclose ( ficin );
 
+  if ( DEDUP_FILE[0] && bufrdeco_write_dedup ( &SEEN, DEDUP_FILE ) )
+    printf ( "%s: Cannot write the hashes of messages seen in %s\n", OWN, DEDUP_FILE );
+  bufrdeco_free_dedup ( &SEEN );
+
   // A brief stat output
   if ( VERBOSE )
     {
       double tx;
       printf ( "Found %zu bufr reports. Selected: %zu. Wrong: %zu\n", nbuf, nsel, nerr );
+      if ( DEDUP )
+        printf ( "Duplicated: %zu. Dedup ratio: %.4lf\n", ndup, ( nsel + ndup ) ? ( double ) ndup / ( double ) ( nsel + ndup ) : 0.0 );
       timeval_substract ( &tt, &tfin, &tini );
       tx = ( double ) tt.tv_sec + ( double ) tt.tv_usec *1e-6;
       printf ( "%lf seg.  ", tx );
@@ -30,6 +30,7 @@
 #include <utime.h>
 #include <sys/time.h>
 #include <sys/stat.h>
+#include "bufrdeco.h"
 
 #define BLEN 1024
 // longitud maxima de un bufr 8 MB
@@ -46,6 +47,9 @@ extern char OWN[];
 extern char HEADER_MARK;
 extern char FINAL_SEP[4];
 extern char SEP[];
+extern int DEDUP;
+extern char DEDUP_FILE[256];
+extern struct bufrdeco_dedup SEEN;
 
 // Functions
 int is_bufr ( const unsigned char *b );
@@ -36,11 +36,13 @@ void print_usage ( void )
 {
   print_version();
   printf ( "Usage: \n" );
-  printf ( "\n%s -i input_file [-h][-v][-f][-l][-F prefix][-T T2_selection][-O selo][-S sels][-U selu][-P selp][-t selt][-X selx][-Z selz]\n" , OWN);
+  printf ( "\n%s -i input_file [-h][-v][-d][-D seen_file][-f][-l][-F prefix][-T T2_selection][-O selo][-S sels][-U selu][-P selp][-t selt][-X selx][-Z selz]\n" , OWN);
   printf ( "   -h Print this help\n" );
   printf ( "   -v Print information about build and version\n" );
   printf ( "   -i Input file. Complete input path file for NOAA *.bin bufr archive file\n" );
   printf ( "   -2 Input file is formatted in alternative form: Headers has '#' instead of '*' marks and no sep after '7777'\n");
+  printf ( "   -d Skip the selected messages already seen, as the same bulletin got by several routes\n" );
+  printf ( "   -D seen_file. As -d, also remembering the messages seen in previous runs in seen_file\n" );
   printf ( "   -l list the names of reports in input file\n" );
   printf ( "   -f Extract selected reports and write them in files, one per bufr message, as \n" );
   printf ( "      example '20110601213442_ISIE06_SBBR_012100_RRB.bufr'. First field in name is input file timestamp \n" );
@@ -163,12 +165,14 @@ int read_args ( int _argc, char * _argv[] )
   LISTF = 0;
   VERBOSE = 1;
   HEADER_MARK = '*';
+  DEDUP = 0;
+  DEDUP_FILE[0] = '\0';
   strcpy(FINAL_SEP, SEP);
   
   /*
      Read input options
   */
-  while ( ( iopt = getopt ( _argc, _argv, "hv2i:flF:O:P:qS:t:T:U:X:Z:" ) ) !=-1 )
+  while ( ( iopt = getopt ( _argc, _argv, "hv2dD:i:flF:O:P:qS:t:T:U:X:Z:" ) ) !=-1 )
     switch ( iopt )
       {
       case 'i':
@@ -179,6 +183,16 @@ int read_args ( int _argc, char * _argv[] )
         HEADER_MARK = '#';
         FINAL_SEP[0] = 0;
         break;
+      case 'd':
+        DEDUP = 1;
+        break;
+      case 'D':
+        if ( strlen ( optarg ) < 256 )
+          {
+            strcpy ( DEDUP_FILE, optarg );
+            DEDUP = 1;
+          }
+        break;
       case 'f':
         INDIVIDUAL = 1;
         break;
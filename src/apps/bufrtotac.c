@@ -89,6 +89,8 @@
 struct bufrdeco BUFR;
 struct metreport REPORT; /*!< stuct to set the parsed report */
 struct bufr2tac_subset_state STATE; /*!< Includes the info when parsing a subset sequence */
+struct bufr2tac_report_class REPORT_CLASS; /*!< The report type of latest message, reused while Section 1 and 3 are the same */
+struct bufr2tac_synop_batch SYNOP_BATCH; /*!< SYNOP template for the subsets of a compressed message */
 struct bufr2tac_error_stack ERRS; /*!< struct to store warnings and errors */
 
 const char SELF[]= "bufrtotac"; /*! < the name of this binary */
@@ -99,6 +101,16 @@ char INPUTFILE[BUFRDECO_PATH_LENGTH]; /*!< The pathname of input file */
 char OFFSETFILE[BUFRDECO_PATH_LENGTH + 8]; /*< The path name of optional file with bit offsets for non-compressed BUFR. */
 char OUTPUTFILE[BUFRDECO_PATH_LENGTH]; /*!< The pathname of output file */
 char BUFR_XFILE[BUFRDECO_PATH_LENGTH]; /*!< Pathname of the file in case of extract an embebed BUFR in the input file */
+char SPOOL_DIR[BUFRDECO_PATH_LENGTH]; /*!< Directory to watch for incoming BUFR files */
+char DONE_DIR[BUFRDECO_PATH_LENGTH]; /*!< Directory where to move the files processed in watch mode. If empty they are removed */
+char CREFS_DIR[BUFRDECO_PATH_LENGTH]; /*!< Directory of the cache of compressed references. If empty it is not used */
+char TIMAGES_DIR[BUFRDECO_PATH_LENGTH]; /*!< Directory of the images of merged tables. If empty they are not used */
+char DEDUP_FILE[BUFRDECO_PATH_LENGTH]; /*!< File where the hashes of messages already seen are kept among runs */
+int DEDUP; /*!< if != 0 then skip the messages already seen */
+char SNAPSHOT_DIR[BUFRDECO_PATH_LENGTH]; /*!< Directory where to write the snapshots of decoded subsets. If empty they are not written */
+struct bufrdeco_snapshot_builder SNAPSHOT; /*!< Decoded subsets of current message to write in a snapshot */
+char STORE_BASE[BUFRDECO_PATH_LENGTH]; /*!< Pathname of the store of observations, without suffix. If empty they are not stored */
+struct bufr2tac_store STORE; /*!< The store of observations */
 
 int VERBOSE; /*!< If != 0 the verbose output */
 int SHOW_SEQUENCE; /*!< Output explained sequence */
@@ -119,20 +131,23 @@ int PRINT_GEO; /*!< if != 0 then print latitude, longitude and altitude */
 int READ_OFFSETS; /*!< if != then read bit offsets */
 int WRITE_OFFSETS; /*!< if != 0 then write bit offsets */
 int USE_CACHE; /*!< if != 0 then use cache of tables */
+int PRELOAD_TABLES; /*!< if >= 0 then preload this number of newest versions of tables in cache, 0 as many as fit */
 int SUBSET ; /*!< Index of subset in a BUFR being parsed */
 int PRINT_JSON_DATA; /*!< If != 0 then the data subset is in json format */
+int PRINT_NDJSON_DATA; /*!< If != 0 then every data subset is printed as a flat json object in a line */
+int PRINT_NDJSON_MEANINGS; /*!< If != 0 then the flat json objects have the meanings of code and flag tables */
 int PRINT_JSON_SEC0;
 int PRINT_JSON_SEC1;
 int PRINT_JSON_SEC2;
 int PRINT_JSON_SEC3;
 int PRINT_JSON_EXPANDED_TREE;
 int LOCAL_TABLES; /*!< if != 0 then read and use local BUFR tables */
+int OUTPUT_PATTERN; /*!< if != 0 then OUTPUTFILE is a strftime(3) pattern and output file rolls with time */
+char STATS_FILE[BUFRDECO_PATH_LENGTH]; /*!< Pathname where to append runtime statistics in json. '-' is stderr */
+int STATS_PERIOD; /*!< if > 0 then the statistics are also dumped every STATS_PERIOD seconds */
 
 FILE *FL; /*!< Buffer to read the list of files */
 FILE *OUT; /*!< Buffer to write to OUTPUTFILE */
-#ifdef DEBUG_TIME
-  clock_t clk_start, clk_end;
-#endif
 
 /*!
   \fn int main(int argc, char *argv[])
@@ -146,231 +161,357 @@ FILE *OUT; /*!< Buffer to write to OUTPUTFILE */
 */
 int main ( int argc, char *argv[] )
 {
-  int first_subset, last_subset;
-  char subset_id[32];
-  struct bufrdeco_subset_sequence_data *seq;
-
 
   if ( bufrtotac_read_args ( argc, argv ) < 0 )
     exit ( EXIT_FAILURE );
 
   // init bufr struct
-#ifdef DEBUG_TIME      
-      clk_start = clock ();
-#endif
   if ( bufrdeco_init ( &BUFR ) )
     {
       printf ( "%s(): Cannot init bufr struct\n", SELF );
       return 1;
     }
-    
-#ifdef DEBUG_TIME        
-      clk_end = clock();  
-      print_timing (clk_start,clk_end,bufrdeco_init());
-#endif      
+
+  // The chunks of report are cleared only when written, so they are all cleared once here
+  bufr2tac_init_metreport ( &REPORT );
+  bufr2tac_init_subset_state ( &STATE );
+  bufr2tac_synop_batch_init ( &SYNOP_BATCH );
 
   /**** set bitmask according with args readed from shell ****/    
   bufrtotac_set_bufrdeco_bitmask (&BUFR);
+  bufrdeco_clean_stats ( &BUFR );
   
   /**** Set bufr tables dir ****/
   strcpy ( BUFR.bufrtables_dir, BUFRTABLES_DIR );
 
-  /**** Big loop. a cycle per file. Get input filenames from LISTOFFILES[] ****/
-  while ( get_bufrfile_path ( INPUTFILE, OFFSETFILE, ERR ) )
+  /**** Load the newest tables in cache before the first message ****/
+  if ( PRELOAD_TABLES >= 0 && bufrdeco_preload_tables ( &BUFR, PRELOAD_TABLES ) < 0 )
+    printf ( "%s(): Cannot preload the tables in cache\n", SELF );
+
+  /**** Remember the messages seen in previous runs. The file does not exist in the first one ****/
+  if ( DEDUP_FILE[0] )
+    bufrdeco_read_dedup ( &BUFR.dedup, DEDUP_FILE );
+
+  /**** The cache of rendered reports ****/
+  if ( USE_RENDER_CACHE && bufr2tac_render_cache_init ( &RENDER_CACHE, RENDER_CACHE_ENTRIES, RENDER_CACHE_BYTES ) )
+    printf ( "%s(): Cannot init the cache of rendered reports\n", SELF );
+
+  /**** The store of observations by station and time ****/
+  if ( STORE_BASE[0] && bufr2tac_store_open ( &STORE, STORE_BASE ) )
+    {
+      printf ( "%s(): Cannot open the store of observations '%s'\n", SELF, STORE_BASE );
+      exit ( EXIT_FAILURE );
+    }
+
+  /**** Watch a spool directory instead of a fixed list of files ****/
+  if ( SPOOL_DIR[0] )
     {
+      bufrtotac_watch_spool ();
+    }
+  else
+    {
+      /**** Big loop. a cycle per file. Get input filenames from LISTOFFILES[] ****/
+      while ( get_bufrfile_path ( INPUTFILE, OFFSETFILE, ERR ) )
+        {
+          if ( bufrtotac_roll_output () )
+            {
+              printf ( "%s\n", ERR );
+              exit ( EXIT_FAILURE );
+            }
+          bufrtotac_decode_file ();
+          NFILES ++;
+          bufrtotac_dump_stats ( 0 );
+        } // End of big loop parsing files
+    }
+
+  bufrtotac_print_filter_counters ( stderr );
+  bufrtotac_dump_stats ( 1 );
+  if ( DEDUP_FILE[0] && bufrdeco_write_dedup ( &BUFR.dedup, DEDUP_FILE ) )
+    printf ( "%s(): Cannot write the hashes of messages seen in '%s'\n", SELF, DEDUP_FILE );
+  bufrdeco_close ( &BUFR );
+  bufr2tac_free_subset_state ( &STATE );
+  bufr2tac_free_metreport ( &REPORT );
+  bufr2tac_synop_batch_free ( &SYNOP_BATCH );
+  bufr2tac_render_cache_free ( &RENDER_CACHE );
+  bufrdeco_snapshot_free ( &SNAPSHOT );
+  if ( STORE_BASE[0] && bufr2tac_store_close ( &STORE ) )
+    printf ( "%s(): Cannot update the index of store '%s'\n", SELF, STORE_BASE );
+  
+  // Close the file if needed
+  if (OUTPUTFILE[0] && OUT != NULL)
+    fclose (OUT);
+  bufrtotac_close_outputs ();
+  
+  exit ( EXIT_SUCCESS );
+}
+
+/*!
+  \fn int bufrtotac_open_snapshot(struct bufrdeco_snapshot *sn, int first_subset, int last_subset)
+  \brief Open the snapshot of the message in BUFR written in SNAPSHOT_DIR by a previous run
+  \param [out] sn pointer to the snapshot to open
+  \param [in] first_subset first subset wanted
+  \param [in] last_subset last subset wanted
+  \return 0 if the snapshot is there with all the subsets wanted, 1 otherwise. Then \a sn is not open
+*/
+int bufrtotac_open_snapshot ( struct bufrdeco_snapshot *sn, int first_subset, int last_subset )
+{
+  char snapshot_file[BUFRDECO_PATH_LENGTH + 32];
+  uint32_t n;
+
+  snprintf ( snapshot_file, sizeof ( snapshot_file ), "%s%016" PRIx64 ".snp", SNAPSHOT_DIR, bufrdeco_message_hash ( &BUFR ) );
+  if ( bufrdeco_snapshot_open ( sn, snapshot_file ) )
+    return 1;
+
+  // Subsets are added in order and without gaps, so checking the first and last is enough
+  n = sn->header->nsubsets;
+  if ( sn->header->hash != bufrdeco_message_hash ( &BUFR ) || n != ( uint32_t ) ( last_subset - first_subset + 1 ) ||
+       sn->sub[0].ss != ( uint32_t ) first_subset || sn->sub[n - 1].ss != ( uint32_t ) last_subset )
+    {
+      bufrdeco_snapshot_close ( sn );
+      return 1;
+    }
+  return 0;
+}
+
+/*!
+  \fn int bufrtotac_decode_file(void)
+  \brief Decode the BUFR file in INPUTFILE and print the results to OUT
+  \return 0 if the file was decoded, 1 if it could not be read or parsed
+
+  The struct \ref bufrdeco BUFR is reset at the end, but the tables (and cache of tables if used) are kept,
+  so the same decoder context can be used for a long sequence of files.
+
+  With SNAPSHOT_DIR set, if the snapshot of the message was already written there, the subsets are got from it
+  instead of decoding them again
+*/
+int bufrtotac_decode_file ( void )
+{
+  int first_subset, last_subset;
+  char subset_id[32];
+  char snapshot_file[BUFRDECO_PATH_LENGTH + 32];
+  struct bufrdeco_subset_sequence_data *seq;
+  struct bufr2tac_store_record record;
+  struct bufrdeco_snapshot sn;
+  int from_snapshot = 0;
+  int from_batch = 0;
+  uint64_t t0;
+  uint8_t *bufrx = NULL;
+  size_t n = 0;
+  int res;
+
 #ifdef __DEBUG      
-      printf ( "####### %s ######\n", INPUTFILE );
+  printf ( "####### %s ######\n", INPUTFILE );
 #endif      
+  if ( DEBUG )
+    printf ( "# %s\n", INPUTFILE );
+
+  // Skip unwanted files before reading them fully and loading tables
+  if ( EXTRACT == 0 && bufrtotac_prefilter ( INPUTFILE ) )
+    {
       if ( DEBUG )
-        printf ( "# %s\n", INPUTFILE );
-
-      // The following call to bufrdeco_read_bufr() does the folowing tasks:
-      // - Read the file and checks the marks at the begining and end to see wheter is a BUFR file
-      // - Init the structs and allocate the needed memory if not done previously
-      // - Splits and parse the BUFR sections (without expanding descriptors nor parsing data)
-      // - Reads the needed Table files and store them in memory.
-      //
-      // If EXTRACT != 0 then the function bufrdeco_extract_bufr() is used instead of bufrdeco_read_bufr()
-      // This act in the same way, but search and extract the first BUFR embebed in a file.
-#ifdef DEBUG_TIME      
-      clk_start = clock ();
-#endif
-
-      if ( ( EXTRACT && bufrdeco_extract_bufr ( &BUFR, INPUTFILE, BUFR_XFILE) ) ||
-           ( EXTRACT == 0 && bufrdeco_read_bufr ( &BUFR, INPUTFILE ) ) )
+        printf ( "# Skipped by prefilter\n" );
+      return 1;
+    }
+
+  // With the cache of rendered reports the file is read here to get its key. If all the reports wanted
+  // are in cache they are written and nothing else is done
+  RENDER_KEY = 0;
+  if ( bufrtotac_render_cache_usable () )
+    {
+      BUFR.stats.read_start = bufrdeco_stats_clock ( &BUFR );
+      if ( ( bufrx = bufrtotac_read_file ( INPUTFILE, &n ) ) != NULL )
         {
-          if ( DEBUG )
-            printf ( "# %s\n", BUFR.error );
-          NFILES++;
-          bufrdeco_reset ( &BUFR );
-          continue;
+          RENDER_KEY = bufrtotac_render_key ( bufrx, n, INPUTFILE );
+          if ( bufrtotac_print_cached_message () == 0 )
+            {
+              if ( DEBUG )
+                printf ( "# Reports got from cache\n" );
+              free ( bufrx );
+              BUFR.stats.read_start = 0;
+              bufrtotac_flush_outputs ();
+              return 0;
+            }
         }
-#ifdef DEBUG_TIME        
-      clk_end = clock();  
-      print_timing (clk_start,clk_end,bufrdeco_extract_bufr());
-#endif      
+    }
 
-      // Check if have to read bit offsets file
-      if ( READ_OFFSETS &&
-           BUFR.sec3.compressed == 0 &&
-           BUFR.sec3.subsets > 1 )
+  // The following call to bufrdeco_read_bufr() does the folowing tasks:
+  // - Read the file and checks the marks at the begining and end to see wheter is a BUFR file
+  // - Init the structs and allocate the needed memory if not done previously
+  // - Splits and parse the BUFR sections (without expanding descriptors nor parsing data)
+  // - Reads the needed Table files and store them in memory.
+  //
+  // If EXTRACT != 0 then the function bufrdeco_extract_bufr() is used instead of bufrdeco_read_bufr()
+  // This act in the same way, but search and extract the first BUFR embebed in a file.
+  // If the file was already read for the cache of rendered reports then bufrdeco_read_buffer() is used
+
+  if ( EXTRACT )
+    res = bufrdeco_extract_bufr ( &BUFR, INPUTFILE, BUFR_XFILE );
+  else if ( bufrx != NULL )
+    res = bufrdeco_read_buffer ( &BUFR, bufrx, n );
+  else
+    res = bufrdeco_read_bufr ( &BUFR, INPUTFILE );
+  free ( bufrx );
+
+  if ( res )
+    {
+      if ( DEBUG )
+        printf ( "# %s\n", BUFR.error );
+      bufrdeco_reset ( &BUFR );
+      return 1;
+    }
+
+  // Check if have to read bit offsets file
+  if ( READ_OFFSETS &&
+       BUFR.sec3.compressed == 0 &&
+       BUFR.sec3.subsets > 1 )
+    {
+      bufrdeco_read_subset_offset_bits ( &BUFR, OFFSETFILE );
+    }
+
+  /* Try to guess a GTS header from filename*/
+  GTS_HEADER = guess_gts_header ( &BUFR.header, INPUTFILE );   // GTS_HEADER = 1 if succeeded
+  if ( GTS_HEADER && DEBUG )
+    printf ( "# Guessed GTS Header: %s %s %s %s %s\n", BUFR.header.timestamp, BUFR.header.bname, BUFR.header.center,
+             BUFR.header.dtrel, BUFR.header.order );
+
+  /* Prints sections if verbose */
+  if ( VERBOSE )
+    {
+      print_sec0_info ( &BUFR );
+      print_sec1_info ( &BUFR );
+      print_sec3_info ( &BUFR );
+      print_sec4_info ( &BUFR );
+    }
+
+  // To get any data from any subset  we need to parse the tree
+  if ( bufrdeco_parse_tree ( &BUFR ) )
+    {
+      if ( DEBUG )
+        printf ( "# %s", BUFR.error );
+      bufrdeco_reset ( &BUFR );
+      return 1;
+    }
+  if (PRINT_JSON_EXPANDED_TREE)
+    bufrdeco_print_json_tree( &BUFR);
+  
+  if ( VERBOSE )
+    bufrdeco_print_tree ( &BUFR );
+
+  first_subset = FIRST_SUBSET;
+  last_subset = LAST_SUBSET;
+  
+  // Fix first and last subset
+  if ( first_subset >= ( int ) BUFR.sec3.subsets )
+    goto fin;
+
+  if ( last_subset < first_subset)
+    last_subset = BUFR.sec3.subsets - 1;
+
+  if ( SNAPSHOT_DIR[0] && bufrtotac_open_snapshot ( &sn, first_subset, last_subset ) == 0 )
+    {
+      from_snapshot = 1;
+      if ( DEBUG )
+        printf ( "# Subsets got from snapshot\n" );
+    }
+
+  for ( SUBSET = first_subset; SUBSET <= last_subset ; SUBSET++ )
+    {
+      if ( from_batch )
         {
-          #ifdef DEBUG_TIME      
-             clk_start = clock ();
-          #endif
-          bufrdeco_read_subset_offset_bits ( &BUFR, OFFSETFILE );
-#ifdef DEBUG_TIME        
-          clk_end = clock();  
-          print_timing (clk_start,clk_end,bufrdeco_read_subset_offset_bits());
-#endif      
+          // The SYNOP is got from the template and the columns of compressed data, with no decode of subset
+          t0 = bufrdeco_stats_clock ( &BUFR );
+          if ( bufrtotac_parse_subset_batch ( &REPORT, &SYNOP_BATCH, &BUFR, ERR ) && DEBUG )
+            fprintf ( stderr, "# %s\n", ERR );
+          bufrtotac_print_report ( &REPORT );
+          bufrdeco_stats_add ( &BUFR, BUFRDECO_STATS_TAC, t0 );
+          if ( BUFR.mask & BUFRDECO_COLLECT_STATS )
+            BUFR.stats.subsets++;
+          continue;
         }
 
-      /* Try to guess a GTS header from filename*/
-      GTS_HEADER = guess_gts_header ( &BUFR.header, INPUTFILE );   // GTS_HEADER = 1 if succeeded
-      if ( GTS_HEADER && DEBUG )
-        printf ( "# Guessed GTS Header: %s %s %s %s %s\n", BUFR.header.timestamp, BUFR.header.bname, BUFR.header.center,
-                 BUFR.header.dtrel, BUFR.header.order );
-
-      /* Prints sections if verbose */
-      if ( VERBOSE )
+      if ( from_snapshot )
         {
-          print_sec0_info ( &BUFR );
-          print_sec1_info ( &BUFR );
-          print_sec3_info ( &BUFR );
-          print_sec4_info ( &BUFR );
+          if ( ( seq = bufrdeco_snapshot_get_subset ( &sn, SUBSET - first_subset, &BUFR.seq ) ) == NULL )
+            snprintf ( BUFR.error, sizeof ( BUFR.error ), "Cannot get subset %d from snapshot\n", SUBSET );
         }
+      else
+        seq = bufrdeco_get_target_subset_sequence_data ( SUBSET, &BUFR );
 
-      // To get any data from any subset  we need to parse the tree
-#ifdef DEBUG_TIME      
-      clk_start = clock ();
-#endif
-      if ( bufrdeco_parse_tree ( &BUFR ) )
+      if ( seq == NULL )
         {
           if ( DEBUG )
             printf ( "# %s", BUFR.error );
-          NFILES++;
-          bufrdeco_reset ( &BUFR );
-          continue;
+          goto fin;
         }
-#ifdef DEBUG_TIME        
-      clk_end = clock();  
-      print_timing (clk_start,clk_end,bufrdeco_parse_tree());
-#endif      
-      if (PRINT_JSON_EXPANDED_TREE)
-        bufrdeco_print_json_tree( &BUFR);
-      
-      if ( VERBOSE )
-        bufrdeco_print_tree ( &BUFR );
-
-      first_subset = FIRST_SUBSET;
-      last_subset = LAST_SUBSET;
-      
-      // Fix first and last subset
-      if ( first_subset >= ( int ) BUFR.sec3.subsets )
-        goto fin;
 
-      if ( last_subset < first_subset)
-        last_subset = BUFR.sec3.subsets - 1;
+      if ( SNAPSHOT_DIR[0] && from_snapshot == 0 && bufrdeco_snapshot_add_subset ( &SNAPSHOT, seq ) && DEBUG )
+        printf ( "# Cannot add subset %d to snapshot\n", SUBSET );
 
-      for ( SUBSET = first_subset; SUBSET <= last_subset ; SUBSET++ )
+      if ( VERBOSE )
         {
-#ifdef DEBUG_TIME      
-          clk_start = clock ();
-#endif          
-          if ( ( seq = bufrdeco_get_target_subset_sequence_data ( SUBSET, &BUFR ) ) == NULL )
+          if ( ( SUBSET == first_subset ) && BUFR.sec3.compressed && BUFR.refs.nd )
+            print_bufrdeco_compressed_data_references ( & ( BUFR.refs ) );
+          if ( BUFR.mask & BUFRDECO_OUTPUT_HTML )
             {
-              if ( DEBUG )
-                printf ( "# %s", BUFR.error );
-              goto fin;
+              snprintf ( subset_id, sizeof ( subset_id ), "subset_%d", SUBSET );
+              bufrdeco_print_subset_sequence_data_tagged_html ( seq, subset_id );
             }
-#ifdef DEBUG_TIME        
-          clk_end = clock();  
-          print_timing (clk_start, clk_end,bufrdeco_get_target_subset_sequence_data());
-#endif      
+          else
+            bufrdeco_print_subset_sequence_data ( seq );
+        }
 
-          if ( VERBOSE )
+      if ( ! NOTAC )
+        {
+          // Here we perform the decode to TAC
+          t0 = bufrdeco_stats_clock ( &BUFR );
+          res = 0;
+          if ( BUFR.sec3.ndesc &&  bufrtotac_parse_subset_sequence ( &REPORT, &STATE, &BUFR, ERR ) )
             {
-              if ( ( SUBSET == first_subset ) && BUFR.sec3.compressed )
-                print_bufrdeco_compressed_data_references ( & ( BUFR.refs ) );
-              if ( BUFR.mask & BUFRDECO_OUTPUT_HTML )
-                {
-                  snprintf ( subset_id, sizeof ( subset_id ), "subset_%d", SUBSET );
-                  bufrdeco_print_subset_sequence_data_tagged_html ( seq, subset_id );
-                }
-              else
-                bufrdeco_print_subset_sequence_data ( seq );
+              if ( DEBUG )
+                fprintf ( stderr, "# %s\n", ERR );
+              res = 1;
             }
-
-          if ( ! NOTAC )
+          else if ( STORE_BASE[0] && bufr2tac_store_set_record ( &record, &REPORT, seq ) == 0 &&
+                    bufr2tac_store_append ( &STORE, &record ) && DEBUG )
+            printf ( "# Cannot append subset %d to store\n", SUBSET );
+
+          // And here print the results
+          bufrtotac_print_report ( &REPORT );
+          bufrdeco_stats_add ( &BUFR, BUFRDECO_STATS_TAC, t0 );
+
+          // The next SYNOP of a compressed message are got from a template if possible
+          if ( SUBSET == first_subset && SUBSET < last_subset && res == 0 && bufrtotac_synop_batch_usable () &&
+               bufr2tac_synop_batch_prepare ( &SYNOP_BATCH, &REPORT, &BUFR,
+                                              bufr2tac_report_type_name ( REPORT_CLASS.type ), ERR ) == 0 )
             {
-              // Here we perform the decode to TAC
-#ifdef DEBUG_TIME      
-              clk_start = clock ();
-#endif          
-              if ( BUFR.sec3.ndesc &&  bufrtotac_parse_subset_sequence ( &REPORT, &STATE, &BUFR, ERR ) )
-                {
-                  if ( DEBUG )
-                    fprintf ( stderr, "# %s\n", ERR );
-                }
-#ifdef DEBUG_TIME        
-              clk_end = clock();  
-              print_timing (clk_start, clk_end, bufrtotac_parse_subset_sequence());
-#endif      
-
-              // And here print the results
-              if ( XML )
-                {
-                  if ( SUBSET == 0 )
-                    fprintf ( OUT, "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n" );
-                  print_xml ( stdout, &REPORT );
-                }
-              else if ( JSON )
-                {
-                  print_json ( OUT, &REPORT );
-                }
-              else if ( CSV )
-                {
-                  if ( SUBSET == 0 )
-                    fprintf ( OUT, "TYPE,FILE,DATETIME,INDEX,NAME,COUNTRY,LATITUDE,LONGITUDE,ALTITUDE,REPORT\n" );
-                  print_csv ( OUT, &REPORT );
-                }
-              else if ( HTML )
-                {
-                  print_html ( OUT, &REPORT );
-                }
-              else
-                {
-                  print_plain ( OUT, &REPORT );
-                }
+              from_batch = 1;
+              if ( DEBUG )
+                printf ( "# Next subsets got from the SYNOP template\n" );
             }
         }
-    fin:
-      ;
-
-      // check if has to write bit offsets file
-      if ( BUFR.sec3.compressed == 0 &&
-           BUFR.sec3.subsets > 1 &&
-           WRITE_OFFSETS )
-        {
-          bufrdeco_write_subset_offset_bits ( &BUFR, OFFSETFILE );
-        }
+    }
+fin:
+  if ( from_snapshot )
+    bufrdeco_snapshot_close ( &sn );
+
+  // check if has to write bit offsets file
+  if ( BUFR.sec3.compressed == 0 &&
+       BUFR.sec3.subsets > 1 &&
+       WRITE_OFFSETS )
+    {
+      bufrdeco_write_subset_offset_bits ( &BUFR, OFFSETFILE );
+    }
 
-#ifdef DEBUG_TIME      
-      clk_start = clock ();
-#endif          
-      bufrdeco_reset ( &BUFR );
-#ifdef DEBUG_TIME        
-      clk_end = clock();  
-      print_timing (clk_start, clk_end, bufrdeco_reset());
-#endif      
-      NFILES ++;
-    } // End of big loop parsing files
+  // Write the snapshot of the decoded subsets, named by the hash of message
+  if ( SNAPSHOT_DIR[0] && SNAPSHOT.nsub )
+    {
+      snprintf ( snapshot_file, sizeof ( snapshot_file ), "%s%016" PRIx64 ".snp", SNAPSHOT_DIR, bufrdeco_message_hash ( &BUFR ) );
+      if ( bufrdeco_snapshot_write ( &SNAPSHOT, bufrdeco_message_hash ( &BUFR ), snapshot_file ) && DEBUG )
+        printf ( "# Cannot write snapshot '%s'\n", snapshot_file );
+    }
+  bufrdeco_snapshot_clean ( &SNAPSHOT );
 
-  bufrdeco_close ( &BUFR );
-  
-  // Close the file if needed
-  if (OUTPUTFILE[0])
-    fclose (OUT);
-  
-  exit ( EXIT_SUCCESS );
+  bufrtotac_flush_outputs ();
+  bufrdeco_reset ( &BUFR );
+  return 0;
 }
@@ -24,11 +24,80 @@
 #include "bufr2tac.h"
 #include "bufrdeco.h"
 
+/*!
+  \def BUFRTOTAC_FILTER_DIM
+  \brief Max number of values for every key in prefilter
+*/
+#define BUFRTOTAC_FILTER_DIM (32)
+
+/*!
+  \struct bufrtotac_filter
+  \brief Conditions of prefilter set with -F options and counters of skipped files
+*/
+struct bufrtotac_filter {
+    int active; /*!< If != 0 then the prefilter is used */
+    int ncategory; /*!< Number of data categories in category[] */
+    int category[BUFRTOTAC_FILTER_DIM]; /*!< Accepted data categories */
+    int nsubcategory; /*!< Number of subcategories in subcategory[] */
+    int subcategory[BUFRTOTAC_FILTER_DIM]; /*!< Accepted data subcategories */
+    int ncentre; /*!< Number of centres in centre[] */
+    int centre[BUFRTOTAC_FILTER_DIM]; /*!< Accepted originating centres */
+    int nmaster_version; /*!< Number of versions in master_version[] */
+    int master_version[BUFRTOTAC_FILTER_DIM]; /*!< Accepted versions of master table */
+    int ntemplate; /*!< Number of descriptors in templ[] */
+    struct bufr_descriptor templ[BUFRTOTAC_FILTER_DIM]; /*!< Accepted sec3 templates */
+    int has_from; /*!< If != 0 then from is used */
+    int has_to; /*!< If != 0 then to is used */
+    time_t from; /*!< Messages with time in sec1 before this are skipped */
+    time_t to; /*!< Messages with time in sec1 after this are skipped */
+    unsigned int accepted; /*!< Files which passed the prefilter */
+    unsigned int unreadable; /*!< Files whose sections cannot be read, passed to full decoder */
+    unsigned int skipped_category; /*!< Files skipped by data category */
+    unsigned int skipped_subcategory; /*!< Files skipped by data subcategory */
+    unsigned int skipped_centre; /*!< Files skipped by originating centre */
+    unsigned int skipped_master_version; /*!< Files skipped by master table version */
+    unsigned int skipped_time; /*!< Files skipped by time window */
+    unsigned int skipped_template; /*!< Files skipped by sec3 template */
+};
+
+/*!
+  \def BUFRTOTAC_OUTPUTS_DIM
+  \brief Max number of outputs set with -O options
+*/
+#define BUFRTOTAC_OUTPUTS_DIM (8)
+
+/*!
+  \enum bufrtotac_output_format
+  \brief Formats of an output set with -O option
+*/
+enum bufrtotac_output_format {
+    BUFRTOTAC_OUTPUT_PLAIN = 0, /*!< TAC reports, a line per report */
+    BUFRTOTAC_OUTPUT_JSON, /*!< json objects */
+    BUFRTOTAC_OUTPUT_CSV, /*!< labeled csv */
+    BUFRTOTAC_OUTPUT_XML, /*!< xml */
+    BUFRTOTAC_OUTPUT_HTML /*!< TAC reports in html */
+};
+
+/*!
+  \struct bufrtotac_output
+  \brief An output set with -O option. All of them are written from the same decoded reports
+*/
+struct bufrtotac_output {
+    enum bufrtotac_output_format format; /*!< Format of reports */
+    char path[BUFRDECO_PATH_LENGTH]; /*!< Pathname of file. '-' is stdout */
+    FILE* f; /*!< Stream opened */
+    int header; /*!< If != 0 the csv or xml header has already been written */
+    struct bufrdeco_output_buffer ob; /*!< Buffer where reports are written before sending them to f */
+    struct bufr2tac_sink sink; /*!< Sink writing into ob */
+};
+
 extern struct bufrdeco BUFR;
 extern struct bufrdeco_subset_sequence_data SEQ;
 extern struct bufrdeco_compressed_data_references REF;
 extern struct metreport REPORT;
 extern struct bufr2tac_subset_state STATE;
+extern struct bufr2tac_report_class REPORT_CLASS;
+extern struct bufr2tac_synop_batch SYNOP_BATCH;
 extern struct bufr2tac_error_stack ERRS;
 
 extern const char SELF[];
@@ -39,6 +108,16 @@ extern char BUFR_XFILE[BUFRDECO_PATH_LENGTH];
 extern char OFFSETFILE[BUFRDECO_PATH_LENGTH + 8];
 extern char BUFRTABLES_DIR[BUFRDECO_PATH_LENGTH];
 extern char LISTOFFILES[BUFRDECO_PATH_LENGTH];
+extern char SPOOL_DIR[BUFRDECO_PATH_LENGTH];
+extern char DONE_DIR[BUFRDECO_PATH_LENGTH];
+extern char CREFS_DIR[BUFRDECO_PATH_LENGTH];
+extern char TIMAGES_DIR[BUFRDECO_PATH_LENGTH];
+extern char DEDUP_FILE[BUFRDECO_PATH_LENGTH];
+extern int DEDUP;
+extern char SNAPSHOT_DIR[BUFRDECO_PATH_LENGTH];
+extern struct bufrdeco_snapshot_builder SNAPSHOT;
+extern char STORE_BASE[BUFRDECO_PATH_LENGTH];
+extern struct bufr2tac_store STORE;
 extern int NFILES;
 extern int SUBSET;
 extern int GTS_HEADER;
@@ -57,15 +136,29 @@ extern int FIRST_SUBSET, LAST_SUBSET;
 extern int READ_OFFSETS;
 extern int WRITE_OFFSETS;
 extern int USE_CACHE;
+extern int PRELOAD_TABLES;
 extern int PRINT_JSON_DATA;
+extern int PRINT_NDJSON_DATA;
+extern int PRINT_NDJSON_MEANINGS;
 extern int PRINT_JSON_SEC0;
 extern int PRINT_JSON_SEC1;
 extern int PRINT_JSON_SEC2;
 extern int PRINT_JSON_SEC3;
 extern int PRINT_JSON_EXPANDED_TREE;
 extern int LOCAL_TABLES;
+extern int OUTPUT_PATTERN;
+extern char STATS_FILE[BUFRDECO_PATH_LENGTH];
+extern int STATS_PERIOD;
 extern FILE* FL;
 extern FILE* OUT;
+extern struct bufrtotac_filter FILTER;
+extern struct bufrtotac_output OUTPUTS[BUFRTOTAC_OUTPUTS_DIM];
+extern int NOUTPUTS;
+extern int USE_RENDER_CACHE;
+extern size_t RENDER_CACHE_ENTRIES;
+extern size_t RENDER_CACHE_BYTES;
+extern struct bufr2tac_render_cache RENDER_CACHE;
+extern uint64_t RENDER_KEY;
 
 // functions
 void bufrtotac_print_version(void);
@@ -73,5 +166,24 @@ void bufrtotac_print_usage(void);
 int bufrtotac_set_bufrdeco_bitmask(struct bufrdeco* b);
 int bufrtotac_read_args(int _argc, char* _argv[]);
 char* get_bufrfile_path(char* filename, char* fileoffset, char* err);
+int bufrtotac_roll_output(void);
+int bufrtotac_dump_stats(int force);
+int bufrtotac_open_snapshot(struct bufrdeco_snapshot* sn, int first_subset, int last_subset);
+int bufrtotac_decode_file(void);
+int bufrtotac_watch_spool(void);
+int bufrtotac_add_filter(const char* arg);
+int bufrtotac_prefilter(const char* filename);
+void bufrtotac_print_filter_counters(FILE* f);
+int bufrtotac_add_output(const char* arg);
+int bufrtotac_print_outputs(const struct metreport* m);
+int bufrtotac_flush_outputs(void);
+int bufrtotac_close_outputs(void);
+int bufrtotac_print_report(const struct metreport* m);
+int bufrtotac_render_cache_usable(void);
+uint64_t bufrtotac_render_key(const uint8_t* bufr, size_t size, const char* filename);
+int bufrtotac_print_cached_message(void);
+uint8_t* bufrtotac_read_file(const char* filename, size_t* size);
 int bufrtotac_parse_subset_sequence(struct metreport* m, struct bufr2tac_subset_state* st, struct bufrdeco* b,
     char* err);
+int bufrtotac_synop_batch_usable(void);
+int bufrtotac_parse_subset_batch(struct metreport* m, struct bufr2tac_synop_batch* sb, struct bufrdeco* b, char* err);
@@ -0,0 +1,259 @@
+/***************************************************************************
+ *   Copyright (C) 2013-2026 by Guillermo Ballester Valor                  *
+ *   gbv@ogimet.com                                                        *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.             *
+ ***************************************************************************/
+/*!
+ \file bufrtotac_filter.c
+ \brief file with the code of prefilter in binary bufrtotac
+
+ The prefilter checks sec0, sec1 and sec3 of a BUFR file using bufrdeco_fast_read_sec_0_1_3(), so the messages
+ which are not wanted are rejected before reading the whole file and loading any table.
+ */
+#ifndef CONFIG_H
+# include "config.h"
+# define CONFIG_H
+#endif
+
+#include "bufrtotac.h"
+
+struct bufrtotac_filter FILTER; /*!< The prefilter set with -F options */
+
+/*!
+  \fn static int bufrtotac_filter_parse_list(int *list, int *n, const char *val)
+  \brief Parse a list of integers separated by commas
+  \param [out] list array where to set the integers. Its dimension is BUFRTOTAC_FILTER_DIM
+  \param [in,out] n number of integers already in list
+  \param [in] val the string with the list
+  \return 0 if succeeded, 2 if there are more than BUFRTOTAC_FILTER_DIM integers, 1 otherwise
+*/
+static int bufrtotac_filter_parse_list ( int *list, int *n, const char *val )
+{
+  char *c;
+  long v;
+
+  while ( *val )
+    {
+      v = strtol ( val, &c, 10 );
+      if ( c == val )
+        return 1;
+      if ( *n >= BUFRTOTAC_FILTER_DIM )
+        return 2;
+      list[ ( *n ) ++] = ( int ) v;
+      if ( *c == ',' )
+        c++;
+      else if ( *c )
+        return 1;
+      val = c;
+    }
+  return 0;
+}
+
+/*!
+  \fn static int bufrtotac_filter_parse_time(time_t *t, const char *val)
+  \brief Parse a time as YYYYMMDDHHMM[SS] in UTC
+  \param [out] t result as seconds since epoch
+  \param [in] val string with the time
+  \return 0 if succeeded, 1 otherwise
+*/
+static int bufrtotac_filter_parse_time ( time_t *t, const char *val )
+{
+  struct tm tim;
+
+  memset ( &tim, 0, sizeof ( tim ) );
+  if ( sscanf ( val, "%4d%2d%2d%2d%2d%2d", &tim.tm_year, &tim.tm_mon, &tim.tm_mday, &tim.tm_hour,
+                &tim.tm_min, &tim.tm_sec ) < 5 )
+    return 1;
+  tim.tm_year -= 1900;
+  tim.tm_mon -= 1;
+  *t = timegm ( &tim );
+  return 0;
+}
+
+/*!
+  \fn int bufrtotac_add_filter(const char *arg)
+  \brief Add a condition to prefilter from an argument of -F option
+  \param [in] arg string as key=value[,value...]
+  \return 0 if succeeded, 2 if a key gets more than BUFRTOTAC_FILTER_DIM values, 1 otherwise
+
+  Valid keys are 'category', 'subcategory', 'centre', 'master_version' and 'template' with a list of values,
+  and 'from' and 'to' with a time as YYYYMMDDHHMM. A message is accepted if its value is one in the list for every
+  key used. The 'template' values are descriptors as 307080, and a message is accepted if one of them is in the
+  unexpanded descriptors of sec3.
+*/
+int bufrtotac_add_filter ( const char *arg )
+{
+  const char *val;
+  size_t nk;
+  int i, res, aux[BUFRTOTAC_FILTER_DIM], naux = 0;
+
+  if ( ( val = strchr ( arg, '=' ) ) == NULL )
+    return 1;
+  nk = val - arg;
+  val++;
+
+  FILTER.active = 1;
+  if ( nk == 8 && strncmp ( arg, "category", nk ) == 0 )
+    return bufrtotac_filter_parse_list ( FILTER.category, &FILTER.ncategory, val );
+  else if ( nk == 11 && strncmp ( arg, "subcategory", nk ) == 0 )
+    return bufrtotac_filter_parse_list ( FILTER.subcategory, &FILTER.nsubcategory, val );
+  else if ( nk == 6 && strncmp ( arg, "centre", nk ) == 0 )
+    return bufrtotac_filter_parse_list ( FILTER.centre, &FILTER.ncentre, val );
+  else if ( nk == 14 && strncmp ( arg, "master_version", nk ) == 0 )
+    return bufrtotac_filter_parse_list ( FILTER.master_version, &FILTER.nmaster_version, val );
+  else if ( nk == 8 && strncmp ( arg, "template", nk ) == 0 )
+    {
+      if ( ( res = bufrtotac_filter_parse_list ( aux, &naux, val ) ) )
+        return res;
+      if ( FILTER.ntemplate + naux > BUFRTOTAC_FILTER_DIM )
+        return 2;
+      for ( i = 0; i < naux; i++ )
+        uint32_t_to_descriptor ( &FILTER.templ[FILTER.ntemplate++], ( uint32_t ) aux[i] );
+      return 0;
+    }
+  else if ( nk == 4 && strncmp ( arg, "from", nk ) == 0 )
+    {
+      FILTER.has_from = 1;
+      return bufrtotac_filter_parse_time ( &FILTER.from, val );
+    }
+  else if ( nk == 2 && strncmp ( arg, "to", nk ) == 0 )
+    {
+      FILTER.has_to = 1;
+      return bufrtotac_filter_parse_time ( &FILTER.to, val );
+    }
+  return 1;
+}
+
+/*!
+  \fn static int bufrtotac_filter_in_list(const int *list, int n, int needle)
+  \brief Check if an integer is in a list. An empty list accepts everything
+  \param [in] list array of integers
+  \param [in] n number of integers in list
+  \param [in] needle integer to find
+  \return 1 if found or list is empty, 0 otherwise
+*/
+static int bufrtotac_filter_in_list ( const int *list, int n, int needle )
+{
+  int i;
+
+  if ( n == 0 )
+    return 1;
+  for ( i = 0; i < n; i++ )
+    if ( list[i] == needle )
+      return 1;
+  return 0;
+}
+
+/*!
+  \fn int bufrtotac_prefilter(const char *filename)
+  \brief Check if a BUFR file pass the prefilter
+  \param [in] filename pathname of BUFR file
+  \return 0 if the file must be decoded, 1 if it has to be skipped
+
+  Only sec0, sec1 and sec3 are read. The counters in FILTER are updated with the reason of every skip.
+  If the sections cannot be read the file is not skipped, so the full decoder reports the error.
+*/
+int bufrtotac_prefilter ( const char *filename )
+{
+  struct bufr_sec0 s0;
+  struct bufr_sec1 s1;
+  struct bufr_sec3 s3;
+  struct tm tim;
+  time_t t;
+  uint32_t i;
+  int j;
+
+  if ( FILTER.active == 0 )
+    return 0;
+
+  if ( bufrdeco_fast_read_sec_0_1_3 ( &s0, &s1, &s3, ( char * ) filename, ERR, ERR_SIZE ) )
+    {
+      FILTER.unreadable++;
+      return 0;
+    }
+
+  if ( bufrtotac_filter_in_list ( FILTER.category, FILTER.ncategory, s1.category ) == 0 )
+    {
+      FILTER.skipped_category++;
+      return 1;
+    }
+
+  if ( bufrtotac_filter_in_list ( FILTER.subcategory, FILTER.nsubcategory, s1.subcategory ) == 0 )
+    {
+      FILTER.skipped_subcategory++;
+      return 1;
+    }
+
+  if ( bufrtotac_filter_in_list ( FILTER.centre, FILTER.ncentre, s1.centre ) == 0 )
+    {
+      FILTER.skipped_centre++;
+      return 1;
+    }
+
+  if ( bufrtotac_filter_in_list ( FILTER.master_version, FILTER.nmaster_version, s1.master_version ) == 0 )
+    {
+      FILTER.skipped_master_version++;
+      return 1;
+    }
+
+  if ( FILTER.has_from || FILTER.has_to )
+    {
+      memset ( &tim, 0, sizeof ( tim ) );
+      tim.tm_year = s1.year - 1900;
+      tim.tm_mon = s1.month - 1;
+      tim.tm_mday = s1.day;
+      tim.tm_hour = s1.hour;
+      tim.tm_min = s1.minute;
+      tim.tm_sec = s1.second;
+      t = timegm ( &tim );
+      if ( ( FILTER.has_from && t < FILTER.from ) || ( FILTER.has_to && t > FILTER.to ) )
+        {
+          FILTER.skipped_time++;
+          return 1;
+        }
+    }
+
+  if ( FILTER.ntemplate )
+    {
+      for ( i = 0; i < s3.ndesc; i++ )
+        for ( j = 0; j < FILTER.ntemplate; j++ )
+          if ( s3.unexpanded[i].f == FILTER.templ[j].f && s3.unexpanded[i].x == FILTER.templ[j].x &&
+               s3.unexpanded[i].y == FILTER.templ[j].y )
+            goto accepted;
+      FILTER.skipped_template++;
+      return 1;
+    }
+
+accepted:
+  FILTER.accepted++;
+  return 0;
+}
+
+/*!
+  \fn void bufrtotac_print_filter_counters(FILE *f)
+  \brief Print the counters of prefilter
+  \param [in] f pointer to a FILE already open by caller
+*/
+void bufrtotac_print_filter_counters ( FILE *f )
+{
+  if ( FILTER.active == 0 )
+    return;
+
+  fprintf ( f, "# Prefilter: accepted=%u unreadable=%u skipped: category=%u subcategory=%u centre=%u master_version=%u time=%u template=%u\n",
+            FILTER.accepted, FILTER.unreadable, FILTER.skipped_category, FILTER.skipped_subcategory, FILTER.skipped_centre,
+            FILTER.skipped_master_version, FILTER.skipped_time, FILTER.skipped_template );
+}
@@ -36,10 +36,17 @@ void bufrtotac_print_usage ( void )
 {
   bufrtotac_print_version ();
   printf ( "\nUsage: \n" );
-  printf ( "%s -i input_file [-i input] [-I list_of_files] [-t bufrtable_dir] [-o output] [-s] [-v][-j][-x][-X][-c][-h][more optional args....]\n", SELF );
+  printf ( "%s -i input_file [-i input] [-I list_of_files] [-w spool_dir] [-t bufrtable_dir] [-o output] [-s] [-v][-j][-x][-X][-c][-h][more optional args....]\n", SELF );
+  printf ( "       -b timages_dir. Write the tables B, C and D merged with local ones in binary images in timages_dir, ended\n" );
+  printf ( "          with '/', and read them from there when the same tables are needed again, instead of the csv files\n" );
   printf ( "       -c. The output is in csv format\n" );
+  printf ( "       -C crefs_dir. Write the parsed references of compressed BUFR in crefs_dir, ended with '/', and read them\n" );
+  printf ( "          from there when the same message is got again, instead of parsing its SEC 4\n" );
   printf ( "       -D debug level. 0 = No debug, 1 = Debug, 2 = Verbose debug (default = 0)\n" );
   printf ( "       -E. Print expanded tree in json format\n" );
+  printf ( "       -F key=value[,value...]. Skip the files not matching the condition before reading the whole file and tables\n" );
+  printf ( "          Keys are 'category', 'subcategory', 'centre', 'master_version', 'template' (as 307080) and\n" );
+  printf ( "          'from' and 'to' (as YYYYMMDDHHMM, UTC). It can be used several times, up to %d values for every key. Not used with -X\n", BUFRTOTAC_FILTER_DIM );
   printf ( "       -G. Print latitude, logitude and altitude \n" );
   printf ( "       -g. Print WIGOS ID\n" );
   printf ( "       -h Print this help\n" );
@@ -47,19 +54,42 @@ void bufrtotac_print_usage ( void )
   printf ( "       -I list_of_files. Pathname of a file with the list of files to parse, one filename per line\n" );
   printf ( "       -j. The output is in json format\n" );
   printf ( "       -J. Output expanded subset SEC 4 data in json format\n");
+  printf ( "       -k entries[:megabytes]. Keep up to 'entries' rendered reports (0 is %d) using up to 'megabytes' (default %d)\n",
+           BUFR2TAC_RENDER_CACHE_DEFAULT_ENTRIES, BUFR2TAC_RENDER_CACHE_DEFAULT_BYTES >> 20 );
+  printf ( "          in a LRU cache, so the messages got again are not decoded. Useful with -w or a long list of files\n" );
+  printf ( "       -K versions. Load in cache of tables (as -T) the newest 'versions' found in bufrtable_dir before the first\n" );
+  printf ( "          message. 0 is as many as fit in cache (%u)\n", BUFRDECO_TABLES_CACHE_SIZE );
+  printf ( "       -L. Output every subset SEC 4 data as a flat json object in a single line ('f xx yyy':value pairs)\n");
+  printf ( "       -m. With -L, add the meanings of code and flag tables\n");
   printf ( "       -N. Do not use local tables\n" );
   printf ( "       -n. Do not try to decode to TAC, just parse BUFR report\n" );
+  printf ( "       -M done_dir. In watch mode (-w), move the processed files to done_dir instead of removing them.\n" );
+  printf ( "          Files that cannot be decoded are always moved to subdirectory 'error' of spool_dir\n" );
+  printf ( "       -P stats_file. Collect runtime statistics and append them in json to stats_file at exit. '-' is stderr\n" );
+  printf ( "       -p seconds. With -P, also append the statistics every 'seconds'\n" );
+  printf ( "       -O format=output. Write the reports in format ('tac', 'json', 'csv', 'xml' or 'html') to output ('-' is stdout)\n" );
+  printf ( "          It can be used several times to get several outputs from a single decode, each one to a different output.\n" );
+  printf ( "          Then -o, -c, -j, -x and -H are not used\n" );
   printf ( "       -o output. Pathname of output file. Default is standar output\n" );
+  printf ( "          If it has strftime(3) conversions (as 'tac_%%Y%%m%%d%%H.txt') the output file rolls using current UTC time\n" );
   printf ( "       -R. Read bit_offsets file if exists. The path of these files is to add '.offs' to the name of input BUFR file\n");
   printf ( "       -s prints a long output with explained sequence of descriptors\n" );
   printf ( "       -S first..last . Print only results for subsets in range first..last (First subset available is 0). Default is all subsets\n" );
   printf ( "       -t bufrtable_dir. Pathname of bufr tables directory. Ended with '/'\n" );
   printf ( "       -T. Use cache of tables to optimize execution time\n");
+  printf ( "       -u. Skip the messages already seen, as the same bulletin got by several routes\n");
+  printf ( "       -U seen_file. As -u, also remembering the messages seen in previous runs in seen_file\n");
+  printf ( "       -w spool_dir. Watch spool_dir and decode every BUFR file closed or moved into it. Runs until SIGINT or SIGTERM\n" );
   printf ( "       -W. Write bit_offsets file. The path of these files is to add '.offs' to the name of input BUFR file\n");
   printf ( "       -V. Verbose output\n" );
   printf ( "       -v. Print version\n" );
   printf ( "       -x. The output is in xml format\n" );
   printf ( "       -X. Try to extract an embebed bufr in a file seraching for a first '7777' after first 'BUFR'\n" );
+  printf ( "       -Y store. Append the station, time and core variables of every report to the store of observations\n" );
+  printf ( "          'store.log', indexed by station and time in 'store.idx'. It can be queried with 'bufrtotac_query'\n" );
+  printf ( "       -Z snapshot_dir. Write the decoded subsets of every message in a binary snapshot file in snapshot_dir, ended\n" );
+  printf ( "          with '/'. The name of file is the hash of message with '.snp' added. It can be read with 'bufrdeco_json -z'\n" );
+  printf ( "          If the snapshot of a message is already there, its subsets are got from it instead of decoding them\n" );
   printf ( "       -B  bufr_xfile. In case of -X flag, write the extracted BUFR to bufr_xfile\n");
   printf ( "       -0. Prints BUFR Sec 0 information in json format\n");
   printf ( "       -1. Prints BUFR Sec 1 information in json format\n");
@@ -153,7 +183,7 @@ void bufrtotac_print_version()
 */
 int bufrtotac_read_args ( int _argc, char * _argv[] )
 {
-  int iopt;
+  int iopt, res;
   char *c;
   char aux[128];
 
@@ -163,6 +193,20 @@ int bufrtotac_read_args ( int _argc, char * _argv[] )
   LISTOFFILES[0] = '\0';
   BUFRTABLES_DIR[0] = '\0';
   BUFR_XFILE[0] = '\0';
+  SPOOL_DIR[0] = '\0';
+  DONE_DIR[0] = '\0';
+  CREFS_DIR[0] = '\0';
+  TIMAGES_DIR[0] = '\0';
+  DEDUP_FILE[0] = '\0';
+  DEDUP = 0;
+  SNAPSHOT_DIR[0] = '\0';
+  STORE_BASE[0] = '\0';
+  USE_RENDER_CACHE = 0;
+  RENDER_CACHE_ENTRIES = 0;
+  RENDER_CACHE_BYTES = 0;
+  OUTPUT_PATTERN = 0;
+  STATS_FILE[0] = '\0';
+  STATS_PERIOD = 0;
   VERBOSE = 0;
   SHOW_SEQUENCE = 0;
   DEBUG = 0;
@@ -179,7 +223,10 @@ int bufrtotac_read_args ( int _argc, char * _argv[] )
   READ_OFFSETS = 0;
   WRITE_OFFSETS = 0;
   USE_CACHE = 0;
+  PRELOAD_TABLES = -1;
   PRINT_JSON_DATA = 0;
+  PRINT_NDJSON_DATA = 0;
+  PRINT_NDJSON_MEANINGS = 0;
   PRINT_JSON_SEC1 = 0;
   PRINT_JSON_SEC2 = 0;
   PRINT_JSON_SEC3 = 0;
@@ -189,7 +236,7 @@ int bufrtotac_read_args ( int _argc, char * _argv[] )
   /*
      Read input options
   */
-  while ( ( iopt = getopt ( _argc, _argv, "cD:Ehi:jJHI:Nno:S:st:TvgGVWRxX0123B:" ) ) !=-1 )
+  while ( ( iopt = getopt ( _argc, _argv, "b:cC:D:EF:hi:jJHI:k:K:LmM:Nno:O:P:p:S:st:TuU:vgGVw:WRxX0123B:Y:Z:" ) ) !=-1 )
     switch ( iopt )
       {
       case 'i':
@@ -211,6 +258,29 @@ int bufrtotac_read_args ( int _argc, char * _argv[] )
       case 'J':
         PRINT_JSON_DATA = 1;
         break;
+
+      case 'k':
+        {
+          unsigned long entries = 0, mbytes = 0;
+
+          if ( sscanf ( optarg, "%lu:%lu", &entries, &mbytes ) < 1 )
+            {
+              printf ( "%s(): Bad size of cache of rendered reports '%s'\n", __func__, optarg );
+              return -1;
+            }
+          RENDER_CACHE_ENTRIES = entries;
+          RENDER_CACHE_BYTES = ( size_t ) mbytes << 20;
+          USE_RENDER_CACHE = 1;
+        }
+        break;
+
+      case 'L':
+        PRINT_NDJSON_DATA = 1;
+        break;
+
+      case 'm':
+        PRINT_NDJSON_MEANINGS = 1;
+        break;
         
       case 'I':
         if ( strlen ( optarg ) < BUFRDECO_PATH_LENGTH )
@@ -226,6 +296,28 @@ int bufrtotac_read_args ( int _argc, char * _argv[] )
           strcpy ( OUTPUTFILE, optarg );
         break;
         
+      case 'O':
+        if ( ( res = bufrtotac_add_output ( optarg ) ) )
+          {
+            if ( res == 2 )
+              printf ( "%s(): Output '%s' uses the same file as another output\n", __func__, optarg );
+            else
+              printf ( "%s(): Bad or too many outputs '%s'\n", __func__, optarg );
+            bufrtotac_print_usage();
+            return -1;
+          }
+        break;
+
+      case 'b':
+        if ( strlen ( optarg ) < BUFRDECO_PATH_LENGTH )
+          strcpy ( TIMAGES_DIR, optarg );
+        break;
+
+      case 'C':
+        if ( strlen ( optarg ) < BUFRDECO_PATH_LENGTH )
+          strcpy ( CREFS_DIR, optarg );
+        break;
+
       case 't':
         if ( strlen ( optarg ) < BUFRDECO_PATH_LENGTH )
           {
@@ -237,6 +329,36 @@ int bufrtotac_read_args ( int _argc, char * _argv[] )
         USE_CACHE = 1;
         break;
 
+      case 'K':
+        if ( atoi ( optarg ) >= 0 )
+          {
+            PRELOAD_TABLES = atoi ( optarg );
+            USE_CACHE = 1;
+          }
+        break;
+
+      case 'u':
+        DEDUP = 1;
+        break;
+
+      case 'Y':
+        if ( strlen ( optarg ) < BUFRDECO_PATH_LENGTH )
+          strcpy ( STORE_BASE, optarg );
+        break;
+
+      case 'Z':
+        if ( strlen ( optarg ) < BUFRDECO_PATH_LENGTH )
+          strcpy ( SNAPSHOT_DIR, optarg );
+        break;
+
+      case 'U':
+        if ( strlen ( optarg ) < BUFRDECO_PATH_LENGTH )
+          {
+            strcpy ( DEDUP_FILE, optarg );
+            DEDUP = 1;
+          }
+        break;
+
       case 'D':
         if ( strlen ( optarg ) < 2 )
           {
@@ -343,21 +465,62 @@ int bufrtotac_read_args ( int _argc, char * _argv[] )
          LOCAL_TABLES = 0;
          break;
 
+      case 'F':
+        if ( ( res = bufrtotac_add_filter ( optarg ) ) )
+          {
+            if ( res == 2 )
+              printf ( "%s(): Too many values in prefilter '%s'. The max is %d for every key\n", __func__, optarg, BUFRTOTAC_FILTER_DIM );
+            else
+              printf ( "%s(): Bad prefilter '%s'\n", __func__, optarg );
+            bufrtotac_print_usage();
+            return -1;
+          }
+        break;
+
+      case 'P':
+        if ( strlen ( optarg ) < BUFRDECO_PATH_LENGTH )
+          strcpy ( STATS_FILE, optarg );
+        break;
+
+      case 'p':
+        STATS_PERIOD = atoi ( optarg );
+        break;
+
+      case 'w':
+        if ( strlen ( optarg ) < BUFRDECO_PATH_LENGTH )
+          strcpy ( SPOOL_DIR, optarg );
+        break;
+
+      case 'M':
+        if ( strlen ( optarg ) < BUFRDECO_PATH_LENGTH )
+          strcpy ( DONE_DIR, optarg );
+        break;
+
       case 'h':
       default:
         bufrtotac_print_usage();
         exit ( EXIT_SUCCESS );
       }
 
-  if ( INPUTFILE[0] == 0 && LISTOFFILES[0] == 0 )
+  if ( INPUTFILE[0] == 0 && LISTOFFILES[0] == 0 && SPOOL_DIR[0] == 0 )
     {
-      printf ( "read_args(): It is needed an input file. Use -i or -I option\n" );
+      printf ( "read_args(): It is needed an input file. Use -i, -I or -w option\n" );
       bufrtotac_print_usage();
       return -1;
     }
-    
+
+  // In watch mode the process lives long, so the tables are always cached
+  if ( SPOOL_DIR[0] )
+    USE_CACHE = 1;
+
   // Open oututfile if needed or stdout
-  if (OUTPUTFILE[0])
+  if ( strchr ( OUTPUTFILE, '%' ) != NULL )
+    {
+      // Rolling output file. It is opened by bufrtotac_roll_output() before decoding every file
+      OUTPUT_PATTERN = 1;
+      OUT = NULL;
+    }
+  else if (OUTPUTFILE[0])
   {
     if ((OUT = fopen (OUTPUTFILE,"w")) == NULL)
     {
@@ -388,17 +551,10 @@ int bufrtotac_parse_subset_sequence ( struct metreport *m, struct bufr2tac_subse
                                       struct bufrdeco *b, char *err )
 {
   size_t i;
-  int ksec1[40], res;
-  int *kdtlst;
+  int ksec1[40];
+  int kdtlst[BUFR_LEN_UNEXPANDED_DESCRIPTOR];
   size_t nlst = ( size_t ) b->sec3.ndesc;
 
-  // memory for kdtlst
-  if ( ( kdtlst = ( int * ) calloc ( 1, nlst * sizeof ( int ) ) ) == NULL )
-    {
-      snprintf ( err, ERR_SIZE, "decobufr_parse_subset_sequence(): cannot alloc memory for kdtlst\n" );
-      return 1;
-    }
-
   // sets descriptor as integer according to ECMWF
   for ( i = 0; i < nlst ; i++ )
     {
@@ -423,9 +579,61 @@ int bufrtotac_parse_subset_sequence ( struct metreport *m, struct bufr2tac_subse
   
   
   m->h = &b->header;
-  res = parse_subset_sequence ( m, &b->seq, st, kdtlst, nlst, ksec1, err );
-  free ( ( void * ) kdtlst );
-  return res;
+
+  // The type of report is the same for all subsets in a message, so it is got just once
+  if ( bufr2tac_classify_report ( &REPORT_CLASS, kdtlst, nlst, ksec1, err ) )
+    {
+      bufr2tac_clean_subset_state ( st );
+      return 1;
+    }
+  return parse_subset_sequence_class ( m, &b->seq, st, &REPORT_CLASS, err );
+}
+
+/*!
+ * \fn int bufrtotac_synop_batch_usable(void)
+ * \brief Check if the next subsets of current BUFR can be got from a SYNOP template
+ * \return 1 if a template can be tried, 0 otherwise
+ *
+ * The subsets got from a template are not decoded, so no output nor store needing the decoded subsets can be active
+ */
+int bufrtotac_synop_batch_usable ( void )
+{
+  if ( VERBOSE || SNAPSHOT_DIR[0] || STORE_BASE[0] || BUFR.sec3.ndesc == 0 ||
+       ( BUFR.mask & ( BUFRDECO_OUTPUT_JSON_SUBSET_DATA | BUFRDECO_OUTPUT_NDJSON_SUBSET_DATA ) ) )
+    return 0;
+
+  if ( BUFR.sec3.compressed == 0 || BUFR.sec3.subsets < 2 )
+    return 0;
+
+  return ( REPORT_CLASS.type == BUFR2TAC_REPORT_AAXX ||
+           REPORT_CLASS.type == BUFR2TAC_REPORT_BBXX ||
+           REPORT_CLASS.type == BUFR2TAC_REPORT_OOXX );
+}
+
+/*!
+ * \fn int bufrtotac_parse_subset_batch(struct metreport *m, struct bufr2tac_synop_batch *sb, struct bufrdeco *b, char *err)
+ * \brief Get the SYNOP of current subset from a template, as \ref bufrtotac_parse_subset_sequence does from a decoded subset
+ * \param [out] m pointer to struct \ref metreport where to store the parsed report
+ * \param [in,out] sb pointer to struct \ref bufr2tac_synop_batch already prepared for \a b
+ * \param [in] b pointer to struct \ref bufrdeco with BUFR data
+ * \param [out] err string buffer to write error messages
+ * \return 0 if success, 1 otherwise
+ */
+int bufrtotac_parse_subset_batch ( struct metreport *m, struct bufr2tac_synop_batch *sb, struct bufrdeco *b, char *err )
+{
+  bufr2tac_clean_metreport( m );
+
+  // Set the subset being parsed
+  m->subset = SUBSET;
+
+  if (PRINT_WIGOS_ID)
+    m->print_mask |= PRINT_BITMASK_WIGOS;
+
+  if (PRINT_GEO)
+    m->print_mask |= PRINT_BITMASK_GEO;
+
+  m->h = &b->header;
+  return bufr2tac_synop_batch_report ( sb, m, ( buf_t ) SUBSET, b, err );
 }
 
 /*!
@@ -487,6 +695,38 @@ char * get_bufrfile_path ( char *filename, char *fileoffset, char *err )
     }
 }
 
+/*!
+  \fn uint8_t *bufrtotac_read_file(const char *filename, size_t *size)
+  \brief Read a whole BUFR file in memory
+  \param [in] filename Pathname of file
+  \param [out] size Bytes read
+  \return Pointer to allocated memory with the file, to be freed by caller. NULL if error
+
+  It is used with -k to get the key of message in the cache of rendered reports before decoding it.
+  The buffer is then passed to bufrdeco_read_buffer(), so the file is read just once
+*/
+uint8_t *bufrtotac_read_file ( const char *filename, size_t *size )
+{
+  struct stat st;
+  uint8_t *bufrx;
+  FILE *fp;
+
+  if ( stat ( filename, &st ) < 0 || ! S_ISREG ( st.st_mode ) || ( st.st_size + 4 ) >= BUFR_LEN )
+    return NULL;
+
+  if ( ( bufrx = ( uint8_t * ) malloc ( st.st_size + 4 ) ) == NULL )
+    return NULL;
+
+  if ( ( fp = fopen ( filename, "rb" ) ) == NULL )
+    {
+      free ( bufrx );
+      return NULL;
+    }
+  *size = fread ( bufrx, 1, st.st_size, fp );
+  fclose ( fp );
+  return bufrx;
+}
+
 /*!
  * \fn int bufrtotac_set_bufrdeco_bitmask(struct bufrdeco *b)
  * \brief Set the bufrdeco struct bitmask according with readed args from shell
@@ -503,9 +743,27 @@ int bufrtotac_set_bufrdeco_bitmask (struct bufrdeco *b)
   if (USE_CACHE)
     b->mask |= BUFRDECO_USE_TABLES_CACHE;
 
+  if (DEDUP)
+    b->mask |= BUFRDECO_SKIP_DUPLICATES;
+
+  if (CREFS_DIR[0])
+    bufrdeco_set_compressed_references_dir (b, CREFS_DIR);
+
+  if (TIMAGES_DIR[0])
+    bufrdeco_set_tables_images_dir (b, TIMAGES_DIR);
+
   if (PRINT_JSON_DATA)
     b->mask |= BUFRDECO_OUTPUT_JSON_SUBSET_DATA;
 
+  if (PRINT_NDJSON_DATA)
+    b->mask |= BUFRDECO_OUTPUT_NDJSON_SUBSET_DATA;
+
+  if (PRINT_NDJSON_MEANINGS)
+    b->mask |= BUFRDECO_OUTPUT_NDJSON_MEANINGS;
+
+  if (STATS_FILE[0])
+    b->mask |= BUFRDECO_COLLECT_STATS;
+
   if (PRINT_JSON_SEC0)
     b->mask |= BUFRDECO_OUTPUT_JSON_SEC0;
 
@@ -526,3 +784,84 @@ int bufrtotac_set_bufrdeco_bitmask (struct bufrdeco *b)
   
   return 0;
 }
+
+/*!
+ * \fn int bufrtotac_roll_output(void)
+ * \brief Open the output file whose name results of expanding OUTPUTFILE with current UTC time
+ * \return 0 if succeeded, 1 otherwise
+ *
+ * It is used when the pathname set with -o option has strftime(3) conversions. If the resulting name is the same as the
+ * one currently opened nothing is done. Otherwise the current output is closed and the new one is opened in append mode,
+ * so a restarted process does not truncate the file for the current period.
+ */
+int bufrtotac_roll_output ( void )
+{
+  static char current[BUFRDECO_PATH_LENGTH];
+  char name[BUFRDECO_PATH_LENGTH];
+  time_t now;
+  struct tm tim;
+
+  if ( OUTPUT_PATTERN == 0 )
+    return 0;
+
+  now = time ( NULL );
+  gmtime_r ( &now, &tim );
+  if ( strftime ( name, sizeof ( name ), OUTPUTFILE, &tim ) == 0 )
+    {
+      snprintf ( ERR, ERR_SIZE, "%s(): Cannot expand output pattern '%s'", __func__, OUTPUTFILE );
+      return 1;
+    }
+
+  if ( OUT != NULL && strcmp ( name, current ) == 0 )
+    return 0;
+
+  if ( OUT != NULL )
+    fclose ( OUT );
+
+  if ( ( OUT = fopen ( name, "a" ) ) == NULL )
+    {
+      snprintf ( ERR, ERR_SIZE, "%s(): Cannot open file %s to write to", __func__, name );
+      current[0] = '\0';
+      return 1;
+    }
+  strcpy ( current, name );
+  return 0;
+}
+
+/*!
+ * \fn int bufrtotac_dump_stats(int force)
+ * \brief Append the runtime statistics of BUFR in json to STATS_FILE
+ * \param [in] force If != 0 then dump them now, otherwise only when STATS_PERIOD seconds passed since last dump
+ * \return 0 if dumped, 1 otherwise
+ *
+ * Every dump is a json object in a single line, so a long running process gives a file with a line per period.
+ * With -k a second line with the counters of the cache of rendered reports follows.
+ */
+int bufrtotac_dump_stats ( int force )
+{
+  static time_t last;
+  time_t now;
+  FILE *f;
+
+  if ( STATS_FILE[0] == '\0' )
+    return 1;
+
+  now = time ( NULL );
+  if ( last == 0 )
+    last = now;
+  if ( force == 0 && ( STATS_PERIOD <= 0 || ( now - last ) < STATS_PERIOD ) )
+    return 1;
+  last = now;
+
+  if ( strcmp ( STATS_FILE, "-" ) == 0 )
+    f = stderr;
+  else if ( ( f = fopen ( STATS_FILE, "a" ) ) == NULL )
+    return 1;
+
+  bufrdeco_print_json_stats ( f, &BUFR );
+  if ( USE_RENDER_CACHE )
+    bufr2tac_print_json_render_cache_stats ( f, &RENDER_CACHE );
+  if ( f != stderr )
+    fclose ( f );
+  return 0;
+}
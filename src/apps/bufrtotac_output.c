@@ -0,0 +1,408 @@
+/***************************************************************************
+ *   Copyright (C) 2013-2026 by Guillermo Ballester Valor                  *
+ *   gbv@ogimet.com                                                        *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.             *
+ ***************************************************************************/
+/*!
+ \file bufrtotac_output.c
+ \brief file with the code of multiple outputs in binary bufrtotac
+
+ Every output set with a -O option has its own stream and buffer. Each decoded report is written to all of them,
+ so a single run can feed a TAC archive, a json and a csv file without decoding the BUFR files again.
+
+ With -k the rendered reports are also kept in a bounded LRU cache. When all the requested reports of a message are
+ there, they are written without reading tables nor decoding the message again.
+ */
+#ifndef CONFIG_H
+# include "config.h"
+# define CONFIG_H
+#endif
+
+#include "bufrtotac.h"
+
+struct bufrtotac_output OUTPUTS[BUFRTOTAC_OUTPUTS_DIM]; /*!< The outputs set with -O options */
+int NOUTPUTS; /*!< Number of outputs in OUTPUTS[] */
+int USE_RENDER_CACHE; /*!< If != 0 then keep the rendered reports in RENDER_CACHE */
+size_t RENDER_CACHE_ENTRIES; /*!< Max number of reports in RENDER_CACHE. 0 is the default */
+size_t RENDER_CACHE_BYTES; /*!< Max bytes of reports in RENDER_CACHE. 0 is the default */
+struct bufr2tac_render_cache RENDER_CACHE; /*!< Cache of rendered reports */
+uint64_t RENDER_KEY; /*!< Key of current message in RENDER_CACHE. If 0 the cache is not used for it */
+static struct bufr2tac_buffer RENDERED; /*!< Where a report is rendered before adding it to RENDER_CACHE */
+
+/*!
+  \fn static int bufrtotac_output_in_use(const char *path)
+  \brief Check if a pathname of -O option is the stream of an output already set
+  \param [in] path Pathname. '-' is the standard output
+  \return 1 if it is in use, 0 otherwise
+
+  Every output has its own buffer, so two of them in the same stream would mix their reports. An existing regular
+  file is compared by device and inode, so other names of a file or the file where stdout is redirected are found
+*/
+static int bufrtotac_output_in_use ( const char *path )
+{
+  int i;
+  struct stat st, sto;
+
+  for ( i = 0; i < NOUTPUTS; i++ )
+    if ( strcmp ( OUTPUTS[i].path, path ) == 0 )
+      return 1;
+
+  if ( strcmp ( path, "-" ) == 0 )
+    {
+      if ( fstat ( fileno ( stdout ), &st ) )
+        return 0;
+    }
+  else if ( stat ( path, &st ) )
+    return 0;
+  if ( S_ISREG ( st.st_mode ) == 0 )
+    return 0;
+
+  for ( i = 0; i < NOUTPUTS; i++ )
+    if ( fstat ( fileno ( OUTPUTS[i].f ), &sto ) == 0 && sto.st_dev == st.st_dev && sto.st_ino == st.st_ino )
+      return 1;
+  return 0;
+}
+
+/*!
+  \fn int bufrtotac_add_output(const char *arg)
+  \brief Add an output from an argument of -O option
+  \param [in] arg string as format=pathname
+  \return 0 if succeeded, 2 if its pathname is already used by another output, 1 otherwise
+
+  Valid formats are 'tac' (or 'plain'), 'json', 'csv', 'xml' and 'html'. A pathname '-' is the standard output.
+  The file is opened here, truncating it.
+*/
+int bufrtotac_add_output ( const char *arg )
+{
+  const char *val;
+  size_t nk;
+  struct bufrtotac_output *o;
+
+  if ( NOUTPUTS >= BUFRTOTAC_OUTPUTS_DIM || ( val = strchr ( arg, '=' ) ) == NULL )
+    return 1;
+  nk = val - arg;
+  val++;
+  if ( val[0] == '\0' || strlen ( val ) >= BUFRDECO_PATH_LENGTH )
+    return 1;
+
+  o = &OUTPUTS[NOUTPUTS];
+  memset ( o, 0, sizeof ( struct bufrtotac_output ) );
+  if ( ( nk == 3 && strncmp ( arg, "tac", nk ) == 0 ) || ( nk == 5 && strncmp ( arg, "plain", nk ) == 0 ) )
+    o->format = BUFRTOTAC_OUTPUT_PLAIN;
+  else if ( nk == 4 && strncmp ( arg, "json", nk ) == 0 )
+    o->format = BUFRTOTAC_OUTPUT_JSON;
+  else if ( nk == 3 && strncmp ( arg, "csv", nk ) == 0 )
+    o->format = BUFRTOTAC_OUTPUT_CSV;
+  else if ( nk == 3 && strncmp ( arg, "xml", nk ) == 0 )
+    o->format = BUFRTOTAC_OUTPUT_XML;
+  else if ( nk == 4 && strncmp ( arg, "html", nk ) == 0 )
+    o->format = BUFRTOTAC_OUTPUT_HTML;
+  else
+    return 1;
+
+  if ( bufrtotac_output_in_use ( val ) )
+    return 2;
+
+  strcpy ( o->path, val );
+  if ( strcmp ( o->path, "-" ) == 0 )
+    o->f = stdout;
+  else if ( ( o->f = fopen ( o->path, "w" ) ) == NULL )
+    return 1;
+
+  bufrdeco_out_init ( &o->ob, o->f );
+  bufr2tac_sink_set_output_buffer ( &o->sink, &o->ob );
+  NOUTPUTS++;
+  return 0;
+}
+
+/*!
+  \fn static void bufrtotac_sink_print(struct bufr2tac_sink *s, int format, const struct metreport *m)
+  \brief Write a decoded report in a format into a sink, without csv or xml headers
+  \param [in,out] s Pointer to the sink
+  \param [in] format As in enum \ref bufrtotac_output_format
+  \param [in] m Pointer to struct \ref metreport with the decoded report
+*/
+static void bufrtotac_sink_print ( struct bufr2tac_sink *s, int format, const struct metreport *m )
+{
+  switch ( format )
+    {
+    case BUFRTOTAC_OUTPUT_JSON:
+      bufr2tac_sink_print_json ( s, m );
+      break;
+    case BUFRTOTAC_OUTPUT_CSV:
+      bufr2tac_sink_print_csv ( s, m );
+      break;
+    case BUFRTOTAC_OUTPUT_XML:
+      bufr2tac_sink_print_xml ( s, m );
+      break;
+    case BUFRTOTAC_OUTPUT_HTML:
+      bufr2tac_sink_print_html ( s, m );
+      break;
+    case BUFRTOTAC_OUTPUT_PLAIN:
+    default:
+      bufr2tac_sink_print_plain ( s, m );
+      break;
+    }
+}
+
+/*!
+  \fn static const char *bufrtotac_render(int format, const struct metreport *m)
+  \brief Get the text of report of current SUBSET in a format from RENDER_CACHE, or render it and add it there
+  \param [in] format As in enum \ref bufrtotac_output_format
+  \param [in] m Pointer to struct \ref metreport with the decoded report. If NULL the text is only got from cache
+  \return The text, valid until next call. NULL if not got
+*/
+static const char *bufrtotac_render ( int format, const struct metreport *m )
+{
+  struct bufr2tac_render_entry *e;
+  struct bufr2tac_sink s;
+
+  if ( ( e = bufr2tac_render_cache_get ( &RENDER_CACHE, RENDER_KEY, SUBSET, format ) ) != NULL )
+    return e->data;
+  if ( m == NULL )
+    return NULL;
+
+  // Allocated before cleaning it, so the text is nul terminated even if nothing is rendered
+  if ( bufr2tac_buffer_reserve ( &RENDERED, 0 ) )
+    return NULL;
+  bufr2tac_buffer_clean ( &RENDERED );
+  bufr2tac_sink_set_buffer ( &s, &RENDERED );
+  bufrtotac_sink_print ( &s, format, m );
+  if ( s.error )
+    return NULL;
+  bufr2tac_render_cache_put ( &RENDER_CACHE, RENDER_KEY, SUBSET, BUFR.sec3.subsets, format, RENDERED.s, RENDERED.len );
+  return RENDERED.s;
+}
+
+/*!
+  \fn int bufrtotac_print_outputs(const struct metreport *m)
+  \brief Write a decoded report in all the outputs
+  \param [in] m Pointer to struct \ref metreport with the decoded report. If NULL it is got from RENDER_CACHE
+  \return 0 if succeeded, 1 if a write failed in any output
+
+  The reports stay in buffers until they are full or \ref bufrtotac_flush_outputs is called
+*/
+int bufrtotac_print_outputs ( const struct metreport *m )
+{
+  int i, res = 0;
+  const char *text;
+  struct bufrtotac_output *o;
+
+  for ( i = 0; i < NOUTPUTS; i++ )
+    {
+      o = &OUTPUTS[i];
+      if ( o->header == 0 && o->format == BUFRTOTAC_OUTPUT_CSV )
+        {
+          bufr2tac_sink_puts ( &o->sink, "TYPE,FILE,DATETIME,INDEX,NAME,COUNTRY,LATITUDE,LONGITUDE,ALTITUDE,REPORT\n" );
+          o->header = 1;
+        }
+      else if ( o->header == 0 && o->format == BUFRTOTAC_OUTPUT_XML )
+        {
+          bufr2tac_sink_puts ( &o->sink, "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n" );
+          o->header = 1;
+        }
+
+      if ( RENDER_KEY == 0 )
+        bufrtotac_sink_print ( &o->sink, o->format, m );
+      else if ( ( text = bufrtotac_render ( o->format, m ) ) != NULL )
+        bufr2tac_sink_puts ( &o->sink, text );
+      res |= o->sink.error;
+    }
+  return res;
+}
+
+/*!
+  \fn static int bufrtotac_single_format(void)
+  \brief Format of the output when there are no -O options, as set with -x, -j, -c or -H
+  \return The format as in enum \ref bufrtotac_output_format
+*/
+static int bufrtotac_single_format ( void )
+{
+  if ( XML )
+    return BUFRTOTAC_OUTPUT_XML;
+  else if ( JSON )
+    return BUFRTOTAC_OUTPUT_JSON;
+  else if ( CSV )
+    return BUFRTOTAC_OUTPUT_CSV;
+  else if ( HTML )
+    return BUFRTOTAC_OUTPUT_HTML;
+  return BUFRTOTAC_OUTPUT_PLAIN;
+}
+
+/*!
+  \fn int bufrtotac_print_report(const struct metreport *m)
+  \brief Write the decoded report of current SUBSET in the outputs set with -O or, if none, in OUT
+  \param [in] m Pointer to struct \ref metreport with the decoded report. If NULL it is got from RENDER_CACHE
+  \return 0 if succeeded, 1 otherwise
+*/
+int bufrtotac_print_report ( const struct metreport *m )
+{
+  int format;
+  const char *text;
+
+  if ( NOUTPUTS )
+    {
+      // Every output set with -O from the same decoded report
+      return bufrtotac_print_outputs ( m );
+    }
+
+  format = bufrtotac_single_format ();
+  if ( SUBSET == 0 && format == BUFRTOTAC_OUTPUT_XML )
+    fprintf ( OUT, "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n" );
+  else if ( SUBSET == 0 && format == BUFRTOTAC_OUTPUT_CSV )
+    fprintf ( OUT, "TYPE,FILE,DATETIME,INDEX,NAME,COUNTRY,LATITUDE,LONGITUDE,ALTITUDE,REPORT\n" );
+
+  if ( RENDER_KEY )
+    {
+      if ( ( text = bufrtotac_render ( format, m ) ) == NULL )
+        return 1;
+      return fputs ( text, format == BUFRTOTAC_OUTPUT_XML ? stdout : OUT ) < 0;
+    }
+
+  switch ( format )
+    {
+    case BUFRTOTAC_OUTPUT_XML:
+      return print_xml ( stdout, m );
+    case BUFRTOTAC_OUTPUT_JSON:
+      return print_json ( OUT, m );
+    case BUFRTOTAC_OUTPUT_CSV:
+      return print_csv ( OUT, m );
+    case BUFRTOTAC_OUTPUT_HTML:
+      return print_html ( OUT, m );
+    default:
+      return print_plain ( OUT, m );
+    }
+}
+
+/*!
+  \fn int bufrtotac_render_cache_usable(void)
+  \brief Check if RENDER_CACHE can be used with the options set
+  \return 1 if it can be used, 0 otherwise
+
+  Reports got from cache skip all the decoding, so it is not used when the decoder itself has to print or write
+  anything, nor when the duplicated messages have to be skipped
+*/
+int bufrtotac_render_cache_usable ( void )
+{
+  return USE_RENDER_CACHE && RENDER_CACHE.nbuckets && NOTAC == 0 && VERBOSE == 0 && EXTRACT == 0 && DEDUP == 0 &&
+         WRITE_OFFSETS == 0 && PRINT_JSON_DATA == 0 && PRINT_NDJSON_DATA == 0 && PRINT_JSON_EXPANDED_TREE == 0 &&
+         PRINT_JSON_SEC0 == 0 && PRINT_JSON_SEC1 == 0 && PRINT_JSON_SEC2 == 0 && PRINT_JSON_SEC3 == 0 &&
+         SNAPSHOT_DIR[0] == '\0' && STORE_BASE[0] == '\0';
+}
+
+/*!
+  \fn uint64_t bufrtotac_render_key(const uint8_t *bufr, size_t size, const char *filename)
+  \brief Get the key in RENDER_CACHE of a message
+  \param [in] bufr Raw message
+  \param [in] size Bytes of message
+  \param [in] filename Pathname of file with the message
+  \return The key, never 0
+
+  Reports have the file name and the GTS header guessed from it, so the name is also hashed with the message
+*/
+uint64_t bufrtotac_render_key ( const uint8_t *bufr, size_t size, const char *filename )
+{
+  uint64_t key = bufrdeco_buffer_hash ( bufr, size );
+  const char *c;
+
+  for ( c = filename; *c; c++ )
+    {
+      key ^= ( uint8_t ) *c;
+      key *= 1099511628211ULL;
+    }
+  return key ? key : 1;
+}
+
+/*!
+  \fn int bufrtotac_print_cached_message(void)
+  \brief Write all the reports of message with key RENDER_KEY if they all are in RENDER_CACHE
+  \return 0 if they were written, 1 if any is missing and then nothing is written
+
+  The subsets written are the ones in range set with -S, as when the message is decoded
+*/
+int bufrtotac_print_cached_message ( void )
+{
+  struct bufr2tac_render_entry *e;
+  int i, first_subset, last_subset, subset, format;
+
+  format = NOUTPUTS ? ( int ) OUTPUTS[0].format : bufrtotac_single_format ();
+  first_subset = FIRST_SUBSET;
+  if ( ( e = bufr2tac_render_cache_find ( &RENDER_CACHE, RENDER_KEY, first_subset, format ) ) == NULL )
+    return 1;
+
+  last_subset = LAST_SUBSET;
+  if ( last_subset < first_subset || last_subset >= ( int ) e->subsets )
+    last_subset = e->subsets - 1;
+
+  for ( subset = first_subset; subset <= last_subset; subset++ )
+    {
+      for ( i = 0; i < ( NOUTPUTS ? NOUTPUTS : 1 ); i++ )
+        {
+          if ( NOUTPUTS )
+            format = OUTPUTS[i].format;
+          if ( bufr2tac_render_cache_find ( &RENDER_CACHE, RENDER_KEY, subset, format ) == NULL )
+            return 1;
+        }
+    }
+
+  for ( SUBSET = first_subset; SUBSET <= last_subset; SUBSET++ )
+    bufrtotac_print_report ( NULL );
+  return 0;
+}
+
+/*!
+  \fn int bufrtotac_flush_outputs(void)
+  \brief Write the buffered reports of all outputs to their files
+  \return 0 if succeeded, 1 if a write failed in any output
+
+  It is called after every BUFR file, so in watch mode the reports are in files as soon as a file is decoded
+*/
+int bufrtotac_flush_outputs ( void )
+{
+  int i, res = 0;
+
+  for ( i = 0; i < NOUTPUTS; i++ )
+    {
+      if ( bufr2tac_sink_flush ( &OUTPUTS[i].sink ) || fflush ( OUTPUTS[i].f ) )
+        {
+          if ( DEBUG )
+            fprintf ( stderr, "# Cannot write to output '%s'\n", OUTPUTS[i].path );
+          res = 1;
+        }
+    }
+  return res;
+}
+
+/*!
+  \fn int bufrtotac_close_outputs(void)
+  \brief Flush and close all outputs
+  \return 0 if succeeded, 1 if a write failed in any output
+*/
+int bufrtotac_close_outputs ( void )
+{
+  int i, res;
+
+  res = bufrtotac_flush_outputs ();
+  for ( i = 0; i < NOUTPUTS; i++ )
+    {
+      if ( OUTPUTS[i].f != stdout && fclose ( OUTPUTS[i].f ) )
+        res = 1;
+      OUTPUTS[i].f = NULL;
+    }
+  NOUTPUTS = 0;
+  return res;
+}
@@ -0,0 +1,214 @@
+/***************************************************************************
+ *   Copyright (C) 2013-2026 by Guillermo Ballester Valor                  *
+ *   gbv@ogimet.com                                                        *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.             *
+ ***************************************************************************/
+/*! \file bufrtotac_query.c
+    \brief This file includes the code to query the store of observations written by 'bufrtotac -Y'
+
+    The last observations of a station are got by a binary search in the index of store, without reading the whole
+    log
+*/
+#ifndef CONFIG_H
+#include "config.h"
+#define CONFIG_H
+#endif
+
+#include "bufr2tac.h"
+
+char STORE_BASE[BUFRDECO_PATH_LENGTH]; /*!< Pathname of store, without suffix */
+char IDENT[BUFR2TAC_STORE_IDENT_LENGTH]; /*!< Key of station to query */
+size_t NLAST; /*!< Max number of observations to get */
+int UPDATE_INDEX; /*!< If != 0 then add to index the records of log not indexed yet */
+int PRINT_JSON; /*!< If != 0 then the output is in json format */
+
+/*!
+  \var VAR_NAMES
+  \brief Names of the core variables in output, in order of \ref bufr2tac_store_var
+*/
+const char *VAR_NAMES[BUFR2TAC_STORE_NVARS] = {"pressure", "msl_pressure", "temperature", "dewpoint", "humidity",
+                                               "wind_direction", "wind_speed", "visibility"
+                                              };
+
+/*!
+  \fn void print_usage(void)
+  \brief Print usage help message to stdout
+*/
+void print_usage ( void )
+{
+  printf ( "Usage: \n" );
+  printf ( "bufrtotac_query -s store [-i station] [-n number] [-b] [-j] [-h]\n" );
+  printf ( "   -b Add to index the observations of log not indexed yet, as when 'bufrtotac -Y' did not end\n" );
+  printf ( "   -h Print this help\n" );
+  printf ( "   -i station. Index of station as '08221' or, if it has none, its WIGOS id as '0-20000-0-08221'\n" );
+  printf ( "   -j The output is in json format, an object per line\n" );
+  printf ( "   -n number. Get the last 'number' observations of station, the newest first. Default is 1\n" );
+  printf ( "   -s store. Pathname of store as in 'bufrtotac -Y store', without the '.log' and '.idx' suffixes\n" );
+}
+
+/*!
+  \fn int read_args( int _argc, char * _argv[])
+  \brief read the arguments from stdio
+  \param [in] _argc number of arguments passed
+  \param [in] _argv array of arguments
+
+  Returns 1 if succcess, -1 othewise
+*/
+int read_args ( int _argc, char * _argv[] )
+{
+  int iopt;
+
+  // Default values
+  STORE_BASE[0] = '\0';
+  IDENT[0] = '\0';
+  NLAST = 1;
+  UPDATE_INDEX = 0;
+  PRINT_JSON = 0;
+
+  while ( ( iopt = getopt ( _argc, _argv, "bhi:jn:s:" ) ) !=-1 )
+    switch ( iopt )
+      {
+      case 'b':
+        UPDATE_INDEX = 1;
+        break;
+
+      case 'i':
+        if ( strlen ( optarg ) < BUFR2TAC_STORE_IDENT_LENGTH )
+          strcpy ( IDENT, optarg );
+        break;
+
+      case 'j':
+        PRINT_JSON = 1;
+        break;
+
+      case 'n':
+        if ( atoi ( optarg ) > 0 )
+          NLAST = ( size_t ) atoi ( optarg );
+        break;
+
+      case 's':
+        if ( strlen ( optarg ) < BUFRDECO_PATH_LENGTH )
+          strcpy ( STORE_BASE, optarg );
+        break;
+
+      case 'h':
+      default:
+        print_usage();
+        exit ( EXIT_SUCCESS );
+      }
+
+  if ( STORE_BASE[0] == '\0' || ( IDENT[0] == '\0' && UPDATE_INDEX == 0 ) )
+    {
+      printf ( "read_args(): Needed a store (-s) and a station (-i) or -b\n" );
+      return -1;
+    }
+  return 1;
+}
+
+/*!
+  \fn void print_record(const struct bufr2tac_store_record *r)
+  \brief Print a record of store to stdout
+  \param [in] r Pointer to the record
+*/
+void print_record ( const struct bufr2tac_store_record *r )
+{
+  char datime[24];
+  struct tm tim;
+  time_t t;
+  size_t i;
+
+  t = ( time_t ) r->time;
+  gmtime_r ( &t, &tim );
+
+  if ( PRINT_JSON )
+    {
+      strftime ( datime, sizeof ( datime ), "%Y-%m-%dT%H:%M:%SZ", &tim );
+      printf ( "{\"station\":\"%s\",\"wigos\":\"%s\",\"datetime\":\"%s\",\"type\":\"%s\",\"subset\":%u",
+               r->ident, r->wigos, datime, r->type, r->subset );
+      printf ( ",\"lat\":%.5lf,\"lon\":%.5lf,\"alt\":%.1lf", r->lat, r->lon, r->alt );
+      for ( i = 0; i < BUFR2TAC_STORE_NVARS; i++ )
+        {
+          if ( r->var[i] == MISSING_REAL )
+            printf ( ",\"%s\":null", VAR_NAMES[i] );
+          else
+            printf ( ",\"%s\":%.6g", VAR_NAMES[i], r->var[i] );
+        }
+      printf ( "}\n" );
+      return;
+    }
+
+  strftime ( datime, sizeof ( datime ), "%Y%m%d%H%M", &tim );
+  printf ( "%s|%s|%s|%s|%.5lf|%.5lf|%.1lf", r->ident, r->wigos, datime, r->type, r->lat, r->lon, r->alt );
+  for ( i = 0; i < BUFR2TAC_STORE_NVARS; i++ )
+    {
+      if ( r->var[i] == MISSING_REAL )
+        printf ( "|" );
+      else
+        printf ( "|%.6g", r->var[i] );
+    }
+  printf ( "\n" );
+}
+
+/*!
+  \fn int main(int argc, char *argv[])
+  \brief Main function for bufrtotac_query program
+  \param [in] argc number of arguments
+  \param [in] argv array of argument strings
+  \return EXIT_SUCCESS if success, EXIT_FAILURE otherwise
+*/
+int main ( int argc, char *argv[] )
+{
+  struct bufr2tac_store_reader rd;
+  const struct bufr2tac_store_record **out;
+  struct timespec t0, t1;
+  size_t i, n;
+
+  if ( read_args ( argc, argv ) < 0 )
+    exit ( EXIT_FAILURE );
+
+  if ( UPDATE_INDEX && bufr2tac_store_update_index ( STORE_BASE ) )
+    {
+      fprintf ( stderr, "# Cannot update the index of store '%s'\n", STORE_BASE );
+      exit ( EXIT_FAILURE );
+    }
+  if ( IDENT[0] == '\0' )
+    exit ( EXIT_SUCCESS );
+
+  if ( bufr2tac_store_reader_open ( &rd, STORE_BASE ) )
+    {
+      fprintf ( stderr, "# Cannot open the store '%s'\n", STORE_BASE );
+      exit ( EXIT_FAILURE );
+    }
+  if ( ( out = ( const struct bufr2tac_store_record ** ) calloc ( NLAST, sizeof ( *out ) ) ) == NULL )
+    {
+      bufr2tac_store_reader_close ( &rd );
+      exit ( EXIT_FAILURE );
+    }
+
+  clock_gettime ( CLOCK_MONOTONIC, &t0 );
+  n = bufr2tac_store_last ( &rd, IDENT, out, NLAST );
+  clock_gettime ( CLOCK_MONOTONIC, &t1 );
+
+  for ( i = 0; i < n; i++ )
+    print_record ( out[i] );
+  fprintf ( stderr, "# %zu observations of %" PRIu64 " found in %.1lf us. %" PRIu64 " not indexed\n", n, rd.nrecords,
+            ( t1.tv_sec - t0.tv_sec ) * 1e6 + ( t1.tv_nsec - t0.tv_nsec ) * 1e-3, rd.nrecords - rd.nindexed );
+
+  free ( out );
+  bufr2tac_store_reader_close ( &rd );
+  exit ( EXIT_SUCCESS );
+}
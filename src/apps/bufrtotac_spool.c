@@ -0,0 +1,254 @@
+/***************************************************************************
+ *   Copyright (C) 2013-2026 by Guillermo Ballester Valor                  *
+ *   gbv@ogimet.com                                                        *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.             *
+ ***************************************************************************/
+/*!
+ \file bufrtotac_spool.c
+ \brief file with the code to watch a spool directory in binary bufrtotac
+
+ Files are decoded as soon as they are closed after writing or moved into the spool directory, using the
+ same struct \ref bufrdeco for all of them, so the tables are read just once. Files with a name beginning
+ with '.' are ignored, so a feeder can write a temporary '.name' and rename it when finished.
+
+ Files that cannot be decoded are kept in subdirectory \ref BUFRTOTAC_SPOOL_ERROR_DIR of the spool directory.
+ */
+#ifndef CONFIG_H
+# include "config.h"
+# define CONFIG_H
+#endif
+
+#include "bufrtotac.h"
+
+#ifdef HAVE_SYS_INOTIFY_H
+
+#include <dirent.h>
+#include <errno.h>
+#include <signal.h>
+#include <unistd.h>
+#include <sys/inotify.h>
+
+/*!
+  \def BUFRTOTAC_SPOOL_ERROR_DIR
+  \brief Subdirectory of spool directory where the files that cannot be decoded are moved
+*/
+#define BUFRTOTAC_SPOOL_ERROR_DIR "error"
+
+/*!
+  \def BUFRTOTAC_SPOOL_BAD_SUFFIX
+  \brief Suffix added to a file that cannot be decoded if it cannot be moved to \ref BUFRTOTAC_SPOOL_ERROR_DIR
+*/
+#define BUFRTOTAC_SPOOL_BAD_SUFFIX ".bad"
+
+static volatile sig_atomic_t SPOOL_STOP; /*!< Set to 1 when a SIGINT or SIGTERM is received */
+
+/*!
+  \fn static void bufrtotac_spool_signal(int sig)
+  \brief Signal handler to finish the watch loop in a clean way
+  \param [in] sig signal number
+*/
+static void bufrtotac_spool_signal ( int sig )
+{
+  ( void ) sig;
+  SPOOL_STOP = 1;
+}
+
+/*!
+  \fn static void bufrtotac_spool_keep_bad(const char *name)
+  \brief Keep a file of spool directory that cannot be decoded
+  \param [in] name name of file in SPOOL_DIR, without directory
+
+  It is moved to subdirectory \ref BUFRTOTAC_SPOOL_ERROR_DIR, created if needed. If it cannot be moved there then
+  \ref BUFRTOTAC_SPOOL_BAD_SUFFIX is added to its name, so it is not decoded again.
+*/
+static void bufrtotac_spool_keep_bad ( const char *name )
+{
+  char bad[BUFRDECO_PATH_LENGTH + 8];
+
+  snprintf ( bad, sizeof ( bad ), "%s/%s", SPOOL_DIR, BUFRTOTAC_SPOOL_ERROR_DIR );
+  if ( ( mkdir ( bad, 0755 ) == 0 || errno == EEXIST ) &&
+       snprintf ( bad, sizeof ( bad ), "%s/%s/%s", SPOOL_DIR, BUFRTOTAC_SPOOL_ERROR_DIR, name ) < ( int ) sizeof ( bad ) &&
+       rename ( INPUTFILE, bad ) == 0 )
+    return;
+
+  snprintf ( bad, sizeof ( bad ), "%s%s", INPUTFILE, BUFRTOTAC_SPOOL_BAD_SUFFIX );
+  if ( rename ( INPUTFILE, bad ) )
+    printf ( "# Cannot keep '%s' which cannot be decoded: %s\n", INPUTFILE, strerror ( errno ) );
+}
+
+/*!
+  \fn static int bufrtotac_spool_file(const char *name)
+  \brief Decode a file of spool directory and then move or remove it
+  \param [in] name name of file in SPOOL_DIR, without directory
+  \return 0 if the file has been processed, 1 if it was skipped
+
+  The output is flushed after every file so the TAC reports are available to readers without delay. A file
+  that cannot be decoded is never removed, see \ref bufrtotac_spool_keep_bad
+*/
+static int bufrtotac_spool_file ( const char *name )
+{
+  char done[BUFRDECO_PATH_LENGTH];
+  struct stat st;
+  size_t len;
+
+  len = strlen ( name );
+  if ( name[0] == '.' || ( len > strlen ( BUFRTOTAC_SPOOL_BAD_SUFFIX ) &&
+                           strcmp ( name + len - strlen ( BUFRTOTAC_SPOOL_BAD_SUFFIX ), BUFRTOTAC_SPOOL_BAD_SUFFIX ) == 0 ) )
+    return 1;
+
+  if ( snprintf ( INPUTFILE, sizeof ( INPUTFILE ), "%s/%s", SPOOL_DIR, name ) >= ( int ) sizeof ( INPUTFILE ) )
+    return 1;
+
+  // It may be already processed when scanning the directory at start, or it can be a subdirectory
+  if ( stat ( INPUTFILE, &st ) || ! S_ISREG ( st.st_mode ) )
+    return 1;
+
+  snprintf ( OFFSETFILE, sizeof ( OFFSETFILE ), "%s.offs", INPUTFILE );
+
+  if ( bufrtotac_roll_output () )
+    {
+      printf ( "%s\n", ERR );
+      return 1;
+    }
+
+  NFILES++;
+  if ( bufrtotac_decode_file () )
+    {
+      if ( DEBUG )
+        printf ( "# Cannot decode '%s'\n", INPUTFILE );
+      fflush ( OUT );
+      bufrtotac_dump_stats ( 0 );
+      bufrtotac_spool_keep_bad ( name );
+      return 0;
+    }
+  fflush ( OUT );
+  bufrtotac_dump_stats ( 0 );
+
+  // Move or remove the processed file
+  if ( DONE_DIR[0] &&
+       snprintf ( done, sizeof ( done ), "%s/%s", DONE_DIR, name ) < ( int ) sizeof ( done ) )
+    {
+      if ( rename ( INPUTFILE, done ) == 0 )
+        return 0;
+      if ( DEBUG )
+        printf ( "# Cannot move '%s' to '%s': %s\n", INPUTFILE, done, strerror ( errno ) );
+    }
+  unlink ( INPUTFILE );
+  return 0;
+}
+
+/*!
+  \fn static void bufrtotac_spool_scan(void)
+  \brief Process all the files already present in the spool directory, in alphabetical order
+*/
+static void bufrtotac_spool_scan ( void )
+{
+  struct dirent **list;
+  int i, n;
+
+  if ( ( n = scandir ( SPOOL_DIR, &list, NULL, alphasort ) ) < 0 )
+    return;
+
+  for ( i = 0; i < n; i++ )
+    {
+      if ( SPOOL_STOP == 0 )
+        bufrtotac_spool_file ( list[i]->d_name );
+      free ( list[i] );
+    }
+  free ( list );
+}
+
+/*!
+  \fn int bufrtotac_watch_spool(void)
+  \brief Watch SPOOL_DIR and decode every file written or moved into it
+  \return 0 when finished by a signal, 1 if the directory cannot be watched
+
+  At start the files already in the directory are processed. Then it waits for inotify events until
+  a SIGINT or SIGTERM is received. If the kernel event queue overflows the directory is scanned again.
+*/
+int bufrtotac_watch_spool ( void )
+{
+  char buf[4096] __attribute__ ( ( aligned ( __alignof__ ( struct inotify_event ) ) ) );
+  const struct inotify_event *ev;
+  struct sigaction sa;
+  ssize_t len;
+  char *c;
+  int fd;
+
+  if ( ( fd = inotify_init1 ( IN_CLOEXEC ) ) < 0 )
+    {
+      printf ( "%s(): Cannot init inotify: %s\n", __func__, strerror ( errno ) );
+      return 1;
+    }
+
+  if ( inotify_add_watch ( fd, SPOOL_DIR, IN_CLOSE_WRITE | IN_MOVED_TO ) < 0 )
+    {
+      printf ( "%s(): Cannot watch '%s': %s\n", __func__, SPOOL_DIR, strerror ( errno ) );
+      close ( fd );
+      return 1;
+    }
+
+  // No SA_RESTART, so a blocking read() returns with EINTR
+  memset ( &sa, 0, sizeof ( sa ) );
+  sa.sa_handler = bufrtotac_spool_signal;
+  sigemptyset ( &sa.sa_mask );
+  sigaction ( SIGINT, &sa, NULL );
+  sigaction ( SIGTERM, &sa, NULL );
+
+  // The watch is already set, so no file is lost between the scan and the first read()
+  bufrtotac_spool_scan ();
+
+  while ( SPOOL_STOP == 0 )
+    {
+      if ( ( len = read ( fd, buf, sizeof ( buf ) ) ) <= 0 )
+        {
+          if ( len < 0 && errno == EINTR )
+            continue;
+          printf ( "%s(): Error reading inotify events: %s\n", __func__, strerror ( errno ) );
+          break;
+        }
+
+      for ( c = buf; c < buf + len && SPOOL_STOP == 0; c += sizeof ( struct inotify_event ) + ev->len )
+        {
+          ev = ( const struct inotify_event * ) c;
+          if ( ev->mask & IN_Q_OVERFLOW )
+            bufrtotac_spool_scan ();
+          else if ( ev->len && ( ev->mask & IN_ISDIR ) == 0 )
+            bufrtotac_spool_file ( ev->name );
+        }
+    }
+
+  close ( fd );
+  if ( DEBUG )
+    printf ( "# %d files processed\n", NFILES );
+  return 0;
+}
+
+#else
+
+/*!
+  \fn int bufrtotac_watch_spool(void)
+  \brief Dummy version for systems without inotify
+  \return 1
+*/
+int bufrtotac_watch_spool ( void )
+{
+  printf ( "%s(): Watch mode is not available in this build, sys/inotify.h was not found\n", __func__ );
+  return 1;
+}
+
+#endif
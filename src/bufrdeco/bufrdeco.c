@@ -28,10 +28,6 @@
 
 #include "bufrdeco.h"
 
-#ifdef DEBUG_TIME
-clock_t bufrdeco_clock_start, bufrdeco_clock_end;
-#endif
-
 const struct bufr_descriptor DESCRIPTOR_ROOT = { 0, 0, 0, 0, "000000" }; /*!< This is a descriptor supposed to be the sequence descriptor for sec3 descriptors */
 
 /*!
@@ -120,10 +116,16 @@ char* bufrdeco_get_version(char* version, size_t dversion, char* build, size_t d
 */
 int bufrdeco_parse_tree(struct bufrdeco* b)
 {
+    uint64_t t0;
+    int res;
+
     bufrdeco_assert(b != NULL);
 
     // here we start the parse
-    return bufrdeco_parse_tree_recursive(b, NULL, 0, NULL);
+    t0 = bufrdeco_stats_clock(b);
+    res = bufrdeco_parse_tree_recursive(b, NULL, 0, NULL);
+    bufrdeco_stats_add(b, BUFRDECO_STATS_TREE, t0);
+    return res;
 }
 
 /*!
@@ -183,13 +185,27 @@ int bufrdeco_reset(struct bufrdeco* b)
 {
     struct bufr_tables* tb;
     struct bufr_tables_cache ch;
+    struct bufrdeco_stats st;
+    struct bufrdeco_compressed_columns cols;
+    struct bufrdeco_ndjson_keys ndjson;
+    struct bufrdeco_dedup dedup;
+    char tables_dir[BUFRDECO_PATH_LENGTH];
+    char crefs_dir[BUFRDECO_PATH_LENGTH];
+    char timages_dir[BUFRDECO_PATH_LENGTH];
     FILE *out, *err;
     uint32_t mask;
     bufrdeco_assert(b != NULL);
 
     // save the data we do not reset
     memcpy(&ch, &b->cache, sizeof(struct bufr_tables_cache));
+    memcpy(&st, &b->stats, sizeof(struct bufrdeco_stats));
+    memcpy(&cols, &b->cols, sizeof(struct bufrdeco_compressed_columns));
+    memcpy(&ndjson, &b->ndjson, sizeof(struct bufrdeco_ndjson_keys));
+    memcpy(&dedup, &b->dedup, sizeof(struct bufrdeco_dedup));
     tb = b->tables;
+    strcpy(tables_dir, b->bufrtables_dir);
+    strcpy(crefs_dir, b->crefs_dir);
+    strcpy(timages_dir, b->timages_dir);
     mask = b->mask;
     out = b->out;
     err = b->err;
@@ -205,7 +221,24 @@ int bufrdeco_reset(struct bufrdeco* b)
     b->err = err;
     b->mask = mask;
     b->tables = tb;
+    strcpy(b->bufrtables_dir, tables_dir);
+    strcpy(b->crefs_dir, crefs_dir);
+    strcpy(b->timages_dir, timages_dir);
     memcpy(&b->cache, &ch, sizeof(struct bufr_tables_cache));
+    memcpy(&b->stats, &st, sizeof(struct bufrdeco_stats));
+    b->stats.read_start = 0;
+
+    // The arrays of columns are kept to be reused by next BUFR, but its data is no more valid
+    b->cols.dim = cols.dim;
+    b->cols.dimk = cols.dimk;
+    b->cols.val = cols.val;
+    b->cols.kind = cols.kind;
+
+    // The keys for flat json output are kept, the same template is likely to come in next BUFR
+    memcpy(&b->ndjson, &ndjson, sizeof(struct bufrdeco_ndjson_keys));
+
+    // The messages already seen are remembered among BUFR
+    memcpy(&b->dedup, &dedup, sizeof(struct bufrdeco_dedup));
 
     // allocate memory for expanded tree of descriptors
     if (bufrdeco_init_expanded_tree(&b->tree)) {
@@ -267,6 +300,9 @@ int bufrdeco_close(struct bufrdeco* b)
     // first deallocate all memory
     bufrdeco_free_subset_sequence_data(&(b->seq));
     bufrdeco_free_compressed_data_references(&(b->refs));
+    bufrdeco_free_compressed_columns(&(b->cols));
+    bufrdeco_free_ndjson_keys(&(b->ndjson));
+    bufrdeco_free_dedup(&(b->dedup));
     bufrdeco_free_expanded_tree(&(b->tree));
     bufrdeco_free_decode_subset_bitacora(&(b->bitacora));
     if (b->mask & BUFRDECO_USE_TABLES_CACHE) {
@@ -335,6 +371,9 @@ int bufrdeco_get_bufr(struct bufrdeco* b, char* filename)
 struct bufrdeco_subset_sequence_data* bufrdeco_get_target_subset_sequence_data(buf_t nset, struct bufrdeco* b)
 {
     buf_t n;
+    uint64_t t0;
+    struct bufrdeco_subset_sequence_data* s;
+    char crefs_file[BUFRDECO_PATH_LENGTH + 32];
     bufrdeco_assert(b != NULL);
     uint32_t mask0 = b->mask;
 
@@ -343,16 +382,34 @@ struct bufrdeco_subset_sequence_data* bufrdeco_get_target_subset_sequence_data(b
         return NULL;
     }
 
+    t0 = bufrdeco_stats_clock(b);
     if (b->sec3.compressed) {
 #ifdef __DEBUG
         printf("# Compressed\n");
 #endif
         // case of compressed, we just need the compressed references
         if (b->refs.nd == 0) {
-            // case of compressed data and still not parsed the refs
-            if (bufrdeco_parse_compressed(&(b->refs), b)) {
-                return NULL;
+            // case of compressed data and still not parsed the refs.
+            // If a cache is used, try first to read the refs already parsed for the same message
+            crefs_file[0] = '\0';
+            if ((b->mask & BUFRDECO_USE_COMPRESSED_REFERENCES_CACHE)
+                && bufrdeco_compressed_references_path(crefs_file, sizeof(crefs_file), b))
+                crefs_file[0] = '\0';
+
+            if (crefs_file[0] && bufrdeco_read_compressed_references(b, crefs_file) == 0) {
+                b->stats.crefs_hits++;
+            } else {
+                if (bufrdeco_parse_compressed(&(b->refs), b)) {
+                    return NULL;
+                }
+                if (crefs_file[0]) {
+                    b->stats.crefs_misses++;
+                    // A failure here is not fatal, the refs will be parsed again next time
+                    bufrdeco_write_compressed_references(b, crefs_file);
+                }
             }
+            bufrdeco_stats_add(b, BUFRDECO_STATS_COMPRESSED, t0);
+            t0 = bufrdeco_stats_clock(b);
         }
     } else if (nset > 0) {
         // In case of not compressed bufr, to parse a subset we need to know the bit offset of the subset data in sec4
@@ -363,8 +420,8 @@ struct bufrdeco_subset_sequence_data* bufrdeco_get_target_subset_sequence_data(b
         //       or if readed the struct from a file
         // In any case the subset bit offset array must be poluted for all n < (nset - 1)
 
-        // clear bit BUFRDECO_OUTPUT_JSON_SUBSET_DATA if actived
-        b->mask &= ~((uint32_t)BUFRDECO_OUTPUT_JSON_SUBSET_DATA);
+        // clear bits BUFRDECO_OUTPUT_JSON_SUBSET_DATA and BUFRDECO_OUTPUT_NDJSON_SUBSET_DATA if actived
+        b->mask &= ~((uint32_t)(BUFRDECO_OUTPUT_JSON_SUBSET_DATA | BUFRDECO_OUTPUT_NDJSON_SUBSET_DATA));
 
         if (b->offsets.nr == 0 || b->offsets.ofs[nset] == 0) {
             for (n = b->state.subset; n < nset; n++) {
@@ -384,5 +441,10 @@ struct bufrdeco_subset_sequence_data* bufrdeco_get_target_subset_sequence_data(b
 #ifdef __DEBUG
     printf("# Finally going to target parse for subset %u\n", b->state.subset);
 #endif
-    return bufrdeco_get_subset_sequence_data(b);
+    if ((s = bufrdeco_get_subset_sequence_data(b)) != NULL) {
+        bufrdeco_stats_add(b, BUFRDECO_STATS_SUBSET, t0);
+        if (b->mask & BUFRDECO_COLLECT_STATS)
+            b->stats.subsets++;
+    }
+    return s;
 }
@@ -33,20 +33,15 @@ extern "C" {
 #define _GNU_SOURCE
 #endif
 
-// Uncomment following line to get timimgs in debug phase
-// #define DEBUG_TIME
-
 #include <getopt.h>
 #include <libgen.h>
+#include <inttypes.h>
+#include <stdarg.h>
 #include <stdint.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 #include <time.h>
-#ifdef DEBUG_TIME
-#include <sys/times.h>
-#include <unistd.h>
-#endif
 #include <math.h>
 #include <sys/stat.h>
 
@@ -119,6 +114,12 @@ extern "C" {
 */
 #define BUFR_NMAXSEQ (16384)
 
+/*!
+  \def BUFR_STRINGS_INITIAL_SIZE
+  \brief Initial bytes allocated for the strings of a table, see struct \ref bufr_strings
+*/
+#define BUFR_STRINGS_INITIAL_SIZE (65536U)
+
 /*!
   \def BUFR_EXPLAINED_LENGTH
   \brief Maximum length for a explained descriptor string
@@ -323,6 +324,50 @@ extern "C" {
 */
 #define BUFRDECO_LOCAL_TABLES (512) 
 
+/*!
+  \def BUFRDECO_COLLECT_STATS
+  \brief Bit mask to the member mask for struct \ref bufrdeco to collect runtime statistics in member \a stats
+*/
+#define BUFRDECO_COLLECT_STATS (1024)
+
+/*!
+  \def BUFRDECO_OUTPUT_NDJSON_SUBSET_DATA
+  \brief Bit mask to the member mask for struct \ref bufrdeco to print every subset as a flat json object in a single line
+*/
+#define BUFRDECO_OUTPUT_NDJSON_SUBSET_DATA (2048)
+
+/*!
+  \def BUFRDECO_OUTPUT_NDJSON_MEANINGS
+  \brief Bit mask to the member mask for struct \ref bufrdeco to add the meanings of code and flag tables in flat json output
+*/
+#define BUFRDECO_OUTPUT_NDJSON_MEANINGS (4096)
+
+/*!
+  \def BUFRDECO_USE_COMPRESSED_REFERENCES_CACHE
+  \brief Bit mask to the member mask for struct \ref bufrdeco to read and write the compressed references in the
+  directory \a crefs_dir, see \ref bufrdeco_set_compressed_references_dir
+*/
+#define BUFRDECO_USE_COMPRESSED_REFERENCES_CACHE (8192)
+
+/*!
+  \def BUFRDECO_SKIP_DUPLICATES
+  \brief Bit mask to the member mask for struct \ref bufrdeco to skip the messages already seen, see struct \ref bufrdeco_dedup
+*/
+#define BUFRDECO_SKIP_DUPLICATES (16384)
+
+/*!
+  \def BUFRDECO_USE_TABLES_IMAGES
+  \brief Bit mask to the member mask for struct \ref bufrdeco to read and write the merged tables as binary images in
+  the directory \a timages_dir, see \ref bufrdeco_set_tables_images_dir
+*/
+#define BUFRDECO_USE_TABLES_IMAGES (32768)
+
+/*!
+  \def BUFRDECO_DUPLICATED
+  \brief Returned by \ref bufrdeco_read_buffer and the functions which call it when a message is skipped as duplicated
+*/
+#define BUFRDECO_DUPLICATED (2)
+
 /*!
   \def BUFR_TABLEB_NAME_LENGTH
   \brief Max length (in chars) reserved for a name of variable in table B
@@ -418,18 +463,6 @@ typedef int32_t ibuf_t;
         return (__returnval__);                                                  \
     }
 
-#ifdef DEBUG_TIME
-/*!
- * \def print_timing
- * \brief Macro to print the time interval between two clocks(). Useful in debug time.
- */
-#define print_timing(__clk_start, __clk_end, __explanation) \
-    printf("# %.6lf s <- Elapsed time for %s\n", (double)(__clk_end - __clk_start) / (double)(CLOCKS_PER_SEC), #__explanation)
-
-extern clock_t bufrdeco_clock_start, bufrdeco_clock_end;
-
-#endif
-
 /*!
   \struct bufr_descriptor
   \brief BUFR descriptor
@@ -725,7 +758,7 @@ struct bufrdeco_compressed_ref {
     int32_t bitac; /*!< Index in the bitacora related to this struct */
     uint8_t is_associated; /*!< 0 if is not associated data */
     uint8_t has_data; /*!< 1 if has any subset with valid data. 0 if missing in all subsets */
-    uint8_t bits; /*!< bits for data or associated in table B */
+    uint16_t bits; /*!< bits for data or associated in table B. CCITT IA5 fields may need more than 255 */
     uint8_t inc_bits; /*!< number of inc bits for every subset  */
     int32_t ref; /*!< reference for a expanded data in table B */
     buf_t bit0; /*!< first bit offset, i.e, most significant bit for ref0 */
@@ -799,6 +832,55 @@ struct bufrdeco_compressed_data_references {
     struct bufrdeco_compressed_ref* refs; /*!< pointer to allocated array */
 };
 
+/*!
+ * \enum bufrdeco_column_kind
+ * \brief How the data of a struct \ref bufrdeco_compressed_ref is got from a struct \ref bufrdeco_compressed_columns
+ */
+enum bufrdeco_column_kind {
+    BUFRDECO_COLUMN_NONE = 0, /*!< No column. Strings, associated fields and local descriptors are got from sec4 for every subset */
+    BUFRDECO_COLUMN_NUMERIC, /*!< Numeric value */
+    BUFRDECO_COLUMN_CODE_TABLE, /*!< Numeric value of a code table */
+    BUFRDECO_COLUMN_FLAG_TABLE /*!< Numeric value of a flag table */
+};
+
+/*!
+ * \struct bufrdeco_compressed_columns
+ * \brief Values of all subsets of a compressed BUFR, got in a single pass for every struct \ref bufrdeco_compressed_ref
+ *
+ * The value of reference \a i for subset \a k is \a val[i * nsubsets + k], \ref MISSING_REAL if missing. Once a subset has been
+ * fully decoded in the struct \ref bufrdeco_subset_sequence_data of a \ref bufrdeco, the names, units and descriptors of its atoms are
+ * the same for all subsets, so only the values are changed from these columns to get other subset
+ */
+struct bufrdeco_compressed_columns {
+    uint8_t ready; /*!< If != 0 then \a val and \a kind have the data for current compressed references */
+    uint8_t seq_ready; /*!< If != 0 then the subset sequence data of the \ref bufrdeco has a full decoded subset of current references */
+    buf_t nrefs; /*!< Number of compressed references with a column */
+    buf_t nsubsets; /*!< Number of subsets in every column */
+    size_t dim; /*!< Allocated elements in \a val */
+    size_t dimk; /*!< Allocated elements in \a kind */
+    double* val; /*!< Array of nrefs * nsubsets values */
+    uint8_t* kind; /*!< Array of nrefs \ref bufrdeco_column_kind */
+};
+
+/*!
+ * \struct bufrdeco_ndjson_keys
+ * \brief Keys of the flat json output for an expanded sequence of descriptors
+ *
+ * Key \a i is the chars from \a keys + \a ofs[i] to \a keys + \a ofs[i + 1], already rendered as <tt>,"f xx yyy":</tt>, with a
+ * suffix "_n" for the n-th occurrence of the same descriptor in the sequence. The keys are rendered once and reused while
+ * the subsets have the same list of descriptors \a desc, as usually happens for all subsets of a BUFR and for the same
+ * template in several BUFRs
+ */
+struct bufrdeco_ndjson_keys {
+    buf_t nd; /*!< Number of descriptors with a key */
+    buf_t dim; /*!< Allocated elements in \a desc. The array \a ofs has dim + 1 elements */
+    uint16_t* desc; /*!< Array of descriptors as (f << 14) | (x << 8) | y */
+    size_t* ofs; /*!< Offset of every key in \a keys */
+    size_t kdim; /*!< Allocated chars in \a keys */
+    char* keys; /*!< Rendered keys */
+    buf_t* count; /*!< Scratch array with occurrences of every descriptor, used when building the keys */
+};
+
 /*!
  *  \struct bufrdeco_subset_bit_offsets
  *  \brief Array of offset in bits for every subset in a non-compressed bufr. Offset is counted in bits from the init of SEC4 data, usually bit 32.
@@ -825,6 +907,293 @@ struct bufr_sec0 {
     uint8_t raw[8]; /*!< bytes as in the bufr message */
 };
 
+/*!
+  \def BUFRDECO_INDEX_MAGIC
+  \brief First 8 bytes of an archive index file, see struct \ref bufrdeco_index_header
+*/
+#define BUFRDECO_INDEX_MAGIC "BUFRIDX"
+
+/*!
+  \def BUFRDECO_INDEX_VERSION
+  \brief Version of the layout of archive index files. Changed whenever a struct of the file changes
+*/
+#define BUFRDECO_INDEX_VERSION (1)
+
+/*!
+  \def BUFRDECO_INDEX_BYTE_ORDER
+  \brief Mark written in native byte order in an archive index. A file from a host with other byte order is rejected
+*/
+#define BUFRDECO_INDEX_BYTE_ORDER (0x01020304U)
+
+/*!
+  \def BUFRDECO_INDEX_IDENT_LENGTH
+  \brief Chars reserved for the station or platform identifier of a subset in an archive index
+*/
+#define BUFRDECO_INDEX_IDENT_LENGTH (24)
+
+/*!
+  \struct bufrdeco_index_header
+  \brief Header at the begin of an archive index file
+
+  The file is the header, the array of \a nmessages struct \ref bufrdeco_index_message at byte \a messages_offset
+  and the array of \a nsubsets struct \ref bufrdeco_index_subset at byte \a subsets_offset, all of them in native
+  byte order and with natural alignment, so the file can be used directly with mmap(2). The subsets are sorted
+  by identifier, time, message and subset
+*/
+struct bufrdeco_index_header {
+    char magic[8]; /*!< \ref BUFRDECO_INDEX_MAGIC */
+    uint32_t version; /*!< \ref BUFRDECO_INDEX_VERSION */
+    uint32_t byte_order; /*!< \ref BUFRDECO_INDEX_BYTE_ORDER */
+    uint32_t header_size; /*!< Size of this struct */
+    uint32_t message_size; /*!< Size of struct \ref bufrdeco_index_message */
+    uint32_t subset_size; /*!< Size of struct \ref bufrdeco_index_subset */
+    uint32_t nmessages; /*!< Number of indexed messages */
+    uint64_t nsubsets; /*!< Number of indexed subsets */
+    uint64_t messages_offset; /*!< Byte offset of the array of messages in file */
+    uint64_t subsets_offset; /*!< Byte offset of the array of subsets in file */
+    uint64_t archive_size; /*!< Size in bytes of the indexed archive */
+    int64_t archive_mtime; /*!< Modification time of the indexed archive */
+};
+
+/*!
+  \struct bufrdeco_index_message
+  \brief A BUFR message of an archive as stored in an index file
+*/
+struct bufrdeco_index_message {
+    uint64_t offset; /*!< Byte offset of 'BUFR' in archive */
+    uint32_t length; /*!< Length in bytes of the message */
+    uint32_t template_hash; /*!< FNV-1a hash of the unexpanded descriptors of sec3 */
+    uint32_t nsubsets; /*!< Number of subsets in sec3 */
+    uint16_t centre; /*!< Originating centre */
+    uint16_t subcentre; /*!< Originating subcentre */
+    uint16_t year; /*!< Year of sec1 */
+    uint8_t month; /*!< Month of sec1 */
+    uint8_t day; /*!< Day of sec1 */
+    uint8_t hour; /*!< Hour of sec1 */
+    uint8_t minute; /*!< Minute of sec1 */
+    uint8_t second; /*!< Second of sec1 */
+    uint8_t edition; /*!< BUFR edition */
+    uint8_t master_version; /*!< Version of master tables */
+    uint8_t master_local; /*!< Version of local tables */
+    uint8_t category; /*!< Data category */
+    uint8_t subcategory; /*!< International data subcategory */
+    uint8_t subcategory_local; /*!< Local data subcategory */
+    uint8_t compressed; /*!< 1 if compressed */
+    uint8_t pad[2]; /*!< Not used, set to 0 */
+};
+
+/*!
+  \struct bufrdeco_index_subset
+  \brief A subset of an archive as stored in an index file
+*/
+struct bufrdeco_index_subset {
+    char ident[BUFRDECO_INDEX_IDENT_LENGTH]; /*!< Station or platform identifier, as '08221'. Empty if unknown */
+    int64_t time; /*!< Time of observation in seconds since epoch (UTC) */
+    uint32_t message; /*!< Index of message in the array of struct \ref bufrdeco_index_message */
+    uint32_t subset; /*!< Index of subset in the message */
+    uint32_t bit_offset; /*!< Bit offset of subset data in sec4 for uncompressed messages. 0 for compressed ones, whose
+                             subsets are got from the compressed references, and for the first subset */
+    uint32_t pad; /*!< Not used, set to 0 */
+};
+
+/*!
+  \struct bufrdeco_index
+  \brief An archive index file and, optionally, its archive mapped in memory
+*/
+struct bufrdeco_index {
+    char archive[BUFRDECO_PATH_LENGTH]; /*!< Pathname of the archive */
+    void* map; /*!< Index file mapped in memory */
+    size_t size; /*!< Size of \a map */
+    uint8_t* data; /*!< Archive mapped in memory, NULL if not opened */
+    size_t data_size; /*!< Size of \a data */
+    const struct bufrdeco_index_header* header; /*!< Header of index */
+    const struct bufrdeco_index_message* msg; /*!< Array of messages */
+    const struct bufrdeco_index_subset* sub; /*!< Sorted array of subsets */
+};
+
+/*!
+  \def BUFRDECO_SNAPSHOT_MAGIC
+  \brief First 8 bytes of a snapshot file, see struct \ref bufrdeco_snapshot_header
+*/
+#define BUFRDECO_SNAPSHOT_MAGIC "BUFRSNP"
+
+/*!
+  \def BUFRDECO_SNAPSHOT_VERSION
+  \brief Version of the layout of snapshot files. Changed whenever a struct of the file changes
+*/
+#define BUFRDECO_SNAPSHOT_VERSION (1)
+
+/*!
+  \struct bufrdeco_snapshot_header
+  \brief Header at the begin of a snapshot file with the decoded subsets of a BUFR message
+
+  The file is the header, the array of \a nsubsets struct \ref bufrdeco_snapshot_subset at byte \a subsets_offset,
+  the array of \a natoms struct \ref bufrdeco_snapshot_atom at byte \a atoms_offset and the table of nul terminated
+  strings at byte \a strings_offset. All of them are in native byte order and with natural alignment, so the file
+  can be used directly with mmap(2). Every different string is in the table once
+*/
+struct bufrdeco_snapshot_header {
+    char magic[8]; /*!< \ref BUFRDECO_SNAPSHOT_MAGIC */
+    uint32_t version; /*!< \ref BUFRDECO_SNAPSHOT_VERSION */
+    uint32_t byte_order; /*!< \ref BUFRDECO_INDEX_BYTE_ORDER */
+    uint32_t header_size; /*!< Size of this struct */
+    uint32_t subset_size; /*!< Size of struct \ref bufrdeco_snapshot_subset */
+    uint32_t atom_size; /*!< Size of struct \ref bufrdeco_snapshot_atom */
+    uint32_t nsubsets; /*!< Number of subsets */
+    uint64_t hash; /*!< Hash of the message, as got with \ref bufrdeco_message_hash */
+    uint64_t natoms; /*!< Number of data of all subsets */
+    uint64_t subsets_offset; /*!< Byte offset of the array of subsets in file */
+    uint64_t atoms_offset; /*!< Byte offset of the array of data in file */
+    uint64_t strings_offset; /*!< Byte offset of the table of strings in file */
+    uint64_t strings_size; /*!< Bytes of the table of strings */
+};
+
+/*!
+  \struct bufrdeco_snapshot_subset
+  \brief A decoded subset as stored in a snapshot file
+*/
+struct bufrdeco_snapshot_subset {
+    uint32_t ss; /*!< Index of subset in the message */
+    uint32_t nd; /*!< Number of data in subset */
+    uint64_t first; /*!< Index of first data of subset in the array of struct \ref bufrdeco_snapshot_atom */
+};
+
+/*!
+  \struct bufrdeco_snapshot_atom
+  \brief A struct \ref bufr_atom_data as stored in a snapshot file
+
+  Strings are byte offsets in the table of strings, where offset 0 is an empty string. Indexes of related data are relative to the subset, as in a
+  struct \ref bufrdeco_subset_sequence_data
+*/
+struct bufrdeco_snapshot_atom {
+    double val; /*!< Value */
+    int32_t escale; /*!< Scale applied to get the data */
+    uint32_t mask; /*!< Mask with the type */
+    uint8_t f; /*!< F part of descriptor */
+    uint8_t x; /*!< X part of descriptor */
+    uint8_t y; /*!< Y part of descriptor */
+    uint8_t pad; /*!< Not used, set to 0 */
+    uint32_t associated; /*!< Associated field */
+    uint32_t name; /*!< Offset of name */
+    uint32_t unit; /*!< Offset of unit */
+    uint32_t cval; /*!< Offset of string value */
+    uint32_t ctable; /*!< Offset of explained meaning of code or flag table */
+    uint32_t associated_to; /*!< Index of data which this is associated to */
+    uint32_t ns; /*!< Element in the sequence of tree to which this descriptor belongs to */
+    uint32_t me; /*!< Index of this data */
+    uint32_t bitac; /*!< Index in bitacora */
+    uint32_t is_bitmaped_by; /*!< Index of data which bitmaps this one */
+    uint32_t bitmap_to; /*!< Index of data which this one is mapping to */
+    uint32_t related_to; /*!< Index of data which this one is related to */
+    uint32_t pad2; /*!< Not used, set to 0 */
+};
+
+/*!
+  \struct bufrdeco_snapshot_builder
+  \brief Decoded subsets being added to a snapshot before writing it with \ref bufrdeco_snapshot_write
+*/
+struct bufrdeco_snapshot_builder {
+    struct bufrdeco_snapshot_subset* sub; /*!< Array of subsets */
+    uint32_t nsub; /*!< Used subsets */
+    uint32_t dsub; /*!< Allocated subsets */
+    struct bufrdeco_snapshot_atom* atom; /*!< Array of data */
+    uint64_t natom; /*!< Used data */
+    uint64_t datom; /*!< Allocated data */
+    char* str; /*!< Table of strings */
+    uint32_t lstr; /*!< Used bytes of table of strings */
+    uint32_t dstr; /*!< Allocated bytes of table of strings */
+    uint32_t* slot; /*!< Hash table of offsets of strings, to add every string once. 0 is a free slot */
+    uint32_t nslot; /*!< Number of slots of hash table, a power of 2 */
+    uint32_t nused; /*!< Used slots of hash table */
+};
+
+/*!
+  \struct bufrdeco_snapshot
+  \brief A snapshot file mapped in memory
+*/
+struct bufrdeco_snapshot {
+    void* map; /*!< File mapped in memory */
+    size_t size; /*!< Size of \a map */
+    const struct bufrdeco_snapshot_header* header; /*!< Header of file */
+    const struct bufrdeco_snapshot_subset* sub; /*!< Array of subsets */
+    const struct bufrdeco_snapshot_atom* atom; /*!< Array of data */
+    const char* str; /*!< Table of strings */
+};
+
+/*!
+  \def BUFRDECO_ARROW_BATCH_ROWS
+  \brief Default rows of a record batch in a columnar export, see struct \ref bufrdeco_arrow_writer
+*/
+#define BUFRDECO_ARROW_BATCH_ROWS (65536)
+
+/*!
+  \def BUFRDECO_ARROW_NAME_LENGTH
+  \brief Max length of the name of a column in a columnar export
+*/
+#define BUFRDECO_ARROW_NAME_LENGTH (16)
+
+/*!
+ * \enum bufrdeco_arrow_type
+ * \brief Type of a column in a columnar export
+ */
+enum bufrdeco_arrow_type {
+    BUFRDECO_ARROW_UNKNOWN = 0, /*!< Not known yet. Written as \ref BUFRDECO_ARROW_FLOAT64 if no data was found */
+    BUFRDECO_ARROW_INT32, /*!< Signed integer of 32 bits, for the index of message and subset */
+    BUFRDECO_ARROW_FLOAT64, /*!< Double, for numeric data and code and flag tables */
+    BUFRDECO_ARROW_UTF8 /*!< String, for CCITT IA5 data */
+};
+
+/*!
+  \struct bufrdeco_arrow_column
+  \brief A column of a columnar export with the rows of current record batch
+
+  A descriptor column has the value of the n-th occurrence of descriptor \a key in every subset, null if missing or
+  not in subset. Values are in \a data as int32_t or double. For strings \a data are the nrows + 1 int32_t offsets
+  of every string in \a str
+*/
+struct bufrdeco_arrow_column {
+    char name[BUFRDECO_ARROW_NAME_LENGTH]; /*!< Name of column, as '012101' or '012101_2' for the second occurrence */
+    char key[8]; /*!< Descriptor as 'FXXYYY', empty for message and subset columns */
+    uint16_t desc; /*!< Descriptor as (f << 14) | (x << 8) | y */
+    uint8_t type; /*!< A \ref bufrdeco_arrow_type */
+    buf_t occurrence; /*!< Occurrence of descriptor in subset, first is 1 */
+    buf_t next; /*!< Index plus one of next column with the same descriptor, 0 if none */
+    buf_t iatom; /*!< Index plus one of the data for this column in current subset, 0 if not in subset */
+    buf_t filled; /*!< Rows already set in current batch */
+    buf_t nulls; /*!< Null rows in current batch */
+    uint8_t* valid; /*!< Validity bitmap, bit set for a non null row */
+    uint8_t* data; /*!< Values or offsets of strings */
+    char* str; /*!< Chars of strings */
+    size_t lstr; /*!< Used chars in \a str */
+    size_t dstr; /*!< Allocated chars in \a str */
+};
+
+/*!
+  \struct bufrdeco_arrow_writer
+  \brief Writer of decoded subsets in Apache Arrow IPC streaming format, a row per subset and a column per descriptor
+
+  The stream is a schema message, the record batches and an end of stream mark. The two first columns are the index
+  of message in stream and the index of subset in message. The schema is fixed when the first batch is written
+*/
+struct bufrdeco_arrow_writer {
+    FILE* out; /*!< Stream opened by caller */
+    struct bufrdeco_arrow_column* col; /*!< Array of columns */
+    buf_t ncols; /*!< Number of columns */
+    buf_t dcols; /*!< Allocated columns */
+    buf_t nrows; /*!< Rows in current batch */
+    buf_t drows; /*!< Allocated rows in every column */
+    buf_t batch_rows; /*!< Rows of a batch. A batch is written when reached */
+    uint32_t message; /*!< Index of current message */
+    uint8_t schema_written; /*!< If != 0 then the schema is written and no column can be added */
+    uint64_t rows; /*!< Rows written */
+    uint64_t batches; /*!< Record batches written */
+    buf_t* first; /*!< Index plus one of first column of every descriptor as (f << 14) | (x << 8) | y, 0 if none */
+    buf_t* count; /*!< Scratch array with occurrences of every descriptor in a subset */
+    uint8_t* fb; /*!< Scratch buffer for flatbuffers metadata */
+    size_t lfb; /*!< Used bytes of \a fb */
+    size_t dfb; /*!< Allocated bytes of \a fb */
+};
+
 /*!
   \struct gts_header
   \brief stores WMO GTS header info
@@ -948,6 +1317,28 @@ struct bufr_sec4 {
     uint8_t raw[BUFR_LEN]; /*!< Pointer to a raw data for sec4 as in original BUFR file */
 };
 
+/*!
+  \struct bufr_strings
+  \brief Pool of the strings of a table, every different string stored once
+
+  Items of tables keep the offset of their strings in member \a s, so they are fixed size records whatever the
+  length of strings. Offset 0 is always the empty string
+*/
+struct bufr_strings {
+    char* s; /*!< Strings, every one ended with '\0' */
+    uint32_t used; /*!< Bytes used in \a s */
+    uint32_t dim; /*!< Bytes allocated in \a s */
+    uint32_t* hash; /*!< Hash table of offsets in \a s, to find a string already stored. 0 if slot is empty */
+    uint32_t nhash; /*!< Slots allocated in \a hash, a power of 2 */
+    uint32_t nstr; /*!< Strings in \a hash */
+};
+
+/*!
+  \def bufr_strings_get
+  \brief Get the string at an offset of a struct \ref bufr_strings
+*/
+#define bufr_strings_get(_p_, _ofs_) ((_p_)->s != NULL ? (const char*)((_p_)->s + (_ofs_)) : "")
+
 /*!
    \struct bufr_tableB_decoded_item
    \brief Store parameters for a descriptor in table b, i. e. with f = 0
@@ -958,8 +1349,8 @@ struct bufr_tableB_decoded_item {
     uint8_t y; /*!< y value of descriptor */
     uint8_t kk; /*!< not used. A trick to align */
     char key[8]; /*!< c value of descriptor */
-    char name[BUFR_TABLEB_NAME_LENGTH]; /*!< name */
-    char unit[BUFR_TABLEB_UNIT_LENGTH]; /*!< unit */
+    uint32_t name_ofs; /*!< Offset of name in member \a strings of struct \ref bufr_tableB */
+    uint32_t unit_ofs; /*!< Offset of unit in member \a strings of struct \ref bufr_tableB */
     int32_t scale; /*!< escale */
     int32_t scale_ori; /*!< escale as readed from table b */
     int32_t reference; /*!< reference */
@@ -985,6 +1376,7 @@ struct bufr_tableB {
     buf_t num[64]; /*!< Amount of items for x. num[i] is the amount of items in array where x = i */
     uint8_t y_ref[64][256]; /*!< index for y since first x. x_ref[i][j] is index since x_start[i] where y == j */
     struct bufr_tableB_decoded_item item[BUFR_MAXLINES_TABLEB]; /*!< Array with structs containing parsed lines readed from file */
+    struct bufr_strings strings; /*!< Names and units of items. Must be the last member */
 };
 
 /*!
@@ -997,7 +1389,7 @@ struct bufr_tableC_decoded_item {
     uint8_t x; /*!< x value of descriptor */
     uint8_t y; /*!< y value of descriptor */
     uint32_t ival; /*!< code value */
-    char description[BUFR_EXPLAINED_LENGTH]; /*!< Description string of code */
+    uint32_t description_ofs; /*!< Offset of description string of code in member \a strings of struct \ref bufr_tableC */
 };
 
 /*!
@@ -1015,6 +1407,7 @@ struct bufr_tableC {
     buf_t num[64]; /*!< Amonut of lines for x. num[i] is the amount of items in array where x = i */
     buf_t y_ref[64][256]; /*!< index for first y since first x. x_ref[i][j] is index since x_start[i] where y == j */
     struct bufr_tableC_decoded_item item[BUFR_MAXLINES_TABLEC]; /*!< Array of decoded lines */
+    struct bufr_strings strings; /*!< Descriptions of items. Must be the last member */
 };
 
 /*!
@@ -1024,8 +1417,9 @@ struct bufr_tableC {
 struct bufr_tableD_decoded_item {
     char key[8]; /*!< c key value of sequence descriptor */
     char key2[8]; /*!< c key 2 of sequence element */
-    char description[BUFR_EXPLAINED_LENGTH]; /*!< Explained name of sequence */
-    char description2[BUFR_EXPLAINED_LENGTH]; /*!< Explained name of elemet of sequence */
+    buf_t nseq; /*!< In the first line of a sequence, the amount of its elements. 0 otherwise */
+    uint32_t description_ofs; /*!< Offset of explained name of sequence in member \a strings of struct \ref bufr_tableD */
+    uint32_t description2_ofs; /*!< Offset of explained name of elemet of sequence in member \a strings of struct \ref bufr_tableD */
 };
 
 /*!
@@ -1041,8 +1435,8 @@ struct bufr_tableD {
     buf_t nlines; /*!< Current lines readed from file, i. e. used in array \a l[] */
     buf_t x_start[64]; /*!< Index in array \a l[] for first x. x_start[j] is index for first descriptor which x == j */
     buf_t num[64]; /*!< Amonut of lines for x. num[i] is the amount of items in array where x = i */
-    char l[BUFR_MAXLINES_TABLED][24]; /*!< Array with info about descriptor sequences emulating ECMW tables D */
     struct bufr_tableD_decoded_item item[BUFR_MAXLINES_TABLED]; /*!< Array of decoded lines */
+    struct bufr_strings strings; /*!< Descriptions of items. Must be the last member */
 };
 
 /*!
@@ -1061,18 +1455,150 @@ struct bufr_tables {
  * \struct bufr_tables_cache
  * \brief Struct to store the cache of structs \ref bufr_tables
  *
- * When used, the member \a tables in main struct \ref bufrdeco is pointing to one of the elements in member array \a tab
+ * When used, the member \a tables in main struct \ref bufrdeco is pointing to one of the elements in member array \a tab.
+ * When full, the least recently used element is replaced. Hits, misses and evictions are counted in \ref bufrdeco_stats
  */
 struct bufr_tables_cache {
     buf_t nt; /*!< Tables actually allocated in cache */
-    buf_t next; /*< index of next element in array to add */
-    int8_t ver[BUFRDECO_TABLES_CACHE_SIZE]; /*!< Table version for array elements */
-    int8_t local_ver[BUFRDECO_TABLES_CACHE_SIZE]; /*!< Local table version for array elements */
-    int8_t centre[BUFRDECO_TABLES_CACHE_SIZE]; /*!< Centre for array elements */
-    int8_t subcentre[BUFRDECO_TABLES_CACHE_SIZE]; /*!< Sub-centre for array elements */
+    uint64_t tick; /*!< Counter increased every time an element is used */
+    uint64_t last_use[BUFRDECO_TABLES_CACHE_SIZE]; /*!< Value of \a tick when element was last used. 0 if free or not valid */
+    uint8_t ver[BUFRDECO_TABLES_CACHE_SIZE]; /*!< Version of master table files for array elements */
+    uint8_t local_ver[BUFRDECO_TABLES_CACHE_SIZE]; /*!< Local table version for array elements */
+    uint16_t centre[BUFRDECO_TABLES_CACHE_SIZE]; /*!< Centre for array elements */
+    uint16_t subcentre[BUFRDECO_TABLES_CACHE_SIZE]; /*!< Sub-centre for array elements */
     struct bufr_tables* tab[BUFRDECO_TABLES_CACHE_SIZE]; /*! Array of structs \ref bufr_tables allocated */
 };
 
+/*!
+ * \enum bufrdeco_stats_phase
+ * \brief Phases of decoding timed in struct \ref bufrdeco_stats
+ */
+enum bufrdeco_stats_phase {
+    BUFRDECO_STATS_READ = 0, /*!< Read the file and split sections */
+    BUFRDECO_STATS_TABLES, /*!< Load tables, from files or cache */
+    BUFRDECO_STATS_TREE, /*!< Expand the tree of descriptors */
+    BUFRDECO_STATS_COMPRESSED, /*!< Parse the references of compressed data */
+    BUFRDECO_STATS_SUBSET, /*!< Decode data of a subset */
+    BUFRDECO_STATS_TAC, /*!< Generate TAC reports. Timed by caller */
+    BUFRDECO_STATS_PHASES /*!< Number of phases */
+};
+
+/*!
+ * \struct bufrdeco_stats
+ * \brief Runtime statistics collected when bit \ref BUFRDECO_COLLECT_STATS is set in mask of struct \ref bufrdeco
+ *
+ * Times are measured with CLOCK_MONOTONIC. These data are not cleaned by \ref bufrdeco_reset, so they are accumulated
+ * for all BUFR decoded since \ref bufrdeco_init or the last call to \ref bufrdeco_clean_stats
+ */
+struct bufrdeco_stats {
+    uint64_t start; /*!< Monotonic time in nanoseconds when stats were cleaned */
+    uint64_t read_start; /*!< Monotonic time in nanoseconds when current file read began, 0 if none */
+    uint64_t calls[BUFRDECO_STATS_PHASES]; /*!< Number of calls for every phase */
+    uint64_t ns[BUFRDECO_STATS_PHASES]; /*!< Accumulated nanoseconds for every phase */
+    uint64_t messages; /*!< BUFR messages read */
+    uint64_t bytes; /*!< Bytes of BUFR messages read */
+    uint64_t subsets; /*!< Subsets decoded */
+    uint64_t cache_hits; /*!< Times tables were found in cache */
+    uint64_t cache_misses; /*!< Times tables were not found in cache */
+    uint64_t cache_evictions; /*!< Times tables in cache were replaced by other ones */
+    uint64_t crefs_hits; /*!< Times compressed references were read from the cache in \a crefs_dir */
+    uint64_t crefs_misses; /*!< Times compressed references were not in the cache and were parsed */
+    uint64_t timages_hits; /*!< Times tables were read from their image in \a timages_dir */
+    uint64_t timages_misses; /*!< Times tables were read from csv files, with no valid image */
+    uint64_t duplicates; /*!< Messages skipped because already seen, see \ref BUFRDECO_SKIP_DUPLICATES */
+};
+
+/*!
+ * \def BUFRDECO_OUTPUT_BUFFER_SIZE
+ * \brief Bytes of a struct \ref bufrdeco_output_buffer. When full it is written to its stream
+ */
+#define BUFRDECO_OUTPUT_BUFFER_SIZE (16384)
+
+/*!
+ * \struct bufrdeco_output_buffer
+ * \brief An append-only output buffer written to a stream in large blocks
+ *
+ * Texts are appended with the bufrdeco_out_* functions, which format numbers and json strings without printf(3).
+ * The data is written to \a out when the buffer is full or when calling \ref bufrdeco_out_flush, which must be
+ * called at the end.
+ */
+struct bufrdeco_output_buffer {
+    FILE* out; /*!< Stream where the data is written to */
+    size_t len; /*!< Bytes currently in buffer */
+    buf_t used; /*!< Total bytes appended since init */
+    int error; /*!< Set to 1 if a write to \a out failed */
+    char s[BUFRDECO_OUTPUT_BUFFER_SIZE]; /*!< The buffer */
+};
+
+/*!
+ * \def BUFRDECO_ENCODE_MASTER_VERSION
+ * \brief Default master table version for synthetic messages made by \ref bufrdeco_encode_synthetic
+ */
+#define BUFRDECO_ENCODE_MASTER_VERSION (45)
+
+/*!
+ * \struct bufrdeco_encode_value
+ * \brief A value coded by \ref bufrdeco_encode_synthetic, as it is expected to be decoded
+ */
+struct bufrdeco_encode_value {
+    double val; /*!< Expected value. MISSING_REAL if missing or if it is a string */
+    uint32_t hash; /*!< FNV-1a hash of the string for CCITT IA5 values, see \ref bufrdeco_encode_string_hash */
+    uint32_t mask; /*!< DESCRIPTOR_VALUE_MISSING or DESCRIPTOR_HAVE_STRING_VALUE bits */
+};
+
+/*!
+ * \struct bufrdeco_encode
+ * \brief Options to encode a synthetic BUFR message and the expected values after encoding it
+ */
+struct bufrdeco_encode {
+    uint8_t edition; /*!< BUFR edition, 3 or 4 */
+    uint8_t compressed; /*!< If != 0 then data is compressed */
+    uint8_t master_version; /*!< Version of master table */
+    uint8_t category; /*!< Data category in sec1 */
+    uint8_t subcategory; /*!< International data subcategory in sec1 */
+    uint8_t max_replications; /*!< Max value for a delayed replication factor */
+    uint8_t missing_percent; /*!< Percent of values set as missing */
+    uint16_t centre; /*!< Originating centre in sec1 */
+    uint16_t subcentre; /*!< Originating sub-centre in sec1 */
+    buf_t subsets; /*!< Number of subsets, up to \ref BUFR_MAX_SUBSETS */
+    time_t time; /*!< Time of message in sec1 */
+    uint64_t seed; /*!< State of pseudo-random generator. Updated on every call */
+    buf_t ndesc; /*!< Number of descriptors in sec3 */
+    struct bufr_descriptor unexpanded[BUFR_LEN_UNEXPANDED_DESCRIPTOR]; /*!< Descriptors in sec3, i.e. the template */
+    buf_t nv; /*!< Number of expected values in array \a value */
+    buf_t dim; /*!< Allocated dimension of array \a value */
+    buf_t first[BUFR_MAX_SUBSETS + 1]; /*!< Index in array \a value of first value of every subset, if not compressed */
+    struct bufrdeco_encode_value* value; /*!< Array of expected values. If compressed, values of all subsets for an element are consecutive */
+};
+
+/*!
+ * \def BUFRDECO_DEDUP_DEFAULT_SIZE
+ * \brief Default number of hashes remembered by a struct \ref bufrdeco_dedup
+ */
+#define BUFRDECO_DEDUP_DEFAULT_SIZE (65536)
+
+/*!
+ * \def BUFRDECO_DEDUP_MAGIC
+ * \brief First 8 bytes of a file with the hashes of a struct \ref bufrdeco_dedup
+ */
+#define BUFRDECO_DEDUP_MAGIC "BUFRDUP"
+
+/*!
+ * \struct bufrdeco_dedup
+ * \brief A bounded set with the hashes of the messages already seen
+ *
+ * The hashes are stored in two generations, every one an open addressing table. New hashes are added to the current
+ * generation. When it is full, the older one is cleaned and becomes the current. So the memory is fixed and the last
+ * \a max to 2 * \a max hashes are remembered
+ */
+struct bufrdeco_dedup {
+    buf_t dim; /*!< Slots in every generation, a power of two */
+    buf_t max; /*!< Hashes in a generation before changing to the other */
+    buf_t cur; /*!< Index of current generation */
+    buf_t nd[2]; /*!< Hashes in every generation */
+    uint64_t* slot[2]; /*!< Tables of every generation. 0 is a free slot */
+};
+
 /*!
   \struct bufrdeco
   \brief This struct contains all needed data to parse and decode a BUFR file
@@ -1093,15 +1619,21 @@ struct bufrdeco {
     struct bufrdeco_decoding_data_state state; /*!< Struct with data needed when parsing bufr */
     struct bufrdeco_subset_bit_offsets offsets; /*!< Struct \ref bufrdeco_subset_bit_offsets with bit offset of start point of every subset in non compressed bufr */
     struct bufrdeco_compressed_data_references refs; /*!< struct with data references in case of compressed bufr */
+    struct bufrdeco_compressed_columns cols; /*!< Values of all subsets in case of compressed bufr */
+    struct bufrdeco_ndjson_keys ndjson; /*!< Keys used when printing subsets as flat json objects */
+    struct bufrdeco_dedup dedup; /*!< Hashes of messages already seen, if bit \ref BUFRDECO_SKIP_DUPLICATES is set in mask */
     struct bufrdeco_decode_subset_bitacora bitacora; /*!< struct with the events log when decoding a subset data in sec4 */
     struct bufrdeco_subset_sequence_data seq; /*!< sequence with data subset after parse */
     struct bufrdeco_bitmap_array bitmap; /*!< Stores data for bit-maps */
     struct bufrdeco_bitmap_related_vars brv; /*!< Stores data related with the aid of a bit-maps */
     struct bufrdeco_associated_field_array assoc; /*!< Array with associated fields info used in a subset */
     char bufrtables_dir[BUFRDECO_PATH_LENGTH]; /*!< string with the path of bufr table directories */
+    char crefs_dir[BUFRDECO_PATH_LENGTH]; /*!< Directory of the cache of compressed references, ended with '/' */
+    char timages_dir[BUFRDECO_PATH_LENGTH]; /*!< Directory of the images of tables, ended with '/' */
     char error[1024]; /*!< String with detected errors, if any */
     FILE* out; /*!< Stream used for normal output. By default 'stdout' */
     FILE* err; /*!< Stream used for error output. By default 'stderr' */
+    struct bufrdeco_stats stats; /*!< Runtime statistics, if bit \ref BUFRDECO_COLLECT_STATS is set in mask */
 };
 
 extern const char DEFAULT_BUFRTABLES_ECMWF_DIR1[];
@@ -1129,12 +1661,90 @@ int bufrdeco_read_subset_offset_bits(struct bufrdeco* b, char* filename);
 int bufrdeco_write_subset_offset_bits(struct bufrdeco* b, const char* filename);
 int bufrdeco_read_subset_offset_bits_universal(struct bufrdeco* b, const char* filename);
 int bufrdeco_write_subset_offset_bits_be(struct bufrdeco* b, const char* filename);
+int bufrdeco_set_compressed_references_dir(struct bufrdeco* b, const char* dir);
+int bufrdeco_read_compressed_references(struct bufrdeco* b, const char* filename);
+int bufrdeco_write_compressed_references(struct bufrdeco* b, const char* filename);
+int bufrdeco_compressed_references_path(char* target, size_t dim, const struct bufrdeco* b);
+int bufrdeco_set_tables_images_dir(struct bufrdeco* b, const char* dir);
+int bufrdeco_tables_image_path(char* target, size_t dim, const struct bufrdeco* b);
+int bufrdeco_read_tables_image(struct bufrdeco* b, const char* filename);
+int bufrdeco_write_tables_image(struct bufrdeco* b, const char* filename);
+uint64_t bufrdeco_message_hash(const struct bufrdeco* b);
+
+// Skip of duplicated messages
+int bufrdeco_init_dedup(struct bufrdeco_dedup* d, buf_t size);
+int bufrdeco_free_dedup(struct bufrdeco_dedup* d);
+int bufrdeco_dedup_check(struct bufrdeco_dedup* d, uint64_t hash);
+int bufrdeco_read_dedup(struct bufrdeco_dedup* d, const char* filename);
+int bufrdeco_write_dedup(const struct bufrdeco_dedup* d, const char* filename);
+uint64_t bufrdeco_buffer_hash(const uint8_t* bufr, size_t size);
+
+// Runtime statistics
+uint64_t bufrdeco_stats_clock(const struct bufrdeco* b);
+int bufrdeco_stats_add(struct bufrdeco* b, enum bufrdeco_stats_phase phase, uint64_t start);
+int bufrdeco_clean_stats(struct bufrdeco* b);
+buf_t bufrdeco_print_json_stats(FILE* out, const struct bufrdeco* b);
+const char* bufrdeco_stats_phase_name(enum bufrdeco_stats_phase phase);
+
+// Archive index
+int bufrdeco_index_build(struct bufrdeco* b, const char* archive, const char* filename);
+int bufrdeco_index_open(struct bufrdeco_index* idx, const char* filename, const char* archive);
+int bufrdeco_index_close(struct bufrdeco_index* idx);
+int bufrdeco_index_find(const struct bufrdeco_index* idx, const char* ident, int64_t from, int64_t to, uint64_t* first, uint64_t* count);
+struct bufrdeco_subset_sequence_data* bufrdeco_index_get_subset(struct bufrdeco* b, const struct bufrdeco_index* idx, const struct bufrdeco_index_subset* s);
+uint32_t bufrdeco_index_template_hash(const struct bufr_sec3* s3);
+
+// Snapshots of decoded subsets
+int bufrdeco_snapshot_add_subset(struct bufrdeco_snapshot_builder* sb, const struct bufrdeco_subset_sequence_data* s);
+int bufrdeco_snapshot_write(const struct bufrdeco_snapshot_builder* sb, uint64_t hash, const char* filename);
+int bufrdeco_snapshot_clean(struct bufrdeco_snapshot_builder* sb);
+int bufrdeco_snapshot_free(struct bufrdeco_snapshot_builder* sb);
+int bufrdeco_snapshot_open(struct bufrdeco_snapshot* sn, const char* filename);
+int bufrdeco_snapshot_close(struct bufrdeco_snapshot* sn);
+struct bufrdeco_subset_sequence_data* bufrdeco_snapshot_get_subset(const struct bufrdeco_snapshot* sn, buf_t subset,
+    struct bufrdeco_subset_sequence_data* s);
+
+// Columnar export in Arrow IPC streaming format
+int bufrdeco_arrow_init(struct bufrdeco_arrow_writer* w, FILE* out);
+int bufrdeco_arrow_add_columns(struct bufrdeco_arrow_writer* w, const char* list);
+int bufrdeco_arrow_add_subset(struct bufrdeco_arrow_writer* w, const struct bufrdeco_subset_sequence_data* s);
+int bufrdeco_arrow_add_bufr(struct bufrdeco_arrow_writer* w, struct bufrdeco* b);
+int bufrdeco_arrow_flush(struct bufrdeco_arrow_writer* w);
+int bufrdeco_arrow_close(struct bufrdeco_arrow_writer* w);
+
+// Output buffer and fast formatters
+int bufrdeco_out_init(struct bufrdeco_output_buffer* ob, FILE* out);
+int bufrdeco_out_flush(struct bufrdeco_output_buffer* ob);
+buf_t bufrdeco_out_write(struct bufrdeco_output_buffer* ob, const char* data, size_t len);
+buf_t bufrdeco_out_puts(struct bufrdeco_output_buffer* ob, const char* str);
+buf_t bufrdeco_out_putc(struct bufrdeco_output_buffer* ob, char c);
+buf_t bufrdeco_out_uint(struct bufrdeco_output_buffer* ob, uint64_t u, int width);
+buf_t bufrdeco_out_int(struct bufrdeco_output_buffer* ob, int64_t i);
+buf_t bufrdeco_out_hex(struct bufrdeco_output_buffer* ob, uint64_t u, int width);
+buf_t bufrdeco_out_fixed(struct bufrdeco_output_buffer* ob, double val, int decimals);
+buf_t bufrdeco_out_json_string(struct bufrdeco_output_buffer* ob, const char* source);
+buf_t bufrdeco_out_printf(struct bufrdeco_output_buffer* ob, const char* format, ...);
+size_t bufrdeco_format_uint(char* target, size_t dim, uint64_t u, int width);
+size_t bufrdeco_format_fixed(char* target, size_t dim, double val, int decimals);
+
+// Synthetic encoder
+int bufrdeco_init_encode(struct bufrdeco_encode* e);
+int bufrdeco_free_encode(struct bufrdeco_encode* e);
+int bufrdeco_encode_synthetic(struct bufrdeco* b, struct bufrdeco_encode* e, uint8_t* target, buf_t dim, buf_t* size);
+const struct bufrdeco_encode_value* bufrdeco_encode_get_value(const struct bufrdeco_encode* e, buf_t subset, buf_t index);
+buf_t bufrdeco_encode_values_in_subset(const struct bufrdeco_encode* e, buf_t subset);
+uint32_t bufrdeco_encode_string_hash(const char* s);
 
 // Memory funcions
 int bufrdeco_init_expanded_tree(struct bufrdeco_expanded_tree** t);
 int bufrdeco_free_expanded_tree(struct bufrdeco_expanded_tree** t);
 int bufrdeco_init_tables(struct bufr_tables** t);
 int bufrdeco_free_tables(struct bufr_tables** t);
+int bufrdeco_clean_tables(struct bufr_tables* t);
+int bufrdeco_strings_add(uint32_t* ofs, struct bufr_strings* p, const char* str);
+int bufrdeco_strings_reserve(struct bufr_strings* p, uint32_t size);
+int bufrdeco_clean_strings(struct bufr_strings* p);
+int bufrdeco_free_strings(struct bufr_strings* p);
 int bufrdeco_substitute_tables(struct bufr_tables** replaced, struct bufr_tables* source, struct bufrdeco* b);
 int bufrdeco_init_subset_sequence_data(struct bufrdeco_subset_sequence_data* ba);
 int bufrdeco_clean_subset_sequence_data(struct bufrdeco_subset_sequence_data* ba);
@@ -1144,9 +1754,13 @@ int bufrdeco_increase_subset_sequence_data_count(struct bufrdeco_subset_sequence
 int bufrdeco_free_compressed_data_references(struct bufrdeco_compressed_data_references* rf);
 int bufrdeco_init_compressed_data_references(struct bufrdeco_compressed_data_references* rf);
 int bufrdeco_increase_compressed_ref_array(struct bufrdeco_compressed_data_references* r);
+int bufrdeco_free_compressed_columns(struct bufrdeco_compressed_columns* c);
+int bufrdeco_free_ndjson_keys(struct bufrdeco_ndjson_keys* k);
 int bufrdeco_increase_data_array(struct bufrdeco_subset_sequence_data* s);
-int bufrdeco_store_tables(struct bufr_tables** t, struct bufr_tables_cache* c, uint8_t ver, uint8_t local_ver, uint8_t centre, uint8_t subcentre);
-int bufrdeco_cache_tables_search(const struct bufr_tables_cache* c, uint8_t ver, uint8_t local_ver, uint8_t centre, uint8_t subcentre);
+int bufrdeco_store_tables(struct bufr_tables** t, struct bufr_tables_cache* c, uint8_t ver, uint8_t local_ver, uint16_t centre, uint16_t subcentre);
+int bufrdeco_cache_tables_search(const struct bufr_tables_cache* c, uint8_t ver, uint8_t local_ver, uint16_t centre, uint16_t subcentre);
+int bufrdeco_cache_tables_lru(const struct bufr_tables_cache* c);
+int bufrdeco_preload_tables(struct bufrdeco* b, buf_t max);
 int bufrdeco_free_cache_tables(struct bufr_tables_cache* c);
 int bufrdeco_add_event_to_bitacora(struct bufrdeco* b, const struct bufrdeco_decode_subset_event* event);
 int bufrdeco_init_subset_bitacora(struct bufrdeco* b);
@@ -1162,10 +1776,13 @@ int bufrdeco_extract_bufr(struct bufrdeco* b, char* filename, const char* bufr_x
 int bufrdeco_read_buffer(struct bufrdeco* b, uint8_t* bufrx, buf_t size);
 int bufrdeco_fast_read_sec_0_1_3(struct bufr_sec0* s0, struct bufr_sec1* s1, struct bufr_sec3 *s3, char* filename, char* error, size_t error_size);
 int bufrdeco_get_sec_0_1_3_from_buffer(struct bufr_sec0* s0, struct bufr_sec1* s1, struct bufr_sec3 *s3, const uint8_t* buff, size_t size, char* error, size_t error_size);
+size_t bufrdeco_sec_0_1_3_length(const uint8_t* buff, size_t size);
 
 
 // Read bufr WMO csv table files
 int get_wmo_tablenames(struct bufrdeco* b);
+uint8_t get_wmo_tables_version(uint8_t ver, int* revision, int* minor);
+void bufrdeco_get_tables_key(const struct bufrdeco* b, uint8_t* ver, uint8_t* local_ver, uint16_t* centre, uint16_t* subcentre);
 int bufr_read_tableB(struct bufrdeco* b);
 int bufr_read_tableC(struct bufrdeco* b);
 int bufr_read_tableD(struct bufrdeco* b);
@@ -1225,6 +1842,9 @@ int bufrdeco_tableB_compressed(struct bufrdeco_compressed_ref* r, struct bufrdec
 int bufrdeco_get_atom_data_from_compressed_data_ref(struct bufr_atom_data* a, struct bufrdeco_compressed_ref* r,
     buf_t subset, struct bufrdeco* b);
 int bufrdeco_increase_compressed_data_references_count(struct bufrdeco_compressed_data_references* r, struct bufrdeco* b);
+int bufrdeco_decode_compressed_columns(struct bufrdeco* b);
+int bufrdeco_get_atom_data_from_compressed_column(struct bufr_atom_data* a, struct bufrdeco_compressed_ref* r,
+    buf_t iref, buf_t subset, struct bufrdeco* b);
 
 // To get parsed data
 struct bufrdeco_subset_sequence_data* bufrdeco_get_subset_sequence_data(struct bufrdeco* b);
@@ -1248,6 +1868,21 @@ buf_t bufrdeco_print_json_separator(FILE* out);
 buf_t bufrdeco_print_json_scape_string_cvals(FILE* out, const char* source);
 buf_t bufrdeco_print_json_subset_data_epilogue(FILE* out);
 buf_t bufrdeco_print_json_subset_data(struct bufrdeco* b);
+buf_t bufrdeco_out_json_sec0(struct bufrdeco_output_buffer* ob, const struct bufrdeco* b);
+buf_t bufrdeco_out_json_sec1(struct bufrdeco_output_buffer* ob, const struct bufrdeco* b);
+buf_t bufrdeco_out_json_sec2(struct bufrdeco_output_buffer* ob, const struct bufrdeco* b);
+buf_t bufrdeco_out_json_sec3(struct bufrdeco_output_buffer* ob, const struct bufrdeco* b);
+buf_t bufrdeco_out_json_tree_recursive(struct bufrdeco_output_buffer* ob, struct bufrdeco* b, struct bufr_sequence* seq);
+buf_t bufrdeco_out_json_subset_data_prologue(struct bufrdeco_output_buffer* ob, const struct bufrdeco* b);
+buf_t bufrdeco_out_json_object_atom_data(struct bufrdeco_output_buffer* ob, struct bufr_atom_data* a, buf_t index_data, const struct bufrdeco* b, const char* add);
+buf_t bufrdeco_out_json_object_operator_descriptor(struct bufrdeco_output_buffer* ob, const struct bufr_descriptor* d, const char* add);
+buf_t bufrdeco_out_json_object_replicator_descriptor(struct bufrdeco_output_buffer* ob, const struct bufr_descriptor* d, const char* add);
+buf_t bufrdeco_out_json_object_event_data(struct bufrdeco_output_buffer* ob, struct bufr_atom_data* a, const struct bufrdeco_decode_subset_event* event, struct bufrdeco* b, const char* add);
+buf_t bufrdeco_out_json_sequence_descriptor_header(struct bufrdeco_output_buffer* ob, const struct bufr_sequence* seq);
+buf_t bufrdeco_out_json_subset_data(struct bufrdeco_output_buffer* ob, struct bufrdeco* b);
+int bufrdeco_ndjson_keys_update(struct bufrdeco_ndjson_keys* k, const struct bufrdeco_subset_sequence_data* s);
+buf_t bufrdeco_out_ndjson_subset_data(struct bufrdeco_output_buffer* ob, struct bufrdeco* b);
+buf_t bufrdeco_print_ndjson_subset_data(struct bufrdeco* b);
 
 // Functions to get bits of data
 uint32_t two_bytes_to_uint32(const uint8_t* source);
@@ -0,0 +1,954 @@
+/***************************************************************************
+ *   Copyright (C) 2013-2026 by Guillermo Ballester Valor                  *
+ *   gbv@ogimet.com                                                        *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.             *
+ ***************************************************************************/
+/*!
+ \file bufrdeco_arrow.c
+ \brief This file has the code to export decoded subsets as columns in Apache Arrow IPC streaming format
+
+ The stream is a sequence of encapsulated messages: a 0xFFFFFFFF mark, the length of metadata, the metadata as a
+ flatbuffer (Message.fbs and Schema.fbs of Arrow format, version 5) and the body with the buffers of columns. The
+ first message is the schema, then a record batch for every \ref BUFRDECO_ARROW_BATCH_ROWS rows, and finally an end
+ of stream mark. The flatbuffers are built here with the few tables needed, so there is no external dependency.
+
+ For compressed BUFR the values of numeric columns are copied from the columns of all subsets already got by
+ \ref bufrdeco_decode_compressed_columns, so the subsets are not decoded one by one
+*/
+#include "bufrdeco.h"
+
+/*!
+  \def ARROW_METADATA_V5
+  \brief Value of MetadataVersion V5 in Arrow format
+*/
+#define ARROW_METADATA_V5 (4)
+
+/*!
+  \def ARROW_HEADER_SCHEMA
+  \brief Value of MessageHeader for a Schema
+*/
+#define ARROW_HEADER_SCHEMA (1)
+
+/*!
+  \def ARROW_HEADER_RECORD_BATCH
+  \brief Value of MessageHeader for a RecordBatch
+*/
+#define ARROW_HEADER_RECORD_BATCH (3)
+
+/*!
+  \def ARROW_TYPE_INT
+  \brief Value of Type for Int
+*/
+#define ARROW_TYPE_INT (2)
+
+/*!
+  \def ARROW_TYPE_FLOATING_POINT
+  \brief Value of Type for FloatingPoint
+*/
+#define ARROW_TYPE_FLOATING_POINT (3)
+
+/*!
+  \def ARROW_TYPE_UTF8
+  \brief Value of Type for Utf8
+*/
+#define ARROW_TYPE_UTF8 (5)
+
+/*!
+  \def ARROW_PRECISION_DOUBLE
+  \brief Value of Precision for a double
+*/
+#define ARROW_PRECISION_DOUBLE (2)
+
+/*!
+  \def ARROW_PAD8
+  \brief Length rounded up to a multiple of 8, as needed for every buffer in body
+*/
+#define ARROW_PAD8(n) (((n) + 7) & ~((size_t)7))
+
+/*!
+  \fn static uint16_t arrow_desc16(const struct bufr_descriptor* d)
+  \brief A descriptor as (f << 14) | (x << 8) | y
+*/
+static uint16_t arrow_desc16(const struct bufr_descriptor* d)
+{
+    return (uint16_t)(((d->f & 0x03) << 14) | ((d->x & 0x3F) << 8) | d->y);
+}
+
+/*!
+  \fn static int arrow_host_is_big_endian(void)
+  \brief Returns 1 if values in memory are big endian, 0 otherwise
+*/
+static int arrow_host_is_big_endian(void)
+{
+    const uint16_t one = 1;
+
+    return *(const uint8_t*)&one == 0;
+}
+
+/*!
+  \fn static int arrow_fb_start(struct bufrdeco_arrow_writer* w)
+  \brief Prepare the scratch buffer to build the flatbuffer of a message, with room for the offset of root table
+*/
+static int arrow_fb_start(struct bufrdeco_arrow_writer* w)
+{
+    size_t need;
+    void* p;
+
+    // Generous bound for the schema or the record batch of ncols columns
+    need = 512 + (size_t)w->ncols * 192;
+    if (w->dfb < need) {
+        if ((p = realloc(w->fb, need)) == NULL)
+            return 1;
+        w->fb = (uint8_t*)p;
+        w->dfb = need;
+    }
+    memset(w->fb, 0, need);
+    w->lfb = 4;
+    return 0;
+}
+
+/*!
+  \fn static void arrow_fb_pad(struct bufrdeco_arrow_writer* w, size_t align, size_t rem)
+  \brief Append zeros to flatbuffer until its length modulo \a align is \a rem
+*/
+static void arrow_fb_pad(struct bufrdeco_arrow_writer* w, size_t align, size_t rem)
+{
+    while (w->lfb % align != rem)
+        w->lfb++;
+}
+
+/*!
+  \fn static void arrow_fb_put(struct bufrdeco_arrow_writer* w, size_t pos, uint64_t v, size_t n)
+  \brief Set a scalar of \a n bytes at \a pos of flatbuffer. Flatbuffers are always little endian
+*/
+static void arrow_fb_put(struct bufrdeco_arrow_writer* w, size_t pos, uint64_t v, size_t n)
+{
+    size_t i;
+
+    for (i = 0; i < n; i++)
+        w->fb[pos + i] = (uint8_t)(v >> (8 * i));
+}
+
+/*!
+  \fn static void arrow_fb_link(struct bufrdeco_arrow_writer* w, size_t pos, size_t target)
+  \brief Set the offset at \a pos to point to \a target, which must be after \a pos
+*/
+static void arrow_fb_link(struct bufrdeco_arrow_writer* w, size_t pos, size_t target)
+{
+    arrow_fb_put(w, pos, target - pos, 4);
+}
+
+/*!
+  \fn static size_t arrow_fb_table(struct bufrdeco_arrow_writer* w, buf_t nfields, const uint8_t* size, size_t* pos)
+  \brief Append a table with its vtable to flatbuffer
+  \param [in,out] w pointer to the writer
+  \param [in] nfields number of fields in schema of table
+  \param [in] size bytes of every field, 0 if absent
+  \param [out] pos position in flatbuffer of every present field, to be set by caller
+  \return the position of table
+*/
+static size_t arrow_fb_table(struct bufrdeco_arrow_writer* w, buf_t nfields, const uint8_t* size, size_t* pos)
+{
+    size_t vt, t, o, ofs[8];
+    buf_t i, s;
+
+    // Fields are set from the largest, so all are aligned if the table begins at 4 modulo 8, after its vtable offset
+    o = 4;
+    for (s = 8; s > 0; s >>= 1) {
+        for (i = 0; i < nfields; i++) {
+            if (size[i] == s) {
+                ofs[i] = o;
+                o += s;
+            }
+        }
+    }
+
+    arrow_fb_pad(w, 2, 0);
+    vt = w->lfb;
+    arrow_fb_put(w, vt, 4 + 2 * nfields, 2);
+    arrow_fb_put(w, vt + 2, o, 2);
+    for (i = 0; i < nfields; i++)
+        arrow_fb_put(w, vt + 4 + 2 * i, size[i] ? ofs[i] : 0, 2);
+    w->lfb += 4 + 2 * nfields;
+
+    arrow_fb_pad(w, 8, 4);
+    t = w->lfb;
+    arrow_fb_put(w, t, t - vt, 4);
+    for (i = 0; i < nfields; i++)
+        pos[i] = size[i] ? t + ofs[i] : 0;
+    w->lfb += o;
+    return t;
+}
+
+/*!
+  \fn static size_t arrow_fb_string(struct bufrdeco_arrow_writer* w, const char* s)
+  \brief Append a string to flatbuffer and return its position
+*/
+static size_t arrow_fb_string(struct bufrdeco_arrow_writer* w, const char* s)
+{
+    size_t p, n = strlen(s);
+
+    arrow_fb_pad(w, 4, 0);
+    p = w->lfb;
+    arrow_fb_put(w, p, n, 4);
+    memcpy(w->fb + p + 4, s, n);
+    w->lfb += 4 + n + 1;
+    return p;
+}
+
+/*!
+  \fn static size_t arrow_fb_vector(struct bufrdeco_arrow_writer* w, buf_t n, size_t elem, size_t align)
+  \brief Append a vector of \a n elements of \a elem bytes, aligned to \a align, and return its position
+
+  The elements begin 4 bytes after the returned position
+*/
+static size_t arrow_fb_vector(struct bufrdeco_arrow_writer* w, buf_t n, size_t elem, size_t align)
+{
+    size_t p;
+
+    arrow_fb_pad(w, align, align == 8 ? 4 : 0);
+    p = w->lfb;
+    arrow_fb_put(w, p, n, 4);
+    w->lfb += 4 + (size_t)n * elem;
+    return p;
+}
+
+/*!
+  \fn static int arrow_write_message(struct bufrdeco_arrow_writer* w)
+  \brief Write the flatbuffer in scratch buffer as the metadata of an encapsulated message
+*/
+static int arrow_write_message(struct bufrdeco_arrow_writer* w)
+{
+    uint8_t prefix[8] = { 0xFF, 0xFF, 0xFF, 0xFF, 0, 0, 0, 0 };
+    size_t i;
+
+    // The body that follows must begin at a multiple of 8
+    arrow_fb_pad(w, 8, 0);
+    for (i = 0; i < 4; i++)
+        prefix[4 + i] = (uint8_t)(w->lfb >> (8 * i));
+    if (fwrite(prefix, 1, 8, w->out) != 8 || fwrite(w->fb, 1, w->lfb, w->out) != w->lfb)
+        return 1;
+    return 0;
+}
+
+/*!
+  \fn static int arrow_write_buffer(struct bufrdeco_arrow_writer* w, const void* p, size_t n)
+  \brief Write a buffer of body padded with zeros to a multiple of 8 bytes
+*/
+static int arrow_write_buffer(struct bufrdeco_arrow_writer* w, const void* p, size_t n)
+{
+    static const uint8_t zeros[8] = { 0 };
+
+    if (n && fwrite(p, 1, n, w->out) != n)
+        return 1;
+    if (ARROW_PAD8(n) > n && fwrite(zeros, 1, ARROW_PAD8(n) - n, w->out) != ARROW_PAD8(n) - n)
+        return 1;
+    return 0;
+}
+
+/*!
+  \fn static buf_t arrow_column_buffers(const struct bufrdeco_arrow_column* c, buf_t nrows, const void** p, size_t* len)
+  \brief Get the buffers of a column for a batch of \a nrows, as stated for its type in Arrow columnar format
+  \return the number of buffers
+*/
+static buf_t arrow_column_buffers(const struct bufrdeco_arrow_column* c, buf_t nrows, const void** p, size_t* len)
+{
+    // A validity bitmap is not needed if there are no nulls
+    p[0] = c->valid;
+    len[0] = c->nulls ? ((size_t)nrows + 7) / 8 : 0;
+    p[1] = c->data;
+    switch (c->type) {
+    case BUFRDECO_ARROW_INT32:
+        len[1] = (size_t)nrows * sizeof(int32_t);
+        return 2;
+    case BUFRDECO_ARROW_UTF8:
+        len[1] = ((size_t)nrows + 1) * sizeof(int32_t);
+        p[2] = c->str;
+        len[2] = c->lstr;
+        return 3;
+    default:
+        len[1] = (size_t)nrows * sizeof(double);
+        return 2;
+    }
+}
+
+/*!
+  \fn static void arrow_column_set_type(struct bufrdeco_arrow_column* c, uint8_t type)
+  \brief Set the type of a column, with the rows already filled as nulls
+*/
+static void arrow_column_set_type(struct bufrdeco_arrow_column* c, uint8_t type)
+{
+    c->type = type;
+    if (c->data == NULL)
+        return;
+    if (type == BUFRDECO_ARROW_UTF8)
+        memset(c->data, 0, ((size_t)c->filled + 1) * sizeof(int32_t));
+    else
+        memset(c->data, 0, (size_t)c->filled * sizeof(double));
+}
+
+/*!
+  \fn static void arrow_append_null(struct bufrdeco_arrow_column* c)
+  \brief Append a null to a column
+*/
+static void arrow_append_null(struct bufrdeco_arrow_column* c)
+{
+    if (c->type == BUFRDECO_ARROW_FLOAT64)
+        ((double*)c->data)[c->filled] = 0.0;
+    else if (c->type == BUFRDECO_ARROW_UTF8)
+        ((int32_t*)c->data)[c->filled + 1] = (int32_t)c->lstr;
+    c->nulls++;
+    c->filled++;
+}
+
+/*!
+  \fn static void arrow_append_int32(struct bufrdeco_arrow_column* c, int32_t v)
+  \brief Append an integer to a column of type \ref BUFRDECO_ARROW_INT32
+*/
+static void arrow_append_int32(struct bufrdeco_arrow_column* c, int32_t v)
+{
+    c->valid[c->filled >> 3] |= (uint8_t)(1U << (c->filled & 7));
+    ((int32_t*)c->data)[c->filled++] = v;
+}
+
+/*!
+  \fn static void arrow_append_double(struct bufrdeco_arrow_column* c, double v)
+  \brief Append a value to a column of type \ref BUFRDECO_ARROW_FLOAT64, as null if it is \ref MISSING_REAL
+*/
+static void arrow_append_double(struct bufrdeco_arrow_column* c, double v)
+{
+    if (v == MISSING_REAL) {
+        arrow_append_null(c);
+        return;
+    }
+    c->valid[c->filled >> 3] |= (uint8_t)(1U << (c->filled & 7));
+    ((double*)c->data)[c->filled++] = v;
+}
+
+/*!
+  \fn static int arrow_append_string(struct bufrdeco_arrow_column* c, const char* s)
+  \brief Append a string to a column of type \ref BUFRDECO_ARROW_UTF8
+*/
+static int arrow_append_string(struct bufrdeco_arrow_column* c, const char* s)
+{
+    size_t n = strlen(s), dim;
+    void* p;
+
+    if (c->lstr + n > INT32_MAX) {
+        arrow_append_null(c);
+        return 0;
+    }
+    if (c->lstr + n > c->dstr) {
+        for (dim = c->dstr ? 2 * c->dstr : 4096; dim < c->lstr + n; dim *= 2)
+            ;
+        if ((p = realloc(c->str, dim)) == NULL)
+            return 1;
+        c->str = (char*)p;
+        c->dstr = dim;
+    }
+    memcpy(c->str + c->lstr, s, n);
+    c->lstr += n;
+    c->valid[c->filled >> 3] |= (uint8_t)(1U << (c->filled & 7));
+    ((int32_t*)c->data)[++c->filled] = (int32_t)c->lstr;
+    return 0;
+}
+
+/*!
+  \fn static void arrow_column_resolve(struct bufrdeco_arrow_column* c, const struct bufr_atom_data* a)
+  \brief Set the type of a column not known yet from the unit of a data
+*/
+static void arrow_column_resolve(struct bufrdeco_arrow_column* c, const struct bufr_atom_data* a)
+{
+    if (c->type == BUFRDECO_ARROW_UNKNOWN)
+        arrow_column_set_type(c, strstr(a->unit, "CCITT") != NULL ? BUFRDECO_ARROW_UTF8 : BUFRDECO_ARROW_FLOAT64);
+}
+
+/*!
+  \fn static int arrow_append_atom(struct bufrdeco_arrow_column* c, const struct bufr_atom_data* a)
+  \brief Append the value of a data to a column. A string for a numeric column or a number for a string column is null
+*/
+static int arrow_append_atom(struct bufrdeco_arrow_column* c, const struct bufr_atom_data* a)
+{
+    arrow_column_resolve(c, a);
+
+    if (a->mask & DESCRIPTOR_VALUE_MISSING)
+        arrow_append_null(c);
+    else if (c->type == BUFRDECO_ARROW_UTF8) {
+        if (a->mask & DESCRIPTOR_HAVE_STRING_VALUE)
+            return arrow_append_string(c, a->cval);
+        arrow_append_null(c);
+    } else if (a->mask & DESCRIPTOR_HAVE_STRING_VALUE)
+        arrow_append_null(c);
+    else
+        arrow_append_double(c, a->val);
+    return 0;
+}
+
+/*!
+  \fn static int arrow_column_alloc(struct bufrdeco_arrow_column* c, buf_t old, buf_t dim)
+  \brief Grow the buffers of a column from \a old to \a dim rows
+*/
+static int arrow_column_alloc(struct bufrdeco_arrow_column* c, buf_t old, buf_t dim)
+{
+    void* p;
+
+    if ((p = realloc(c->valid, ((size_t)dim + 7) / 8)) == NULL)
+        return 1;
+    c->valid = (uint8_t*)p;
+    memset(c->valid + ((size_t)old + 7) / 8, 0, ((size_t)dim + 7) / 8 - ((size_t)old + 7) / 8);
+
+    // Room for doubles or for the nrows + 1 offsets of strings
+    if ((p = realloc(c->data, ((size_t)dim + 1) * sizeof(double))) == NULL)
+        return 1;
+    c->data = (uint8_t*)p;
+    if (old == 0)
+        memset(c->data, 0, sizeof(double));
+    return 0;
+}
+
+/*!
+  \fn static int arrow_reserve(struct bufrdeco_arrow_writer* w, buf_t n)
+  \brief Grow the columns of a writer, if needed, to add \a n rows to current batch
+*/
+static int arrow_reserve(struct bufrdeco_arrow_writer* w, buf_t n)
+{
+    buf_t dim, i;
+
+    if (w->nrows + n <= w->drows)
+        return 0;
+
+    for (dim = w->drows ? 2 * w->drows : 1024; dim < w->nrows + n; dim *= 2)
+        ;
+    for (i = 0; i < w->ncols; i++) {
+        if (arrow_column_alloc(&w->col[i], w->drows, dim))
+            return 1;
+    }
+    w->drows = dim;
+    return 0;
+}
+
+/*!
+  \fn static int arrow_add_column(struct bufrdeco_arrow_writer* w, const char* name, const char* key, buf_t occurrence, uint8_t type)
+  \brief Add a column to a writer
+  \param [in,out] w pointer to the writer
+  \param [in] name name of column
+  \param [in] key descriptor as 'FXXYYY', or empty for a column not from data
+  \param [in] occurrence occurrence of descriptor in subset, first is 1
+  \param [in] type a \ref bufrdeco_arrow_type
+  \return 0 if succeeded, 1 otherwise
+*/
+static int arrow_add_column(struct bufrdeco_arrow_writer* w, const char* name, const char* key, buf_t occurrence,
+    uint8_t type)
+{
+    struct bufrdeco_arrow_column* c;
+    struct bufr_descriptor d;
+    buf_t* link;
+    void* p;
+
+    if (w->schema_written || w->nrows)
+        return 1;
+
+    if (w->ncols == w->dcols) {
+        if ((p = realloc(w->col, (w->dcols ? 2 * w->dcols : 64) * sizeof(struct bufrdeco_arrow_column))) == NULL)
+            return 1;
+        w->col = (struct bufrdeco_arrow_column*)p;
+        w->dcols = w->dcols ? 2 * w->dcols : 64;
+    }
+
+    c = &w->col[w->ncols];
+    memset(c, 0, sizeof(struct bufrdeco_arrow_column));
+    snprintf(c->name, sizeof(c->name), "%s", name);
+    snprintf(c->key, sizeof(c->key), "%s", key);
+    c->occurrence = occurrence;
+    c->type = type;
+    if (w->drows && arrow_column_alloc(c, 0, w->drows)) {
+        free(c->valid);
+        free(c->data);
+        return 1;
+    }
+
+    // Columns of the same descriptor are linked, in the order they were added
+    if (key[0]) {
+        uint32_t_to_descriptor(&d, (uint32_t)strtoul(key, NULL, 10));
+        c->desc = arrow_desc16(&d);
+        for (link = &w->first[c->desc]; *link; link = &w->col[*link - 1].next)
+            ;
+        *link = w->ncols + 1;
+    }
+    w->ncols++;
+    return 0;
+}
+
+/*!
+  \fn static int arrow_default_columns(struct bufrdeco_arrow_writer* w, const struct bufrdeco_subset_sequence_data* s)
+  \brief Add a column for every data of a subset if no descriptor column was added before the first subset
+*/
+static int arrow_default_columns(struct bufrdeco_arrow_writer* w, const struct bufrdeco_subset_sequence_data* s)
+{
+    const struct bufr_descriptor* d;
+    char name[BUFRDECO_ARROW_NAME_LENGTH];
+    buf_t i, n;
+    uint16_t k;
+    int res = 0;
+
+    if (w->ncols > 2 || w->schema_written || w->nrows)
+        return 0;
+
+    for (i = 0; i < s->nd && res == 0; i++) {
+        d = &s->sequence[i].desc;
+        k = arrow_desc16(d);
+        if ((n = ++w->count[k]) > 1)
+            snprintf(name, sizeof(name), "%s_%u", d->c, n);
+        else
+            snprintf(name, sizeof(name), "%s", d->c);
+        res = arrow_add_column(w, name, d->c, n, BUFRDECO_ARROW_UNKNOWN);
+    }
+    for (i = 0; i < s->nd; i++)
+        w->count[arrow_desc16(&s->sequence[i].desc)] = 0;
+    return res;
+}
+
+/*!
+  \fn static void arrow_map_subset(struct bufrdeco_arrow_writer* w, const struct bufrdeco_subset_sequence_data* s)
+  \brief Set the index plus one of the data of a subset for every descriptor column, 0 if not in subset
+*/
+static void arrow_map_subset(struct bufrdeco_arrow_writer* w, const struct bufrdeco_subset_sequence_data* s)
+{
+    buf_t i, j, n;
+    uint16_t k;
+
+    for (j = 0; j < w->ncols; j++)
+        w->col[j].iatom = 0;
+
+    for (i = 0; i < s->nd; i++) {
+        k = arrow_desc16(&s->sequence[i].desc);
+        n = ++w->count[k];
+        for (j = w->first[k]; j; j = w->col[j - 1].next) {
+            if (w->col[j - 1].occurrence == n)
+                w->col[j - 1].iatom = i + 1;
+        }
+    }
+    for (i = 0; i < s->nd; i++)
+        w->count[arrow_desc16(&s->sequence[i].desc)] = 0;
+}
+
+/*!
+  \fn static int arrow_write_schema(struct bufrdeco_arrow_writer* w)
+  \brief Write the schema message, with a nullable field for every column
+*/
+static int arrow_write_schema(struct bufrdeco_arrow_writer* w)
+{
+    static const uint8_t message_size[4] = { 2, 1, 4, 8 }; // version, header_type, header, bodyLength
+    static const uint8_t schema_size[2] = { 2, 4 }; // endianness, fields
+    static const uint8_t field_size[6] = { 4, 1, 1, 4, 0, 4 }; // name, nullable, type_type, type, dictionary, children
+    static const uint8_t int_size[2] = { 4, 1 }; // bitWidth, is_signed
+    static const uint8_t float_size[1] = { 2 }; // precision
+    size_t mpos[4], spos[2], fpos[6], tpos[2], v, t;
+    buf_t i;
+
+    if (arrow_fb_start(w))
+        return 1;
+
+    t = arrow_fb_table(w, 4, message_size, mpos);
+    arrow_fb_link(w, 0, t);
+    arrow_fb_put(w, mpos[0], ARROW_METADATA_V5, 2);
+    arrow_fb_put(w, mpos[1], ARROW_HEADER_SCHEMA, 1);
+    arrow_fb_put(w, mpos[3], 0, 8);
+
+    t = arrow_fb_table(w, 2, schema_size, spos);
+    arrow_fb_link(w, mpos[2], t);
+    arrow_fb_put(w, spos[0], arrow_host_is_big_endian(), 2);
+    v = arrow_fb_vector(w, w->ncols, 4, 4);
+    arrow_fb_link(w, spos[1], v);
+
+    for (i = 0; i < w->ncols; i++) {
+        t = arrow_fb_table(w, 6, field_size, fpos);
+        arrow_fb_link(w, v + 4 + 4 * (size_t)i, t);
+        arrow_fb_put(w, fpos[1], 1, 1);
+        arrow_fb_link(w, fpos[0], arrow_fb_string(w, w->col[i].name));
+
+        switch (w->col[i].type) {
+        case BUFRDECO_ARROW_INT32:
+            arrow_fb_put(w, fpos[2], ARROW_TYPE_INT, 1);
+            t = arrow_fb_table(w, 2, int_size, tpos);
+            arrow_fb_put(w, tpos[0], 32, 4);
+            arrow_fb_put(w, tpos[1], 1, 1);
+            break;
+        case BUFRDECO_ARROW_UTF8:
+            arrow_fb_put(w, fpos[2], ARROW_TYPE_UTF8, 1);
+            t = arrow_fb_table(w, 0, NULL, tpos);
+            break;
+        default:
+            arrow_fb_put(w, fpos[2], ARROW_TYPE_FLOATING_POINT, 1);
+            t = arrow_fb_table(w, 1, float_size, tpos);
+            arrow_fb_put(w, tpos[0], ARROW_PRECISION_DOUBLE, 2);
+            break;
+        }
+        arrow_fb_link(w, fpos[3], t);
+        arrow_fb_link(w, fpos[5], arrow_fb_vector(w, 0, 4, 4));
+    }
+    return arrow_write_message(w);
+}
+
+/*!
+  \fn static int arrow_write_batch(struct bufrdeco_arrow_writer* w)
+  \brief Write the rows of current batch as a record batch message
+*/
+static int arrow_write_batch(struct bufrdeco_arrow_writer* w)
+{
+    static const uint8_t message_size[4] = { 2, 1, 4, 8 }; // version, header_type, header, bodyLength
+    static const uint8_t batch_size[3] = { 8, 4, 4 }; // length, nodes, buffers
+    size_t mpos[4], rpos[3], nodes, bufs, t, body, len[3];
+    const void* p[3];
+    buf_t i, j, n, nb;
+
+    for (i = 0, nb = 0; i < w->ncols; i++)
+        nb += arrow_column_buffers(&w->col[i], w->nrows, p, len);
+
+    if (arrow_fb_start(w))
+        return 1;
+
+    t = arrow_fb_table(w, 4, message_size, mpos);
+    arrow_fb_link(w, 0, t);
+    arrow_fb_put(w, mpos[0], ARROW_METADATA_V5, 2);
+    arrow_fb_put(w, mpos[1], ARROW_HEADER_RECORD_BATCH, 1);
+
+    t = arrow_fb_table(w, 3, batch_size, rpos);
+    arrow_fb_link(w, mpos[2], t);
+    arrow_fb_put(w, rpos[0], w->nrows, 8);
+    nodes = arrow_fb_vector(w, w->ncols, 16, 8);
+    arrow_fb_link(w, rpos[1], nodes);
+    bufs = arrow_fb_vector(w, nb, 16, 8);
+    arrow_fb_link(w, rpos[2], bufs);
+
+    // A FieldNode for every column and its buffers, as offsets in body
+    body = 0;
+    for (i = 0, nb = 0; i < w->ncols; i++) {
+        arrow_fb_put(w, nodes + 4 + 16 * (size_t)i, w->nrows, 8);
+        arrow_fb_put(w, nodes + 12 + 16 * (size_t)i, w->col[i].nulls, 8);
+        n = arrow_column_buffers(&w->col[i], w->nrows, p, len);
+        for (j = 0; j < n; j++, nb++) {
+            arrow_fb_put(w, bufs + 4 + 16 * (size_t)nb, body, 8);
+            arrow_fb_put(w, bufs + 12 + 16 * (size_t)nb, len[j], 8);
+            body += ARROW_PAD8(len[j]);
+        }
+    }
+    arrow_fb_put(w, mpos[3], body, 8);
+
+    if (arrow_write_message(w))
+        return 1;
+    for (i = 0; i < w->ncols; i++) {
+        n = arrow_column_buffers(&w->col[i], w->nrows, p, len);
+        for (j = 0; j < n; j++) {
+            if (arrow_write_buffer(w, p[j], len[j]))
+                return 1;
+        }
+    }
+    return 0;
+}
+
+/*!
+  \fn int bufrdeco_arrow_init(struct bufrdeco_arrow_writer* w, FILE* out)
+  \brief Init a struct \ref bufrdeco_arrow_writer with the columns of index of message and subset
+  \param [out] w pointer to the writer
+  \param [in] out stream opened by caller where to write
+  \return 0 if succeeded, 1 otherwise
+
+  Nothing is written until the first batch is complete or \ref bufrdeco_arrow_flush is called
+*/
+int bufrdeco_arrow_init(struct bufrdeco_arrow_writer* w, FILE* out)
+{
+    memset(w, 0, sizeof(struct bufrdeco_arrow_writer));
+    w->out = out;
+    w->batch_rows = BUFRDECO_ARROW_BATCH_ROWS;
+    if ((w->first = (buf_t*)calloc(65536, sizeof(buf_t))) == NULL
+        || (w->count = (buf_t*)calloc(65536, sizeof(buf_t))) == NULL
+        || arrow_add_column(w, "message", "", 0, BUFRDECO_ARROW_INT32)
+        || arrow_add_column(w, "subset", "", 0, BUFRDECO_ARROW_INT32)) {
+        free(w->first);
+        free(w->count);
+        free(w->col);
+        memset(w, 0, sizeof(struct bufrdeco_arrow_writer));
+        return 1;
+    }
+    return 0;
+}
+
+/*!
+  \fn int bufrdeco_arrow_add_columns(struct bufrdeco_arrow_writer* w, const char* list)
+  \brief Add columns for a list of descriptors
+  \param [in,out] w pointer to the writer
+  \param [in] list descriptors separated by commas, as '001001,001002,012101'. A suffix '_n' selects the n-th
+  occurrence of descriptor in subset, as '007004_2'
+  \return 0 if succeeded, 1 if the list is not valid or the columns cannot be added
+
+  Columns must be added before the first subset. If none is added, there will be a column for every data of the
+  first subset
+*/
+int bufrdeco_arrow_add_columns(struct bufrdeco_arrow_writer* w, const char* list)
+{
+    char aux[BUFRDECO_ARROW_NAME_LENGTH], key[8], *c;
+    const char* s;
+    size_t n;
+    unsigned long occurrence;
+
+    for (s = list; *s; s += n) {
+        while (*s == ',' || *s == ' ')
+            s++;
+        if ((n = strcspn(s, ", ")) == 0)
+            break;
+        if (n >= sizeof(aux))
+            return 1;
+        memcpy(aux, s, n);
+        aux[n] = '\0';
+
+        if (strspn(aux, "0123456789") < 6 || aux[0] > '3' || (aux[1] - '0') * 10 + aux[2] - '0' > 63
+            || (aux[3] - '0') * 100 + (aux[4] - '0') * 10 + aux[5] - '0' > 255)
+            return 1;
+        memcpy(key, aux, 6);
+        key[6] = '\0';
+        occurrence = 1;
+        if (aux[6] == '_') {
+            occurrence = strtoul(aux + 7, &c, 10);
+            if (aux[7] == '\0' || *c != '\0' || occurrence == 0)
+                return 1;
+        } else if (aux[6] != '\0')
+            return 1;
+
+        if (occurrence > 1)
+            snprintf(aux, sizeof(aux), "%s_%lu", key, occurrence);
+        else
+            snprintf(aux, sizeof(aux), "%s", key);
+        if (arrow_add_column(w, aux, key, (buf_t)occurrence, BUFRDECO_ARROW_UNKNOWN))
+            return 1;
+    }
+    return 0;
+}
+
+/*!
+  \fn int bufrdeco_arrow_add_subset(struct bufrdeco_arrow_writer* w, const struct bufrdeco_subset_sequence_data* s)
+  \brief Add a row with the data of a decoded subset of current message
+  \param [in,out] w pointer to the writer
+  \param [in] s the decoded subset
+  \return 0 if succeeded, 1 otherwise
+*/
+int bufrdeco_arrow_add_subset(struct bufrdeco_arrow_writer* w, const struct bufrdeco_subset_sequence_data* s)
+{
+    struct bufrdeco_arrow_column* c;
+    buf_t j;
+
+    if (arrow_default_columns(w, s) || arrow_reserve(w, 1))
+        return 1;
+
+    arrow_append_int32(&w->col[0], (int32_t)w->message);
+    arrow_append_int32(&w->col[1], (int32_t)s->ss);
+    arrow_map_subset(w, s);
+    for (j = 2; j < w->ncols; j++) {
+        c = &w->col[j];
+        if (c->iatom == 0)
+            arrow_append_null(c);
+        else if (arrow_append_atom(c, &s->sequence[c->iatom - 1]))
+            return 1;
+    }
+
+    if (++w->nrows >= w->batch_rows)
+        return bufrdeco_arrow_flush(w);
+    return 0;
+}
+
+/*!
+  \fn static int arrow_add_compressed(struct bufrdeco_arrow_writer* w, struct bufrdeco* b)
+  \brief Add the rows of all subsets of a compressed message, from the columns of its compressed references
+*/
+static int arrow_add_compressed(struct bufrdeco_arrow_writer* w, struct bufrdeco* b)
+{
+    struct bufrdeco_subset_sequence_data* s;
+    struct bufrdeco_arrow_column* c;
+    struct bufr_atom_data a;
+    const double* v;
+    buf_t *iref, i, j, k, n, ns = b->sec3.subsets;
+
+    // The first subset is decoded to get the compressed references and the descriptors of data
+    if ((s = bufrdeco_get_target_subset_sequence_data(0, b)) == NULL)
+        return 1;
+    if (b->cols.ready == 0 && bufrdeco_decode_compressed_columns(b))
+        return 1;
+    if (arrow_default_columns(w, s) || arrow_reserve(w, ns)) {
+        snprintf(b->error, sizeof(b->error), "%s(): Cannot allocate memory for columns\n", __func__);
+        return 1;
+    }
+
+    // Index of compressed reference of every data, in the same order they are set in subset
+    if ((iref = (buf_t*)malloc(((size_t)s->nd + 1) * sizeof(buf_t))) == NULL) {
+        snprintf(b->error, sizeof(b->error), "%s(): Cannot allocate memory\n", __func__);
+        return 1;
+    }
+    for (k = 0, n = 0; k < b->bitacora.nd && n < s->nd; k++) {
+        if (b->bitacora.event[k].ref_index >= 0)
+            iref[n++] = (buf_t)b->bitacora.event[k].ref_index;
+    }
+
+    arrow_map_subset(w, s);
+    for (k = 0; k < ns; k++) {
+        arrow_append_int32(&w->col[0], (int32_t)w->message);
+        arrow_append_int32(&w->col[1], (int32_t)k);
+    }
+    for (j = 2; j < w->ncols; j++) {
+        c = &w->col[j];
+        if (c->iatom == 0 || c->iatom > n) {
+            for (k = 0; k < ns; k++)
+                arrow_append_null(c);
+            continue;
+        }
+
+        i = iref[c->iatom - 1];
+        arrow_column_resolve(c, &s->sequence[c->iatom - 1]);
+        if (b->cols.kind[i] != BUFRDECO_COLUMN_NONE && c->type == BUFRDECO_ARROW_FLOAT64) {
+            v = b->cols.val + (size_t)i * ns;
+            for (k = 0; k < ns; k++)
+                arrow_append_double(c, v[k]);
+            continue;
+        }
+
+        // Strings, associated fields and local descriptors are got subset by subset
+        for (k = 0; k < ns; k++) {
+            if (bufrdeco_get_atom_data_from_compressed_data_ref(&a, &b->refs.refs[i], k, b)
+                || arrow_append_atom(c, &a)) {
+                free(iref);
+                return 1;
+            }
+        }
+    }
+    free(iref);
+
+    w->nrows += ns;
+    if (w->nrows >= w->batch_rows)
+        return bufrdeco_arrow_flush(w);
+    return 0;
+}
+
+/*!
+  \fn int bufrdeco_arrow_add_bufr(struct bufrdeco_arrow_writer* w, struct bufrdeco* b)
+  \brief Add a row for every subset of current message of a struct \ref bufrdeco
+  \param [in,out] w pointer to the writer
+  \param [in,out] b pointer to the decoder, with the tree of message already parsed
+  \return 0 if succeeded, 1 otherwise. The error is in member \a error of \a b
+
+  The message is counted even if it fails, so the column of index of message is the order of messages in input
+*/
+int bufrdeco_arrow_add_bufr(struct bufrdeco_arrow_writer* w, struct bufrdeco* b)
+{
+    struct bufrdeco_subset_sequence_data* s;
+    buf_t k;
+    int res = 0;
+
+    bufrdeco_assert(w != NULL && b != NULL);
+
+    if (b->sec3.compressed && b->sec3.subsets > 1)
+        res = arrow_add_compressed(w, b);
+    else {
+        for (k = 0; k < b->sec3.subsets && res == 0; k++) {
+            if ((s = bufrdeco_get_target_subset_sequence_data(k, b)) == NULL)
+                res = 1;
+            else if (bufrdeco_arrow_add_subset(w, s)) {
+                snprintf(b->error, sizeof(b->error), "%s(): Cannot add subset %u\n", __func__, k);
+                res = 1;
+            }
+        }
+    }
+    w->message++;
+    return res;
+}
+
+/*!
+  \fn int bufrdeco_arrow_flush(struct bufrdeco_arrow_writer* w)
+  \brief Write the schema if not written yet and the rows of current batch, if any
+  \param [in,out] w pointer to the writer
+  \return 0 if succeeded, 1 otherwise
+
+  Columns with a type still unknown, because no data was found for them, are written as doubles
+*/
+int bufrdeco_arrow_flush(struct bufrdeco_arrow_writer* w)
+{
+    struct bufrdeco_arrow_column* c;
+    buf_t i;
+
+    if (w->schema_written == 0) {
+        for (i = 0; i < w->ncols; i++) {
+            if (w->col[i].type == BUFRDECO_ARROW_UNKNOWN)
+                arrow_column_set_type(&w->col[i], BUFRDECO_ARROW_FLOAT64);
+        }
+        if (arrow_write_schema(w))
+            return 1;
+        w->schema_written = 1;
+    }
+
+    if (w->nrows == 0)
+        return 0;
+
+    if (arrow_write_batch(w))
+        return 1;
+    w->rows += w->nrows;
+    w->batches++;
+
+    for (i = 0; i < w->ncols; i++) {
+        c = &w->col[i];
+        memset(c->valid, 0, ((size_t)w->nrows + 7) / 8);
+        c->nulls = 0;
+        c->filled = 0;
+        c->lstr = 0;
+        if (c->type == BUFRDECO_ARROW_UTF8)
+            ((int32_t*)c->data)[0] = 0;
+    }
+    w->nrows = 0;
+    return 0;
+}
+
+/*!
+  \fn int bufrdeco_arrow_close(struct bufrdeco_arrow_writer* w)
+  \brief Write the pending rows and the end of stream mark, then free the memory of a writer
+  \param [in,out] w pointer to the writer
+  \return 0 if succeeded, 1 otherwise
+
+  The stream is not closed, it was opened by caller
+*/
+int bufrdeco_arrow_close(struct bufrdeco_arrow_writer* w)
+{
+    static const uint8_t eos[8] = { 0xFF, 0xFF, 0xFF, 0xFF, 0, 0, 0, 0 };
+    buf_t i;
+    int res;
+
+    res = bufrdeco_arrow_flush(w);
+    if (res == 0 && (fwrite(eos, 1, 8, w->out) != 8 || fflush(w->out)))
+        res = 1;
+
+    for (i = 0; i < w->ncols; i++) {
+        free(w->col[i].valid);
+        free(w->col[i].data);
+        free(w->col[i].str);
+    }
+    free(w->col);
+    free(w->first);
+    free(w->count);
+    free(w->fb);
+    w->col = NULL;
+    w->first = w->count = NULL;
+    w->fb = NULL;
+    w->ncols = w->dcols = w->nrows = w->drows = 0;
+    w->lfb = w->dfb = 0;
+    return res;
+}
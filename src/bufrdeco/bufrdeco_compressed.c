@@ -47,6 +47,10 @@ int bufrdeco_parse_compressed ( struct bufrdeco_compressed_data_references *r, s
       return 1; //fatal error, no parsed tree
     }
 
+  // columns and subset data got from previous references are no more valid
+  b->cols.ready = 0;
+  b->cols.seq_ready = 0;
+
   // first we assure that needed memory is allocated and array of bufr_compressed references initizalized
   if ( bufrdeco_init_compressed_data_references ( r ) )
     {
@@ -463,6 +467,7 @@ int bufrdeco_decode_replicated_subsequence_compressed ( struct bufrdeco_compress
 
   // the registry
   dsb = &b->bitacora;
+  memset ( &event, 0, sizeof ( struct bufrdeco_decode_subset_event ) );
 
   // The big loop
   for ( ixloop = 0; ixloop < rep->nloops; ixloop++ )
@@ -1227,6 +1232,184 @@ int bufrdeco_get_atom_data_from_compressed_data_ref ( struct bufr_atom_data *a,
   return 0;
 }
 
+/*!
+  \fn int bufrdeco_decode_compressed_columns ( struct bufrdeco *b )
+  \brief Get the values of all subsets for every numeric compressed reference in a single pass
+  \param [in,out] b Basic container struct \ref bufrdeco with the compressed references already parsed
+  \return Returns 0 if succeeded, 1 otherwise
+
+  The data of every reference in sec4 is a contiguous array of \a inc_bits fields, one per subset, so the values
+  of a reference for all subsets are got in an inner loop with the same reference, scale and bit length. Results
+  are in member \a cols of \a b
+*/
+int bufrdeco_decode_compressed_columns ( struct bufrdeco *b )
+{
+  buf_t i, k, bit_offset;
+  uint8_t has_data;
+  uint32_t ival0;
+  double factor, *v;
+  struct bufrdeco_compressed_ref *r;
+  struct bufrdeco_compressed_columns *c;
+  size_t need;
+
+  bufrdeco_assert ( b != NULL );
+
+  c = & ( b->cols );
+  if ( b->refs.refs == NULL || b->refs.nd == 0 )
+    {
+      snprintf ( b->error, sizeof ( b->error ), "%s(): Try to get columns without previous references\n", __func__ );
+      return 1;
+    }
+
+  // allocate memory if needed
+  need = ( size_t ) b->refs.nd * b->sec3.subsets;
+  if ( c->dim < need )
+    {
+      free ( ( void * ) c->val );
+      if ( ( c->val = ( double * ) malloc ( need * sizeof ( double ) ) ) == NULL )
+        {
+          c->dim = 0;
+          snprintf ( b->error, sizeof ( b->error ), "%s(): Cannot allocate memory for columns\n", __func__ );
+          return 1;
+        }
+      c->dim = need;
+    }
+  if ( c->dimk < b->refs.nd )
+    {
+      free ( ( void * ) c->kind );
+      if ( ( c->kind = ( uint8_t * ) malloc ( b->refs.nd ) ) == NULL )
+        {
+          c->dimk = 0;
+          snprintf ( b->error, sizeof ( b->error ), "%s(): Cannot allocate memory for columns\n", __func__ );
+          return 1;
+        }
+      c->dimk = b->refs.nd;
+    }
+
+  c->nrefs = b->refs.nd;
+  c->nsubsets = b->sec3.subsets;
+
+  for ( i = 0; i < b->refs.nd; i++ )
+    {
+      r = & ( b->refs.refs[i] );
+
+      // The same cases than bufrdeco_get_atom_data_from_compressed_data_ref() with no numeric value
+      if ( is_a_local_descriptor ( r->desc ) || strstr ( r->unit, "CCITT" ) != NULL || r->is_associated )
+        {
+          c->kind[i] = BUFRDECO_COLUMN_NONE;
+          continue;
+        }
+
+      if ( strstr ( r->unit, "CODE TABLE" ) == r->unit  || strstr ( r->unit, "Code table" ) == r->unit )
+        c->kind[i] = BUFRDECO_COLUMN_CODE_TABLE;
+      else if ( strstr ( r->unit,"FLAG" ) == r->unit || strstr ( r->unit,"Flag" ) == r->unit )
+        c->kind[i] = BUFRDECO_COLUMN_FLAG_TABLE;
+      else
+        c->kind[i] = BUFRDECO_COLUMN_NUMERIC;
+
+      v = c->val + ( size_t ) i * c->nsubsets;
+      if ( r->has_data == 0 || r->inc_bits > r->bits )
+        {
+          for ( k = 0; k < c->nsubsets; k++ )
+            v[k] = MISSING_REAL;
+          continue;
+        }
+
+      factor = Exp10 ( ( double ) ( - r->escale ) );
+      if ( r->inc_bits == 0 )
+        {
+          // case of all data same
+          v[0] = ( double ) ( r->ref + ( int32_t ) r->ref0 ) * factor;
+          for ( k = 1; k < c->nsubsets; k++ )
+            v[k] = v[0];
+          continue;
+        }
+
+      // the inc_bits of the subsets are consecutive after the local reference and the 6 bits of inc_bits
+      bit_offset = r->bit0 + r->bits + 6;
+      for ( k = 0; k < c->nsubsets; k++ )
+        {
+          if ( get_bits_as_uint32_t ( &ival0, &has_data, &b->sec4.raw[4], &bit_offset, r->inc_bits ) == 0 )
+            {
+              snprintf ( b->error, sizeof ( b->error ), "%s(): Cannot get %d inc_bits from '%s'\n", __func__, r->inc_bits, r->desc->c );
+              return 1;
+            }
+          v[k] = has_data ? ( double ) ( r->ref + ( int32_t ) ( r->ref0 + ival0 ) ) * factor : MISSING_REAL;
+        }
+    }
+
+  c->ready = 1;
+  return 0;
+}
+
+/*!
+  \fn int bufrdeco_get_atom_data_from_compressed_column ( struct bufr_atom_data *a, struct bufrdeco_compressed_ref *r, buf_t iref, buf_t subset, struct bufrdeco *b )
+  \brief Update an atom data got for other subset from the same reference with the value of a given subset
+  \param [in,out] a Pointer to the target struct \ref bufr_atom_data, already set for other subset from reference \a r
+  \param [in] r Pointer to the struct \ref bufrdeco_compressed_ref
+  \param [in] iref Index of \a r in compressed references
+  \param [in] subset Index for solicited subset. First subset has index 0
+  \param [in,out] b Basic container struct \ref bufrdeco with columns already got by \ref bufrdeco_decode_compressed_columns
+
+  \return Returns 0 if succeeded, 1 otherwise
+
+  Descriptor, name, unit, scale and bitmap indexes are the same for all subsets, so only value, mask and
+  code or flag table explanation are set. References with no column are got with \ref bufrdeco_get_atom_data_from_compressed_data_ref
+*/
+int bufrdeco_get_atom_data_from_compressed_column ( struct bufr_atom_data *a, struct bufrdeco_compressed_ref *r,
+    buf_t iref, buf_t subset, struct bufrdeco *b )
+{
+  double val;
+  uint32_t ival;
+  buf_t i;
+  struct bufr_tableB *tb;
+  const struct bufrdeco_compressed_columns *c = & ( b->cols );
+
+  if ( c->kind[iref] == BUFRDECO_COLUMN_NONE )
+    return bufrdeco_get_atom_data_from_compressed_data_ref ( a, r, subset, b );
+
+  val = c->val[( size_t ) iref * c->nsubsets + subset];
+  if ( val == MISSING_REAL )
+    {
+      a->val = MISSING_REAL;
+      a->mask = DESCRIPTOR_VALUE_MISSING;
+      return 0;
+    }
+
+  if ( c->kind[iref] == BUFRDECO_COLUMN_NUMERIC )
+    {
+      a->val = val;
+      a->mask = 0;
+      return 0;
+    }
+
+  // Same code or flag value than in previous subset, so the explanation is the same
+  if ( ( a->mask & DESCRIPTOR_VALUE_MISSING ) == 0 && a->val == val )
+    return 0;
+
+  a->val = val;
+  ival = ( uint32_t ) ( a->val + 0.5 );
+  tb = & ( b->tables->b );
+  if ( c->kind[iref] == BUFRDECO_COLUMN_CODE_TABLE )
+    {
+      i = tb->x_start[r->desc->x] + tb->y_ref[r->desc->x][r->desc->y];
+      a->mask = DESCRIPTOR_IS_CODE_TABLE;
+      if ( bufrdeco_explained_table_val ( a->ctable, 256, & ( b->tables->c ), & ( tb->item[i].tableC_ref ), & ( a->desc ), ival ) != NULL )
+        {
+          a->mask |= DESCRIPTOR_HAVE_CODE_TABLE_STRING;
+        }
+    }
+  else
+    {
+      a->mask = DESCRIPTOR_IS_FLAG_TABLE;
+      if ( bufrdeco_explained_flag_val ( a->ctable, 256, & ( b->tables->c ), & ( a->desc ), ival, r->bits ) != NULL )
+        {
+          a->mask |= DESCRIPTOR_HAVE_FLAG_TABLE_STRING;
+        }
+    }
+  return 0;
+}
+
 /*!
   \fn int bufr_decode_subset_data_compressed ( struct bufrdeco_subset_sequence_data *s, struct bufrdeco_compressed_data_references *r, struct bufrdeco *b )
   \brief Get data for a given subset in a compressed data bufr
@@ -1238,6 +1421,7 @@ int bufrdeco_get_atom_data_from_compressed_data_ref ( struct bufr_atom_data *a,
 int bufr_decode_subset_data_compressed ( struct bufrdeco_subset_sequence_data *s, struct bufrdeco_compressed_data_references *r, struct bufrdeco *b )
 {
   size_t i = 0, /*j = 0,*/ k; // references index
+  int use_columns;
 
   if ( b == NULL )
     return 1;
@@ -1259,6 +1443,16 @@ int bufr_decode_subset_data_compressed ( struct bufrdeco_subset_sequence_data *s
   // The subset index
   s->ss = b->state.subset;
 
+  // If a previous subset is already in s, only the values change. Then they are got from the columns
+  use_columns = 0;
+  if ( b->cols.seq_ready && b->sec3.subsets > 1 )
+    {
+      if ( b->cols.ready == 0 && bufrdeco_decode_compressed_columns ( b ) )
+        return 1;
+      use_columns = 1;
+    }
+  b->cols.seq_ready = 0;
+
   // then get sequence
   for ( k = 0; k < b->bitacora.nd; k++ )
     {
@@ -1267,7 +1461,12 @@ int bufr_decode_subset_data_compressed ( struct bufrdeco_subset_sequence_data *s
       else
         continue;// index in compressed refs
 
-      if ( bufrdeco_get_atom_data_from_compressed_data_ref ( & ( s->sequence[s->nd] ), & ( r->refs[i] ), b->state.subset, b ) )
+      if ( use_columns )
+        {
+          if ( bufrdeco_get_atom_data_from_compressed_column ( & ( s->sequence[s->nd] ), & ( r->refs[i] ), i, b->state.subset, b ) )
+            return 1;
+        }
+      else if ( bufrdeco_get_atom_data_from_compressed_data_ref ( & ( s->sequence[s->nd] ), & ( r->refs[i] ), b->state.subset, b ) )
         return 1;
 
       if ( r->refs[i].is_associated == 0 )
@@ -1296,6 +1495,8 @@ int bufr_decode_subset_data_compressed ( struct bufrdeco_subset_sequence_data *s
         }
     }
 
+  b->cols.seq_ready = 1;
+
   if ( b->mask & BUFRDECO_OUTPUT_JSON_SUBSET_DATA )
     bufrdeco_print_json_subset_data ( b );
   return 0;
@@ -0,0 +1,578 @@
+/***************************************************************************
+ *   Copyright (C) 2013-2026 by Guillermo Ballester Valor                  *
+ *   gbv@ogimet.com                                                        *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.             *
+ ***************************************************************************/
+/*!
+ \file bufrdeco_crefs.c
+ \brief This file has the code to write and read the references of a compressed BUFR in a binary file
+
+ When decoding a compressed BUFR, \ref bufrdeco_parse_compressed walks the whole sec4 to set the compressed
+ references, the events of bitacora, the bitmaps and the associated fields. All of them are written in a compact
+ binary file, named with the hash of the message, so when the same message is got again these are read instead.
+ Pointers to the expanded tree are stored as byte offsets in struct \ref bufrdeco_expanded_tree, which is the same
+ for the same message and tables. The tables used are also stored, so a file written with other tables, or with
+ the same ones before they were changed, is not used. The file is in native byte order and only valid for the host
+ which wrote it
+*/
+#include "bufrdeco.h"
+#include <unistd.h>
+
+/*!
+  \def BUFRDECO_CREFS_MAGIC
+  \brief First 8 bytes of a file of compressed references
+*/
+#define BUFRDECO_CREFS_MAGIC "BUFRCRF"
+
+/*!
+  \def BUFRDECO_CREFS_VERSION
+  \brief Version of the layout of a file of compressed references
+*/
+#define BUFRDECO_CREFS_VERSION (2U)
+
+/*!
+  \def BUFRDECO_CREFS_BYTE_ORDER
+  \brief Written in native order, to check the file was written by a host with the same byte order
+*/
+#define BUFRDECO_CREFS_BYTE_ORDER (0x01020304U)
+
+/*!
+  \def BUFRDECO_CREFS_NULL
+  \brief Offset or index stored for a NULL pointer
+*/
+#define BUFRDECO_CREFS_NULL (0xFFFFFFFFU)
+
+/*!
+  \struct bufrdeco_crefs_table
+  \brief A csv file of table B the references were got with, as found when the file was written
+*/
+struct bufrdeco_crefs_table {
+    char path[BUFRDECO_PATH_LENGTH]; /*!< Pathname. Empty if not used */
+    int64_t size; /*!< Size in bytes */
+    int64_t mtime; /*!< Time of last modification */
+};
+
+/*!
+  \struct bufrdeco_crefs_source
+  \brief The tables the compressed references were got with. Widths, scales and references come from table B
+*/
+struct bufrdeco_crefs_source {
+    char tables_dir[BUFRDECO_PATH_LENGTH]; /*!< Directory of tables, member \a bufrtables_dir of struct \ref bufrdeco */
+    uint32_t local; /*!< 1 if local tables are used, 0 otherwise */
+    uint32_t pad; /*!< Not used, set to 0 */
+    struct bufrdeco_crefs_table tableb[2]; /*!< Master and local tables B */
+};
+
+/*!
+  \struct bufrdeco_crefs_header
+  \brief Header of a file of compressed references
+*/
+struct bufrdeco_crefs_header {
+    char magic[8]; /*!< \ref BUFRDECO_CREFS_MAGIC */
+    uint32_t version; /*!< \ref BUFRDECO_CREFS_VERSION */
+    uint32_t byte_order; /*!< \ref BUFRDECO_CREFS_BYTE_ORDER */
+    uint64_t hash; /*!< Hash of message, see \ref bufrdeco_message_hash */
+    uint32_t length; /*!< Length of sec4 */
+    uint32_t subsets; /*!< Subsets in message */
+    uint32_t tree_size; /*!< sizeof (struct bufrdeco_expanded_tree), offsets are in this struct */
+    uint32_t nseq; /*!< Number of sequences in expanded tree */
+    uint32_t nrefs; /*!< Number of compressed references */
+    uint32_t nevents; /*!< Number of events in bitacora */
+    uint32_t nbitmaps; /*!< Number of bitmaps */
+    uint32_t nassoc; /*!< Number of associated fields */
+    struct bufrdeco_crefs_source src; /*!< Tables used */
+};
+
+/*!
+  \struct bufrdeco_crefs_reader
+  \brief A file of compressed references loaded in memory and the position of next item to read
+*/
+struct bufrdeco_crefs_reader {
+    const uint8_t* data; /*!< Content of file */
+    size_t size; /*!< Bytes in \a data */
+    size_t pos; /*!< Offset of next item to read */
+};
+
+/*!
+  \fn static int crefs_set_table(struct bufrdeco_crefs_table* t, const char* path)
+  \brief Set the pathname, size and time of a csv file of table B
+  \return 0 if succeeded, 1 if the file does not exist
+*/
+static int crefs_set_table(struct bufrdeco_crefs_table* t, const char* path)
+{
+    struct stat st;
+
+    if (path[0] == '\0')
+        return 0;
+    if (stat(path, &st))
+        return 1;
+    snprintf(t->path, sizeof(t->path), "%s", path);
+    t->size = (int64_t)st.st_size;
+    t->mtime = (int64_t)st.st_mtime;
+    return 0;
+}
+
+/*!
+  \fn static int crefs_set_source(struct bufrdeco_crefs_source* s, const struct bufrdeco* b)
+  \brief Set the tables used now by a struct \ref bufrdeco
+  \return 0 if succeeded, 1 if tables are not loaded or a csv file does not exist
+*/
+static int crefs_set_source(struct bufrdeco_crefs_source* s, const struct bufrdeco* b)
+{
+    memset(s, 0, sizeof(struct bufrdeco_crefs_source));
+    if (b->tables == NULL)
+        return 1;
+    snprintf(s->tables_dir, sizeof(s->tables_dir), "%s", b->bufrtables_dir);
+    s->local = (b->mask & BUFRDECO_LOCAL_TABLES) ? 1 : 0;
+    return crefs_set_table(&s->tableb[0], b->tables->b.path) || crefs_set_table(&s->tableb[1], b->tables->b.local_path);
+}
+
+/*!
+  \fn static int crefs_put(FILE* f, const void* p, size_t n)
+  \brief Write \a n bytes in a file
+  \return 0 if succeeded, 1 otherwise
+*/
+static int crefs_put(FILE* f, const void* p, size_t n)
+{
+    return n && fwrite(p, n, 1, f) != 1;
+}
+
+/*!
+  \fn static int crefs_put_string(FILE* f, const char* s)
+  \brief Write a string as its length in 16 bits followed by its chars without the final '\\0'
+  \return 0 if succeeded, 1 otherwise
+*/
+static int crefs_put_string(FILE* f, const char* s)
+{
+    uint16_t n = (uint16_t)strlen(s);
+
+    return crefs_put(f, &n, sizeof(n)) || crefs_put(f, s, n);
+}
+
+/*!
+  \fn static int crefs_get(struct bufrdeco_crefs_reader* r, void* p, size_t n)
+  \brief Read \a n bytes from a loaded file of compressed references
+  \return 0 if succeeded, 1 if the file has not enough bytes
+*/
+static int crefs_get(struct bufrdeco_crefs_reader* r, void* p, size_t n)
+{
+    if (r->size - r->pos < n)
+        return 1;
+    memcpy(p, r->data + r->pos, n);
+    r->pos += n;
+    return 0;
+}
+
+/*!
+  \fn static int crefs_get_string(struct bufrdeco_crefs_reader* r, char* s, size_t dim)
+  \brief Read a string written by \ref crefs_put_string
+  \param [in,out] r the reader
+  \param [out] s target string
+  \param [in] dim size of \a s
+  \return 0 if succeeded, 1 if the file has not enough bytes or the string does not fit in \a s
+*/
+static int crefs_get_string(struct bufrdeco_crefs_reader* r, char* s, size_t dim)
+{
+    uint16_t n;
+
+    if (crefs_get(r, &n, sizeof(n)) || n >= dim || crefs_get(r, s, n))
+        return 1;
+    s[n] = '\0';
+    return 0;
+}
+
+/*!
+  \fn static uint32_t crefs_tree_offset(const struct bufrdeco* b, const void* p)
+  \brief Byte offset of a pointer in the expanded tree
+  \return the offset, \ref BUFRDECO_CREFS_NULL if \a p is NULL or it is not in the tree
+*/
+static uint32_t crefs_tree_offset(const struct bufrdeco* b, const void* p)
+{
+    const uint8_t* t = (const uint8_t*)b->tree;
+
+    if (p == NULL || (const uint8_t*)p < t || (const uint8_t*)p >= t + sizeof(struct bufrdeco_expanded_tree))
+        return BUFRDECO_CREFS_NULL;
+    return (uint32_t)((const uint8_t*)p - t);
+}
+
+/*!
+  \fn static void* crefs_tree_pointer(const struct bufrdeco* b, uint32_t ofs, size_t size)
+  \brief Pointer in the expanded tree from its byte offset
+  \param [in] b the active struct \ref bufrdeco
+  \param [in] ofs the offset got from \ref crefs_tree_offset
+  \param [in] size size of the struct pointed to
+  \return The pointer, NULL if \a ofs is \ref BUFRDECO_CREFS_NULL or out of the tree
+*/
+static void* crefs_tree_pointer(const struct bufrdeco* b, uint32_t ofs, size_t size)
+{
+    if (ofs == BUFRDECO_CREFS_NULL || ofs + size > sizeof(struct bufrdeco_expanded_tree))
+        return NULL;
+    return (uint8_t*)b->tree + ofs;
+}
+
+/*!
+  \fn static int crefs_put_bitmap(FILE* f, const struct bufrdeco_bitmap* bm)
+  \brief Write a bitmap, only the used elements of its arrays
+  \return 0 if succeeded, 1 otherwise
+*/
+static int crefs_put_bitmap(FILE* f, const struct bufrdeco_bitmap* bm)
+{
+    buf_t i;
+    int e;
+
+    e = crefs_put(f, &bm->dim, sizeof(buf_t)) || crefs_put(f, &bm->nb0, sizeof(buf_t)) || crefs_put(f, &bm->nb, sizeof(buf_t))
+        || crefs_put(f, &bm->nq, sizeof(buf_t)) || crefs_put(f, &bm->subs, sizeof(buf_t)) || crefs_put(f, &bm->retain, sizeof(buf_t))
+        || crefs_put(f, &bm->ns1, sizeof(buf_t)) || crefs_put(f, &bm->nds, sizeof(buf_t))
+        || crefs_put(f, bm->bitmap_to, bm->nb * sizeof(buf_t)) || crefs_put(f, bm->me, bm->nb * sizeof(buf_t))
+        || crefs_put(f, bm->quality, bm->nq * sizeof(buf_t)) || crefs_put(f, bm->stat1, bm->ns1 * sizeof(buf_t))
+        || crefs_put(f, bm->stat1_desc, bm->ns1 * sizeof(buf_t)) || crefs_put(f, bm->dstat, bm->nds * sizeof(buf_t))
+        || crefs_put(f, bm->dstat_desc, bm->nds * sizeof(buf_t));
+    for (i = 0; e == 0 && i < bm->ns1; i++)
+        e = crefs_put_string(f, bm->stat1_expl[i]);
+    for (i = 0; e == 0 && i < bm->nds; i++)
+        e = crefs_put_string(f, bm->dstat_expl[i]);
+    return e;
+}
+
+/*!
+  \fn static int crefs_get_bitmap(struct bufrdeco_crefs_reader* r, struct bufrdeco_bitmap* bm)
+  \brief Read a bitmap written by \ref crefs_put_bitmap
+  \return 0 if succeeded, 1 otherwise
+*/
+static int crefs_get_bitmap(struct bufrdeco_crefs_reader* r, struct bufrdeco_bitmap* bm)
+{
+    buf_t i;
+    int e;
+
+    e = crefs_get(r, &bm->dim, sizeof(buf_t)) || crefs_get(r, &bm->nb0, sizeof(buf_t)) || crefs_get(r, &bm->nb, sizeof(buf_t))
+        || crefs_get(r, &bm->nq, sizeof(buf_t)) || crefs_get(r, &bm->subs, sizeof(buf_t)) || crefs_get(r, &bm->retain, sizeof(buf_t))
+        || crefs_get(r, &bm->ns1, sizeof(buf_t)) || crefs_get(r, &bm->nds, sizeof(buf_t));
+    if (e || bm->nb > BUFR_MAX_BITMAP_PRESENT_DATA || bm->nq > BUFR_MAX_QUALITY_DATA || bm->ns1 > BUFR_MAX_QUALITY_DATA
+        || bm->nds > BUFR_MAX_QUALITY_DATA)
+        return 1;
+    e = crefs_get(r, bm->bitmap_to, bm->nb * sizeof(buf_t)) || crefs_get(r, bm->me, bm->nb * sizeof(buf_t))
+        || crefs_get(r, bm->quality, bm->nq * sizeof(buf_t)) || crefs_get(r, bm->stat1, bm->ns1 * sizeof(buf_t))
+        || crefs_get(r, bm->stat1_desc, bm->ns1 * sizeof(buf_t)) || crefs_get(r, bm->dstat, bm->nds * sizeof(buf_t))
+        || crefs_get(r, bm->dstat_desc, bm->nds * sizeof(buf_t));
+    for (i = 0; e == 0 && i < bm->ns1; i++)
+        e = crefs_get_string(r, bm->stat1_expl[i], BUFR_EXPLAINED_LENGTH);
+    for (i = 0; e == 0 && i < bm->nds; i++)
+        e = crefs_get_string(r, bm->dstat_expl[i], BUFR_EXPLAINED_LENGTH);
+    return e;
+}
+
+/*!
+  \fn int bufrdeco_set_compressed_references_dir(struct bufrdeco* b, const char* dir)
+  \brief Set the directory of the cache of compressed references and activate it
+  \param [in,out] b pointer to the target struct \ref bufrdeco
+  \param [in] dir path of directory, ended with '/'. If NULL or empty the cache is not used
+  \return 0 if succeeded, 1 otherwise
+*/
+int bufrdeco_set_compressed_references_dir(struct bufrdeco* b, const char* dir)
+{
+    bufrdeco_assert_with_return_val(b != NULL, 1);
+
+    if (dir == NULL || dir[0] == '\0') {
+        b->crefs_dir[0] = '\0';
+        b->mask &= ~((uint32_t)BUFRDECO_USE_COMPRESSED_REFERENCES_CACHE);
+        return 0;
+    }
+    if (strlen(dir) >= sizeof(b->crefs_dir)) {
+        snprintf(b->error, sizeof(b->error), "%s(): Too long directory '%s'\n", __func__, dir);
+        return 1;
+    }
+    strcpy(b->crefs_dir, dir);
+    b->mask |= BUFRDECO_USE_COMPRESSED_REFERENCES_CACHE;
+    return 0;
+}
+
+/*!
+  \fn int bufrdeco_compressed_references_path(char* target, size_t dim, const struct bufrdeco* b)
+  \brief Set the path of the file of compressed references of current message in cache directory
+  \param [out] target the resulting path, as \a crefs_dir plus the hash in hexadecimal and '.crefs'
+  \param [in] dim size of \a target
+  \param [in] b pointer to the struct \ref bufrdeco with a read BUFR
+  \return 0 if succeeded, 1 if the path does not fit in \a target
+*/
+int bufrdeco_compressed_references_path(char* target, size_t dim, const struct bufrdeco* b)
+{
+    int n;
+
+    n = snprintf(target, dim, "%s%016" PRIx64 ".crefs", b->crefs_dir, bufrdeco_message_hash(b));
+    return n < 0 || (size_t)n >= dim;
+}
+
+/*!
+  \fn int bufrdeco_write_compressed_references(struct bufrdeco* b, const char* filename)
+  \brief Write the compressed references, bitacora, bitmaps and associated fields of current compressed BUFR
+  \param [in,out] b pointer to the struct \ref bufrdeco, with compressed references already parsed
+  \param [in] filename pathname of file to write
+  \return 0 if succeeded, 1 otherwise
+
+  The file is written with a temporary name and then renamed, so a process reading the cache never gets it incomplete
+*/
+int bufrdeco_write_compressed_references(struct bufrdeco* b, const char* filename)
+{
+    struct bufrdeco_crefs_header h;
+    const struct bufrdeco_compressed_ref* rf;
+    const struct bufrdeco_decode_subset_event* ev;
+    char tmp[BUFRDECO_PATH_LENGTH + 32];
+    uint32_t u;
+    buf_t i, j;
+    FILE* f;
+    int e = 0;
+
+    bufrdeco_assert_with_return_val(b != NULL && filename != NULL, 1);
+
+    if (b->sec3.compressed == 0 || b->refs.nd == 0 || b->tree == NULL) {
+        snprintf(b->error, sizeof(b->error), "%s(): No compressed references to write\n", __func__);
+        return 1;
+    }
+
+    memset(&h, 0, sizeof(h));
+    strcpy(h.magic, BUFRDECO_CREFS_MAGIC);
+    h.version = BUFRDECO_CREFS_VERSION;
+    h.byte_order = BUFRDECO_CREFS_BYTE_ORDER;
+    h.hash = bufrdeco_message_hash(b);
+    h.length = b->sec4.length;
+    h.subsets = b->sec3.subsets;
+    h.tree_size = (uint32_t)sizeof(struct bufrdeco_expanded_tree);
+    h.nseq = b->tree->nseq;
+    h.nrefs = b->refs.nd;
+    h.nevents = b->bitacora.nd;
+    h.nbitmaps = b->bitmap.nba;
+    h.nassoc = b->assoc.nd;
+    if (crefs_set_source(&h.src, b)) {
+        snprintf(b->error, sizeof(b->error), "%s(): Cannot get the tables used\n", __func__);
+        return 1;
+    }
+
+    snprintf(tmp, sizeof(tmp), "%s.%ld.tmp", filename, (long)getpid());
+    if ((f = fopen(tmp, "w")) == NULL) {
+        snprintf(b->error, sizeof(b->error), "%s(): Cannot open '%s'\n", __func__, tmp);
+        return 1;
+    }
+
+    e = crefs_put(f, &h, sizeof(h));
+
+    for (i = 0; e == 0 && i < b->refs.nd; i++) {
+        rf = &b->refs.refs[i];
+        e = crefs_put(f, &rf->bitac, sizeof(rf->bitac)) || crefs_put(f, &rf->is_associated, sizeof(rf->is_associated))
+            || crefs_put(f, &rf->has_data, sizeof(rf->has_data)) || crefs_put(f, &rf->bits, sizeof(rf->bits))
+            || crefs_put(f, &rf->inc_bits, sizeof(rf->inc_bits)) || crefs_put(f, &rf->ref, sizeof(rf->ref))
+            || crefs_put(f, &rf->bit0, sizeof(rf->bit0)) || crefs_put(f, &rf->ref0, sizeof(rf->ref0))
+            || crefs_put(f, &rf->escale, sizeof(rf->escale)) || crefs_put(f, &rf->me, sizeof(buf_t))
+            || crefs_put(f, &rf->is_bitmaped_by, sizeof(buf_t)) || crefs_put(f, &rf->bitmap_to, sizeof(buf_t))
+            || crefs_put(f, &rf->related_to, sizeof(buf_t)) || crefs_put(f, &rf->qualified_by, sizeof(buf_t))
+            || crefs_put(f, &rf->replicated_desc, sizeof(buf_t)) || crefs_put(f, &rf->replicated_loop, sizeof(buf_t))
+            || crefs_put(f, &rf->replicated_ndesc, sizeof(buf_t)) || crefs_put(f, &rf->replicated_nloop, sizeof(buf_t))
+            || crefs_put(f, &rf->associated_to, sizeof(buf_t)) || crefs_put_string(f, rf->cref0)
+            || crefs_put_string(f, rf->name) || crefs_put_string(f, rf->unit);
+        if (e == 0) {
+            u = crefs_tree_offset(b, rf->desc);
+            e = crefs_put(f, &u, sizeof(u));
+            u = crefs_tree_offset(b, rf->seq);
+            e = e || crefs_put(f, &u, sizeof(u));
+        }
+    }
+
+    for (i = 0; e == 0 && i < b->bitmap.nba; i++)
+        e = crefs_put_bitmap(f, b->bitmap.bmap[i]);
+
+    for (i = 0; e == 0 && i < b->assoc.nd; i++) {
+        e = crefs_put(f, &b->assoc.afield[i].index, sizeof(buf_t))
+            || crefs_put(f, &b->assoc.afield[i].assoc_bits, sizeof(uint8_t))
+            || crefs_put(f, &b->assoc.afield[i].val, sizeof(uint8_t))
+            || crefs_put_string(f, b->assoc.afield[i].cval);
+    }
+
+    for (i = 0; e == 0 && i < b->bitacora.nd; i++) {
+        ev = &b->bitacora.event[i];
+        e = crefs_put(f, &ev->mask, sizeof(ev->mask)) || crefs_put(f, &ev->ref_index, sizeof(ev->ref_index))
+            || crefs_put(f, ev->iaux, sizeof(ev->iaux));
+        if (e == 0) {
+            if ((u = crefs_tree_offset(b, ev->pointer)) == BUFRDECO_CREFS_NULL && ev->pointer != NULL)
+                e = 1; // pointer out of the tree, it cannot be stored
+            e = e || crefs_put(f, &u, sizeof(u));
+        }
+        if (e == 0) {
+            u = BUFRDECO_CREFS_NULL;
+            for (j = 0; ev->pointer2 != NULL && j < b->bitmap.nba; j++) {
+                if (b->bitmap.bmap[j] == ev->pointer2) {
+                    u = j;
+                    break;
+                }
+            }
+            // pointer2 is only used when it is a bitmap
+            e = crefs_put(f, &u, sizeof(u));
+        }
+    }
+
+    if (fclose(f) || e || rename(tmp, filename)) {
+        remove(tmp);
+        snprintf(b->error, sizeof(b->error), "%s(): Cannot write compressed references in '%s'\n", __func__, filename);
+        return 1;
+    }
+    return 0;
+}
+
+/*!
+  \fn static int crefs_clean(struct bufrdeco* b)
+  \brief Clean the compressed references partially read from a bad file, so they are parsed from sec4
+  \return 1, to be returned by \ref bufrdeco_read_compressed_references
+*/
+static int crefs_clean(struct bufrdeco* b)
+{
+    b->refs.nd = 0;
+    b->bitacora.nd = 0;
+    b->assoc.nd = 0;
+    bufrdeco_clean_bitmaps(b);
+    return 1;
+}
+
+/*!
+  \fn int bufrdeco_read_compressed_references(struct bufrdeco* b, const char* filename)
+  \brief Read the compressed references, bitacora, bitmaps and associated fields of current compressed BUFR from a file
+  \param [in,out] b pointer to the struct \ref bufrdeco with the BUFR read and its tree already parsed
+  \param [in] filename pathname of file written by \ref bufrdeco_write_compressed_references
+  \return 0 if succeeded, 1 if the file does not exist or is not valid for current BUFR and tables. Then nothing is
+  set in \a b
+*/
+int bufrdeco_read_compressed_references(struct bufrdeco* b, const char* filename)
+{
+    struct bufrdeco_crefs_header h;
+    struct bufrdeco_crefs_source src;
+    struct bufrdeco_crefs_reader r;
+    struct bufrdeco_compressed_ref* rf;
+    struct bufrdeco_decode_subset_event* ev;
+    struct stat st;
+    uint8_t* data;
+    uint32_t u, v;
+    buf_t i;
+    FILE* f;
+    int e;
+
+    bufrdeco_assert_with_return_val(b != NULL && filename != NULL, 1);
+
+    if (b->tree == NULL || b->tree->nseq == 0 || stat(filename, &st) || (size_t)st.st_size < sizeof(h)
+        || crefs_set_source(&src, b))
+        return 1;
+
+    if ((f = fopen(filename, "r")) == NULL)
+        return 1;
+    if ((data = (uint8_t*)malloc((size_t)st.st_size)) == NULL) {
+        fclose(f);
+        return 1;
+    }
+    e = fread(data, (size_t)st.st_size, 1, f) != 1;
+    fclose(f);
+
+    r.data = data;
+    r.size = (size_t)st.st_size;
+    r.pos = 0;
+
+    // check the header
+    if (e || crefs_get(&r, &h, sizeof(h)) || memcmp(h.magic, BUFRDECO_CREFS_MAGIC, sizeof(h.magic)) || h.version != BUFRDECO_CREFS_VERSION
+        || h.byte_order != BUFRDECO_CREFS_BYTE_ORDER || h.hash != bufrdeco_message_hash(b) || h.length != b->sec4.length
+        || h.subsets != b->sec3.subsets || h.tree_size != sizeof(struct bufrdeco_expanded_tree) || h.nseq != b->tree->nseq
+        || h.nrefs == 0 || h.nbitmaps > BUFR_MAX_BITMAPS
+        || h.nassoc > BUFRDECO_MAX_ASSOCIATED_FIELD_STACK * 256 || memcmp(&h.src, &src, sizeof(src))) {
+        free(data);
+        return 1;
+    }
+
+    // make room
+    if (bufrdeco_init_compressed_data_references(&b->refs) || bufrdeco_init_subset_bitacora(b)) {
+        free(data);
+        return 1;
+    }
+    while (b->refs.dim <= h.nrefs) {
+        if (bufrdeco_increase_compressed_ref_array(&b->refs)) {
+            free(data);
+            return crefs_clean(b);
+        }
+    }
+    while (b->bitacora.dim <= h.nevents) {
+        if (bufrdeco_increase_decode_subset_bitacora_array(&b->bitacora)) {
+            free(data);
+            return crefs_clean(b);
+        }
+    }
+
+    for (i = 0, e = 0; e == 0 && i < h.nrefs; i++) {
+        rf = &b->refs.refs[i];
+        e = crefs_get(&r, &rf->bitac, sizeof(rf->bitac)) || crefs_get(&r, &rf->is_associated, sizeof(rf->is_associated))
+            || crefs_get(&r, &rf->has_data, sizeof(rf->has_data)) || crefs_get(&r, &rf->bits, sizeof(rf->bits))
+            || crefs_get(&r, &rf->inc_bits, sizeof(rf->inc_bits)) || crefs_get(&r, &rf->ref, sizeof(rf->ref))
+            || crefs_get(&r, &rf->bit0, sizeof(rf->bit0)) || crefs_get(&r, &rf->ref0, sizeof(rf->ref0))
+            || crefs_get(&r, &rf->escale, sizeof(rf->escale)) || crefs_get(&r, &rf->me, sizeof(buf_t))
+            || crefs_get(&r, &rf->is_bitmaped_by, sizeof(buf_t)) || crefs_get(&r, &rf->bitmap_to, sizeof(buf_t))
+            || crefs_get(&r, &rf->related_to, sizeof(buf_t)) || crefs_get(&r, &rf->qualified_by, sizeof(buf_t))
+            || crefs_get(&r, &rf->replicated_desc, sizeof(buf_t)) || crefs_get(&r, &rf->replicated_loop, sizeof(buf_t))
+            || crefs_get(&r, &rf->replicated_ndesc, sizeof(buf_t)) || crefs_get(&r, &rf->replicated_nloop, sizeof(buf_t))
+            || crefs_get(&r, &rf->associated_to, sizeof(buf_t)) || crefs_get_string(&r, rf->cref0, sizeof(rf->cref0))
+            || crefs_get_string(&r, rf->name, sizeof(rf->name)) || crefs_get_string(&r, rf->unit, sizeof(rf->unit))
+            || crefs_get(&r, &u, sizeof(u)) || crefs_get(&r, &v, sizeof(v));
+        if (e == 0) {
+            rf->desc = (struct bufr_descriptor*)crefs_tree_pointer(b, u, sizeof(struct bufr_descriptor));
+            rf->seq = (struct bufr_sequence*)crefs_tree_pointer(b, v, sizeof(struct bufr_sequence));
+            // every reference has a descriptor, and its event must be in bitacora
+            e = rf->desc == NULL || (rf->seq == NULL && v != BUFRDECO_CREFS_NULL) || rf->bitac < 0
+                || (uint32_t)rf->bitac >= h.nevents;
+        }
+    }
+    b->refs.nd = i;
+
+    for (i = 0; e == 0 && i < h.nbitmaps; i++) {
+        if (bufrdeco_allocate_bitmap(b)) {
+            e = 1;
+            break;
+        }
+        memset(b->bitmap.bmap[i], 0, sizeof(struct bufrdeco_bitmap));
+        e = crefs_get_bitmap(&r, b->bitmap.bmap[i]);
+    }
+
+    for (i = 0; e == 0 && i < h.nassoc; i++) {
+        e = crefs_get(&r, &b->assoc.afield[i].index, sizeof(buf_t))
+            || crefs_get(&r, &b->assoc.afield[i].assoc_bits, sizeof(uint8_t))
+            || crefs_get(&r, &b->assoc.afield[i].val, sizeof(uint8_t))
+            || crefs_get_string(&r, b->assoc.afield[i].cval, BUFR_EXPLAINED_LENGTH);
+    }
+    b->assoc.nd = i;
+
+    for (i = 0; e == 0 && i < h.nevents; i++) {
+        ev = &b->bitacora.event[i];
+        e = crefs_get(&r, &ev->mask, sizeof(ev->mask)) || crefs_get(&r, &ev->ref_index, sizeof(ev->ref_index))
+            || crefs_get(&r, ev->iaux, sizeof(ev->iaux)) || crefs_get(&r, &u, sizeof(u)) || crefs_get(&r, &v, sizeof(v));
+        if (e == 0) {
+            ev->pointer = crefs_tree_pointer(b, u, 1);
+            ev->pointer2 = (v == BUFRDECO_CREFS_NULL || v >= b->bitmap.nba) ? NULL : b->bitmap.bmap[v];
+            e = (ev->pointer == NULL && u != BUFRDECO_CREFS_NULL) || (ev->pointer2 == NULL && v != BUFRDECO_CREFS_NULL)
+                || ev->ref_index >= (int32_t)h.nrefs;
+        }
+    }
+    b->bitacora.nd = i;
+
+    free(data);
+    if (e || r.pos != r.size)
+        return crefs_clean(b);
+
+    // columns and subset data got from previous references are no more valid
+    b->cols.ready = 0;
+    b->cols.seq_ready = 0;
+    return 0;
+}
@@ -123,6 +123,8 @@ int bufrdeco_decode_data_subset ( struct bufrdeco *b )
   // print json output if needed
   if ( b->mask & BUFRDECO_OUTPUT_JSON_SUBSET_DATA )
     bufrdeco_print_json_subset_data ( b );
+  if ( b->mask & BUFRDECO_OUTPUT_NDJSON_SUBSET_DATA )
+    bufrdeco_print_ndjson_subset_data ( b );
 
   // Finally we update the subset counter
   ( b->state.subset ) ++;
@@ -0,0 +1,222 @@
+/***************************************************************************
+ *   Copyright (C) 2013-2026 by Guillermo Ballester Valor                  *
+ *   gbv@ogimet.com                                                        *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.             *
+ ***************************************************************************/
+/*!
+ \file bufrdeco_dedup.c
+ \brief This file has the code of the bounded set of hashes used to skip the messages already seen
+
+ GTS feeds deliver the same bulletin several times by different routes. The hash of sections 1 to 4 of every
+ message, see \ref bufrdeco_message_hash, is checked against a struct \ref bufrdeco_dedup and the exact repeats are
+ skipped before reading tables or expanding the tree. The set can be saved in a file to be used in the next run
+*/
+#include "bufrdeco.h"
+#include <unistd.h>
+
+/*!
+  \def BUFRDECO_DEDUP_BYTE_ORDER
+  \brief Written in native order, to check the file was written by a host with the same byte order
+*/
+#define BUFRDECO_DEDUP_BYTE_ORDER (0x01020304U)
+
+/*!
+  \struct bufrdeco_dedup_header
+  \brief Header of a file with the hashes of a struct \ref bufrdeco_dedup. The hashes follow, the oldest first
+*/
+struct bufrdeco_dedup_header {
+    char magic[8]; /*!< \ref BUFRDECO_DEDUP_MAGIC */
+    uint32_t byte_order; /*!< \ref BUFRDECO_DEDUP_BYTE_ORDER */
+    uint32_t nhashes; /*!< Number of hashes */
+};
+
+/*!
+  \fn int bufrdeco_init_dedup(struct bufrdeco_dedup* d, buf_t size)
+  \brief Allocate a struct \ref bufrdeco_dedup
+  \param [out] d pointer to the target struct
+  \param [in] size Minimum number of hashes remembered. If 0 then \ref BUFRDECO_DEDUP_DEFAULT_SIZE
+  \return 0 if succeeded, 1 otherwise
+*/
+int bufrdeco_init_dedup(struct bufrdeco_dedup* d, buf_t size)
+{
+    bufrdeco_assert_with_return_val(d != NULL, 1);
+
+    bufrdeco_free_dedup(d);
+    if (size == 0)
+        size = BUFRDECO_DEDUP_DEFAULT_SIZE;
+    if (size > (1U << 28))
+        size = 1U << 28;
+
+    // A generation is never filled over a half of its slots
+    d->max = size;
+    for (d->dim = 16; d->dim < 2 * size; d->dim <<= 1)
+        ;
+    if ((d->slot[0] = (uint64_t*)calloc(d->dim, sizeof(uint64_t))) == NULL
+        || (d->slot[1] = (uint64_t*)calloc(d->dim, sizeof(uint64_t))) == NULL) {
+        bufrdeco_free_dedup(d);
+        return 1;
+    }
+    return 0;
+}
+
+/*!
+  \fn int bufrdeco_free_dedup(struct bufrdeco_dedup* d)
+  \brief Free the memory of a struct \ref bufrdeco_dedup
+  \param [in,out] d pointer to the target struct
+  \return 0 if succeeded, 1 otherwise
+*/
+int bufrdeco_free_dedup(struct bufrdeco_dedup* d)
+{
+    bufrdeco_assert_with_return_val(d != NULL, 1);
+
+    free(d->slot[0]);
+    free(d->slot[1]);
+    memset(d, 0, sizeof(struct bufrdeco_dedup));
+    return 0;
+}
+
+/*!
+  \fn static int bufrdeco_dedup_find(const struct bufrdeco_dedup* d, buf_t g, uint64_t hash, buf_t* ix)
+  \brief Find a hash in a generation of a struct \ref bufrdeco_dedup
+  \param [in] d pointer to the struct
+  \param [in] g index of generation
+  \param [in] hash the hash to find, not 0
+  \param [out] ix index of slot with the hash or the free slot where to add it
+  \return 1 if found, 0 otherwise
+*/
+static int bufrdeco_dedup_find(const struct bufrdeco_dedup* d, buf_t g, uint64_t hash, buf_t* ix)
+{
+    buf_t i = (buf_t)(hash ^ (hash >> 32)) & (d->dim - 1);
+
+    while (d->slot[g][i] != 0) {
+        if (d->slot[g][i] == hash) {
+            *ix = i;
+            return 1;
+        }
+        i = (i + 1) & (d->dim - 1);
+    }
+    *ix = i;
+    return 0;
+}
+
+/*!
+  \fn int bufrdeco_dedup_check(struct bufrdeco_dedup* d, uint64_t hash)
+  \brief Check if a hash was already seen and remember it
+  \param [in,out] d pointer to the struct \ref bufrdeco_dedup. If not allocated it is done with default size
+  \param [in] hash the hash of message
+  \return 1 if the hash was already seen, 0 if it is new or the set cannot be allocated
+*/
+int bufrdeco_dedup_check(struct bufrdeco_dedup* d, uint64_t hash)
+{
+    buf_t ix;
+
+    bufrdeco_assert_with_return_val(d != NULL, 0);
+
+    if (d->dim == 0 && bufrdeco_init_dedup(d, 0))
+        return 0;
+
+    if (hash == 0)
+        hash = 1; // 0 is a free slot
+
+    if (bufrdeco_dedup_find(d, d->cur ^ 1, hash, &ix) || bufrdeco_dedup_find(d, d->cur, hash, &ix))
+        return 1;
+
+    if (d->nd[d->cur] >= d->max) {
+        // current generation is full. The older one is forgotten and becomes the current
+        d->cur ^= 1;
+        memset(d->slot[d->cur], 0, d->dim * sizeof(uint64_t));
+        d->nd[d->cur] = 0;
+        bufrdeco_dedup_find(d, d->cur, hash, &ix);
+    }
+    d->slot[d->cur][ix] = hash;
+    d->nd[d->cur]++;
+    return 0;
+}
+
+/*!
+  \fn int bufrdeco_write_dedup(const struct bufrdeco_dedup* d, const char* filename)
+  \brief Write the hashes of a struct \ref bufrdeco_dedup in a file, to read them in next run
+  \param [in] d pointer to the struct
+  \param [in] filename pathname of file. It is written with a temporary name and then renamed
+  \return 0 if succeeded, 1 otherwise
+*/
+int bufrdeco_write_dedup(const struct bufrdeco_dedup* d, const char* filename)
+{
+    struct bufrdeco_dedup_header h;
+    char tmp[BUFRDECO_PATH_LENGTH + 32];
+    buf_t g, i;
+    FILE* f;
+    int e;
+
+    bufrdeco_assert_with_return_val(d != NULL && filename != NULL, 1);
+
+    memset(&h, 0, sizeof(h));
+    strcpy(h.magic, BUFRDECO_DEDUP_MAGIC);
+    h.byte_order = BUFRDECO_DEDUP_BYTE_ORDER;
+    h.nhashes = d->nd[0] + d->nd[1];
+
+    snprintf(tmp, sizeof(tmp), "%s.%ld.tmp", filename, (long)getpid());
+    if ((f = fopen(tmp, "w")) == NULL)
+        return 1;
+
+    e = fwrite(&h, sizeof(h), 1, f) != 1;
+    // the older generation first, so it is the first forgotten when read again
+    for (g = d->cur ^ 1; d->dim && e == 0; g = d->cur) {
+        for (i = 0; e == 0 && i < d->dim; i++) {
+            if (d->slot[g][i])
+                e = fwrite(&d->slot[g][i], sizeof(uint64_t), 1, f) != 1;
+        }
+        if (g == d->cur)
+            break;
+    }
+
+    if (fclose(f) || e || rename(tmp, filename)) {
+        remove(tmp);
+        return 1;
+    }
+    return 0;
+}
+
+/*!
+  \fn int bufrdeco_read_dedup(struct bufrdeco_dedup* d, const char* filename)
+  \brief Add to a struct \ref bufrdeco_dedup the hashes of a file written by \ref bufrdeco_write_dedup
+  \param [in,out] d pointer to the struct. If not allocated it is done with default size
+  \param [in] filename pathname of file
+  \return 0 if succeeded, 1 if the file does not exist or is not valid
+*/
+int bufrdeco_read_dedup(struct bufrdeco_dedup* d, const char* filename)
+{
+    struct bufrdeco_dedup_header h;
+    uint64_t hash;
+    uint32_t i;
+    FILE* f;
+    int e;
+
+    bufrdeco_assert_with_return_val(d != NULL && filename != NULL, 1);
+
+    if ((f = fopen(filename, "r")) == NULL)
+        return 1;
+
+    e = fread(&h, sizeof(h), 1, f) != 1 || memcmp(h.magic, BUFRDECO_DEDUP_MAGIC, sizeof(h.magic))
+        || h.byte_order != BUFRDECO_DEDUP_BYTE_ORDER || (d->dim == 0 && bufrdeco_init_dedup(d, 0));
+    for (i = 0; e == 0 && i < h.nhashes; i++) {
+        if ((e = fread(&hash, sizeof(hash), 1, f) != 1) == 0)
+            bufrdeco_dedup_check(d, hash);
+    }
+    fclose(f);
+    return e;
+}
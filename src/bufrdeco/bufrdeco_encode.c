@@ -0,0 +1,835 @@
+/***************************************************************************
+ *   Copyright (C) 2013-2026 by Guillermo Ballester Valor                  *
+ *   gbv@ogimet.com                                                        *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.             *
+ ***************************************************************************/
+/*!
+ \file bufrdeco_encode.c
+ \brief This file has the code of a minimal BUFR encoder to generate synthetic messages
+
+ The encoder walks the same expanded tree of descriptors the decoder uses (struct \ref bufrdeco_expanded_tree),
+ so the templates are taken from the WMO tables D. Values are pseudo-random but valid: numeric values are in range
+ of the data width, code tables get a value defined in table C and flag tables a defined bit. Every value is also
+ stored as it is expected to be decoded, so the result of the decoder can be checked.
+
+ Supported descriptors are elements, fixed and delayed replication (0 31 000, 0 31 001 and 0 31 002), sequences and
+ the operators 2 01, 2 02, 2 05, 2 07 and 2 08. Other operators are rejected.
+*/
+#include "bufrdeco.h"
+
+/*!
+  \def BUFRDECO_ENCODE_NUMERIC
+  \brief Kind of element for a numeric value
+*/
+#define BUFRDECO_ENCODE_NUMERIC (0)
+
+/*!
+  \def BUFRDECO_ENCODE_CODE_TABLE
+  \brief Kind of element for a code table value
+*/
+#define BUFRDECO_ENCODE_CODE_TABLE (1)
+
+/*!
+  \def BUFRDECO_ENCODE_FLAG_TABLE
+  \brief Kind of element for a flag table value
+*/
+#define BUFRDECO_ENCODE_FLAG_TABLE (2)
+
+/*!
+  \def BUFRDECO_ENCODE_CCITT
+  \brief Kind of element for a CCITT IA5 string
+*/
+#define BUFRDECO_ENCODE_CCITT (3)
+
+/*!
+  \def BUFRDECO_ENCODE_CHARS
+  \brief Chars used in CCITT IA5 values. No spaces, so the decoded strings are the same as encoded
+*/
+#define BUFRDECO_ENCODE_CHARS "ABCDEFGHIJKLMNOPQRSTUVWXYZ0123456789"
+
+static int bufrdeco_encode_descriptors(struct bufrdeco* b, struct bufrdeco_encode* e, struct bufr_sequence* seq, buf_t first, buf_t last);
+
+/*!
+  \fn int bufrdeco_init_encode(struct bufrdeco_encode* e)
+  \brief Init a struct \ref bufrdeco_encode with default options
+  \param [out] e pointer to the target struct
+  \return 0 if succeeded, 1 otherwise
+
+  Defaults are edition 4, latest master version, one uncompressed subset, 4 as max delayed replication and 5% of missing values.
+  The caller has to set the descriptors of sec3 in members \a ndesc and \a unexpanded.
+*/
+int bufrdeco_init_encode(struct bufrdeco_encode* e)
+{
+    if (e == NULL)
+        return 1;
+
+    memset(e, 0, sizeof(struct bufrdeco_encode));
+    e->edition = 4;
+    e->master_version = BUFRDECO_ENCODE_MASTER_VERSION;
+    e->centre = 255; // missing value, as in a generic generator
+    e->subsets = 1;
+    e->max_replications = 4;
+    e->missing_percent = 5;
+    e->seed = 1;
+    e->time = time(NULL);
+    return 0;
+}
+
+/*!
+  \fn int bufrdeco_free_encode(struct bufrdeco_encode* e)
+  \brief Free the memory allocated for expected values in a struct \ref bufrdeco_encode
+  \param [in,out] e pointer to the target struct
+  \return 0 if succeeded, 1 otherwise
+*/
+int bufrdeco_free_encode(struct bufrdeco_encode* e)
+{
+    if (e == NULL)
+        return 1;
+
+    if (e->value != NULL)
+        free(e->value);
+    e->value = NULL;
+    e->dim = 0;
+    e->nv = 0;
+    return 0;
+}
+
+/*!
+  \fn static uint64_t bufrdeco_encode_random(struct bufrdeco_encode* e)
+  \brief xorshift64* pseudo-random generator, so the corpus is reproducible for a given seed
+  \param [in,out] e pointer to the struct \ref bufrdeco_encode with the state in member seed
+  \return A pseudo-random 64 bits integer
+*/
+static uint64_t bufrdeco_encode_random(struct bufrdeco_encode* e)
+{
+    if (e->seed == 0)
+        e->seed = 0x9E3779B97F4A7C15ULL;
+    e->seed ^= e->seed >> 12;
+    e->seed ^= e->seed << 25;
+    e->seed ^= e->seed >> 27;
+    return e->seed * 0x2545F4914F6CDD1DULL;
+}
+
+/*!
+  \fn static uint64_t bufrdeco_encode_random_below(struct bufrdeco_encode* e, uint64_t n)
+  \brief Get a pseudo-random integer in range [0, n)
+  \param [in,out] e pointer to the struct \ref bufrdeco_encode
+  \param [in] n upper limit, not included
+  \return The integer, 0 if n is 0
+*/
+static uint64_t bufrdeco_encode_random_below(struct bufrdeco_encode* e, uint64_t n)
+{
+    if (n == 0)
+        return 0;
+    return bufrdeco_encode_random(e) % n;
+}
+
+/*!
+  \fn static int bufrdeco_encode_put_bits(struct bufrdeco* b, uint32_t val, buf_t nbits)
+  \brief Set the nbits less significant bits of val at current bit offset of sec4 data
+  \param [in,out] b pointer to the active struct \ref bufrdeco
+  \param [in] val value to set
+  \param [in] nbits number of bits, up to 32
+  \return 0 if succeeded, 1 otherwise
+
+  Bytes are cleaned when the first bit is set on them, so the buffer does not need to be cleaned before.
+*/
+static int bufrdeco_encode_put_bits(struct bufrdeco* b, uint32_t val, buf_t nbits)
+{
+    uint8_t* c;
+    buf_t n, room;
+
+    if (nbits > 32 || (b->state.bit_offset + nbits) / 8 + 16 >= BUFR_LEN) {
+        snprintf(b->error, sizeof(b->error), "%s(): Cannot put %u bits in sec4. Consider increase BUFR_LEN\n", __func__, nbits);
+        return 1;
+    }
+
+    while (nbits) {
+        c = &b->sec4.raw[4 + b->state.bit_offset / 8];
+        room = 8 - b->state.bit_offset % 8;
+        if (room == 8)
+            *c = 0;
+        n = (nbits < room) ? nbits : room;
+        *c |= (uint8_t)(((val >> (nbits - n)) & ((1U << n) - 1)) << (room - n));
+        b->state.bit_offset += n;
+        nbits -= n;
+    }
+    return 0;
+}
+
+/*!
+  \fn static int bufrdeco_encode_put_string(struct bufrdeco* b, const char* s, buf_t nchars)
+  \brief Set nchars octets of a string at current bit offset of sec4 data
+  \param [in,out] b pointer to the active struct \ref bufrdeco
+  \param [in] s the string. If NULL then all the bits are set to 1, i.e. missing
+  \param [in] nchars number of octets
+  \return 0 if succeeded, 1 otherwise
+*/
+static int bufrdeco_encode_put_string(struct bufrdeco* b, const char* s, buf_t nchars)
+{
+    buf_t i;
+
+    for (i = 0; i < nchars; i++) {
+        if (bufrdeco_encode_put_bits(b, s == NULL ? 0xFFU : (uint8_t)s[i], 8))
+            return 1;
+    }
+    return 0;
+}
+
+/*!
+  \fn uint32_t bufrdeco_encode_string_hash(const char* s)
+  \brief FNV-1a hash of a string, as stored in member hash of struct \ref bufrdeco_encode_value
+  \param [in] s the string
+  \return The hash
+*/
+uint32_t bufrdeco_encode_string_hash(const char* s)
+{
+    uint32_t hash = 2166136261U;
+
+    while (*s)
+        hash = (hash ^ (uint8_t)(*s++)) * 16777619U;
+    return hash;
+}
+
+/*!
+  \fn static int bufrdeco_encode_add_value(struct bufrdeco* b, struct bufrdeco_encode* e, double val, const char* s, uint32_t mask)
+  \brief Append an expected decoded value to array in a struct \ref bufrdeco_encode
+  \param [in,out] b pointer to the active struct \ref bufrdeco, used to report errors
+  \param [in,out] e pointer to the struct \ref bufrdeco_encode
+  \param [in] val expected numeric value
+  \param [in] s expected string for CCITT IA5 values, NULL otherwise
+  \param [in] mask DESCRIPTOR_VALUE_MISSING or DESCRIPTOR_HAVE_STRING_VALUE bits
+  \return 0 if succeeded, 1 otherwise
+*/
+static int bufrdeco_encode_add_value(struct bufrdeco* b, struct bufrdeco_encode* e, double val, const char* s, uint32_t mask)
+{
+    struct bufrdeco_encode_value* v;
+
+    if (e->nv == e->dim) {
+        e->dim = e->dim ? 2 * e->dim : 4096;
+        if ((v = (struct bufrdeco_encode_value*)realloc(e->value, e->dim * sizeof(struct bufrdeco_encode_value))) == NULL) {
+            snprintf(b->error, sizeof(b->error), "%s(): Cannot allocate memory for expected values\n", __func__);
+            return 1;
+        }
+        e->value = v;
+    }
+
+    v = &e->value[e->nv++];
+    v->val = (mask & DESCRIPTOR_VALUE_MISSING) ? MISSING_REAL : val;
+    v->hash = (s != NULL) ? bufrdeco_encode_string_hash(s) : 0;
+    v->mask = mask;
+    return 0;
+}
+
+/*!
+  \fn static uint32_t bufrdeco_encode_random_raw(struct bufrdeco* b, struct bufrdeco_encode* e, const struct bufr_descriptor* d, int kind, buf_t nbits, int* missing)
+  \brief Get a pseudo-random but valid raw value for an element
+  \param [in] b pointer to the active struct \ref bufrdeco, with the tables
+  \param [in,out] e pointer to the struct \ref bufrdeco_encode
+  \param [in] d the element descriptor
+  \param [in] kind BUFRDECO_ENCODE_NUMERIC, BUFRDECO_ENCODE_CODE_TABLE or BUFRDECO_ENCODE_FLAG_TABLE
+  \param [in] nbits data width
+  \param [out] missing set to 1 if the value is missing, 0 otherwise
+  \return The raw value. All bits set to 1 if missing
+*/
+static uint32_t bufrdeco_encode_random_raw(struct bufrdeco* b, struct bufrdeco_encode* e, const struct bufr_descriptor* d, int kind,
+    buf_t nbits, int* missing)
+{
+    const struct bufr_tableC* tc = &b->tables->c;
+    uint64_t all_ones = (1ULL << nbits) - 1;
+    buf_t i, i0, n;
+
+    // Class 31 values are never missing, the decoder takes them as data
+    *missing = 0;
+    if (d->x != 31 && (uint64_t)bufrdeco_encode_random_below(e, 100) < e->missing_percent) {
+        *missing = 1;
+        return (uint32_t)all_ones;
+    }
+
+    if (kind == BUFRDECO_ENCODE_CODE_TABLE || kind == BUFRDECO_ENCODE_FLAG_TABLE) {
+        // lines in table C for this descriptor are consecutive
+        n = 0;
+        i0 = tc->x_start[d->x] + tc->y_ref[d->x][d->y];
+        if (tc->num[d->x] && i0 < tc->nlines && tc->item[i0].x == d->x && tc->item[i0].y == d->y) {
+            for (i = i0; i < tc->nlines && tc->item[i].x == d->x && tc->item[i].y == d->y; i++) {
+                if (kind == BUFRDECO_ENCODE_CODE_TABLE && tc->item[i].ival < all_ones)
+                    n++;
+                else if (kind == BUFRDECO_ENCODE_FLAG_TABLE && tc->item[i].ival > 0 && tc->item[i].ival < nbits)
+                    n++;
+            }
+        }
+        if (n == 0)
+            return (kind == BUFRDECO_ENCODE_FLAG_TABLE) ? 0 : (uint32_t)bufrdeco_encode_random_below(e, all_ones);
+
+        n = bufrdeco_encode_random_below(e, n);
+        for (i = i0;; i++) {
+            if (kind == BUFRDECO_ENCODE_CODE_TABLE && tc->item[i].ival < all_ones) {
+                if (n-- == 0)
+                    return tc->item[i].ival;
+            } else if (kind == BUFRDECO_ENCODE_FLAG_TABLE && tc->item[i].ival > 0 && tc->item[i].ival < nbits) {
+                // Bit 1 is the most significant one
+                if (n-- == 0)
+                    return 1U << (nbits - tc->item[i].ival);
+            }
+        }
+    }
+
+    // Numeric. All ones is reserved for missing
+    return (uint32_t)bufrdeco_encode_random_below(e, all_ones);
+}
+
+/*!
+  \fn static int bufrdeco_encode_numeric_column(struct bufrdeco* b, const struct bufrdeco_encode* e, const uint32_t* raw, const uint8_t* missing, buf_t nbits)
+  \brief Put the compressed data for a numeric element: R0, NBINC and the increments for every subset
+  \param [in,out] b pointer to the active struct \ref bufrdeco
+  \param [in] e pointer to the struct \ref bufrdeco_encode
+  \param [in] raw array of raw values, one per subset
+  \param [in] missing array of flags, one per subset. 1 if value is missing
+  \param [in] nbits data width
+  \return 0 if succeeded, 1 otherwise
+*/
+static int bufrdeco_encode_numeric_column(struct bufrdeco* b, const struct bufrdeco_encode* e, const uint32_t* raw, const uint8_t* missing,
+    buf_t nbits)
+{
+    uint32_t min = UINT32_MAX, max = 0, inc;
+    buf_t i, nbinc = 0, nmiss = 0;
+
+    for (i = 0; i < e->subsets; i++) {
+        if (missing[i]) {
+            nmiss++;
+            continue;
+        }
+        if (raw[i] < min)
+            min = raw[i];
+        if (raw[i] > max)
+            max = raw[i];
+    }
+
+    // all missing
+    if (nmiss == e->subsets)
+        return bufrdeco_encode_put_bits(b, (uint32_t)((1ULL << nbits) - 1), nbits) || bufrdeco_encode_put_bits(b, 0, 6);
+
+    // An increment with all bits set to 1 is always taken as missing, so it is kept out of valid ones.
+    // If all subsets have the same value then no increments are needed
+    inc = (max == min && nmiss == 0) ? 0 : max - min + 1;
+    while (nbinc < 32 && (inc >> nbinc))
+        nbinc++;
+
+    if (bufrdeco_encode_put_bits(b, min, nbits) || bufrdeco_encode_put_bits(b, nbinc, 6))
+        return 1;
+
+    if (nbinc == 0)
+        return 0;
+
+    for (i = 0; i < e->subsets; i++) {
+        if (bufrdeco_encode_put_bits(b, missing[i] ? (uint32_t)((1ULL << nbinc) - 1) : raw[i] - min, nbinc))
+            return 1;
+    }
+    return 0;
+}
+
+/*!
+  \fn static int bufrdeco_encode_element(struct bufrdeco* b, struct bufrdeco_encode* e, const struct bufr_descriptor* d, const uint32_t* fixed)
+  \brief Encode an element descriptor (f = 0) for current subset, or for all subsets if compressed
+  \param [in,out] b pointer to the active struct \ref bufrdeco
+  \param [in,out] e pointer to the struct \ref bufrdeco_encode
+  \param [in] d the element descriptor
+  \param [in] fixed if not NULL then this value is used for all subsets and it is not random. It is used for delayed replication factors
+  \return 0 if succeeded, 1 otherwise
+*/
+static int bufrdeco_encode_element(struct bufrdeco* b, struct bufrdeco_encode* e, const struct bufr_descriptor* d, const uint32_t* fixed)
+{
+    const struct bufr_tableB_decoded_item* it;
+    const char* unit;
+    char str[BUFR_CVAL_LENGTH];
+    uint32_t raw[BUFR_MAX_SUBSETS];
+    uint8_t missing[BUFR_MAX_SUBSETS];
+    int32_t reference, escale;
+    buf_t i, j, nbits, ns;
+    int kind, miss = 0;
+    double factor;
+
+    if (is_a_local_descriptor(d)) {
+        snprintf(b->error, sizeof(b->error), "%s(): Local descriptor '%s' cannot be encoded\n", __func__, d->c);
+        return 1;
+    }
+
+    i = b->tables->b.x_start[d->x] + b->tables->b.y_ref[d->x][d->y];
+    it = &b->tables->b.item[i];
+    if (b->tables->b.num[d->x] == 0 || it->x != d->x || it->y != d->y) {
+        snprintf(b->error, sizeof(b->error), "%s(): Descriptor '%s' not found in table B\n", __func__, d->c);
+        return 1;
+    }
+
+    ns = e->compressed ? e->subsets : 1;
+    nbits = it->nbits_ori;
+    reference = it->reference_ori;
+    escale = it->scale_ori;
+
+    unit = bufr_strings_get(&b->tables->b.strings, it->unit_ofs);
+    if (strstr(unit, "CCITT") != NULL)
+        kind = BUFRDECO_ENCODE_CCITT;
+    else if (strstr(unit, "CODE TABLE") == unit || strstr(unit, "Code table") == unit)
+        kind = BUFRDECO_ENCODE_CODE_TABLE;
+    else if (strstr(unit, "FLAG") == unit || strstr(unit, "Flag") == unit)
+        kind = BUFRDECO_ENCODE_FLAG_TABLE;
+    else
+        kind = BUFRDECO_ENCODE_NUMERIC;
+
+    if (kind == BUFRDECO_ENCODE_CCITT) {
+        if (b->state.fixed_ccitt)
+            nbits = 8 * b->state.fixed_ccitt;
+        if (nbits % 8 || nbits / 8 >= BUFR_CVAL_LENGTH) {
+            snprintf(b->error, sizeof(b->error), "%s(): Cannot encode %u bits of characters for '%s'\n", __func__, nbits, d->c);
+            return 1;
+        }
+        nbits /= 8; // now they are chars
+
+        // In compressed data R0 has all chars set to 0 and the increments are the whole strings, with NBINC as octets.
+        // NBINC cannot be over 63, so longer strings are set in R0 and are the same for all subsets
+        if (e->compressed && nbits <= 63) {
+            for (j = 0; j < nbits; j++) {
+                if (bufrdeco_encode_put_bits(b, 0, 8))
+                    return 1;
+            }
+            if (bufrdeco_encode_put_bits(b, nbits, 6))
+                return 1;
+        }
+
+        for (i = 0; i < ns; i++) {
+            if (i == 0 || nbits <= 63) {
+                miss = (bufrdeco_encode_random_below(e, 100) < e->missing_percent);
+                for (j = 0; j < nbits; j++)
+                    str[j] = BUFRDECO_ENCODE_CHARS[bufrdeco_encode_random_below(e, sizeof(BUFRDECO_ENCODE_CHARS) - 1)];
+                str[nbits] = '\0';
+                if (bufrdeco_encode_put_string(b, miss ? NULL : str, nbits))
+                    return 1;
+                if (e->compressed && nbits > 63 && bufrdeco_encode_put_bits(b, 0, 6))
+                    return 1;
+            }
+            if (bufrdeco_encode_add_value(b, e, 0.0, miss ? NULL : str, miss ? DESCRIPTOR_VALUE_MISSING : DESCRIPTOR_HAVE_STRING_VALUE))
+                return 1;
+        }
+        return 0;
+    }
+
+    if (kind == BUFRDECO_ENCODE_NUMERIC) {
+        nbits += b->state.added_bit_length;
+        escale += b->state.added_scale;
+        reference += b->state.added_reference;
+        if (b->state.factor_reference > 1)
+            reference *= b->state.factor_reference;
+    }
+
+    if (nbits == 0 || nbits > 32) {
+        snprintf(b->error, sizeof(b->error), "%s(): Cannot encode %u bits for '%s'\n", __func__, nbits, d->c);
+        return 1;
+    }
+
+    for (i = 0; i < ns; i++) {
+        if (fixed != NULL) {
+            raw[i] = *fixed;
+            miss = 0;
+        } else {
+            raw[i] = bufrdeco_encode_random_raw(b, e, d, kind, nbits, &miss);
+        }
+        missing[i] = (uint8_t)miss;
+
+        if (e->compressed == 0 && bufrdeco_encode_put_bits(b, raw[i], nbits))
+            return 1;
+
+        // Expected value, computed as the decoder does
+        if (escale >= 0 && escale < 8)
+            factor = pow10neg[escale];
+        else if (escale < 0 && escale > -8)
+            factor = pow10pos[-escale];
+        else
+            factor = Exp10((double)(-escale));
+        if (bufrdeco_encode_add_value(b, e, (double)((int32_t)raw[i] + reference) * factor, NULL, miss ? DESCRIPTOR_VALUE_MISSING : 0))
+            return 1;
+    }
+
+    if (e->compressed)
+        return bufrdeco_encode_numeric_column(b, e, raw, missing, nbits);
+    return 0;
+}
+
+/*!
+  \fn static int bufrdeco_encode_operator(struct bufrdeco* b, struct bufrdeco_encode* e, const struct bufr_descriptor* d)
+  \brief Apply an operator descriptor (f = 2) to the encoding state
+  \param [in,out] b pointer to the active struct \ref bufrdeco
+  \param [in,out] e pointer to the struct \ref bufrdeco_encode
+  \param [in] d the operator descriptor
+  \return 0 if succeeded, 1 otherwise
+*/
+static int bufrdeco_encode_operator(struct bufrdeco* b, struct bufrdeco_encode* e, const struct bufr_descriptor* d)
+{
+    char str[256];
+    buf_t i, j, ns;
+
+    switch (d->x) {
+    case 1:
+        b->state.added_bit_length = d->y ? d->y - 128 : 0;
+        break;
+
+    case 2:
+        b->state.added_scale = d->y ? d->y - 128 : 0;
+        break;
+
+    case 5:
+        // YYY characters inserted as data. Same for all subsets if compressed
+        ns = e->compressed ? e->subsets : 1;
+        for (j = 0; j < d->y; j++)
+            str[j] = BUFRDECO_ENCODE_CHARS[bufrdeco_encode_random_below(e, sizeof(BUFRDECO_ENCODE_CHARS) - 1)];
+        str[d->y] = '\0';
+        if (d->y >= BUFR_CVAL_LENGTH || bufrdeco_encode_put_string(b, str, d->y) ||
+            (e->compressed && bufrdeco_encode_put_bits(b, 0, 6))) {
+            snprintf(b->error, sizeof(b->error), "%s(): Cannot encode '%s'\n", __func__, d->c);
+            return 1;
+        }
+        for (i = 0; i < ns; i++) {
+            if (bufrdeco_encode_add_value(b, e, 0.0, str, DESCRIPTOR_HAVE_STRING_VALUE))
+                return 1;
+        }
+        break;
+
+    case 7:
+        if (d->y >= 10) {
+            snprintf(b->error, sizeof(b->error), "%s(): Too much %u increase bits for operator '%s'\n", __func__, d->y, d->c);
+            return 1;
+        }
+        if (d->y) {
+            b->state.added_scale = d->y;
+            b->state.factor_reference = pow10pos_int[d->y];
+            b->state.added_bit_length = (int8_t)((10.0 * d->y + 2.0) / 3.0);
+        } else {
+            b->state.added_scale = 0;
+            b->state.factor_reference = 1;
+            b->state.added_bit_length = 0;
+        }
+        break;
+
+    case 8:
+        b->state.fixed_ccitt = d->y;
+        break;
+
+    default:
+        snprintf(b->error, sizeof(b->error), "%s(): Operator '%s' is not supported by the encoder\n", __func__, d->c);
+        return 1;
+    }
+    return 0;
+}
+
+/*!
+  \fn static int bufrdeco_encode_descriptors(struct bufrdeco* b, struct bufrdeco_encode* e, struct bufr_sequence* seq, buf_t first, buf_t last)
+  \brief Encode a range of descriptors of a sequence in the expanded tree, in a recursive way
+  \param [in,out] b pointer to the active struct \ref bufrdeco
+  \param [in,out] e pointer to the struct \ref bufrdeco_encode
+  \param [in] seq the sequence
+  \param [in] first index of first descriptor in sequence
+  \param [in] last index of last descriptor in sequence
+  \return 0 if succeeded, 1 otherwise
+
+  The delayed replication factors are pseudo-random, from 0 to member \a max_replications of struct \ref bufrdeco_encode (0 or 1
+  for 0 31 000). In compressed data they are the same for all subsets.
+*/
+static int bufrdeco_encode_descriptors(struct bufrdeco* b, struct bufrdeco_encode* e, struct bufr_sequence* seq, buf_t first, buf_t last)
+{
+    const struct bufr_descriptor* d;
+    uint32_t nloops;
+    buf_t i, ndesc, loop, ixdel;
+
+    for (i = first; i <= last && i < seq->ndesc; i++) {
+        d = &seq->lseq[i];
+        switch (d->f) {
+        case 0:
+            if (d->x == 31 && (d->y == 11 || d->y == 12)) {
+                snprintf(b->error, sizeof(b->error), "%s(): Data repetition factor '%s' is not supported by the encoder\n", __func__, d->c);
+                return 1;
+            }
+            if (bufrdeco_encode_element(b, e, d, NULL))
+                return 1;
+            break;
+
+        case 1:
+            ndesc = d->x;
+            if (d->y) {
+                ixdel = i;
+                nloops = d->y;
+            } else {
+                // delayed replication factor follows
+                ixdel = i + 1;
+                if (ixdel >= seq->ndesc || !(is_a_delayed_descriptor(&seq->lseq[ixdel]) || is_a_short_delayed_descriptor(&seq->lseq[ixdel]))) {
+                    snprintf(b->error, sizeof(b->error), "%s(): Bad delayed replication after '%s'\n", __func__, d->c);
+                    return 1;
+                }
+                if (is_a_short_delayed_descriptor(&seq->lseq[ixdel]))
+                    nloops = (uint32_t)bufrdeco_encode_random_below(e, 2);
+                else
+                    nloops = (uint32_t)bufrdeco_encode_random_below(e, (uint64_t)e->max_replications + 1);
+                if (bufrdeco_encode_element(b, e, &seq->lseq[ixdel], &nloops))
+                    return 1;
+            }
+            for (loop = 0; loop < nloops; loop++) {
+                if (ndesc && bufrdeco_encode_descriptors(b, e, seq, ixdel + 1, ixdel + ndesc))
+                    return 1;
+            }
+            i = ixdel + ndesc;
+            break;
+
+        case 2:
+            if (bufrdeco_encode_operator(b, e, d))
+                return 1;
+            break;
+
+        case 3:
+            if (seq->sons[i] == NULL || bufrdeco_encode_descriptors(b, e, seq->sons[i], 0, seq->sons[i]->ndesc - 1))
+                return 1;
+            break;
+
+        default:
+            snprintf(b->error, sizeof(b->error), "%s(): Found bad 'f' in descriptor '%s'\n", __func__, d->c);
+            return 1;
+        }
+    }
+    return 0;
+}
+
+/*!
+  \fn static void bufrdeco_encode_clean_state(struct bufrdeco* b)
+  \brief Set the operator state as at the begin of a subset
+  \param [in,out] b pointer to the active struct \ref bufrdeco
+*/
+static void bufrdeco_encode_clean_state(struct bufrdeco* b)
+{
+    b->state.added_bit_length = 0;
+    b->state.added_scale = 0;
+    b->state.added_reference = 0;
+    b->state.factor_reference = 1;
+    b->state.fixed_ccitt = 0;
+    b->state.changing_reference = 255;
+}
+
+/*!
+  \fn int bufrdeco_encode_synthetic(struct bufrdeco* b, struct bufrdeco_encode* e, uint8_t* target, buf_t dim, buf_t* size)
+  \brief Encode a BUFR message with pseudo-random values for a template
+  \param [in,out] b pointer to an initialized struct \ref bufrdeco, used for tables and expanded tree
+  \param [in,out] e pointer to the struct \ref bufrdeco_encode with the options. The expected values are set here
+  \param [out] target buffer where to set the message
+  \param [in] dim size of target
+  \param [out] size bytes of resulting message
+  \return 0 if succeeded, 1 otherwise
+
+  Member \a seed of e is updated, so consecutive calls produce different messages. The struct b is left with the
+  tables and tree of the message, so \ref bufrdeco_reset has to be called before decoding with it.
+*/
+int bufrdeco_encode_synthetic(struct bufrdeco* b, struct bufrdeco_encode* e, uint8_t* target, buf_t dim, buf_t* size)
+{
+    struct tm tim;
+    uint8_t *c, sec1[32];
+    buf_t i, len1, len3, len4, total;
+
+    bufrdeco_assert(b != NULL);
+
+    if (e == NULL || target == NULL || size == NULL) {
+        snprintf(b->error, sizeof(b->error), "%s(): Unspected NULL argument(s)\n", __func__);
+        return 1;
+    }
+
+    if ((e->edition != 3 && e->edition != 4) || e->subsets == 0 || e->subsets > BUFR_MAX_SUBSETS || e->ndesc == 0 ||
+        e->ndesc > BUFR_LEN_UNEXPANDED_DESCRIPTOR) {
+        snprintf(b->error, sizeof(b->error), "%s(): Bad options. Edition %u, %u subsets, %u descriptors\n", __func__, e->edition,
+            e->subsets, e->ndesc);
+        return 1;
+    }
+
+    // Set the sections needed by tables and tree as the reader does
+    gmtime_r(&e->time, &tim);
+    b->sec0.edition = e->edition;
+    b->sec1.master = 0;
+    b->sec1.centre = e->centre;
+    b->sec1.subcentre = e->subcentre;
+    b->sec1.category = e->category;
+    b->sec1.subcategory = e->subcategory;
+    b->sec1.master_version = e->master_version;
+    b->sec1.master_local = 0;
+    b->sec1.year = tim.tm_year + 1900;
+    b->sec1.month = tim.tm_mon + 1;
+    b->sec1.day = tim.tm_mday;
+    b->sec1.hour = tim.tm_hour;
+    b->sec1.minute = tim.tm_min;
+    b->sec1.second = tim.tm_sec;
+    b->sec3.subsets = e->subsets;
+    b->sec3.observed = 1;
+    b->sec3.compressed = e->compressed ? 1 : 0;
+    b->sec3.ndesc = e->ndesc;
+    memcpy(b->sec3.unexpanded, e->unexpanded, e->ndesc * sizeof(struct bufr_descriptor));
+
+    if (bufr_read_tables(b) || bufrdeco_parse_tree(b))
+        return 1;
+
+    // Data in sec4, after its 4 first octets
+    e->nv = 0;
+    b->state.bit_offset = 0;
+    if (e->compressed) {
+        bufrdeco_encode_clean_state(b);
+        if (bufrdeco_encode_descriptors(b, e, &b->tree->seq[0], 0, b->tree->seq[0].ndesc - 1))
+            return 1;
+    } else {
+        for (i = 0; i < e->subsets; i++) {
+            e->first[i] = e->nv;
+            bufrdeco_encode_clean_state(b);
+            if (bufrdeco_encode_descriptors(b, e, &b->tree->seq[0], 0, b->tree->seq[0].ndesc - 1))
+                return 1;
+        }
+        e->first[e->subsets] = e->nv;
+    }
+
+    // Lengths of sections. In edition 3 they have to be even
+    len1 = (e->edition == 3) ? 18 : 22;
+    len3 = 7 + 2 * e->ndesc;
+    len4 = 4 + (b->state.bit_offset + 7) / 8;
+    if (e->edition == 3) {
+        len3 += len3 % 2;
+        len4 += len4 % 2;
+    }
+    total = 8 + len1 + len3 + len4 + 4;
+    if (total > dim || len4 + 4 > BUFR_LEN) {
+        snprintf(b->error, sizeof(b->error), "%s(): Message of %u bytes does not fit in %u bytes\n", __func__, total, dim);
+        return 1;
+    }
+
+    // Pad bits of last octet and the possible pad octet in sec4
+    for (i = (b->state.bit_offset + 7) / 8; i < len4 - 4; i++)
+        b->sec4.raw[4 + i] = 0;
+    if (b->state.bit_offset % 8)
+        b->sec4.raw[4 + b->state.bit_offset / 8] &= (uint8_t)(0xFF << (8 - b->state.bit_offset % 8));
+
+    // sec0
+    c = target;
+    memcpy(c, "BUFR", 4);
+    c[4] = (total >> 16) & 0xFF;
+    c[5] = (total >> 8) & 0xFF;
+    c[6] = total & 0xFF;
+    c[7] = e->edition;
+    c += 8;
+
+    // sec1
+    memset(sec1, 0, sizeof(sec1));
+    sec1[0] = (len1 >> 16) & 0xFF;
+    sec1[1] = (len1 >> 8) & 0xFF;
+    sec1[2] = len1 & 0xFF;
+    sec1[3] = b->sec1.master;
+    if (e->edition == 3) {
+        sec1[4] = e->subcentre & 0xFF;
+        sec1[5] = e->centre & 0xFF;
+        sec1[8] = e->category;
+        sec1[9] = e->subcategory;
+        sec1[10] = e->master_version;
+        sec1[12] = tim.tm_year % 100;
+        sec1[13] = tim.tm_mon + 1;
+        sec1[14] = tim.tm_mday;
+        sec1[15] = tim.tm_hour;
+        sec1[16] = tim.tm_min;
+    } else {
+        sec1[4] = (e->centre >> 8) & 0xFF;
+        sec1[5] = e->centre & 0xFF;
+        sec1[6] = (e->subcentre >> 8) & 0xFF;
+        sec1[7] = e->subcentre & 0xFF;
+        sec1[10] = e->category;
+        sec1[11] = e->subcategory;
+        sec1[12] = 255; // local subcategory not defined
+        sec1[13] = e->master_version;
+        sec1[15] = ((tim.tm_year + 1900) >> 8) & 0xFF;
+        sec1[16] = (tim.tm_year + 1900) & 0xFF;
+        sec1[17] = tim.tm_mon + 1;
+        sec1[18] = tim.tm_mday;
+        sec1[19] = tim.tm_hour;
+        sec1[20] = tim.tm_min;
+        sec1[21] = tim.tm_sec;
+    }
+    memcpy(c, sec1, len1);
+    c += len1;
+
+    // sec3
+    memset(c, 0, len3);
+    c[0] = (len3 >> 16) & 0xFF;
+    c[1] = (len3 >> 8) & 0xFF;
+    c[2] = len3 & 0xFF;
+    c[4] = (e->subsets >> 8) & 0xFF;
+    c[5] = e->subsets & 0xFF;
+    c[6] = 0x80 | (e->compressed ? 0x40 : 0);
+    for (i = 0; i < e->ndesc; i++) {
+        c[7 + 2 * i] = (uint8_t)((e->unexpanded[i].f << 6) | e->unexpanded[i].x);
+        c[8 + 2 * i] = e->unexpanded[i].y;
+    }
+    c += len3;
+
+    // sec4
+    b->sec4.raw[0] = (len4 >> 16) & 0xFF;
+    b->sec4.raw[1] = (len4 >> 8) & 0xFF;
+    b->sec4.raw[2] = len4 & 0xFF;
+    b->sec4.raw[3] = 0;
+    memcpy(c, b->sec4.raw, len4);
+    c += len4;
+
+    // sec5
+    memcpy(c, "7777", 4);
+    *size = total;
+    return 0;
+}
+
+/*!
+  \fn const struct bufrdeco_encode_value* bufrdeco_encode_get_value(const struct bufrdeco_encode* e, buf_t subset, buf_t index)
+  \brief Get the expected decoded value of a subset
+  \param [in] e pointer to the struct \ref bufrdeco_encode used to encode the message
+  \param [in] subset index of subset
+  \param [in] index index of data in subset, as in struct \ref bufrdeco_subset_sequence_data
+  \return A pointer to the expected value, NULL if out of range
+*/
+const struct bufrdeco_encode_value* bufrdeco_encode_get_value(const struct bufrdeco_encode* e, buf_t subset, buf_t index)
+{
+    if (e == NULL || subset >= e->subsets)
+        return NULL;
+
+    if (e->compressed) {
+        // values are stored for all subsets of an element in a row
+        if ((index + 1) * e->subsets > e->nv)
+            return NULL;
+        return &e->value[index * e->subsets + subset];
+    }
+
+    if (e->first[subset] + index >= e->first[subset + 1])
+        return NULL;
+    return &e->value[e->first[subset] + index];
+}
+
+/*!
+  \fn buf_t bufrdeco_encode_values_in_subset(const struct bufrdeco_encode* e, buf_t subset)
+  \brief Get the number of expected decoded values of a subset
+  \param [in] e pointer to the struct \ref bufrdeco_encode used to encode the message
+  \param [in] subset index of subset
+  \return The number of values
+*/
+buf_t bufrdeco_encode_values_in_subset(const struct bufrdeco_encode* e, buf_t subset)
+{
+    if (e == NULL || subset >= e->subsets)
+        return 0;
+    if (e->compressed)
+        return e->nv / e->subsets;
+    return e->first[subset + 1] - e->first[subset];
+}
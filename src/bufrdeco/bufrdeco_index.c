@@ -0,0 +1,552 @@
+/***************************************************************************
+ *   Copyright (C) 2013-2026 by Guillermo Ballester Valor                  *
+ *   gbv@ogimet.com                                                        *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.             *
+ ***************************************************************************/
+/*!
+ \file bufrdeco_index.c
+ \brief This file has the code to build and use an index of all the subsets of an archive with many BUFR messages
+
+ The index has, for every message, its place in archive and the keys of sec1, and for every subset its station or
+ platform identifier, its time and, in uncompressed messages, the bit offset of its data. The subsets are sorted by
+ identifier and time, so a subset is found with a binary search and decoded without scanning the archive nor the
+ previous subsets. The data of a subset of a compressed message is got from the compressed references of the message,
+ without decoding the other subsets, so no offset is needed for them
+*/
+#include "bufrdeco.h"
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+
+/*!
+  \struct bufrdeco_index_builder
+  \brief Arrays of messages and subsets while building an index
+*/
+struct bufrdeco_index_builder {
+    struct bufrdeco_index_message* msg; /*!< Array of messages */
+    uint32_t nmsg; /*!< Used messages */
+    uint32_t dmsg; /*!< Allocated messages */
+    struct bufrdeco_index_subset* sub; /*!< Array of subsets */
+    uint64_t nsub; /*!< Used subsets */
+    uint64_t dsub; /*!< Allocated subsets */
+};
+
+/*!
+  \fn uint32_t bufrdeco_index_template_hash(const struct bufr_sec3* s3)
+  \brief FNV-1a hash of the unexpanded descriptors of a sec3, used to know which messages share a template
+  \param [in] s3 pointer to the parsed struct \ref bufr_sec3
+  \return The hash
+*/
+uint32_t bufrdeco_index_template_hash(const struct bufr_sec3* s3)
+{
+    uint32_t hash = 2166136261U;
+    buf_t i;
+
+    for (i = 0; i < s3->ndesc; i++) {
+        hash = (hash ^ s3->unexpanded[i].f) * 16777619U;
+        hash = (hash ^ s3->unexpanded[i].x) * 16777619U;
+        hash = (hash ^ s3->unexpanded[i].y) * 16777619U;
+    }
+    return hash;
+}
+
+/*!
+  \fn static int bufrdeco_index_subset_keys(const struct bufrdeco* b, struct bufrdeco_index_subset* r)
+  \brief Set the identifier and time of a subset from its decoded data
+  \param [in] b pointer to the struct \ref bufrdeco with current subset decoded in member \a seq
+  \param [out] r pointer to the target struct \ref bufrdeco_index_subset
+  \return 0 if an identifier was found, 1 otherwise
+
+  The identifier is, by preference, the WMO block and station number (0 01 001 and 0 01 002) as '08221', a numeric
+  buoy or marine platform number (0 01 087, 0 01 005), a ship or aircraft identifier (0 01 011, 0 01 006, 0 01 008)
+  or the WIGOS identifier (0 01 125 to 0 01 128) as '0-20000-0-08221'. The time is the first one got from
+  0 04 001 to 0 04 006, with the missing items from sec1
+*/
+static int bufrdeco_index_subset_keys(const struct bufrdeco* b, struct bufrdeco_index_subset* r)
+{
+    const struct bufr_atom_data* a;
+    const struct bufr_atom_data* id[8] = { NULL };
+    int tv[6], got[6] = { 0 };
+    struct tm tim;
+    buf_t i;
+    char aux[BUFR_CVAL_LENGTH];
+
+    for (i = 0; i < b->seq.nd; i++) {
+        a = &(b->seq.sequence[i]);
+        if (a->desc.f || (a->mask & DESCRIPTOR_VALUE_MISSING))
+            continue;
+        if (a->desc.x == 4 && a->desc.y >= 1 && a->desc.y <= 6 && got[a->desc.y - 1] == 0) {
+            tv[a->desc.y - 1] = (int)a->val;
+            got[a->desc.y - 1] = 1;
+        } else if (a->desc.x == 1) {
+            switch (a->desc.y) {
+            case 1:
+                if (id[0] == NULL)
+                    id[0] = a;
+                break;
+            case 2:
+                if (id[1] == NULL)
+                    id[1] = a;
+                break;
+            case 87:
+            case 5:
+                if (id[2] == NULL)
+                    id[2] = a;
+                break;
+            case 11:
+            case 6:
+            case 8:
+                if (id[3] == NULL)
+                    id[3] = a;
+                break;
+            case 125:
+            case 126:
+            case 127:
+            case 128:
+                if (id[4 + a->desc.y - 125] == NULL)
+                    id[4 + a->desc.y - 125] = a;
+                break;
+            default:
+                break;
+            }
+        }
+    }
+
+    // Time
+    memset(&tim, 0, sizeof(tim));
+    tim.tm_year = (got[0] ? tv[0] : (int)b->sec1.year) - 1900;
+    tim.tm_mon = (got[1] ? tv[1] : (int)b->sec1.month) - 1;
+    tim.tm_mday = got[2] ? tv[2] : (int)b->sec1.day;
+    tim.tm_hour = got[3] ? tv[3] : (int)b->sec1.hour;
+    tim.tm_min = got[4] ? tv[4] : (int)b->sec1.minute;
+    tim.tm_sec = got[5] ? tv[5] : 0;
+    r->time = (int64_t)timegm(&tim);
+
+    // Identifier
+    r->ident[0] = '\0';
+    if (id[0] != NULL && id[1] != NULL) {
+        snprintf(r->ident, sizeof(r->ident), "%02u%03u", (uint32_t)id[0]->val, (uint32_t)id[1]->val);
+    } else if (id[2] != NULL) {
+        snprintf(r->ident, sizeof(r->ident), "%u", (uint32_t)id[2]->val);
+    } else if (id[3] != NULL && (id[3]->mask & DESCRIPTOR_HAVE_STRING_VALUE)) {
+        strcpy_safe(aux, id[3]->cval);
+        snprintf(r->ident, sizeof(r->ident), "%s", bufr_adjust_string(aux));
+    } else if (id[4] != NULL && id[5] != NULL && id[6] != NULL && id[7] != NULL && (id[7]->mask & DESCRIPTOR_HAVE_STRING_VALUE)) {
+        strcpy_safe(aux, id[7]->cval);
+        snprintf(r->ident, sizeof(r->ident), "%u-%u-%u-%s", (uint32_t)id[4]->val, (uint32_t)id[5]->val,
+            (uint32_t)id[6]->val, bufr_adjust_string(aux));
+    }
+    return r->ident[0] ? 0 : 1;
+}
+
+/*!
+  \fn static int bufrdeco_index_subset_cmp(const void* a, const void* b)
+  \brief Compare two struct \ref bufrdeco_index_subset by identifier, time, message and subset
+*/
+static int bufrdeco_index_subset_cmp(const void* a, const void* b)
+{
+    const struct bufrdeco_index_subset* sa = (const struct bufrdeco_index_subset*)a;
+    const struct bufrdeco_index_subset* sb = (const struct bufrdeco_index_subset*)b;
+    int c;
+
+    if ((c = strncmp(sa->ident, sb->ident, BUFRDECO_INDEX_IDENT_LENGTH)) != 0)
+        return c;
+    if (sa->time != sb->time)
+        return sa->time < sb->time ? -1 : 1;
+    if (sa->message != sb->message)
+        return sa->message < sb->message ? -1 : 1;
+    if (sa->subset != sb->subset)
+        return sa->subset < sb->subset ? -1 : 1;
+    return 0;
+}
+
+/*!
+  \fn static int bufrdeco_index_add_message(struct bufrdeco* b, struct bufrdeco_index_builder* ib, uint64_t offset)
+  \brief Add the message already read in \a b and all its subsets to an index being built
+  \param [in,out] b pointer to the struct \ref bufrdeco with the message read
+  \param [in,out] ib pointer to the struct \ref bufrdeco_index_builder
+  \param [in] offset byte offset of message in archive
+  \return 0 if succeeded, 1 if cannot allocate memory. Subsets which cannot be decoded are not added
+*/
+static int bufrdeco_index_add_message(struct bufrdeco* b, struct bufrdeco_index_builder* ib, uint64_t offset)
+{
+    struct bufrdeco_index_message* m;
+    struct bufrdeco_index_subset* r;
+    void* p;
+    buf_t ss;
+
+    if (ib->nmsg == ib->dmsg) {
+        if ((p = realloc(ib->msg, (ib->dmsg ? 2 * (size_t)ib->dmsg : 256) * sizeof(struct bufrdeco_index_message))) == NULL)
+            return 1;
+        ib->msg = (struct bufrdeco_index_message*)p;
+        ib->dmsg = ib->dmsg ? 2 * ib->dmsg : 256;
+    }
+    m = &(ib->msg[ib->nmsg]);
+    memset(m, 0, sizeof(struct bufrdeco_index_message));
+    m->offset = offset;
+    m->length = b->sec0.bufr_length;
+    m->template_hash = bufrdeco_index_template_hash(&b->sec3);
+    m->nsubsets = b->sec3.subsets;
+    m->centre = (uint16_t)b->sec1.centre;
+    m->subcentre = (uint16_t)b->sec1.subcentre;
+    m->year = (uint16_t)b->sec1.year;
+    m->month = (uint8_t)b->sec1.month;
+    m->day = (uint8_t)b->sec1.day;
+    m->hour = (uint8_t)b->sec1.hour;
+    m->minute = (uint8_t)b->sec1.minute;
+    m->second = (uint8_t)b->sec1.second;
+    m->edition = b->sec0.edition;
+    m->master_version = (uint8_t)b->sec1.master_version;
+    m->master_local = (uint8_t)b->sec1.master_local;
+    m->category = (uint8_t)b->sec1.category;
+    m->subcategory = (uint8_t)b->sec1.subcategory;
+    m->subcategory_local = (uint8_t)b->sec1.subcategory_local;
+    m->compressed = b->sec3.compressed;
+
+    if (bufrdeco_parse_tree(b) == 0) {
+        for (ss = 0; ss < b->sec3.subsets; ss++) {
+            if (bufrdeco_get_target_subset_sequence_data(ss, b) == NULL)
+                break;
+            if (ib->nsub == ib->dsub) {
+                if ((p = realloc(ib->sub, (ib->dsub ? 2 * ib->dsub : 4096) * sizeof(struct bufrdeco_index_subset))) == NULL)
+                    return 1;
+                ib->sub = (struct bufrdeco_index_subset*)p;
+                ib->dsub = ib->dsub ? 2 * ib->dsub : 4096;
+            }
+            r = &(ib->sub[ib->nsub++]);
+            memset(r, 0, sizeof(struct bufrdeco_index_subset));
+            bufrdeco_index_subset_keys(b, r);
+            r->message = ib->nmsg;
+            r->subset = ss;
+            // Every uncompressed subset decoded has its offset, the decoder fails for subsets over BUFR_MAX_SUBSETS
+            if (b->sec3.compressed == 0 && ss < BUFR_MAX_SUBSETS)
+                r->bit_offset = b->offsets.ofs[ss];
+        }
+    }
+    ib->nmsg++;
+    return 0;
+}
+
+/*!
+  \fn int bufrdeco_index_build(struct bufrdeco* b, const char* archive, const char* filename)
+  \brief Build the index file of an archive with many BUFR messages
+  \param [in,out] b pointer to an inited struct \ref bufrdeco, with the tables dir and mask set by caller
+  \param [in] archive pathname of the archive
+  \param [in] filename pathname of the index file to write
+  \return 0 if succeeded, 1 otherwise
+
+  Every sequence of bytes from 'BUFR' with the length declared in sec0 and ending with '7777' is a message, so
+  GTS headers among them are skipped. All the subsets of every message are decoded once to get their keys
+*/
+int bufrdeco_index_build(struct bufrdeco* b, const char* archive, const char* filename)
+{
+    struct bufrdeco_index_builder ib;
+    struct bufrdeco_index_header h;
+    struct stat st;
+    uint8_t* data;
+    size_t i, len;
+    FILE* f;
+    int fd, res = 1;
+
+    bufrdeco_assert_with_return_val(b != NULL && archive != NULL && filename != NULL, 1);
+
+    if ((fd = open(archive, O_RDONLY)) < 0 || fstat(fd, &st) < 0) {
+        snprintf(b->error, sizeof(b->error), "%s(): Cannot open archive '%s'\n", __func__, archive);
+        if (fd >= 0)
+            close(fd);
+        return 1;
+    }
+    if (st.st_size < 8) {
+        snprintf(b->error, sizeof(b->error), "%s(): Archive '%s' has not BUFR messages\n", __func__, archive);
+        close(fd);
+        return 1;
+    }
+    // private writable map because bufrdeco_read_buffer() does not take a const buffer
+    data = (uint8_t*)mmap(NULL, st.st_size, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (data == MAP_FAILED) {
+        snprintf(b->error, sizeof(b->error), "%s(): Cannot map archive '%s'\n", __func__, archive);
+        return 1;
+    }
+
+    memset(&ib, 0, sizeof(ib));
+    for (i = 0; i + 8 <= (size_t)st.st_size; i++) {
+        if (memcmp(data + i, "BUFR", 4))
+            continue;
+        len = three_bytes_to_uint32(data + i + 4);
+        if (len < 8 || i + len > (size_t)st.st_size || memcmp(data + i + len - 4, "7777", 4))
+            continue;
+
+        bufrdeco_reset(b);
+        if (bufrdeco_read_buffer(b, data + i, len) == 0 && bufrdeco_index_add_message(b, &ib, i)) {
+            snprintf(b->error, sizeof(b->error), "%s(): Cannot allocate memory for index\n", __func__);
+            goto end;
+        }
+        i += len - 1;
+    }
+    bufrdeco_reset(b);
+
+    if (ib.nsub)
+        qsort(ib.sub, ib.nsub, sizeof(struct bufrdeco_index_subset), bufrdeco_index_subset_cmp);
+
+    memset(&h, 0, sizeof(h));
+    memcpy(h.magic, BUFRDECO_INDEX_MAGIC, sizeof(BUFRDECO_INDEX_MAGIC));
+    h.version = BUFRDECO_INDEX_VERSION;
+    h.byte_order = BUFRDECO_INDEX_BYTE_ORDER;
+    h.header_size = sizeof(struct bufrdeco_index_header);
+    h.message_size = sizeof(struct bufrdeco_index_message);
+    h.subset_size = sizeof(struct bufrdeco_index_subset);
+    h.nmessages = ib.nmsg;
+    h.nsubsets = ib.nsub;
+    h.messages_offset = sizeof(struct bufrdeco_index_header);
+    h.subsets_offset = h.messages_offset + (uint64_t)ib.nmsg * sizeof(struct bufrdeco_index_message);
+    h.archive_size = st.st_size;
+    h.archive_mtime = st.st_mtime;
+
+    if ((f = fopen(filename, "wb")) == NULL) {
+        snprintf(b->error, sizeof(b->error), "%s(): Cannot open '%s' to write\n", __func__, filename);
+        goto end;
+    }
+    if (fwrite(&h, sizeof(h), 1, f) != 1 || fwrite(ib.msg, sizeof(struct bufrdeco_index_message), ib.nmsg, f) != ib.nmsg
+        || fwrite(ib.sub, sizeof(struct bufrdeco_index_subset), ib.nsub, f) != ib.nsub) {
+        snprintf(b->error, sizeof(b->error), "%s(): Cannot write index '%s'\n", __func__, filename);
+        fclose(f);
+        goto end;
+    }
+    if (fclose(f) == 0)
+        res = 0;
+    else
+        snprintf(b->error, sizeof(b->error), "%s(): Cannot write index '%s'\n", __func__, filename);
+
+end:
+    munmap(data, st.st_size);
+    if (ib.msg != NULL)
+        free((void*)ib.msg);
+    if (ib.sub != NULL)
+        free((void*)ib.sub);
+    return res;
+}
+
+/*!
+  \fn static void* bufrdeco_index_map_file(const char* filename, size_t* size, int writable, time_t* mtime)
+  \brief Map a whole file in memory
+  \param [in] filename pathname of the file
+  \param [out] size size of file
+  \param [in] writable if != 0 the map is private and writable
+  \param [out] mtime if not NULL, modification time of file
+  \return Pointer to the map, NULL if failed
+*/
+static void* bufrdeco_index_map_file(const char* filename, size_t* size, int writable, time_t* mtime)
+{
+    struct stat st;
+    void* map;
+    int fd;
+
+    if ((fd = open(filename, O_RDONLY)) < 0)
+        return NULL;
+    if (fstat(fd, &st) < 0 || st.st_size == 0) {
+        close(fd);
+        return NULL;
+    }
+    map = mmap(NULL, st.st_size, writable ? PROT_READ | PROT_WRITE : PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (map == MAP_FAILED)
+        return NULL;
+    *size = st.st_size;
+    if (mtime != NULL)
+        *mtime = st.st_mtime;
+    return map;
+}
+
+/*!
+  \fn int bufrdeco_index_open(struct bufrdeco_index* idx, const char* filename, const char* archive)
+  \brief Map an index file and, optionally, its archive
+  \param [out] idx pointer to the target struct \ref bufrdeco_index
+  \param [in] filename pathname of the index file
+  \param [in] archive pathname of the archive. If NULL the subsets can be found but not decoded
+  \return 0 if succeeded, 1 if cannot map the files, the index is not valid or the archive changed after the index was built
+*/
+int bufrdeco_index_open(struct bufrdeco_index* idx, const char* filename, const char* archive)
+{
+    const struct bufrdeco_index_header* h;
+    time_t mtime;
+
+    bufrdeco_assert_with_return_val(idx != NULL && filename != NULL, 1);
+
+    memset(idx, 0, sizeof(struct bufrdeco_index));
+    if ((idx->map = bufrdeco_index_map_file(filename, &idx->size, 0, NULL)) == NULL)
+        return 1;
+
+    // Checks of layout
+    h = (const struct bufrdeco_index_header*)idx->map;
+    if (idx->size < sizeof(struct bufrdeco_index_header) || memcmp(h->magic, BUFRDECO_INDEX_MAGIC, sizeof(BUFRDECO_INDEX_MAGIC))
+        || h->version != BUFRDECO_INDEX_VERSION || h->byte_order != BUFRDECO_INDEX_BYTE_ORDER
+        || h->header_size != sizeof(struct bufrdeco_index_header) || h->message_size != sizeof(struct bufrdeco_index_message)
+        || h->subset_size != sizeof(struct bufrdeco_index_subset)
+        || h->messages_offset + (uint64_t)h->nmessages * sizeof(struct bufrdeco_index_message) > idx->size
+        || h->subsets_offset + h->nsubsets * sizeof(struct bufrdeco_index_subset) > idx->size) {
+        bufrdeco_index_close(idx);
+        return 1;
+    }
+    idx->header = h;
+    idx->msg = (const struct bufrdeco_index_message*)((const uint8_t*)idx->map + h->messages_offset);
+    idx->sub = (const struct bufrdeco_index_subset*)((const uint8_t*)idx->map + h->subsets_offset);
+
+    if (archive != NULL) {
+        strcpy_safe(idx->archive, archive);
+        // private writable map because bufrdeco_read_buffer() does not take a const buffer
+        if ((idx->data = (uint8_t*)bufrdeco_index_map_file(archive, &idx->data_size, 1, &mtime)) == NULL
+            || idx->data_size != h->archive_size || (int64_t)mtime != h->archive_mtime) {
+            bufrdeco_index_close(idx);
+            return 1;
+        }
+    }
+    return 0;
+}
+
+/*!
+  \fn int bufrdeco_index_close(struct bufrdeco_index* idx)
+  \brief Unmap the files of a struct \ref bufrdeco_index
+  \param [in,out] idx pointer to the struct \ref bufrdeco_index
+  \return 0 if succeeded
+*/
+int bufrdeco_index_close(struct bufrdeco_index* idx)
+{
+    bufrdeco_assert(idx != NULL);
+
+    if (idx->map != NULL)
+        munmap(idx->map, idx->size);
+    if (idx->data != NULL)
+        munmap((void*)idx->data, idx->data_size);
+    memset(idx, 0, sizeof(struct bufrdeco_index));
+    return 0;
+}
+
+/*!
+  \fn static uint64_t bufrdeco_index_lower_bound(const struct bufrdeco_index* idx, const char* ident, int64_t t)
+  \brief Get the first subset in index with identifier and time not lower than the given ones
+*/
+static uint64_t bufrdeco_index_lower_bound(const struct bufrdeco_index* idx, const char* ident, int64_t t)
+{
+    uint64_t lo = 0, hi = idx->header->nsubsets, mid;
+    int c;
+
+    while (lo < hi) {
+        mid = lo + (hi - lo) / 2;
+        c = strncmp(idx->sub[mid].ident, ident, BUFRDECO_INDEX_IDENT_LENGTH);
+        if (c < 0 || (c == 0 && idx->sub[mid].time < t))
+            lo = mid + 1;
+        else
+            hi = mid;
+    }
+    return lo;
+}
+
+/*!
+  \fn int bufrdeco_index_find(const struct bufrdeco_index* idx, const char* ident, int64_t from, int64_t to, uint64_t* first, uint64_t* count)
+  \brief Find the subsets of a station or platform in a time interval
+  \param [in] idx pointer to an opened struct \ref bufrdeco_index
+  \param [in] ident identifier of station or platform, as '08221'
+  \param [in] from first time, in seconds since epoch (UTC)
+  \param [in] to last time, in seconds since epoch (UTC). Use \a from to get a single time
+  \param [out] first index of the first subset found in array \a sub of \a idx
+  \param [out] count number of subsets found, which are consecutive in array \a sub of \a idx
+  \return 0 if some subset was found, 1 otherwise
+*/
+int bufrdeco_index_find(const struct bufrdeco_index* idx, const char* ident, int64_t from, int64_t to, uint64_t* first, uint64_t* count)
+{
+    uint64_t last;
+
+    bufrdeco_assert_with_return_val(idx != NULL && idx->header != NULL && ident != NULL && first != NULL && count != NULL, 1);
+
+    *first = bufrdeco_index_lower_bound(idx, ident, from);
+    last = (to < INT64_MAX) ? bufrdeco_index_lower_bound(idx, ident, to + 1) : *first;
+    if (to == INT64_MAX) {
+        while (last < idx->header->nsubsets && strncmp(idx->sub[last].ident, ident, BUFRDECO_INDEX_IDENT_LENGTH) == 0)
+            last++;
+    }
+    *count = (last > *first) ? last - *first : 0;
+    return *count ? 0 : 1;
+}
+
+/*!
+  \fn static int bufrdeco_index_is_current(const struct bufrdeco* b, const uint8_t* data, size_t length)
+  \brief Check if a message is the one already read and parsed in a struct \ref bufrdeco
+  \param [in] b pointer to the struct \ref bufrdeco
+  \param [in] data the message, from 'BUFR' to '7777'
+  \param [in] length length of message
+  \return 1 if it is the current message, 0 otherwise
+
+  Sections 0, 3 and 4 are compared. Section 4 is at the end of message, just before '7777', and section 3 just before it
+*/
+static int bufrdeco_index_is_current(const struct bufrdeco* b, const uint8_t* data, size_t length)
+{
+    const uint8_t* c;
+
+    if (b->tree == NULL || b->tree->nseq == 0 || b->sec0.bufr_length != length || memcmp(b->sec0.raw, data, 8)
+        || (size_t)b->sec4.length + b->sec3.length + 12 > length)
+        return 0;
+    c = data + length - 4 - b->sec4.length;
+    if (memcmp(b->sec4.raw, c, b->sec4.length) || memcmp(b->sec3.raw, c - b->sec3.length, b->sec3.length))
+        return 0;
+    return 1;
+}
+
+/*!
+  \fn struct bufrdeco_subset_sequence_data* bufrdeco_index_get_subset(struct bufrdeco* b, const struct bufrdeco_index* idx, const struct bufrdeco_index_subset* s)
+  \brief Decode a subset found in an index
+  \param [in,out] b pointer to an inited struct \ref bufrdeco, with the tables dir and mask set by caller
+  \param [in] idx pointer to a struct \ref bufrdeco_index opened with its archive
+  \param [in] s pointer to the subset in array \a sub of \a idx
+  \return Pointer to the member \a seq of \a b with the subset data, NULL if failed
+
+  The message is read from the mapped archive. If it is the same as the one already in \a b it is not read again.
+  For uncompressed messages the bit offset of the subset is got from the index, so the previous subsets are not decoded.
+  For compressed messages there is no bit offset of a subset: the compressed references of message are parsed once,
+  or read from the cache set by \ref bufrdeco_set_compressed_references_dir, and then any subset is got from them
+*/
+struct bufrdeco_subset_sequence_data* bufrdeco_index_get_subset(struct bufrdeco* b, const struct bufrdeco_index* idx, const struct bufrdeco_index_subset* s)
+{
+    const struct bufrdeco_index_message* m;
+
+    bufrdeco_assert_with_return_val(b != NULL && idx != NULL && s != NULL, NULL);
+
+    if (idx->data == NULL || s->message >= idx->header->nmessages) {
+        snprintf(b->error, sizeof(b->error), "%s(): Index without archive or bad message\n", __func__);
+        return NULL;
+    }
+    m = &(idx->msg[s->message]);
+    if (m->offset + m->length > idx->data_size) {
+        snprintf(b->error, sizeof(b->error), "%s(): Message out of archive\n", __func__);
+        return NULL;
+    }
+
+    // Read the message if not the current one
+    if (bufrdeco_index_is_current(b, idx->data + m->offset, m->length) == 0) {
+        bufrdeco_reset(b);
+        strcpy_safe(b->header.filename, idx->archive);
+        if (bufrdeco_read_buffer(b, idx->data + m->offset, m->length) || bufrdeco_parse_tree(b))
+            return NULL;
+    }
+
+    if (m->compressed == 0 && s->subset && s->subset < BUFR_MAX_SUBSETS && s->bit_offset) {
+        b->offsets.ofs[s->subset] = s->bit_offset;
+        if (b->offsets.nr <= s->subset)
+            b->offsets.nr = s->subset + 1;
+    }
+    return bufrdeco_get_target_subset_sequence_data(s->subset, b);
+}
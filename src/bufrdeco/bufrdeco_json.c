@@ -20,31 +20,184 @@
 /*!
  \file bufrdeco_json.c
  \brief This file has the code which functions to print BUFR data in json format
+
+ The functions bufrdeco_out_json_* append to a struct \ref bufrdeco_output_buffer. The functions bufrdeco_print_json_*
+ with a FILE argument use a local buffer which is written to the stream at the end
 */
 #include "bufrdeco.h"
 
+/*!
+ * \fn static buf_t bufrdeco_out_descriptor ( struct bufrdeco_output_buffer *ob, uint8_t f, uint8_t x, uint8_t y )
+ * \brief Append a descriptor as "f xx yyy"
+ */
+static buf_t bufrdeco_out_descriptor ( struct bufrdeco_output_buffer *ob, uint8_t f, uint8_t x, uint8_t y )
+{
+  buf_t used = 0;
+
+  used += bufrdeco_out_uint ( ob, f, 0 );
+  used += bufrdeco_out_putc ( ob, ' ' );
+  used += bufrdeco_out_uint ( ob, x, 2 );
+  used += bufrdeco_out_putc ( ob, ' ' );
+  used += bufrdeco_out_uint ( ob, y, 3 );
+  return used;
+}
+
+/*!
+ * \fn static buf_t bufrdeco_out_json_field_ref ( struct bufrdeco_output_buffer *ob, const char *key, buf_t ss, buf_t index )
+ * \brief Append a key with a reference to a data field as ,"key":"#ss_index"
+ */
+static buf_t bufrdeco_out_json_field_ref ( struct bufrdeco_output_buffer *ob, const char *key, buf_t ss, buf_t index )
+{
+  buf_t used = 0;
+
+  used += bufrdeco_out_puts ( ob, ",\"" );
+  used += bufrdeco_out_puts ( ob, key );
+  used += bufrdeco_out_puts ( ob, "\":\"#" );
+  used += bufrdeco_out_uint ( ob, ss, 0 );
+  used += bufrdeco_out_putc ( ob, '_' );
+  used += bufrdeco_out_uint ( ob, index, 0 );
+  used += bufrdeco_out_putc ( ob, '"' );
+  return used;
+}
+
+/*!
+ * \fn static buf_t bufrdeco_out_json_replicator ( struct bufrdeco_output_buffer *ob, const struct bufr_descriptor *d, const char *prefix )
+ * \brief Append the explanation of a replicator descriptor
+ */
+static buf_t bufrdeco_out_json_replicator ( struct bufrdeco_output_buffer *ob, const struct bufr_descriptor *d, const char *prefix )
+{
+  buf_t used = 0;
+
+  used += bufrdeco_out_puts ( ob, prefix );
+  if ( d->y == 0 )
+    {
+      used += bufrdeco_out_puts ( ob, "Replicator for " );
+      used += bufrdeco_out_int ( ob, d->x );
+      if ( d->x == 1 )
+        used += bufrdeco_out_puts ( ob, " descriptor after next delayed descriptor which set the number of replications." );
+      else
+        used += bufrdeco_out_puts ( ob, " descriptors after next delayed descriptor which set the number of replications." );
+    }
+  else
+    {
+      if ( d->x == 1 )
+        {
+          used += bufrdeco_out_puts ( ob, "Replicator for next descriptor " );
+          used += bufrdeco_out_int ( ob, d->y );
+          used += bufrdeco_out_puts ( ob, " times" );
+        }
+      else
+        {
+          used += bufrdeco_out_puts ( ob, "Replicator for next " );
+          used += bufrdeco_out_int ( ob, d->x );
+          used += bufrdeco_out_puts ( ob, " descriptors " );
+          used += bufrdeco_out_int ( ob, d->y );
+          used += bufrdeco_out_puts ( ob, " times" );
+        }
+    }
+  return used;
+}
+
+/*!
+ * \fn static buf_t bufrdeco_out_json_value ( struct bufrdeco_output_buffer *ob, struct bufr_atom_data *a )
+ * \brief Append the unit, value and meaning keys of a descriptor data
+ */
+static buf_t bufrdeco_out_json_value ( struct bufrdeco_output_buffer *ob, struct bufr_atom_data *a )
+{
+  buf_t used = 0;
+
+  if ( a->mask & DESCRIPTOR_HAVE_STRING_VALUE )
+    {
+      // string data case
+      if ( a->mask & DESCRIPTOR_VALUE_MISSING )
+        used += bufrdeco_out_puts ( ob, "\"Unit\":\"CCITT5\",\"Value\":\"MISSING\"" ) ;
+      else
+        {
+          used += bufrdeco_out_puts ( ob, "\"Unit\":\"CCITT5\",\"Value\":\"" ) ;
+          used += bufrdeco_out_json_string ( ob, a->cval );
+          used += bufrdeco_out_putc ( ob, '"' );
+        }
+    }
+  else if ( a->mask & DESCRIPTOR_IS_CODE_TABLE )
+    {
+      // code table case
+      if ( a->mask & DESCRIPTOR_VALUE_MISSING )
+        used += bufrdeco_out_puts ( ob, "\"Unit\":\"Code table\",\"Value\":\"MISSING\"" ) ;
+      else
+        {
+          used += bufrdeco_out_puts ( ob, "\"Unit\":\"Code table\",\"Value\":" ) ;
+          used += bufrdeco_out_uint ( ob, ( uint32_t ) ( a->val + 0.5 ), 0 );
+          used += bufrdeco_out_puts ( ob, ",\"Meaning\":\"" );
+          used += bufrdeco_out_puts ( ob, bufr_adjust_string ( a->ctable ) );
+          used += bufrdeco_out_putc ( ob, '"' );
+        }
+    }
+  else if ( a->mask & DESCRIPTOR_IS_FLAG_TABLE )
+    {
+      // flag table case
+      if ( a->mask & DESCRIPTOR_VALUE_MISSING )
+        used += bufrdeco_out_puts ( ob, "\"Unit\":\"Flag table\",\"Value\":\"MISSING\"" ) ;
+      else
+        {
+          used += bufrdeco_out_puts ( ob, "\"Unit\":\"Flag table\",\"Value\":\"0x" ) ;
+          used += bufrdeco_out_hex ( ob, ( uint32_t ) ( a->val ), 8 );
+          used += bufrdeco_out_puts ( ob, "\",\"Meaning\":\"" );
+          used += bufrdeco_out_puts ( ob, bufr_adjust_string ( a->ctable ) );
+          used += bufrdeco_out_putc ( ob, '"' );
+        }
+    }
+  else
+    {
+      // numeric data case
+      used += bufrdeco_out_puts ( ob, "\"Unit\":\"" );
+      used += bufrdeco_out_puts ( ob, a->unit );
+      if ( a->mask & DESCRIPTOR_VALUE_MISSING )
+        used += bufrdeco_out_puts ( ob, "\",\"Value\":\"MISSING\"" ) ;
+      else
+        {
+          used += bufrdeco_out_puts ( ob, "\",\"Value\":" );
+          used += bufrdeco_out_fixed ( ob, a->val, a->escale >= 0 ? a->escale : 0 );
+        }
+    }
+  return used;
+}
+
 /*!
  * \fn buf_t bufrdeco_print_json_scape_string_cvals ( FILE *out, char *source )
- * \brief prints a descriptor string value scaping the '"' for a json format
+ * \brief prints a descriptor string value scaping it for a json format
  * \param [in] out Output stream
  * \param [in] source Source string
  * \return The amount of bytes sent to out
  */
 buf_t bufrdeco_print_json_scape_string_cvals ( FILE *out, const char *source )
 {
-  buf_t i = 0, used = 0;
-  while ( source[i] )
-    {
-      switch ( source[i] )
-        {
-        case '"':
-          used += fprintf ( out, "%c%c", '\\', source[i++] );
-          break;
-        default:
-          used += fprintf ( out, "%c", source[i++] );
-          break;
-        }
-    }
+  struct bufrdeco_output_buffer ob;
+  buf_t used;
+
+  bufrdeco_out_init ( &ob, out );
+  used = bufrdeco_out_json_string ( &ob, source );
+  bufrdeco_out_flush ( &ob );
+  return used;
+}
+
+/*!
+ * \fn buf_t bufrdeco_out_json_subset_data_prologue ( struct bufrdeco_output_buffer *ob, const struct bufrdeco *b )
+ * \brief Appends the prologue of object with a subset data in json format
+ * \param [in,out] ob Output buffer
+ * \param [in] b Pointer to active struct \ref bufrdeco
+ * \return The amount of bytes appended
+ */
+buf_t bufrdeco_out_json_subset_data_prologue ( struct bufrdeco_output_buffer *ob, const struct bufrdeco *b )
+{
+  buf_t used = 0;
+
+  bufrdeco_assert ( b != NULL );
+
+  used += bufrdeco_out_puts ( ob, "{\"BUFR File\":\"" );
+  used += bufrdeco_out_json_string ( ob, b->header.filename );
+  used += bufrdeco_out_puts ( ob, "\",\"Subset\":" );
+  used += bufrdeco_out_uint ( ob, b->seq.ss, 0 );
+  used += bufrdeco_out_puts ( ob, ",\"Decoded data\":" );
   return used;
 }
 
@@ -57,13 +210,12 @@ buf_t bufrdeco_print_json_scape_string_cvals ( FILE *out, const char *source )
  */
 buf_t bufrdeco_print_json_subset_data_prologue ( FILE *out,  const struct bufrdeco *b )
 {
-  buf_t used = 0;
-
-  bufrdeco_assert ( b != NULL );
-
-  // print prologue
-  used += fprintf ( out, "{\"BUFR File\":\"%s\",\"Subset\":%u,\"Decoded data\":",b->header.filename, b->seq.ss );
+  struct bufrdeco_output_buffer ob;
+  buf_t used;
 
+  bufrdeco_out_init ( &ob, out );
+  used = bufrdeco_out_json_subset_data_prologue ( &ob, b );
+  bufrdeco_out_flush ( &ob );
   return used;
 }
 
@@ -76,10 +228,35 @@ buf_t bufrdeco_print_json_subset_data_prologue ( FILE *out,  const struct bufrde
  */
 buf_t bufrdeco_print_json_subset_data_epilogue ( FILE *out )
 {
+  return fwrite ( "}\n", 1, 2, out );
+}
+
+/*!
+ *  \fn buf_t bufrdeco_out_json_sequence_descriptor_header ( struct bufrdeco_output_buffer *ob, const struct bufr_sequence *seq )
+ *  \brief Append the header of a sequence descriptor (f == 3)
+ *  \param [in,out] ob Output buffer
+ *  \param [in] seq Pointer to a bufr_sequence \ref bufr_sequence
+ *
+ * \return The amount of bytes appended
+ */
+buf_t bufrdeco_out_json_sequence_descriptor_header ( struct bufrdeco_output_buffer *ob, const struct bufr_sequence *seq )
+{
+  char aux[8];
   buf_t used = 0;
 
-  // print prologue
-  used += fprintf ( out, "}\n" );
+  aux[0] = seq->key[0];
+  aux[1] = ' ';
+  aux[2] = seq->key[1];
+  aux[3] = seq->key[2];
+  aux[4] = ' ';
+  aux[5] = seq->key[3];
+  aux[6] = seq->key[4];
+  aux[7] = seq->key[5];
+  used += bufrdeco_out_puts ( ob, "{\"Descriptor\":\"" );
+  used += bufrdeco_out_write ( ob, aux, sizeof ( aux ) );
+  used += bufrdeco_out_puts ( ob, "\",\"Sequence description\":\"" );
+  used += bufrdeco_out_puts ( ob, seq->name );
+  used += bufrdeco_out_puts ( ob, "\",\"Expanded sequence\":[" );
   return used;
 }
 
@@ -93,10 +270,12 @@ buf_t bufrdeco_print_json_subset_data_epilogue ( FILE *out )
  */
 buf_t bufrdeco_print_json_sequence_descriptor_header ( FILE *out,  const struct bufr_sequence *seq )
 {
-  buf_t used = 0;
+  struct bufrdeco_output_buffer ob;
+  buf_t used;
 
-  used += fprintf ( out, "{\"Descriptor\":\"%c %c%c %c%c%c\",", seq->key[0], seq->key[1], seq->key[2], seq->key[3], seq->key[4], seq->key[5] );
-  used += fprintf ( out, "\"Sequence description\":\"%s\",\"Expanded sequence\":[", seq->name );
+  bufrdeco_out_init ( &ob, out );
+  used = bufrdeco_out_json_sequence_descriptor_header ( &ob, seq );
+  bufrdeco_out_flush ( &ob );
   return used;
 }
 
@@ -109,22 +288,19 @@ buf_t bufrdeco_print_json_sequence_descriptor_header ( FILE *out,  const struct
  */
 buf_t bufrdeco_print_json_sequence_descriptor_final ( FILE *out )
 {
-  buf_t used = 0;
-  // print final
-  used += fprintf ( out,  "]}" );
-  return used;
+  return fwrite ( "]}", 1, 2, out );
 }
 
-
 /*!
- *  \fn buf_t bufrdeco_print_json_object_atom_data (FILE *out, struct bufr_atom_data *a, buf_t index_data, char *add )
- *  \brief Print an json object with a descriptor data
- *  \param [in] out Output stream opened by caller
+ *  \fn buf_t bufrdeco_out_json_object_atom_data ( struct bufrdeco_output_buffer *ob, struct bufr_atom_data *a, buf_t index_data, const struct bufrdeco *b, const char *add )
+ *  \brief Append an json object with a descriptor data
+ *  \param [in,out] ob Output buffer
  *  \param [in] a Pointer to target struct \ref bufr_atom_data
  *  \param [in] index_data Index in array of data
+ *  \param [in] b Pointer to active struct \ref bufrdeco
  *  \param [in] add Additional optional info
  *
- * \return The amount of bytes sent to out
+ * \return The amount of bytes appended
  *
  * There are four cases of objects, depending of data type
  * { "descriptor":"f xx yyy", "name":"name_of_descriptor" , "unit":"name_of_unit", "value":"string_value"}
@@ -132,77 +308,64 @@ buf_t bufrdeco_print_json_sequence_descriptor_final ( FILE *out )
  * { "descriptor":"f xx yyy", "name":"name_of_descriptor" , "unit":"Flag value", "value":"numeric_value", "meaning":"explanation_string}
  * { "descriptor":"f xx yyy", "name":"name_of_descriptor" , "unit":"name_of_unit", "value":"numeric_value"}
  */
-buf_t bufrdeco_print_json_object_atom_data ( FILE *out,  struct bufr_atom_data *a, buf_t index_data, const struct bufrdeco *b, const char *add )
+buf_t bufrdeco_out_json_object_atom_data ( struct bufrdeco_output_buffer *ob, struct bufr_atom_data *a, buf_t index_data, const struct bufrdeco *b, const char *add )
 {
-  char aux[256];
   buf_t used = 0;
 
-  used += fprintf ( out,  "{\"Datafield\":\"#%u_%u\",", b->seq.ss, index_data );
-  used += fprintf ( out,  "\"Descriptor\":\"%u %02u %03u\",\"Name\":\"%s\",", a->desc.f, a->desc.x, a->desc.y, bufr_adjust_string ( a->name ) );
+  used += bufrdeco_out_puts ( ob, "{\"Datafield\":\"#" );
+  used += bufrdeco_out_uint ( ob, b->seq.ss, 0 );
+  used += bufrdeco_out_putc ( ob, '_' );
+  used += bufrdeco_out_uint ( ob, index_data, 0 );
+  used += bufrdeco_out_puts ( ob, "\",\"Descriptor\":\"" );
+  used += bufrdeco_out_descriptor ( ob, a->desc.f, a->desc.x, a->desc.y );
+  used += bufrdeco_out_puts ( ob, "\",\"Name\":\"" );
+  used += bufrdeco_out_puts ( ob, bufr_adjust_string ( a->name ) );
+  used += bufrdeco_out_puts ( ob, "\"," );
 
   // add aditional info keys
   if ( add != NULL && add[0] )
-    used += fprintf ( out, "%s,", add );
-
-  if ( a->mask & DESCRIPTOR_HAVE_STRING_VALUE )
     {
-      // string data case
-      if ( a->mask & DESCRIPTOR_VALUE_MISSING )
-        used += fprintf ( out, "\"Unit\":\"CCITT5\",\"Value\":\"MISSING\"}" ) ;
-      else
-        {
-          used += fprintf ( out, "\"Unit\":\"CCITT5\",\"Value\":\"" ) ;
-          used += bufrdeco_print_json_scape_string_cvals ( out, a->cval );
-          used += fprintf ( out, "\"}" );
-        }
-    }
-  else if ( a->mask & DESCRIPTOR_IS_CODE_TABLE )
-    {
-      // code table case
-      if ( a->mask & DESCRIPTOR_VALUE_MISSING )
-        used += fprintf ( out, "\"Unit\":\"Code table\",\"Value\":\"MISSING\"}" ) ;
-      else
-        {
-          used += fprintf ( out, "\"Unit\":\"Code table\",\"Value\":%u,", ( uint32_t ) ( a->val + 0.5 ) ) ;
-          used += fprintf ( out, "\"Meaning\":\"%s\"}", bufr_adjust_string ( a->ctable ) );
-        }
-    }
-  else if ( a->mask & DESCRIPTOR_IS_FLAG_TABLE )
-    {
-      // flag table case
-      if ( a->mask & DESCRIPTOR_VALUE_MISSING )
-        used += fprintf ( out, "\"Unit\":\"Flag table\",\"Value\":\"MISSING\"}" ) ;
-      else
-        {
-          used += fprintf ( out, "\"Unit\":\"Flag table\",\"Value\":\"0x%08X\",", ( uint32_t ) ( a->val ) ) ;
-          used += fprintf ( out, "\"Meaning\":\"%s\"}", bufr_adjust_string ( a->ctable ) );
-        }
+      used += bufrdeco_out_puts ( ob, add );
+      used += bufrdeco_out_putc ( ob, ',' );
     }
-  else
-    {
-      // numeric data case
-      if ( a->mask & DESCRIPTOR_VALUE_MISSING )
-        used += fprintf ( out, "\"Unit\":\"%s\",\"Value\":\"MISSING\"}", a->unit ) ;
-      else
-        {
-          used += fprintf ( out, "\"Unit\":\"%s\",\"Value\":%s}", a->unit,
-                            get_formatted_value_from_escale2 ( aux, sizeof ( aux ), a->escale, a->val ) );
 
-        }
-    }
+  used += bufrdeco_out_json_value ( ob, a );
+  used += bufrdeco_out_putc ( ob, '}' );
   return used;
 }
 
 /*!
- *  \fn buf_t bufrdeco_print_json_object_operator_descriptor (FILE *out, struct bufr_descriptor *d, char *add )
- *  \brief print an operator descriptor as a json object
+ *  \fn buf_t bufrdeco_print_json_object_atom_data (FILE *out, struct bufr_atom_data *a, buf_t index_data, char *add )
+ *  \brief Print an json object with a descriptor data
  *  \param [in] out Output stream opened by caller
- *  \param [in] d Pointer to operator descriptor
+ *  \param [in] a Pointer to target struct \ref bufr_atom_data
+ *  \param [in] index_data Index in array of data
+ *  \param [in] b Pointer to active struct \ref bufrdeco
  *  \param [in] add Additional optional info
  *
  * \return The amount of bytes sent to out
  */
-buf_t bufrdeco_print_json_object_operator_descriptor ( FILE *out,  const struct bufr_descriptor *d, const char *add )
+buf_t bufrdeco_print_json_object_atom_data ( FILE *out,  struct bufr_atom_data *a, buf_t index_data, const struct bufrdeco *b, const char *add )
+{
+  struct bufrdeco_output_buffer ob;
+  buf_t used;
+
+  bufrdeco_out_init ( &ob, out );
+  used = bufrdeco_out_json_object_atom_data ( &ob, a, index_data, b, add );
+  bufrdeco_out_flush ( &ob );
+  return used;
+}
+
+/*!
+ *  \fn buf_t bufrdeco_out_json_object_operator_descriptor ( struct bufrdeco_output_buffer *ob, const struct bufr_descriptor *d, const char *add )
+ *  \brief Append an operator descriptor as a json object
+ *  \param [in,out] ob Output buffer
+ *  \param [in] d Pointer to operator descriptor
+ *  \param [in] add Additional optional info
+ *
+ * \return The amount of bytes appended
+ */
+buf_t bufrdeco_out_json_object_operator_descriptor ( struct bufrdeco_output_buffer *ob, const struct bufr_descriptor *d, const char *add )
 {
   buf_t used = 0;
   char explanation[256];
@@ -210,55 +373,96 @@ buf_t bufrdeco_print_json_object_operator_descriptor ( FILE *out,  const struct
   if ( d->f == 2 )
     {
       // only prints if f == 2
-      used += fprintf ( out, "{\"Descriptor\":\"%u %02u %03u\",", d->f, d->x, d->y );
+      used += bufrdeco_out_puts ( ob, "{\"Descriptor\":\"" );
+      used += bufrdeco_out_descriptor ( ob, d->f, d->x, d->y );
+      used += bufrdeco_out_puts ( ob, "\"," );
       // add aditional info keys
       if ( add != NULL && add[0] )
-        used += fprintf ( out, "%s,", add );
+        {
+          used += bufrdeco_out_puts ( ob, add );
+          used += bufrdeco_out_putc ( ob, ',' );
+        }
 
-      used += fprintf ( out, "\"Operator\": \"%s\"}", bufrdeco_get_f2_descriptor_explanation ( explanation, sizeof ( explanation ), d ) );
+      used += bufrdeco_out_puts ( ob, "\"Operator\": \"" );
+      used += bufrdeco_out_puts ( ob, bufrdeco_get_f2_descriptor_explanation ( explanation, sizeof ( explanation ), d ) );
+      used += bufrdeco_out_puts ( ob, "\"}" );
     }
   return used;
 }
 
 /*!
- *  \fn buf_t bufrdeco_print_json_object_replicator_descriptor (FILE *out, struct bufr_descriptor *d, char *add )
+ *  \fn buf_t bufrdeco_print_json_object_operator_descriptor (FILE *out, struct bufr_descriptor *d, char *add )
  *  \brief print an operator descriptor as a json object
- *  \param [in] out String where to print
+ *  \param [in] out Output stream opened by caller
  *  \param [in] d Pointer to operator descriptor
- *  \param [in] add Additional info
+ *  \param [in] add Additional optional info
  *
  * \return The amount of bytes sent to out
  */
-buf_t bufrdeco_print_json_object_replicator_descriptor ( FILE *out,  const struct bufr_descriptor *d, const char *add )
+buf_t bufrdeco_print_json_object_operator_descriptor ( FILE *out,  const struct bufr_descriptor *d, const char *add )
+{
+  struct bufrdeco_output_buffer ob;
+  buf_t used;
+
+  bufrdeco_out_init ( &ob, out );
+  used = bufrdeco_out_json_object_operator_descriptor ( &ob, d, add );
+  bufrdeco_out_flush ( &ob );
+  return used;
+}
+
+/*!
+ *  \fn buf_t bufrdeco_out_json_object_replicator_descriptor ( struct bufrdeco_output_buffer *ob, const struct bufr_descriptor *d, const char *add )
+ *  \brief Append a replicator descriptor as a json object
+ *  \param [in,out] ob Output buffer
+ *  \param [in] d Pointer to replicator descriptor
+ *  \param [in] add Additional info
+ *
+ * \return The amount of bytes appended
+ */
+buf_t bufrdeco_out_json_object_replicator_descriptor ( struct bufrdeco_output_buffer *ob, const struct bufr_descriptor *d, const char *add )
 {
   buf_t used = 0;
 
   if ( d->f == 1 )
     {
-      used += fprintf ( out, "{\"Descriptor\":\"%u %02u %03u\",", d->f, d->x, d->y );
+      used += bufrdeco_out_puts ( ob, "{\"Descriptor\":\"" );
+      used += bufrdeco_out_descriptor ( ob, d->f, d->x, d->y );
+      used += bufrdeco_out_puts ( ob, "\"," );
       // add aditional info keys
       if ( add != NULL && add[0] )
-        used += fprintf ( out, "%s,", add );
-
-      if ( d->y == 0 )
-        {
-          if ( d->x == 1 )
-            used += fprintf ( out, "\"Replicator\":\"Replicator for %d descriptor after next delayed descriptor which set the number of replications.\"}", d->x );
-          else
-            used += fprintf ( out, "\"Replicator\":\"Replicator for %d descriptors after next delayed descriptor which set the number of replications.\"}", d->x );
-        }
-      else
         {
-          if ( d->x == 1 )
-            used += fprintf ( out, "\"Replicator\":\"Replicator for next descriptor %d times.\"}", d->y );
-          else
-            used += fprintf ( out, "\"Replicator\":\"Replicator for next %d descriptors %d times\"}", d->x, d->y );
+          used += bufrdeco_out_puts ( ob, add );
+          used += bufrdeco_out_putc ( ob, ',' );
         }
 
+      used += bufrdeco_out_json_replicator ( ob, d, "\"Replicator\":\"" );
+      if ( d->y && d->x == 1 )
+        used += bufrdeco_out_putc ( ob, '.' );
+      used += bufrdeco_out_puts ( ob, "\"}" );
     }
   return used;
 }
 
+/*!
+ *  \fn buf_t bufrdeco_print_json_object_replicator_descriptor (FILE *out, struct bufr_descriptor *d, char *add )
+ *  \brief print an operator descriptor as a json object
+ *  \param [in] out String where to print
+ *  \param [in] d Pointer to operator descriptor
+ *  \param [in] add Additional info
+ *
+ * \return The amount of bytes sent to out
+ */
+buf_t bufrdeco_print_json_object_replicator_descriptor ( FILE *out,  const struct bufr_descriptor *d, const char *add )
+{
+  struct bufrdeco_output_buffer ob;
+  buf_t used;
+
+  bufrdeco_out_init ( &ob, out );
+  used = bufrdeco_out_json_object_replicator_descriptor ( &ob, d, add );
+  bufrdeco_out_flush ( &ob );
+  return used;
+}
+
 /*!
  *  \fn buf_t bufrdeco_print_json_separator( FILE *out)
  *  \brief Print the comma ',' separator in an output
@@ -268,7 +472,28 @@ buf_t bufrdeco_print_json_object_replicator_descriptor ( FILE *out,  const struc
  */
 buf_t bufrdeco_print_json_separator ( FILE *out )
 {
-  return fprintf ( out, "," );
+  return ( fputc ( ',', out ) == EOF ) ? 0 : 1;
+}
+
+/*!
+ * \fn buf_t bufrdeco_out_json_sec0 ( struct bufrdeco_output_buffer *ob, const struct bufrdeco *b )
+ * \brief Append info form sec 0 in json format
+ * \param [in,out] ob Output buffer
+ * \param [in] b Active struct \ref bufrdeco
+ *
+ * \return The amount of bytes appended
+ */
+buf_t bufrdeco_out_json_sec0 ( struct bufrdeco_output_buffer *ob, const struct bufrdeco *b )
+{
+  buf_t used = 0;
+
+  bufrdeco_assert ( b != NULL );
+  used += bufrdeco_out_puts ( ob, "{\"Sec 0\":{\"Bufr length\":" );
+  used += bufrdeco_out_uint ( ob, b->sec0.bufr_length, 0 );
+  used += bufrdeco_out_puts ( ob, ",\"Bufr edition\":" );
+  used += bufrdeco_out_uint ( ob, b->sec0.edition, 0 );
+  used += bufrdeco_out_puts ( ob, "}}" );
+  return used;
 }
 
 /*!
@@ -281,136 +506,225 @@ buf_t bufrdeco_print_json_separator ( FILE *out )
 */
 buf_t bufrdeco_print_json_sec0 ( FILE *out, const struct bufrdeco *b )
 {
-  size_t used = 0;
+  struct bufrdeco_output_buffer ob;
+  buf_t used;
 
-  bufrdeco_assert ( b != NULL );
-  used += fprintf ( out, "{\"Sec 0\":{" );
-  used += fprintf ( out, "\"Bufr length\":%u,", b->sec0.bufr_length );
-  used += fprintf ( out, "\"Bufr edition\":%u}}", b->sec0.edition );
+  bufrdeco_out_init ( &ob, out );
+  used = bufrdeco_out_json_sec0 ( &ob, b );
+  bufrdeco_out_flush ( &ob );
   return used;
 }
 
+/*!
+ * \fn static buf_t bufrdeco_out_json_uint_key ( struct bufrdeco_output_buffer *ob, const char *key, uint64_t u )
+ * \brief Append a key with an unsigned value as ,"key":u
+ */
+static buf_t bufrdeco_out_json_uint_key ( struct bufrdeco_output_buffer *ob, const char *key, uint64_t u )
+{
+  buf_t used = 0;
+
+  used += bufrdeco_out_puts ( ob, ",\"" );
+  used += bufrdeco_out_puts ( ob, key );
+  used += bufrdeco_out_puts ( ob, "\":" );
+  used += bufrdeco_out_uint ( ob, u, 0 );
+  return used;
+}
 
 /*!
- * \fn bufrdeco_print_json_sec1 (FILE *out, const struct bufrdeco *b)
- * \brief Print info form sec 1 in json format
- * \param [in] out String where to print
+ * \fn static buf_t bufrdeco_out_json_string_key ( struct bufrdeco_output_buffer *ob, const char *key, const char *value )
+ * \brief Append a key with a string value as ,"key":"value"
+ */
+static buf_t bufrdeco_out_json_string_key ( struct bufrdeco_output_buffer *ob, const char *key, const char *value )
+{
+  buf_t used = 0;
+
+  used += bufrdeco_out_puts ( ob, ",\"" );
+  used += bufrdeco_out_puts ( ob, key );
+  used += bufrdeco_out_puts ( ob, "\":\"" );
+  used += bufrdeco_out_puts ( ob, value );
+  used += bufrdeco_out_putc ( ob, '"' );
+  return used;
+}
+
+/*!
+ * \fn buf_t bufrdeco_out_json_sec1 ( struct bufrdeco_output_buffer *ob, const struct bufrdeco *b )
+ * \brief Append info form sec 1 in json format
+ * \param [in,out] ob Output buffer
  * \param [in] b Active struct \ref bufrdeco
  *
- * \return The amount of bytes sent to out
-*/
-buf_t bufrdeco_print_json_sec1 ( FILE *out, const struct bufrdeco *b )
+ * \return The amount of bytes appended
+ */
+buf_t bufrdeco_out_json_sec1 ( struct bufrdeco_output_buffer *ob, const struct bufrdeco *b )
 {
-  size_t used = 0;
+  buf_t used = 0;
 
   bufrdeco_assert ( b != NULL );
-  used += fprintf ( out, "{\"Sec 1\":{" );
-  used += fprintf ( out, "\"Length\":%u", b->sec1.length );
-  used += fprintf ( out, ",\"Bufr master table\":%u", b->sec1.master );
-  used += fprintf ( out, ",\"Centre\":%u", b->sec1.centre );
-  used += fprintf ( out, ",\"Sub-Centre\":%u", b->sec1.subcentre );
-  used += fprintf ( out, ",\"Update sequence\":%u", b->sec1.update );
-  used += fprintf ( out, ",\"Options\":\"0x%x\"", b->sec1.options );
-  used += fprintf ( out, ",\"Category\":%u", b->sec1.category );
-  used += fprintf ( out, ",\"Subcategory\":%u", b->sec1.subcategory );
-  used += fprintf ( out, ",\"Sub-category local\":%u", b->sec1.subcategory_local );
-  used += fprintf ( out, ",\"Master table version\":%u", b->sec1.master_version );
-  used += fprintf ( out, ",\"Master table local\":%u", b->sec1.master_local );
-  used += fprintf ( out, ",\"Year\":%u", b->sec1.year );
-  used += fprintf ( out, ",\"Month\":%u", b->sec1.month );
-  used += fprintf ( out, ",\"Day\":%u", b->sec1.day );
-  used += fprintf ( out, ",\"Hour\":%u", b->sec1.hour );
-  used += fprintf ( out, ",\"Minute\":%u", b->sec1.minute );
-  used += fprintf ( out, ",\"Second\":%u", b->sec1.second );
+  used += bufrdeco_out_puts ( ob, "{\"Sec 1\":{\"Length\":" );
+  used += bufrdeco_out_uint ( ob, b->sec1.length, 0 );
+  used += bufrdeco_out_json_uint_key ( ob, "Bufr master table", b->sec1.master );
+  used += bufrdeco_out_json_uint_key ( ob, "Centre", b->sec1.centre );
+  used += bufrdeco_out_json_uint_key ( ob, "Sub-Centre", b->sec1.subcentre );
+  used += bufrdeco_out_json_uint_key ( ob, "Update sequence", b->sec1.update );
+  used += bufrdeco_out_puts ( ob, ",\"Options\":\"0x" );
+  used += bufrdeco_out_printf ( ob, "%x", b->sec1.options );
+  used += bufrdeco_out_putc ( ob, '"' );
+  used += bufrdeco_out_json_uint_key ( ob, "Category", b->sec1.category );
+  used += bufrdeco_out_json_uint_key ( ob, "Subcategory", b->sec1.subcategory );
+  used += bufrdeco_out_json_uint_key ( ob, "Sub-category local", b->sec1.subcategory_local );
+  used += bufrdeco_out_json_uint_key ( ob, "Master table version", b->sec1.master_version );
+  used += bufrdeco_out_json_uint_key ( ob, "Master table local", b->sec1.master_local );
+  used += bufrdeco_out_json_uint_key ( ob, "Year", b->sec1.year );
+  used += bufrdeco_out_json_uint_key ( ob, "Month", b->sec1.month );
+  used += bufrdeco_out_json_uint_key ( ob, "Day", b->sec1.day );
+  used += bufrdeco_out_json_uint_key ( ob, "Hour", b->sec1.hour );
+  used += bufrdeco_out_json_uint_key ( ob, "Minute", b->sec1.minute );
+  used += bufrdeco_out_json_uint_key ( ob, "Second", b->sec1.second );
+  // Same as printf "%u" of an unsigned difference, even if it wraps
   if ( b->sec0.edition == 3 )
-    used += fprintf ( out, ",\"Aditional space\":%u", b->sec1.length - 17 );
+    used += bufrdeco_out_json_uint_key ( ob, "Aditional space", ( uint32_t ) ( b->sec1.length - 17 ) );
   else
-    used += fprintf ( out, ",\"Aditional space\":%u", b->sec1.length - 22 );
-  used += fprintf ( out, "}" );
+    used += bufrdeco_out_json_uint_key ( ob, "Aditional space", ( uint32_t ) ( b->sec1.length - 22 ) );
+  used += bufrdeco_out_putc ( ob, '}' );
 
   if ( b->tables->b.path[0] )
     {
-      used += fprintf ( out, ",{\"Used tables\":{" );
-      used += fprintf ( out, ",\"TableB file\":\"%s\"", b->tables->b.path );
-      used += fprintf ( out, ",\"tableC file\":\"%s\"", b->tables->c.path );
-      used += fprintf ( out, ",\"tableD file\":\"%s\"", b->tables->d.path );
-      used += fprintf ( out, "}" );
+      used += bufrdeco_out_puts ( ob, ",{\"Used tables\":{" );
+      used += bufrdeco_out_json_string_key ( ob, "TableB file", b->tables->b.path );
+      used += bufrdeco_out_json_string_key ( ob, "tableC file", b->tables->c.path );
+      used += bufrdeco_out_json_string_key ( ob, "tableD file", b->tables->d.path );
+      used += bufrdeco_out_putc ( ob, '}' );
     }
-  used += fprintf ( out, "}" );
+  used += bufrdeco_out_putc ( ob, '}' );
 
   return used;
 }
 
 /*!
-  \fn buf_t bufrdeco_print_json_sec2( FILE *out, const struct bufrdeco *b )
-* \brief Print info form optional sec 2 in json format
+ * \fn bufrdeco_print_json_sec1 (FILE *out, const struct bufrdeco *b)
+ * \brief Print info form sec 1 in json format
  * \param [in] out String where to print
  * \param [in] b Active struct \ref bufrdeco
  *
  * \return The amount of bytes sent to out
 */
-buf_t bufrdeco_print_json_sec2 ( FILE *out, const struct bufrdeco *b )
+buf_t bufrdeco_print_json_sec1 ( FILE *out, const struct bufrdeco *b )
 {
-  size_t used = 0;
+  struct bufrdeco_output_buffer ob;
+  buf_t used;
 
-  bufrdeco_assert ( b != NULL );
-  used += fprintf ( out, "{\"Sec 2\":{" );
-  if ( b->sec1.options & 0x80 )
-    used += fprintf ( out, "\"Length\":%u}}", b->sec2.length );
-  else
-    used += fprintf ( out, "\"Length\":0}}" );
+  bufrdeco_out_init ( &ob, out );
+  used = bufrdeco_out_json_sec1 ( &ob, b );
+  bufrdeco_out_flush ( &ob );
+  return used;
+}
+
+/*!
+ * \fn buf_t bufrdeco_out_json_sec2 ( struct bufrdeco_output_buffer *ob, const struct bufrdeco *b )
+ * \brief Append info form optional sec 2 in json format
+ * \param [in,out] ob Output buffer
+ * \param [in] b Active struct \ref bufrdeco
+ *
+ * \return The amount of bytes appended
+ */
+buf_t bufrdeco_out_json_sec2 ( struct bufrdeco_output_buffer *ob, const struct bufrdeco *b )
+{
+  buf_t used = 0;
 
+  bufrdeco_assert ( b != NULL );
+  used += bufrdeco_out_puts ( ob, "{\"Sec 2\":{\"Length\":" );
+  used += bufrdeco_out_uint ( ob, ( b->sec1.options & 0x80 ) ? b->sec2.length : 0, 0 );
+  used += bufrdeco_out_puts ( ob, "}}" );
   return used;
 }
 
 /*!
- * \fn bufrdeco_print_json_sec3 (FILE *out, const struct bufrdeco *b)
- * \brief Print info form sec 3 in json format
+  \fn buf_t bufrdeco_print_json_sec2( FILE *out, const struct bufrdeco *b )
+* \brief Print info form optional sec 2 in json format
  * \param [in] out String where to print
  * \param [in] b Active struct \ref bufrdeco
  *
  * \return The amount of bytes sent to out
 */
-buf_t bufrdeco_print_json_sec3 ( FILE *out, const struct bufrdeco *b )
+buf_t bufrdeco_print_json_sec2 ( FILE *out, const struct bufrdeco *b )
+{
+  struct bufrdeco_output_buffer ob;
+  buf_t used;
+
+  bufrdeco_out_init ( &ob, out );
+  used = bufrdeco_out_json_sec2 ( &ob, b );
+  bufrdeco_out_flush ( &ob );
+  return used;
+}
+
+/*!
+ * \fn buf_t bufrdeco_out_json_sec3 ( struct bufrdeco_output_buffer *ob, const struct bufrdeco *b )
+ * \brief Append info form sec 3 in json format
+ * \param [in,out] ob Output buffer
+ * \param [in] b Active struct \ref bufrdeco
+ *
+ * \return The amount of bytes appended
+ */
+buf_t bufrdeco_out_json_sec3 ( struct bufrdeco_output_buffer *ob, const struct bufrdeco *b )
 {
   buf_t used = 0, i;
 
   bufrdeco_assert ( b != NULL );
-  used += fprintf ( out, "{\"Sec 3\":{" );
-  used += fprintf ( out, "\"Sec3 length\":%u", b->sec3.length );
-  used += fprintf ( out, ",\"Subsets\":%u", b->sec3.subsets );
-  used += fprintf ( out, ",\"Observed\":%u", b->sec3.observed );
-  used += fprintf ( out, ",\"Compressed\":%u", b->sec3.compressed );
-  used += fprintf ( out, ",\"Unexpanded descriptors\":%u", b->sec3.ndesc );
-  used += fprintf ( out, ",\"Unexpanded array\":" );
-
-  used += fprintf ( out,"[" );
+  used += bufrdeco_out_puts ( ob, "{\"Sec 3\":{\"Sec3 length\":" );
+  used += bufrdeco_out_uint ( ob, b->sec3.length, 0 );
+  used += bufrdeco_out_json_uint_key ( ob, "Subsets", b->sec3.subsets );
+  used += bufrdeco_out_json_uint_key ( ob, "Observed", b->sec3.observed );
+  used += bufrdeco_out_json_uint_key ( ob, "Compressed", b->sec3.compressed );
+  used += bufrdeco_out_json_uint_key ( ob, "Unexpanded descriptors", b->sec3.ndesc );
+  used += bufrdeco_out_puts ( ob, ",\"Unexpanded array\":[" );
   for ( i = 0; i < b->sec3.ndesc; i++ )
     {
       if ( i )
-        used += fprintf ( out,"," );
-      used += fprintf ( out, "{\"%u\":\"%u %02u %03u\"}", i, b->sec3.unexpanded[i].f, b->sec3.unexpanded[i].x, b->sec3.unexpanded[i].y );
+        used += bufrdeco_out_putc ( ob, ',' );
+      used += bufrdeco_out_puts ( ob, "{\"" );
+      used += bufrdeco_out_uint ( ob, i, 0 );
+      used += bufrdeco_out_puts ( ob, "\":\"" );
+      used += bufrdeco_out_descriptor ( ob, b->sec3.unexpanded[i].f, b->sec3.unexpanded[i].x, b->sec3.unexpanded[i].y );
+      used += bufrdeco_out_puts ( ob, "\"}" );
     }
-  used += fprintf ( out,"]}}" );
+  used += bufrdeco_out_puts ( ob, "]}}" );
 
   return used;
 }
 
 /*!
-  \fn int bufrdeco_print_json_tree_recursive ( FILE *out, struct bufrdeco *b, struct bufr_sequence *seq )
-  \brief  Print a tree of descriptors to a file in a recursive way in json format
-  \param [in] out Stream opened by caller
+ * \fn bufrdeco_print_json_sec3 (FILE *out, const struct bufrdeco *b)
+ * \brief Print info form sec 3 in json format
+ * \param [in] out String where to print
+ * \param [in] b Active struct \ref bufrdeco
+ *
+ * \return The amount of bytes sent to out
+*/
+buf_t bufrdeco_print_json_sec3 ( FILE *out, const struct bufrdeco *b )
+{
+  struct bufrdeco_output_buffer ob;
+  buf_t used;
+
+  bufrdeco_out_init ( &ob, out );
+  used = bufrdeco_out_json_sec3 ( &ob, b );
+  bufrdeco_out_flush ( &ob );
+  return used;
+}
+
+/*!
+  \fn buf_t bufrdeco_out_json_tree_recursive ( struct bufrdeco_output_buffer *ob, struct bufrdeco *b, struct bufr_sequence *seq )
+  \brief  Append a tree of descriptors in a recursive way in json format
+  \param [in,out] ob Output buffer
   \param [in,out] b Pointer to the basic container struct \ref bufrdeco
   \param [in] seq Pointer to the struct \ref bufr_sequence  to print
-  \return The amount of bytes sent to out
+  \return The amount of bytes appended
 */
-buf_t bufrdeco_print_json_tree_recursive ( FILE *out, struct bufrdeco *b, struct bufr_sequence *seq )
+buf_t bufrdeco_out_json_tree_recursive ( struct bufrdeco_output_buffer *ob, struct bufrdeco *b, struct bufr_sequence *seq )
 {
   buf_t i, k, used = 0;
   struct bufr_sequence *l;
   char explanation[256];
 
-  bufrdeco_assert ( out != NULL && b != NULL );
+  bufrdeco_assert ( ob != NULL && b != NULL );
 
   if ( seq == NULL )
     {
@@ -425,79 +739,99 @@ buf_t bufrdeco_print_json_tree_recursive ( FILE *out, struct bufrdeco *b, struct
   for ( i = 0; i < l->ndesc; i++ )
     {
       if ( i )
-        used += fprintf ( out, "," );
-      fprintf ( out,  "{\"%u %02u %03u\"", l->lseq[i].f, l->lseq[i].x,l->lseq[i].y );
+        used += bufrdeco_out_putc ( ob, ',' );
+      used += bufrdeco_out_puts ( ob, "{\"" );
+      used += bufrdeco_out_descriptor ( ob, l->lseq[i].f, l->lseq[i].x, l->lseq[i].y );
+      used += bufrdeco_out_putc ( ob, '"' );
 
       if ( l->lseq[i].f != 3 )
         {
           if ( l->lseq[i].f == 0 )
             {
               if ( bufr_find_tableB_index ( &k, & ( b->tables->b ), l->lseq[i].c ) )
-                used += fprintf ( out, "\"Not found in tables\"}" );
+                used += bufrdeco_out_puts ( ob, "\"Not found in tables\"}" );
               else
                 {
-                  used += fprintf ( out, ":\"" );
+                  used += bufrdeco_out_puts ( ob, ":\"" );
                   if ( l->replicated[i] )
                     {
                        if ( l->replicated[i] == 1 )
-                          used += fprintf ( out, "Replicated | " );
+                          used += bufrdeco_out_puts ( ob, "Replicated | " );
                        else
-                          used += fprintf ( out, "Replicated depth %u | ", l->replicated[i] );
+                         {
+                           used += bufrdeco_out_puts ( ob, "Replicated depth " );
+                           used += bufrdeco_out_uint ( ob, l->replicated[i], 0 );
+                           used += bufrdeco_out_puts ( ob, " | " );
+                         }
                     }
                   if ( is_a_delayed_descriptor ( & l->lseq[i] ) ||
                        is_a_short_delayed_descriptor ( & l->lseq[i] ) )
-                    used += fprintf ( out, "* %s\"}", b->tables->b.item[k].name );
-                  else
-                    used += fprintf ( out, "%s\"}", b->tables->b.item[k].name );
+                    used += bufrdeco_out_puts ( ob, "* " );
+                  used += bufrdeco_out_puts ( ob, bufr_strings_get ( & ( b->tables->b.strings ), b->tables->b.item[k].name_ofs ) );
+                  used += bufrdeco_out_puts ( ob, "\"}" );
                 }
             }
           else if ( l->lseq[i].f == 2 )
             {
-              used += fprintf ( out, ":\"%s\"}", bufrdeco_get_f2_descriptor_explanation ( explanation, sizeof ( explanation ), & ( l->lseq[i] ) ) );
+              used += bufrdeco_out_puts ( ob, ":\"" );
+              used += bufrdeco_out_puts ( ob, bufrdeco_get_f2_descriptor_explanation ( explanation, sizeof ( explanation ), & ( l->lseq[i] ) ) );
+              used += bufrdeco_out_puts ( ob, "\"}" );
             }
           else if ( l->lseq[i].f == 1 )
             {
-              if ( l->lseq[i].y == 0 )
-                {
-                  if ( l->lseq[i].x == 1 )
-                    used += fprintf ( out, ":\"* Replicator for %d descriptor after next delayed descriptor which set the number of replications.\"}", l->lseq[i].x );
-                  else
-                    used += fprintf ( out, ":\"* Replicator for %d descriptors after next delayed descriptor which set the number of replications.\"}", l->lseq[i].x );
-                }
-              else
-                {
-                  if ( l->lseq[i].x == 1 )
-                    used += fprintf ( out, ":\"* Replicator for next descriptor %d times\"}", l->lseq[i].y );
-                  else
-                    used += fprintf ( out, ":\"* Replicator for next %d descriptors %d times\"}", l->lseq[i].x, l->lseq[i].y );
-                }
+              used += bufrdeco_out_json_replicator ( ob, & ( l->lseq[i] ), ":\"* " );
+              used += bufrdeco_out_puts ( ob, "\"}" );
             }
           else
-            used += fprintf ( out, "\n" );
+            used += bufrdeco_out_putc ( ob, '\n' );
           continue;
         }
       else
         {
           // f == 3
-          used += fprintf ( out, ":\"" );
+          used += bufrdeco_out_puts ( ob, ":\"" );
           if ( l->replicated[i] )
             {
               if ( l->replicated[i] == 1 )
-                used += fprintf ( out, "Replicated | " );
+                used += bufrdeco_out_puts ( ob, "Replicated | " );
               else
-                used += fprintf ( out, "Replicated depth %u | ", l->replicated[i] );
+                {
+                  used += bufrdeco_out_puts ( ob, "Replicated depth " );
+                  used += bufrdeco_out_uint ( ob, l->replicated[i], 0 );
+                  used += bufrdeco_out_puts ( ob, " | " );
+                }
             }
-          used += fprintf ( out, "%s\"", bufr_adjust_string ( l->name ) );
-          used += fprintf ( out, ",\"Expanded\":[" );
-          // parse de son
-          used += bufrdeco_print_json_tree_recursive ( out, b, l->sons[i] );
-          used += fprintf ( out, "]}" );
+          used += bufrdeco_out_puts ( ob, bufr_adjust_string ( l->name ) );
+          used += bufrdeco_out_puts ( ob, "\",\"Expanded\":[" );
           // we then recursively parse the son
+          used += bufrdeco_out_json_tree_recursive ( ob, b, l->sons[i] );
+          used += bufrdeco_out_puts ( ob, "]}" );
         }
     }
   return used;
 }
 
+/*!
+  \fn int bufrdeco_print_json_tree_recursive ( FILE *out, struct bufrdeco *b, struct bufr_sequence *seq )
+  \brief  Print a tree of descriptors to a file in a recursive way in json format
+  \param [in] out Stream opened by caller
+  \param [in,out] b Pointer to the basic container struct \ref bufrdeco
+  \param [in] seq Pointer to the struct \ref bufr_sequence  to print
+  \return The amount of bytes sent to out
+*/
+buf_t bufrdeco_print_json_tree_recursive ( FILE *out, struct bufrdeco *b, struct bufr_sequence *seq )
+{
+  struct bufrdeco_output_buffer ob;
+  buf_t used;
+
+  bufrdeco_assert ( out != NULL && b != NULL );
+
+  bufrdeco_out_init ( &ob, out );
+  used = bufrdeco_out_json_tree_recursive ( &ob, b, seq );
+  bufrdeco_out_flush ( &ob );
+  return used;
+}
+
 /*!
   \fn int bufrdeco_print_tree ( struct bufrdeco *b )
   \brief Print a tree of descriptors
@@ -514,7 +848,14 @@ buf_t bufrdeco_print_json_tree ( struct bufrdeco *b )
   return used;
 };
 
-buf_t bufrdeco_print_json_subset_data ( struct bufrdeco *b )
+/*!
+  \fn buf_t bufrdeco_out_json_subset_data ( struct bufrdeco_output_buffer *ob, struct bufrdeco *b )
+  \brief Append the data of current subset in json format, using the events log
+  \param [in,out] ob Output buffer
+  \param [in,out] b Pointer to a basic container struct \ref bufrdeco
+  \return The amount of bytes appended
+*/
+buf_t bufrdeco_out_json_subset_data ( struct bufrdeco_output_buffer *ob, struct bufrdeco *b )
 {
   buf_t i, j, used = 0;
   struct bufrdeco_decode_subset_event *event;
@@ -524,7 +865,7 @@ buf_t bufrdeco_print_json_subset_data ( struct bufrdeco *b )
   bufrdeco_assert ( b != NULL && b->bitacora.event != NULL && b->seq.sequence != NULL );
 
   // print prologue
-  used += bufrdeco_print_json_subset_data_prologue ( b->out,  b );
+  used += bufrdeco_out_json_subset_data_prologue ( ob,  b );
 
   for ( i = 0, j = 0; i < b->bitacora.nd ; i++ )
     {
@@ -549,159 +890,343 @@ buf_t bufrdeco_print_json_subset_data ( struct bufrdeco *b )
       if ( event->mask & BUFRDECO_EVENT_SEQUENCE_INIT_BITMASK )
         {
           if ( j )
-            bufrdeco_print_json_separator ( b->out );
-          used += bufrdeco_print_json_sequence_descriptor_header ( b->out,  (const struct bufr_sequence *)event->pointer );
+            used += bufrdeco_out_putc ( ob, ',' );
+          used += bufrdeco_out_json_sequence_descriptor_header ( ob,  (const struct bufr_sequence *)event->pointer );
           j = 0;
         }
       else if ( event->mask & BUFRDECO_EVENT_SEQUENCE_FINAL_BITMASK )
         {
-          used += bufrdeco_print_json_sequence_descriptor_final ( b->out );
+          used += bufrdeco_out_puts ( ob, "]}" );
           j++;
         }
 
       if ( event->mask & BUFRDECO_EVENT_REPLICATOR_DESCRIPTOR_BITMASK )
         {
           if ( j )
-            bufrdeco_print_json_separator ( b->out );
-          used += bufrdeco_print_json_object_replicator_descriptor ( b->out, (const struct bufr_descriptor *)event->pointer, aux );
+            used += bufrdeco_out_putc ( ob, ',' );
+          used += bufrdeco_out_json_object_replicator_descriptor ( ob, (const struct bufr_descriptor *)event->pointer, aux );
           j++;
         }
 
       if ( event->mask & BUFRDECO_EVENT_OPERATOR_DESCRIPTOR_BITMASK )
         {
           if ( j )
-            bufrdeco_print_json_separator ( b->out );
+            used += bufrdeco_out_putc ( ob, ',' );
           if ( event->mask & BUFRDECO_EVENT_DATA_DESCRIPTOR_BITMASK )
             {
-              used += bufrdeco_print_json_object_event_data ( b->out, a, event, b, aux );
+              used += bufrdeco_out_json_object_event_data ( ob, a, event, b, aux );
             }
           else
             {
-              used += bufrdeco_print_json_object_operator_descriptor ( b->out, (const struct bufr_descriptor *)event->pointer, aux );
+              used += bufrdeco_out_json_object_operator_descriptor ( ob, (const struct bufr_descriptor *)event->pointer, aux );
             }
           j++;
         }
       else if ( event->mask & BUFRDECO_EVENT_DATA_DESCRIPTOR_BITMASK )
         {
           if ( j )
-            bufrdeco_print_json_separator ( b->out );
-          used += bufrdeco_print_json_object_event_data ( b->out, a, event, b, aux );
+            used += bufrdeco_out_putc ( ob, ',' );
+          used += bufrdeco_out_json_object_event_data ( ob, a, event, b, aux );
           j++;
         }
     }
-  // print prologue
-  used += bufrdeco_print_json_subset_data_epilogue ( b->out );
+  // print epilogue
+  used += bufrdeco_out_puts ( ob, "}\n" );
   return used;
 }
 
-buf_t bufrdeco_print_json_object_event_data ( FILE *out,  struct bufr_atom_data *a, const struct bufrdeco_decode_subset_event *event, struct bufrdeco *b, const char *add )
+/*!
+  \fn buf_t bufrdeco_print_json_subset_data ( struct bufrdeco *b )
+  \brief Print the data of current subset in json format to the output stream of \a b
+  \param [in,out] b Pointer to a basic container struct \ref bufrdeco
+  \return The amount of bytes sent to out
+*/
+buf_t bufrdeco_print_json_subset_data ( struct bufrdeco *b )
 {
-  char aux[256];
-  buf_t used = 0;
-  //struct bufrdeco_bitmap *bitmap;
+  struct bufrdeco_output_buffer ob;
+  buf_t used;
 
-  if (a == NULL || b == NULL)
-    return 0;
-  
-  used += fprintf ( out,  "{\"Datafield\":\"#%u_%d\",", b->seq.ss, event->ref_index );
-  used += fprintf ( out,  "\"Descriptor\":\"%u %02u %03u\",\"Name\":\"%s\",", a->desc.f, a->desc.x, a->desc.y, bufr_adjust_string ( a->name ) );
+  bufrdeco_out_init ( &ob, b->out );
+  used = bufrdeco_out_json_subset_data ( &ob, b );
+  bufrdeco_out_flush ( &ob );
+  return used;
+}
 
-  // add aditional info keys
-  if ( add != NULL && add[0] )
-    used += fprintf ( out, "%s,", add );
+/*!
+  \fn int bufrdeco_ndjson_keys_update ( struct bufrdeco_ndjson_keys *k, const struct bufrdeco_subset_sequence_data *s )
+  \brief Adjust the keys of flat json output to the descriptors of an expanded sequence
+  \param [in,out] k Pointer to the target struct \ref bufrdeco_ndjson_keys
+  \param [in] s Pointer to the source struct \ref bufrdeco_subset_sequence_data
+  \return If succeeded return 0, otherwise 1
 
+  Only the keys from the first descriptor which differs are rendered again, the keys of a common prefix are
+  still valid because the suffix of a key only depends on the descriptors before it
+*/
+int bufrdeco_ndjson_keys_update ( struct bufrdeco_ndjson_keys *k, const struct bufrdeco_subset_sequence_data *s )
+{
+  buf_t i, i0, dim;
+  uint16_t d;
+  size_t len;
+  const struct bufr_descriptor *desc;
+  void *p;
 
-  if ( a->mask & DESCRIPTOR_HAVE_STRING_VALUE )
+  bufrdeco_assert ( k != NULL && s != NULL );
+
+  // Find the first descriptor not matching
+  for ( i0 = 0; i0 < s->nd && i0 < k->nd; i0++ )
     {
-      // string data case
-      if ( a->mask & DESCRIPTOR_VALUE_MISSING )
-        used += fprintf ( out, "\"Unit\":\"CCITT5\",\"Value\":\"MISSING\"" ) ;
-      else
-        {
-          used += fprintf ( out, "\"Unit\":\"CCITT5\",\"Value\":\"" ) ;
-          used += bufrdeco_print_json_scape_string_cvals ( out, a->cval );
-          used += fprintf ( out, "\"" );
-        }
+      desc = & ( s->sequence[i0].desc );
+      d = ( uint16_t ) ( ( ( desc->f & 0x03 ) << 14 ) | ( ( desc->x & 0x3F ) << 8 ) | desc->y );
+      if ( k->desc[i0] != d )
+        break;
     }
-  else if ( a->mask & DESCRIPTOR_IS_CODE_TABLE )
+
+  if ( i0 == s->nd && i0 == k->nd )
+    return 0; // Same descriptors, same keys
+
+  if ( k->count == NULL &&
+       ( k->count = ( buf_t * ) calloc ( 65536, sizeof ( buf_t ) ) ) == NULL )
+    return 1;
+
+  if ( k->dim < s->nd )
     {
-      // code table case
-      if ( a->mask & DESCRIPTOR_VALUE_MISSING )
-        used += fprintf ( out, "\"Unit\":\"Code table\",\"Value\":\"MISSING\"" ) ;
-      else
-        {
-          used += fprintf ( out, "\"Unit\":\"Code table\",\"Value\":%u,", ( uint32_t ) ( a->val + 0.5 ) ) ;
-          used += fprintf ( out, "\"Meaning\":\"%s\"", bufr_adjust_string ( a->ctable ) );
-        }
+      dim = k->dim ? k->dim : BUFR_NMAXSEQ;
+      while ( dim < s->nd )
+        dim *= 2;
+      if ( ( p = realloc ( k->desc, dim * sizeof ( uint16_t ) ) ) == NULL )
+        return 1;
+      k->desc = ( uint16_t * ) p;
+      if ( ( p = realloc ( k->ofs, ( dim + 1 ) * sizeof ( size_t ) ) ) == NULL )
+        return 1;
+      k->ofs = ( size_t * ) p;
+      if ( k->dim == 0 )
+        k->ofs[0] = 0;
+      k->dim = dim;
     }
-  else if ( a->mask & DESCRIPTOR_IS_FLAG_TABLE )
+
+  // Count the occurrences in the common prefix
+  for ( i = 0; i < i0; i++ )
+    k->count[k->desc[i]]++;
+
+  // Render the remaining keys
+  len = k->ofs[i0];
+  for ( i = i0; i < s->nd; i++ )
     {
-      // flag table case
-      if ( a->mask & DESCRIPTOR_VALUE_MISSING )
-        used += fprintf ( out, "\"Unit\":\"Flag table\",\"Value\":\"MISSING\"" ) ;
-      else
+      if ( len + 24 > k->kdim )
         {
-          used += fprintf ( out, "\"Unit\":\"Flag table\",\"Value\":\"0x%08X\",", ( uint32_t ) ( a->val ) ) ;
-          used += fprintf ( out, "\"Meaning\":\"%s\"", bufr_adjust_string ( a->ctable ) );
+          if ( ( p = realloc ( k->keys, k->kdim ? 2 * k->kdim : 16384 ) ) == NULL )
+            {
+              k->nd = i;
+              break;
+            }
+          k->keys = ( char * ) p;
+          k->kdim = k->kdim ? 2 * k->kdim : 16384;
         }
+      desc = & ( s->sequence[i].desc );
+      d = ( uint16_t ) ( ( ( desc->f & 0x03 ) << 14 ) | ( ( desc->x & 0x3F ) << 8 ) | desc->y );
+      k->desc[i] = d;
+      if ( k->count[d]++ )
+        len += snprintf ( k->keys + len, k->kdim - len, ",\"%u %02u %03u_%u\":", desc->f, desc->x, desc->y, k->count[d] );
+      else
+        len += snprintf ( k->keys + len, k->kdim - len, ",\"%u %02u %03u\":", desc->f, desc->x, desc->y );
+      k->ofs[i + 1] = len;
     }
-  else
+  if ( i == s->nd )
+    k->nd = s->nd;
+
+  // Clean the scratch array for next time
+  for ( i = 0; i < k->nd; i++ )
+    k->count[k->desc[i]] = 0;
+
+  return ( k->nd == s->nd ) ? 0 : 1;
+}
+
+/*!
+  \fn buf_t bufrdeco_out_ndjson_subset_data ( struct bufrdeco_output_buffer *ob, struct bufrdeco *b )
+  \brief Append the data of current subset as a flat json object in a single line
+  \param [in,out] ob Output buffer
+  \param [in,out] b Pointer to a basic container struct \ref bufrdeco
+  \return The amount of bytes appended
+
+  Every data is a pair "f xx yyy":value, with null for missing values. If bit \ref BUFRDECO_OUTPUT_NDJSON_MEANINGS is
+  set in mask of \a b, a pair "f xx yyy meaning":"..." is added after every code or flag table with a known meaning
+*/
+buf_t bufrdeco_out_ndjson_subset_data ( struct bufrdeco_output_buffer *ob, struct bufrdeco *b )
+{
+  buf_t i, used = 0;
+  size_t len;
+  const char *key;
+  struct bufr_atom_data *a;
+
+  bufrdeco_assert ( b != NULL );
+
+  if ( bufrdeco_ndjson_keys_update ( & ( b->ndjson ), & ( b->seq ) ) )
     {
-      // numeric data case
+      snprintf ( b->error, sizeof ( b->error ), "%s(): Cannot allocate memory for json keys\n", __func__ );
+      return 0;
+    }
+
+  used += bufrdeco_out_puts ( ob, "{\"BUFR File\":\"" );
+  used += bufrdeco_out_json_string ( ob, b->header.filename );
+  used += bufrdeco_out_puts ( ob, "\",\"Subset\":" );
+  used += bufrdeco_out_uint ( ob, b->seq.ss, 0 );
+
+  for ( i = 0; i < b->seq.nd; i++ )
+    {
+      a = & ( b->seq.sequence[i] );
+      key = b->ndjson.keys + b->ndjson.ofs[i];
+      len = b->ndjson.ofs[i + 1] - b->ndjson.ofs[i];
+      used += bufrdeco_out_write ( ob, key, len );
+
       if ( a->mask & DESCRIPTOR_VALUE_MISSING )
-        used += fprintf ( out, "\"Unit\":\"%s\",\"Value\":\"MISSING\"", a->unit ) ;
-      else
         {
-          used += fprintf ( out, "\"Unit\":\"%s\",\"Value\":%s", a->unit,
-                            get_formatted_value_from_escale2 ( aux, sizeof ( aux ), a->escale, a->val ) );
+          used += bufrdeco_out_puts ( ob, "null" );
+          continue;
+        }
 
+      if ( a->mask & DESCRIPTOR_HAVE_STRING_VALUE )
+        {
+          used += bufrdeco_out_putc ( ob, '"' );
+          used += bufrdeco_out_json_string ( ob, a->cval );
+          used += bufrdeco_out_putc ( ob, '"' );
         }
+      else if ( a->mask & ( DESCRIPTOR_IS_CODE_TABLE | DESCRIPTOR_IS_FLAG_TABLE ) )
+        {
+          used += bufrdeco_out_uint ( ob, ( uint32_t ) ( a->val + 0.5 ), 0 );
+          if ( ( b->mask & BUFRDECO_OUTPUT_NDJSON_MEANINGS ) &&
+               ( a->mask & ( DESCRIPTOR_HAVE_CODE_TABLE_STRING | DESCRIPTOR_HAVE_FLAG_TABLE_STRING ) ) )
+            {
+              // same key without the final '":' and with the suffix " meaning"
+              used += bufrdeco_out_write ( ob, key, len - 2 );
+              used += bufrdeco_out_puts ( ob, " meaning\":\"" );
+              used += bufrdeco_out_json_string ( ob, bufr_adjust_string ( a->ctable ) );
+              used += bufrdeco_out_putc ( ob, '"' );
+            }
+        }
+      else
+        used += bufrdeco_out_fixed ( ob, a->val, a->escale >= 0 ? a->escale : 0 );
     }
+  used += bufrdeco_out_puts ( ob, "}\n" );
+  return used;
+}
+
+/*!
+  \fn buf_t bufrdeco_print_ndjson_subset_data ( struct bufrdeco *b )
+  \brief Print the data of current subset as a flat json object in a single line to the output stream of \a b
+  \param [in,out] b Pointer to a basic container struct \ref bufrdeco
+  \return The amount of bytes sent to out
+*/
+buf_t bufrdeco_print_ndjson_subset_data ( struct bufrdeco *b )
+{
+  struct bufrdeco_output_buffer ob;
+  buf_t used;
+
+  bufrdeco_out_init ( &ob, b->out );
+  used = bufrdeco_out_ndjson_subset_data ( &ob, b );
+  bufrdeco_out_flush ( &ob );
+  return used;
+}
+
+/*!
+  \fn buf_t bufrdeco_out_json_object_event_data ( struct bufrdeco_output_buffer *ob, struct bufr_atom_data *a, const struct bufrdeco_decode_subset_event *event, struct bufrdeco *b, const char *add )
+  \brief Append a json object with a descriptor data and its relations got from the events log
+  \param [in,out] ob Output buffer
+  \param [in] a Pointer to target struct \ref bufr_atom_data
+  \param [in] event Pointer to the event of this data
+  \param [in,out] b Pointer to a basic container struct \ref bufrdeco
+  \param [in] add Additional optional info
+  \return The amount of bytes appended
+*/
+buf_t bufrdeco_out_json_object_event_data ( struct bufrdeco_output_buffer *ob, struct bufr_atom_data *a, const struct bufrdeco_decode_subset_event *event, struct bufrdeco *b, const char *add )
+{
+  buf_t used = 0;
+
+  if (a == NULL || b == NULL)
+    return 0;
+  
+  used += bufrdeco_out_puts ( ob, "{\"Datafield\":\"#" );
+  used += bufrdeco_out_uint ( ob, b->seq.ss, 0 );
+  used += bufrdeco_out_putc ( ob, '_' );
+  used += bufrdeco_out_int ( ob, event->ref_index );
+  used += bufrdeco_out_puts ( ob, "\",\"Descriptor\":\"" );
+  used += bufrdeco_out_descriptor ( ob, a->desc.f, a->desc.x, a->desc.y );
+  used += bufrdeco_out_puts ( ob, "\",\"Name\":\"" );
+  used += bufrdeco_out_puts ( ob, bufr_adjust_string ( a->name ) );
+  used += bufrdeco_out_puts ( ob, "\"," );
+
+  // add aditional info keys
+  if ( add != NULL && add[0] )
+    {
+      used += bufrdeco_out_puts ( ob, add );
+      used += bufrdeco_out_putc ( ob, ',' );
+    }
+
+  used += bufrdeco_out_json_value ( ob, a );
 
   if ( a->is_bitmaped_by )
     {
       if ( bufrdeco_get_bitmaped_info ( &b->brv, event->ref_index, b ) )
         return 1;
-      used += fprintf ( out, ",\"Bitmaped_by\":\"#%u_%u\"", b->seq.ss, a->is_bitmaped_by );
+      used += bufrdeco_out_json_field_ref ( ob, "Bitmaped_by", b->seq.ss, a->is_bitmaped_by );
       for ( buf_t i = 0; i < b->bitmap.nba; i++ )
         {
 
           for ( buf_t j = 0; j < b->bitmap.bmap[i]->nq ; j++ )
             {
-              used += fprintf ( out, ",\"Qualified_by\":\"#%u_%u\"", b->seq.ss, b->brv.qualified_by[j] + 1 );
+              used += bufrdeco_out_json_field_ref ( ob, "Qualified_by", b->seq.ss, b->brv.qualified_by[j] + 1 );
             }
 
           for ( buf_t j = 0; j < b->bitmap.bmap[i]->ns1 ; j++ )
             {
-              used += fprintf ( out, ",\"First_stat_by\":\"#%u_%u\"", b->seq.ss, b->brv.stat1_desc[j] + 1 );
+              used += bufrdeco_out_json_field_ref ( ob, "First_stat_by", b->seq.ss, b->brv.stat1_desc[j] + 1 );
             }
           for ( buf_t j = 0; j < b->bitmap.bmap[i]->nds ; j++ )
             {
-              used += fprintf ( out, ",\"Diff_stat_by\":\"#%u_%u\"", b->seq.ss, b->brv.dstat_desc[j] + 1 );
+              used += bufrdeco_out_json_field_ref ( ob, "Diff_stat_by", b->seq.ss, b->brv.dstat_desc[j] + 1 );
             }
         }
     }
   else if ( a->related_to )
     {
       if ( event->mask & BUFRDECO_EVENT_DATA_QUALIFIYER_BITMASK )
-        used += fprintf ( out, ",\"Qualify_to\":\"#%u_%u\"", b->seq.ss, a->related_to );
+        used += bufrdeco_out_json_field_ref ( ob, "Qualify_to", b->seq.ss, a->related_to );
       else if ( event->mask & BUFRDECO_EVENT_DATA_FIRST_ORDER_STAT_BITMASK )
-        used += fprintf ( out, ",\"Stats_to\":\"#%u_%u\"", b->seq.ss, a->related_to );
+        used += bufrdeco_out_json_field_ref ( ob, "Stats_to", b->seq.ss, a->related_to );
       else if ( event->mask & BUFRDECO_EVENT_DATA_DIFF_STAT_BITMASK )
-        used += fprintf ( out, ",\"Diff_stats_to\":\"#%u_%u\"", b->seq.ss, a->related_to );
+        used += bufrdeco_out_json_field_ref ( ob, "Diff_stats_to", b->seq.ss, a->related_to );
       else
-        used += fprintf ( out, ",\"Related_to\":\"#%u_%u\"", b->seq.ss, a->related_to );
+        used += bufrdeco_out_json_field_ref ( ob, "Related_to", b->seq.ss, a->related_to );
     }
   else if ( a->bitmap_to )
     {
-      used += fprintf ( out, ",\"Bitmap_to\":\"#%u_%u\"", b->seq.ss, a->bitmap_to );
+      used += bufrdeco_out_json_field_ref ( ob, "Bitmap_to", b->seq.ss, a->bitmap_to );
     }
   else if ( a->associated_to )
     {
-      used += fprintf ( out, ",\"Associated_to\":\"#%u_%u\"", b->seq.ss, a->associated_to );
+      used += bufrdeco_out_json_field_ref ( ob, "Associated_to", b->seq.ss, a->associated_to );
     }
 
-  used += fprintf ( out, "}" );
+  used += bufrdeco_out_putc ( ob, '}' );
   return used;
 }
 
+/*!
+  \fn buf_t bufrdeco_print_json_object_event_data ( FILE *out, struct bufr_atom_data *a, const struct bufrdeco_decode_subset_event *event, struct bufrdeco *b, const char *add )
+  \brief Print a json object with a descriptor data and its relations got from the events log
+  \param [in] out Output stream opened by caller
+  \param [in] a Pointer to target struct \ref bufr_atom_data
+  \param [in] event Pointer to the event of this data
+  \param [in,out] b Pointer to a basic container struct \ref bufrdeco
+  \param [in] add Additional optional info
+  \return The amount of bytes sent to out
+*/
+buf_t bufrdeco_print_json_object_event_data ( FILE *out,  struct bufr_atom_data *a, const struct bufrdeco_decode_subset_event *event, struct bufrdeco *b, const char *add )
+{
+  struct bufrdeco_output_buffer ob;
+  buf_t used;
+
+  bufrdeco_out_init ( &ob, out );
+  used = bufrdeco_out_json_object_event_data ( &ob, a, event, b, add );
+  bufrdeco_out_flush ( &ob );
+  return used;
+}
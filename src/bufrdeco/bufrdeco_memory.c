@@ -22,6 +22,7 @@
  \brief This file has the memory stufs for library bufrdeco
 */
 #include "bufrdeco.h"
+#include <stddef.h>
 
 /*!
   \fn int bufrdeco_init_tables ( struct bufr_tables **t )
@@ -34,13 +35,32 @@ int bufrdeco_init_tables ( struct bufr_tables **t )
   bufrdeco_assert ( t != NULL );
   
   if ( *t != NULL )
-    free ( ( void * ) *t );
+    bufrdeco_free_tables ( t );
 
   if ( ( *t = ( struct bufr_tables * ) calloc ( 1, sizeof ( struct bufr_tables ) ) ) == NULL )
     return 1;
   return 0;
 }
 
+/*!
+  \fn int bufrdeco_clean_tables ( struct bufr_tables *t )
+  \brief Clean a struct \ref bufr_tables with zeroes, keeping the space allocated for its strings
+  \param [in,out] t Pointer to the target struct \ref bufr_tables
+  \return 0
+*/
+int bufrdeco_clean_tables ( struct bufr_tables *t )
+{
+  bufrdeco_assert ( t != NULL );
+
+  memset ( &t->b, 0, offsetof ( struct bufr_tableB, strings ) );
+  bufrdeco_clean_strings ( &t->b.strings );
+  memset ( &t->c, 0, offsetof ( struct bufr_tableC, strings ) );
+  bufrdeco_clean_strings ( &t->c.strings );
+  memset ( &t->d, 0, offsetof ( struct bufr_tableD, strings ) );
+  bufrdeco_clean_strings ( &t->d.strings );
+  return 0;
+}
+
 
 /*!
   \fn int bufrdeco_free_tables ( struct bufr_tables **t )
@@ -54,12 +74,144 @@ int bufrdeco_free_tables ( struct bufr_tables **t )
 
   if ( *t != NULL )
     {
+      bufrdeco_free_strings ( & ( ( *t )->b.strings ) );
+      bufrdeco_free_strings ( & ( ( *t )->c.strings ) );
+      bufrdeco_free_strings ( & ( ( *t )->d.strings ) );
       free ( ( void * ) *t );
       *t = NULL;
     }
   return 0;
 }
 
+/*!
+  \fn int bufrdeco_strings_reserve ( struct bufr_strings *p, uint32_t size )
+  \brief Allocate space in a struct \ref bufr_strings for, at least, \a size bytes of strings
+  \param [in,out] p Pointer to the target struct \ref bufr_strings
+  \param [in] size Bytes needed
+  \return 0 if succeeded, 1 otherwise
+*/
+int bufrdeco_strings_reserve ( struct bufr_strings *p, uint32_t size )
+{
+  char *s;
+  uint32_t dim;
+
+  bufrdeco_assert ( p != NULL );
+
+  if ( size <= p->dim )
+    return 0;
+
+  dim = p->dim ? p->dim : BUFR_STRINGS_INITIAL_SIZE;
+  while ( dim < size )
+    {
+      if ( dim > UINT32_MAX / 2 )
+        return 1;
+      dim *= 2;
+    }
+  if ( ( s = ( char * ) realloc ( ( void * ) p->s, dim ) ) == NULL )
+    return 1;
+  if ( p->s == NULL )
+    s[0] = '\0'; // The empty string at offset 0
+  p->s = s;
+  p->dim = dim;
+  return 0;
+}
+
+/*!
+  \fn int bufrdeco_strings_add ( uint32_t *ofs, struct bufr_strings *p, const char *str )
+  \brief Add a string to a struct \ref bufr_strings, if not already stored
+  \param [out] ofs Pointer where to set the offset of string in \a p->s
+  \param [in,out] p Pointer to the target struct \ref bufr_strings
+  \param [in] str The string
+  \return 0 if succeeded, 1 if no memory can be allocated
+
+  A string is stored once. If it was already in \a p then \a ofs is set with the offset of stored one
+*/
+int bufrdeco_strings_add ( uint32_t *ofs, struct bufr_strings *p, const char *str )
+{
+  uint32_t i, j, h, len, *hash;
+
+  bufrdeco_assert ( ofs != NULL && p != NULL && str != NULL );
+
+  if ( str[0] == '\0' )
+    {
+      *ofs = 0;
+      return 0;
+    }
+
+  // Keep the hash table half empty at most
+  if ( 2 * ( p->nstr + 1 ) > p->nhash )
+    {
+      h = p->nhash ? 2 * p->nhash : BUFR_STRINGS_INITIAL_SIZE / 64;
+      if ( ( hash = ( uint32_t * ) calloc ( h, sizeof ( uint32_t ) ) ) == NULL )
+        return 1;
+      for ( i = 0; i < p->nhash; i++ )
+        {
+          if ( p->hash[i] == 0 )
+            continue;
+          for ( j = bufrdeco_encode_string_hash ( p->s + p->hash[i] ) & ( h - 1 ); hash[j]; j = ( j + 1 ) & ( h - 1 ) );
+          hash[j] = p->hash[i];
+        }
+      free ( ( void * ) p->hash );
+      p->hash = hash;
+      p->nhash = h;
+    }
+
+  for ( j = bufrdeco_encode_string_hash ( str ) & ( p->nhash - 1 ); p->hash[j]; j = ( j + 1 ) & ( p->nhash - 1 ) )
+    {
+      if ( strcmp ( p->s + p->hash[j], str ) == 0 )
+        {
+          *ofs = p->hash[j];
+          return 0;
+        }
+    }
+
+  len = strlen ( str ) + 1;
+  if ( p->used == 0 )
+    p->used = 1; // The empty string at offset 0
+  if ( bufrdeco_strings_reserve ( p, p->used + len ) )
+    return 1;
+  memcpy ( p->s + p->used, str, len );
+  *ofs = p->hash[j] = p->used;
+  p->used += len;
+  ( p->nstr )++;
+  return 0;
+}
+
+/*!
+  \fn int bufrdeco_clean_strings ( struct bufr_strings *p )
+  \brief Remove all the strings in a struct \ref bufr_strings, keeping the space allocated
+  \param [in,out] p Pointer to the target struct \ref bufr_strings
+  \return 0
+*/
+int bufrdeco_clean_strings ( struct bufr_strings *p )
+{
+  bufrdeco_assert ( p != NULL );
+
+  if ( p->hash != NULL )
+    memset ( p->hash, 0, p->nhash * sizeof ( uint32_t ) );
+  p->nstr = 0;
+  p->used = ( p->s != NULL ) ? 1 : 0;
+  return 0;
+}
+
+/*!
+  \fn int bufrdeco_free_strings ( struct bufr_strings *p )
+  \brief Frees the allocated space in a struct \ref bufr_strings
+  \param [in,out] p Pointer to the target struct \ref bufr_strings
+  \return 0
+*/
+int bufrdeco_free_strings ( struct bufr_strings *p )
+{
+  bufrdeco_assert ( p != NULL );
+
+  if ( p->s != NULL )
+    free ( ( void * ) p->s );
+  if ( p->hash != NULL )
+    free ( ( void * ) p->hash );
+  memset ( p, 0, sizeof ( struct bufr_strings ) );
+  return 0;
+}
+
 /*!
   \fn int bufrdeco_init_expanded_tree ( struct bufrdeco_expanded_tree **t )
   \brief Init a struct \ref bufrdeco_expanded_tree allocating space
@@ -319,6 +471,46 @@ int bufrdeco_free_compressed_data_references ( struct bufrdeco_compressed_data_r
   return 0;
 }
 
+/*!
+  \fn int bufrdeco_free_compressed_columns ( struct bufrdeco_compressed_columns *c )
+  \brief Free the memory allocated for arrays in a struct \ref bufrdeco_compressed_columns
+  \param [in,out] c Pointer to the target struct \ref bufrdeco_compressed_columns to free
+  \return If succeeded return 0, otherwise 1
+*/
+int bufrdeco_free_compressed_columns ( struct bufrdeco_compressed_columns *c )
+{
+  bufrdeco_assert ( c != NULL );
+
+  if ( c->val != NULL )
+    free ( ( void * ) c->val );
+  if ( c->kind != NULL )
+    free ( ( void * ) c->kind );
+  memset ( c, 0, sizeof ( struct bufrdeco_compressed_columns ) );
+  return 0;
+}
+
+/*!
+  \fn int bufrdeco_free_ndjson_keys ( struct bufrdeco_ndjson_keys *k )
+  \brief Free the memory allocated for arrays in a struct \ref bufrdeco_ndjson_keys
+  \param [in,out] k Pointer to the target struct \ref bufrdeco_ndjson_keys to free
+  \return If succeeded return 0, otherwise 1
+*/
+int bufrdeco_free_ndjson_keys ( struct bufrdeco_ndjson_keys *k )
+{
+  bufrdeco_assert ( k != NULL );
+
+  if ( k->desc != NULL )
+    free ( ( void * ) k->desc );
+  if ( k->ofs != NULL )
+    free ( ( void * ) k->ofs );
+  if ( k->keys != NULL )
+    free ( ( void * ) k->keys );
+  if ( k->count != NULL )
+    free ( ( void * ) k->count );
+  memset ( k, 0, sizeof ( struct bufrdeco_ndjson_keys ) );
+  return 0;
+}
+
 /*!
   \fn int bufrdeco_increase_compressed_ref_array ( struct bufrdeco_compressed_data_references *r )
   \brief doubles the allocated space for a struct \ref bufrdeco_compressed_data_references whenever is posible
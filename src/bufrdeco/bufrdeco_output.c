@@ -0,0 +1,385 @@
+/***************************************************************************
+ *   Copyright (C) 2013-2026 by Guillermo Ballester Valor                  *
+ *   gbv@ogimet.com                                                        *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.             *
+ ***************************************************************************/
+/*!
+ \file bufrdeco_output.c
+ \brief This file has the code of the output buffer and fast formatters used to print json and other outputs
+*/
+#include "bufrdeco.h"
+
+/*!
+  \brief Powers of ten as integers used by fixed point formatting
+*/
+static const uint64_t POW10_U64[10] = {1ULL, 10ULL, 100ULL, 1000ULL, 10000ULL, 100000ULL, 1000000ULL,
+                                       10000000ULL, 100000000ULL, 1000000000ULL
+                                      };
+
+/*!
+  \brief Hexadecimal digits in uppercase
+*/
+static const char HEX_DIGITS[] = "0123456789ABCDEF";
+
+/*!
+  \fn int bufrdeco_out_init ( struct bufrdeco_output_buffer *ob, FILE *out )
+  \brief Init an output buffer
+  \param [out] ob Pointer to struct \ref bufrdeco_output_buffer to init
+  \param [in] out Stream opened by caller where data will be written
+  \return 0 if succeeded, 1 otherwise
+*/
+int bufrdeco_out_init ( struct bufrdeco_output_buffer *ob, FILE *out )
+{
+  bufrdeco_assert_with_return_val ( ob != NULL && out != NULL, 1 );
+
+  ob->out = out;
+  ob->len = 0;
+  ob->used = 0;
+  ob->error = 0;
+  return 0;
+}
+
+/*!
+  \fn int bufrdeco_out_flush ( struct bufrdeco_output_buffer *ob )
+  \brief Write the data in buffer to its stream and empty the buffer
+  \param [in,out] ob Pointer to struct \ref bufrdeco_output_buffer
+  \return 0 if succeeded, 1 if a write failed now or before
+*/
+int bufrdeco_out_flush ( struct bufrdeco_output_buffer *ob )
+{
+  if ( ob->len )
+    {
+      if ( fwrite ( ob->s, 1, ob->len, ob->out ) != ob->len )
+        ob->error = 1;
+      ob->len = 0;
+    }
+  return ob->error;
+}
+
+/*!
+  \fn buf_t bufrdeco_out_write ( struct bufrdeco_output_buffer *ob, const char *data, size_t len )
+  \brief Append bytes to an output buffer
+  \param [in,out] ob Pointer to struct \ref bufrdeco_output_buffer
+  \param [in] data Bytes to append
+  \param [in] len Number of bytes
+  \return The amount of bytes appended
+
+  If data does not fit, the buffer is flushed. Data bigger than the whole buffer is written directly
+*/
+buf_t bufrdeco_out_write ( struct bufrdeco_output_buffer *ob, const char *data, size_t len )
+{
+  if ( ob->len + len > sizeof ( ob->s ) )
+    {
+      bufrdeco_out_flush ( ob );
+      if ( len > sizeof ( ob->s ) )
+        {
+          if ( fwrite ( data, 1, len, ob->out ) != len )
+            ob->error = 1;
+          ob->used += len;
+          return len;
+        }
+    }
+  memcpy ( ob->s + ob->len, data, len );
+  ob->len += len;
+  ob->used += len;
+  return len;
+}
+
+/*!
+  \fn buf_t bufrdeco_out_puts ( struct bufrdeco_output_buffer *ob, const char *str )
+  \brief Append a nul terminated string to an output buffer
+  \param [in,out] ob Pointer to struct \ref bufrdeco_output_buffer
+  \param [in] str String to append
+  \return The amount of bytes appended
+*/
+buf_t bufrdeco_out_puts ( struct bufrdeco_output_buffer *ob, const char *str )
+{
+  return bufrdeco_out_write ( ob, str, strlen ( str ) );
+}
+
+/*!
+  \fn buf_t bufrdeco_out_putc ( struct bufrdeco_output_buffer *ob, char c )
+  \brief Append a char to an output buffer
+  \param [in,out] ob Pointer to struct \ref bufrdeco_output_buffer
+  \param [in] c Char to append
+  \return The amount of bytes appended
+*/
+buf_t bufrdeco_out_putc ( struct bufrdeco_output_buffer *ob, char c )
+{
+  if ( ob->len == sizeof ( ob->s ) )
+    bufrdeco_out_flush ( ob );
+  ob->s[ob->len++] = c;
+  ob->used++;
+  return 1;
+}
+
+/*!
+  \fn size_t bufrdeco_format_uint ( char *target, size_t dim, uint64_t u, int width )
+  \brief Write an unsigned integer in decimal, as printf(3) with "%0*llu"
+  \param [out] target String where to write. It is nul terminated
+  \param [in] dim Size of \a target. At least 21 bytes or \a width + 1 if bigger
+  \param [in] u Value to write
+  \param [in] width Minimum number of digits, padding with zeroes at left
+  \return The number of chars written, not counting final nul. 0 if no room
+*/
+size_t bufrdeco_format_uint ( char *target, size_t dim, uint64_t u, int width )
+{
+  char aux[24];
+  size_t n = 0, i;
+
+  do
+    {
+      aux[n++] = '0' + ( char ) ( u % 10 );
+      u /= 10;
+    }
+  while ( u );
+
+  i = ( width > 0 && ( size_t ) width > n ) ? ( size_t ) width : n;
+  if ( i >= dim )
+    return 0;
+
+  // zero padding and digits in reverse order
+  target[i] = '\0';
+  for ( i = 0; ( int ) ( i + n ) < width; i++ )
+    target[i] = '0';
+  while ( n )
+    target[i++] = aux[--n];
+  return i;
+}
+
+/*!
+  \fn size_t bufrdeco_format_fixed ( char *target, size_t dim, double val, int decimals )
+  \brief Write a double in fixed point notation, as printf(3) with "%.*lf"
+  \param [out] target String where to write. It is nul terminated
+  \param [in] dim Size of \a target
+  \param [in] val Value to write
+  \param [in] decimals Number of decimals
+  \return The number of chars written, not counting final nul
+
+  The common case is done with integer arithmetic. When the value is too big, is not finite, or is so close to a
+  rounding tie that the result may differ from printf(3), it falls back to snprintf, so the output is always the same
+*/
+size_t bufrdeco_format_fixed ( char *target, size_t dim, double val, int decimals )
+{
+  double scaled, r, frac;
+  uint64_t n, ip, fp;
+  size_t used = 0, k;
+  int i;
+
+  if ( decimals < 0 )
+    decimals = 0;
+
+  if ( decimals > 9 || !isfinite ( val ) )
+    goto fallback;
+
+  // Below 1e9 the rounding error of product is less than 1e-7, so a result far from a tie is the same as printf(3)
+  scaled = fabs ( val ) * POW10_U64[decimals];
+  if ( scaled >= 1e9 )
+    goto fallback;
+  r = floor ( scaled );
+  frac = scaled - r;
+  if ( fabs ( frac - 0.5 ) < 1e-6 )
+    goto fallback;
+
+  n = ( uint64_t ) r + ( frac > 0.5 ? 1 : 0 );
+  ip = n / POW10_U64[decimals];
+  fp = n % POW10_U64[decimals];
+
+  if ( dim < 24 + ( size_t ) decimals )
+    goto fallback;
+
+  if ( signbit ( val ) )
+    target[used++] = '-';
+  used += bufrdeco_format_uint ( target + used, dim - used, ip, 0 );
+  if ( decimals )
+    {
+      target[used++] = '.';
+      for ( i = decimals - 1, k = used; i >= 0; i-- )
+        {
+          target[k + i] = '0' + ( char ) ( fp % 10 );
+          fp /= 10;
+        }
+      used += decimals;
+      target[used] = '\0';
+    }
+  return used;
+
+fallback:
+  i = snprintf ( target, dim, "%.*lf", decimals, val );
+  if ( i < 0 )
+    return 0;
+  return ( ( size_t ) i < dim ) ? ( size_t ) i : dim - 1;
+}
+
+/*!
+  \fn buf_t bufrdeco_out_uint ( struct bufrdeco_output_buffer *ob, uint64_t u, int width )
+  \brief Append an unsigned integer in decimal to an output buffer
+  \param [in,out] ob Pointer to struct \ref bufrdeco_output_buffer
+  \param [in] u Value to append
+  \param [in] width Minimum number of digits, padding with zeroes at left. Up to 32
+  \return The amount of bytes appended
+*/
+buf_t bufrdeco_out_uint ( struct bufrdeco_output_buffer *ob, uint64_t u, int width )
+{
+  char aux[40];
+
+  if ( width > 32 )
+    width = 32;
+  return bufrdeco_out_write ( ob, aux, bufrdeco_format_uint ( aux, sizeof ( aux ), u, width ) );
+}
+
+/*!
+  \fn buf_t bufrdeco_out_int ( struct bufrdeco_output_buffer *ob, int64_t i )
+  \brief Append a signed integer in decimal to an output buffer
+  \param [in,out] ob Pointer to struct \ref bufrdeco_output_buffer
+  \param [in] i Value to append
+  \return The amount of bytes appended
+*/
+buf_t bufrdeco_out_int ( struct bufrdeco_output_buffer *ob, int64_t i )
+{
+  char aux[24];
+  size_t n = 0;
+
+  if ( i < 0 )
+    {
+      aux[n++] = '-';
+      n += bufrdeco_format_uint ( aux + n, sizeof ( aux ) - n, ( uint64_t ) ( - ( i + 1 ) ) + 1, 0 );
+    }
+  else
+    n = bufrdeco_format_uint ( aux, sizeof ( aux ), ( uint64_t ) i, 0 );
+  return bufrdeco_out_write ( ob, aux, n );
+}
+
+/*!
+  \fn buf_t bufrdeco_out_hex ( struct bufrdeco_output_buffer *ob, uint64_t u, int width )
+  \brief Append an unsigned integer in uppercase hexadecimal, as printf(3) with "%0*X"
+  \param [in,out] ob Pointer to struct \ref bufrdeco_output_buffer
+  \param [in] u Value to append
+  \param [in] width Minimum number of digits, padding with zeroes at left. Up to 16
+  \return The amount of bytes appended
+*/
+buf_t bufrdeco_out_hex ( struct bufrdeco_output_buffer *ob, uint64_t u, int width )
+{
+  char aux[16];
+  size_t n = 0, k;
+
+  do
+    {
+      aux[sizeof ( aux ) - 1 - n++] = HEX_DIGITS[u & 0x0F];
+      u >>= 4;
+    }
+  while ( u );
+  for ( k = n; ( int ) k < width && k < sizeof ( aux ); k++ )
+    aux[sizeof ( aux ) - 1 - k] = '0';
+  return bufrdeco_out_write ( ob, aux + sizeof ( aux ) - k, k );
+}
+
+/*!
+  \fn buf_t bufrdeco_out_fixed ( struct bufrdeco_output_buffer *ob, double val, int decimals )
+  \brief Append a double in fixed point notation, as printf(3) with "%.*lf"
+  \param [in,out] ob Pointer to struct \ref bufrdeco_output_buffer
+  \param [in] val Value to append
+  \param [in] decimals Number of decimals
+  \return The amount of bytes appended
+*/
+buf_t bufrdeco_out_fixed ( struct bufrdeco_output_buffer *ob, double val, int decimals )
+{
+  char aux[512];
+
+  return bufrdeco_out_write ( ob, aux, bufrdeco_format_fixed ( aux, sizeof ( aux ), val, decimals ) );
+}
+
+/*!
+  \fn buf_t bufrdeco_out_json_string ( struct bufrdeco_output_buffer *ob, const char *source )
+  \brief Append a string escaped to be the content of a json string
+  \param [in,out] ob Pointer to struct \ref bufrdeco_output_buffer
+  \param [in] source Source string
+  \return The amount of bytes appended
+
+  The '"' and '\\' are escaped with a backslash. Control chars are written as \\u00XX. The runs of chars which do not
+  need escape are appended at once
+*/
+buf_t bufrdeco_out_json_string ( struct bufrdeco_output_buffer *ob, const char *source )
+{
+  const char *c, *run = source;
+  buf_t used = 0;
+  char aux[8];
+
+  for ( c = source; *c; c++ )
+    {
+      if ( *c != '"' && *c != '\\' && ( unsigned char ) *c >= 0x20 )
+        continue;
+
+      used += bufrdeco_out_write ( ob, run, c - run );
+      if ( *c == '"' || *c == '\\' )
+        {
+          aux[0] = '\\';
+          aux[1] = *c;
+          used += bufrdeco_out_write ( ob, aux, 2 );
+        }
+      else
+        {
+          memcpy ( aux, "\\u00", 4 );
+          aux[4] = HEX_DIGITS[ ( ( unsigned char ) *c ) >> 4];
+          aux[5] = HEX_DIGITS[ ( ( unsigned char ) *c ) & 0x0F];
+          used += bufrdeco_out_write ( ob, aux, 6 );
+        }
+      run = c + 1;
+    }
+  used += bufrdeco_out_write ( ob, run, c - run );
+  return used;
+}
+
+/*!
+  \fn buf_t bufrdeco_out_printf ( struct bufrdeco_output_buffer *ob, const char *format, ... )
+  \brief Append formatted output as printf(3). To use in cases not covered by the other formatters
+  \param [in,out] ob Pointer to struct \ref bufrdeco_output_buffer
+  \param [in] format Format string
+  \return The amount of bytes appended
+*/
+buf_t bufrdeco_out_printf ( struct bufrdeco_output_buffer *ob, const char *format, ... )
+{
+  va_list ap;
+  int n;
+
+  // Try to write directly in the free part of buffer
+  va_start ( ap, format );
+  n = vsnprintf ( ob->s + ob->len, sizeof ( ob->s ) - ob->len, format, ap );
+  va_end ( ap );
+  if ( n < 0 )
+    return 0;
+  if ( ( size_t ) n < sizeof ( ob->s ) - ob->len )
+    {
+      ob->len += n;
+      ob->used += n;
+      return n;
+    }
+
+  // Does not fit. Flush and retry in an empty buffer, or write directly if too big
+  bufrdeco_out_flush ( ob );
+  va_start ( ap, format );
+  if ( ( size_t ) n < sizeof ( ob->s ) )
+    {
+      vsnprintf ( ob->s, sizeof ( ob->s ), format, ap );
+      ob->len = n;
+    }
+  else if ( vfprintf ( ob->out, format, ap ) < 0 )
+    ob->error = 1;
+  va_end ( ap );
+  ob->used += n;
+  return n;
+}
@@ -306,9 +306,9 @@ int bufrdeco_fprint_tree_recursive ( FILE *f, struct bufrdeco *b, struct bufr_se
                     }
                   if ( is_a_delayed_descriptor ( & l->lseq[i] ) ||
                        is_a_short_delayed_descriptor ( & l->lseq[i] ) )
-                    fprintf ( f, "* %s\n", b->tables->b.item[k].name );
+                    fprintf ( f, "* %s\n", bufr_strings_get ( & ( b->tables->b.strings ), b->tables->b.item[k].name_ofs ) );
                   else
-                    fprintf ( f, " %s\n", b->tables->b.item[k].name );
+                    fprintf ( f, " %s\n", bufr_strings_get ( & ( b->tables->b.strings ), b->tables->b.item[k].name_ofs ) );
                 }
             }
           else if ( l->lseq[i].f == 2 )
@@ -28,7 +28,7 @@
   \brief Read bufr file and does preliminary and first decode pass
   \param [in,out] b Pointer to struct \ref bufrdeco
   \param [in] filename Complete path of BUFR file
-  \return 0 if all is OK, 1 otherwise
+  \return 0 if all is OK, \ref BUFRDECO_DUPLICATED if skipped as duplicated, 1 otherwise
 
   This function does the folowing tasks:
   - Read the file and checks the marks at the begining and end to see wheter is a BUFR file
@@ -47,6 +47,9 @@ int bufrdeco_read_bufr(struct bufrdeco* b, char* filename)
 
     bufrdeco_assert(b != NULL);
 
+    // The file reading is accounted in the read phase of bufrdeco_read_buffer()
+    b->stats.read_start = bufrdeco_stats_clock(b);
+
     /* Stat input file */
     if (stat(filename, &st) < 0) {
         snprintf(b->error, sizeof(b->error), "%s(): cannot stat file '%s'\n", __func__, filename);
@@ -99,7 +102,7 @@ int bufrdeco_read_bufr(struct bufrdeco* b, char* filename)
   \param [in,out] b Pointer to struct \ref bufrdeco
   \param [in] filename Complete path of BUFR file
   \param [in] bufr_xout If != NULL and strlen(bufrout) != 0 then it writes the extracted bufrfile to a file named as argument
-  \return 0 if all is OK, 1 otherwise
+  \return 0 if all is OK, \ref BUFRDECO_DUPLICATED if skipped as duplicated, 1 otherwise
 
   This function does the folowing tasks:
   - Try to find first buffer of bytes begining with 'BUFR' chars and ending with '7777'. This will be considered as a bufr file.
@@ -119,6 +122,9 @@ int bufrdeco_extract_bufr(struct bufrdeco* b, char* filename, const char* bufr_x
 
     bufrdeco_assert(b != NULL);
 
+    // The file reading is accounted in the read phase of bufrdeco_read_buffer()
+    b->stats.read_start = bufrdeco_stats_clock(b);
+
     /* Stat input file */
     if (stat(filename, &st) < 0) {
         snprintf(b->error, sizeof(b->error), "%s(): cannot stat file '%s'\n", __func__, filename);
@@ -204,7 +210,7 @@ int bufrdeco_extract_bufr(struct bufrdeco* b, char* filename, const char* bufr_x
   \param [in,out] b Pointer to struct \ref bufrdeco
   \param [in] bufrx Buffer already allocated by caller
   \param [in] size Size of BUFR in buffer
-  \return 0 if all is OK, 1 otherwise
+  \return 0 if all is OK, \ref BUFRDECO_DUPLICATED if skipped as duplicated, 1 otherwise
 
   This function does the folowing tasks:
   - Splits and parse the BUFR sections (without expanding descriptors nor parsing data)
@@ -215,9 +221,14 @@ int bufrdeco_read_buffer(struct bufrdeco* b, uint8_t* bufrx, buf_t size)
 {
     uint8_t* c;
     buf_t ix, ud;
+    uint64_t t0;
 
     bufrdeco_assert(b != NULL);
 
+    if ((t0 = b->stats.read_start) == 0)
+        t0 = bufrdeco_stats_clock(b);
+    b->stats.read_start = 0;
+
     // Some fast checks
     if ((size + 4) >= BUFR_LEN) {
         snprintf(b->error, sizeof(b->error), "%s(): Buffer provided too large. Consider increase BUFR_LEN\n", __func__);
@@ -389,17 +400,23 @@ int bufrdeco_read_buffer(struct bufrdeco* b, uint8_t* bufrx, buf_t size)
 
     b->sec4.bit_offset = 32; // the first bit in byte 4
 
-#ifdef DEBUG_TIME
-    bufrdeco_clock_start = clock();
-#endif
+    if (bufrdeco_stats_add(b, BUFRDECO_STATS_READ, t0) == 0) {
+        b->stats.messages++;
+        b->stats.bytes += size;
+    }
+
+    // Skip an exact repeat of a message already seen before loading tables
+    if ((b->mask & BUFRDECO_SKIP_DUPLICATES) && bufrdeco_dedup_check(&b->dedup, bufrdeco_message_hash(b))) {
+        b->stats.duplicates++;
+        snprintf(b->error, sizeof(b->error), "%s(): Duplicated message skipped\n", __func__);
+        return BUFRDECO_DUPLICATED;
+    }
 
+    t0 = bufrdeco_stats_clock(b);
     if (bufr_read_tables(b)) {
         return 1;
     }
-#ifdef DEBUG_TIME
-    bufrdeco_clock_end = clock();
-    print_timing(bufrdeco_clock_start, bufrdeco_clock_end, bufr_read_tables_wmo());
-#endif
+    bufrdeco_stats_add(b, BUFRDECO_STATS_TABLES, t0);
 
     return 0;
 }
@@ -415,7 +432,8 @@ int bufrdeco_read_buffer(struct bufrdeco* b, uint8_t* bufrx, buf_t size)
   \return 0 if all is OK, 1 otherwise
 
    This function is useful when we want to know the edition number and some metadata of the file before doing any parsing. 
-   It only reads secs 0, 1, and 3 of from file without parsing anything further.   
+   It only reads secs 0, 1, and 3 of from file without parsing anything further. A first chunk of bytes is read and, only
+   if secs 1 to 3 do not fit in it, the whole message is read again.
 */
 int bufrdeco_fast_read_sec_0_1_3(struct bufr_sec0* s0, struct bufr_sec1* s1, struct bufr_sec3* s3, char* filename, char* error, size_t error_size)
 {
@@ -433,15 +451,75 @@ int bufrdeco_fast_read_sec_0_1_3(struct bufr_sec0* s0, struct bufr_sec1* s1, str
         return 1;
     }
 
-    uint8_t sec0_1[30];
-    if (fread(sec0_1, 1, sizeof(sec0_1), fp) != sizeof(sec0_1)) {
+    uint8_t head[BUFR_LEN_SEC3 + 512];
+    uint8_t* buff;
+    size_t n, needed;
+    int res;
+
+    if ((n = fread(head, 1, sizeof(head), fp)) < 30) {
         snprintf(error, error_size, "%s(): Cannot read sec0/sec1 from file %s\n", __func__, filename);
         fclose(fp);
         return 1;
     }
 
+    // Most of times sec1, sec2 and sec3 fit in the first chunk
+    needed = bufrdeco_sec_0_1_3_length(head, n);
+    if (needed <= n) {
+        fclose(fp);
+        return bufrdeco_get_sec_0_1_3_from_buffer(s0, s1, s3, head, n, error, error_size);
+    }
+
+    if ((buff = (uint8_t*)malloc(BUFR_LEN)) == NULL) {
+        snprintf(error, error_size, "%s(): Cannot allocate memory\n", __func__);
+        fclose(fp);
+        return 1;
+    }
+    memcpy(buff, head, n);
+
+    // The needed length can grow as the lengths of sec1 and sec2 are known
+    while (needed > n) {
+        if (needed > BUFR_LEN || fread(buff + n, 1, needed - n, fp) != needed - n) {
+            snprintf(error, error_size, "%s(): Cannot read sec3 from file %s\n", __func__, filename);
+            free(buff);
+            fclose(fp);
+            return 1;
+        }
+        n = needed;
+        needed = bufrdeco_sec_0_1_3_length(buff, n);
+    }
     fclose(fp);
-    return bufrdeco_get_sec_0_1_3_from_buffer(s0, s1, s3, (const uint8_t*)sec0_1, sizeof(sec0_1), error, error_size);
+    res = bufrdeco_get_sec_0_1_3_from_buffer(s0, s1, s3, buff, n, error, error_size);
+    free(buff);
+    return res;
+}
+
+/*! \fn size_t bufrdeco_sec_0_1_3_length(const uint8_t* buff, size_t size)
+  \brief Get the number of bytes from the begin of a BUFR message to the end of sec3
+  \param [in] buff Pointer to the buffer with the first bytes of the BUFR message
+  \param [in] size Number of available bytes in buff
+  \return The number of bytes needed. If it is greater than size, the value can be a lower limit when the lengths of
+  some sections are not yet in buff, so the caller have to read more bytes and call it again.
+*/
+size_t bufrdeco_sec_0_1_3_length(const uint8_t* buff, size_t size)
+{
+    size_t ix;
+    uint8_t options;
+
+    if (size < 30)
+        return 30;
+
+    // options flag in sec1, sec2 is present if the bit 1 is set
+    options = (buff[7] == 3) ? buff[8 + 7] : buff[8 + 9];
+
+    ix = 8 + three_bytes_to_uint32(&buff[8]);
+    if (options & 0x80) {
+        if (ix + 3 > size)
+            return ix + 3;
+        ix += three_bytes_to_uint32(&buff[ix]);
+    }
+    if (ix + 7 > size)
+        return ix + 7;
+    return ix + three_bytes_to_uint32(&buff[ix]);
 }
 
 /*! \fn int bufrdeco_get_sec_0_1_3_from_buffer(struct bufr_sec0* s0, struct bufr_sec1* s1, struct bufr_sec3* s3, const uint8_t* buff, size_t size, char* error, size_t error_size)
@@ -456,8 +534,9 @@ int bufrdeco_fast_read_sec_0_1_3(struct bufr_sec0* s0, struct bufr_sec1* s1, str
   \return 0 if all is OK, 1 otherwise
 
     This function is useful when we want to know the edition number and some metadata of the file before doing any parsing. 
-    It only reads the first 30 bytes of the buffer to do it. It is used by bufrdeco_fast_read_sec_0_1_3() but can be also used 
-    when we already have the data in a buffer and we want just to read sec0, sec1, and sec3.   
+    The buffer must include all bytes up to the end of sec3, as returned by bufrdeco_sec_0_1_3_length(). It is used by
+    bufrdeco_fast_read_sec_0_1_3() but can be also used when we already have the data in a buffer and we want just to read
+    sec0, sec1, and sec3.
 */
 int bufrdeco_get_sec_0_1_3_from_buffer(struct bufr_sec0* s0, struct bufr_sec1* s1, struct bufr_sec3* s3, const uint8_t* buff, size_t size, char* error, size_t error_size)
 {
@@ -477,6 +556,12 @@ int bufrdeco_get_sec_0_1_3_from_buffer(struct bufr_sec0* s0, struct bufr_sec1* s
         snprintf(error, error_size, "%s(): bufr file does not begin with 'BUFR' chars\n", __func__);
         return 1;
     }
+
+    // check that sec3 is complete in the buffer
+    if (bufrdeco_sec_0_1_3_length(buff, size) > size) {
+        snprintf(error, error_size, "%s(): buffer of %zu bytes does not include the whole sec3\n", __func__, size);
+        return 1;
+    }
     
 
     // length of whole message
@@ -542,6 +627,10 @@ int bufrdeco_get_sec_0_1_3_from_buffer(struct bufr_sec0* s0, struct bufr_sec1* s
     } 
     const uint8_t* sec3 = (const uint8_t*)(buff + 8 + s1->length + sec2_length); // pointer to begin of sec3
     s3->length = three_bytes_to_uint32(sec3);
+    if (s3->length < 8 || s3->length > BUFR_LEN_SEC3) {
+        snprintf(error, error_size, "%s(): Bad length %u of sec3\n", __func__, s3->length);
+        return 1;
+    }
     s3->subsets = two_bytes_to_uint32(&sec3[4]);
     if (sec3[6] & 0x80)
         s3->observed = 1;
@@ -0,0 +1,430 @@
+/***************************************************************************
+ *   Copyright (C) 2013-2026 by Guillermo Ballester Valor                  *
+ *   gbv@ogimet.com                                                        *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.             *
+ ***************************************************************************/
+/*!
+ \file bufrdeco_snapshot.c
+ \brief This file has the code to write and read snapshots, binary files with the decoded subsets of a message
+
+ The decoded subsets are added to a struct \ref bufrdeco_snapshot_builder as they are got and then written at once.
+ Names, units and string values are stored once in a table of strings, so a snapshot is a small fraction of the
+ size of the decoded structs. A snapshot is read mapping it in memory, and its subsets are got as a struct
+ \ref bufrdeco_subset_sequence_data without the tables nor the BUFR message
+*/
+#include "bufrdeco.h"
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+
+/*!
+  \fn static uint32_t bufrdeco_snapshot_string_hash(const char* s)
+  \brief FNV-1a hash of a string
+*/
+static uint32_t bufrdeco_snapshot_string_hash(const char* s)
+{
+    uint32_t hash = 2166136261U;
+
+    for (; *s; s++)
+        hash = (hash ^ (uint8_t)*s) * 16777619U;
+    return hash;
+}
+
+/*!
+  \fn static int bufrdeco_snapshot_grow_slots(struct bufrdeco_snapshot_builder* sb)
+  \brief Double the hash table of strings of a builder, adding again the strings already in table
+*/
+static int bufrdeco_snapshot_grow_slots(struct bufrdeco_snapshot_builder* sb)
+{
+    uint32_t *slot, nslot, i, j;
+
+    nslot = sb->nslot ? 2 * sb->nslot : 1024;
+    if ((slot = (uint32_t*)calloc(nslot, sizeof(uint32_t))) == NULL)
+        return 1;
+    for (i = 0; i < sb->nslot; i++) {
+        if (sb->slot[i] == 0)
+            continue;
+        for (j = bufrdeco_snapshot_string_hash(sb->str + sb->slot[i]) & (nslot - 1); slot[j]; j = (j + 1) & (nslot - 1))
+            ;
+        slot[j] = sb->slot[i];
+    }
+    free(sb->slot);
+    sb->slot = slot;
+    sb->nslot = nslot;
+    return 0;
+}
+
+/*!
+  \fn static int bufrdeco_snapshot_add_string(struct bufrdeco_snapshot_builder* sb, const char* s, uint32_t* offset)
+  \brief Get the offset of a string in the table of a builder, adding it if not there
+  \param [in,out] sb pointer to the builder
+  \param [in] s the string
+  \param [out] offset the offset of string in table
+  \return 0 if succeeded, 1 otherwise
+*/
+static int bufrdeco_snapshot_add_string(struct bufrdeco_snapshot_builder* sb, const char* s, uint32_t* offset)
+{
+    size_t len;
+    uint32_t i, dim;
+    char* str;
+
+    // offset 0 is always the empty string
+    if (s[0] == '\0') {
+        *offset = 0;
+        return 0;
+    }
+
+    // kept at most half full
+    if (2 * (sb->nused + 1) > sb->nslot && bufrdeco_snapshot_grow_slots(sb))
+        return 1;
+
+    for (i = bufrdeco_snapshot_string_hash(s) & (sb->nslot - 1); sb->slot[i]; i = (i + 1) & (sb->nslot - 1)) {
+        if (strcmp(sb->str + sb->slot[i], s) == 0) {
+            *offset = sb->slot[i];
+            return 0;
+        }
+    }
+
+    len = strlen(s) + 1;
+    if (sb->lstr + len > sb->dstr) {
+        for (dim = sb->dstr ? sb->dstr : 4096; dim < sb->lstr + len; dim *= 2)
+            ;
+        if ((str = (char*)realloc(sb->str, dim)) == NULL)
+            return 1;
+        sb->str = str;
+        sb->dstr = dim;
+    }
+    if (sb->lstr == 0)
+        sb->str[sb->lstr++] = '\0';
+    memcpy(sb->str + sb->lstr, s, len);
+    sb->slot[i] = sb->lstr;
+    sb->nused++;
+    *offset = sb->lstr;
+    sb->lstr += len;
+    return 0;
+}
+
+/*!
+  \fn int bufrdeco_snapshot_add_subset(struct bufrdeco_snapshot_builder* sb, const struct bufrdeco_subset_sequence_data* s)
+  \brief Add a decoded subset to a snapshot being built
+  \param [in,out] sb pointer to the builder. A zeroed struct is a valid empty builder
+  \param [in] s pointer to the decoded subset, as got with \ref bufrdeco_get_target_subset_sequence_data
+  \return 0 if succeeded, 1 otherwise
+*/
+int bufrdeco_snapshot_add_subset(struct bufrdeco_snapshot_builder* sb, const struct bufrdeco_subset_sequence_data* s)
+{
+    struct bufrdeco_snapshot_subset* sub;
+    struct bufrdeco_snapshot_atom* t;
+    const struct bufr_atom_data* a;
+    uint64_t dim;
+    buf_t i;
+
+    bufrdeco_assert_with_return_val(sb != NULL && s != NULL, 1);
+
+    if (sb->nsub == sb->dsub) {
+        dim = sb->dsub ? 2 * sb->dsub : 64;
+        if ((sub = (struct bufrdeco_snapshot_subset*)realloc(sb->sub, dim * sizeof(struct bufrdeco_snapshot_subset))) == NULL)
+            return 1;
+        sb->sub = sub;
+        sb->dsub = dim;
+    }
+    if (sb->natom + s->nd > sb->datom) {
+        for (dim = sb->datom ? sb->datom : 1024; dim < sb->natom + s->nd; dim *= 2)
+            ;
+        if ((t = (struct bufrdeco_snapshot_atom*)realloc(sb->atom, dim * sizeof(struct bufrdeco_snapshot_atom))) == NULL)
+            return 1;
+        sb->atom = t;
+        sb->datom = dim;
+    }
+
+    for (i = 0; i < s->nd; i++) {
+        a = &s->sequence[i];
+        t = &sb->atom[sb->natom + i];
+        memset(t, 0, sizeof(struct bufrdeco_snapshot_atom));
+        t->val = a->val;
+        t->escale = a->escale;
+        t->mask = a->mask;
+        t->f = a->desc.f;
+        t->x = a->desc.x;
+        t->y = a->desc.y;
+        t->associated = a->associated;
+        t->associated_to = a->associated_to;
+        t->ns = a->ns;
+        t->me = a->me;
+        t->bitac = a->bitac;
+        t->is_bitmaped_by = a->is_bitmaped_by;
+        t->bitmap_to = a->bitmap_to;
+        t->related_to = a->related_to;
+        if (bufrdeco_snapshot_add_string(sb, a->name, &t->name) || bufrdeco_snapshot_add_string(sb, a->unit, &t->unit)
+            || bufrdeco_snapshot_add_string(sb, a->cval, &t->cval) || bufrdeco_snapshot_add_string(sb, a->ctable, &t->ctable))
+            return 1;
+    }
+
+    sub = &sb->sub[sb->nsub++];
+    sub->ss = s->ss;
+    sub->nd = s->nd;
+    sub->first = sb->natom;
+    sb->natom += s->nd;
+    return 0;
+}
+
+/*!
+  \fn static uint64_t bufrdeco_snapshot_align(uint64_t offset)
+  \brief Round up an offset to a multiple of 8
+*/
+static uint64_t bufrdeco_snapshot_align(uint64_t offset)
+{
+    return (offset + 7) & ~(uint64_t)7;
+}
+
+/*!
+  \fn int bufrdeco_snapshot_write(const struct bufrdeco_snapshot_builder* sb, uint64_t hash, const char* filename)
+  \brief Write the subsets added to a builder in a snapshot file
+  \param [in] sb pointer to the builder
+  \param [in] hash hash of message, as got with \ref bufrdeco_message_hash
+  \param [in] filename pathname of file. It is written with a temporary name and then renamed
+  \return 0 if succeeded, 1 otherwise
+*/
+int bufrdeco_snapshot_write(const struct bufrdeco_snapshot_builder* sb, uint64_t hash, const char* filename)
+{
+    struct bufrdeco_snapshot_header h;
+    char tmp[BUFRDECO_PATH_LENGTH + 32];
+    static const char zero[8] = { 0 };
+    const char* empty = "";
+    FILE* f;
+    int e;
+
+    bufrdeco_assert_with_return_val(sb != NULL && filename != NULL, 1);
+
+    memset(&h, 0, sizeof(h));
+    strcpy(h.magic, BUFRDECO_SNAPSHOT_MAGIC);
+    h.version = BUFRDECO_SNAPSHOT_VERSION;
+    h.byte_order = BUFRDECO_INDEX_BYTE_ORDER;
+    h.header_size = sizeof(struct bufrdeco_snapshot_header);
+    h.subset_size = sizeof(struct bufrdeco_snapshot_subset);
+    h.atom_size = sizeof(struct bufrdeco_snapshot_atom);
+    h.nsubsets = sb->nsub;
+    h.hash = hash;
+    h.natoms = sb->natom;
+    h.subsets_offset = bufrdeco_snapshot_align(sizeof(h));
+    h.atoms_offset = bufrdeco_snapshot_align(h.subsets_offset + (uint64_t)sb->nsub * sizeof(struct bufrdeco_snapshot_subset));
+    h.strings_offset = h.atoms_offset + sb->natom * sizeof(struct bufrdeco_snapshot_atom);
+    // at least the empty string at offset 0
+    h.strings_size = sb->lstr ? sb->lstr : 1;
+
+    snprintf(tmp, sizeof(tmp), "%s.%ld.tmp", filename, (long)getpid());
+    if ((f = fopen(tmp, "w")) == NULL)
+        return 1;
+
+    e = fwrite(&h, sizeof(h), 1, f) != 1;
+    if (e == 0 && sizeof(h) < h.subsets_offset)
+        e = fwrite(zero, h.subsets_offset - sizeof(h), 1, f) != 1;
+    if (e == 0 && sb->nsub)
+        e = fwrite(sb->sub, sizeof(struct bufrdeco_snapshot_subset), sb->nsub, f) != sb->nsub;
+    if (e == 0 && h.subsets_offset + (uint64_t)sb->nsub * sizeof(struct bufrdeco_snapshot_subset) < h.atoms_offset)
+        e = fwrite(zero, h.atoms_offset - h.subsets_offset - sb->nsub * sizeof(struct bufrdeco_snapshot_subset), 1, f) != 1;
+    if (e == 0 && sb->natom)
+        e = fwrite(sb->atom, sizeof(struct bufrdeco_snapshot_atom), sb->natom, f) != sb->natom;
+    if (e == 0)
+        e = fwrite(sb->lstr ? sb->str : empty, h.strings_size, 1, f) != 1;
+
+    if (fclose(f) || e || rename(tmp, filename)) {
+        remove(tmp);
+        return 1;
+    }
+    return 0;
+}
+
+/*!
+  \fn int bufrdeco_snapshot_clean(struct bufrdeco_snapshot_builder* sb)
+  \brief Remove all the subsets of a builder, keeping the allocated memory to build the next snapshot
+  \param [in,out] sb pointer to the builder
+  \return 0 if succeeded
+*/
+int bufrdeco_snapshot_clean(struct bufrdeco_snapshot_builder* sb)
+{
+    bufrdeco_assert(sb != NULL);
+
+    sb->nsub = 0;
+    sb->natom = 0;
+    sb->lstr = 0;
+    sb->nused = 0;
+    if (sb->slot != NULL)
+        memset(sb->slot, 0, sb->nslot * sizeof(uint32_t));
+    return 0;
+}
+
+/*!
+  \fn int bufrdeco_snapshot_free(struct bufrdeco_snapshot_builder* sb)
+  \brief Free the memory of a builder
+  \param [in,out] sb pointer to the builder
+  \return 0 if succeeded
+*/
+int bufrdeco_snapshot_free(struct bufrdeco_snapshot_builder* sb)
+{
+    bufrdeco_assert(sb != NULL);
+
+    free(sb->sub);
+    free(sb->atom);
+    free(sb->str);
+    free(sb->slot);
+    memset(sb, 0, sizeof(struct bufrdeco_snapshot_builder));
+    return 0;
+}
+
+/*!
+  \fn int bufrdeco_snapshot_open(struct bufrdeco_snapshot* sn, const char* filename)
+  \brief Map a snapshot file in memory
+  \param [out] sn pointer to the target struct \ref bufrdeco_snapshot
+  \param [in] filename pathname of the snapshot file
+  \return 0 if succeeded, 1 if the file cannot be mapped or it is not valid
+*/
+int bufrdeco_snapshot_open(struct bufrdeco_snapshot* sn, const char* filename)
+{
+    const struct bufrdeco_snapshot_header* h;
+    struct stat st;
+    uint32_t i;
+    int fd;
+
+    bufrdeco_assert_with_return_val(sn != NULL && filename != NULL, 1);
+
+    memset(sn, 0, sizeof(struct bufrdeco_snapshot));
+    if ((fd = open(filename, O_RDONLY)) < 0)
+        return 1;
+    if (fstat(fd, &st) < 0 || (size_t)st.st_size < sizeof(struct bufrdeco_snapshot_header)) {
+        close(fd);
+        return 1;
+    }
+    sn->map = mmap(NULL, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (sn->map == MAP_FAILED) {
+        sn->map = NULL;
+        return 1;
+    }
+    sn->size = st.st_size;
+
+    // Checks of layout
+    h = (const struct bufrdeco_snapshot_header*)sn->map;
+    if (memcmp(h->magic, BUFRDECO_SNAPSHOT_MAGIC, sizeof(BUFRDECO_SNAPSHOT_MAGIC)) || h->version != BUFRDECO_SNAPSHOT_VERSION
+        || h->byte_order != BUFRDECO_INDEX_BYTE_ORDER || h->header_size != sizeof(struct bufrdeco_snapshot_header)
+        || h->subset_size != sizeof(struct bufrdeco_snapshot_subset) || h->atom_size != sizeof(struct bufrdeco_snapshot_atom)
+        || h->subsets_offset + (uint64_t)h->nsubsets * sizeof(struct bufrdeco_snapshot_subset) > sn->size
+        || h->natoms > sn->size || h->atoms_offset + h->natoms * sizeof(struct bufrdeco_snapshot_atom) > sn->size
+        || h->strings_size == 0 || h->strings_offset + h->strings_size != sn->size
+        || ((const char*)sn->map)[sn->size - 1] != '\0') {
+        bufrdeco_snapshot_close(sn);
+        return 1;
+    }
+    sn->header = h;
+    sn->sub = (const struct bufrdeco_snapshot_subset*)((const uint8_t*)sn->map + h->subsets_offset);
+    sn->atom = (const struct bufrdeco_snapshot_atom*)((const uint8_t*)sn->map + h->atoms_offset);
+    sn->str = (const char*)sn->map + h->strings_offset;
+
+    for (i = 0; i < h->nsubsets; i++) {
+        if (sn->sub[i].first + sn->sub[i].nd > h->natoms) {
+            bufrdeco_snapshot_close(sn);
+            return 1;
+        }
+    }
+    return 0;
+}
+
+/*!
+  \fn int bufrdeco_snapshot_close(struct bufrdeco_snapshot* sn)
+  \brief Unmap a snapshot file
+  \param [in,out] sn pointer to the struct \ref bufrdeco_snapshot
+  \return 0 if succeeded
+*/
+int bufrdeco_snapshot_close(struct bufrdeco_snapshot* sn)
+{
+    bufrdeco_assert(sn != NULL);
+
+    if (sn->map != NULL)
+        munmap(sn->map, sn->size);
+    memset(sn, 0, sizeof(struct bufrdeco_snapshot));
+    return 0;
+}
+
+/*!
+  \fn static void bufrdeco_snapshot_get_string(char* target, size_t dim, const struct bufrdeco_snapshot* sn, uint32_t offset)
+  \brief Copy a string of the table of a snapshot. An offset out of table gives an empty string
+*/
+static void bufrdeco_snapshot_get_string(char* target, size_t dim, const struct bufrdeco_snapshot* sn, uint32_t offset)
+{
+    if (offset >= sn->header->strings_size)
+        target[0] = '\0';
+    else
+        strncpy_safe(target, sn->str + offset, dim);
+}
+
+/*!
+  \fn struct bufrdeco_subset_sequence_data* bufrdeco_snapshot_get_subset(const struct bufrdeco_snapshot* sn, buf_t subset, struct bufrdeco_subset_sequence_data* s)
+  \brief Get a subset of a snapshot
+  \param [in] sn pointer to the opened snapshot
+  \param [in] subset index of subset in snapshot, which is not the index in message if not all subsets were added
+  \param [in,out] s pointer to the target struct. It is allocated if needed and freed by caller with
+         \ref bufrdeco_free_subset_sequence_data
+  \return s if succeeded, NULL otherwise
+
+  The member \a seq of every struct \ref bufr_atom_data is NULL, because it points to the tree of a decoder
+*/
+struct bufrdeco_subset_sequence_data* bufrdeco_snapshot_get_subset(const struct bufrdeco_snapshot* sn, buf_t subset,
+    struct bufrdeco_subset_sequence_data* s)
+{
+    const struct bufrdeco_snapshot_subset* sub;
+    const struct bufrdeco_snapshot_atom* t;
+    struct bufr_atom_data* a;
+    buf_t i;
+
+    bufrdeco_assert_with_return_val(sn != NULL && sn->header != NULL && s != NULL, NULL);
+
+    if (subset >= sn->header->nsubsets || bufrdeco_clean_subset_sequence_data(s))
+        return NULL;
+    sub = &sn->sub[subset];
+    while (s->dim < sub->nd) {
+        if (bufrdeco_increase_data_array(s))
+            return NULL;
+    }
+
+    for (i = 0; i < sub->nd; i++) {
+        t = &sn->atom[sub->first + i];
+        a = &s->sequence[i];
+        memset(a, 0, sizeof(struct bufr_atom_data));
+        a->desc.f = t->f;
+        a->desc.x = t->x;
+        a->desc.y = t->y;
+        snprintf(a->desc.c, sizeof(a->desc.c), "%u%02u%03u", a->desc.f, a->desc.x, a->desc.y);
+        a->mask = t->mask;
+        a->val = t->val;
+        a->escale = t->escale;
+        a->associated = t->associated;
+        a->associated_to = t->associated_to;
+        a->ns = t->ns;
+        a->me = t->me;
+        a->bitac = t->bitac;
+        a->is_bitmaped_by = t->is_bitmaped_by;
+        a->bitmap_to = t->bitmap_to;
+        a->related_to = t->related_to;
+        bufrdeco_snapshot_get_string(a->name, sizeof(a->name), sn, t->name);
+        bufrdeco_snapshot_get_string(a->unit, sizeof(a->unit), sn, t->unit);
+        bufrdeco_snapshot_get_string(a->cval, sizeof(a->cval), sn, t->cval);
+        bufrdeco_snapshot_get_string(a->ctable, sizeof(a->ctable), sn, t->ctable);
+    }
+    s->nd = sub->nd;
+    s->ss = sub->ss;
+    return s;
+}
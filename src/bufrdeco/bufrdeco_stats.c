@@ -0,0 +1,140 @@
+/***************************************************************************
+ *   Copyright (C) 2013-2026 by Guillermo Ballester Valor                  *
+ *   gbv@ogimet.com                                                        *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.             *
+ ***************************************************************************/
+/*!
+ \file bufrdeco_stats.c
+ \brief This file has the code to collect and print runtime statistics of bufrdeco library
+*/
+#include "bufrdeco.h"
+
+/*!
+  \brief Names of phases in json output. Same order than enum \ref bufrdeco_stats_phase
+*/
+static const char* BUFRDECO_STATS_PHASE_NAME[BUFRDECO_STATS_PHASES] = { "read", "tables", "tree", "compressed", "subset", "tac" };
+
+/*!
+  \fn const char* bufrdeco_stats_phase_name(enum bufrdeco_stats_phase phase)
+  \brief Get the name of a phase as used in json output
+  \param [in] phase the phase as in enum \ref bufrdeco_stats_phase
+  \return A pointer to the name, or to "unknown" if phase is out of range
+*/
+const char* bufrdeco_stats_phase_name(enum bufrdeco_stats_phase phase)
+{
+    if (phase >= BUFRDECO_STATS_PHASES)
+        return "unknown";
+    return BUFRDECO_STATS_PHASE_NAME[phase];
+}
+
+/*!
+  \fn uint64_t bufrdeco_stats_clock(const struct bufrdeco* b)
+  \brief Get the monotonic time in nanoseconds if statistics are being collected
+  \param [in] b pointer to the active struct \ref bufrdeco
+  \return The time in nanoseconds, or 0 if bit \ref BUFRDECO_COLLECT_STATS is not set
+
+  It is used to mark the start of a phase, which then is passed to \ref bufrdeco_stats_add
+*/
+uint64_t bufrdeco_stats_clock(const struct bufrdeco* b)
+{
+    struct timespec ts;
+
+    if (b == NULL || (b->mask & BUFRDECO_COLLECT_STATS) == 0)
+        return 0;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
+/*!
+  \fn int bufrdeco_stats_add(struct bufrdeco* b, enum bufrdeco_stats_phase phase, uint64_t start)
+  \brief Add a call and the time elapsed since start to a phase
+  \param [in,out] b pointer to the active struct \ref bufrdeco
+  \param [in] phase the phase as in enum \ref bufrdeco_stats_phase
+  \param [in] start time got with \ref bufrdeco_stats_clock at the begin of phase
+  \return 0 if added, 1 if statistics are not being collected
+*/
+int bufrdeco_stats_add(struct bufrdeco* b, enum bufrdeco_stats_phase phase, uint64_t start)
+{
+    uint64_t now;
+
+    if (start == 0 || (now = bufrdeco_stats_clock(b)) == 0 || phase >= BUFRDECO_STATS_PHASES)
+        return 1;
+
+    b->stats.calls[phase]++;
+    b->stats.ns[phase] += now - start;
+    return 0;
+}
+
+/*!
+  \fn int bufrdeco_clean_stats(struct bufrdeco* b)
+  \brief Set to zero all the statistics and mark the start time
+  \param [in,out] b pointer to the active struct \ref bufrdeco
+  \return 0 if succeeded, 1 otherwise
+*/
+int bufrdeco_clean_stats(struct bufrdeco* b)
+{
+    bufrdeco_assert_with_return_val(b != NULL, 1);
+
+    memset(&b->stats, 0, sizeof(struct bufrdeco_stats));
+    b->stats.start = bufrdeco_stats_clock(b);
+    return 0;
+}
+
+/*!
+  \fn buf_t bufrdeco_print_json_stats(FILE* out, const struct bufrdeco* b)
+  \brief Print the runtime statistics as a json object in a single line
+  \param [in] out stream opened by caller
+  \param [in] b pointer to the active struct \ref bufrdeco
+  \return The amount of bytes sent to out
+*/
+buf_t bufrdeco_print_json_stats(FILE* out, const struct bufrdeco* b)
+{
+    size_t used = 0;
+    uint64_t now;
+    int i;
+
+    bufrdeco_assert(b != NULL);
+
+    now = bufrdeco_stats_clock(b);
+    used += fprintf(out, "{\"Elapsed\":%.6lf", (now > b->stats.start && b->stats.start) ? (double)(now - b->stats.start) * 1e-9 : 0.0);
+    used += fprintf(out, ",\"Messages\":%" PRIu64, b->stats.messages);
+    used += fprintf(out, ",\"Bytes\":%" PRIu64, b->stats.bytes);
+    used += fprintf(out, ",\"Subsets\":%" PRIu64, b->stats.subsets);
+    used += fprintf(out, ",\"Cache hits\":%" PRIu64, b->stats.cache_hits);
+    used += fprintf(out, ",\"Cache misses\":%" PRIu64, b->stats.cache_misses);
+    used += fprintf(out, ",\"Cache evictions\":%" PRIu64, b->stats.cache_evictions);
+    if (b->mask & BUFRDECO_SKIP_DUPLICATES) {
+        used += fprintf(out, ",\"Duplicates\":%" PRIu64, b->stats.duplicates);
+        used += fprintf(out, ",\"Dedup ratio\":%.6lf", b->stats.messages ? (double)b->stats.duplicates / (double)b->stats.messages : 0.0);
+    }
+    if (b->mask & BUFRDECO_USE_COMPRESSED_REFERENCES_CACHE) {
+        used += fprintf(out, ",\"Compressed references hits\":%" PRIu64, b->stats.crefs_hits);
+        used += fprintf(out, ",\"Compressed references misses\":%" PRIu64, b->stats.crefs_misses);
+    }
+    if (b->mask & BUFRDECO_USE_TABLES_IMAGES) {
+        used += fprintf(out, ",\"Tables images hits\":%" PRIu64, b->stats.timages_hits);
+        used += fprintf(out, ",\"Tables images misses\":%" PRIu64, b->stats.timages_misses);
+    }
+    used += fprintf(out, ",\"Phases\":{");
+    for (i = 0; i < BUFRDECO_STATS_PHASES; i++) {
+        used += fprintf(out, "%s\"%s\":{\"Calls\":%" PRIu64 ",\"Seconds\":%.6lf}", i ? "," : "", BUFRDECO_STATS_PHASE_NAME[i],
+            b->stats.calls[i], (double)b->stats.ns[i] * 1e-9);
+    }
+    used += fprintf(out, "}}\n");
+    return used;
+}
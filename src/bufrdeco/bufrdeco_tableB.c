@@ -22,6 +22,7 @@
  \brief file with the code to read table B data (code and flag tables)
  */
 #include "bufrdeco.h"
+#include <stddef.h>
 
 #define BUFR_TABLEB_CHANGED_BITS (1)
 #define BUFR_TABLEB_CHANGED_SCALE (2)
@@ -150,7 +151,8 @@ int bufr_read_tableB ( struct bufrdeco *b )
 
   memcpy ( caux, tb->path, sizeof (tb->path) );
   memcpy ( caux_local, tb->local_path, sizeof (tb->local_path) );
-  memset ( tb, 0, sizeof ( struct bufr_tableB ) );
+  memset ( tb, 0, offsetof ( struct bufr_tableB, strings ) );
+  bufrdeco_clean_strings ( & ( tb->strings ) );
   memcpy ( tb->path, caux, sizeof (tb->path) );
   memcpy ( tb->local_path, caux_local, sizeof (tb->local_path) );
 
@@ -272,8 +274,17 @@ int bufr_read_tableB ( struct bufrdeco *b )
       tb->y_ref[desc.x][desc.y] = i - tb->x_start[desc.x]; // mark the position from start of first x
       ( tb->num[desc.x] )++;
 
-      memcpy ( tb->item[i].name, row->name, sizeof ( tb->item[i].name ) );
-      memcpy ( tb->item[i].unit, row->unit, sizeof ( tb->item[i].unit ) );
+      if ( bufrdeco_strings_add ( & ( tb->item[i].name_ofs ), & ( tb->strings ), row->name ) ||
+           bufrdeco_strings_add ( & ( tb->item[i].unit_ofs ), & ( tb->strings ), row->unit ) )
+        {
+          snprintf ( b->error, sizeof ( b->error ),"Cannot allocate memory for strings of table B file '%s'\n", tb->path );
+          fclose ( t );
+          if ( t_local != NULL )
+            {
+              fclose ( t_local );
+            }
+          return 1;
+        }
 
       tb->item[i].scale_ori = row->scale;
       tb->item[i].scale = tb->item[i].scale_ori;
@@ -492,16 +503,21 @@ int bufrdeco_tableB_compressed ( struct bufrdeco_compressed_ref *r, struct bufrd
   // copy the descriptor to reference member desc
   r->desc = d;
   r->ref = tb->item[i].reference_ori; // copy the reference value from tableB, first from original
-  r->bits = tb->item[i].nbits + b->state.added_bit_length; // copy the bits from tableB
+  r->bits = tb->item[i].nbits; // copy the bits from tableB
   r->escale = tb->item[i].scale; // copy the scale from Tableb
-  memcpy ( r->name, tb->item[i].name, sizeof ( r->name ) ); // copy the name
-  memcpy ( r->unit, tb->item[i].unit, sizeof ( r->unit ) ); // copy the unit name
+  strncpy_safe ( r->name, bufr_strings_get ( & ( tb->strings ), tb->item[i].name_ofs ), sizeof ( r->name ) ); // copy the name
+  strncpy_safe ( r->unit, bufr_strings_get ( & ( tb->strings ), tb->item[i].unit_ofs ), sizeof ( r->unit ) ); // copy the unit name
 
-  // Add the added_scaled if not flag or code table
+  // Add the added bits, scale and reference if numeric, as in bufrdeco_tableB_val()
   if ( strstr ( r->unit, "CODE TABLE" ) != r->unit &&  strstr ( r->unit,"FLAG" ) != r->unit &&
-       strstr ( r->unit, "Code table" ) != r->unit &&  strstr ( r->unit,"Flag" ) != r->unit )
+       strstr ( r->unit, "Code table" ) != r->unit &&  strstr ( r->unit,"Flag" ) != r->unit &&
+       strstr ( r->unit, "CCITT" ) == NULL )
     {
+      r->bits += b->state.added_bit_length;
       r->escale += b->state.added_scale;
+      r->ref += b->state.added_reference;
+      if ( b->state.factor_reference > 1 )
+        r->ref *= b->state.factor_reference;
     }
   r->bit0 = b->state.bit_offset; // Sets the reference offset to current state offset
   r->cref0[0] = '\0'; // default
@@ -682,8 +698,8 @@ int bufrdeco_tableB_val ( struct bufr_atom_data *a, struct bufrdeco *b, const st
 
   memcpy ( & ( a->desc ), d, sizeof ( struct bufr_descriptor ) );
   a->mask = 0;
-  memcpy ( a->name, tb->item[i].name, sizeof ( a->name ) );
-  memcpy ( a->unit, tb->item[i].unit, sizeof ( a->unit ) );
+  strncpy_safe ( a->name, bufr_strings_get ( & ( tb->strings ), tb->item[i].name_ofs ), sizeof ( a->name ) );
+  strncpy_safe ( a->unit, bufr_strings_get ( & ( tb->strings ), tb->item[i].unit_ofs ), sizeof ( a->unit ) );
   a->escale = tb->item[i].scale;
 
   // Case of difference statistics active
@@ -22,6 +22,7 @@
  \brief file with the code to read table C data (code and flag tables)
  */
 #include "bufrdeco.h"
+#include <stddef.h>
 
 struct bufr_tableC_csv_row {
     char key[8];
@@ -85,7 +86,10 @@ static int bufr_tableC_append_row ( struct bufr_tableC *tc, const struct bufr_ta
   tc->item[idx].x = row->x;
   tc->item[idx].y = row->y;
   tc->item[idx].ival = row->ival;
-  memcpy ( tc->item[idx].description, row->description, sizeof ( tc->item[idx].description ) );
+  if ( bufrdeco_strings_add ( & ( tc->item[idx].description_ofs ), & ( tc->strings ), row->description ) )
+    {
+      return 1;
+    }
 
   if ( tc->num[row->x] == 0 )
     {
@@ -141,7 +145,8 @@ int bufr_read_tableC ( struct bufrdeco *b )
 
   memcpy ( caux, tc->path, sizeof ( caux ) );
   memcpy ( caux_local, tc->local_path, sizeof ( tc->local_path ) );
-  memset ( tc, 0, sizeof ( struct bufr_tableC ) );
+  memset ( tc, 0, offsetof ( struct bufr_tableC, strings ) );
+  bufrdeco_clean_strings ( & ( tc->strings ) );
   memcpy ( tc->path, caux, sizeof ( tc->path ) );
   memcpy ( tc->local_path, caux_local, sizeof ( tc->local_path ) );
   t_local = NULL;
@@ -213,7 +218,10 @@ int bufr_read_tableC ( struct bufrdeco *b )
               row = &row_local;
               if ( bufr_tableC_append_row ( tc, row, &i ) )
                 {
-                  break;
+                  snprintf ( b->error, sizeof ( b->error ),"Cannot allocate memory for strings of table C file '%s'\n", tc->local_path );
+                  fclose ( t );
+                  fclose ( t_local );
+                  return 1;
                 }
               have_local = bufr_tableC_read_next_csv_row ( t_local, tc->local_path, &row_local, b );
               if ( have_local < 0 )
@@ -244,7 +252,13 @@ int bufr_read_tableC ( struct bufrdeco *b )
               row = &row_master;
               if ( bufr_tableC_append_row ( tc, row, &i ) )
                 {
-                  break;
+                  snprintf ( b->error, sizeof ( b->error ),"Cannot allocate memory for strings of table C file '%s'\n", tc->path );
+                  fclose ( t );
+                  if ( t_local != NULL )
+                    {
+                      fclose ( t_local );
+                    }
+                  return 1;
                 }
               have_master = bufr_tableC_read_next_csv_row ( t, tc->path, &row_master, b );
               if ( have_master < 0 )
@@ -330,7 +344,7 @@ char * bufrdeco_explained_table_val ( char *expl, size_t dim, struct bufr_tableC
   // here the calling b item learn where to find first table C struct for a given x and y.
   *index = tc->x_start[d->x] + tc->y_ref[d->x][d->y];
 
-  strncpy_safe ( expl, tc->item[i].description, dim );
+  strncpy_safe ( expl, bufr_strings_get ( & ( tc->strings ), tc->item[i].description_ofs ), dim );
   return expl;
 }
 
@@ -383,7 +397,7 @@ char * bufrdeco_explained_flag_val ( char *expl, size_t dim, struct bufr_tableC
           if ( ival == 0 )
             {
               used += snprintf ( expl + used, dim - used, "|" );
-              snprintf ( expl + used, dim - used, "%s", tc->item[i].description );
+              snprintf ( expl + used, dim - used, "%s", bufr_strings_get ( & ( tc->strings ), tc->item[i].description_ofs ) );
               return expl;
             }
         }
@@ -393,7 +407,7 @@ char * bufrdeco_explained_flag_val ( char *expl, size_t dim, struct bufr_tableC
       if ( v && ( test & ival ) != 0 )
         {
           used += snprintf ( expl + used, dim - used, "|" );
-          used += snprintf ( expl + used, dim - used, "%s", tc->item[i].description );
+          used += snprintf ( expl + used, dim - used, "%s", bufr_strings_get ( & ( tc->strings ), tc->item[i].description_ofs ) );
         }
       else
         {
@@ -22,6 +22,7 @@
  \brief file with the code to read table D data (code and flag tables)
  */
 #include "bufrdeco.h"
+#include <stddef.h>
 
 struct bufr_tableD_csv_row {
     char key[8];
@@ -91,8 +92,11 @@ static int bufr_tableD_append_row ( struct bufr_tableD *td, const struct bufr_ta
   idx = *i;
   memcpy ( td->item[idx].key, row->key, sizeof ( td->item[idx].key ) );
   memcpy ( td->item[idx].key2, row->key2, sizeof ( td->item[idx].key2 ) );
-  memcpy ( td->item[idx].description, row->description, sizeof ( td->item[idx].description ) );
-  memcpy ( td->item[idx].description2, row->description2, sizeof ( td->item[idx].description2 ) );
+  if ( bufrdeco_strings_add ( & ( td->item[idx].description_ofs ), & ( td->strings ), row->description ) ||
+       bufrdeco_strings_add ( & ( td->item[idx].description2_ofs ), & ( td->strings ), row->description2 ) )
+    {
+      return 1;
+    }
 
   ix = strtoul ( row->key, &c, 10 );
   uint32_t_to_descriptor ( &desc, ix );
@@ -105,55 +109,21 @@ static int bufr_tableD_append_row ( struct bufr_tableD *td, const struct bufr_ta
   return 0;
 }
 
-static void bufr_tableD_build_ecmwf_lines ( struct bufr_tableD *td )
+static void bufr_tableD_set_sequences ( struct bufr_tableD *td )
 {
   buf_t i;
   buf_t j0 = 0;
-  int nj = 0;
   char oldkey[8] = {0};
-  char aux[32];
 
   for ( i = 0; i < td->nlines; i++ )
     {
       if ( strcmp ( oldkey, td->item[i].key ) )
         {
-          if ( oldkey[0] )
-            {
-              snprintf ( aux, sizeof ( aux ), "%s%3d", oldkey, nj );
-              td->l[j0][1] = aux[0];
-              td->l[j0][2] = aux[1];
-              td->l[j0][3] = aux[2];
-              td->l[j0][4] = aux[3];
-              td->l[j0][5] = aux[4];
-              td->l[j0][6] = aux[5];
-              td->l[j0][7] = aux[6];
-              td->l[j0][8] = aux[7];
-              td->l[j0][9] = aux[8];
-            }
+          // First line of a sequence
           j0 = i;
-          nj = 1;
+          memcpy ( oldkey, td->item[i].key, sizeof ( oldkey ) );
         }
-      else
-        {
-          nj++;
-        }
-
-      memcpy ( oldkey, td->item[i].key, sizeof ( oldkey ) );
-      snprintf ( td->l[i], sizeof ( td->l[i] ), "           %s", td->item[i].key2 );
-    }
-
-  if ( oldkey[0] )
-    {
-      snprintf ( aux, sizeof ( aux ), "%s%3d", oldkey, nj );
-      td->l[j0][1] = aux[0];
-      td->l[j0][2] = aux[1];
-      td->l[j0][3] = aux[2];
-      td->l[j0][4] = aux[3];
-      td->l[j0][5] = aux[4];
-      td->l[j0][6] = aux[5];
-      td->l[j0][7] = aux[6];
-      td->l[j0][8] = aux[7];
-      td->l[j0][9] = aux[8];
+      ( td->item[j0].nseq ) ++;
     }
 }
 
@@ -198,7 +168,8 @@ int bufr_read_tableD ( struct bufrdeco *b )
 
   memcpy ( caux, td->path, sizeof ( caux ) );
   memcpy ( caux_local, td->local_path, sizeof ( td->local_path ) );
-  memset ( td, 0, sizeof ( struct bufr_tableD ) );
+  memset ( td, 0, offsetof ( struct bufr_tableD, strings ) );
+  bufrdeco_clean_strings ( & ( td->strings ) );
   memcpy ( td->path, caux, sizeof ( td->path ) );
   memcpy ( td->local_path, caux_local, sizeof ( td->local_path ) );
   t_local = NULL;
@@ -270,7 +241,10 @@ int bufr_read_tableD ( struct bufrdeco *b )
               row = &row_local;
               if ( bufr_tableD_append_row ( td, row, &i ) )
                 {
-                  break;
+                  snprintf ( b->error, sizeof ( b->error ),"Cannot allocate memory for strings of table D file '%s'\n", td->local_path );
+                  fclose ( t );
+                  fclose ( t_local );
+                  return 1;
                 }
 
               have_local = bufr_tableD_read_next_csv_row ( t_local, td->local_path, &row_local, b );
@@ -302,7 +276,13 @@ int bufr_read_tableD ( struct bufrdeco *b )
               row = &row_master;
               if ( bufr_tableD_append_row ( td, row, &i ) )
                 {
-                  break;
+                  snprintf ( b->error, sizeof ( b->error ),"Cannot allocate memory for strings of table D file '%s'\n", td->path );
+                  fclose ( t );
+                  if ( t_local != NULL )
+                    {
+                      fclose ( t_local );
+                    }
+                  return 1;
                 }
 
               have_master = bufr_tableD_read_next_csv_row ( t, td->path, &row_master, b );
@@ -326,7 +306,7 @@ int bufr_read_tableD ( struct bufrdeco *b )
     }
 
   td->nlines = i;
-  bufr_tableD_build_ecmwf_lines ( td );
+  bufr_tableD_set_sequences ( td );
   td->wmo_table = 1;
   memcpy ( td->old_path, td->path, sizeof ( td->old_path ) ); // store latest path
   memcpy ( td->local_path_old, td->local_path, sizeof ( td->local_path_old ) ); // store latest local path
@@ -356,12 +336,13 @@ int bufr_find_tableD_index ( buf_t *index, struct bufr_tableD *td, const char *k
   i0 = td->x_start[ix];
   for ( i = i0 ; i < i0 + td->num[ix] ; i++ )
     {
-      if ( td->l[i][1] != key[0] ||
-           td->l[i][2] != key[1] ||
-           td->l[i][3] != key[2] ||
-           td->l[i][4] != key[3] ||
-           td->l[i][5] != key[4] ||
-           td->l[i][6] != key[5] )
+      if ( td->item[i].nseq == 0 ||
+           td->item[i].key[0] != key[0] ||
+           td->item[i].key[1] != key[1] ||
+           td->item[i].key[2] != key[2] ||
+           td->item[i].key[3] != key[3] ||
+           td->item[i].key[4] != key[4] ||
+           td->item[i].key[5] != key[5] )
         {
           continue;
         }
@@ -410,13 +391,10 @@ int bufrdeco_tableD_get_descriptors_array ( struct bufr_sequence *s, struct bufr
     }
 
   // Get the name of common sequence
-  if ( td->item[i].description[0] )
-    memcpy ( s->name, td->item[i].description, sizeof ( s->name ) );
-  else
-    s->name[0] = 0;
+  strncpy_safe ( s->name, bufr_strings_get ( & ( td->strings ), td->item[i].description_ofs ), sizeof ( s->name ) );
 
-  // reads the amount of possible values
-  nv = strtoul ( &td->l[i][7], &c, 10 );
+  // the amount of possible values
+  nv = td->item[i].nseq;
 
   // s->level must be set by caller
   // s->father must be set by caller
@@ -426,7 +404,7 @@ int bufrdeco_tableD_get_descriptors_array ( struct bufr_sequence *s, struct bufr
   // read all descriptors
   for ( j = 0; j < nv && ( i + j ) < td->nlines ; j++ )
     {
-      v = strtoul ( & ( td->l[i+j][11] ), &c, 10 );
+      v = strtoul ( td->item[i + j].key2, &c, 10 );
       uint32_t_to_descriptor ( & ( s->lseq[j] ), v );
       ( s->ndesc ) ++;
     }
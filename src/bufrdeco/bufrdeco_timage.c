@@ -0,0 +1,308 @@
+/***************************************************************************
+ *   Copyright (C) 2013-2026 by Guillermo Ballester Valor                  *
+ *   gbv@ogimet.com                                                        *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.             *
+ ***************************************************************************/
+/*!
+ \file bufrdeco_timage.c
+ \brief This file has the code to write and read the merged tables B, C and D in a binary image
+
+ Reading tables B, C and D parses the master csv files and, with local tables, merges them row by row with the local
+ ones. The result for a master version, local version, centre and subcentre is written in a binary image in
+ directory \a timages_dir, so every process and every struct \ref bufrdeco reading the same tables later gets them
+ from there. An image is never changed once written. It is not used if any of the csv files it was made from has
+ changed. The file is in native byte order and only valid for the host which wrote it
+*/
+#include "bufrdeco.h"
+#include <stddef.h>
+#include <unistd.h>
+
+/*!
+  \def BUFRDECO_TIMAGE_MAGIC
+  \brief First 8 bytes of an image of tables
+*/
+#define BUFRDECO_TIMAGE_MAGIC "BUFRTIM"
+
+/*!
+  \def BUFRDECO_TIMAGE_VERSION
+  \brief Version of the layout of an image of tables
+*/
+#define BUFRDECO_TIMAGE_VERSION (2U)
+
+/*!
+  \def BUFRDECO_TIMAGE_BYTE_ORDER
+  \brief Written in native order, to check the file was written by a host with the same byte order
+*/
+#define BUFRDECO_TIMAGE_BYTE_ORDER (0x01020304U)
+
+/*!
+  \def BUFRDECO_TIMAGE_SOURCES
+  \brief Number of csv files an image is made from: master and local tables B, C and D
+*/
+#define BUFRDECO_TIMAGE_SOURCES (6)
+
+/*!
+  \struct bufrdeco_timage_source
+  \brief A csv file an image is made from, as found when the image was written
+*/
+struct bufrdeco_timage_source {
+    char path[BUFRDECO_PATH_LENGTH]; /*!< Pathname. Empty if not used */
+    int64_t size; /*!< Size in bytes */
+    int64_t mtime; /*!< Time of last modification */
+};
+
+/*!
+  \struct bufrdeco_timage_header
+  \brief Header of an image of tables
+*/
+struct bufrdeco_timage_header {
+    char magic[8]; /*!< \ref BUFRDECO_TIMAGE_MAGIC */
+    uint32_t version; /*!< \ref BUFRDECO_TIMAGE_VERSION */
+    uint32_t byte_order; /*!< \ref BUFRDECO_TIMAGE_BYTE_ORDER */
+    uint32_t size[3]; /*!< sizeof the structs of tables B, C and D */
+    uint32_t nlines[3]; /*!< Lines of tables B, C and D */
+    uint32_t strings[3]; /*!< Bytes of strings of tables B, C and D */
+    struct bufrdeco_timage_source src[BUFRDECO_TIMAGE_SOURCES]; /*!< csv files of tables */
+};
+
+/*!
+  \fn static const char* timage_source_path(const struct bufr_tables* t, int i)
+  \brief Pathname of i-th csv file of tables, in the order of member \a src of struct \ref bufrdeco_timage_header
+*/
+static const char* timage_source_path(const struct bufr_tables* t, int i)
+{
+    switch (i) {
+    case 0:
+        return t->b.path;
+    case 1:
+        return t->b.local_path;
+    case 2:
+        return t->c.path;
+    case 3:
+        return t->c.local_path;
+    case 4:
+        return t->d.path;
+    default:
+        return t->d.local_path;
+    }
+}
+
+/*!
+  \fn static int timage_set_source(struct bufrdeco_timage_source* s, const char* path)
+  \brief Set the pathname, size and time of a csv file
+  \return 0 if succeeded, 1 if the file does not exist
+*/
+static int timage_set_source(struct bufrdeco_timage_source* s, const char* path)
+{
+    struct stat st;
+
+    memset(s, 0, sizeof(struct bufrdeco_timage_source));
+    if (path[0] == '\0')
+        return 0;
+    if (stat(path, &st))
+        return 1;
+    snprintf(s->path, sizeof(s->path), "%s", path);
+    s->size = (int64_t)st.st_size;
+    s->mtime = (int64_t)st.st_mtime;
+    return 0;
+}
+
+/*!
+  \fn static int timage_read_strings(struct bufr_strings* p, uint32_t used, FILE* f)
+  \brief Read the strings of a table, as written from member \a s of a struct \ref bufr_strings
+  \return 0 if succeeded, 1 otherwise
+
+  The hash table is left empty, as no strings are added to a table once read
+*/
+static int timage_read_strings(struct bufr_strings* p, uint32_t used, FILE* f)
+{
+    bufrdeco_clean_strings(p);
+    if (used == 0)
+        return 0;
+    if (bufrdeco_strings_reserve(p, used) || fread(p->s, used, 1, f) != 1)
+        return 1;
+    p->used = used;
+    return 0;
+}
+
+/*!
+  \fn int bufrdeco_set_tables_images_dir(struct bufrdeco* b, const char* dir)
+  \brief Set the directory of the images of tables and activate them
+  \param [in,out] b pointer to the target struct \ref bufrdeco
+  \param [in] dir path of directory, ended with '/'. If NULL or empty the images are not used
+  \return 0 if succeeded, 1 otherwise
+*/
+int bufrdeco_set_tables_images_dir(struct bufrdeco* b, const char* dir)
+{
+    bufrdeco_assert_with_return_val(b != NULL, 1);
+
+    if (dir == NULL || dir[0] == '\0') {
+        b->timages_dir[0] = '\0';
+        b->mask &= ~((uint32_t)BUFRDECO_USE_TABLES_IMAGES);
+        return 0;
+    }
+    if (strlen(dir) >= sizeof(b->timages_dir)) {
+        snprintf(b->error, sizeof(b->error), "%s(): Too long directory '%s'\n", __func__, dir);
+        return 1;
+    }
+    strcpy(b->timages_dir, dir);
+    b->mask |= BUFRDECO_USE_TABLES_IMAGES;
+    return 0;
+}
+
+/*!
+  \fn int bufrdeco_tables_image_path(char* target, size_t dim, const struct bufrdeco* b)
+  \brief Set the path of the image of the tables needed by current message
+  \param [out] target the resulting path, as \a timages_dir plus the key of tables, see \ref bufrdeco_get_tables_key
+  \param [in] dim size of \a target
+  \param [in] b pointer to the struct \ref bufrdeco with sec1 already read
+  \return 0 if succeeded, 1 if the path does not fit in \a target
+*/
+int bufrdeco_tables_image_path(char* target, size_t dim, const struct bufrdeco* b)
+{
+    uint8_t ver, local_ver;
+    uint16_t centre, subcentre;
+    int n;
+
+    bufrdeco_get_tables_key(b, &ver, &local_ver, &centre, &subcentre);
+    n = snprintf(target, dim, "%stables_%u_%u_%u_%u.timg", b->timages_dir, ver, local_ver, centre, subcentre);
+    return n < 0 || (size_t)n >= dim;
+}
+
+/*!
+  \fn int bufrdeco_write_tables_image(struct bufrdeco* b, const char* filename)
+  \brief Write the tables B, C and D just read in an image
+  \param [in,out] b pointer to the struct \ref bufrdeco, with tables read from csv files
+  \param [in] filename pathname of file to write
+  \return 0 if succeeded, 1 otherwise
+
+  Only the used lines of tables are written. The file is written with a temporary name and then renamed, so a
+  process reading the images never gets one incomplete
+*/
+int bufrdeco_write_tables_image(struct bufrdeco* b, const char* filename)
+{
+    struct bufrdeco_timage_header h;
+    const struct bufr_tables* t;
+    char tmp[BUFRDECO_PATH_LENGTH + 96];
+    FILE* f;
+    int i, e;
+
+    bufrdeco_assert_with_return_val(b != NULL && filename != NULL && b->tables != NULL, 1);
+    t = b->tables;
+
+    memset(&h, 0, sizeof(h));
+    strcpy(h.magic, BUFRDECO_TIMAGE_MAGIC);
+    h.version = BUFRDECO_TIMAGE_VERSION;
+    h.byte_order = BUFRDECO_TIMAGE_BYTE_ORDER;
+    h.size[0] = (uint32_t)sizeof(struct bufr_tableB);
+    h.size[1] = (uint32_t)sizeof(struct bufr_tableC);
+    h.size[2] = (uint32_t)sizeof(struct bufr_tableD);
+    h.nlines[0] = t->b.nlines;
+    h.nlines[1] = t->c.nlines;
+    h.nlines[2] = t->d.nlines;
+    h.strings[0] = t->b.strings.used;
+    h.strings[1] = t->c.strings.used;
+    h.strings[2] = t->d.strings.used;
+    for (i = 0; i < BUFRDECO_TIMAGE_SOURCES; i++) {
+        if (timage_set_source(&h.src[i], timage_source_path(t, i))) {
+            snprintf(b->error, sizeof(b->error), "%s(): Cannot stat '%s'\n", __func__, timage_source_path(t, i));
+            return 1;
+        }
+    }
+
+    snprintf(tmp, sizeof(tmp), "%s.%ld.tmp", filename, (long)getpid());
+    if ((f = fopen(tmp, "w")) == NULL) {
+        snprintf(b->error, sizeof(b->error), "%s(): Cannot open '%s'\n", __func__, tmp);
+        return 1;
+    }
+    e = fwrite(&h, sizeof(h), 1, f) != 1;
+    e = e || fwrite(&t->b, offsetof(struct bufr_tableB, item), 1, f) != 1;
+    e = e || (t->b.nlines && fwrite(t->b.item, sizeof(t->b.item[0]), t->b.nlines, f) != t->b.nlines);
+    e = e || (h.strings[0] && fwrite(t->b.strings.s, h.strings[0], 1, f) != 1);
+    e = e || fwrite(&t->c, offsetof(struct bufr_tableC, item), 1, f) != 1;
+    e = e || (t->c.nlines && fwrite(t->c.item, sizeof(t->c.item[0]), t->c.nlines, f) != t->c.nlines);
+    e = e || (h.strings[1] && fwrite(t->c.strings.s, h.strings[1], 1, f) != 1);
+    e = e || fwrite(&t->d, offsetof(struct bufr_tableD, item), 1, f) != 1;
+    e = e || (t->d.nlines && fwrite(t->d.item, sizeof(t->d.item[0]), t->d.nlines, f) != t->d.nlines);
+    e = e || (h.strings[2] && fwrite(t->d.strings.s, h.strings[2], 1, f) != 1);
+
+    if (fclose(f) || e || rename(tmp, filename)) {
+        remove(tmp);
+        snprintf(b->error, sizeof(b->error), "%s(): Cannot write tables image in '%s'\n", __func__, filename);
+        return 1;
+    }
+    return 0;
+}
+
+/*!
+  \fn int bufrdeco_read_tables_image(struct bufrdeco* b, const char* filename)
+  \brief Read the tables B, C and D from an image
+  \param [in,out] b pointer to the struct \ref bufrdeco, with the paths of tables already set by \ref get_wmo_tablenames
+  \param [in] filename pathname of image
+  \return 0 if succeeded, 1 if there is no valid image for the current paths of tables
+
+  An image is valid only if it was made from the same csv files, with the same size and time of last modification
+*/
+int bufrdeco_read_tables_image(struct bufrdeco* b, const char* filename)
+{
+    struct bufrdeco_timage_header h;
+    struct bufrdeco_timage_source s;
+    struct bufr_tables* t;
+    FILE* f;
+    int i, e;
+
+    bufrdeco_assert_with_return_val(b != NULL && filename != NULL && b->tables != NULL, 1);
+    t = b->tables;
+
+    if ((f = fopen(filename, "r")) == NULL)
+        return 1;
+    if (fread(&h, sizeof(h), 1, f) != 1 || memcmp(h.magic, BUFRDECO_TIMAGE_MAGIC, sizeof(h.magic))
+        || h.version != BUFRDECO_TIMAGE_VERSION || h.byte_order != BUFRDECO_TIMAGE_BYTE_ORDER
+        || h.size[0] != sizeof(struct bufr_tableB) || h.size[1] != sizeof(struct bufr_tableC)
+        || h.size[2] != sizeof(struct bufr_tableD) || h.nlines[0] > BUFR_MAXLINES_TABLEB
+        || h.nlines[1] > BUFR_MAXLINES_TABLEC || h.nlines[2] > BUFR_MAXLINES_TABLED) {
+        fclose(f);
+        return 1;
+    }
+
+    // The same csv files as now, not changed since the image was written
+    for (i = 0; i < BUFRDECO_TIMAGE_SOURCES; i++) {
+        if (timage_set_source(&s, timage_source_path(t, i)) || memcmp(&s, &h.src[i], sizeof(s))) {
+            fclose(f);
+            return 1;
+        }
+    }
+
+    // Only the used lines were written, the rest of arrays is not used
+    e = fread(&t->b, offsetof(struct bufr_tableB, item), 1, f) != 1 || t->b.nlines != h.nlines[0];
+    e = e || (h.nlines[0] && fread(t->b.item, sizeof(t->b.item[0]), h.nlines[0], f) != h.nlines[0]);
+    e = e || timage_read_strings(&t->b.strings, h.strings[0], f);
+    e = e || fread(&t->c, offsetof(struct bufr_tableC, item), 1, f) != 1 || t->c.nlines != h.nlines[1];
+    e = e || (h.nlines[1] && fread(t->c.item, sizeof(t->c.item[0]), h.nlines[1], f) != h.nlines[1]);
+    e = e || timage_read_strings(&t->c.strings, h.strings[1], f);
+    e = e || fread(&t->d, offsetof(struct bufr_tableD, item), 1, f) != 1 || t->d.nlines != h.nlines[2];
+    e = e || (h.nlines[2] && fread(t->d.item, sizeof(t->d.item[0]), h.nlines[2], f) != h.nlines[2]);
+    e = e || timage_read_strings(&t->d.strings, h.strings[2], f);
+    fclose(f);
+
+    if (e) {
+        // Not to reuse a table partially read
+        t->b.old_path[0] = t->c.old_path[0] = t->d.old_path[0] = '\0';
+        return 1;
+    }
+    return 0;
+}
@@ -568,3 +568,56 @@ char *strcat_safe ( char *dst, const char *src, size_t n )
     }
   return dst;
 }
+
+/*!
+ * \fn static uint64_t bufrdeco_fnv1a_64 ( uint64_t hash, const uint8_t *data, size_t size )
+ * \brief Update a FNV-1a 64 bits hash with an array of bytes
+ * \param [in] hash Current value of hash
+ * \param [in] data Array of bytes
+ * \param [in] size Bytes in \a data
+ * \return The updated hash
+ */
+static uint64_t bufrdeco_fnv1a_64 ( uint64_t hash, const uint8_t *data, size_t size )
+{
+  size_t i;
+
+  for ( i = 0; i < size; i++ )
+    hash = ( hash ^ data[i] ) * 1099511628211ULL;
+  return hash;
+}
+
+/*!
+ * \fn uint64_t bufrdeco_message_hash ( const struct bufrdeco *b )
+ * \brief FNV-1a 64 bits hash of the raw sections 1 to 4 of the current BUFR message
+ * \param [in] b Pointer to the struct \ref bufrdeco with a read BUFR
+ * \return The hash
+ *
+ * Two messages with the same hash have, with a very high probability, the same data. The GTS header is not
+ * used, so a message got again with another transport header gets the same hash
+ */
+uint64_t bufrdeco_message_hash ( const struct bufrdeco *b )
+{
+  uint64_t hash = 14695981039346656037ULL;
+
+  hash = bufrdeco_fnv1a_64 ( hash, b->sec1.raw, b->sec1.length );
+  hash = bufrdeco_fnv1a_64 ( hash, b->sec2.raw, b->sec2.length );
+  hash = bufrdeco_fnv1a_64 ( hash, b->sec3.raw, b->sec3.length );
+  hash = bufrdeco_fnv1a_64 ( hash, b->sec4.raw, b->sec4.length );
+  return hash;
+}
+
+/*!
+ * \fn uint64_t bufrdeco_buffer_hash ( const uint8_t *bufr, size_t size )
+ * \brief Hash of a raw BUFR message, the same than \ref bufrdeco_message_hash once it is read
+ * \param [in] bufr Raw message, from 'BUFR' to '7777'
+ * \param [in] size Bytes of message
+ * \return The hash
+ *
+ * Sections 1 to 4 are contiguous in a message, so they are hashed at once without splitting them
+ */
+uint64_t bufrdeco_buffer_hash ( const uint8_t *bufr, size_t size )
+{
+  if ( size < 12 )
+    return bufrdeco_fnv1a_64 ( 14695981039346656037ULL, bufr, size );
+  return bufrdeco_fnv1a_64 ( 14695981039346656037ULL, bufr + 8, size - 12 );
+}
@@ -22,6 +22,7 @@
  \brief This file has the code to read bufr files from WMO csv files
 */
 #include "bufrdeco.h"
+#include <dirent.h>
 
 /*!
    And these are the default directories when using WMO csv table files
@@ -30,58 +31,43 @@ const char DEFAULT_BUFRTABLES_WMO_CSV_DIR1[] = "/usr/local/share/bufr2synop/";
 const char DEFAULT_BUFRTABLES_WMO_CSV_DIR2[] = "/usr/share/bufr2synop/";
 
 /*!
-  \fn int get_wmo_tablenames ( struct bufrdeco *b)
-  \brief Get the complete pathnames for WMO csv table files needed by a bufr message
-  \param [in,out] b Pointer for a struct \ref bufrdeco
+  \fn static int get_wmo_tables_dir ( char *dir, size_t dim, const struct bufrdeco *b )
+  \brief Get the directory of WMO csv table files, the one set by user or the first default one found
+  \param [out] dir string where to set the directory, ended with '/'
+  \param [in] dim dimension of dir
+  \param [in] b Pointer for a struct \ref bufrdeco
   \return if success return 0, otherwise 1
-
-  For WMO files this format is adopted
-       BUFR_XX_Y_Z_TableB_en for table B
-       BUFR_XX_Y_Z_CodeFlag for Code table and Flag table. This is equivalent to table C in ECMWF package
-       BUFR_XX_Y_Z_TableD_en for table D
-
-  XX is the Version number of master table used
-  Y is the revision (currently ignored)
-  Z is minor revision (currently ignored)
 */
-int get_wmo_tablenames ( struct bufrdeco *b )
+static int get_wmo_tables_dir ( char *dir, size_t dim, const struct bufrdeco *b )
 {
   struct stat st;
-  char aux[BUFRDECO_PATH_LENGTH - 32];
 
-  bufrdeco_assert ( b != NULL );
-
-  if ( b->bufrtables_dir[0] == '\0' )
-    {
-      // try to guess directory
-      if ( stat ( DEFAULT_BUFRTABLES_WMO_CSV_DIR1, &st ) )
-        {
-          if ( stat ( DEFAULT_BUFRTABLES_WMO_CSV_DIR2, &st ) )
-            {
-              return 1;
-            }
-          else
-            {
-              if ( S_ISDIR ( st.st_mode ) )
-                {
-                  strcpy ( aux, DEFAULT_BUFRTABLES_WMO_CSV_DIR2 );
-                }
-            }
-        }
-      else
-        {
-          if ( S_ISDIR ( st.st_mode ) )
-            {
-              strcpy ( aux, DEFAULT_BUFRTABLES_WMO_CSV_DIR1 );
-            }
-        }
-    }
+  if ( b->bufrtables_dir[0] )
+    snprintf ( dir, dim, "%s", b->bufrtables_dir );
+  else if ( stat ( DEFAULT_BUFRTABLES_WMO_CSV_DIR1, &st ) == 0 && S_ISDIR ( st.st_mode ) )
+    snprintf ( dir, dim, "%s", DEFAULT_BUFRTABLES_WMO_CSV_DIR1 );
+  else if ( stat ( DEFAULT_BUFRTABLES_WMO_CSV_DIR2, &st ) == 0 && S_ISDIR ( st.st_mode ) )
+    snprintf ( dir, dim, "%s", DEFAULT_BUFRTABLES_WMO_CSV_DIR2 );
   else
-    {
-      strcpy ( aux, b->bufrtables_dir );
-    }
+    return 1;
+  return 0;
+}
+
+/*!
+  \fn uint8_t get_wmo_tables_version ( uint8_t ver, int *revision, int *minor )
+  \brief Get the version of WMO csv table files used for a master table version
+  \param [in] ver Version of master table in sec1
+  \param [out] revision revision in the name of files, if not NULL
+  \param [out] minor minor revision in the name of files, if not NULL
+  \return The version XX in the name of files BUFR_XX_Y_Z_*
+
+  Several master versions share the same files, so this is also the key of tables in a \ref bufr_tables_cache
+*/
+uint8_t get_wmo_tables_version ( uint8_t ver, int *revision, int *minor )
+{
+  int y = 0, z = 0;
 
-  switch ( b->sec1.master_version )
+  switch ( ver )
     {
     case 4:
     case 5:
@@ -93,24 +79,17 @@ int get_wmo_tablenames ( struct bufrdeco *b )
     case 11:
     case 12:
     case 13:
-      snprintf ( b->tables->b.path, sizeof ( b->tables->b.path ),"%sBUFR_13_0_0_TableB_en.csv", aux );
-      snprintf ( b->tables->c.path, sizeof ( b->tables->c.path ),"%sBUFR_13_0_0_TableC_en.csv", aux );
-      snprintf ( b->tables->d.path, sizeof ( b->tables->d.path ),"%sBUFR_13_0_0_TableD_en.csv", aux );
+      ver = 13;
       break;
     case 18:
-      snprintf ( b->tables->b.path, sizeof ( b->tables->b.path ),"%sBUFR_18_1_0_TableB_en.csv", aux );
-      snprintf ( b->tables->c.path, sizeof ( b->tables->c.path ),"%sBUFR_18_1_0_TableC_en.csv", aux );
-      snprintf ( b->tables->d.path, sizeof ( b->tables->d.path ),"%sBUFR_18_1_0_TableD_en.csv", aux );
+      y = 1;
       break;
     case 19:
-      snprintf ( b->tables->b.path, sizeof ( b->tables->b.path ),"%sBUFR_19_1_1_TableB_en.csv", aux );
-      snprintf ( b->tables->c.path, sizeof ( b->tables->c.path ),"%sBUFR_19_1_1_TableC_en.csv", aux );
-      snprintf ( b->tables->d.path, sizeof ( b->tables->d.path ),"%sBUFR_19_1_1_TableD_en.csv", aux );
+      y = 1;
+      z = 1;
       break;
     case 22:
-      snprintf ( b->tables->b.path, sizeof ( b->tables->b.path ),"%sBUFR_22_0_1_TableB_en.csv", aux );
-      snprintf ( b->tables->c.path, sizeof ( b->tables->c.path ),"%sBUFR_22_0_1_TableC_en.csv", aux );
-      snprintf ( b->tables->d.path, sizeof ( b->tables->d.path ),"%sBUFR_22_0_1_TableD_en.csv", aux );
+      z = 1;
       break;
     case 14:
     case 15:
@@ -133,29 +112,61 @@ int get_wmo_tablenames ( struct bufrdeco *b )
     case 35:
     case 36:
     case 37:
-    case 39:  
-    case 40:  
+    case 39:
+    case 40:
     case 41:
     case 42:
     case 43:
-    case 44: 
+    case 44:
     case 45:
-      snprintf ( b->tables->b.path, sizeof ( b->tables->b.path ),"%sBUFR_%d_0_0_TableB_en.csv", aux, b->sec1.master_version );
-      snprintf ( b->tables->c.path, sizeof ( b->tables->c.path ),"%sBUFR_%d_0_0_TableC_en.csv", aux, b->sec1.master_version );
-      snprintf ( b->tables->d.path, sizeof ( b->tables->d.path ),"%sBUFR_%d_0_0_TableD_en.csv", aux, b->sec1.master_version );
       break;
     case 38:
-      snprintf ( b->tables->b.path, sizeof ( b->tables->b.path ),"%sBUFR_%d_1_0_TableB_en.csv", aux, b->sec1.master_version );
-      snprintf ( b->tables->c.path, sizeof ( b->tables->c.path ),"%sBUFR_%d_1_0_TableC_en.csv", aux, b->sec1.master_version );
-      snprintf ( b->tables->d.path, sizeof ( b->tables->d.path ),"%sBUFR_%d_1_0_TableD_en.csv", aux, b->sec1.master_version );
+      y = 1;
       break;
     default: // last version for BUFR tables
-      snprintf ( b->tables->b.path, sizeof ( b->tables->b.path ),"%sBUFR_45_0_0_TableB_en.csv", aux );
-      snprintf ( b->tables->c.path, sizeof ( b->tables->c.path ),"%sBUFR_45_0_0_TableC_en.csv", aux );
-      snprintf ( b->tables->d.path, sizeof ( b->tables->d.path ),"%sBUFR_45_0_0_TableD_en.csv", aux );
+      ver = 45;
       break;
     }
 
+  if ( revision != NULL )
+    *revision = y;
+  if ( minor != NULL )
+    *minor = z;
+  return ver;
+}
+
+/*!
+  \fn int get_wmo_tablenames ( struct bufrdeco *b)
+  \brief Get the complete pathnames for WMO csv table files needed by a bufr message
+  \param [in,out] b Pointer for a struct \ref bufrdeco
+  \return if success return 0, otherwise 1
+
+  For WMO files this format is adopted
+       BUFR_XX_Y_Z_TableB_en for table B
+       BUFR_XX_Y_Z_CodeFlag for Code table and Flag table. This is equivalent to table C in ECMWF package
+       BUFR_XX_Y_Z_TableD_en for table D
+
+  XX is the Version number of master table used
+  Y is the revision (currently ignored)
+  Z is minor revision (currently ignored)
+*/
+int get_wmo_tablenames ( struct bufrdeco *b )
+{
+  struct stat st;
+  char aux[BUFRDECO_PATH_LENGTH - 32];
+  uint8_t ver;
+  int y, z;
+
+  bufrdeco_assert ( b != NULL );
+
+  if ( get_wmo_tables_dir ( aux, sizeof ( aux ), b ) )
+    return 1;
+
+  ver = get_wmo_tables_version ( b->sec1.master_version, &y, &z );
+  snprintf ( b->tables->b.path, sizeof ( b->tables->b.path ),"%sBUFR_%u_%d_%d_TableB_en.csv", aux, ver, y, z );
+  snprintf ( b->tables->c.path, sizeof ( b->tables->c.path ),"%sBUFR_%u_%d_%d_TableC_en.csv", aux, ver, y, z );
+  snprintf ( b->tables->d.path, sizeof ( b->tables->d.path ),"%sBUFR_%u_%d_%d_TableD_en.csv", aux, ver, y, z );
+
   // Check if local tables are needed, when sec1.master_local_version not zero. 
   // Thne tables needed are in local directory, and with the named schema 
   // local/tableB_LOCAL_XX_Y_Z.csv 
@@ -164,12 +175,12 @@ int get_wmo_tablenames ( struct bufrdeco *b )
   // if Z version for a subcentre is not found, then 0 is used as version, and then the file named local/tableB_LOCAL_XX_Y_0.csv is searched. 
   // If not found, then local tables are not use 
   // note that some local tables may not exist, but if at least one exist, then local tables are used, and the missing ones are not used but with the same format as WMO tables.
+  // clean local tables path, and set new ones if needed
+  b->tables->b.local_path[0] = '\0';
+  b->tables->c.local_path[0] = '\0';
+  b->tables->d.local_path[0] = '\0';
   if ( (b->mask & BUFRDECO_LOCAL_TABLES) && b->sec1.master_local != 0 )
     {
-      // clean local tables path, and set new ones
-      b->tables->b.local_path[0] = '\0';
-      b->tables->c.local_path[0] = '\0';
-      b->tables->d.local_path[0] = '\0';
       char local_path[BUFRDECO_PATH_LENGTH];
 
       // local table B
@@ -224,6 +235,72 @@ int get_wmo_tablenames ( struct bufrdeco *b )
   return 0;
 }
 
+/*!
+  \fn void bufrdeco_get_tables_key ( const struct bufrdeco *b, uint8_t *ver, uint8_t *local_ver, uint16_t *centre, uint16_t *subcentre )
+  \brief Get the key of the tables needed by current message, in a \ref bufr_tables_cache or an image of tables
+  \param [in] b Pointer to a struct \ref bufrdeco with sec1 already read
+  \param [out] ver Version of master table files, see \ref get_wmo_tables_version
+  \param [out] local_ver Version of local tables, 0 if not used
+  \param [out] centre Originating centre, 0 if local tables are not used
+  \param [out] subcentre Originating subcentre, 0 if local tables are not used
+
+  Tables only depend on files, so messages without local tables share the key of master version files
+*/
+void bufrdeco_get_tables_key ( const struct bufrdeco *b, uint8_t *ver, uint8_t *local_ver, uint16_t *centre, uint16_t *subcentre )
+{
+  *ver = get_wmo_tables_version ( b->sec1.master_version, NULL, NULL );
+  if ( ( b->mask & BUFRDECO_LOCAL_TABLES ) && b->sec1.master_local != 0 )
+    {
+      *local_ver = b->sec1.master_local;
+      *centre = b->sec1.centre;
+      *subcentre = b->sec1.subcentre;
+    }
+  else
+    {
+      *local_ver = 0;
+      *centre = 0;
+      *subcentre = 0;
+    }
+}
+
+/*!
+  \fn static int bufr_read_tables_files ( struct bufrdeco *b )
+  \brief Read tables B, C and D from the files set by \ref get_wmo_tablenames
+  \param [in,out] b Basic struct with needed data
+  \return if success return 0, otherwise 1
+
+  With \ref BUFRDECO_USE_TABLES_IMAGES, tables not read yet are got from their image, and the image is written
+  when there is none, so the master and local csv files are parsed and merged only once
+*/
+static int bufr_read_tables_files ( struct bufrdeco *b )
+{
+  char image[BUFRDECO_PATH_LENGTH + 64];
+  struct bufr_tables *t = b->tables;
+
+  if ( ( b->mask & BUFRDECO_USE_TABLES_IMAGES ) &&
+       ( strcmp ( t->b.path, t->b.old_path ) || strcmp ( t->b.local_path, t->b.local_path_old ) ||
+         strcmp ( t->c.path, t->c.old_path ) || strcmp ( t->c.local_path, t->c.local_path_old ) ||
+         strcmp ( t->d.path, t->d.old_path ) || strcmp ( t->d.local_path, t->d.local_path_old ) ) &&
+       bufrdeco_tables_image_path ( image, sizeof ( image ), b ) == 0 )
+    {
+      if ( bufrdeco_read_tables_image ( b, image ) == 0 )
+        {
+          b->stats.timages_hits++;
+          return 0;
+        }
+      b->stats.timages_misses++;
+      if ( bufr_read_tableB ( b ) || bufr_read_tableC ( b ) || bufr_read_tableD ( b ) )
+        return 1;
+      // An image not written is not an error, tables are already read
+      bufrdeco_write_tables_image ( b, image );
+      return 0;
+    }
+
+  if ( bufr_read_tableB ( b ) || bufr_read_tableC ( b ) || bufr_read_tableD ( b ) )
+    return 1;
+  return 0;
+}
+
 /*!
   \fn int bufr_read_tables (struct bufrdeco *b)
   \brief Read the tables according with bufr file data from a bufr table directory
@@ -236,19 +313,24 @@ int bufr_read_tables ( struct bufrdeco *b )
 {
   int index;
   buf_t i;
+  uint8_t ver, local_ver;
+  uint16_t centre, subcentre;
   bufrdeco_assert ( b != NULL );
   struct bufr_tableB *tb;
 
   if ( b->mask & BUFRDECO_USE_TABLES_CACHE )
     {
       // When using cache, member b->tables is actually a pointer in array b->cache.tab[]
+      bufrdeco_get_tables_key ( b, &ver, &local_ver, &centre, &subcentre );
 
-      if ( ( index = bufrdeco_cache_tables_search ( & ( b->cache ), b->sec1.master_version, b->sec1.master_local, b->sec1.centre, b->sec1.subcentre ) ) >= 0 )
+      if ( ( index = bufrdeco_cache_tables_search ( & ( b->cache ), ver, local_ver, centre, subcentre ) ) >= 0 )
         {
 #ifdef __DEBUG
           printf ( "# Found tables in cache for version %u index %d\n", b->sec1.master_version, index );
 #endif
           // hit cache, then the only task is to change member b->tables, and restore original values from item im tableB
+          b->stats.cache_hits++;
+          b->cache.last_use[index] = ++ ( b->cache.tick );
           b->tables = b->cache.tab[index];
           tb = & ( b->tables->b );
 
@@ -265,35 +347,34 @@ int bufr_read_tables ( struct bufrdeco *b )
         }
       else
         {
+          // If not in cache, the new tables are stored in a free element or in the least recently used one
+          b->stats.cache_misses++;
+          index = bufrdeco_cache_tables_lru ( & ( b->cache ) );
+          if ( b->cache.last_use[index] )
+            b->stats.cache_evictions++;
 #ifdef __DEBUG
-          printf ( "# Tables for version %u not found in cache. Stored in index %u\n", b->sec1.master_version, b->cache.next );
+          printf ( "# Tables for version %u not found in cache. Stored in index %d\n", b->sec1.master_version, index );
 #endif
-          // If not in cache, the new master version tables has to be stored. This implies that
-          bufrdeco_store_tables ( & ( b->tables ), & ( b->cache ), b->sec1.master_version, b->sec1.master_local, b->sec1.centre, b->sec1.subcentre );
+          if ( bufrdeco_store_tables ( & ( b->tables ), & ( b->cache ), ver, local_ver, centre, subcentre ) < 0 )
+            {
+              snprintf ( b->error, sizeof ( b->error ), "%s(): Cannot allocate memory for tables\n", __func__ );
+              return 1;
+            }
 
           // get tablenames
           if ( get_wmo_tablenames ( b ) )
             {
               snprintf ( b->error, sizeof ( b->error ),"%s(): Cannot find bufr tables\n", __func__ );
+              b->cache.last_use[index] = 0; // Do not hit an incomplete element in future searches
               return 1;
             }
 
           // Missed cache
-          if ( bufr_read_tableB ( b ) )
-            {
-              return 1;
-            }
-
-          if ( bufr_read_tableC ( b ) )
-            {
-              return 1;
-            }
-
-          if ( bufr_read_tableD ( b ) )
+          if ( bufr_read_tables_files ( b ) )
             {
+              b->cache.last_use[index] = 0;
               return 1;
             }
-
         }
     }
   else
@@ -312,83 +393,169 @@ int bufr_read_tables ( struct bufrdeco *b )
         }
 
       // And now read tables
-      if ( bufr_read_tableB ( b ) )
+      if ( bufr_read_tables_files ( b ) )
         {
           return 1;
         }
+    }
+  return 0;
+}
 
-      if ( bufr_read_tableC ( b ) )
-        {
-          return 1;
-        }
+/*!
+ * \fn int bufrdeco_cache_tables_lru ( const struct bufr_tables_cache *c )
+ * \brief Get the element of a \ref bufr_tables_cache where to store new tables
+ * \param [in] c Pointer to the struct \ref bufr_tables_cache
+ * \return The index of a free element if any, otherwise the index of the least recently used one
+ */
+int bufrdeco_cache_tables_lru ( const struct bufr_tables_cache *c )
+{
+  buf_t i, lru = 0;
 
-      if ( bufr_read_tableD ( b ) )
-        {
-          return 1;
-        }
+  for ( i = 0; i < BUFRDECO_TABLES_CACHE_SIZE ; i++ )
+    {
+      if ( c->last_use[i] == 0 )
+        return i; // Free or not valid
+      if ( c->last_use[i] < c->last_use[lru] )
+        lru = i;
     }
-  return 0;
+  return lru;
 }
 
 /*!
- *  \fn int bufrdeco_store_tables ( struct bufr_tables **t, struct bufr_tables_cache *c,  uint8_t ver )
- *  \brief Init an element of array c->tab[] if still not allocated. If allocated clean it and set *t pointing to this element
+ *  \fn int bufrdeco_store_tables ( struct bufr_tables **t, struct bufr_tables_cache *c, uint8_t ver, uint8_t local_ver, uint16_t centre, uint16_t subcentre )
+ *  \brief Init the element of array c->tab[] got by \ref bufrdeco_cache_tables_lru if still not allocated. If allocated clean it and set *t pointing to this element
  *  \param [out] t Pointer to array of struct \ref bufr_tables
  *  \param [in,out] c Pointer to struct \ref bufr_tables_cache
- *  \param [in] ver Version of tables acting as key
- *  \return if success return 0
+ *  \param [in] ver Version of master table files acting as key, see \ref get_wmo_tables_version
+ *  \param [in] local_ver Version of local tables acting as key
+ *  \param [in] centre Originating centre acting as key
+ *  \param [in] subcentre Originating subcentre acting as key
+ *  \return if success return the index of element, -1 if it cannot be allocated
  *
  */
-int bufrdeco_store_tables ( struct bufr_tables **t, struct bufr_tables_cache *c,  uint8_t ver, uint8_t local_ver, uint8_t centre, uint8_t subcentre )
+int bufrdeco_store_tables ( struct bufr_tables **t, struct bufr_tables_cache *c, uint8_t ver, uint8_t local_ver, uint16_t centre, uint16_t subcentre )
 {
-  if ( c->tab[c->next] == NULL )
+  int index;
+
+  index = bufrdeco_cache_tables_lru ( c );
+  if ( c->tab[index] == NULL )
     {
       // Init the array element
-      bufrdeco_init_tables ( & ( c->tab[c->next] ) );
+      if ( bufrdeco_init_tables ( & ( c->tab[index] ) ) )
+        return -1;
 
       // increase the counter of allocated elements
       ( c->nt )++;
     }
   else
     {
-      // Clean the element in array with zeroes
-      memset ( c->tab[c->next], 0, sizeof ( struct bufr_tables ) );
-
-      // sets the proper version as a key of element
-      c->ver[c->next] = ver;
-      c->local_ver[c->next] = local_ver;
-      c->centre[c->next] = centre;
-      c->subcentre[c->next] = subcentre;
+      // Clean the element in array with zeroes, keeping the space of strings
+      bufrdeco_clean_tables ( c->tab[index] );
     }
 
-  // t will point to array element
-  *t = c->tab[c->next];
+  // sets the proper version as a key of element, also for a just allocated one
+  c->ver[index] = ver;
+  c->local_ver[index] = local_ver;
+  c->centre[index] = centre;
+  c->subcentre[index] = subcentre;
+  c->last_use[index] = ++ ( c->tick );
 
-  // Set the member 'next'. It marks the next element in array it will be modified when failing a search in future
-  c->next = ( c->next + 1 ) % BUFRDECO_TABLES_CACHE_SIZE;
-  return 0;
+  // t will point to array element
+  *t = c->tab[index];
+  return index;
 }
 
 /*!
- * \fn int bufrdeco_cache_tables_search ( struct bufr_tables_cache *c, uint8_t ver )
- * \brief Search a struct \ref bufr_tables in \ref bufr_tables_cache 
+ * \fn int bufrdeco_cache_tables_search ( const struct bufr_tables_cache *c, uint8_t ver, uint8_t local_ver, uint16_t centre, uint16_t subcentre )
+ * \brief Search a struct \ref bufr_tables in \ref bufr_tables_cache
  * \param [in] c Pointer to the struct \ref bufr_tables_cache where to search
- * \param [in] ver Small int with the master version acting as a key in the search
- * 
+ * \param [in] ver Version of master table files acting as a key in the search
+ * \param [in] local_ver Version of local tables acting as key
+ * \param [in] centre Originating centre acting as key
+ * \param [in] subcentre Originating subcentre acting as key
+ *
  * \return The index of found struct. If no struct found returns -1
  */
-int bufrdeco_cache_tables_search ( const struct bufr_tables_cache *c, uint8_t ver, uint8_t local_ver, uint8_t centre, uint8_t subcentre )
+int bufrdeco_cache_tables_search ( const struct bufr_tables_cache *c, uint8_t ver, uint8_t local_ver, uint16_t centre, uint16_t subcentre )
 {
   buf_t i = 0;
 
   for ( i = 0; i < BUFRDECO_TABLES_CACHE_SIZE ; i++ )
     {
-      if ( c->ver[i] == ver && c->local_ver[i] == local_ver && c->centre[i] == centre && c->subcentre[i] == subcentre )
+      if ( c->last_use[i] && c->ver[i] == ver && c->local_ver[i] == local_ver && c->centre[i] == centre && c->subcentre[i] == subcentre )
         return i; // found
     }
   return -1; // Not found
 }
 
+/*!
+ * \fn int bufrdeco_preload_tables ( struct bufrdeco *b, buf_t max )
+ * \brief Store in cache of tables the master tables of the newest versions found in the tables directory
+ * \param [in,out] b Pointer to a struct \ref bufrdeco with \ref BUFRDECO_USE_TABLES_CACHE set in mask
+ * \param [in] max Max number of versions to load. If 0 or greater than \ref BUFRDECO_TABLES_CACHE_SIZE, the size of cache
+ * \return The number of versions loaded, -1 on error
+ *
+ * Every version takes several megabytes, so only the newest ones are loaded. The first messages decoded of these
+ * versions then hit the cache instead of reading the csv files
+ */
+int bufrdeco_preload_tables ( struct bufrdeco *b, buf_t max )
+{
+  char dir[BUFRDECO_PATH_LENGTH];
+  uint8_t found[256], master_version, master_local;
+  struct dirent *d;
+  DIR *dp;
+  int v, y, z, first, n = 0;
+
+  bufrdeco_assert ( b != NULL );
+
+  if ( ( b->mask & BUFRDECO_USE_TABLES_CACHE ) == 0 || get_wmo_tables_dir ( dir, sizeof ( dir ), b ) )
+    return -1;
+  if ( max == 0 || max > BUFRDECO_TABLES_CACHE_SIZE )
+    max = BUFRDECO_TABLES_CACHE_SIZE;
+
+  // The versions of table B files which are actually used for a version
+  memset ( found, 0, sizeof ( found ) );
+  if ( ( dp = opendir ( dir ) ) == NULL )
+    return -1;
+  while ( ( d = readdir ( dp ) ) != NULL )
+    {
+      if ( sscanf ( d->d_name, "BUFR_%d_%d_%d_TableB_en.csv", &v, &y, &z ) == 3 && v > 0 && v < 256 &&
+           get_wmo_tables_version ( v, &y, &z ) == v )
+        found[v] = 1;
+    }
+  closedir ( dp );
+
+  // The oldest of the newest 'max' versions
+  for ( v = 255, first = 255; v > 0 && ( buf_t ) n < max; v-- )
+    {
+      if ( found[v] )
+        {
+          first = v;
+          n++;
+        }
+    }
+
+  // Load them from the oldest, so the newest are the last ones to be evicted
+  master_version = b->sec1.master_version;
+  master_local = b->sec1.master_local;
+  for ( v = first, n = 0; v < 256; v++ )
+    {
+      if ( found[v] == 0 )
+        continue;
+      b->sec1.master_version = v;
+      b->sec1.master_local = 0;
+      if ( bufr_read_tables ( b ) )
+        {
+          n = -1;
+          break;
+        }
+      n++;
+    }
+  b->sec1.master_version = master_version;
+  b->sec1.master_local = master_local;
+  return n;
+}
+
 /*!
  * \fn int bufrdeco_free_cache_tables (struct bufr_tables_cache *c)
  * \brief deallocate and clean a \ref bufr_tables_cache
@@ -403,7 +570,7 @@ int bufrdeco_free_cache_tables ( struct bufr_tables_cache *c )
     {
       if ( c->tab[i] )
         {
-          free ( ( void * ) c->tab[i] );
+          bufrdeco_free_tables ( & ( c->tab[i] ) );
         }
     }
   // then clean
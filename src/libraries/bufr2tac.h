@@ -35,6 +35,7 @@ extern "C" {
 
 #include <getopt.h>
 #include <math.h>
+#include <stdarg.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
@@ -212,6 +213,11 @@ extern "C" {
  */
 #define REPORT_LENGTH (16384)
 
+/*! \def BUFR2TAC_NUM_X_CLASSES
+ *  \brief Number of possible values of X part of a descriptor (6 bits). Dimension of the tables of x-class parsers
+ */
+#define BUFR2TAC_NUM_X_CLASSES (64)
+
 /*!
  *  \def PRINT_BITMASK_WIGOS
  *  \brief Bit mask to member \a print_mask in struct \ref metreport to print WIGOS Identifier
@@ -224,6 +230,72 @@ extern "C" {
  */
 #define PRINT_BITMASK_GEO (2)
 
+/*!
+ *  \def METREPORT_DIRTY_SYNOP
+ *  \brief Bit mask to member \a dirty in struct \ref metreport. The synop chunks have been written
+ */
+#define METREPORT_DIRTY_SYNOP (1)
+
+/*!
+ *  \def METREPORT_DIRTY_BUOY
+ *  \brief Bit mask to member \a dirty in struct \ref metreport. The buoy chunks have been written
+ */
+#define METREPORT_DIRTY_BUOY (2)
+
+/*!
+ *  \def METREPORT_DIRTY_TEMP
+ *  \brief Bit mask to member \a dirty in struct \ref metreport. The temp chunks have been written
+ */
+#define METREPORT_DIRTY_TEMP (4)
+
+/*!
+ *  \def METREPORT_DIRTY_CLIMAT
+ *  \brief Bit mask to member \a dirty in struct \ref metreport. The climat chunks have been written
+ */
+#define METREPORT_DIRTY_CLIMAT (8)
+
+/*!
+ *  \def METREPORT_DIRTY_ALL
+ *  \brief Bit mask to member \a dirty in struct \ref metreport. All the chunks, as when the struct is not initialized
+ */
+#define METREPORT_DIRTY_ALL (METREPORT_DIRTY_SYNOP | METREPORT_DIRTY_BUOY | METREPORT_DIRTY_TEMP | METREPORT_DIRTY_CLIMAT)
+
+/*!
+ *  \def METREPORT_MAGIC
+ *  \brief Value of member \a magic in struct \ref metreport once initialized. Any other value means a struct never
+ *  initialized, so all its chunks are cleared
+ */
+#define METREPORT_MAGIC (0x6d657472U)
+
+/*!
+ *  \def BUFR2TAC_SUBSET_STATE_MAGIC
+ *  \brief Value of member \a magic in struct \ref bufr2tac_subset_state once initialized
+ */
+#define BUFR2TAC_SUBSET_STATE_MAGIC (0x73746174U)
+
+/*!
+ *  \def SYNOP_BATCH_WATCH
+ *  \brief Mark of a descriptor of a SYNOP template whose parse has to be known by a struct \ref bufr2tac_synop_batch
+ */
+#define SYNOP_BATCH_WATCH (1)
+
+/*!
+ *  \def SYNOP_BATCH_SKIP
+ *  \brief Mark of a descriptor of a SYNOP template not parsed in the template, but set later for every subset
+ */
+#define SYNOP_BATCH_SKIP (2)
+
+/*!
+ *  \def SYNOP_BATCH_ACTIVE
+ *  \brief Mark set by \ref synop_first_pass to a marked descriptor reached out of a significance qualifier sequence
+ */
+#define SYNOP_BATCH_ACTIVE (4)
+
+/*! \def SYNOP_BATCH_NITEMS
+ *  \brief Maximum number of descriptors of a SYNOP template set for every subset by a struct \ref bufr2tac_synop_batch
+ */
+#define SYNOP_BATCH_NITEMS (64)
+
 /*!
  * \def bufr_subset_sequence_data
  * \brief To use bufrdeco library with legacy old code using ECMWF library which is not used currently
@@ -233,10 +305,21 @@ extern "C" {
 /*!
  * \struct bufr2tac_error
  * \brief Store an error/warning/info and its severity
+ *
+ * Nothing is formatted when an error is set. The text is made by \ref bufr2tac_error_description only when needed.
+ * \a origin and \a explanation must be strings alive while the error is used, usually literals
  */
 struct bufr2tac_error {
     int severity; /*!< Level of severity. if = 1 then is a warning. if = 2 is an error */
-    char description[BUFR2TAC_ERROR_DESCRIPTION_LENGTH]; /*!< string with error description */
+    const char* origin; /*!< Function or location where error occurred. NULL if not related to a descriptor */
+    const char* explanation; /*!< Error explanation or description */
+    size_t i; /*!< Index of the descriptor in the subset sequence */
+    uint8_t f; /*!< F part of the descriptor */
+    uint8_t x; /*!< X part of the descriptor */
+    uint8_t y; /*!< Y part of the descriptor */
+    uint32_t mask; /*!< Mask of the descriptor data */
+    double val; /*!< Value of the descriptor */
+    const struct bufr_atom_data* a; /*!< Descriptor data, to get name and strings. Only used if still has the same descriptor */
 };
 
 /*!
@@ -249,13 +332,214 @@ struct bufr2tac_error_stack {
     struct bufr2tac_error err[BUFR2TAC_ERROR_STACK_DIM]; /*!< Dimension of stack array */
 };
 
+/*!
+ * \typedef bufr2tac_sink_write_function
+ * \brief Function called by a struct \ref bufr2tac_sink to write \a len bytes of \a data. Returns 0 if success
+ */
+typedef int (*bufr2tac_sink_write_function)(void* ctx, const char* data, size_t len);
+
+/*!
+ * \typedef bufr2tac_sink_flush_function
+ * \brief Function called by a struct \ref bufr2tac_sink to flush the written data. Returns 0 if success
+ */
+typedef int (*bufr2tac_sink_flush_function)(void* ctx);
+
+/*!
+ * \struct bufr2tac_sink
+ * \brief Where the formatted output of reports is written to
+ *
+ * It can be set with \ref bufr2tac_sink_set_file, \ref bufr2tac_sink_set_buffer or filling the callbacks with
+ * \ref bufr2tac_sink_set_callbacks, as example to write to a network connection
+ */
+struct bufr2tac_sink {
+    bufr2tac_sink_write_function write; /*!< Function to write data */
+    bufr2tac_sink_flush_function flush; /*!< Function to flush data. It can be NULL */
+    void* ctx; /*!< Context passed to callbacks, as a FILE * or a struct \ref bufr2tac_buffer */
+    int error; /*!< Set to 1 when a write or flush failed */
+};
+
+/*!
+ * \struct bufr2tac_buffer
+ * \brief A growable string buffer. It can be the target of a struct \ref bufr2tac_sink
+ */
+struct bufr2tac_buffer {
+    char* s; /*!< The data. It is always nul terminated if not NULL */
+    size_t len; /*!< Used bytes, not counting final nul */
+    size_t dim; /*!< Allocated bytes */
+};
+
+/*!
+ * \def BUFR2TAC_RENDER_CACHE_DEFAULT_ENTRIES
+ * \brief Default max number of rendered reports in a struct \ref bufr2tac_render_cache
+ */
+#define BUFR2TAC_RENDER_CACHE_DEFAULT_ENTRIES (16384)
+
+/*!
+ * \def BUFR2TAC_RENDER_CACHE_DEFAULT_BYTES
+ * \brief Default max bytes of rendered reports in a struct \ref bufr2tac_render_cache
+ */
+#define BUFR2TAC_RENDER_CACHE_DEFAULT_BYTES (64 * 1024 * 1024)
+
+/*!
+ * \struct bufr2tac_render_entry
+ * \brief A rendered report in a struct \ref bufr2tac_render_cache
+ */
+struct bufr2tac_render_entry {
+    uint64_t hash; /*!< Hash of the message, and of anything else which changes the rendered text */
+    uint32_t subset; /*!< Index of subset in message */
+    uint32_t subsets; /*!< Number of subsets in message, so a user can know if all of them are cached */
+    int format; /*!< Output format, as defined by the user */
+    char* data; /*!< The rendered text, nul terminated */
+    size_t len; /*!< Bytes of data, not counting final nul */
+    struct bufr2tac_render_entry* prev; /*!< Previous entry in list, more recently used */
+    struct bufr2tac_render_entry* next; /*!< Next entry in list, less recently used */
+    struct bufr2tac_render_entry* chain; /*!< Next entry in the same bucket of hash table */
+};
+
+/*!
+ * \struct bufr2tac_render_cache
+ * \brief A bounded LRU cache of rendered reports indexed by message hash, subset and output format
+ *
+ * When the number of entries or the bytes of rendered texts exceed the limits, the least recently used entries are
+ * freed. It lets a long running process skip the decoding of messages requested again and again
+ */
+struct bufr2tac_render_cache {
+    size_t max_entries; /*!< Max number of entries */
+    size_t max_bytes; /*!< Max bytes of rendered texts */
+    size_t nentries; /*!< Current number of entries */
+    size_t bytes; /*!< Current bytes of rendered texts */
+    size_t nbuckets; /*!< Number of buckets of hash table, a power of 2 */
+    struct bufr2tac_render_entry** bucket; /*!< The hash table */
+    struct bufr2tac_render_entry* first; /*!< Most recently used entry */
+    struct bufr2tac_render_entry* last; /*!< Least recently used entry */
+    uint64_t hits; /*!< Calls to \ref bufr2tac_render_cache_get which found the report */
+    uint64_t misses; /*!< Calls to \ref bufr2tac_render_cache_get which did not find the report */
+    uint64_t evictions; /*!< Entries freed to keep the limits */
+};
+
+/*!
+ * \def BUFR2TAC_STORE_LOG_MAGIC
+ * \brief First 8 bytes of the log file of an observation store
+ */
+#define BUFR2TAC_STORE_LOG_MAGIC "B2TSLOG"
+
+/*!
+ * \def BUFR2TAC_STORE_INDEX_MAGIC
+ * \brief First 8 bytes of the index file of an observation store
+ */
+#define BUFR2TAC_STORE_INDEX_MAGIC "B2TSIDX"
+
+/*!
+ * \def BUFR2TAC_STORE_VERSION
+ * \brief Version of the layout of store files. Changed whenever a struct of the files changes
+ */
+#define BUFR2TAC_STORE_VERSION (1)
+
+/*!
+ * \def BUFR2TAC_STORE_IDENT_LENGTH
+ * \brief Max length of the key of a station in an observation store
+ */
+#define BUFR2TAC_STORE_IDENT_LENGTH (32)
+
+/*!
+ * \enum bufr2tac_store_var
+ * \brief Core variables of a record in an observation store. The value is the first one found in subset of the
+ * descriptors in comment, in SI units as in BUFR
+ */
+enum bufr2tac_store_var {
+    BUFR2TAC_STORE_PRESSURE = 0, /*!< Station pressure, Pa. 0 10 004 */
+    BUFR2TAC_STORE_MSL_PRESSURE, /*!< Pressure reduced to mean sea level, Pa. 0 10 051 */
+    BUFR2TAC_STORE_TEMPERATURE, /*!< Air temperature, K. 0 12 101, 0 12 001 or 0 12 004 */
+    BUFR2TAC_STORE_DEWPOINT, /*!< Dewpoint temperature, K. 0 12 103, 0 12 003 or 0 12 006 */
+    BUFR2TAC_STORE_HUMIDITY, /*!< Relative humidity, %. 0 13 003 */
+    BUFR2TAC_STORE_WIND_DIRECTION, /*!< Wind direction, degree true. 0 11 001 or 0 11 011 */
+    BUFR2TAC_STORE_WIND_SPEED, /*!< Wind speed, m/s. 0 11 002 or 0 11 012 */
+    BUFR2TAC_STORE_VISIBILITY, /*!< Horizontal visibility, m. 0 20 001 */
+    BUFR2TAC_STORE_NVARS /*!< Number of core variables */
+};
+
+/*!
+ * \struct bufr2tac_store_record
+ * \brief An observation as stored in the log of an observation store. Missing values are \ref MISSING_REAL
+ */
+struct bufr2tac_store_record {
+    char ident[BUFR2TAC_STORE_IDENT_LENGTH]; /*!< Key of station: index as '08221' or, if none, the WIGOS id */
+    char wigos[48]; /*!< WIGOS id as '0-20000-0-08221', empty if not known */
+    int64_t time; /*!< Observation time, seconds since epoch */
+    double lat; /*!< Latitude in degrees. North positive */
+    double lon; /*!< Longitude in degrees. East positive */
+    double alt; /*!< Altitude in metres */
+    double var[BUFR2TAC_STORE_NVARS]; /*!< Core variables, see \ref bufr2tac_store_var */
+    char type[8]; /*!< Type of report as MiMiMjMj */
+    uint32_t subset; /*!< Index of subset in message */
+    uint32_t pad; /*!< Not used, set to 0 */
+};
+
+/*!
+ * \struct bufr2tac_store_header
+ * \brief Header of the log and of the index files of an observation store
+ *
+ * The log is the header and the records in order of arrival. It only grows, so the number of records is got from the
+ * size of file. The index is the header and the entries sorted by station and time of the first \a nrecords of log
+ */
+struct bufr2tac_store_header {
+    char magic[8]; /*!< \ref BUFR2TAC_STORE_LOG_MAGIC or \ref BUFR2TAC_STORE_INDEX_MAGIC */
+    uint32_t version; /*!< \ref BUFR2TAC_STORE_VERSION */
+    uint32_t byte_order; /*!< \ref BUFRDECO_INDEX_BYTE_ORDER */
+    uint32_t header_size; /*!< Size of this struct */
+    uint32_t item_size; /*!< Size of a record of log or of an entry of index */
+    uint64_t nrecords; /*!< In index, records of log already indexed. Not used in log */
+};
+
+/*!
+ * \struct bufr2tac_store_entry
+ * \brief An entry of the index of an observation store
+ */
+struct bufr2tac_store_entry {
+    char ident[BUFR2TAC_STORE_IDENT_LENGTH]; /*!< Key of station */
+    int64_t time; /*!< Observation time, seconds since epoch */
+    uint64_t record; /*!< Index of record in log */
+};
+
+/*!
+ * \struct bufr2tac_store
+ * \brief An observation store opened to append records, with pathnames '<base>.log' and '<base>.idx'
+ */
+struct bufr2tac_store {
+    char log[BUFRDECO_PATH_LENGTH + 8]; /*!< Pathname of log */
+    char idx[BUFRDECO_PATH_LENGTH + 8]; /*!< Pathname of index */
+    FILE* f; /*!< The log opened to append */
+    uint64_t appended; /*!< Records appended since opened */
+};
+
+/*!
+ * \struct bufr2tac_store_reader
+ * \brief An observation store mapped in memory to query it
+ */
+struct bufr2tac_store_reader {
+    void* log_map; /*!< Log mapped in memory */
+    size_t log_size; /*!< Size of \a log_map */
+    const struct bufr2tac_store_record* rec; /*!< Array of records of log */
+    uint64_t nrecords; /*!< Records in log */
+    void* idx_map; /*!< Index mapped in memory, NULL if there is no index */
+    size_t idx_size; /*!< Size of \a idx_map */
+    const struct bufr2tac_store_entry* ent; /*!< Sorted array of entries of index */
+    uint64_t nentries; /*!< Entries in index */
+    uint64_t nindexed; /*!< Records of log in index. The next ones are searched one by one */
+};
+
 /*!
   \struct bufr2tac_subset_state
   \brief stores information needed to parse a sequential list of expanded descriptors for a subset
 */
 struct bufr2tac_subset_state {
+    uint32_t magic; /*!< BUFR2TAC_SUBSET_STATE_MAGIC if the struct has been initialized */
     char type_report[16]; /*!< The type of report to decode (MMMM) */
     struct bufr2tac_error_stack e; /*!< Pointer to a struct \ref bufr2tac_error_stack */
+    struct temp_raw_data raw; /*!< Raw points of a temp profile. Its array is kept and reused for next subsets */
+    struct temp_raw_wind_shear_data wind_shear; /*!< Raw wind shear points of a temp profile. Its array is kept and reused for next subsets */
+    // All the members from here are zeroed for every subset by bufr2tac_clean_subset_state(). Members kept
+    // from a subset to the next one must be declared before 'a'
     struct bufr_atom_data* a; /*!< the current struct \ref bufr_atom_data being parsed */
     struct bufr_atom_data* a1; /*!< the prior struct \ref bufr_atom_data being parsed */
     size_t i; /*!< current index in array element */
@@ -297,6 +581,38 @@ struct bufr2tac_subset_state {
     struct temp_raw_wind_shear_data* w; /*!< pointer to a struct where to set the data from a temp profile being parsed */
 };
 
+/*!
+  \enum bufr2tac_report_type
+  \brief Type of report as classified from Section 1 and Section 3 of a BUFR message
+*/
+enum bufr2tac_report_type {
+    BUFR2TAC_REPORT_UNKNOWN = 0, /*!< Not classified or not parsed at the moment */
+    BUFR2TAC_REPORT_AAXX, /*!< FM-12 SYNOP */
+    BUFR2TAC_REPORT_BBXX, /*!< FM-13 SHIP */
+    BUFR2TAC_REPORT_OOXX, /*!< FM-14 SYNOP MOBIL */
+    BUFR2TAC_REPORT_ZZYY, /*!< FM-18 BUOY */
+    BUFR2TAC_REPORT_TTXX, /*!< FM-35 TEMP, TEMP SHIP, TEMP MOBIL */
+    BUFR2TAC_REPORT_PPXX, /*!< FM-32 PILOT, PILOT SHIP, PILOT MOBIL */
+    BUFR2TAC_REPORT_CLIMAT, /*!< FM-71 CLIMAT */
+    BUFR2TAC_REPORT_CLIMAT_SHIP, /*!< FM-72 CLIMAT SHIP */
+    BUFR2TAC_REPORT_TYPES /*!< Number of types */
+};
+
+/*!
+  \struct bufr2tac_report_class
+  \brief The report type of a BUFR message and the Section 1 and 3 data used as key to get it
+
+  All subsets in a message share Section 1 and 3, so the classification is done once and reused while the key is the same
+*/
+struct bufr2tac_report_class {
+    int cached; /*!< If 1 then the key and type are valid */
+    int category; /*!< Data category, ksec1[5] */
+    int subcategory; /*!< Local data subcategory, ksec1[6] */
+    size_t nlst; /*!< Number of descriptors in \a kdtlst */
+    int kdtlst[BUFR_LEN_UNEXPANDED_DESCRIPTOR]; /*!< Section 3 descriptors as integers */
+    enum bufr2tac_report_type type; /*!< The resulting report type */
+};
+
 /*!
    \struct met_geo
    \brief Geographic meta information
@@ -319,6 +635,8 @@ struct metreport {
     char source[256]; /*!< The bufr source filename */
     int subset; /*!< Subset index in bufr report */
     int print_mask; /*!< Mode of print 0=legacy, 1= with WIGOS id, 2=with lat/lon/alt */
+    uint32_t magic; /*!< METREPORT_MAGIC if the struct has been initialized */
+    int dirty; /*!< Mask of chunks written since last \ref bufr2tac_clean_metreport, see METREPORT_DIRTY_* */
     struct gts_header* h; /*!< A pointer to a GTS Header Bulletin */
     struct met_datetime t; /*!< The date/time information for report */
     struct met_geo g; /*!< The geographical info */
@@ -326,14 +644,72 @@ struct metreport {
     struct buoy_chunks buoy; /*!< The possible parsed buoy */
     struct temp_chunks temp; /*!< The possible parsed temp */
     struct climat_chunks climat; /*!< The pssible parsed climat */
+    struct bufr2tac_buffer tac[4]; /*!< The reports as rendered, without length limit: the report or TEMP part A, then TEMP parts B, C and D */
     char type[8]; /*!< The type of report as MiMiMjMj */
-    char alphanum[REPORT_LENGTH]; /*!< The alphanumeric report */
+    char alphanum[REPORT_LENGTH]; /*!< Compatibility copy of tac[0], truncated to REPORT_LENGTH - 1 chars */
     char type2[8]; /*!< The type of report of part 2 as MiMiMjMj */
-    char alphanum2[REPORT_LENGTH]; /*!< The alphanumeric report, part 2 */
+    char alphanum2[REPORT_LENGTH]; /*!< Compatibility copy of tac[1], the part 2 */
     char type3[8]; /*!< The type of report of part 3 as MiMiMjMj */
-    char alphanum3[REPORT_LENGTH]; /*!< The alphanumeric report, part 3 */
+    char alphanum3[REPORT_LENGTH]; /*!< Compatibility copy of tac[2], the part 3 */
     char type4[8]; /*!< The type of report of part 4 as MiMiMjMj */
-    char alphanum4[REPORT_LENGTH]; /*!< The alphanumeric report, part 4 */
+    char alphanum4[REPORT_LENGTH]; /*!< Compatibility copy of tac[3], the part 4 */
+};
+
+/*!
+  \enum bufr2tac_synop_batch_kind
+  \brief How a descriptor of a SYNOP template is set for every subset by a struct \ref bufr2tac_synop_batch
+*/
+enum bufr2tac_synop_batch_kind {
+    SYNOP_BATCH_NONE = 0, /*!< Not set by subset. The value must be the same in all subsets */
+    SYNOP_BATCH_PARSE, /*!< Parsed again for every subset with its x-class parser. Station identification and position */
+    SYNOP_BATCH_T, /*!< Air temperature, as snTTT */
+    SYNOP_BATCH_TD, /*!< Dewpoint temperature, as snTdTdTd */
+    SYNOP_BATCH_PO, /*!< Station level pressure, as PoPoPoPo */
+    SYNOP_BATCH_P, /*!< Pressure reduced to mean sea level, as PPPP */
+    SYNOP_BATCH_DD, /*!< Wind direction, as dd */
+    SYNOP_BATCH_FF, /*!< Wind speed, as ff and fff */
+    SYNOP_BATCH_N /*!< Total cloud cover, as N */
+};
+
+/*!
+  \struct bufr2tac_synop_batch_item
+  \brief A descriptor of a SYNOP template set for every subset
+*/
+struct bufr2tac_synop_batch_item {
+    size_t is; /*!< Index of the descriptor in the subset sequence of template */
+    buf_t iref; /*!< Index of its struct \ref bufrdeco_compressed_ref */
+    enum bufr2tac_synop_batch_kind kind; /*!< How it is set */
+    struct bufr_atom_data a; /*!< The atom data of template, with the value of subset being set when it is needed */
+};
+
+/*!
+  \struct bufr2tac_synop_batch
+  \brief A SYNOP template to get the reports of all subsets of a compressed BUFR from its columns
+
+  The template is the result of the first pass of parse of a subset with the descriptors set by subset skipped. The
+  codes of temperatures, pressures, wind and cloud cover are got for all subsets in a single pass for every item, and
+  every report is then the template with the codes of its subset and the second pass of parse
+*/
+struct bufr2tac_synop_batch {
+    int ready; /*!< If != 0 then the template is valid for the current compressed BUFR */
+    buf_t nsubsets; /*!< Number of subsets */
+    size_t nitems; /*!< Number of items in use */
+    struct bufr2tac_synop_batch_item item[SYNOP_BATCH_NITEMS]; /*!< The descriptors set by subset, in order of sequence */
+    size_t dmark; /*!< Allocated elements in \a mark */
+    uint8_t* mark; /*!< SYNOP_BATCH_* marks for every descriptor of the sequence of template */
+    size_t dcode; /*!< Allocated elements in \a code */
+    char (*code)[8]; /*!< Code of item \a i for subset \a k in code[i * nsubsets + k]. Empty if not set */
+    struct synop_chunks syn; /*!< The template */
+    char type[8]; /*!< The type of report as MiMiMjMj */
+    struct bufr2tac_subset_state st; /*!< The state after the first pass of template */
+    int mask; /*!< Member \a mask of \a st after the first pass of template */
+    double lat; /*!< Member \a lat of \a st after the first pass of template */
+    double lon; /*!< Member \a lon of \a st after the first pass of template */
+    double alt; /*!< Member \a alt of \a st after the first pass of template */
+    double altb; /*!< Member \a altb of \a st after the first pass of template */
+    char name[80]; /*!< Member \a name of \a st after the first pass of template */
+    size_t ne; /*!< Member \a e.ne of \a st after the first pass of template */
+    int full; /*!< Member \a e.full of \a st after the first pass of template */
 };
 
 /* Functions definitions */
@@ -362,7 +738,7 @@ char* bufr2tac_get_version(char* version, size_t dversion, char* build, size_t d
   \brief Push an error or warning into the error stack
   \param [in,out] e Pointer to error stack
   \param [in] severity Level of severity (1=warning, 2=error)
-  \param [in] description String with error description
+  \param [in] description String with error description. It is not copied, so it must be alive while the stack is used
   \return 0 on success, 1 if stack is full
 */
 int bufr2tac_push_error(struct bufr2tac_error_stack* e, int severity, const char* description);
@@ -394,6 +770,16 @@ int bufr2tac_set_error(struct bufr2tac_subset_state* s, int severity, const char
 */
 int bufr2tac_print_error(const struct bufr2tac_error_stack* e);
 
+/*!
+  \fn char *bufr2tac_error_description(char *target, size_t dim, const struct bufr2tac_error *err)
+  \brief Write the text of an error as set by \ref bufr2tac_set_error or \ref bufr2tac_push_error
+  \param [out] target String where to write the text
+  \param [in] dim Size of \a target
+  \param [in] err Pointer to the error
+  \return Pointer to \a target
+*/
+char* bufr2tac_error_description(char* target, size_t dim, const struct bufr2tac_error* err);
+
 /*!
   \fn int bufr2tac_set_debug_level(int level)
   \brief Set debug level for library
@@ -434,9 +820,72 @@ void bufr2tac_clean_climat_chunks(struct climat_chunks* c);
   \fn void bufr2tac_clean_metreport(struct metreport *m)
   \brief Clean/reset all data in a metreport structure
   \param [in,out] m Pointer to metreport structure to clean
+
+  Only the chunks marked in member \a dirty are cleared. All of them are cleared in a struct never initialized, as
+  checked with member \a magic, and its buffers of reports are set as empty ones. The memory of buffers is freed
+  with \ref bufr2tac_free_metreport
 */
 void bufr2tac_clean_metreport(struct metreport* m);
 
+/*!
+  \fn void bufr2tac_init_metreport(struct metreport *m)
+  \brief Init a metreport structure before its first use, clearing all its chunks
+  \param [in,out] m Pointer to metreport structure to init
+*/
+void bufr2tac_init_metreport(struct metreport* m);
+
+/*!
+  \fn void bufr2tac_free_metreport(struct metreport *m)
+  \brief Free the memory allocated for the rendered reports in a metreport structure
+  \param [in,out] m Pointer to metreport structure
+*/
+void bufr2tac_free_metreport(struct metreport* m);
+
+/*!
+  \fn void bufr2tac_init_subset_state(struct bufr2tac_subset_state *st)
+  \brief Init a bufr2tac_subset_state structure before its first use
+  \param [in,out] st Pointer to bufr2tac_subset_state structure to init
+
+  The arrays of raw temp points allocated while parsing are kept in the struct, so it must be set with this function
+  before its first use and released with \ref bufr2tac_free_subset_state when no longer needed
+*/
+void bufr2tac_init_subset_state(struct bufr2tac_subset_state* st);
+
+/*!
+  \fn void bufr2tac_clean_subset_state(struct bufr2tac_subset_state *st)
+  \brief Clean/reset a bufr2tac_subset_state structure before parsing a subset
+  \param [in,out] st Pointer to bufr2tac_subset_state structure to clean
+
+  The arrays of raw temp points are kept to be reused. A struct never initialized with
+  \ref bufr2tac_init_subset_state is initialized here
+*/
+void bufr2tac_clean_subset_state(struct bufr2tac_subset_state* st);
+
+/*!
+  \fn void bufr2tac_free_subset_state(struct bufr2tac_subset_state *st)
+  \brief Free the memory allocated for arrays of raw temp points in a \ref bufr2tac_subset_state struct
+  \param [in,out] st Pointer to the struct
+*/
+void bufr2tac_free_subset_state(struct bufr2tac_subset_state* st);
+
+/*!
+  \fn int bufr2tac_temp_raw_data_reserve(struct temp_raw_data *r, size_t n)
+  \brief Assures that array of raw points in a \ref temp_raw_data has room for at least \a n points
+  \param [in,out] r Pointer to the struct
+  \param [in] n Number of points needed
+  \return 0 on success, 1 if cannot allocate memory
+*/
+int bufr2tac_temp_raw_data_reserve(struct temp_raw_data* r, size_t n);
+
+/*!
+  \fn int bufr2tac_temp_raw_wind_shear_data_reserve(struct temp_raw_wind_shear_data *w, size_t n)
+  \brief Assures that array of points in a \ref temp_raw_wind_shear_data has room for at least \a n points
+  \param [in,out] w Pointer to the struct
+  \param [in] n Number of points needed
+  \return 0 on success, 1 if cannot allocate memory
+*/
+int bufr2tac_temp_raw_wind_shear_data_reserve(struct temp_raw_wind_shear_data* w, size_t n);
+
 /*!
   \fn int set_environment(char *default_bufrtables, char *bufrtables_dir)
   \brief Set up the environment for BUFR tables directory
@@ -553,6 +1002,71 @@ int parse_subset_as_buoy(struct metreport* m, struct bufr2tac_subset_state* s, s
 int parse_subset_as_synop(struct metreport* m, struct bufr2tac_subset_state* s, struct bufr_subset_sequence_data* sq,
     char* err);
 
+/*!
+  \fn int synop_first_pass(struct metreport *m, struct bufr2tac_subset_state *s, struct bufr_subset_sequence_data *sq, uint8_t *batch, char *err)
+  \brief First pass of the parse of a subset as a synop report, the sequential analysis of its descriptors
+  \param [out] m Pointer to metreport structure to fill
+  \param [in,out] s Pointer to subset state
+  \param [in] sq Pointer to subset sequence data
+  \param [in,out] batch SYNOP_BATCH_* marks of descriptors in \a sq, or NULL
+  \param [out] err Buffer for error messages
+  \return 0 on success, 1 on error
+*/
+int synop_first_pass(struct metreport* m, struct bufr2tac_subset_state* s, struct bufr_subset_sequence_data* sq,
+    uint8_t* batch, char* err);
+
+/*!
+  \fn int synop_second_pass(struct metreport *m, struct bufr2tac_subset_state *s, char *err)
+  \brief Second pass of the parse of a subset as a synop report, with global results and consistence analysis
+  \param [in,out] m Pointer to metreport structure with the results of \ref synop_first_pass
+  \param [in,out] s Pointer to subset state
+  \param [out] err Buffer for error messages
+  \return 0 on success, 1 on error
+*/
+int synop_second_pass(struct metreport* m, struct bufr2tac_subset_state* s, char* err);
+
+/*!
+  \fn int bufr2tac_synop_batch_prepare(struct bufr2tac_synop_batch *sb, struct metreport *m, struct bufrdeco *b, const char *type_report, char *err)
+  \brief Prepare a SYNOP template for the subsets of a compressed BUFR whose current subset has been decoded
+  \param [out] sb Pointer to the struct \ref bufr2tac_synop_batch
+  \param [in,out] m Pointer to metreport structure used as work area. Its synop chunks are overwritten
+  \param [in,out] b Pointer to the struct \ref bufrdeco with a subset already decoded
+  \param [in] type_report The type of report, AAXX, BBXX or OOXX
+  \param [out] err Buffer for error messages
+  \return 0 on success, 1 if the subsets have to be parsed one by one
+*/
+int bufr2tac_synop_batch_prepare(struct bufr2tac_synop_batch* sb, struct metreport* m, struct bufrdeco* b,
+    const char* type_report, char* err);
+
+/*!
+  \fn int bufr2tac_synop_batch_report(struct bufr2tac_synop_batch *sb, struct metreport *m, buf_t subset, struct bufrdeco *b, char *err)
+  \brief Set and print the synop report of a subset from a template got by \ref bufr2tac_synop_batch_prepare
+  \param [in,out] sb Pointer to the struct \ref bufr2tac_synop_batch
+  \param [out] m Pointer to metreport structure to fill
+  \param [in] subset Index of subset. First subset has index 0
+  \param [in,out] b Pointer to the struct \ref bufrdeco used in \ref bufr2tac_synop_batch_prepare
+  \param [out] err Buffer for error messages
+  \return 0 on success, 1 on error
+*/
+int bufr2tac_synop_batch_report(struct bufr2tac_synop_batch* sb, struct metreport* m, buf_t subset, struct bufrdeco* b,
+    char* err);
+
+/*!
+  \fn void bufr2tac_synop_batch_init(struct bufr2tac_synop_batch *sb)
+  \brief Init a struct \ref bufr2tac_synop_batch before its first use
+  \param [in,out] sb Pointer to the struct \ref bufr2tac_synop_batch
+
+  Its memory is freed with \ref bufr2tac_synop_batch_free
+*/
+void bufr2tac_synop_batch_init(struct bufr2tac_synop_batch* sb);
+
+/*!
+  \fn void bufr2tac_synop_batch_free(struct bufr2tac_synop_batch *sb)
+  \brief Free the memory allocated in a struct \ref bufr2tac_synop_batch
+  \param [in,out] sb Pointer to the struct \ref bufr2tac_synop_batch
+*/
+void bufr2tac_synop_batch_free(struct bufr2tac_synop_batch* sb);
+
 /*!
   \fn int parse_subset_as_temp(struct metreport *m, struct bufr2tac_subset_state *s, struct bufr_subset_sequence_data *sq, char *err)
   \brief Parse a BUFR subset as a temp report
@@ -678,10 +1192,49 @@ int read_table_c(char tablec[MAXLINES_TABLEC][92], size_t* nlines_tablec, const
   \param [in] ksec1 BUFR section 1 data array
   \param [out] err Buffer for error messages
   \return 0 on success, 1 on error
+
+  The subset state \a st must be set with \ref bufr2tac_init_subset_state before the first subset and freed with
+  \ref bufr2tac_free_subset_state after the last one
 */
 int parse_subset_sequence(struct metreport* m, struct bufr_subset_sequence_data* sq, struct bufr2tac_subset_state* st,
     const int* kdtlst, size_t nlst, const int* ksec1, char* err);
 
+/*!
+  \fn int bufr2tac_classify_report(struct bufr2tac_report_class *rc, const int *kdtlst, size_t nlst, const int *ksec1, char *err)
+  \brief Get the report type of a message, reusing the previous result if Section 1 and 3 are the same
+  \param [in,out] rc Pointer to the struct with the cached classification
+  \param [in] kdtlst Array of descriptor list
+  \param [in] nlst Number of descriptors in list
+  \param [in] ksec1 BUFR section 1 data array
+  \param [out] err Buffer for error messages
+  \return 0 on success, 1 if the type cannot be parsed
+*/
+int bufr2tac_classify_report(struct bufr2tac_report_class* rc, const int* kdtlst, size_t nlst, const int* ksec1, char* err);
+
+/*!
+  \fn const char *bufr2tac_report_type_name(enum bufr2tac_report_type type)
+  \brief Get the MiMiMjMj string of a report type
+  \param [in] type The report type
+  \return Pointer to the name, an empty string if unknown
+*/
+const char* bufr2tac_report_type_name(enum bufr2tac_report_type type);
+
+/*!
+  \fn int parse_subset_sequence_class(struct metreport *m, struct bufr_subset_sequence_data *sq, struct bufr2tac_subset_state *st, const struct bufr2tac_report_class *rc, char *err)
+  \brief Parse a BUFR subset sequence whose report type was got by \ref bufr2tac_classify_report
+  \param [out] m Pointer to metreport structure to fill
+  \param [in] sq Pointer to subset sequence data
+  \param [in,out] st Pointer to subset state
+  \param [in] rc Pointer to the classification of the message
+  \param [out] err Buffer for error messages
+  \return 0 on success, 1 on error
+
+  The subset state \a st must be set with \ref bufr2tac_init_subset_state before the first subset and freed with
+  \ref bufr2tac_free_subset_state after the last one
+*/
+int parse_subset_sequence_class(struct metreport* m, struct bufr_subset_sequence_data* sq, struct bufr2tac_subset_state* st,
+    const struct bufr2tac_report_class* rc, char* err);
+
 /*!
   \fn int find_descriptor(const int *haystack, size_t nlst, int needle)
   \brief Find a descriptor in a descriptor list
@@ -1020,24 +1573,31 @@ int check_j_cm2(double val);
 // Geographic and WIGOS ID print functions
 
 /*!
-  \fn size_t print_geo(char **geo, size_t lmax, const struct metreport *m)
+  \fn size_t print_geo(struct bufr2tac_buffer *out, const struct metreport *m)
   \brief Print geographic information (lat/lon/alt) from metreport
-  \param [out] geo Pointer to string pointer where to write geographic info
-  \param [in] lmax Maximum size available
+  \param [in,out] out Growable buffer where to append geographic info
   \param [in] m Pointer to metreport structure
   \return Number of bytes written
 */
-size_t print_geo(char** geo, size_t lmax, const struct metreport* m);
+size_t print_geo(struct bufr2tac_buffer* out, const struct metreport* m);
 
 /*!
-  \fn size_t print_wigos_id(char **wid, size_t lmax, const struct metreport *m)
+  \fn size_t print_wigos_id(struct bufr2tac_buffer *out, const struct metreport *m)
   \brief Print WIGOS identifier from metreport
-  \param [out] wid Pointer to string pointer where to write WIGOS ID
-  \param [in] lmax Maximum size available
+  \param [in,out] out Growable buffer where to append WIGOS ID
   \param [in] m Pointer to metreport structure
   \return Number of bytes written
 */
-size_t print_wigos_id(char** wid, size_t lmax, const struct metreport* m);
+size_t print_wigos_id(struct bufr2tac_buffer* out, const struct metreport* m);
+
+/*!
+  \fn void bufr2tac_set_alphanum(char *target, size_t dim, const struct bufr2tac_buffer *b)
+  \brief Set a fixed size alphanum member of a metreport as a copy of a rendered report
+  \param [out] target The alphanum member to set
+  \param [in] dim Size of target. Longer reports are truncated
+  \param [in] b Pointer to struct \ref bufr2tac_buffer with the rendered report
+*/
+void bufr2tac_set_alphanum(char* target, size_t dim, const struct bufr2tac_buffer* b);
 
 // SYNOP print functions
 
@@ -1050,54 +1610,49 @@ size_t print_wigos_id(char** wid, size_t lmax, const struct metreport* m);
 int print_synop_report(struct metreport* m);
 
 /*!
-  \fn size_t print_synop_sec0(char **sec0, size_t lmax, const struct synop_chunks *syn)
+  \fn size_t print_synop_sec0(struct bufr2tac_buffer *out, const struct synop_chunks *syn)
   \brief Print SYNOP section 0 (header)
-  \param [out] sec0 Pointer to string pointer where to write section 0
-  \param [in] lmax Maximum size available
+  \param [in,out] out Growable buffer where to append section 0
   \param [in] syn Pointer to synop_chunks structure
   \return Number of bytes written
 */
-size_t print_synop_sec0(char** sec0, size_t lmax, const struct synop_chunks* syn);
+size_t print_synop_sec0(struct bufr2tac_buffer* out, const struct synop_chunks* syn);
 
 /*!
-  \fn size_t print_synop_sec1(char **sec1, size_t lmax, struct synop_chunks *syn)
+  \fn size_t print_synop_sec1(struct bufr2tac_buffer *out, struct synop_chunks *syn)
   \brief Print SYNOP section 1 (surface observations)
-  \param [out] sec1 Pointer to string pointer where to write section 1
-  \param [in] lmax Maximum size available
+  \param [in,out] out Growable buffer where to append section 1
   \param [in,out] syn Pointer to synop_chunks structure
   \return Number of bytes written
 */
-size_t print_synop_sec1(char** sec1, size_t lmax, struct synop_chunks* syn);
+size_t print_synop_sec1(struct bufr2tac_buffer* out, struct synop_chunks* syn);
 
 /*!
-  \fn size_t print_synop_sec2(char **sec2, size_t lmax, const struct synop_chunks *syn)
+  \fn size_t print_synop_sec2(struct bufr2tac_buffer *out, const struct synop_chunks *syn)
   \brief Print SYNOP section 2 (ship/mobile station data)
-  \param [out] sec2 Pointer to string pointer where to write section 2
-  \param [in] lmax Maximum size available
+  \param [in,out] out Growable buffer where to append section 2
   \param [in] syn Pointer to synop_chunks structure
   \return Number of bytes written
 */
-size_t print_synop_sec2(char** sec2, size_t lmax, const struct synop_chunks* syn);
+size_t print_synop_sec2(struct bufr2tac_buffer* out, const struct synop_chunks* syn);
 
 /*!
-  \fn size_t print_synop_sec3(char **sec3, size_t lmax, struct synop_chunks *syn)
+  \fn size_t print_synop_sec3(struct bufr2tac_buffer *out, struct synop_chunks *syn)
   \brief Print SYNOP section 3 (regional/national data)
-  \param [out] sec3 Pointer to string pointer where to write section 3
-  \param [in] lmax Maximum size available
+  \param [in,out] out Growable buffer where to append section 3
   \param [in,out] syn Pointer to synop_chunks structure
   \return Number of bytes written
 */
-size_t print_synop_sec3(char** sec3, size_t lmax, struct synop_chunks* syn);
+size_t print_synop_sec3(struct bufr2tac_buffer* out, struct synop_chunks* syn);
 
 /*!
-  \fn size_t print_synop_wigos_id(char **wid, size_t lmax, struct synop_chunks *syn)
+  \fn size_t print_synop_wigos_id(struct bufr2tac_buffer *out, struct synop_chunks *syn)
   \brief Print WIGOS identifier for SYNOP report
-  \param [out] wid Pointer to string pointer where to write WIGOS ID
-  \param [in] lmax Maximum size available
+  \param [in,out] out Growable buffer where to append WIGOS ID
   \param [in,out] syn Pointer to synop_chunks structure
   \return Number of bytes written
 */
-size_t print_synop_wigos_id(char** wid, size_t lmax, struct synop_chunks* syn);
+size_t print_synop_wigos_id(struct bufr2tac_buffer* out, struct synop_chunks* syn);
 
 int buoy_YYYYMMDDHHmm_to_JMMYYGGgg(struct buoy_chunks* b);
 
@@ -1112,54 +1667,49 @@ int buoy_YYYYMMDDHHmm_to_JMMYYGGgg(struct buoy_chunks* b);
 int print_buoy_report(struct metreport* m);
 
 /*!
-  \fn size_t print_buoy_sec0(char **sec0, size_t lmax, const struct buoy_chunks *b)
+  \fn size_t print_buoy_sec0(struct bufr2tac_buffer *out, const struct buoy_chunks *b)
   \brief Print BUOY section 0 (header)
-  \param [out] sec0 Pointer to string pointer where to write section 0
-  \param [in] lmax Maximum size available
+  \param [in,out] out Growable buffer where to append section 0
   \param [in] b Pointer to buoy_chunks structure
   \return Number of bytes written
 */
-size_t print_buoy_sec0(char** sec0, size_t lmax, const struct buoy_chunks* b);
+size_t print_buoy_sec0(struct bufr2tac_buffer* out, const struct buoy_chunks* b);
 
 /*!
-  \fn size_t print_buoy_sec1(char **sec1, size_t lmax, struct buoy_chunks *b)
+  \fn size_t print_buoy_sec1(struct bufr2tac_buffer *out, struct buoy_chunks *b)
   \brief Print BUOY section 1 (identification and position)
-  \param [out] sec1 Pointer to string pointer where to write section 1
-  \param [in] lmax Maximum size available
+  \param [in,out] out Growable buffer where to append section 1
   \param [in,out] b Pointer to buoy_chunks structure
   \return Number of bytes written
 */
-size_t print_buoy_sec1(char** sec1, size_t lmax, struct buoy_chunks* b);
+size_t print_buoy_sec1(struct bufr2tac_buffer* out, struct buoy_chunks* b);
 
 /*!
-  \fn size_t print_buoy_sec2(char **sec2, size_t lmax, const struct buoy_chunks *b)
+  \fn size_t print_buoy_sec2(struct bufr2tac_buffer *out, const struct buoy_chunks *b)
   \brief Print BUOY section 2 (meteorological data)
-  \param [out] sec2 Pointer to string pointer where to write section 2
-  \param [in] lmax Maximum size available
+  \param [in,out] out Growable buffer where to append section 2
   \param [in] b Pointer to buoy_chunks structure
   \return Number of bytes written
 */
-size_t print_buoy_sec2(char** sec2, size_t lmax, const struct buoy_chunks* b);
+size_t print_buoy_sec2(struct bufr2tac_buffer* out, const struct buoy_chunks* b);
 
 /*!
-  \fn size_t print_buoy_sec3(char **sec3, size_t lmax, const struct buoy_chunks *b)
+  \fn size_t print_buoy_sec3(struct bufr2tac_buffer *out, const struct buoy_chunks *b)
   \brief Print BUOY section 3 (regional/national data)
-  \param [out] sec3 Pointer to string pointer where to write section 3
-  \param [in] lmax Maximum size available
+  \param [in,out] out Growable buffer where to append section 3
   \param [in] b Pointer to buoy_chunks structure
   \return Number of bytes written
 */
-size_t print_buoy_sec3(char** sec3, size_t lmax, const struct buoy_chunks* b);
+size_t print_buoy_sec3(struct bufr2tac_buffer* out, const struct buoy_chunks* b);
 
 /*!
-  \fn size_t print_buoy_wigos_id(char **wid, size_t lmax, const struct buoy_chunks *b)
+  \fn size_t print_buoy_wigos_id(struct bufr2tac_buffer *out, const struct buoy_chunks *b)
   \brief Print WIGOS identifier for BUOY report
-  \param [out] wid Pointer to string pointer where to write WIGOS ID
-  \param [in] lmax Maximum size available
+  \param [in,out] out Growable buffer where to append WIGOS ID
   \param [in] b Pointer to buoy_chunks structure
   \return Number of bytes written
 */
-size_t print_buoy_wigos_id(char** wid, size_t lmax, const struct buoy_chunks* b);
+size_t print_buoy_wigos_id(struct bufr2tac_buffer* out, const struct buoy_chunks* b);
 
 // CLIMAT print functions
 
@@ -1172,64 +1722,58 @@ size_t print_buoy_wigos_id(char** wid, size_t lmax, const struct buoy_chunks* b)
 int print_climat_report(struct metreport* m);
 
 /*!
-  \fn size_t print_climat_sec0(char **sec0, size_t lmax, const struct climat_chunks *cl)
+  \fn size_t print_climat_sec0(struct bufr2tac_buffer *out, const struct climat_chunks *cl)
   \brief Print CLIMAT section 0 (header)
-  \param [out] sec0 Pointer to string pointer where to write section 0
-  \param [in] lmax Maximum size available
+  \param [in,out] out Growable buffer where to append section 0
   \param [in] cl Pointer to climat_chunks structure
   \return Number of bytes written
 */
-size_t print_climat_sec0(char** sec0, size_t lmax, const struct climat_chunks* cl);
+size_t print_climat_sec0(struct bufr2tac_buffer* out, const struct climat_chunks* cl);
 
 /*!
-  \fn size_t print_climat_sec1(char **sec1, size_t lmax, struct climat_chunks *cl)
+  \fn size_t print_climat_sec1(struct bufr2tac_buffer *out, struct climat_chunks *cl)
   \brief Print CLIMAT section 1 (monthly means)
-  \param [out] sec1 Pointer to string pointer where to write section 1
-  \param [in] lmax Maximum size available
+  \param [in,out] out Growable buffer where to append section 1
   \param [in,out] cl Pointer to climat_chunks structure
   \return Number of bytes written
 */
-size_t print_climat_sec1(char** sec1, size_t lmax, struct climat_chunks* cl);
+size_t print_climat_sec1(struct bufr2tac_buffer* out, struct climat_chunks* cl);
 
 /*!
-  \fn size_t print_climat_sec2(char **sec2, size_t lmax, struct climat_chunks *cl)
+  \fn size_t print_climat_sec2(struct bufr2tac_buffer *out, struct climat_chunks *cl)
   \brief Print CLIMAT section 2 (monthly extremes)
-  \param [out] sec2 Pointer to string pointer where to write section 2
-  \param [in] lmax Maximum size available
+  \param [in,out] out Growable buffer where to append section 2
   \param [in,out] cl Pointer to climat_chunks structure
   \return Number of bytes written
 */
-size_t print_climat_sec2(char** sec2, size_t lmax, struct climat_chunks* cl);
+size_t print_climat_sec2(struct bufr2tac_buffer* out, struct climat_chunks* cl);
 
 /*!
-  \fn size_t print_climat_sec3(char **sec3, size_t lmax, struct climat_chunks *cl)
+  \fn size_t print_climat_sec3(struct bufr2tac_buffer *out, struct climat_chunks *cl)
   \brief Print CLIMAT section 3 (monthly totals)
-  \param [out] sec3 Pointer to string pointer where to write section 3
-  \param [in] lmax Maximum size available
+  \param [in,out] out Growable buffer where to append section 3
   \param [in,out] cl Pointer to climat_chunks structure
   \return Number of bytes written
 */
-size_t print_climat_sec3(char** sec3, size_t lmax, struct climat_chunks* cl);
+size_t print_climat_sec3(struct bufr2tac_buffer* out, struct climat_chunks* cl);
 
 /*!
-  \fn size_t print_climat_sec4(char **sec4, size_t lmax, struct climat_chunks *cl)
+  \fn size_t print_climat_sec4(struct bufr2tac_buffer *out, struct climat_chunks *cl)
   \brief Print CLIMAT section 4 (regional data)
-  \param [out] sec4 Pointer to string pointer where to write section 4
-  \param [in] lmax Maximum size available
+  \param [in,out] out Growable buffer where to append section 4
   \param [in,out] cl Pointer to climat_chunks structure
   \return Number of bytes written
 */
-size_t print_climat_sec4(char** sec4, size_t lmax, struct climat_chunks* cl);
+size_t print_climat_sec4(struct bufr2tac_buffer* out, struct climat_chunks* cl);
 
 /*!
-  \fn size_t print_climat_wigos_id(char **wid, size_t lmax, struct climat_chunks *cl)
+  \fn size_t print_climat_wigos_id(struct bufr2tac_buffer *out, struct climat_chunks *cl)
   \brief Print WIGOS identifier for CLIMAT report
-  \param [out] wid Pointer to string pointer where to write WIGOS ID
-  \param [in] lmax Maximum size available
+  \param [in,out] out Growable buffer where to append WIGOS ID
   \param [in,out] cl Pointer to climat_chunks structure
   \return Number of bytes written
 */
-size_t print_climat_wigos_id(char** wid, size_t lmax, struct climat_chunks* cl);
+size_t print_climat_wigos_id(struct bufr2tac_buffer* out, struct climat_chunks* cl);
 
 // TEMP print functions
 
@@ -1250,54 +1794,49 @@ int print_temp_report(struct metreport* m);
 int print_temp_a(struct metreport* m);
 
 /*!
-  \fn size_t print_temp_a_sec1(char **sec1, size_t lmax, const struct temp_chunks *t)
+  \fn size_t print_temp_a_sec1(struct bufr2tac_buffer *out, const struct temp_chunks *t)
   \brief Print TEMP part A section 1
-  \param [out] sec1 Pointer to string pointer where to write section 1
-  \param [in] lmax Maximum size available
+  \param [in,out] out Growable buffer where to append section 1
   \param [in] t Pointer to temp_chunks structure
   \return Number of bytes written
 */
-size_t print_temp_a_sec1(char** sec1, size_t lmax, const struct temp_chunks* t);
+size_t print_temp_a_sec1(struct bufr2tac_buffer* out, const struct temp_chunks* t);
 
 /*!
-  \fn size_t print_temp_a_sec2(char **sec2, size_t lmax, const struct temp_chunks *t)
+  \fn size_t print_temp_a_sec2(struct bufr2tac_buffer *out, const struct temp_chunks *t)
   \brief Print TEMP part A section 2
-  \param [out] sec2 Pointer to string pointer where to write section 2
-  \param [in] lmax Maximum size available
+  \param [in,out] out Growable buffer where to append section 2
   \param [in] t Pointer to temp_chunks structure
   \return Number of bytes written
 */
-size_t print_temp_a_sec2(char** sec2, size_t lmax, const struct temp_chunks* t);
+size_t print_temp_a_sec2(struct bufr2tac_buffer* out, const struct temp_chunks* t);
 
 /*!
-  \fn size_t print_temp_a_sec3(char **sec3, size_t lmax, const struct temp_chunks *t)
+  \fn size_t print_temp_a_sec3(struct bufr2tac_buffer *out, const struct temp_chunks *t)
   \brief Print TEMP part A section 3
-  \param [out] sec3 Pointer to string pointer where to write section 3
-  \param [in] lmax Maximum size available
+  \param [in,out] out Growable buffer where to append section 3
   \param [in] t Pointer to temp_chunks structure
   \return Number of bytes written
 */
-size_t print_temp_a_sec3(char** sec3, size_t lmax, const struct temp_chunks* t);
+size_t print_temp_a_sec3(struct bufr2tac_buffer* out, const struct temp_chunks* t);
 
 /*!
-  \fn size_t print_temp_a_sec4(char **sec4, size_t lmax, const struct temp_chunks *t)
+  \fn size_t print_temp_a_sec4(struct bufr2tac_buffer *out, const struct temp_chunks *t)
   \brief Print TEMP part A section 4
-  \param [out] sec4 Pointer to string pointer where to write section 4
-  \param [in] lmax Maximum size available
+  \param [in,out] out Growable buffer where to append section 4
   \param [in] t Pointer to temp_chunks structure
   \return Number of bytes written
 */
-size_t print_temp_a_sec4(char** sec4, size_t lmax, const struct temp_chunks* t);
+size_t print_temp_a_sec4(struct bufr2tac_buffer* out, const struct temp_chunks* t);
 
 /*!
-  \fn size_t print_temp_a_sec7(char **sec7, size_t lmax, const struct temp_chunks *t)
+  \fn size_t print_temp_a_sec7(struct bufr2tac_buffer *out, const struct temp_chunks *t)
   \brief Print TEMP part A section 7
-  \param [out] sec7 Pointer to string pointer where to write section 7
-  \param [in] lmax Maximum size available
+  \param [in,out] out Growable buffer where to append section 7
   \param [in] t Pointer to temp_chunks structure
   \return Number of bytes written
 */
-size_t print_temp_a_sec7(char** sec7, size_t lmax, const struct temp_chunks* t);
+size_t print_temp_a_sec7(struct bufr2tac_buffer* out, const struct temp_chunks* t);
 
 /*!
   \fn int print_temp_b(struct metreport *m)
@@ -1308,54 +1847,50 @@ size_t print_temp_a_sec7(char** sec7, size_t lmax, const struct temp_chunks* t);
 int print_temp_b(struct metreport* m);
 
 /*!
-  \fn size_t print_temp_b_sec1(char **sec1, size_t lmax, const struct temp_chunks *t)
+  \fn size_t print_temp_b_sec1(struct bufr2tac_buffer *out, const struct temp_chunks *t)
   \brief Print TEMP part B section 1
-  \param [out] sec1 Pointer to string pointer where to write section 1
-  \param [in] lmax Maximum size available
+  \param [in,out] out Growable buffer where to append section 1
   \param [in] t Pointer to temp_chunks structure
   \return Number of bytes written
 */
-size_t print_temp_b_sec1(char** sec1, size_t lmax, const struct temp_chunks* t);
+size_t print_temp_b_sec1(struct bufr2tac_buffer* out, const struct temp_chunks* t);
 
 /*!
-  \fn size_t print_temp_b_sec5(char **sec5, size_t lmax, const struct temp_chunks *t)
+  \fn size_t print_temp_b_sec5(struct bufr2tac_buffer *out, const struct temp_chunks *t)
   \brief Print TEMP part B section 5
-  \param [out] sec5 Pointer to string pointer where to write section 5
-  \param [in] lmax Maximum size available
+  \param [in,out] out Growable buffer where to append section 5
   \param [in] t Pointer to temp_chunks structure
   \return Number of bytes written
 */
-size_t print_temp_b_sec5(char** sec5, size_t lmax, const struct temp_chunks* t);
+size_t print_temp_b_sec5(struct bufr2tac_buffer* out, const struct temp_chunks* t);
 
 /*!
- \fn size_t print_temp_b_sec6(char **sec6, size_t lmax, const struct temp_chunks *t)
+ \fn size_t print_temp_b_sec6(struct bufr2tac_buffer *out, const struct temp_chunks *t)
  \brief Print TEMP part B section 6
- \param [out] sec6 Pointer to string pointer where to write section 6
+ \param [in,out] out Growable buffer where to append section 6
  \param [in] lmax Maximum size available
  \param [in] t Pointer to temp_chunks structure
  \return Number of bytes written
 */
-size_t print_temp_b_sec6(char** sec6, size_t lmax, const struct temp_chunks* t);
+size_t print_temp_b_sec6(struct bufr2tac_buffer* out, const struct temp_chunks* t);
 
 /*!
-  \fn size_t print_temp_b_sec7(char **sec7, size_t lmax, const struct temp_chunks *t)
+  \fn size_t print_temp_b_sec7(struct bufr2tac_buffer *out, const struct temp_chunks *t)
   \brief Print TEMP part B section 7
-  \param [out] sec7 Pointer to string pointer where to write section 7
-  \param [in] lmax Maximum size available
+  \param [in,out] out Growable buffer where to append section 7
   \param [in] t Pointer to temp_chunks structure
   \return Number of bytes written
 */
-size_t print_temp_b_sec7(char** sec7, size_t lmax, const struct temp_chunks* t);
+size_t print_temp_b_sec7(struct bufr2tac_buffer* out, const struct temp_chunks* t);
 
 /*!
-  \fn size_t print_temp_b_sec8(char **sec8, size_t lmax, const struct temp_chunks *t)
+  \fn size_t print_temp_b_sec8(struct bufr2tac_buffer *out, const struct temp_chunks *t)
   \brief Print TEMP part B section 8
-  \param [out] sec8 Pointer to string pointer where to write section 8
-  \param [in] lmax Maximum size available
+  \param [in,out] out Growable buffer where to append section 8
   \param [in] t Pointer to temp_chunks structure
   \return Number of bytes written
 */
-size_t print_temp_b_sec8(char** sec8, size_t lmax, const struct temp_chunks* t);
+size_t print_temp_b_sec8(struct bufr2tac_buffer* out, const struct temp_chunks* t);
 
 /*!
   \fn int print_temp_c(struct metreport *m)
@@ -1366,54 +1901,49 @@ size_t print_temp_b_sec8(char** sec8, size_t lmax, const struct temp_chunks* t);
 int print_temp_c(struct metreport* m);
 
 /*!
-  \fn size_t print_temp_c_sec1(char **sec1, size_t lmax, const struct temp_chunks *t)
+  \fn size_t print_temp_c_sec1(struct bufr2tac_buffer *out, const struct temp_chunks *t)
   \brief Print TEMP part C section 1
-  \param [out] sec1 Pointer to string pointer where to write section 1
-  \param [in] lmax Maximum size available
+  \param [in,out] out Growable buffer where to append section 1
   \param [in] t Pointer to temp_chunks structure
   \return Number of bytes written
 */
-size_t print_temp_c_sec1(char** sec1, size_t lmax, const struct temp_chunks* t);
+size_t print_temp_c_sec1(struct bufr2tac_buffer* out, const struct temp_chunks* t);
 
 /*!
-  \fn size_t print_temp_c_sec2(char **sec2, size_t lmax, const struct temp_chunks *t)
+  \fn size_t print_temp_c_sec2(struct bufr2tac_buffer *out, const struct temp_chunks *t)
   \brief Print TEMP part C section 2
-  \param [out] sec2 Pointer to string pointer where to write section 2
-  \param [in] lmax Maximum size available
+  \param [in,out] out Growable buffer where to append section 2
   \param [in] t Pointer to temp_chunks structure
   \return Number of bytes written
 */
-size_t print_temp_c_sec2(char** sec2, size_t lmax, const struct temp_chunks* t);
+size_t print_temp_c_sec2(struct bufr2tac_buffer* out, const struct temp_chunks* t);
 
 /*!
-  \fn size_t print_temp_c_sec3(char **sec3, size_t lmax, const struct temp_chunks *t)
+  \fn size_t print_temp_c_sec3(struct bufr2tac_buffer *out, const struct temp_chunks *t)
   \brief Print TEMP part C section 3
-  \param [out] sec3 Pointer to string pointer where to write section 3
-  \param [in] lmax Maximum size available
+  \param [in,out] out Growable buffer where to append section 3
   \param [in] t Pointer to temp_chunks structure
   \return Number of bytes written
 */
-size_t print_temp_c_sec3(char** sec3, size_t lmax, const struct temp_chunks* t);
+size_t print_temp_c_sec3(struct bufr2tac_buffer* out, const struct temp_chunks* t);
 
 /*!
-  \fn size_t print_temp_c_sec4(char **sec4, size_t lmax, const struct temp_chunks *t)
+  \fn size_t print_temp_c_sec4(struct bufr2tac_buffer *out, const struct temp_chunks *t)
   \brief Print TEMP part C section 4
-  \param [out] sec4 Pointer to string pointer where to write section 4
-  \param [in] lmax Maximum size available
+  \param [in,out] out Growable buffer where to append section 4
   \param [in] t Pointer to temp_chunks structure
   \return Number of bytes written
 */
-size_t print_temp_c_sec4(char** sec4, size_t lmax, const struct temp_chunks* t);
+size_t print_temp_c_sec4(struct bufr2tac_buffer* out, const struct temp_chunks* t);
 
 /*!
-  \fn size_t print_temp_c_sec7(char **sec7, size_t lmax, const struct temp_chunks *t)
+  \fn size_t print_temp_c_sec7(struct bufr2tac_buffer *out, const struct temp_chunks *t)
   \brief Print TEMP part C section 7
-  \param [out] sec7 Pointer to string pointer where to write section 7
-  \param [in] lmax Maximum size available
+  \param [in,out] out Growable buffer where to append section 7
   \param [in] t Pointer to temp_chunks structure
   \return Number of bytes written
 */
-size_t print_temp_c_sec7(char** sec7, size_t lmax, const struct temp_chunks* t);
+size_t print_temp_c_sec7(struct bufr2tac_buffer* out, const struct temp_chunks* t);
 
 /*!
   \fn int print_temp_d(struct metreport *m)
@@ -1424,64 +1954,58 @@ size_t print_temp_c_sec7(char** sec7, size_t lmax, const struct temp_chunks* t);
 int print_temp_d(struct metreport* m);
 
 /*!
-  \fn size_t print_temp_d_sec1(char **sec1, size_t lmax, const struct temp_chunks *t)
+  \fn size_t print_temp_d_sec1(struct bufr2tac_buffer *out, const struct temp_chunks *t)
   \brief Print TEMP part D section 1
-  \param [out] sec1 Pointer to string pointer where to write section 1
-  \param [in] lmax Maximum size available
+  \param [in,out] out Growable buffer where to append section 1
   \param [in] t Pointer to temp_chunks structure
   \return Number of bytes written
 */
-size_t print_temp_d_sec1(char** sec1, size_t lmax, const struct temp_chunks* t);
+size_t print_temp_d_sec1(struct bufr2tac_buffer* out, const struct temp_chunks* t);
 
 /*!
-  \fn size_t print_temp_d_sec5(char **sec5, size_t lmax, const struct temp_chunks *t)
+  \fn size_t print_temp_d_sec5(struct bufr2tac_buffer *out, const struct temp_chunks *t)
   \brief Print TEMP part D section 5
-  \param [out] sec5 Pointer to string pointer where to write section 5
-  \param [in] lmax Maximum size available
+  \param [in,out] out Growable buffer where to append section 5
   \param [in] t Pointer to temp_chunks structure
   \return Number of bytes written
 */
-size_t print_temp_d_sec5(char** sec5, size_t lmax, const struct temp_chunks* t);
+size_t print_temp_d_sec5(struct bufr2tac_buffer* out, const struct temp_chunks* t);
 
 /*!
-  \fn size_t print_temp_d_sec6(char **sec6, size_t lmax, const struct temp_chunks *t)
+  \fn size_t print_temp_d_sec6(struct bufr2tac_buffer *out, const struct temp_chunks *t)
   \brief Print TEMP part D section 6
-  \param [out] sec6 Pointer to string pointer where to write section 6
-  \param [in] lmax Maximum size available
+  \param [in,out] out Growable buffer where to append section 6
   \param [in] t Pointer to temp_chunks structure
   \return Number of bytes written
 */
-size_t print_temp_d_sec6(char** sec6, size_t lmax, const struct temp_chunks* t);
+size_t print_temp_d_sec6(struct bufr2tac_buffer* out, const struct temp_chunks* t);
 
 /*!
-  \fn size_t print_temp_d_sec7(char **sec7, size_t lmax, const struct temp_chunks *t)
+  \fn size_t print_temp_d_sec7(struct bufr2tac_buffer *out, const struct temp_chunks *t)
   \brief Print TEMP part D section 7
-  \param [out] sec7 Pointer to string pointer where to write section 7
-  \param [in] lmax Maximum size available
+  \param [in,out] out Growable buffer where to append section 7
   \param [in] t Pointer to temp_chunks structure
   \return Number of bytes written
 */
-size_t print_temp_d_sec7(char** sec7, size_t lmax, const struct temp_chunks* t);
+size_t print_temp_d_sec7(struct bufr2tac_buffer* out, const struct temp_chunks* t);
 
 /*!
-  \fn size_t print_temp_d_sec8(char **sec8, size_t lmax, const struct temp_chunks *t)
+  \fn size_t print_temp_d_sec8(struct bufr2tac_buffer *out, const struct temp_chunks *t)
   \brief Print TEMP part D section 8
-  \param [out] sec8 Pointer to string pointer where to write section 8
-  \param [in] lmax Maximum size available
+  \param [in,out] out Growable buffer where to append section 8
   \param [in] t Pointer to temp_chunks structure
   \return Number of bytes written
 */
-size_t print_temp_d_sec8(char** sec8, size_t lmax, const struct temp_chunks* t);
+size_t print_temp_d_sec8(struct bufr2tac_buffer* out, const struct temp_chunks* t);
 
 /*!
-  \fn size_t print_temp_wigos_id(char **wid, size_t lmax, struct temp_chunks *t)
+  \fn size_t print_temp_wigos_id(struct bufr2tac_buffer *out, struct temp_chunks *t)
   \brief Print WIGOS identifier for TEMP report
-  \param [out] wid Pointer to string pointer where to write WIGOS ID
-  \param [in] lmax Maximum size available
+  \param [in,out] out Growable buffer where to append WIGOS ID
   \param [in,out] t Pointer to temp_chunks structure
   \return Number of bytes written
 */
-size_t print_temp_wigos_id(char** wid, size_t lmax, struct temp_chunks* t);
+size_t print_temp_wigos_id(struct bufr2tac_buffer* out, struct temp_chunks* t);
 
 // TEMP raw data parsing functions
 
@@ -1566,6 +2090,361 @@ int print_plain(FILE* f, const struct metreport* m);
 */
 int print_html(FILE* f, const struct metreport* m);
 
+/*!
+  \fn int bufr2tac_sink_print_csv(struct bufr2tac_sink *s, const struct metreport *m)
+  \brief Print metreport in CSV format into a sink
+  \param [in,out] s Pointer to struct \ref bufr2tac_sink where to write output
+  \param [in] m Pointer to metreport structure
+  \return 0 on success, 1 on error
+*/
+int bufr2tac_sink_print_csv(struct bufr2tac_sink* s, const struct metreport* m);
+
+/*!
+  \fn int bufr2tac_sink_print_json(struct bufr2tac_sink *s, const struct metreport *m)
+  \brief Print metreport in JSON format into a sink
+  \param [in,out] s Pointer to struct \ref bufr2tac_sink where to write output
+  \param [in] m Pointer to metreport structure
+  \return 0 on success, 1 on error
+*/
+int bufr2tac_sink_print_json(struct bufr2tac_sink* s, const struct metreport* m);
+
+/*!
+  \fn int bufr2tac_sink_print_xml(struct bufr2tac_sink *s, const struct metreport *m)
+  \brief Print metreport in XML format into a sink
+  \param [in,out] s Pointer to struct \ref bufr2tac_sink where to write output
+  \param [in] m Pointer to metreport structure
+  \return 0 on success, 1 on error
+*/
+int bufr2tac_sink_print_xml(struct bufr2tac_sink* s, const struct metreport* m);
+
+/*!
+  \fn int bufr2tac_sink_print_plain(struct bufr2tac_sink *s, const struct metreport *m)
+  \brief Print metreport in plain text format into a sink
+  \param [in,out] s Pointer to struct \ref bufr2tac_sink where to write output
+  \param [in] m Pointer to metreport structure
+  \return 0 on success, 1 on error
+*/
+int bufr2tac_sink_print_plain(struct bufr2tac_sink* s, const struct metreport* m);
+
+/*!
+  \fn int bufr2tac_sink_print_html(struct bufr2tac_sink *s, const struct metreport *m)
+  \brief Print metreport in HTML format into a sink
+  \param [in,out] s Pointer to struct \ref bufr2tac_sink where to write output
+  \param [in] m Pointer to metreport structure
+  \return 0 on success, 1 on error
+*/
+int bufr2tac_sink_print_html(struct bufr2tac_sink* s, const struct metreport* m);
+
+// Output sinks
+
+/*!
+  \fn int bufr2tac_sink_set_callbacks(struct bufr2tac_sink *s, bufr2tac_sink_write_function write, bufr2tac_sink_flush_function flush, void *ctx)
+  \brief Set a sink writing through user callbacks
+  \param [out] s Pointer to struct \ref bufr2tac_sink to set
+  \param [in] write Function to write data
+  \param [in] flush Function to flush data. It can be NULL
+  \param [in] ctx Context passed to \a write and \a flush
+  \return 0 on success, 1 on error
+*/
+int bufr2tac_sink_set_callbacks(struct bufr2tac_sink* s, bufr2tac_sink_write_function write,
+    bufr2tac_sink_flush_function flush, void* ctx);
+
+/*!
+  \fn int bufr2tac_sink_set_file(struct bufr2tac_sink *s, FILE *f)
+  \brief Set a sink writing to a file already open
+  \param [out] s Pointer to struct \ref bufr2tac_sink to set
+  \param [in] f File pointer where to write output
+  \return 0 on success, 1 on error
+*/
+int bufr2tac_sink_set_file(struct bufr2tac_sink* s, FILE* f);
+
+/*!
+  \fn int bufr2tac_sink_set_buffer(struct bufr2tac_sink *s, struct bufr2tac_buffer *b)
+  \brief Set a sink appending to a growable buffer
+  \param [out] s Pointer to struct \ref bufr2tac_sink to set
+  \param [in,out] b Pointer to struct \ref bufr2tac_buffer where to append output
+  \return 0 on success, 1 on error
+*/
+int bufr2tac_sink_set_buffer(struct bufr2tac_sink* s, struct bufr2tac_buffer* b);
+
+/*!
+  \fn int bufr2tac_sink_set_output_buffer(struct bufr2tac_sink *s, struct bufrdeco_output_buffer *ob)
+  \brief Set a sink appending to an output buffer which writes to its stream in large blocks
+  \param [out] s Pointer to struct \ref bufr2tac_sink to set
+  \param [in,out] ob Pointer to struct \ref bufrdeco_output_buffer already inited
+  \return 0 on success, 1 on error
+*/
+int bufr2tac_sink_set_output_buffer(struct bufr2tac_sink* s, struct bufrdeco_output_buffer* ob);
+
+/*!
+  \fn int bufr2tac_sink_write(struct bufr2tac_sink *s, const char *data, size_t len)
+  \brief Write bytes into a sink
+  \param [in,out] s Pointer to struct \ref bufr2tac_sink
+  \param [in] data Bytes to write
+  \param [in] len Number of bytes to write
+  \return 0 on success, 1 on error
+*/
+int bufr2tac_sink_write(struct bufr2tac_sink* s, const char* data, size_t len);
+
+/*!
+  \fn int bufr2tac_sink_puts(struct bufr2tac_sink *s, const char *str)
+  \brief Write a nul terminated string into a sink
+  \param [in,out] s Pointer to struct \ref bufr2tac_sink
+  \param [in] str String to write
+  \return 0 on success, 1 on error
+*/
+int bufr2tac_sink_puts(struct bufr2tac_sink* s, const char* str);
+
+/*!
+  \fn int bufr2tac_sink_put_field(struct bufr2tac_sink *s, const char *before, const char *value, const char *after)
+  \brief Write a string value between two strings into a sink
+  \param [in,out] s Pointer to struct \ref bufr2tac_sink
+  \param [in] before String written before value
+  \param [in] value The value
+  \param [in] after String written after value
+  \return 0 on success, 1 on error
+*/
+int bufr2tac_sink_put_field(struct bufr2tac_sink* s, const char* before, const char* value, const char* after);
+
+/*!
+  \fn int bufr2tac_sink_put_fixed(struct bufr2tac_sink *s, const char *before, double value, int decimals, const char *after)
+  \brief Write a value in fixed point notation between two strings into a sink, without printf(3)
+  \param [in,out] s Pointer to struct \ref bufr2tac_sink
+  \param [in] before String written before value
+  \param [in] value The value
+  \param [in] decimals Number of decimals
+  \param [in] after String written after value
+  \return 0 on success, 1 on error
+*/
+int bufr2tac_sink_put_fixed(struct bufr2tac_sink* s, const char* before, double value, int decimals, const char* after);
+
+/*!
+  \fn int bufr2tac_sink_printf(struct bufr2tac_sink *s, const char *format, ...)
+  \brief Write formatted output into a sink, as printf(3)
+  \param [in,out] s Pointer to struct \ref bufr2tac_sink
+  \param [in] format Format string
+  \return 0 on success, 1 on error
+*/
+int bufr2tac_sink_printf(struct bufr2tac_sink* s, const char* format, ...);
+
+/*!
+  \fn int bufr2tac_sink_flush(struct bufr2tac_sink *s)
+  \brief Flush a sink
+  \param [in,out] s Pointer to struct \ref bufr2tac_sink
+  \return 0 on success, 1 on error
+*/
+int bufr2tac_sink_flush(struct bufr2tac_sink* s);
+
+/*!
+  \fn int bufr2tac_buffer_reserve(struct bufr2tac_buffer *b, size_t n)
+  \brief Make room in a buffer for at least \a n more bytes and the final nul
+  \param [in,out] b Pointer to struct \ref bufr2tac_buffer
+  \param [in] n Bytes to add
+  \return 0 on success, 1 on error
+*/
+int bufr2tac_buffer_reserve(struct bufr2tac_buffer* b, size_t n);
+
+/*!
+  \fn void bufr2tac_buffer_clean(struct bufr2tac_buffer *b)
+  \brief Set a buffer as empty, keeping allocated memory to be reused
+  \param [in,out] b Pointer to struct \ref bufr2tac_buffer
+*/
+void bufr2tac_buffer_clean(struct bufr2tac_buffer* b);
+
+/*!
+  \fn void bufr2tac_buffer_truncate(struct bufr2tac_buffer *b, size_t len)
+  \brief Drop the data of a buffer from \a len on, keeping allocated memory
+  \param [in,out] b Pointer to struct \ref bufr2tac_buffer
+  \param [in] len New length
+*/
+void bufr2tac_buffer_truncate(struct bufr2tac_buffer* b, size_t len);
+
+/*!
+  \fn size_t bufr2tac_buffer_printf(struct bufr2tac_buffer *b, const char *format, ...)
+  \brief Append formatted output to a buffer, as printf(3)
+  \param [in,out] b Pointer to struct \ref bufr2tac_buffer
+  \param [in] format Format string
+  \return Number of bytes appended, 0 on error
+*/
+size_t bufr2tac_buffer_printf(struct bufr2tac_buffer* b, const char* format, ...);
+
+/*!
+  \fn void bufr2tac_buffer_free(struct bufr2tac_buffer *b)
+  \brief Free the memory of a buffer
+  \param [in,out] b Pointer to struct \ref bufr2tac_buffer
+*/
+void bufr2tac_buffer_free(struct bufr2tac_buffer* b);
+
+// Cache of rendered reports
+
+/*!
+  \fn int bufr2tac_render_cache_init(struct bufr2tac_render_cache *c, size_t max_entries, size_t max_bytes)
+  \brief Init a struct \ref bufr2tac_render_cache
+  \param [out] c Pointer to the cache
+  \param [in] max_entries Max number of entries. If 0 then \ref BUFR2TAC_RENDER_CACHE_DEFAULT_ENTRIES
+  \param [in] max_bytes Max bytes of rendered texts. If 0 then \ref BUFR2TAC_RENDER_CACHE_DEFAULT_BYTES
+  \return 0 on success, 1 on error
+*/
+int bufr2tac_render_cache_init(struct bufr2tac_render_cache* c, size_t max_entries, size_t max_bytes);
+
+/*!
+  \fn void bufr2tac_render_cache_free(struct bufr2tac_render_cache *c)
+  \brief Free all the memory of a struct \ref bufr2tac_render_cache. Counters are also cleaned
+  \param [in,out] c Pointer to the cache
+*/
+void bufr2tac_render_cache_free(struct bufr2tac_render_cache* c);
+
+/*!
+  \fn struct bufr2tac_render_entry *bufr2tac_render_cache_find(const struct bufr2tac_render_cache *c, uint64_t hash, uint32_t subset, int format)
+  \brief Find a rendered report without changing the order of use nor the counters
+  \param [in] c Pointer to the cache
+  \param [in] hash Hash of message
+  \param [in] subset Index of subset
+  \param [in] format Output format
+  \return Pointer to the entry if found, NULL otherwise
+*/
+struct bufr2tac_render_entry* bufr2tac_render_cache_find(const struct bufr2tac_render_cache* c, uint64_t hash,
+    uint32_t subset, int format);
+
+/*!
+  \fn struct bufr2tac_render_entry *bufr2tac_render_cache_get(struct bufr2tac_render_cache *c, uint64_t hash, uint32_t subset, int format)
+  \brief Get a rendered report, setting it as the most recently used and counting a hit or a miss
+  \param [in,out] c Pointer to the cache
+  \param [in] hash Hash of message
+  \param [in] subset Index of subset
+  \param [in] format Output format
+  \return Pointer to the entry if found, NULL otherwise. It is valid until next call to \ref bufr2tac_render_cache_put
+*/
+struct bufr2tac_render_entry* bufr2tac_render_cache_get(struct bufr2tac_render_cache* c, uint64_t hash,
+    uint32_t subset, int format);
+
+/*!
+  \fn int bufr2tac_render_cache_put(struct bufr2tac_render_cache *c, uint64_t hash, uint32_t subset, uint32_t subsets, int format, const char *data, size_t len)
+  \brief Add a rendered report to cache, freeing the least recently used ones if needed
+  \param [in,out] c Pointer to the cache
+  \param [in] hash Hash of message
+  \param [in] subset Index of subset
+  \param [in] subsets Number of subsets in message
+  \param [in] format Output format
+  \param [in] data Rendered text
+  \param [in] len Bytes of data
+  \return 0 on success, 1 if it cannot be added, as when len is over the limit of bytes
+*/
+int bufr2tac_render_cache_put(struct bufr2tac_render_cache* c, uint64_t hash, uint32_t subset, uint32_t subsets,
+    int format, const char* data, size_t len);
+
+/*!
+  \fn size_t bufr2tac_print_json_render_cache_stats(FILE *out, const struct bufr2tac_render_cache *c)
+  \brief Print the size and counters of a struct \ref bufr2tac_render_cache as a json object in a single line
+  \param [in] out Stream opened by caller
+  \param [in] c Pointer to the cache
+  \return The amount of bytes sent to out
+*/
+size_t bufr2tac_print_json_render_cache_stats(FILE* out, const struct bufr2tac_render_cache* c);
+
+// Store of observations by station and time
+
+/*!
+  \fn int bufr2tac_store_set_record(struct bufr2tac_store_record *r, const struct metreport *m, const struct bufrdeco_subset_sequence_data *sq)
+  \brief Set a record of an observation store from a decoded report and its subset
+  \param [out] r Pointer to the record
+  \param [in] m Pointer to the decoded report, with the station in \a g and the time in \a t
+  \param [in] sq Pointer to the decoded subset, where the core variables are got from
+  \return 0 on success, 1 if the report has no station or no time
+*/
+int bufr2tac_store_set_record(struct bufr2tac_store_record* r, const struct metreport* m,
+    const struct bufrdeco_subset_sequence_data* sq);
+
+/*!
+  \fn int bufr2tac_store_open(struct bufr2tac_store *st, const char *base)
+  \brief Open an observation store to append records, creating its log if needed
+  \param [out] st Pointer to the store
+  \param [in] base Pathname of store, without the '.log' and '.idx' suffixes
+  \return 0 on success, 1 on error
+*/
+int bufr2tac_store_open(struct bufr2tac_store* st, const char* base);
+
+/*!
+  \fn int bufr2tac_store_append(struct bufr2tac_store *st, const struct bufr2tac_store_record *r)
+  \brief Append a record to the log of an observation store
+  \param [in,out] st Pointer to the store
+  \param [in] r Pointer to the record
+  \return 0 on success, 1 on error
+*/
+int bufr2tac_store_append(struct bufr2tac_store* st, const struct bufr2tac_store_record* r);
+
+/*!
+  \fn int bufr2tac_store_close(struct bufr2tac_store *st)
+  \brief Close the log of an observation store and add the records appended to its index
+  \param [in,out] st Pointer to the store
+  \return 0 on success, 1 on error
+*/
+int bufr2tac_store_close(struct bufr2tac_store* st);
+
+/*!
+  \fn int bufr2tac_store_update_index(const char *base)
+  \brief Add to the index of an observation store the records of log not indexed yet
+  \param [in] base Pathname of store, without the '.log' and '.idx' suffixes
+  \return 0 on success, 1 on error
+
+  The new entries are sorted and merged with the old ones in a new index which replaces the old one at once
+*/
+int bufr2tac_store_update_index(const char* base);
+
+/*!
+  \fn int bufr2tac_store_reader_open(struct bufr2tac_store_reader *rd, const char *base)
+  \brief Map an observation store in memory to query it
+  \param [out] rd Pointer to the reader
+  \param [in] base Pathname of store, without the '.log' and '.idx' suffixes
+  \return 0 on success, 1 on error. A store without index is valid, but all its records are searched one by one
+*/
+int bufr2tac_store_reader_open(struct bufr2tac_store_reader* rd, const char* base);
+
+/*!
+  \fn void bufr2tac_store_reader_close(struct bufr2tac_store_reader *rd)
+  \brief Unmap an observation store
+  \param [in,out] rd Pointer to the reader
+*/
+void bufr2tac_store_reader_close(struct bufr2tac_store_reader* rd);
+
+/*!
+  \fn size_t bufr2tac_store_last(const struct bufr2tac_store_reader *rd, const char *ident, const struct bufr2tac_store_record **out, size_t n)
+  \brief Get the last observations of a station, the newest first
+  \param [in] rd Pointer to the reader
+  \param [in] ident Key of station, as '08221' or a WIGOS id for stations without index
+  \param [out] out Array where to set the pointers to the records found
+  \param [in] n Max number of records to get, dimension of \a out
+  \return The number of records found
+
+  An observation stored more than once, same time and type of report, is got once, the last copy stored
+*/
+size_t bufr2tac_store_last(const struct bufr2tac_store_reader* rd, const char* ident,
+    const struct bufr2tac_store_record** out, size_t n);
+
+/*!
+  \typedef syn_parse_x_function
+  \brief Parser of a class X of descriptors for a SYNOP report
+*/
+typedef int (*syn_parse_x_function)(struct synop_chunks* syn, struct bufr2tac_subset_state* s);
+
+/*!
+  \typedef buoy_parse_x_function
+  \brief Parser of a class X of descriptors for a BUOY report
+*/
+typedef int (*buoy_parse_x_function)(struct buoy_chunks* b, struct bufr2tac_subset_state* s);
+
+/*!
+  \typedef climat_parse_x_function
+  \brief Parser of a class X of descriptors for a CLIMAT report
+*/
+typedef int (*climat_parse_x_function)(struct climat_chunks* c, struct bufr2tac_subset_state* s);
+
+/*!
+  \typedef temp_parse_x_function
+  \brief Parser of a class X of descriptors for a TEMP report
+*/
+typedef int (*temp_parse_x_function)(struct temp_chunks* t, struct bufr2tac_subset_state* s);
+
 // SYNOP descriptor parsing functions (class X)
 // These functions parse BUFR descriptors from class X (0-3) for SYNOP reports
 // Each function handles specific descriptor categories
@@ -1697,13 +2576,13 @@ int syn_parse_x20(struct synop_chunks* syn, struct bufr2tac_subset_state* s);
 int syn_parse_x22(struct synop_chunks* syn, struct bufr2tac_subset_state* s);
 
 /*!
-  \fn int syn_parse_x31(const struct synop_chunks *syn, struct bufr2tac_subset_state *s)
+  \fn int syn_parse_x31(struct synop_chunks *syn, struct bufr2tac_subset_state *s)
   \brief Parse BUFR class 31 descriptors (data description and delayed replication factors) for SYNOP
   \param [in] syn Pointer to synop_chunks structure
   \param [in,out] s Pointer to subset state
   \return 0 on success, 1 on error
 */
-int syn_parse_x31(const struct synop_chunks* syn, struct bufr2tac_subset_state* s);
+int syn_parse_x31(struct synop_chunks* syn, struct bufr2tac_subset_state* s);
 
 // BUOY descriptor parsing functions (class X)
 // These functions parse BUFR descriptors from class X (0-3) for BUOY reports
@@ -1755,13 +2634,13 @@ int buoy_parse_x05(struct buoy_chunks* b, struct bufr2tac_subset_state* s);
 int buoy_parse_x06(struct buoy_chunks* b, struct bufr2tac_subset_state* s);
 
 /*!
-  \fn int buoy_parse_x07(const struct buoy_chunks *b, struct bufr2tac_subset_state *s)
+  \fn int buoy_parse_x07(struct buoy_chunks *b, struct bufr2tac_subset_state *s)
   \brief Parse BUFR class 07 descriptors (height, altitude, pressure) for BUOY
   \param [in] b Pointer to buoy_chunks structure
   \param [in,out] s Pointer to subset state
   \return 0 on success, 1 on error
 */
-int buoy_parse_x07(const struct buoy_chunks* b, struct bufr2tac_subset_state* s);
+int buoy_parse_x07(struct buoy_chunks* b, struct bufr2tac_subset_state* s);
 
 /*!
   \fn int buoy_parse_x08(const struct buoy_chunks *b, struct bufr2tac_subset_state *s)
@@ -1800,31 +2679,31 @@ int buoy_parse_x11(struct buoy_chunks* b, struct bufr2tac_subset_state* s);
 int buoy_parse_x12(struct buoy_chunks* b, struct bufr2tac_subset_state* s);
 
 /*!
-  \fn int buoy_parse_x13(const struct buoy_chunks *b, struct bufr2tac_subset_state *s)
+  \fn int buoy_parse_x13(struct buoy_chunks *b, struct bufr2tac_subset_state *s)
   \brief Parse BUFR class 13 descriptors (humidity and moisture) for BUOY
   \param [in] b Pointer to buoy_chunks structure
   \param [in,out] s Pointer to subset state
   \return 0 on success, 1 on error
 */
-int buoy_parse_x13(const struct buoy_chunks* b, struct bufr2tac_subset_state* s);
+int buoy_parse_x13(struct buoy_chunks* b, struct bufr2tac_subset_state* s);
 
 /*!
-  \fn int buoy_parse_x14(const struct buoy_chunks *b, struct bufr2tac_subset_state *s)
+  \fn int buoy_parse_x14(struct buoy_chunks *b, struct bufr2tac_subset_state *s)
   \brief Parse BUFR class 14 descriptors (radiation and brightness) for BUOY
   \param [in] b Pointer to buoy_chunks structure
   \param [in,out] s Pointer to subset state
   \return 0 on success, 1 on error
 */
-int buoy_parse_x14(const struct buoy_chunks* b, struct bufr2tac_subset_state* s);
+int buoy_parse_x14(struct buoy_chunks* b, struct bufr2tac_subset_state* s);
 
 /*!
-  \fn int buoy_parse_x20(const struct buoy_chunks *b, struct bufr2tac_subset_state *s)
+  \fn int buoy_parse_x20(struct buoy_chunks *b, struct bufr2tac_subset_state *s)
   \brief Parse BUFR class 20 descriptors (visibility, clouds, and weather phenomena) for BUOY
   \param [in] b Pointer to buoy_chunks structure
   \param [in,out] s Pointer to subset state
   \return 0 on success, 1 on error
 */
-int buoy_parse_x20(const struct buoy_chunks* b, struct bufr2tac_subset_state* s);
+int buoy_parse_x20(struct buoy_chunks* b, struct bufr2tac_subset_state* s);
 
 /*!
   \fn int buoy_parse_x22(struct buoy_chunks *b, struct bufr2tac_subset_state *s)
@@ -1836,13 +2715,13 @@ int buoy_parse_x20(const struct buoy_chunks* b, struct bufr2tac_subset_state* s)
 int buoy_parse_x22(struct buoy_chunks* b, struct bufr2tac_subset_state* s);
 
 /*!
-  \fn int buoy_parse_x31(const struct buoy_chunks *b, struct bufr2tac_subset_state *s)
+  \fn int buoy_parse_x31(struct buoy_chunks *b, struct bufr2tac_subset_state *s)
   \brief Parse BUFR class 31 descriptors (data description and delayed replication factors) for BUOY
   \param [in] b Pointer to buoy_chunks structure
   \param [in,out] s Pointer to subset state
   \return 0 on success, 1 on error
 */
-int buoy_parse_x31(const struct buoy_chunks* b, struct bufr2tac_subset_state* s);
+int buoy_parse_x31(struct buoy_chunks* b, struct bufr2tac_subset_state* s);
 
 /*!
   \fn int buoy_parse_x33(struct buoy_chunks *b, struct bufr2tac_subset_state *s)
@@ -1885,31 +2764,31 @@ int climat_parse_x02(struct climat_chunks* c, struct bufr2tac_subset_state* s);
 int climat_parse_x04(struct climat_chunks* c, struct bufr2tac_subset_state* s);
 
 /*!
-  \fn int climat_parse_x05(const struct climat_chunks *c, struct bufr2tac_subset_state *s)
+  \fn int climat_parse_x05(struct climat_chunks *c, struct bufr2tac_subset_state *s)
   \brief Parse BUFR class 05 descriptors (horizontal coordinates) for CLIMAT
   \param [in] c Pointer to climat_chunks structure
   \param [in,out] s Pointer to subset state
   \return 0 on success, 1 on error
 */
-int climat_parse_x05(const struct climat_chunks* c, struct bufr2tac_subset_state* s);
+int climat_parse_x05(struct climat_chunks* c, struct bufr2tac_subset_state* s);
 
 /*!
-  \fn int climat_parse_x06(const struct climat_chunks *c, struct bufr2tac_subset_state *s)
+  \fn int climat_parse_x06(struct climat_chunks *c, struct bufr2tac_subset_state *s)
   \brief Parse BUFR class 06 descriptors (vertical coordinates) for CLIMAT
   \param [in] c Pointer to climat_chunks structure
   \param [in,out] s Pointer to subset state
   \return 0 on success, 1 on error
 */
-int climat_parse_x06(const struct climat_chunks* c, struct bufr2tac_subset_state* s);
+int climat_parse_x06(struct climat_chunks* c, struct bufr2tac_subset_state* s);
 
 /*!
-  \fn int climat_parse_x07(const struct climat_chunks *c, struct bufr2tac_subset_state *s)
+  \fn int climat_parse_x07(struct climat_chunks *c, struct bufr2tac_subset_state *s)
   \brief Parse BUFR class 07 descriptors (height, altitude, pressure) for CLIMAT
   \param [in] c Pointer to climat_chunks structure
   \param [in,out] s Pointer to subset state
   \return 0 on success, 1 on error
 */
-int climat_parse_x07(const struct climat_chunks* c, struct bufr2tac_subset_state* s);
+int climat_parse_x07(struct climat_chunks* c, struct bufr2tac_subset_state* s);
 
 /*!
   \fn int climat_parse_x08(struct climat_chunks *c, struct bufr2tac_subset_state *s)
@@ -2069,31 +2948,31 @@ int temp_parse_x07(struct temp_chunks* t, struct bufr2tac_subset_state* s);
 int temp_parse_x08(const struct temp_chunks* t, struct bufr2tac_subset_state* s);
 
 /*!
-  \fn int temp_parse_x10(const struct temp_chunks *t, struct bufr2tac_subset_state *s)
+  \fn int temp_parse_x10(struct temp_chunks *t, struct bufr2tac_subset_state *s)
   \brief Parse BUFR class 10 descriptors (pressure) for TEMP
   \param [in] t Pointer to temp_chunks structure
   \param [in,out] s Pointer to subset state
   \return 0 on success, 1 on error
 */
-int temp_parse_x10(const struct temp_chunks* t, struct bufr2tac_subset_state* s);
+int temp_parse_x10(struct temp_chunks* t, struct bufr2tac_subset_state* s);
 
 /*!
-  \fn int temp_parse_x11(const struct temp_chunks *t, struct bufr2tac_subset_state *s)
+  \fn int temp_parse_x11(struct temp_chunks *t, struct bufr2tac_subset_state *s)
   \brief Parse BUFR class 11 descriptors (wind data) for TEMP
   \param [in] t Pointer to temp_chunks structure
   \param [in,out] s Pointer to subset state
   \return 0 on success, 1 on error
 */
-int temp_parse_x11(const struct temp_chunks* t, struct bufr2tac_subset_state* s);
+int temp_parse_x11(struct temp_chunks* t, struct bufr2tac_subset_state* s);
 
 /*!
-  \fn int temp_parse_x12(const struct temp_chunks *t, struct bufr2tac_subset_state *s)
+  \fn int temp_parse_x12(struct temp_chunks *t, struct bufr2tac_subset_state *s)
   \brief Parse BUFR class 12 descriptors (temperature and dew point) for TEMP
   \param [in] t Pointer to temp_chunks structure
   \param [in,out] s Pointer to subset state
   \return 0 on success, 1 on error
 */
-int temp_parse_x12(const struct temp_chunks* t, struct bufr2tac_subset_state* s);
+int temp_parse_x12(struct temp_chunks* t, struct bufr2tac_subset_state* s);
 
 /*!
   \fn int temp_parse_x20(struct temp_chunks *t, struct bufr2tac_subset_state *s)
@@ -2114,13 +2993,13 @@ int temp_parse_x20(struct temp_chunks* t, struct bufr2tac_subset_state* s);
 int temp_parse_x22(struct temp_chunks* t, struct bufr2tac_subset_state* s);
 
 /*!
-  \fn int temp_parse_x31(const struct temp_chunks *t, struct bufr2tac_subset_state *s)
+  \fn int temp_parse_x31(struct temp_chunks *t, struct bufr2tac_subset_state *s)
   \brief Parse BUFR class 31 descriptors (data description and delayed replication factors) for TEMP
   \param [in] t Pointer to temp_chunks structure
   \param [in,out] s Pointer to subset state
   \return 0 on success, 1 on error
 */
-int temp_parse_x31(const struct temp_chunks* t, struct bufr2tac_subset_state* s);
+int temp_parse_x31(struct temp_chunks* t, struct bufr2tac_subset_state* s);
 
 /*!
   \fn int temp_parse_x33(struct temp_chunks *t, struct bufr2tac_subset_state *s)
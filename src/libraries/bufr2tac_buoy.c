@@ -64,6 +64,30 @@ int buoy_YYYYMMDDHHmm_to_JMMYYGGgg ( struct buoy_chunks *b )
   return 0;
 }
 
+/*!
+  \brief Parsers of BUOY descriptors indexed by class X. NULL for the classes not used in a BUOY
+
+  Class 08 is not here because it is checked for every descriptor before this dispatch
+*/
+static const buoy_parse_x_function buoy_parse_x[BUFR2TAC_NUM_X_CLASSES] =
+{
+  [1] = buoy_parse_x01, // localization descriptors
+  [2] = buoy_parse_x02, // Type of station descriptors
+  [4] = buoy_parse_x04, // Date time descriptors
+  [5] = buoy_parse_x05, // Position
+  [6] = buoy_parse_x06, // Horizontal Position -2
+  [7] = buoy_parse_x07, // Vertical Position
+  [10] = buoy_parse_x10, // Air Pressure descriptors
+  [11] = buoy_parse_x11, // wind  data
+  [12] = buoy_parse_x12, // Temperature descriptors
+  [13] = buoy_parse_x13, // Humidity and precipitation data
+  [14] = buoy_parse_x14, // Radiation
+  [20] = buoy_parse_x20, // Cloud data
+  [22] = buoy_parse_x22, // Oceanographic data
+  [31] = buoy_parse_x31, // Replicators
+  [33] = buoy_parse_x33, // Quality data
+};
+
 /*!
   \fn int parse_subset_as_buoy(struct metreport *m, struct bufr_subset_sequence_data *sq, char *err)
   \brief parses a subset sequence as an Buoy SYNOP FM-18 report
@@ -78,12 +102,14 @@ int parse_subset_as_buoy ( struct metreport *m, struct bufr2tac_subset_state *s,
   size_t is;
   char aux[32];
   struct buoy_chunks *b;
+  buoy_parse_x_function parse_x;
 
   //
   b = &m->buoy;
 
   // clean data
   bufr2tac_clean_buoy_chunks ( b );
+  m->dirty |= METREPORT_DIRTY_BUOY;
 
   // reject if still not coded type
   if ( strcmp ( s->type_report,"ZZYY" ) )
@@ -124,73 +150,10 @@ int parse_subset_as_buoy ( struct metreport *m, struct bufr2tac_subset_state *s,
           s->a1 = &sq->sequence[is - 1];
         }
 
-      switch ( sq->sequence[is].desc.x )
+      if ( sq->sequence[is].desc.x < BUFR2TAC_NUM_X_CLASSES &&
+           ( parse_x = buoy_parse_x[sq->sequence[is].desc.x] ) != NULL )
         {
-
-        case 1: //localization descriptors
-          buoy_parse_x01 ( b, s );
-          break;
-
-        case 2: //Date time descriptors
-          buoy_parse_x02 ( b, s );
-          break;
-
-        case 4: //Date time descriptors
-          buoy_parse_x04 ( b, s );
-          break;
-
-        case 5: //Position
-          buoy_parse_x05 ( b, s );
-          break;
-
-        case 6: // Horizontal Position -2
-          buoy_parse_x06 ( b, s );
-          break;
-
-        case 7: // Vertical Position
-          buoy_parse_x07 ( b, s );
-          break;
-
-        case 10: // Air Pressure descriptors
-          buoy_parse_x10 ( b, s );
-          break;
-
-        case 11: // wind  data
-          buoy_parse_x11 ( b, s );
-          break;
-
-        case 12: //Temperature descriptors
-          buoy_parse_x12 ( b, s );
-          break;
-
-        case 13: // Humidity and precipitation data
-          buoy_parse_x13 ( b, s );
-          break;
-
-        case 14: // Radiation
-          buoy_parse_x14 ( b, s );
-          break;
-
-        case 20: // Cloud data
-          buoy_parse_x20 ( b, s );
-          break;
-
-        case 22: // Oceanographic data
-          buoy_parse_x22 ( b, s );
-          break;
-
-        case 31: // Replicators
-          buoy_parse_x31 ( b, s );
-          break;
-
-
-        case 33: // Quality data
-          buoy_parse_x33 ( b, s );
-          break;
-
-
-        default:
-          break;
+          parse_x ( b, s );
         }
 
     }
@@ -25,6 +25,25 @@
 
 
 
+/*!
+  \brief Parsers of CLIMAT descriptors indexed by class X. NULL for the classes not used in a CLIMAT
+*/
+static const climat_parse_x_function climat_parse_x[BUFR2TAC_NUM_X_CLASSES] =
+{
+  [1] = climat_parse_x01, // localization descriptors
+  [2] = climat_parse_x02, // Type of station descriptors
+  [4] = climat_parse_x04, // Date and time descriptors
+  [5] = climat_parse_x05, // Horizontal position. Latitude
+  [6] = climat_parse_x06, // Horizontal position. Longitude
+  [7] = climat_parse_x07, // Vertical position
+  [8] = climat_parse_x08, // significance qualifier
+  [10] = climat_parse_x10, // Air pressure
+  [11] = climat_parse_x11, // Wind
+  [12] = climat_parse_x12, // Temperature
+  [13] = climat_parse_x13, // Humidity and precipitation data
+  [14] = climat_parse_x14, // Radiation
+};
+
 /*!
   \fn int parse_subset_as_climat(struct metreport *m, char *type, struct bufr_subset_sequence_data *sq, char *err)
   \brief parses a subset sequence as an Land fixed CLIMAT FM-71 report
@@ -39,11 +58,13 @@ int parse_subset_as_climat ( struct metreport *m, struct bufr2tac_subset_state *
   size_t is;
   char aux[32];
   struct climat_chunks *c;
+  climat_parse_x_function parse_x;
 
   c = &m->climat;
 
   // clean data
   bufr2tac_clean_climat_chunks ( c );
+  m->dirty |= METREPORT_DIRTY_CLIMAT;
 
   // reject if still not coded type
   if ( strcmp ( s->type_report,"CLIMAT" ) )
@@ -66,58 +87,10 @@ int parse_subset_as_climat ( struct metreport *m, struct bufr2tac_subset_state *
           s->a1 = &sq->sequence[is - 1];
         }
 
-      switch ( sq->sequence[is].desc.x )
+      if ( sq->sequence[is].desc.x < BUFR2TAC_NUM_X_CLASSES &&
+           ( parse_x = climat_parse_x[sq->sequence[is].desc.x] ) != NULL )
         {
-        case 1: //localization descriptors
-          climat_parse_x01 ( c, s );
-          break;
-
-        case 2: //Type of station descriptors
-          climat_parse_x02 ( c, s );
-          break;
-
-        case 4: //Date and time descriptors
-          climat_parse_x04 ( c, s );
-          break;
-
-        case 5: // Horizontal position. Latitude
-          climat_parse_x05 ( c, s );
-          break;
-
-        case 6: // Horizontal position. Longitude
-          climat_parse_x06 ( c, s );
-          break;
-
-        case 7: // Vertical position
-          climat_parse_x07 ( c, s );
-          break;
-
-        case 8: // significance qualifier
-          climat_parse_x08 ( c, s );
-          break;
-
-        case 10: // Air pressure
-          climat_parse_x10 ( c, s );
-          break;
-
-        case 11: // Wind
-          climat_parse_x11 ( c, s );
-          break;
-
-        case 12: // Temperature
-          climat_parse_x12 ( c, s );
-          break;
-
-        case 13: // Humidity and precipitation data
-          climat_parse_x13 ( c, s );
-          break;
-
-        case 14: // Radiation
-          climat_parse_x14 ( c, s );
-          break;
-
-        default:
-          break;
+          parse_x ( c, s );
         }
 
     }
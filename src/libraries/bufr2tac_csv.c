@@ -24,96 +24,119 @@
 #include "bufr2tac.h"
 
 /*!
-  \fn int print_csv_alphanum(FILE *f, const char *type, const char *alphanum, const struct metreport *m)
+  \fn static int print_csv_alphanum(struct bufr2tac_sink *s, const char *type, const struct bufr2tac_buffer *tac, const struct metreport *m)
   \brief Prints a single alphanumeric report in CSV format
-  \param [in] f File pointer to output stream
+  \param [in,out] s Pointer to struct \ref bufr2tac_sink where to write
   \param [in] type Report type string
-  \param [in] alphanum Alphanumeric report string
+  \param [in] tac Pointer to struct \ref bufr2tac_buffer with the report
   \param [in] m Pointer to struct \ref metreport containing the data
   \return 0 on success
 */
-int print_csv_alphanum ( FILE *f, const char *type, const char *alphanum, const struct metreport *m )
+static int print_csv_alphanum ( struct bufr2tac_sink *s, const char *type, const struct bufr2tac_buffer *tac, const struct metreport *m )
 {
   // prints header
-  fprintf ( f, "\"%s\",", type );
+  bufr2tac_sink_put_field ( s, "\"", type, "\"," );
   // print GTS_HEADER
   if ( m->h != NULL )
     {
-      fprintf ( f, "\"%s\",",m->h->filename );
-      fprintf ( f, "\"%s %s %s %s\",",m->h->bname, m->h->center, m->h->dtrel, m->h->order );
+      bufr2tac_sink_put_field ( s, "\"", m->h->filename, "\"," );
+      bufr2tac_sink_put_field ( s, "\"", m->h->bname, " " );
+      bufr2tac_sink_put_field ( s, "", m->h->center, " " );
+      bufr2tac_sink_put_field ( s, "", m->h->dtrel, " " );
+      bufr2tac_sink_put_field ( s, "", m->h->order, "\"," );
     }
   else
     {
-      fprintf ( f, ",," );
+      bufr2tac_sink_puts ( s, ",," );
     }
   // print DATE AND TIME
-  fprintf ( f, "\"%s\",",m->t.datime );
+  bufr2tac_sink_put_field ( s, "\"", m->t.datime, "\"," );
 
   // Geo data
   if ( strlen ( m->g.index ) )
     {
-      fprintf ( f, "\"%s\",", m->g.index );
+      bufr2tac_sink_put_field ( s, "\"", m->g.index, "\"," );
     }
   else
     {
-      fprintf ( f, "," );
+      bufr2tac_sink_puts ( s, "," );
     }
 
   if ( strlen ( m->g.name ) )
     {
-      fprintf ( f, "\"%s\",", m->g.name );
+      bufr2tac_sink_put_field ( s, "\"", m->g.name, "\"," );
     }
   else
     {
-      fprintf ( f, "," );
+      bufr2tac_sink_puts ( s, "," );
     }
 
 
   if ( strlen ( m->g.country ) )
     {
-      fprintf ( f, "\"%s\",", m->g.country );
+      bufr2tac_sink_put_field ( s, "\"", m->g.country, "\"," );
     }
   else
     {
-      fprintf ( f, "," );
+      bufr2tac_sink_puts ( s, "," );
     }
 
-  fprintf ( f, "%.6lf,", m->g.lat );
-  fprintf ( f, "%.6lf,", m->g.lon );
-  fprintf ( f, "%.1lf,", m->g.alt );
-  fprintf ( f, "\"%s=\"\n", alphanum );
-  return 0;
+  bufr2tac_sink_put_fixed ( s, "", m->g.lat, 6, "," );
+  bufr2tac_sink_put_fixed ( s, "", m->g.lon, 6, "," );
+  bufr2tac_sink_put_fixed ( s, "", m->g.alt, 1, "," );
+  bufr2tac_sink_puts ( s, "\"" );
+  bufr2tac_sink_write ( s, tac->s, tac->len );
+  bufr2tac_sink_puts ( s, "=\"\n" );
+  return s->error;
 }
 
 /*!
-  \fn int print_csv(FILE *f, const struct metreport *m)
+  \fn int bufr2tac_sink_print_csv(struct bufr2tac_sink *s, const struct metreport *m)
   \brief prints a struct \ref metreport in labeled csv format
-  \param [in] f Pointer to a file already open by caller routine
+  \param [in,out] s Pointer to struct \ref bufr2tac_sink where to write
   \param [in] m Pointer to struct \ref metreport containing the data to print
   \return 0 on success
 */
-int print_csv ( FILE *f, const struct metreport *m )
+int bufr2tac_sink_print_csv ( struct bufr2tac_sink *s, const struct metreport *m )
 {
   // Single report
-  if ( m->alphanum[0] )
+  if ( m->tac[0].len )
     {
-      print_csv_alphanum ( f, m->type, m->alphanum, m );
+      print_csv_alphanum ( s, m->type, & ( m->tac[0] ), m );
     }
 
-  if ( m->alphanum2[0] ) //TTBB
+  if ( m->tac[1].len ) //TTBB
     {
-      print_csv_alphanum ( f, m->type2, m->alphanum2, m );
+      print_csv_alphanum ( s, m->type2, & ( m->tac[1] ), m );
     }
 
-  if ( m->alphanum3[0] ) //TTCC
+  if ( m->tac[2].len ) //TTCC
     {
-      print_csv_alphanum ( f, m->type3, m->alphanum3, m );
+      print_csv_alphanum ( s, m->type3, & ( m->tac[2] ), m );
     }
 
-  if ( m->alphanum4[0] ) //TTDD
+  if ( m->tac[3].len ) //TTDD
     {
-      print_csv_alphanum ( f, m->type4, m->alphanum4, m );
+      print_csv_alphanum ( s, m->type4, & ( m->tac[3] ), m );
     }
 
-  return 0;
+  return s->error;
+}
+
+/*!
+  \fn int print_csv(FILE *f, const struct metreport *m)
+  \brief prints a struct \ref metreport in labeled csv format
+  \param [in] f Pointer to a file already open by caller routine
+  \param [in] m Pointer to struct \ref metreport containing the data to print
+  \return 0 on success
+*/
+int print_csv ( FILE *f, const struct metreport *m )
+{
+  struct bufrdeco_output_buffer ob;
+  struct bufr2tac_sink s;
+
+  if ( bufrdeco_out_init ( &ob, f ) || bufr2tac_sink_set_output_buffer ( &s, &ob ) )
+    return 1;
+  bufr2tac_sink_print_csv ( &s, m );
+  return bufr2tac_sink_flush ( &s ) || s.error;
 }
@@ -38,9 +38,10 @@ int bufr2tac_push_error(struct bufr2tac_error_stack* e, int severity, const char
         return -1; // Fatal error
 
     if (e->ne < BUFR2TAC_ERROR_STACK_DIM) {
-        e->err[e->ne].severity = severity;
-        strncpy(e->err[e->ne].description, description, sizeof(e->err[e->ne].description) - 1);
-        e->err[e->ne].description[sizeof(e->err[e->ne].description) - 1] = '\0';
+        struct bufr2tac_error* err = &e->err[e->ne];
+        memset(err, 0, sizeof(struct bufr2tac_error));
+        err->severity = severity;
+        err->explanation = description;
         (e->ne)++;
         return 1;
     } else if (e->ne == BUFR2TAC_ERROR_STACK_DIM) {
@@ -78,60 +79,76 @@ int bufr2tac_clean_error_stack(struct bufr2tac_error_stack* e)
 */
 int bufr2tac_set_error(struct bufr2tac_subset_state* s, int severity, const char* origin, const char* explanation)
 {
-    char description[BUFR2TAC_ERROR_DESCRIPTION_LENGTH];
-    char* c = description;
-    size_t rem = sizeof(description);
+    struct bufr2tac_error* err;
+    int res;
+
+    // Just annotate where and what. The text is written by bufr2tac_error_description() if someone asks for it
+    if ((res = bufr2tac_push_error(&s->e, severity, explanation)) != 1)
+        return res;
+
+    err = &s->e.err[s->e.ne - 1];
+    err->origin = origin;
+    err->i = s->i;
+    err->a = s->a;
+    err->f = s->a->desc.f;
+    err->x = s->a->desc.x;
+    err->y = s->a->desc.y;
+    err->mask = s->a->mask;
+    err->val = s->a->val;
+    return res;
+}
+
+/*!
+  \fn char* bufr2tac_error_description(char* target, size_t dim, const struct bufr2tac_error* err)
+  \brief Write the text of an error
+  \param [out] target String where to write the text
+  \param [in] dim Size of \a target
+  \param [in] err Pointer to struct \ref bufr2tac_error
+  \return Pointer to \a target
+
+  The descriptor name and strings are taken from the atom only if it still has the same descriptor than when the
+  error was set.
+*/
+char* bufr2tac_error_description(char* target, size_t dim, const struct bufr2tac_error* err)
+{
+    const struct bufr_atom_data* a;
+    size_t used = 0;
     int n;
 
-    n = snprintf(c, rem, "%s: ", origin);
-    if (n >= 0 && (size_t)n < rem) {
-        c += n;
-        rem -= n;
-    } else {
-        rem = 0;
-    }
+    if (target == NULL || dim == 0)
+        return target;
+    target[0] = '\0';
 
-    if (rem > 0) {
-        n = snprintf(c, rem, " Descriptor: %u %02u %03u: \"%s\"", s->a->desc.f, s->a->desc.x, s->a->desc.y, s->a->name);
-        if (n >= 0 && (size_t)n < rem) {
-            c += n;
-            rem -= n;
-        } else {
-            rem = 0;
-        }
+    if (err->origin == NULL) {
+        // Pushed directly with bufr2tac_push_error()
+        snprintf(target, dim, "%s", err->explanation ? err->explanation : "");
+        return target;
     }
 
-    if (rem > 0) {
-        if (s->a->mask & DESCRIPTOR_VALUE_MISSING) {
-            n = snprintf(c, rem, " = MISSING. ");
-            if (n >= 0 && (size_t)n < rem) {
-                c += n;
-                rem -= n;
-            } else {
-                rem = 0;
-            }
-        } else {
-            if (s->a->cval[0])
-                n = snprintf(c, rem, " = '%s'. ", s->a->cval);
-            else if (s->a->desc.x == 2)
-                n = snprintf(c, rem, " = '%s'. ", s->a->ctable);
-            else
-                n = snprintf(c, rem, " = %lf . ", s->a->val);
-
-            if (n >= 0 && (size_t)n < rem) {
-                c += n;
-                rem -= n;
-            } else {
-                rem = 0;
-            }
-        }
-    }
+    a = err->a;
+    if (a != NULL && (a->desc.f != err->f || a->desc.x != err->x || a->desc.y != err->y))
+        a = NULL;
 
-    if (rem > 0) {
-        snprintf(c, rem, "%s", explanation);
-    }
+    n = snprintf(target, dim, "%s:  Descriptor: %u %02u %03u: \"%s\"", err->origin, err->f, err->x, err->y,
+                 a ? a->name : "");
+    if (n < 0 || (size_t)n >= dim)
+        return target;
+    used = n;
 
-    return bufr2tac_push_error(&s->e, severity, description);
+    if (err->mask & DESCRIPTOR_VALUE_MISSING)
+        n = snprintf(target + used, dim - used, " = MISSING. ");
+    else if (a != NULL && a->cval[0])
+        n = snprintf(target + used, dim - used, " = '%s'. ", a->cval);
+    else if (a != NULL && err->x == 2)
+        n = snprintf(target + used, dim - used, " = '%s'. ", a->ctable);
+    else
+        n = snprintf(target + used, dim - used, " = %lf . ", err->val);
+    if (n < 0 || (size_t)n >= dim - used)
+        return target;
+    used += n;
+
+    snprintf(target + used, dim - used, "%s", err->explanation ? err->explanation : "");
+    return target;
 }
 
 /*!
@@ -142,6 +159,7 @@ int bufr2tac_set_error(struct bufr2tac_subset_state* s, int severity, const char
 */
 int bufr2tac_print_error(const struct bufr2tac_error_stack* e)
 {
+    char description[BUFR2TAC_ERROR_DESCRIPTION_LENGTH];
     unsigned int i;
     if (e->ne == 0) {
         printf("# No info/warning/error \n");
@@ -159,7 +177,7 @@ int bufr2tac_print_error(const struct bufr2tac_error_stack* e)
             printf("# %d\n", e->err[i].severity);
             return 1;
         }
-        printf("%s\n", e->err[i].description);
+        printf("%s\n", bufr2tac_error_description(description, sizeof(description), &e->err[i]));
     }
     if (e->full > 0)
         printf("# More debug info follows, stack of logs full\n");
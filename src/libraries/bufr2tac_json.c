@@ -24,76 +24,99 @@
 #include "bufr2tac.h"
 
 /*!
-  \fn int print_json_alphanum(FILE *f, const char *type, const char *alphanum, const struct metreport *m)
+  \fn static int print_json_alphanum(struct bufr2tac_sink *s, const char *type, const struct bufr2tac_buffer *tac, const struct metreport *m)
   \brief Prints a single alphanumeric report in JSON format
-  \param [in] f File pointer to output stream
+  \param [in,out] s Pointer to struct \ref bufr2tac_sink where to write
   \param [in] type Report type string
-  \param [in] alphanum Alphanumeric report string
+  \param [in] tac Pointer to struct \ref bufr2tac_buffer with the report
   \param [in] m Pointer to struct \ref metreport containing the data
   \return 0 on success
 */
-int print_json_alphanum ( FILE *f, const char *type, const char *alphanum, const struct metreport *m )
+static int print_json_alphanum ( struct bufr2tac_sink *s, const char *type, const struct bufr2tac_buffer *tac, const struct metreport *m )
 {
-  fprintf ( f, " { \n  \"type\": \"%s\",\n", type );
+  bufr2tac_sink_put_field ( s, " { \n  \"type\": \"", type, "\",\n" );
   if ( m->h != NULL )
     {
-      fprintf ( f, "  \"bufrfile\": \"%s\",\n", m->h->filename );
-      fprintf ( f, "  \"gts_header\": \"%s %s %s %s\",\n", m->h->bname, m->h->center, m->h->dtrel, m->h->order );
+      bufr2tac_sink_put_field ( s, "  \"bufrfile\": \"", m->h->filename, "\",\n" );
+      bufr2tac_sink_put_field ( s, "  \"gts_header\": \"", m->h->bname, " " );
+      bufr2tac_sink_put_field ( s, "", m->h->center, " " );
+      bufr2tac_sink_put_field ( s, "", m->h->dtrel, " " );
+      bufr2tac_sink_put_field ( s, "", m->h->order, "\",\n" );
     }
-  fprintf ( f, "  \"observation_datetime\": \"%s\",\n", m->t.datime );
-  fprintf ( f, "  \"geo\": { \n" );
+  bufr2tac_sink_put_field ( s, "  \"observation_datetime\": \"", m->t.datime, "\",\n" );
+  bufr2tac_sink_puts ( s, "  \"geo\": { \n" );
   if ( strlen ( m->g.index ) )
     {
-      fprintf ( f, "    \"index\": \"%s\",\n", m->g.index );
+      bufr2tac_sink_put_field ( s, "    \"index\": \"", m->g.index, "\",\n" );
     }
   if ( strlen ( m->g.name ) )
     {
-      fprintf ( f, "    \"name\": \"%s\",\n", m->g.name );
+      bufr2tac_sink_put_field ( s, "    \"name\": \"", m->g.name, "\",\n" );
     }
   if ( strlen ( m->g.country ) )
     {
-      fprintf ( f, "    \"country\": \"%s\",\n", m->g.country );
+      bufr2tac_sink_put_field ( s, "    \"country\": \"", m->g.country, "\",\n" );
     }
-  fprintf ( f, "    \"latitude\": %.6lf,\n", m->g.lat );
-  fprintf ( f, "    \"longitude\": %.6lf,\n", m->g.lon );
-  fprintf ( f, "    \"altitude\": %.1lf\n", m->g.alt );
-  fprintf ( f, "    },\n" );
-  fprintf ( f, "  \"report\": \"%s\"\n", alphanum );
-  fprintf ( f, "  }" );
-  return 0;
+  bufr2tac_sink_put_fixed ( s, "    \"latitude\": ", m->g.lat, 6, ",\n" );
+  bufr2tac_sink_put_fixed ( s, "    \"longitude\": ", m->g.lon, 6, ",\n" );
+  bufr2tac_sink_put_fixed ( s, "    \"altitude\": ", m->g.alt, 1, "\n" );
+  bufr2tac_sink_puts ( s, "    },\n" );
+  bufr2tac_sink_puts ( s, "  \"report\": \"" );
+  bufr2tac_sink_write ( s, tac->s, tac->len );
+  bufr2tac_sink_puts ( s, "\"\n" );
+  bufr2tac_sink_puts ( s, "  }" );
+  return s->error;
 }
 /*!
-  \fn int print_json(FILE *f, const struct metreport *m)
+  \fn int bufr2tac_sink_print_json(struct bufr2tac_sink *s, const struct metreport *m)
   \brief prints a struct \ref metreport in json format
-  \param [in] f Pointer to a file already open by caller routine
+  \param [in,out] s Pointer to struct \ref bufr2tac_sink where to write
   \param [in] m Pointer to struct \ref metreport containing the data to print
   \return 0 on success
 */
-int print_json ( FILE *f, const struct metreport *m )
+int bufr2tac_sink_print_json ( struct bufr2tac_sink *s, const struct metreport *m )
 {
-  fprintf ( f, "{\"metreport\" :" );
-  if ( m->alphanum[0] )
+  bufr2tac_sink_puts ( s, "{\"metreport\" :" );
+  if ( m->tac[0].len )
     {
-      print_json_alphanum ( f, m->type, m->alphanum, m );
+      print_json_alphanum ( s, m->type, & ( m->tac[0] ), m );
     }
 
-  if ( m->alphanum2[0] ) //TTBB
+  if ( m->tac[1].len ) //TTBB
     {
-      fprintf ( f, "," );
-      print_json_alphanum ( f, m->type2, m->alphanum2, m );
+      bufr2tac_sink_puts ( s, "," );
+      print_json_alphanum ( s, m->type2, & ( m->tac[1] ), m );
     }
 
-  if ( m->alphanum3[0] ) //TTCC
+  if ( m->tac[2].len ) //TTCC
     {
-      fprintf ( f, "," );
-      print_json_alphanum ( f, m->type3, m->alphanum3, m );
+      bufr2tac_sink_puts ( s, "," );
+      print_json_alphanum ( s, m->type3, & ( m->tac[2] ), m );
     }
-  if ( m->alphanum4[0] ) //TTDD
+  if ( m->tac[3].len ) //TTDD
     {
-      fprintf ( f, "," );
-      print_json_alphanum ( f, m->type4, m->alphanum4, m );
+      bufr2tac_sink_puts ( s, "," );
+      print_json_alphanum ( s, m->type4, & ( m->tac[3] ), m );
     }
 
-  fprintf ( f, "\n}\n" );
-  return 0;
+  bufr2tac_sink_puts ( s, "\n}\n" );
+  return s->error;
+}
+
+/*!
+  \fn int print_json(FILE *f, const struct metreport *m)
+  \brief prints a struct \ref metreport in json format
+  \param [in] f Pointer to a file already open by caller routine
+  \param [in] m Pointer to struct \ref metreport containing the data to print
+  \return 0 on success
+*/
+int print_json ( FILE *f, const struct metreport *m )
+{
+  struct bufrdeco_output_buffer ob;
+  struct bufr2tac_sink s;
+
+  if ( bufrdeco_out_init ( &ob, f ) || bufr2tac_sink_set_output_buffer ( &s, &ob ) )
+    return 1;
+  bufr2tac_sink_print_json ( &s, m );
+  return bufr2tac_sink_flush ( &s ) || s.error;
 }
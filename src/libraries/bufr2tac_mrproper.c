@@ -21,6 +21,7 @@
  \file bufr2tac_mrproper.c
  \brief file with the code to clean and init structures
  */
+#include <stddef.h>
 #include "bufr2tac.h"
 
 /*! \fn void clean_syn_sec0(struct synop_sec0 *s)
@@ -280,6 +281,150 @@ void bufr2tac_clean_climat_chunks ( struct climat_chunks *c )
 */
 void bufr2tac_clean_metreport (struct metreport *m)
 {
-  if (m != NULL)
-    memset(m, 0, sizeof (struct metreport));
+  int i;
+
+  if ( m == NULL )
+    return;
+
+  m->source[0] = '\0';
+  m->subset = 0;
+  m->print_mask = 0;
+  m->h = NULL;
+  memset ( & ( m->t ), 0, sizeof ( struct met_datetime ) );
+  memset ( & ( m->g ), 0, sizeof ( struct met_geo ) );
+
+  if ( m->magic != METREPORT_MAGIC )
+    {
+      // Never initialized, so nothing is known about the chunks and the buffers of reports have no memory yet
+      m->magic = METREPORT_MAGIC;
+      m->dirty = METREPORT_DIRTY_ALL;
+      memset ( m->tac, 0, sizeof ( m->tac ) );
+    }
+
+  // Only the chunks written by the parse of previous subset are zeroed
+  if ( m->dirty & METREPORT_DIRTY_SYNOP )
+    memset ( & ( m->synop ), 0, sizeof ( struct synop_chunks ) );
+  if ( m->dirty & METREPORT_DIRTY_BUOY )
+    memset ( & ( m->buoy ), 0, sizeof ( struct buoy_chunks ) );
+  if ( m->dirty & METREPORT_DIRTY_TEMP )
+    memset ( & ( m->temp ), 0, sizeof ( struct temp_chunks ) );
+  if ( m->dirty & METREPORT_DIRTY_CLIMAT )
+    memset ( & ( m->climat ), 0, sizeof ( struct climat_chunks ) );
+  m->dirty = 0;
+
+  // The reports are always written as strings, so just the first char is reset
+  // and the buffers keep their memory to be reused
+  for ( i = 0; i < 4; i++ )
+    bufr2tac_buffer_clean ( & ( m->tac[i] ) );
+  m->type[0] = '\0';
+  m->alphanum[0] = '\0';
+  m->type2[0] = '\0';
+  m->alphanum2[0] = '\0';
+  m->type3[0] = '\0';
+  m->alphanum3[0] = '\0';
+  m->type4[0] = '\0';
+  m->alphanum4[0] = '\0';
+}
+
+/*!
+  \fn void bufr2tac_init_metreport(struct metreport *m)
+  \brief Init a \ref metreport struct before its first use
+  \param [in,out] m Pointer to the struct to init
+
+  As its content is unknown, all the chunks are cleared and the buffers of reports are set as empty ones.
+  Their memory is freed with \ref bufr2tac_free_metreport
+*/
+void bufr2tac_init_metreport ( struct metreport *m )
+{
+  if ( m == NULL )
+    return;
+
+  m->magic = 0;
+  bufr2tac_clean_metreport ( m );
+}
+
+/*!
+  \fn void bufr2tac_free_metreport(struct metreport *m)
+  \brief Free the memory allocated for the rendered reports in a \ref metreport struct
+  \param [in,out] m Pointer to the struct
+*/
+void bufr2tac_free_metreport ( struct metreport *m )
+{
+  int i;
+
+  if ( m == NULL )
+    return;
+
+  for ( i = 0; i < 4; i++ )
+    bufr2tac_buffer_free ( & ( m->tac[i] ) );
+  m->magic = 0;
+}
+
+// The members kept by bufr2tac_clean_subset_state() must be before member 'a', the first one zeroed
+_Static_assert ( offsetof ( struct bufr2tac_subset_state, magic ) < offsetof ( struct bufr2tac_subset_state, a ) &&
+                 offsetof ( struct bufr2tac_subset_state, type_report ) < offsetof ( struct bufr2tac_subset_state, a ) &&
+                 offsetof ( struct bufr2tac_subset_state, e ) < offsetof ( struct bufr2tac_subset_state, a ) &&
+                 offsetof ( struct bufr2tac_subset_state, raw ) < offsetof ( struct bufr2tac_subset_state, a ) &&
+                 offsetof ( struct bufr2tac_subset_state, wind_shear ) < offsetof ( struct bufr2tac_subset_state, a ),
+                 "members kept by bufr2tac_clean_subset_state() must be declared before member 'a'" );
+
+/*!
+  \fn void bufr2tac_init_subset_state(struct bufr2tac_subset_state *st)
+  \brief Init a \ref bufr2tac_subset_state struct before its first use
+  \param [in,out] st Pointer to the struct to init
+
+  The arrays of raw temp points allocated later are freed with \ref bufr2tac_free_subset_state
+*/
+void bufr2tac_init_subset_state ( struct bufr2tac_subset_state *st )
+{
+  if ( st == NULL )
+    return;
+
+  memset ( st, 0, sizeof ( struct bufr2tac_subset_state ) );
+  st->magic = BUFR2TAC_SUBSET_STATE_MAGIC;
+}
+
+/*!
+  \fn void bufr2tac_clean_subset_state(struct bufr2tac_subset_state *st)
+  \brief cleans a \ref bufr2tac_subset_state struct
+  \param [in,out] st Pointer to the struct to clean
+
+  The array of errors is not zeroed, as only the first \a e.ne items are used. The arrays of raw temp points are kept
+  to be reused, only their counters are reset. A struct never initialized is fully zeroed, so its pointers to arrays
+  are not taken as allocated ones.
+*/
+void bufr2tac_clean_subset_state ( struct bufr2tac_subset_state *st )
+{
+  if ( st == NULL )
+    return;
+
+  if ( st->magic != BUFR2TAC_SUBSET_STATE_MAGIC )
+    {
+      bufr2tac_init_subset_state ( st );
+      return;
+    }
+
+  memset ( st->type_report, 0, sizeof ( st->type_report ) );
+  st->e.ne = 0;
+  st->e.full = 0;
+  st->raw.n = 0;
+  st->wind_shear.n = 0;
+  // members after the error stack and temp scratch arrays
+  memset ( & ( st->a ), 0, sizeof ( struct bufr2tac_subset_state ) - offsetof ( struct bufr2tac_subset_state, a ) );
+}
+
+/*!
+  \fn void bufr2tac_free_subset_state(struct bufr2tac_subset_state *st)
+  \brief Free the memory allocated for arrays of raw temp points in a \ref bufr2tac_subset_state struct
+  \param [in,out] st Pointer to the struct
+*/
+void bufr2tac_free_subset_state ( struct bufr2tac_subset_state *st )
+{
+  if ( st == NULL )
+    return;
+
+  free ( ( void * ) st->raw.raw );
+  free ( ( void * ) st->wind_shear.raw );
+  memset ( & ( st->raw ), 0, sizeof ( struct temp_raw_data ) );
+  memset ( & ( st->wind_shear ), 0, sizeof ( struct temp_raw_wind_shear_data ) );
 }
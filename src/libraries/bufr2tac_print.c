@@ -23,6 +23,53 @@
  */
 #include "bufr2tac.h"
 
+/*!
+  \fn  int bufr2tac_sink_print_plain ( struct bufr2tac_sink *s, const struct metreport *m )
+  \brief Print in a sink the report decoded to Traditional Alphanumeric Code in plain text format. A line per report
+  \param [in,out] s Pointer to struct \ref bufr2tac_sink where to write to
+  \param [in] m Pointer to struct \ref metreport where the decoded report is stored
+  \return 0 if successful
+*/
+int bufr2tac_sink_print_plain ( struct bufr2tac_sink *s, const struct metreport *m )
+{
+  if ( m->tac[0].len )
+    {
+      bufr2tac_sink_write ( s, m->tac[0].s, m->tac[0].len );
+      bufr2tac_sink_puts ( s, "\n" );
+    }
+  if ( m->tac[1].len )
+    {
+      bufr2tac_sink_write ( s, m->tac[1].s, m->tac[1].len );
+      bufr2tac_sink_puts ( s, "\n" );
+    }
+  if ( m->tac[2].len )
+    {
+      bufr2tac_sink_write ( s, m->tac[2].s, m->tac[2].len );
+      bufr2tac_sink_puts ( s, "\n" );
+    }
+  if ( m->tac[3].len )
+    {
+      bufr2tac_sink_write ( s, m->tac[3].s, m->tac[3].len );
+      bufr2tac_sink_puts ( s, "\n" );
+    }
+  return s->error;
+}
+
+/*!
+  \fn  int bufr2tac_sink_print_html ( struct bufr2tac_sink *s, const struct metreport *m )
+  \brief Print in a sink the report decoded to Traditional Alphanumeric Code in plain html format. A line per report
+  \param [in,out] s Pointer to struct \ref bufr2tac_sink where to write to
+  \param [in] m Pointer to struct \ref metreport where the decoded report is stored
+  \return 0 if successful
+*/
+int bufr2tac_sink_print_html ( struct bufr2tac_sink *s, const struct metreport *m )
+{
+  bufr2tac_sink_puts ( s, "<pre>" );
+  bufr2tac_sink_print_plain ( s, m );
+  bufr2tac_sink_puts ( s, "</pre>" );
+  return s->error;
+}
+
 /*!
   \fn  int print_plain ( FILE *f, struct metreport *m )
   \brief Print in a file the report decoded to Traditional Alphanumeric Code in plain text format. A line per report
@@ -32,15 +79,13 @@
 */
 int print_plain ( FILE *f, const struct metreport *m )
 {
-  if ( m->alphanum[0] )
-    fprintf ( f, "%s\n", m->alphanum );
-  if ( m->alphanum2[0] )
-    fprintf ( f, "%s\n", m->alphanum2 );
-  if ( m->alphanum3[0] )
-    fprintf ( f, "%s\n", m->alphanum3 );
-  if ( m->alphanum4[0] )
-    fprintf ( f, "%s\n", m->alphanum4 );
-  return 0;
+  struct bufrdeco_output_buffer ob;
+  struct bufr2tac_sink s;
+
+  if ( bufrdeco_out_init ( &ob, f ) || bufr2tac_sink_set_output_buffer ( &s, &ob ) )
+    return 1;
+  bufr2tac_sink_print_plain ( &s, m );
+  return bufr2tac_sink_flush ( &s ) || s.error;
 }
 
 /*!
@@ -52,46 +97,39 @@ int print_plain ( FILE *f, const struct metreport *m )
 */
 int print_html ( FILE *f, const struct metreport *m )
 {
-  fprintf(f, "<pre>");
-  if ( m->alphanum[0] )
-    fprintf ( f, "%s\n", m->alphanum );
-  if ( m->alphanum2[0] )
-    fprintf ( f, "%s\n", m->alphanum2 );
-  if ( m->alphanum3[0] )
-    fprintf ( f, "%s\n", m->alphanum3 );
-  if ( m->alphanum4[0] )
-    fprintf ( f, "%s\n", m->alphanum4 );
-  fprintf(f, "</pre>");
-  return 0;
+  struct bufrdeco_output_buffer ob;
+  struct bufr2tac_sink s;
+
+  if ( bufrdeco_out_init ( &ob, f ) || bufr2tac_sink_set_output_buffer ( &s, &ob ) )
+    return 1;
+  bufr2tac_sink_print_html ( &s, m );
+  return bufr2tac_sink_flush ( &s ) || s.error;
 }
 
 /*!
- *  \fn size_t print_geo ( char **geo,  size_t lmax, const struct metrepor *m )
+ *  \fn size_t print_geo ( struct bufr2tac_buffer *out, const struct metrepor *m )
  *  \brief Prints geographic metadata (latitude, longitude, altitude) for a report
- *  \param [in,out] geo Pointer to the output buffer where geographic data will be written
- *  \param [in] lmax Maximum length permitted for the output buffer
+ *  \param [in,out] out Growable buffer where geographic data is appended
  *  \param [in] m Pointer to struct \ref metreport where are both target and source
- *  \return Number of characters written to the buffer
+ *  \return Number of characters appended to the buffer
  */
-size_t print_geo ( char **geo,  size_t lmax, const struct metreport *m )
+size_t print_geo ( struct bufr2tac_buffer *out, const struct metreport *m )
 {
   size_t used;
   char sep = '|';
   
-  used = snprintf(*geo, lmax, "%8.4lf %9.4lf %6.1lf%c", m->g.lat, m->g.lon, m->g.alt, sep);
-  *geo += used;
+  used = bufr2tac_buffer_printf ( out, "%8.4lf %9.4lf %6.1lf%c", m->g.lat, m->g.lon, m->g.alt, sep );
   return used;
 }
 
 /*!
- *  \fn size_t print_wigos_id ( char **wid,  size_t lmax, const struct metrepor *m )
+ *  \fn size_t print_wigos_id ( struct bufr2tac_buffer *out, const struct metrepor *m )
  *  \brief Prints a WIGOS identifier in a TAC output report
- *  \param [in,out] wid Pointer to the output buffer where WIGOS ID will be written
- *  \param [in] lmax Maximum length permitted for the output buffer
+ *  \param [in,out] out Growable buffer where WIGOS ID is appended
  *  \param [in] m Pointer to struct \ref metreport where are both target and source
- *  \return Number of characters written to the buffer
+ *  \return Number of characters appended to the buffer
  */
-  size_t print_wigos_id ( char **wid,  size_t lmax, const struct metreport *m )
+  size_t print_wigos_id ( struct bufr2tac_buffer *out, const struct metreport *m )
 {
   char aux[40];
   size_t used;
@@ -102,7 +140,27 @@ size_t print_geo ( char **geo,  size_t lmax, const struct metreport *m )
   else
     snprintf ( aux, sizeof(aux), "%d-%d-%d-%s", m->g.wid.series, m->g.wid.issuer, m->g.wid.issue, m->g.wid.local_id );
  
-  used = snprintf (*wid, lmax, "%-32s%c", aux, sep);
-  *wid += used;
+  used = bufr2tac_buffer_printf ( out, "%-32s%c", aux, sep );
   return used;
 }
+
+/*!
+ *  \fn void bufr2tac_set_alphanum ( char *target, size_t dim, const struct bufr2tac_buffer *b )
+ *  \brief Set a fixed size alphanum member of a \ref metreport as a copy of a rendered report
+ *  \param [out] target The alphanum member to set
+ *  \param [in] dim Size of \a target. Longer reports are truncated
+ *  \param [in] b Pointer to struct \ref bufr2tac_buffer with the rendered report
+ */
+void bufr2tac_set_alphanum ( char *target, size_t dim, const struct bufr2tac_buffer *b )
+{
+  size_t n;
+
+  if ( b->s == NULL )
+    {
+      target[0] = '\0';
+      return;
+    }
+  n = ( b->len < dim ) ? b->len : dim - 1;
+  memcpy ( target, b->s, n );
+  target[n] = '\0';
+}
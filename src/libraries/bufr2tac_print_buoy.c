@@ -24,165 +24,159 @@
 #include "bufr2tac.h"
 
 /*!
-  \fn size_t print_buoy_sec0 (char **sec0, size_t lmax, const struct buoy_chunks *b)
+  \fn size_t print_buoy_sec0 ( struct bufr2tac_buffer *out, const struct buoy_chunks *b)
   \brief Prints the buoy section 0 (identification and basic data)
-  \param [in,out] sec0 Pointer to the pointer where to print section
-  \param [in] lmax Maximum length permitted
+  \param [in,out] out Growable buffer where section 0 is appended
   \param [in] b Pointer to a struct \ref buoy_chunks where the parse results are set
   \return Number of characters written
 */
-size_t print_buoy_sec0 ( char **sec0, size_t lmax, const struct buoy_chunks *b )
+size_t print_buoy_sec0 ( struct bufr2tac_buffer *out, const struct buoy_chunks *b )
 {
   size_t used = 0;
-  char *c = *sec0;
 
-  used += snprintf ( c + used, lmax - used, "%s%s%s%s%s", b->e.YYYY, b->e.MM, b->e.DD, b->e.HH, b->e.mm );
+  used += bufr2tac_buffer_printf ( out, "%s%s%s%s%s", b->e.YYYY, b->e.MM, b->e.DD, b->e.HH, b->e.mm );
 
   // Print type
-  used += snprintf ( c + used, lmax - used, " %s%s", b->s0.MiMi, b->s0.MjMj );
+  used += bufr2tac_buffer_printf ( out, " %s%s", b->s0.MiMi, b->s0.MjMj );
 
   if ( b->s0.A1[0] && b->s0.bw[0] && b->s0.nbnbnb[0] )
     {
-      used += snprintf ( c + used, lmax - used, " %s%s%s", b->s0.A1, b->s0.bw, b->s0.nbnbnb );
+      used += bufr2tac_buffer_printf ( out, " %s%s%s", b->s0.A1, b->s0.bw, b->s0.nbnbnb );
     }
   else if ( b->s0.D_D[0] )
     {
-      used += snprintf ( c + used, lmax - used, " %s", b->s0.D_D );
+      used += bufr2tac_buffer_printf ( out, " %s", b->s0.D_D );
     }
 
 
-  used += snprintf ( c + used, lmax - used, " %s%s%s", b->s0.YY, b->s0.MM, b->s0.J );
+  used += bufr2tac_buffer_printf ( out, " %s%s%s", b->s0.YY, b->s0.MM, b->s0.J );
 
   if ( b->s0.iw[0] )
     {
-      used += snprintf ( c + used, lmax - used, " %s%s%s", b->s0.GG, b->s0.gg, b->s0.iw );
+      used += bufr2tac_buffer_printf ( out, " %s%s%s", b->s0.GG, b->s0.gg, b->s0.iw );
     }
   else
     {
-      used += snprintf ( c + used, lmax - used, " %s%s/", b->s0.GG, b->s0.gg );
+      used += bufr2tac_buffer_printf ( out, " %s%s/", b->s0.GG, b->s0.gg );
     }
 
-  used += snprintf ( c + used, lmax - used, " %s%s", b->s0.Qc, b->s0.LaLaLaLaLa );
+  used += bufr2tac_buffer_printf ( out, " %s%s", b->s0.Qc, b->s0.LaLaLaLaLa );
 
 
-  used += snprintf ( c + used, lmax - used, " %s", b->s0.LoLoLoLoLoLo );
+  used += bufr2tac_buffer_printf ( out, " %s", b->s0.LoLoLoLoLoLo );
 
   if ( b->s0.QA[0] || b->s0.Ql[0] || b->s0.Qt[0] )
     {
       if ( b->s0.Ql[0] )
         {
-          used += snprintf ( c + used, lmax - used,  " 6%s", b->s0.Ql );
+          used += bufr2tac_buffer_printf ( out, " 6%s", b->s0.Ql );
         }
       else
         {
-          used += snprintf ( c + used, lmax - used, " 6/" );
+          used += bufr2tac_buffer_printf ( out, " 6/" );
         }
 
       if ( b->s0.Qt[0] )
         {
-          used +=snprintf ( c + used, lmax - used, "%s", b->s0.Qt );
+          used += bufr2tac_buffer_printf ( out, "%s", b->s0.Qt );
         }
       else
         {
-          used += snprintf ( c + used, lmax - used,  "/" );
+          used += bufr2tac_buffer_printf ( out, "/" );
         }
 
       if ( b->s0.QA[0] )
         {
-          used += snprintf ( c + used, lmax - used,  "%s/", b->s0.QA );
+          used += bufr2tac_buffer_printf ( out, "%s/", b->s0.QA );
         }
       else
         {
-          used += snprintf ( c + used, lmax - used, "//" );
+          used += bufr2tac_buffer_printf ( out, "//" );
         }
     }
-
-  *sec0 = c + used;
   return used;
 }
 
 
 /*!
-  \fn size_t print_buoy_sec1 (char **sec1, size_t lmax, struct buoy_chunks *b)
+  \fn size_t print_buoy_sec1 ( struct bufr2tac_buffer *out, struct buoy_chunks *b)
   \brief Prints the buoy section 1 (meteorological data)
-  \param [in,out] sec1 Pointer to the pointer where to print section
-  \param [in] lmax Maximum length permitted
+  \param [in,out] out Growable buffer where section 1 is appended
   \param [in,out] b Pointer to a struct \ref buoy_chunks where the parse results are set
   \return Number of characters written
 */
-size_t print_buoy_sec1 ( char **sec1, size_t lmax, struct buoy_chunks *b )
+size_t print_buoy_sec1 ( struct bufr2tac_buffer *out, struct buoy_chunks *b )
 {
   size_t used = 0;
-  char *c = *sec1;
 
   if ( b->mask & BUOY_SEC1 )
     {
       // 111QdQx
-      used += snprintf ( c + used, lmax - used," 111" );
+      used += bufr2tac_buffer_printf ( out, " 111" );
 
       if ( b->s1.Qd[0] )
         {
-          used += snprintf ( c + used, lmax - used,"%s", b->s1.Qd );
+          used += bufr2tac_buffer_printf ( out, "%s", b->s1.Qd );
         }
       else
         {
-          used += snprintf ( c + used, lmax - used,"/" );
+          used += bufr2tac_buffer_printf ( out, "/" );
         }
 
       if ( b->s1.Qx[0] )
         {
-          used += snprintf ( c + used, lmax - used,"%s", b->s1.Qx );
+          used += bufr2tac_buffer_printf ( out, "%s", b->s1.Qx );
         }
       else
         {
-          used += snprintf ( c + used, lmax - used,"/" );
+          used += bufr2tac_buffer_printf ( out, "/" );
         }
 
       // 0ddff
       if ( b->s1.dd[0] || b->s1.ff[0] )
         {
-          used += snprintf ( c + used, lmax - used, " 0" );
+          used += bufr2tac_buffer_printf ( out, " 0" );
           if ( b->s1.dd[0] )
             {
-              used += snprintf ( c + used, lmax - used, "%s", b->s1.dd );
+              used += bufr2tac_buffer_printf ( out, "%s", b->s1.dd );
             }
           else
             {
-              used += snprintf ( c + used, lmax - used, "//" );
+              used += bufr2tac_buffer_printf ( out, "//" );
             }
 
           if ( b->s1.ff[0] )
             {
-              used += snprintf ( c + used, lmax - used, "%s", b->s1.ff );
+              used += bufr2tac_buffer_printf ( out, "%s", b->s1.ff );
             }
           else
             {
-              used += snprintf ( c + used, lmax - used, "//" );
+              used += bufr2tac_buffer_printf ( out, "//" );
             }
         }
 
       // 1snTTT
       if ( b->s1.TTT[0] )
         {
-          used += snprintf ( c + used, lmax - used, " 1%s%s", b->s1.sn1, b->s1.TTT );
+          used += bufr2tac_buffer_printf ( out, " 1%s%s", b->s1.sn1, b->s1.TTT );
         }
 
       // 2snTdTdTd
       if ( b->s1.TdTdTd[0] )
         {
-          used += snprintf ( c + used, lmax - used, " 2%s%s", b->s1.sn2, b->s1.TdTdTd );
+          used += bufr2tac_buffer_printf ( out, " 2%s%s", b->s1.sn2, b->s1.TdTdTd );
         }
 
       // 3PoPoPoPo
       if ( b->s1.PoPoPoPo[0] )
         {
-          used += snprintf ( c + used, lmax - used, " 3%s", b->s1.PoPoPoPo );
+          used += bufr2tac_buffer_printf ( out, " 3%s", b->s1.PoPoPoPo );
         }
 
       // printf 4PPPP
       if ( b->s1.PPPP[0] )
         {
-          used += snprintf ( c + used, lmax - used, " 4%s", b->s1.PPPP );
+          used += bufr2tac_buffer_printf ( out, " 4%s", b->s1.PPPP );
         }
 
       // printf 5appp
@@ -196,115 +190,107 @@ size_t print_buoy_sec1 ( char **sec1, size_t lmax, struct buoy_chunks *b )
             {
               strcpy ( b->s1.ppp, "///" );
             }
-          used += snprintf ( c + used, lmax - used, " 5%s%s", b->s1.a, b->s1.ppp );
+          used += bufr2tac_buffer_printf ( out, " 5%s%s", b->s1.a, b->s1.ppp );
         }
     }
-
-  *sec1 = c + used;
   return used;
 }
 
 /*!
-  \fn size_t print_buoy_sec2 (char **sec2, size_t lmax, const struct buoy_chunks *b)
+  \fn size_t print_buoy_sec2 ( struct bufr2tac_buffer *out, const struct buoy_chunks *b)
   \brief Prints the buoy section 2 (sea data)
-  \param [in,out] sec2 Pointer to the pointer where to print section
-  \param [in] lmax Maximum length permitted
+  \param [in,out] out Growable buffer where section 2 is appended
   \param [in] b Pointer to a struct \ref buoy_chunks where the parse results are set
   \return Number of characters written
 */
-size_t print_buoy_sec2 ( char **sec2, size_t lmax, const struct buoy_chunks *b )
+size_t print_buoy_sec2 ( struct bufr2tac_buffer *out, const struct buoy_chunks *b )
 {
   size_t used = 0;
-  char *c = *sec2;
 
   if ( b->mask & BUOY_SEC2 )
     {
       // 222QdQx
-      used += snprintf ( c + used, lmax - used," 222" );
+      used += bufr2tac_buffer_printf ( out, " 222" );
 
       if ( b->s2.Qd[0] )
         {
-          used += snprintf ( c + used, lmax - used,"%s", b->s2.Qd );
+          used += bufr2tac_buffer_printf ( out, "%s", b->s2.Qd );
         }
       else
         {
-          used += snprintf ( c + used, lmax - used,"/" );
+          used += bufr2tac_buffer_printf ( out, "/" );
         }
 
       if ( b->s2.Qx[0] )
         {
-          used += snprintf ( c + used, lmax - used,"%s", b->s2.Qx );
+          used += bufr2tac_buffer_printf ( out, "%s", b->s2.Qx );
         }
       else
         {
-          used += snprintf ( c + used, lmax - used,"/" );
+          used += bufr2tac_buffer_printf ( out, "/" );
         }
 
       // 0snTwTwTw
       if ( b->s2.TwTwTw[0] )
         {
-          used += snprintf ( c + used, lmax - used, " 0%s%s", b->s2.sn, b->s2.TwTwTw );
+          used += bufr2tac_buffer_printf ( out, " 0%s%s", b->s2.sn, b->s2.TwTwTw );
         }
 
       // 1PwaPwaHwaHwa
       if ( b->s2.PwaPwa[0] || b->s2.HwaHwa[0] )
         {
-          used += snprintf ( c + used, lmax - used, " 1" );
+          used += bufr2tac_buffer_printf ( out, " 1" );
           if ( b->s2.PwaPwa[0] )
             {
-              used += snprintf ( c + used, lmax - used,"%s", b->s2.PwaPwa );
+              used += bufr2tac_buffer_printf ( out, "%s", b->s2.PwaPwa );
             }
           else
             {
-              used += snprintf ( c + used, lmax - used,"//" );
+              used += bufr2tac_buffer_printf ( out, "//" );
             }
 
           if ( b->s2.HwaHwa[0] )
             {
-              used += snprintf ( c + used, lmax - used,"%s", b->s2.HwaHwa );
+              used += bufr2tac_buffer_printf ( out, "%s", b->s2.HwaHwa );
             }
           else
             {
-              used += snprintf ( c + used, lmax - used,"//" );
+              used += bufr2tac_buffer_printf ( out, "//" );
             }
         }
 
       // 20PwaPwaPwa
       if ( b->s2.PwaPwaPwa[0] )
         {
-          used += snprintf ( c + used, lmax - used, " 20%s", b->s2.PwaPwaPwa );
+          used += bufr2tac_buffer_printf ( out, " 20%s", b->s2.PwaPwaPwa );
         }
 
       // 21HwaHwaHwa
       if ( b->s2.HwaHwaHwa[0] )
         {
-          used += snprintf ( c + used, lmax - used, " 21%s", b->s2.HwaHwaHwa );
+          used += bufr2tac_buffer_printf ( out, " 21%s", b->s2.HwaHwaHwa );
         }
 
 
     }
-
-  *sec2 = c + used;
   return used;
 }
 
 /*!
-  \fn size_t print_buoy_sec3 (char **sec3, size_t lmax, const struct buoy_chunks *b)
+  \fn size_t print_buoy_sec3 ( struct bufr2tac_buffer *out, const struct buoy_chunks *b)
   \brief Prints the buoy section 3 (oceanographic data - temperature and salinity profiles)
-  \param [in,out] sec3 Pointer to the pointer where to print section
-  \param [in] lmax Maximum length permitted
+  \param [in,out] out Growable buffer where section 3 is appended
   \param [in] b Pointer to a struct \ref buoy_chunks where the parse results are set
   \return Number of characters written
 */
-size_t print_buoy_sec3 ( char **sec3, size_t lmax, const struct buoy_chunks *b )
+size_t print_buoy_sec3 ( struct bufr2tac_buffer *out, const struct buoy_chunks *b )
 {
   size_t used = 0;
-  char *c = *sec3;
   size_t l;
 
   if ( b->mask & BUOY_SEC3 )
     {
-      used += snprintf ( c + used, lmax - used, " 333%s%s", b->s3.Qd1, b->s3.Qd2 );
+      used += bufr2tac_buffer_printf ( out, " 333%s%s", b->s3.Qd1, b->s3.Qd2 );
 
       // check if has 8887k2
       l = 0;
@@ -312,18 +298,18 @@ size_t print_buoy_sec3 ( char **sec3, size_t lmax, const struct buoy_chunks *b )
         {
           if ( l == 0 )
             {
-              used += snprintf ( c + used, lmax - used, " 8887%s", b->s3.k2 );
+              used += bufr2tac_buffer_printf ( out, " 8887%s", b->s3.k2 );
             }
-          used += snprintf ( c + used, lmax - used,  " 2%s", b->s3.l1[l].zzzz );
+          used += bufr2tac_buffer_printf ( out, " 2%s", b->s3.l1[l].zzzz );
 
           if ( b->s3.l1[l].TTTT[0] )
             {
-              used += snprintf ( c + used, lmax - used,  " 3%s", b->s3.l1[l].TTTT );
+              used += bufr2tac_buffer_printf ( out, " 3%s", b->s3.l1[l].TTTT );
             }
 
           if ( b->s3.l1[l].SSSS[0] )
             {
-              used += snprintf ( c + used, lmax - used,  " 4%s", b->s3.l1[l].SSSS );
+              used += bufr2tac_buffer_printf ( out, " 4%s", b->s3.l1[l].SSSS );
             }
           l++;
         }
@@ -333,46 +319,43 @@ size_t print_buoy_sec3 ( char **sec3, size_t lmax, const struct buoy_chunks *b )
         {
           if ( l == 0 )
             {
-              used += snprintf ( c + used, lmax - used, " 66%s9%s", b->s3.k6, b->s3.k3 );
+              used += bufr2tac_buffer_printf ( out, " 66%s9%s", b->s3.k6, b->s3.k3 );
             }
-          used += snprintf ( c + used, lmax - used,  " 2%s", b->s3.l2[l].zzzz );
+          used += bufr2tac_buffer_printf ( out, " 2%s", b->s3.l2[l].zzzz );
 
           if ( b->s3.l2[l].dd[0] || b->s3.l2[l].ccc[0] )
             {
               if ( b->s3.l2[l].dd[0] )
                 {
-                  used += snprintf ( c + used, lmax - used,  " %s", b->s3.l2[l].dd );
+                  used += bufr2tac_buffer_printf ( out, " %s", b->s3.l2[l].dd );
                 }
               else
                 {
-                  used += snprintf ( c + used, lmax - used,  " //" );
+                  used += bufr2tac_buffer_printf ( out, " //" );
                 }
               if ( b->s3.l2[l].ccc[0] )
                 {
-                  used += snprintf ( c + used, lmax - used,  "%s", b->s3.l2[l].ccc );
+                  used += bufr2tac_buffer_printf ( out, "%s", b->s3.l2[l].ccc );
                 }
               else
                 {
-                  used += snprintf ( c + used, lmax - used,  "///" );
+                  used += bufr2tac_buffer_printf ( out, "///" );
                 }
             }
           l++;
         }
     }
-
-  *sec3 = c + used;
   return used;
 }
 
 /*!
- *  \fn size_t print_buoy_wigos_id ( char **wid,  size_t lmax, const struct buoy_chunks *b )
+ *  \fn size_t print_buoy_wigos_id ( struct bufr2tac_buffer *out, const struct buoy_chunks *b )
  *  \brief Prints a WIGOS identifier in a buoy report
- *  \param [in,out] wid Pointer to the pointer where to print WIGOS ID
- *  \param [in] lmax Maximum length permitted
+ *  \param [in,out] out Growable buffer where WIGOS ID is appended
  *  \param [in] b Pointer to a struct \ref buoy_chunks with WIGOS identifier data
  *  \return Number of characters written
  */
-size_t print_buoy_wigos_id ( char **wid,  size_t lmax, const struct buoy_chunks *b )
+size_t print_buoy_wigos_id ( struct bufr2tac_buffer *out, const struct buoy_chunks *b )
 {
   char aux[40];
   size_t used = 0;
@@ -383,15 +366,14 @@ size_t print_buoy_wigos_id ( char **wid,  size_t lmax, const struct buoy_chunks
   else
     snprintf ( aux, sizeof(aux), "%d-%d-%d-%s", b->wid.series, b->wid.issuer, b->wid.issue, b->wid.local_id );
 
-  used = snprintf ( *wid, lmax, "%-32s%c", aux, sep );
-  *wid += used;
+  used = bufr2tac_buffer_printf ( out, "%-32s%c", aux, sep );
   return used;
 }
 
 
 /*!
  \fn int print_buoy_report(struct metreport *m )
- \brief Prints a complete buoy report into the alphanum string
+ \brief Prints a complete buoy report into the growable buffer tac[0], with alphanum as a copy
  \param [in,out] m Pointer to struct \ref metreport where are both target and source
  \return 0 if OK, 1 otherwise
 */
@@ -401,11 +383,11 @@ int print_buoy_report ( struct metreport *m )
     {
       return 1; // No buoy report to print
     }
-  char *c = & ( m->alphanum[0] );
-  size_t used = 0;
-  size_t lmax = sizeof ( m->alphanum );
+  struct bufr2tac_buffer *out = &m->tac[0];
   struct buoy_chunks *b = &m->buoy;
 
+  bufr2tac_buffer_clean ( out );
+
   // Needs time extension
   if ( b->e.YYYY[0] == 0  || b->e.YYYY[0] == '0' )
     {
@@ -414,29 +396,30 @@ int print_buoy_report ( struct metreport *m )
 
   if ( m->print_mask & PRINT_BITMASK_WIGOS )
     {
-      used += print_wigos_id ( &c, lmax, m );
+      print_wigos_id ( out, m );
     }
 
   if ( m->print_mask & PRINT_BITMASK_GEO )
     {
-      used += print_geo ( &c, lmax, m );
+      print_geo ( out, m );
     }
 
-  print_buoy_sec0 ( &c, lmax, b );
+  print_buoy_sec0 ( out, b );
 
   if ( b->mask & ( BUOY_SEC1 | BUOY_SEC2 | BUOY_SEC3 ) )
     {
-      used += print_buoy_sec1 ( &c, lmax - used, b );
+      print_buoy_sec1 ( out, b );
 
-      used += print_buoy_sec2 ( &c, lmax - used, b );
+      print_buoy_sec2 ( out, b );
 
-      used += print_buoy_sec3 ( &c, lmax - used, b );
+      print_buoy_sec3 ( out, b );
     }
   else
     {
-      c += snprintf ( c, lmax - used, " NIL" );
+      bufr2tac_buffer_printf ( out, " NIL" );
     }
-  snprintf ( c, lmax - used - 1, "=" );
+  bufr2tac_buffer_printf ( out, "=" );
+  bufr2tac_set_alphanum ( m->alphanum, sizeof ( m->alphanum ), out );
 
   return 0;
 }
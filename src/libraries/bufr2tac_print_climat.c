@@ -24,62 +24,56 @@
 #include "bufr2tac.h"
 
 /*!
-  \fn size_t print_climat_sec0 (char **sec0, size_t lmax, const struct climat_chunks *cl)
+  \fn size_t print_climat_sec0 ( struct bufr2tac_buffer *out, const struct climat_chunks *cl)
   \brief Prints the climat section 0 (header)
-  \param [in,out] sec0 Pointer to the output buffer where section 0 will be written
-  \param [in] lmax Maximum length permitted for the output buffer
+  \param [in,out] out Growable buffer where section 0 is appended
   \param [in] cl Pointer to struct \ref climat_chunks where the parse results are set
-  \return Number of characters written to the buffer
+  \return Number of characters appended to the buffer
 */
-size_t print_climat_sec0 ( char **sec0, size_t lmax, const struct climat_chunks *cl )
+size_t print_climat_sec0 ( struct bufr2tac_buffer *out, const struct climat_chunks *cl )
 {
-  char *c = *sec0;
   size_t used = 0;
 
-  used += snprintf ( c + used, lmax - used, "%s%s%s%s%s", cl->e.YYYY, cl->e.MM, cl->e.DD, cl->e.HH, cl->e.mm );
+  used += bufr2tac_buffer_printf ( out, "%s%s%s%s%s", cl->e.YYYY, cl->e.MM, cl->e.DD, cl->e.HH, cl->e.mm );
 
   // Print type
-  used += snprintf ( c + used, lmax - used, " CLIMAT" );
+  used += bufr2tac_buffer_printf ( out, " CLIMAT" );
 
   // print MMJJJ
-  used += snprintf ( c + used, lmax - used, " %s%s", cl->s0.MM, cl->s0.JJJ );
+  used += bufr2tac_buffer_printf ( out, " %s%s", cl->s0.MM, cl->s0.JJJ );
 
 
   // print IIiii
   if ( cl->s0.II[0] )
     {
-      used += snprintf ( c + used, lmax - used, " %s%s", cl->s0.II, cl->s0.iii );
+      used += bufr2tac_buffer_printf ( out, " %s%s", cl->s0.II, cl->s0.iii );
     }
-
-  *sec0 = c + used;
   return used;
 }
 
 /*!
-  \fn size_t print_climat_sec1 (char **sec1, size_t lmax, struct climat_chunks *cl)
+  \fn size_t print_climat_sec1 ( struct bufr2tac_buffer *out, struct climat_chunks *cl)
   \brief Prints the climat section 1
-  \param [in,out] sec1 Pointer to the output buffer where section 1 will be written
-  \param [in] lmax Maximum length permitted for the output buffer
+  \param [in,out] out Growable buffer where section 1 is appended
   \param [in,out] cl Pointer to struct \ref climat_chunks where the parse results are set
-  \return Number of characters written to the buffer
+  \return Number of characters appended to the buffer
 */
-size_t print_climat_sec1 ( char **sec1, size_t lmax, struct climat_chunks *cl )
+size_t print_climat_sec1 ( struct bufr2tac_buffer *out, struct climat_chunks *cl )
 {
-  char *c = *sec1;
   size_t used = 0;
 
   if ( cl->mask & SYNOP_SEC1 )
     {
-      used += snprintf ( c + used, lmax - used, " 111" );
+      used += bufr2tac_buffer_printf ( out, " 111" );
 
       if ( cl->s1.PoPoPoPo[0] )
         {
-          used += snprintf ( c + used, lmax - used, " 1%s", cl->s1.PoPoPoPo );
+          used += bufr2tac_buffer_printf ( out, " 1%s", cl->s1.PoPoPoPo );
         }
 
       if ( cl->s1.PPPP[0] )
         {
-          used += snprintf ( c + used, lmax - used, " 2%s", cl->s1.PPPP );
+          used += bufr2tac_buffer_printf ( out, " 2%s", cl->s1.PPPP );
         }
 
       if ( cl->s1.TTT[0] || cl->s1.ststst[0] )
@@ -93,7 +87,7 @@ size_t print_climat_sec1 ( char **sec1, size_t lmax, struct climat_chunks *cl )
             {
               strcpy ( cl->s1.ststst, "///" );
             }
-          used += snprintf ( c + used, lmax - used, " 3%s%s%s", cl->s1.s, cl->s1.TTT, cl->s1.ststst );
+          used += bufr2tac_buffer_printf ( out, " 3%s%s%s", cl->s1.s, cl->s1.TTT, cl->s1.ststst );
         }
 
       if ( cl->s1.TxTxTx[0] || cl->s1.TnTnTn[0] )
@@ -108,12 +102,12 @@ size_t print_climat_sec1 ( char **sec1, size_t lmax, struct climat_chunks *cl )
               strcpy ( cl->s1.sn, "/" );
               strcpy ( cl->s1.TnTnTn, "///" );
             }
-          used += snprintf ( c + used, lmax - used, " 4%s%s%s%s", cl->s1.sx, cl->s1.TxTxTx, cl->s1.sn, cl->s1.TnTnTn );
+          used += bufr2tac_buffer_printf ( out, " 4%s%s%s%s", cl->s1.sx, cl->s1.TxTxTx, cl->s1.sn, cl->s1.TnTnTn );
         }
 
       if ( cl->s1.eee[0] )
         {
-          used += snprintf ( c + used, lmax - used, " 5%s", cl->s1.eee );
+          used += bufr2tac_buffer_printf ( out, " 5%s", cl->s1.eee );
         }
 
       if ( cl->s1.R1R1R1R1[0] ||  cl->s1.Rd[0] ||  cl->s1.nrnr[0] )
@@ -130,7 +124,7 @@ size_t print_climat_sec1 ( char **sec1, size_t lmax, struct climat_chunks *cl )
             {
               strcpy ( cl->s1.nrnr, "//" );
             }
-          used += snprintf ( c + used, lmax - used, " 6%s%s%s", cl->s1.R1R1R1R1, cl->s1.Rd, cl->s1.nrnr );
+          used += bufr2tac_buffer_printf ( out, " 6%s%s%s", cl->s1.R1R1R1R1, cl->s1.Rd, cl->s1.nrnr );
         }
 
       if ( cl->s1.S1S1S1[0] ||  cl->s1.pspsps[0] )
@@ -143,7 +137,7 @@ size_t print_climat_sec1 ( char **sec1, size_t lmax, struct climat_chunks *cl )
             {
               strcpy ( cl->s1.pspsps, "///" );
             }
-          used += snprintf ( c + used, lmax - used, " 7%s%s", cl->s1.S1S1S1, cl->s1.pspsps );
+          used += bufr2tac_buffer_printf ( out, " 7%s%s", cl->s1.S1S1S1, cl->s1.pspsps );
         }
 
       if ( cl->s1.mpmp[0] || cl->s1.mtmt[0] ||  cl->s1.mtx[0] ||  cl->s1.mtn[0] )
@@ -164,7 +158,7 @@ size_t print_climat_sec1 ( char **sec1, size_t lmax, struct climat_chunks *cl )
             {
               strcpy ( cl->s1.mtn, "/" );
             }
-          used += snprintf ( c + used, lmax - used, " 8%s%s%s%s", cl->s1.mpmp, cl->s1.mtmt, cl->s1.mtx, cl->s1.mtn );
+          used += bufr2tac_buffer_printf ( out, " 8%s%s%s%s", cl->s1.mpmp, cl->s1.mtmt, cl->s1.mtx, cl->s1.mtn );
         }
 
 
@@ -182,31 +176,27 @@ size_t print_climat_sec1 ( char **sec1, size_t lmax, struct climat_chunks *cl )
             {
               strcpy ( cl->s1.msms, "//" );
             }
-          used += snprintf ( c + used, lmax - used, " 9%s%s%s", cl->s1.meme, cl->s1.mrmr, cl->s1.msms );
+          used += bufr2tac_buffer_printf ( out, " 9%s%s%s", cl->s1.meme, cl->s1.mrmr, cl->s1.msms );
         }
     }
-
-  *sec1 = c + used;
   return used;
 }
 
 /*!
-  \fn size_t print_climat_sec2 (char **sec2, size_t lmax, struct climat_chunks *cl)
+  \fn size_t print_climat_sec2 ( struct bufr2tac_buffer *out, struct climat_chunks *cl)
   \brief Prints the climat section 2
-  \param [in,out] sec2 Pointer to the output buffer where section 2 will be written
-  \param [in] lmax Maximum length permitted for the output buffer
+  \param [in,out] out Growable buffer where section 2 is appended
   \param [in,out] cl Pointer to struct \ref climat_chunks where the parse results are set
-  \return Number of characters written to the buffer
+  \return Number of characters appended to the buffer
 */
-size_t print_climat_sec2 ( char **sec2, size_t lmax, struct climat_chunks *cl )
+size_t print_climat_sec2 ( struct bufr2tac_buffer *out, struct climat_chunks *cl )
 {
-  char *c = *sec2;
   size_t used = 0, used0 = 0;
 
   if ( cl->mask & SYNOP_SEC2 )
     {
-      //used += snprintf ( c + used, lmax - used, "\r\n      222" );
-      used += snprintf ( c + used, lmax - used, " 222" );
+      //used += bufr2tac_buffer_printf ( out, "\r\n      222" );
+      used += bufr2tac_buffer_printf ( out, " 222" );
 
       // init point to write info.
       // in case we finally write nothing in this section
@@ -222,17 +212,17 @@ size_t print_climat_sec2 ( char **sec2, size_t lmax, struct climat_chunks *cl )
             {
               strcpy ( cl->s2.YcYc, "//" );
             }
-          used += snprintf ( c + used, lmax - used, " 0%s%s", cl->s2.YbYb, cl->s2.YcYc );
+          used += bufr2tac_buffer_printf ( out, " 0%s%s", cl->s2.YbYb, cl->s2.YcYc );
         }
 
       if ( cl->s2.PoPoPoPo[0] )
         {
-          used += snprintf ( c + used, lmax - used, " 1%s", cl->s2.PoPoPoPo );
+          used += bufr2tac_buffer_printf ( out, " 1%s", cl->s2.PoPoPoPo );
         }
 
       if ( cl->s2.PPPP[0] )
         {
-          used += snprintf ( c + used, lmax - used, " 2%s", cl->s2.PPPP );
+          used += bufr2tac_buffer_printf ( out, " 2%s", cl->s2.PPPP );
         }
 
       if (  cl->s2.s[0] || cl->s2.TTT[0] || cl->s2.ststst[0] )
@@ -250,7 +240,7 @@ size_t print_climat_sec2 ( char **sec2, size_t lmax, struct climat_chunks *cl )
               strcpy ( cl->s2.ststst, "///" );
             }
 
-          used += snprintf ( c + used, lmax - used, " 3%s%s%s", cl->s2.s, cl->s2.TTT, cl->s2.ststst );
+          used += bufr2tac_buffer_printf ( out, " 3%s%s%s", cl->s2.s, cl->s2.TTT, cl->s2.ststst );
         }
 
       if (  cl->s2.sx[0] || cl->s2.TxTxTx[0] || cl->s2.sn[0] || cl->s2.TnTnTn[0] )
@@ -272,12 +262,12 @@ size_t print_climat_sec2 ( char **sec2, size_t lmax, struct climat_chunks *cl )
               strcpy ( cl->s2.TnTnTn, "///" );
             }
 
-          used += snprintf ( c + used, lmax - used, " 4%s%s%s%s", cl->s2.sx, cl->s2.TxTxTx, cl->s2.sn, cl->s2.TnTnTn );
+          used += bufr2tac_buffer_printf ( out, " 4%s%s%s%s", cl->s2.sx, cl->s2.TxTxTx, cl->s2.sn, cl->s2.TnTnTn );
         }
 
       if (  cl->s2.eee[0] )
         {
-          used += snprintf ( c + used, lmax - used, " 5%s", cl->s2.eee );
+          used += bufr2tac_buffer_printf ( out, " 5%s", cl->s2.eee );
         }
 
       if ( cl->s2.R1R1R1R1[0] || cl->s2.nrnr[0]  )
@@ -290,12 +280,12 @@ size_t print_climat_sec2 ( char **sec2, size_t lmax, struct climat_chunks *cl )
             {
               strcpy ( cl->s2.nrnr, "//" );
             }
-          used += snprintf ( c + used, lmax - used, " 6%s%s", cl->s2.R1R1R1R1, cl->s2.nrnr );
+          used += bufr2tac_buffer_printf ( out, " 6%s%s", cl->s2.R1R1R1R1, cl->s2.nrnr );
         }
 
       if ( cl->s2.S1S1S1[0] )
         {
-          used += snprintf ( c + used, lmax - used, " 7%s", cl->s2.S1S1S1 );
+          used += bufr2tac_buffer_printf ( out, " 7%s", cl->s2.S1S1S1 );
         }
 
       if ( cl->s2.ypyp[0] || cl->s2.ytyt[0] || cl->s2.ytxytx[0] )
@@ -313,7 +303,7 @@ size_t print_climat_sec2 ( char **sec2, size_t lmax, struct climat_chunks *cl )
               strcpy ( cl->s2.ytxytx, "//" );
             }
 
-          used += snprintf ( c + used, lmax - used, " 8%s%s%s", cl->s2.ypyp, cl->s2.ytyt, cl->s2.ytxytx );
+          used += bufr2tac_buffer_printf ( out, " 8%s%s%s", cl->s2.ypyp, cl->s2.ytyt, cl->s2.ytxytx );
         }
 
       if (  cl->s2.yeye[0] || cl->s2.yryr[0] || cl->s2.ysys[0] )
@@ -331,39 +321,37 @@ size_t print_climat_sec2 ( char **sec2, size_t lmax, struct climat_chunks *cl )
               strcpy ( cl->s2.ysys, "//" );
             }
 
-          used += snprintf ( c + used, lmax - used, " 9%s%s%s", cl->s2.yeye, cl->s2.yryr, cl->s2.ysys );
+          used += bufr2tac_buffer_printf ( out, " 9%s%s%s", cl->s2.yeye, cl->s2.yryr, cl->s2.ysys );
         }
 
     }
 
-  if ( used != used0 )
+  // Nothing but the header of section, which is dropped
+  if ( used == used0 )
     {
-      *sec2 = c + used;
+      bufr2tac_buffer_truncate ( out, out->len - used );
+      used = 0;
     }
-  else
-    used = 0;
 
   return used;
 }
 
 
 /*!
-  \fn size_t print_climat_sec3 (char **sec3, size_t lmax, struct climat_chunks *cl)
+  \fn size_t print_climat_sec3 ( struct bufr2tac_buffer *out, struct climat_chunks *cl)
   \brief Prints the climat section 3
-  \param [in,out] sec3 Pointer to the output buffer where section 3 will be written
-  \param [in] lmax Maximum length permitted for the output buffer
+  \param [in,out] out Growable buffer where section 3 is appended
   \param [in,out] cl Pointer to struct \ref climat_chunks where the parse results are set
-  \return Number of characters written to the buffer
+  \return Number of characters appended to the buffer
 */
-size_t print_climat_sec3 ( char **sec3, size_t lmax, struct climat_chunks *cl )
+size_t print_climat_sec3 ( struct bufr2tac_buffer *out, struct climat_chunks *cl )
 {
-  char *c = *sec3;
   size_t used0 = 0, used = 0;
 
   if ( cl->mask & SYNOP_SEC3 )
     {
-      //used += snprintf ( c + used, lmax - used, "\r\n      333" );
-      used += snprintf ( c + used, lmax - used, " 333" );
+      //used += bufr2tac_buffer_printf ( out, "\r\n      333" );
+      used += bufr2tac_buffer_printf ( out, " 333" );
 
       // init point to write info.
       // in case we finally write nothing in this section
@@ -381,7 +369,7 @@ size_t print_climat_sec3 ( char **sec3, size_t lmax, struct climat_chunks *cl )
             {
               strcpy ( cl->s3.T30,"//" );
             }
-          used += snprintf ( c + used, lmax - used, " 0%s%s", cl->s3.T25, cl->s3.T30 );
+          used += bufr2tac_buffer_printf ( out, " 0%s%s", cl->s3.T25, cl->s3.T30 );
         }
 
       if ( 
@@ -397,7 +385,7 @@ size_t print_climat_sec3 ( char **sec3, size_t lmax, struct climat_chunks *cl )
             {
               strcpy ( cl->s3.T40,"//" );
             }
-          used += snprintf ( c + used, lmax - used, " 1%s%s", cl->s3.T35, cl->s3.T40 );
+          used += bufr2tac_buffer_printf ( out, " 1%s%s", cl->s3.T35, cl->s3.T40 );
         }
 
       if ( 
@@ -413,7 +401,7 @@ size_t print_climat_sec3 ( char **sec3, size_t lmax, struct climat_chunks *cl )
             {
               strcpy ( cl->s3.Tx0,"//" );
             }
-          used += snprintf ( c + used, lmax - used, " 2%s%s", cl->s3.Tn0, cl->s3.Tx0 );
+          used += bufr2tac_buffer_printf ( out, " 2%s%s", cl->s3.Tn0, cl->s3.Tx0 );
         }
 
       if (   ( cl->s3.R01[0] && strcmp ( cl->s3.R01, "00" ) ) ||
@@ -429,7 +417,7 @@ size_t print_climat_sec3 ( char **sec3, size_t lmax, struct climat_chunks *cl )
             {
               strcpy ( cl->s3.R05,"//" );
             }
-          used += snprintf ( c + used, lmax - used, " 3%s%s", cl->s3.R01, cl->s3.R05 );
+          used += bufr2tac_buffer_printf ( out, " 3%s%s", cl->s3.R01, cl->s3.R05 );
         }
 
       if (   ( cl->s3.R10[0] && strcmp ( cl->s3.R10, "00" ) ) ||
@@ -445,7 +433,7 @@ size_t print_climat_sec3 ( char **sec3, size_t lmax, struct climat_chunks *cl )
             {
               strcpy ( cl->s3.R50,"//" );
             }
-          used += snprintf ( c + used, lmax - used, " 4%s%s", cl->s3.R10, cl->s3.R50 );
+          used += bufr2tac_buffer_printf ( out, " 4%s%s", cl->s3.R10, cl->s3.R50 );
         }
 
       if (   ( cl->s3.R100[0] && strcmp ( cl->s3.R100, "00" ) ) ||
@@ -461,7 +449,7 @@ size_t print_climat_sec3 ( char **sec3, size_t lmax, struct climat_chunks *cl )
             {
               strcpy ( cl->s3.R150,"//" );
             }
-          used += snprintf ( c + used, lmax - used, " 5%s%s", cl->s3.R100, cl->s3.R150 );
+          used += bufr2tac_buffer_printf ( out, " 5%s%s", cl->s3.R100, cl->s3.R150 );
         }
 
       if (   ( cl->s3.s00[0] && strcmp ( cl->s3.s00, "00" ) ) ||
@@ -476,7 +464,7 @@ size_t print_climat_sec3 ( char **sec3, size_t lmax, struct climat_chunks *cl )
             {
               strcpy ( cl->s3.s01,"//" );
             }
-          used += snprintf ( c + used, lmax - used, " 6%s%s", cl->s3.s00, cl->s3.s01 );
+          used += bufr2tac_buffer_printf ( out, " 6%s%s", cl->s3.s00, cl->s3.s01 );
         }
 
       if (   ( cl->s3.s10[0] && strcmp ( cl->s3.s10, "00" ) ) ||
@@ -492,7 +480,7 @@ size_t print_climat_sec3 ( char **sec3, size_t lmax, struct climat_chunks *cl )
             {
               strcpy ( cl->s3.s50,"//" );
             }
-          used += snprintf ( c + used, lmax - used, " 7%s%s", cl->s3.s10, cl->s3.s50 );
+          used += bufr2tac_buffer_printf ( out, " 7%s%s", cl->s3.s10, cl->s3.s50 );
         }
 
       if ( 
@@ -513,7 +501,7 @@ size_t print_climat_sec3 ( char **sec3, size_t lmax, struct climat_chunks *cl )
             {
               strcpy ( cl->s3.f30,"//" );
             }
-          used += snprintf ( c + used, lmax - used, " 8%s%s%s", cl->s3.f10, cl->s3.f20, cl->s3.f30 );
+          used += bufr2tac_buffer_printf ( out, " 8%s%s%s", cl->s3.f10, cl->s3.f20, cl->s3.f30 );
         }
 
       if ( 
@@ -534,38 +522,37 @@ size_t print_climat_sec3 ( char **sec3, size_t lmax, struct climat_chunks *cl )
             {
               strcpy ( cl->s3.V3,"//" );
             }
-          used += snprintf ( c + used, lmax - used, " 9%s%s%s", cl->s3.V1, cl->s3.V2, cl->s3.V3 );
+          used += bufr2tac_buffer_printf ( out, " 9%s%s%s", cl->s3.V1, cl->s3.V2, cl->s3.V3 );
         }
 
     }
 
-  if ( used != used0 )
+  // Nothing but the header of section, which is dropped
+  if ( used == used0 )
     {
-      *sec3 = c + used;
+      bufr2tac_buffer_truncate ( out, out->len - used );
+      used = 0;
     }
-  used = 0;
 
   return used;
 
 }
 
 /*!
-  \fn size_t print_climat_sec4 (char **sec4, size_t lmax, struct climat_chunks *cl)
+  \fn size_t print_climat_sec4 ( struct bufr2tac_buffer *out, struct climat_chunks *cl)
   \brief Prints the climat section 4
-  \param [in,out] sec4 Pointer to the output buffer where section 4 will be written
-  \param [in] lmax Maximum length permitted for the output buffer
+  \param [in,out] out Growable buffer where section 4 is appended
   \param [in,out] cl Pointer to struct \ref climat_chunks where the parse results are set
-  \return Number of characters written to the buffer
+  \return Number of characters appended to the buffer
 */
-size_t print_climat_sec4 ( char **sec4, size_t lmax, struct climat_chunks *cl )
+size_t print_climat_sec4 ( struct bufr2tac_buffer *out, struct climat_chunks *cl )
 {
-  char *c = *sec4;
   size_t used0 = 0, used = 0;
 
   if ( cl->mask & CLIMAT_SEC4 )
     {
-      //used += snprintf ( c + used, lmax - used, "\r\n      444" );
-      used += snprintf ( c + used, lmax - used, " 444" );
+      //used += bufr2tac_buffer_printf ( out, "\r\n      444" );
+      used += bufr2tac_buffer_printf ( out, " 444" );
 
       // init point to write info.
       // in case we finally write nothing in this section
@@ -585,7 +572,7 @@ size_t print_climat_sec4 ( char **sec4, size_t lmax, struct climat_chunks *cl )
             {
               strcpy ( cl->s4.yx, "//" );
             }
-          used += snprintf ( c + used, lmax - used, " 0%s%s%s", cl->s4.sx, cl->s4.Txd, cl->s4.yx );
+          used += bufr2tac_buffer_printf ( out, " 0%s%s%s", cl->s4.sx, cl->s4.Txd, cl->s4.yx );
         }
 
       if ( cl->s4.sn[0] || cl->s4.Tnd[0] || cl->s4.yn[0] )
@@ -602,7 +589,7 @@ size_t print_climat_sec4 ( char **sec4, size_t lmax, struct climat_chunks *cl )
             {
               strcpy ( cl->s4.yn, "//" );
             }
-          used += snprintf ( c + used, lmax - used, " 1%s%s%s", cl->s4.sn, cl->s4.Tnd, cl->s4.yn );
+          used += bufr2tac_buffer_printf ( out, " 1%s%s%s", cl->s4.sn, cl->s4.Tnd, cl->s4.yn );
         }
 
       if (  cl->s4.sax[0] || cl->s4.Tax[0] || cl->s4.yax[0] )
@@ -619,7 +606,7 @@ size_t print_climat_sec4 ( char **sec4, size_t lmax, struct climat_chunks *cl )
             {
               strcpy ( cl->s4.yax, "//" );
             }
-          used += snprintf ( c + used, lmax - used, " 2%s%s%s", cl->s4.sax, cl->s4.Tax, cl->s4.yax );
+          used += bufr2tac_buffer_printf ( out, " 2%s%s%s", cl->s4.sax, cl->s4.Tax, cl->s4.yax );
         }
 
       if (  cl->s4.san[0] || cl->s4.Tan[0] || cl->s4.yan[0] )
@@ -636,7 +623,7 @@ size_t print_climat_sec4 ( char **sec4, size_t lmax, struct climat_chunks *cl )
             {
               strcpy ( cl->s4.yan, "//" );
             }
-          used += snprintf ( c + used, lmax - used, " 3%s%s%s", cl->s4.san, cl->s4.Tan, cl->s4.yan );
+          used += bufr2tac_buffer_printf ( out, " 3%s%s%s", cl->s4.san, cl->s4.Tan, cl->s4.yan );
         }
 
       if (  cl->s4.RxRxRxRx[0] || cl->s4.yr[0] )
@@ -649,7 +636,7 @@ size_t print_climat_sec4 ( char **sec4, size_t lmax, struct climat_chunks *cl )
             {
               strcpy ( cl->s4.Tan, "//" );
             }
-          used += snprintf ( c + used, lmax - used, " 4%s%s", cl->s4.RxRxRxRx, cl->s4.yr );
+          used += bufr2tac_buffer_printf ( out, " 4%s%s", cl->s4.RxRxRxRx, cl->s4.yr );
         }
 
       if (  cl->s4.fxfxfx[0] || cl->s4.yfx[0] )
@@ -666,7 +653,7 @@ size_t print_climat_sec4 ( char **sec4, size_t lmax, struct climat_chunks *cl )
             {
               strcpy ( cl->s4.yfx, "//" );
             }
-          used += snprintf ( c + used, lmax - used, " 5%s%s%s", cl->s4.iw, cl->s4.fxfxfx, cl->s4.yfx );
+          used += bufr2tac_buffer_printf ( out, " 5%s%s%s", cl->s4.iw, cl->s4.fxfxfx, cl->s4.yfx );
         }
 
       if ( cl->s4.Dts[0] || cl->s4.Dgr[0] )
@@ -679,7 +666,7 @@ size_t print_climat_sec4 ( char **sec4, size_t lmax, struct climat_chunks *cl )
             {
               strcpy ( cl->s4.Dgr,"//" );
             }
-          used += snprintf ( c + used, lmax - used, " 6%s%s", cl->s4.Dts, cl->s4.Dgr );
+          used += bufr2tac_buffer_printf ( out, " 6%s%s", cl->s4.Dts, cl->s4.Dgr );
         }
 
       if (  cl->s4.iy[0] || cl->s4.GxGx[0] || cl->s4.GnGn[0] )
@@ -696,18 +683,18 @@ size_t print_climat_sec4 ( char **sec4, size_t lmax, struct climat_chunks *cl )
             {
               strcpy ( cl->s4.GnGn, "//" );
             }
-          used += snprintf ( c + used, lmax - used, " 7%s%s%s", cl->s4.iy, cl->s4.GxGx, cl->s4.GnGn );
+          used += bufr2tac_buffer_printf ( out, " 7%s%s%s", cl->s4.iy, cl->s4.GxGx, cl->s4.GnGn );
         }
 
 
     }
 
-  if ( used != used0 )
+  // Nothing but the header of section, which is dropped
+  if ( used == used0 )
     {
-      *sec4 = c + used;
+      bufr2tac_buffer_truncate ( out, out->len - used );
+      used = 0;
     }
-  else
-    used = 0;
 
   return used;
 }
@@ -715,7 +702,7 @@ size_t print_climat_sec4 ( char **sec4, size_t lmax, struct climat_chunks *cl )
 
 /*!
  \fn int print_climat_report ( struct metreport *m )
- \brief Prints a complete climat report into a string
+ \brief Prints a complete climat report into the growable buffer tac[0], with alphanum as a copy
  \param [in,out] m Pointer to struct \ref metreport where are both target and source
 
  \return 0 if successful, 1 otherwise
@@ -727,11 +714,11 @@ int print_climat_report ( struct metreport *m )
       return 1; // No climat report to print
     }
 
-  char *c = &(m->alphanum[0]);
-  size_t used = 0;
-  size_t lmax = sizeof(m->alphanum);
+  struct bufr2tac_buffer *out = &m->tac[0];
   struct climat_chunks *cl = &m->climat;
 
+  bufr2tac_buffer_clean ( out );
+
   // Needs time extension
   if ( cl->e.YYYY[0] == 0  || cl->e.YYYY[0] == '0' || cl->e.MM[0] == 0 )
     {
@@ -740,31 +727,32 @@ int print_climat_report ( struct metreport *m )
 
   if ( m->print_mask & PRINT_BITMASK_WIGOS )
     {
-      used += print_wigos_id ( &c, lmax, m );
+      print_wigos_id ( out, m );
     }
 
   if ( m->print_mask & PRINT_BITMASK_GEO )
     {
-      used += print_geo ( &c, lmax, m );
+      print_geo ( out, m );
     }
 
-  used += print_climat_sec0 ( &c, lmax - used, cl );
+  print_climat_sec0 ( out, cl );
 
   if ( cl->mask & ( CLIMAT_SEC1 | CLIMAT_SEC2 | CLIMAT_SEC3 | CLIMAT_SEC4 ) )
     {
-      used += print_climat_sec1 ( &c, lmax - used, cl );
+      print_climat_sec1 ( out, cl );
 
-      used += print_climat_sec2 ( &c, lmax - used, cl );
+      print_climat_sec2 ( out, cl );
 
-      used += print_climat_sec3 ( &c, lmax - used, cl );
+      print_climat_sec3 ( out, cl );
 
-      used += print_climat_sec4 ( &c, lmax - used, cl );
+      print_climat_sec4 ( out, cl );
     }
   else
     {
-      c += snprintf ( c, lmax - used, " NIL" );
+      bufr2tac_buffer_printf ( out, " NIL" );
     }
-  snprintf ( c, lmax - used - 1, "=" );
+  bufr2tac_buffer_printf ( out, "=" );
+  bufr2tac_set_alphanum ( m->alphanum, sizeof ( m->alphanum ), out );
 
   return 0;
 
@@ -24,59 +24,57 @@
 #include "bufr2tac.h"
 
 /*!
-  \fn size_t print_synop_sec0 (char **sec0, size_t lmax, const struct synop_chunks *syn)
+  \fn size_t print_synop_sec0 ( struct bufr2tac_buffer *out, const struct synop_chunks *syn)
   \brief Prints the synop section 0 (header)
-  \param [in,out] sec0 Pointer to the output buffer where section 0 will be written
-  \param [in] lmax Maximum length permitted for the output buffer
+  \param [in,out] out Growable buffer where section 0 is appended
   \param [in] syn Pointer to struct \ref synop_chunks where the parse results are set
-  \return Number of characters written to the buffer
+  \return Number of characters appended to the buffer
 */
-size_t print_synop_sec0 ( char **sec0, size_t lmax, const struct synop_chunks *syn )
+size_t print_synop_sec0 ( struct bufr2tac_buffer *out, const struct synop_chunks *syn )
 {
-  char *c = *sec0;
   size_t used = 0;
 
-  used += snprintf ( c + used, lmax - used,  "%s%s%s%s%s", syn->e.YYYY, syn->e.MM, syn->e.DD, syn->e.HH, syn->e.mm );
+  used += bufr2tac_buffer_printf ( out, "%s%s%s%s%s", syn->e.YYYY, syn->e.MM, syn->e.DD, syn->e.HH, syn->e.mm );
 
   // Print type
-  used += snprintf ( c + used, lmax - used,    " %s%s", syn->s0.MiMi, syn->s0.MjMj );
+  used += bufr2tac_buffer_printf ( out, " %s%s", syn->s0.MiMi, syn->s0.MjMj );
 
   if ( syn->s0.D_D[0] )
     {
-      used += snprintf ( c + used, lmax - used,  " %s", syn->s0.D_D );
+      used += bufr2tac_buffer_printf ( out, " %s", syn->s0.D_D );
     }
   else if ( syn->s0.A1[0] && syn->s0.bw[0] && syn->s0.nbnbnb[0] )
     {
-      used += snprintf ( c + used, lmax - used,  " %s%s%s", syn->s0.A1, syn->s0.bw, syn->s0.nbnbnb );
+      used += bufr2tac_buffer_printf ( out, " %s%s%s", syn->s0.A1, syn->s0.bw, syn->s0.nbnbnb );
     }
 
 
   // print YYGGiw
-  used += snprintf ( c + used, lmax - used, " %s%s%s", syn->s0.YY, syn->s0.GG, syn->s0.iw );
+  used += bufr2tac_buffer_printf ( out, " %s%s%s", syn->s0.YY, syn->s0.GG, syn->s0.iw );
 
   // print IIiii
   if ( syn->s0.II[0] )
     {
-      used += snprintf ( c + used, lmax - used, " %s%s", syn->s0.II, syn->s0.iii );
+      used += bufr2tac_buffer_printf ( out, " %s%s", syn->s0.II, syn->s0.iii );
     }
   else
     {
       if ( syn->s0.LaLaLa[0] )
         {
-          used += snprintf ( c + used, lmax - used, " 99%s", syn->s0.LaLaLa );
+          used += bufr2tac_buffer_printf ( out, " 99%s", syn->s0.LaLaLa );
         }
       else
         {
-          used += snprintf ( c + used, lmax - used, " 99///" );
+          used += bufr2tac_buffer_printf ( out, " 99///" );
         }
 
       if ( syn->s0.Qc[0] && syn->s0.LoLoLoLo[0] )
         {
-          used += snprintf ( c + used, lmax - used, " %s%s", syn->s0.Qc, syn->s0.LoLoLoLo );
+          used += bufr2tac_buffer_printf ( out, " %s%s", syn->s0.Qc, syn->s0.LoLoLoLo );
         }
       else
         {
-          used += snprintf ( c + used, lmax - used, " /////" );
+          used += bufr2tac_buffer_printf ( out, " /////" );
         }
     }
 
@@ -84,72 +82,68 @@ size_t print_synop_sec0 ( char **sec0, size_t lmax, const struct synop_chunks *s
     {
       if ( syn->s0.MMM[0] && syn->s0.Ula[0] && syn->s0.Ulo[0] )
         {
-          used += snprintf ( c + used, lmax - used, " %s%s%s", syn->s0.MMM, syn->s0.Ula, syn->s0.Ulo );
+          used += bufr2tac_buffer_printf ( out, " %s%s%s", syn->s0.MMM, syn->s0.Ula, syn->s0.Ulo );
         }
       if ( syn->s0.h0h0h0h0[0] )
         {
-          used += snprintf ( c + used, lmax - used, " %s%s", syn->s0.h0h0h0h0, syn->s0.im );
+          used += bufr2tac_buffer_printf ( out, " %s%s", syn->s0.h0h0h0h0, syn->s0.im );
         }
 
     }
-
-  *sec0 = c + used;
   return used;
 }
 
 /*!
-  \fn size_t print_synop_sec1 (char **sec1, size_t lmax, struct synop_chunks *syn)
+  \fn size_t print_synop_sec1 ( struct bufr2tac_buffer *out, struct synop_chunks *syn)
   \brief Prints the synop section 1
-  \param [in,out] sec1 Pointer to the output buffer where section 1 will be written
-  \param [in] lmax Maximum length permitted for the output buffer
+  \param [in,out] out Growable buffer where section 1 is appended
   \param [in] syn Pointer to struct \ref synop_chunks where the parse results are set
-  \return Number of characters written to the buffer
+  \return Number of characters appended to the buffer
 */
-size_t print_synop_sec1 ( char **sec1, size_t lmax, struct synop_chunks *syn )
+size_t print_synop_sec1 ( struct bufr2tac_buffer *out, struct synop_chunks *syn )
 {
-  char *c = *sec1;
   size_t used = 0;
 
   if ( syn->mask & SYNOP_SEC1 )
     {
       // printf irixhVV
-      used += snprintf ( c + used, lmax - used, " %s%s%s%s", syn->s1.ir, syn->s1.ix, syn->s1.h, syn->s1.VV );
+      used += bufr2tac_buffer_printf ( out, " %s%s%s%s", syn->s1.ir, syn->s1.ix, syn->s1.h, syn->s1.VV );
 
 
       // printf Nddff
-      used += snprintf ( c + used, lmax - used, " %s%s%s", syn->s1.N, syn->s1.dd, syn->s1.ff );
+      used += bufr2tac_buffer_printf ( out, " %s%s%s", syn->s1.N, syn->s1.dd, syn->s1.ff );
       if ( strlen ( syn->s1.fff ) )
         {
-          used += snprintf ( c + used, lmax - used, " 00%s", syn->s1.fff );
+          used += bufr2tac_buffer_printf ( out, " 00%s", syn->s1.fff );
         }
 
       // printf 1snTTT
 
       if ( syn->s1.TTT[0] )
         {
-          used += snprintf ( c + used, lmax - used, " 1%s%s", syn->s1.sn1, syn->s1.TTT );
+          used += bufr2tac_buffer_printf ( out, " 1%s%s", syn->s1.sn1, syn->s1.TTT );
         }
 
       // printf 2snTdTdTd or 29UUU
       if ( syn->s1.TdTdTd[0] )
         {
-          used += snprintf ( c + used, lmax - used, " 2%s%s", syn->s1.sn2, syn->s1.TdTdTd );
+          used += bufr2tac_buffer_printf ( out, " 2%s%s", syn->s1.sn2, syn->s1.TdTdTd );
         }
       else if ( syn->s1.UUU[0] )
         {
-          used += snprintf ( c + used, lmax - used, " 29%s", syn->s1.UUU );
+          used += bufr2tac_buffer_printf ( out, " 29%s", syn->s1.UUU );
         }
 
       // printf 3PoPoPoPo
       if ( syn->s1.PoPoPoPo[0] )
         {
-          used += snprintf ( c + used, lmax - used, " 3%s", syn->s1.PoPoPoPo );
+          used += bufr2tac_buffer_printf ( out, " 3%s", syn->s1.PoPoPoPo );
         }
 
       // printf 4PPPP or 4a3hhh
       if ( syn->s1.PPPP[0] )
         {
-          used += snprintf ( c + used, lmax - used, " 4%s", syn->s1.PPPP );
+          used += bufr2tac_buffer_printf ( out, " 4%s", syn->s1.PPPP );
         }
       else if ( syn->s1.hhh[0] )
         {
@@ -157,7 +151,7 @@ size_t print_synop_sec1 ( char **sec1, size_t lmax, struct synop_chunks *syn )
             {
               syn->s1.a3[0] = '/';
             }
-          used += snprintf ( c + used, lmax - used, " 4%s%s", syn->s1.a3, syn->s1.hhh );
+          used += bufr2tac_buffer_printf ( out, " 4%s%s", syn->s1.a3, syn->s1.hhh );
         }
 
       // printf 5appp
@@ -171,7 +165,7 @@ size_t print_synop_sec1 ( char **sec1, size_t lmax, struct synop_chunks *syn )
             {
               strcpy ( syn->s1.ppp, "///" );
             }
-          used += snprintf ( c + used, lmax - used, " 5%s%s", syn->s1.a, syn->s1.ppp );
+          used += bufr2tac_buffer_printf ( out, " 5%s%s", syn->s1.a, syn->s1.ppp );
         }
 
       // printf 6RRRtr
@@ -185,7 +179,7 @@ size_t print_synop_sec1 ( char **sec1, size_t lmax, struct synop_chunks *syn )
             {
               strcpy ( syn->s1.RRR, "///" );
             }
-          used += snprintf ( c + used, lmax - used, " 6%s%s", syn->s1.RRR, syn->s1.tr );
+          used += bufr2tac_buffer_printf ( out, " 6%s%s", syn->s1.RRR, syn->s1.tr );
         }
 
       if ( syn->s1.ww[0] || syn->s1.W1[0] || syn->s1.W2[0] )
@@ -202,7 +196,7 @@ size_t print_synop_sec1 ( char **sec1, size_t lmax, struct synop_chunks *syn )
             {
               strcpy ( syn->s1.W2, "/" );
             }
-          used += snprintf ( c + used, lmax - used, " 7%s%s%s", syn->s1.ww, syn->s1.W1, syn->s1.W2 );
+          used += bufr2tac_buffer_printf ( out, " 7%s%s%s", syn->s1.ww, syn->s1.W1, syn->s1.W2 );
         }
 
       if ( ( syn->s1.Nh[0] && syn->s1.Nh[0] != '0' && syn->s1.Nh[0] != '/' ) ||
@@ -226,78 +220,75 @@ size_t print_synop_sec1 ( char **sec1, size_t lmax, struct synop_chunks *syn )
             {
               strcpy ( syn->s1.Ch, "/" );
             }
-          used += snprintf ( c + used, lmax - used, " 8%s%s%s%s", syn->s1.Nh, syn->s1.Cl, syn->s1.Cm, syn->s1.Ch );
+          used += bufr2tac_buffer_printf ( out, " 8%s%s%s%s", syn->s1.Nh, syn->s1.Cl, syn->s1.Cm, syn->s1.Ch );
         }
 
       if ( syn->s1.GG[0] )
         {
-          used += snprintf ( c + used, lmax - used, " 9%s%s", syn->s1.GG, syn->s1.gg );
+          used += bufr2tac_buffer_printf ( out, " 9%s%s", syn->s1.GG, syn->s1.gg );
         }
     }
-  *sec1 = c + used;
   return used;
 }
 
 
 /*!
-  \fn size_t print_synop_sec2 (char **sec2, size_t lmax, const struct synop_chunks *syn)
+  \fn size_t print_synop_sec2 ( struct bufr2tac_buffer *out, const struct synop_chunks *syn)
   \brief Prints the synop section 2
-  \param [in,out] sec2 Pointer to the output buffer where section 2 will be written
-  \param [in] lmax Maximum length permitted for the output buffer
+  \param [in,out] out Growable buffer where section 2 is appended
   \param [in] syn Pointer to struct \ref synop_chunks where the parse results are set
-  \return Number of characters written to the buffer
+  \return Number of characters appended to the buffer
 */
-size_t print_synop_sec2 ( char **sec2, size_t lmax, const struct synop_chunks *syn )
+size_t print_synop_sec2 ( struct bufr2tac_buffer *out, const struct synop_chunks *syn )
 {
-  char *c = *sec2;
   size_t used = 0;
 
   if ( syn->mask & SYNOP_SEC2 )
     {
       // 222Dsvs
-      used += snprintf ( c + used, lmax - used, " 222" );
+      used += bufr2tac_buffer_printf ( out, " 222" );
       if ( syn->s2.Ds[0] )
         {
-          used += snprintf ( c + used, lmax - used, "%s", syn->s2.Ds );
+          used += bufr2tac_buffer_printf ( out, "%s", syn->s2.Ds );
         }
       else
         {
-          used += snprintf ( c + used, lmax - used, "/" );
+          used += bufr2tac_buffer_printf ( out, "/" );
         }
 
       if ( syn->s2.vs[0] )
         {
-          used += snprintf ( c + used, lmax - used, "%s", syn->s2.vs );
+          used += bufr2tac_buffer_printf ( out, "%s", syn->s2.vs );
         }
       else
         {
-          used += snprintf ( c + used, lmax - used, "/" );
+          used += bufr2tac_buffer_printf ( out, "/" );
         }
 
       // printf 0ssTwTwTw
       if ( syn->s2.TwTwTw[0] )
         {
-          used += snprintf ( c + used, lmax - used, " 0%s%s", syn->s2.ss, syn->s2.TwTwTw );
+          used += bufr2tac_buffer_printf ( out, " 0%s%s", syn->s2.ss, syn->s2.TwTwTw );
         }
 
       if ( syn->s2.PwaPwa[0] || syn->s2.HwaHwa[0] )
         {
           if ( syn->s2.PwaPwa[0] )
             {
-              used += snprintf ( c + used, lmax - used, " 1%s", syn->s2.PwaPwa );
+              used += bufr2tac_buffer_printf ( out, " 1%s", syn->s2.PwaPwa );
             }
           else
             {
-              used += snprintf ( c + used, lmax - used, " 1//" );
+              used += bufr2tac_buffer_printf ( out, " 1//" );
             }
 
           if ( syn->s2.HwaHwa[0] )
             {
-              used += snprintf ( c + used, lmax - used, "%s", syn->s2.HwaHwa );
+              used += bufr2tac_buffer_printf ( out, "%s", syn->s2.HwaHwa );
             }
           else
             {
-              used += snprintf ( c + used, lmax - used, "//" );
+              used += bufr2tac_buffer_printf ( out, "//" );
             }
         }
 
@@ -305,20 +296,20 @@ size_t print_synop_sec2 ( char **sec2, size_t lmax, const struct synop_chunks *s
         {
           if ( syn->s2.PwPw[0] )
             {
-              used += snprintf ( c + used, lmax - used, " 2%s", syn->s2.PwPw );
+              used += bufr2tac_buffer_printf ( out, " 2%s", syn->s2.PwPw );
             }
           else
             {
-              used += snprintf ( c + used, lmax - used, " 2//" );
+              used += bufr2tac_buffer_printf ( out, " 2//" );
             }
 
           if ( syn->s2.HwHw[0] )
             {
-              used += snprintf ( c + used, lmax - used, "%s", syn->s2.HwHw );
+              used += bufr2tac_buffer_printf ( out, "%s", syn->s2.HwHw );
             }
           else
             {
-              used += snprintf ( c + used, lmax - used, "//" );
+              used += bufr2tac_buffer_printf ( out, "//" );
             }
         }
 
@@ -326,20 +317,20 @@ size_t print_synop_sec2 ( char **sec2, size_t lmax, const struct synop_chunks *s
         {
           if ( syn->s2.dw1dw1[0] )
             {
-              used += snprintf ( c + used, lmax - used, " 3%s", syn->s2.dw1dw1 );
+              used += bufr2tac_buffer_printf ( out, " 3%s", syn->s2.dw1dw1 );
             }
           else
             {
-              used += snprintf ( c + used, lmax - used, " 3//" );
+              used += bufr2tac_buffer_printf ( out, " 3//" );
             }
 
           if ( syn->s2.dw2dw2[0] )
             {
-              used += snprintf ( c + used, lmax - used, "%s", syn->s2.dw2dw2 );
+              used += bufr2tac_buffer_printf ( out, "%s", syn->s2.dw2dw2 );
             }
           else
             {
-              used += snprintf ( c + used, lmax - used, "//" );
+              used += bufr2tac_buffer_printf ( out, "//" );
             }
         }
 
@@ -347,20 +338,20 @@ size_t print_synop_sec2 ( char **sec2, size_t lmax, const struct synop_chunks *s
         {
           if ( syn->s2.Pw1Pw1[0] )
             {
-              used += snprintf ( c + used, lmax - used, " 4%s", syn->s2.Pw1Pw1 );
+              used += bufr2tac_buffer_printf ( out, " 4%s", syn->s2.Pw1Pw1 );
             }
           else
             {
-              used += snprintf ( c + used, lmax - used, " 4//" );
+              used += bufr2tac_buffer_printf ( out, " 4//" );
             }
 
           if ( syn->s2.Hw1Hw1[0] )
             {
-              used += snprintf ( c + used, lmax - used, "%s", syn->s2.Hw1Hw1 );
+              used += bufr2tac_buffer_printf ( out, "%s", syn->s2.Hw1Hw1 );
             }
           else
             {
-              used += snprintf ( c + used, lmax - used, "//" );
+              used += bufr2tac_buffer_printf ( out, "//" );
             }
         }
 
@@ -369,55 +360,52 @@ size_t print_synop_sec2 ( char **sec2, size_t lmax, const struct synop_chunks *s
         {
           if ( syn->s2.Pw2Pw2[0] )
             {
-              used += snprintf ( c + used, lmax - used, " 5%s", syn->s2.Pw2Pw2 );
+              used += bufr2tac_buffer_printf ( out, " 5%s", syn->s2.Pw2Pw2 );
             }
           else
             {
-              used += snprintf ( c + used, lmax - used, " 5//" );
+              used += bufr2tac_buffer_printf ( out, " 5//" );
             }
 
           if ( syn->s2.Hw2Hw2[0] )
             {
-              used += snprintf ( c + used, lmax - used, "%s", syn->s2.Hw2Hw2 );
+              used += bufr2tac_buffer_printf ( out, "%s", syn->s2.Hw2Hw2 );
             }
           else
             {
-              used += snprintf ( c + used, lmax - used, "//" );
+              used += bufr2tac_buffer_printf ( out, "//" );
             }
         }
 
       if ( syn->s2.HwaHwaHwa[0] )
         {
-          used += snprintf ( c + used, lmax - used, " 70%s", syn->s2.HwaHwaHwa );
+          used += bufr2tac_buffer_printf ( out, " 70%s", syn->s2.HwaHwaHwa );
         }
 
 
       if ( syn->s2.TbTbTb[0] )
         {
-          used += snprintf ( c + used, lmax - used, " 8%s%s", syn->s2.sw, syn->s2.TbTbTb );
+          used += bufr2tac_buffer_printf ( out, " 8%s%s", syn->s2.sw, syn->s2.TbTbTb );
         }
 
     }
-  *sec2 = c + used;
   return used;
 }
 
 /*!
-  \fn size_t print_synop_sec3 (char **sec3, size_t lmax, struct synop_chunks *syn)
+  \fn size_t print_synop_sec3 ( struct bufr2tac_buffer *out, struct synop_chunks *syn)
   \brief Prints the synop section 3
-  \param [in,out] sec3 Pointer to the output buffer where section 3 will be written
-  \param [in] lmax Maximum length permitted for the output buffer
+  \param [in,out] out Growable buffer where section 3 is appended
   \param [in,out] syn Pointer to struct \ref synop_chunks where the parse results are set
-  \return Number of characters written to the buffer
+  \return Number of characters appended to the buffer
 */
-size_t print_synop_sec3 ( char **sec3, size_t lmax, struct synop_chunks *syn )
+size_t print_synop_sec3 ( struct bufr2tac_buffer *out, struct synop_chunks *syn )
 {
-  char *c = *sec3;
   size_t used = 0;
 
   if ( syn->mask & SYNOP_SEC3 )
     {
-      used += snprintf ( c + used, lmax - used, " 333" );
+      used += bufr2tac_buffer_printf ( out, " 333" );
 
       // init point to write info.
       // in case we finally write nothing in this section
@@ -438,19 +426,19 @@ size_t print_synop_sec3 ( char **sec3, size_t lmax, struct synop_chunks *syn )
             {
               syn->s3.XoXoXoXo[3] = '/';
             }
-          used += snprintf ( c + used, lmax - used, " 0%s", syn->s3.XoXoXoXo );
+          used += bufr2tac_buffer_printf ( out, " 0%s", syn->s3.XoXoXoXo );
         }
 
       // printf 1snxTxTxTx
       if ( syn->s3.snx[0] )
         {
-          used += snprintf ( c + used, lmax - used, " 1%s%s", syn->s3.snx, syn->s3.TxTxTx );
+          used += bufr2tac_buffer_printf ( out, " 1%s%s", syn->s3.snx, syn->s3.TxTxTx );
         }
 
       // printf 1snnTnTnTn
       if ( syn->s3.snn[0] )
         {
-          used += snprintf ( c + used, lmax - used, " 2%s%s", syn->s3.snn, syn->s3.TnTnTn );
+          used += bufr2tac_buffer_printf ( out, " 2%s%s", syn->s3.snn, syn->s3.TnTnTn );
         }
 
       // printf 3Ejjj
@@ -464,7 +452,7 @@ size_t print_synop_sec3 ( char **sec3, size_t lmax, struct synop_chunks *syn )
             {
               strcpy ( syn->s3.jjj, "///" );
             }
-          used += snprintf ( c + used, lmax - used, " 3%s%s", syn->s3.E, syn->s3.jjj );
+          used += bufr2tac_buffer_printf ( out, " 3%s%s", syn->s3.E, syn->s3.jjj );
         }
 
       // printf 4E1sss
@@ -480,7 +468,7 @@ size_t print_synop_sec3 ( char **sec3, size_t lmax, struct synop_chunks *syn )
             }
           if ( syn->s3.E1[0] != '/' || strcmp ( syn->s3.sss, "999" ) )
             {
-              used += snprintf ( c + used, lmax - used, " 4%s%s", syn->s3.E1, syn->s3.sss );
+              used += bufr2tac_buffer_printf ( out, " 4%s%s", syn->s3.E1, syn->s3.sss );
             }
         }
 
@@ -491,21 +479,21 @@ size_t print_synop_sec3 ( char **sec3, size_t lmax, struct synop_chunks *syn )
         {
           if ( strcmp ( syn->s3.SSS, "///" ) )
             {
-              used += snprintf ( c + used, lmax - used, " 55%s", syn->s3.SSS );
+              used += bufr2tac_buffer_printf ( out, " 55%s", syn->s3.SSS );
             }
           else if ( syn->s3.j524[0][0] || syn->s3.j524[1][0] ||
                     syn->s3.j524[2][0] || syn->s3.j524[3][0] ||
                     syn->s3.j524[4][0] || syn->s3.j524[5][0] ||
                     syn->s3.j524[6][0] )
             {
-              used += snprintf ( c + used, lmax - used, " 55%s", syn->s3.SSS );
+              used += bufr2tac_buffer_printf ( out, " 55%s", syn->s3.SSS );
             }
 
           for ( size_t i = 0; i < 7; i++ )
             {
               if ( syn->s3.j524[i][0] )
                 {
-                  used += snprintf ( c + used, lmax - used, " %s%s", syn->s3.j524[i], syn->s3.FFFF24[i] );
+                  used += bufr2tac_buffer_printf ( out, " %s%s", syn->s3.j524[i], syn->s3.FFFF24[i] );
                 }
             }
         }
@@ -515,21 +503,21 @@ size_t print_synop_sec3 ( char **sec3, size_t lmax, struct synop_chunks *syn )
         {
           if ( strcmp ( syn->s3.SS, "//" ) )
             {
-              used += snprintf ( c + used, lmax - used, " 553%s", syn->s3.SS );
+              used += bufr2tac_buffer_printf ( out, " 553%s", syn->s3.SS );
             }
           else if ( syn->s3.j5[0][0] || syn->s3.j5[1][0] ||
                     syn->s3.j5[2][0] || syn->s3.j5[3][0] ||
                     syn->s3.j5[4][0] || syn->s3.j5[5][0] ||
                     syn->s3.j5[6][0] )
             {
-              used += snprintf ( c + used, lmax - used, " 553%s", syn->s3.SS );
+              used += bufr2tac_buffer_printf ( out, " 553%s", syn->s3.SS );
             }
 
           for ( size_t i = 0; i < 7; i++ )
             {
               if ( syn->s3.j5[i][0] )
                 {
-                  used += snprintf ( c + used, lmax - used, " %s%s", syn->s3.j5[i], syn->s3.FFFF[i] );
+                  used += bufr2tac_buffer_printf ( out, " %s%s", syn->s3.j5[i], syn->s3.FFFF[i] );
                 }
             }
         }
@@ -537,25 +525,25 @@ size_t print_synop_sec3 ( char **sec3, size_t lmax, struct synop_chunks *syn )
       // print 55407
       if ( syn->s3.FFFF407[0] )
         {
-          used += snprintf ( c + used, lmax - used, " 55407 4%s", syn->s3.FFFF407 );
+          used += bufr2tac_buffer_printf ( out, " 55407 4%s", syn->s3.FFFF407 );
         }
 
       // print 55408
       if ( syn->s3.FFFF408[0] )
         {
-          used += snprintf ( c + used, lmax - used, " 55408 4%s", syn->s3.FFFF408 );
+          used += bufr2tac_buffer_printf ( out, " 55408 4%s", syn->s3.FFFF408 );
         }
 
       // print 55507
       if ( syn->s3.FFFF507[0] )
         {
-          used += snprintf ( c + used, lmax - used, " 55507 4%s", syn->s3.FFFF507 );
+          used += bufr2tac_buffer_printf ( out, " 55507 4%s", syn->s3.FFFF507 );
         }
 
       // print 55507
       if ( syn->s3.FFFF508[0] )
         {
-          used += snprintf ( c + used, lmax - used, " 55508 4%s", syn->s3.FFFF508 );
+          used += bufr2tac_buffer_printf ( out, " 55508 4%s", syn->s3.FFFF508 );
         }
 
       // print 56DlDmDh
@@ -574,7 +562,7 @@ size_t print_synop_sec3 ( char **sec3, size_t lmax, struct synop_chunks *syn )
               syn->s3.Dh[0] = '/';
             }
 
-          used += snprintf ( c + used, lmax - used, " 56%s%s%s", syn->s3.Dl, syn->s3.Dm, syn->s3.Dh );
+          used += bufr2tac_buffer_printf ( out, " 56%s%s%s", syn->s3.Dl, syn->s3.Dm, syn->s3.Dh );
         }
 
       // print 57CDeec
@@ -589,13 +577,13 @@ size_t print_synop_sec3 ( char **sec3, size_t lmax, struct synop_chunks *syn )
               syn->s3.ec[0] = '/';
             }
 
-          used += snprintf ( c + used, lmax - used, " 57%s%s%s", syn->s3.C, syn->s3.Da, syn->s3.ec );
+          used += bufr2tac_buffer_printf ( out, " 57%s%s%s", syn->s3.C, syn->s3.Da, syn->s3.ec );
         }
 
       // print 58ppp24 or 59ppo24
       if ( syn->s3.ppp24[0] )
         {
-          used += snprintf ( c + used, lmax - used, " 5%s%s", syn->s3.snp24, syn->s3.ppp24 );
+          used += bufr2tac_buffer_printf ( out, " 5%s%s", syn->s3.snp24, syn->s3.ppp24 );
         }
 
       // printf 6RRRtr
@@ -609,12 +597,12 @@ size_t print_synop_sec3 ( char **sec3, size_t lmax, struct synop_chunks *syn )
             {
               strcpy ( syn->s3.RRR, "///" );
             }
-          used += snprintf ( c + used, lmax - used, " 6%s%s", syn->s3.RRR,syn->s3.tr );
+          used += bufr2tac_buffer_printf ( out, " 6%s%s", syn->s3.RRR,syn->s3.tr );
         }
 
       if ( syn->s3.RRRR24[0] )
         {
-          used += snprintf ( c + used, lmax - used, " 7%s", syn->s3.RRRR24 );
+          used += bufr2tac_buffer_printf ( out, " 7%s", syn->s3.RRRR24 );
         }
 
       // additional cloud layers
@@ -624,30 +612,30 @@ size_t print_synop_sec3 ( char **sec3, size_t lmax, struct synop_chunks *syn )
             {
               if ( syn->s3.nub[i].Ns[0] == 0 && syn->s3.nub[i].C[0] == 0 )
                 {
-                  used += snprintf ( c + used, lmax - used, " 8//%s", syn->s3.nub[i].hshs ); // Detected cloud but no anymore info
+                  used += bufr2tac_buffer_printf ( out, " 8//%s", syn->s3.nub[i].hshs ); // Detected cloud but no anymore info
                 }
               else
                 {
-                  used += snprintf ( c + used, lmax - used, " 8" );
+                  used += bufr2tac_buffer_printf ( out, " 8" );
                   if ( syn->s3.nub[i].Ns[0] )
                     {
-                      used += snprintf ( c + used, lmax - used, "%s", syn->s3.nub[i].Ns );
+                      used += bufr2tac_buffer_printf ( out, "%s", syn->s3.nub[i].Ns );
                     }
                   else
                     {
-                      used += snprintf ( c + used, lmax - used, "/" );
+                      used += bufr2tac_buffer_printf ( out, "/" );
                     }
 
                   if ( syn->s3.nub[i].C[0] )
                     {
-                      used += snprintf ( c + used, lmax - used, "%s", syn->s3.nub[i].C );
+                      used += bufr2tac_buffer_printf ( out, "%s", syn->s3.nub[i].C );
                     }
                   else
                     {
-                      used += snprintf ( c + used, lmax - used, "/" );
+                      used += bufr2tac_buffer_printf ( out, "/" );
                     }
 
-                  used += snprintf ( c + used, lmax - used, "%s", syn->s3.nub[i].hshs );
+                  used += bufr2tac_buffer_printf ( out, "%s", syn->s3.nub[i].hshs );
 
                 }
             }
@@ -658,7 +646,7 @@ size_t print_synop_sec3 ( char **sec3, size_t lmax, struct synop_chunks *syn )
         {
           if ( syn->s3.d9.misc[i].SpSp[0] && syn->s3.d9.misc[i].spsp[0] )
             {
-              used += snprintf ( c + used, lmax - used, " %s%s", syn->s3.d9.misc[i].SpSp, syn->s3.d9.misc[i].spsp );
+              used += bufr2tac_buffer_printf ( out, " %s%s", syn->s3.d9.misc[i].SpSp, syn->s3.d9.misc[i].spsp );
             }
         }
 
@@ -666,7 +654,7 @@ size_t print_synop_sec3 ( char **sec3, size_t lmax, struct synop_chunks *syn )
       // aditional regional info
       if ( syn->mask & SYNOP_SEC3_8 )
         {
-          used += snprintf ( c + used, lmax - used, " 80000" );
+          used += bufr2tac_buffer_printf ( out, " 80000" );
           for ( size_t i = 0; i < SYNOP_NMISC; i++ )
             {
               if ( syn->s3.R8[i][0] || syn->s3.R8[i][1] || syn->s3.R8[i][2] || syn->s3.R8[i][3] )
@@ -687,38 +675,36 @@ size_t print_synop_sec3 ( char **sec3, size_t lmax, struct synop_chunks *syn )
                     {
                       syn->s3.R8[i][3] = '/';
                     }
-                  used += snprintf ( c + used, lmax - used, " %zu%s", i, syn->s3.R8[i] );
+                  used += bufr2tac_buffer_printf ( out, " %zu%s", i, syn->s3.R8[i] );
                 }
             }
         }
 
-      if ( used != used0 )
+      // Nothing but the header of section, which is dropped
+      if ( used == used0 )
         {
-          *sec3 = c + used;
+          bufr2tac_buffer_truncate ( out, out->len - used );
+          used = 0;
         }
-      else
-        used = 0;
 
     }
   return used;
 }
 
 /*!
-  \fn size_t print_synop_sec4 (char **sec4, size_t lmax, struct synop_chunks *syn)
+  \fn size_t print_synop_sec4 ( struct bufr2tac_buffer *out, struct synop_chunks *syn)
   \brief Prints the synop section 4
-  \param [in,out] sec4 Pointer to the output buffer where section 4 will be written
-  \param [in] lmax Maximum length permitted for the output buffer
+  \param [in,out] out Growable buffer where section 4 is appended
   \param [in,out] syn Pointer to struct \ref synop_chunks where the parse results are set
-  \return Number of characters written to the buffer
+  \return Number of characters appended to the buffer
 */
-size_t print_synop_sec4 ( char **sec4, size_t lmax, struct synop_chunks *syn )
+size_t print_synop_sec4 ( struct bufr2tac_buffer *out, struct synop_chunks *syn )
 {
-  char *c = *sec4;
   size_t used = 0;
 
   if ( syn->mask & SYNOP_SEC5 )
     {
-      used += snprintf ( c + used, lmax - used, " 444" );
+      used += bufr2tac_buffer_printf ( out, " 444" );
 
       // init point to write info.
       // in case we finally write nothing in this section
@@ -743,36 +729,34 @@ size_t print_synop_sec4 ( char **sec4, size_t lmax, struct synop_chunks *syn )
             {
               strcpy ( syn->s4.H1H1, "//" );
             }
-          used += snprintf ( c + used, lmax - used, " %s%s%s%s", syn->s4.N1, syn->s4.C1, syn->s4.H1H1, syn->s4.Ct );
+          used += bufr2tac_buffer_printf ( out, " %s%s%s%s", syn->s4.N1, syn->s4.C1, syn->s4.H1H1, syn->s4.Ct );
         }
 
-      if ( used != used0 )
+      // Nothing but the header of section, which is dropped
+      if ( used == used0 )
         {
-          *sec4 = c + used;
+          bufr2tac_buffer_truncate ( out, out->len - used );
+          used = 0;
         }
-      else
-        used = 0;
     }
   return used;
 }
 
 
 /*!
-  \fn size_t print_synop_sec5 (char **sec5, size_t lmax, struct synop_chunks *syn)
+  \fn size_t print_synop_sec5 ( struct bufr2tac_buffer *out, struct synop_chunks *syn)
   \brief Prints the synop section 5
-  \param [in,out] sec5 Pointer to the output buffer where section 5 will be written
-  \param [in] lmax Maximum length permitted for the output buffer
+  \param [in,out] out Growable buffer where section 5 is appended
   \param [in,out] syn Pointer to struct \ref synop_chunks where the parse results are set
-  \return Number of characters written to the buffer
+  \return Number of characters appended to the buffer
 */
-size_t print_synop_sec5 ( char **sec5, size_t lmax, struct synop_chunks *syn )
+size_t print_synop_sec5 ( struct bufr2tac_buffer *out, struct synop_chunks *syn )
 {
-  char *c = *sec5;
   size_t used = 0, used0;
 
   if ( syn->mask & SYNOP_SEC5 )
     {
-      used += snprintf ( c + used, lmax - used, " 555" );
+      used += bufr2tac_buffer_printf ( out, " 555" );
 
       // init point to write info.
       // in case we finally write nothing in this section
@@ -789,21 +773,21 @@ size_t print_synop_sec5 ( char **sec5, size_t lmax, struct synop_chunks *syn )
             {
               strcpy ( syn->s5.RRR, "///" );
             }
-          used += snprintf ( c + used, lmax - used, " 6%s%s", syn->s5.RRR,syn->s5.tr );
+          used += bufr2tac_buffer_printf ( out, " 6%s%s", syn->s5.RRR,syn->s5.tr );
         }
 
       // additional info
       for ( size_t i = 0; i < syn->s5.d9.n ; i++ )
         {
-          used += snprintf ( c + used, lmax - used, " %s%s", syn->s5.d9.misc[i].SpSp, syn->s5.d9.misc[i].spsp );
+          used += bufr2tac_buffer_printf ( out, " %s%s", syn->s5.d9.misc[i].SpSp, syn->s5.d9.misc[i].spsp );
         }
 
-      if ( used != used0 )
+      // Nothing but the header of section, which is dropped
+      if ( used == used0 )
         {
-          *sec5 = c + used;
+          bufr2tac_buffer_truncate ( out, out->len - used );
+          used = 0;
         }
-      else
-        used = 0;
     }
   return used;
 }
@@ -811,7 +795,7 @@ size_t print_synop_sec5 ( char **sec5, size_t lmax, struct synop_chunks *syn )
 
 /*!
  \fn int print_synop_report(struct metreport *m)
- \brief Prints a complete synop report into a string
+ \brief Prints a complete synop report into the growable buffer tac[0], with alphanum as a copy
  \param [in,out] m Pointer to struct \ref metreport where are both target and source
 
  \return 0 if successful, 1 otherwise
@@ -823,10 +807,10 @@ int print_synop_report (struct metreport *m)
       return 1; // No climat report to print
     }
   
-  char *c = &(m->alphanum[0]);
-  size_t used = 0;
-  size_t lmax = sizeof(m->alphanum);
+  struct bufr2tac_buffer *out = &m->tac[0];
   struct synop_chunks *syn = &m->synop;
+
+  bufr2tac_buffer_clean ( out );
   
   // Needs time extension
   if ( syn->e.YYYY[0] == 0 || syn->e.YYYY[0] == '0' )
@@ -836,7 +820,7 @@ int print_synop_report (struct metreport *m)
 
   if ( m->print_mask & PRINT_BITMASK_WIGOS )
     {
-      used += print_wigos_id ( &c, lmax, m );
+      print_wigos_id ( out, m );
     }
   /*else
     {
@@ -848,28 +832,29 @@ int print_synop_report (struct metreport *m)
   */
   if ( m->print_mask & PRINT_BITMASK_GEO )
     {
-      used += print_geo ( &c, lmax, m );
+      print_geo ( out, m );
     }
     
-  used += print_synop_sec0 ( &c, lmax - used, syn );
+  print_synop_sec0 ( out, syn );
 
   if ( syn->mask & ( SYNOP_SEC1 | SYNOP_SEC2 | SYNOP_SEC3 | SYNOP_SEC4 | SYNOP_SEC5 ) )
     {
-      used += print_synop_sec1 ( &c, lmax - used, syn );
+      print_synop_sec1 ( out, syn );
 
-      used += print_synop_sec2 ( &c, lmax - used, syn );
+      print_synop_sec2 ( out, syn );
 
-      used += print_synop_sec3 ( &c, lmax - used, syn );
+      print_synop_sec3 ( out, syn );
 
-      used += print_synop_sec4 ( &c, lmax - used, syn );
+      print_synop_sec4 ( out, syn );
 
-      used += print_synop_sec5 ( &c, lmax - used, syn );
+      print_synop_sec5 ( out, syn );
     }
   else
     {
-      c += snprintf ( c, lmax - used, " NIL" );
+      bufr2tac_buffer_printf ( out, " NIL" );
     }
-  snprintf ( c, lmax - used - 1, "=" );
+  bufr2tac_buffer_printf ( out, "=" );
+  bufr2tac_set_alphanum ( m->alphanum, sizeof ( m->alphanum ), out );
 
   return 0;
 }
@@ -136,152 +136,138 @@ int print_temp_raw_wind_shear_data ( const struct temp_raw_wind_shear_data *w )
 }
 
 /*!
-  \fn size_t print_temp_a_sec1 (char **sec1, size_t lmax, const struct temp_chunks *t)
+  \fn size_t print_temp_a_sec1 ( struct bufr2tac_buffer *out, const struct temp_chunks *t)
   \brief Prints the section 1 of part A of a TEMP report
-  \param [in,out] sec1 Pointer to the output buffer where section 1 will be written
-  \param [in] lmax Maximum length permitted for the output buffer
+  \param [in,out] out Growable buffer where section 1 is appended
   \param [in] t Pointer to struct \ref temp_chunks where the parse results are set
 
-  \return Number of characters written to the buffer
+  \return Number of characters appended to the buffer
 */
-size_t print_temp_a_sec1 ( char **sec1, size_t lmax, const struct temp_chunks *t )
+size_t print_temp_a_sec1 ( struct bufr2tac_buffer *out, const struct temp_chunks *t )
 {
   size_t used = 0;
-  char *c = *sec1;
 
-  used += snprintf ( c + used, lmax - used, "%s", t->t.datime );
+  used += bufr2tac_buffer_printf ( out, "%s", t->t.datime );
 
-  used += snprintf ( c + used, lmax - used, " %s%s", t->a.s1.MiMi, t->a.s1.MjMj );
+  used += bufr2tac_buffer_printf ( out, " %s%s", t->a.s1.MiMi, t->a.s1.MjMj );
 
   if ( t->a.s1.D_D[0] && t->a.s1.II[0] == 0 )
     {
-      used += snprintf ( c + used, lmax - used, " %s", t->a.s1.D_D );
+      used += bufr2tac_buffer_printf ( out, " %s", t->a.s1.D_D );
     }
 
-  used += snprintf ( c + used, lmax - used, " %s%s", t->a.s1.YYGG, t->a.s1.id );
+  used += bufr2tac_buffer_printf ( out, " %s%s", t->a.s1.YYGG, t->a.s1.id );
 
   // print IIiii
   if ( t->a.s1.II[0] )
     {
-      used += snprintf ( c + used, lmax - used, " %s%s", t->a.s1.II, t->a.s1.iii );
+      used += bufr2tac_buffer_printf ( out, " %s%s", t->a.s1.II, t->a.s1.iii );
     }
   else
     {
       if ( t->a.s1.LaLaLa[0] )
         {
-          used += snprintf ( c + used, lmax - used, " 99%s", t->a.s1.LaLaLa );
+          used += bufr2tac_buffer_printf ( out, " 99%s", t->a.s1.LaLaLa );
         }
       else
         {
-          used += snprintf ( c + used, lmax - used, " 99///" );
+          used += bufr2tac_buffer_printf ( out, " 99///" );
         }
 
       if ( t->a.s1.Qc[0] && t->a.s1.LoLoLoLo[0] )
         {
-          used += snprintf ( c + used, lmax - used, " %s%s", t->a.s1.Qc, t->a.s1.LoLoLoLo );
+          used += bufr2tac_buffer_printf ( out, " %s%s", t->a.s1.Qc, t->a.s1.LoLoLoLo );
         }
       else
         {
-          used += snprintf ( c + used, lmax - used, " /////" );
+          used += bufr2tac_buffer_printf ( out, " /////" );
         }
 
       if ( t->a.s1.MMM[0] && t->a.s1.Ula[0] && t->a.s1.Ulo[0] )
         {
-          used += snprintf ( c + used, lmax - used, " %s%s%s", t->a.s1.MMM, t->a.s1.Ula, t->a.s1.Ulo );
+          used += bufr2tac_buffer_printf ( out, " %s%s%s", t->a.s1.MMM, t->a.s1.Ula, t->a.s1.Ulo );
         }
 
       if ( t->a.s1.h0h0h0h0[0] )
         {
-          used += snprintf ( c + used, lmax - used, " %s%s", t->a.s1.h0h0h0h0, t->a.s1.im );
+          used += bufr2tac_buffer_printf ( out, " %s%s", t->a.s1.h0h0h0h0, t->a.s1.im );
         }
     }
-
-  *sec1 = c + used;
   return used;
 }
 
 
 /*!
-  \fn size_t print_temp_a_sec2 (char **sec2, size_t lmax, const struct temp_chunks *t)
+  \fn size_t print_temp_a_sec2 ( struct bufr2tac_buffer *out, const struct temp_chunks *t)
   \brief Prints the section 2 of part A of a TEMP report
-  \param [in,out] sec2 Pointer to the output buffer where section 2 will be written
-  \param [in] lmax Maximum length permitted for the output buffer
+  \param [in,out] out Growable buffer where section 2 is appended
   \param [in] t Pointer to struct \ref temp_chunks where the parse results are set
 
-  \return Number of characters written to the buffer
+  \return Number of characters appended to the buffer
 */
-size_t print_temp_a_sec2 ( char **sec2, size_t lmax, const struct temp_chunks *t )
+size_t print_temp_a_sec2 ( struct bufr2tac_buffer *out, const struct temp_chunks *t )
 {
   size_t i;
   size_t used = 0;
-  char *c = *sec2;
 
   //Surface level
-  used += snprintf ( c + used, lmax - used, " 99%s", t->a.s2.lev0.PnPnPn );
-  used += snprintf ( c + used, lmax - used, " %s%s", t->a.s2.lev0.TnTnTan, t->a.s2.lev0.DnDn );
-  used += snprintf ( c + used, lmax - used, " %s", t->a.s2.lev0.dndnfnfnfn );
+  used += bufr2tac_buffer_printf ( out, " 99%s", t->a.s2.lev0.PnPnPn );
+  used += bufr2tac_buffer_printf ( out, " %s%s", t->a.s2.lev0.TnTnTan, t->a.s2.lev0.DnDn );
+  used += bufr2tac_buffer_printf ( out, " %s", t->a.s2.lev0.dndnfnfnfn );
 
   for ( i = 0; i < t->a.s2.n ; i++ )
     {
-      used += snprintf ( c + used, lmax - used, " %s%s", t->a.s2.std[i].PnPn, t->a.s2.std[i].hnhnhn );
-      used += snprintf ( c + used, lmax - used, " %s%s", t->a.s2.std[i].TnTnTan, t->a.s2.std[i].DnDn );
-      used += snprintf ( c + used, lmax - used, " %s", t->a.s2.std[i].dndnfnfnfn );
+      used += bufr2tac_buffer_printf ( out, " %s%s", t->a.s2.std[i].PnPn, t->a.s2.std[i].hnhnhn );
+      used += bufr2tac_buffer_printf ( out, " %s%s", t->a.s2.std[i].TnTnTan, t->a.s2.std[i].DnDn );
+      used += bufr2tac_buffer_printf ( out, " %s", t->a.s2.std[i].dndnfnfnfn );
     }
-
-  *sec2 = c + used;
   return used;
 }
 
 /*!
-  \fn size_t print_temp_a_sec3 (char **sec3, size_t lmax, const struct temp_chunks *t)
+  \fn size_t print_temp_a_sec3 ( struct bufr2tac_buffer *out, const struct temp_chunks *t)
   \brief Prints the section 3 of part A of a TEMP report
-  \param [in,out] sec3 Pointer to the output buffer where section 3 will be written
-  \param [in] lmax Maximum length permitted for the output buffer
+  \param [in,out] out Growable buffer where section 3 is appended
   \param [in] t Pointer to struct \ref temp_chunks where the parse results are set
 
-  \return Number of characters written to the buffer
+  \return Number of characters appended to the buffer
 */
-size_t print_temp_a_sec3 ( char **sec3, size_t lmax, const struct temp_chunks *t )
+size_t print_temp_a_sec3 ( struct bufr2tac_buffer *out, const struct temp_chunks *t )
 {
   size_t used = 0;
-  char *c = *sec3;
 
   if ( t->a.s3.n == 0 )
     {
-      used += snprintf ( c + used, lmax - used, " 88999" );
+      used += bufr2tac_buffer_printf ( out, " 88999" );
     }
   else
     {
       for ( size_t i = 0; i < t->a.s3.n ; i++ )
         {
-          used += snprintf ( c + used, lmax - used, " 88%s", t->a.s3.trop[i].PnPnPn );
-          used += snprintf ( c + used, lmax - used, " %s%s", t->a.s3.trop[i].TnTnTan, t->a.s3.trop[i].DnDn );
-          used += snprintf ( c + used, lmax - used, " %s", t->a.s3.trop[i].dndnfnfnfn );
+          used += bufr2tac_buffer_printf ( out, " 88%s", t->a.s3.trop[i].PnPnPn );
+          used += bufr2tac_buffer_printf ( out, " %s%s", t->a.s3.trop[i].TnTnTan, t->a.s3.trop[i].DnDn );
+          used += bufr2tac_buffer_printf ( out, " %s", t->a.s3.trop[i].dndnfnfnfn );
         }
     }
-
-  *sec3 = c + used;
   return used;
 
 }
 
 /*!
-  \fn size_t print_temp_a_sec4 (char **sec4, size_t lmax, const struct temp_chunks *t)
+  \fn size_t print_temp_a_sec4 ( struct bufr2tac_buffer *out, const struct temp_chunks *t)
   \brief Prints the section 4 of part A of a TEMP report
-  \param [in,out] sec4 Pointer to the output buffer where section 4 will be written
-  \param [in] lmax Maximum length permitted for the output buffer
+  \param [in,out] out Growable buffer where section 4 is appended
   \param [in] t Pointer to struct \ref temp_chunks where the parse results are set
 
-  \return Number of characters written to the buffer
+  \return Number of characters appended to the buffer
 */
-size_t print_temp_a_sec4 ( char **sec4, size_t lmax, const struct temp_chunks *t )
+size_t print_temp_a_sec4 ( struct bufr2tac_buffer *out, const struct temp_chunks *t )
 {
   size_t used = 0;
-  char *c = *sec4;
 
   if ( t->a.s4.n == 0 )
     {
-      used += snprintf ( c + used, lmax - used, " 77999" );
+      used += bufr2tac_buffer_printf ( out, " 77999" );
     }
   else
     {
@@ -289,67 +275,60 @@ size_t print_temp_a_sec4 ( char **sec4, size_t lmax, const struct temp_chunks *t
         {
           if ( t->a.s4.windx[i].no_last_wind )
             {
-              used += snprintf ( c + used, lmax - used, " 77%s", t->a.s4.windx[i].PmPmPm );
+              used += bufr2tac_buffer_printf ( out, " 77%s", t->a.s4.windx[i].PmPmPm );
             }
           else
             {
-              used += snprintf ( c + used, lmax - used, " 66%s", t->a.s4.windx[i].PmPmPm );
+              used += bufr2tac_buffer_printf ( out, " 66%s", t->a.s4.windx[i].PmPmPm );
             }
-          used += snprintf ( c + used, lmax - used, " %s", t->a.s4.windx[i].dmdmfmfmfm );
+          used += bufr2tac_buffer_printf ( out, " %s", t->a.s4.windx[i].dmdmfmfmfm );
 
           if ( t->a.s4.windx[i].vbvb[0] && t->a.s4.windx[i].vava[0] )
             {
-              used += snprintf ( c + used, lmax - used, " 4%s%s", t->a.s4.windx[i].vbvb, t->a.s4.windx[i].vava );
+              used += bufr2tac_buffer_printf ( out, " 4%s%s", t->a.s4.windx[i].vbvb, t->a.s4.windx[i].vava );
             }
         }
     }
-
-  *sec4 = c + used;
   return used;
 
 }
 
 /*!
-  \fn size_t print_temp_a_sec7 (char **sec7, size_t lmax, const struct temp_chunks *t)
+  \fn size_t print_temp_a_sec7 ( struct bufr2tac_buffer *out, const struct temp_chunks *t)
   \brief Prints the section 7 of part A of a TEMP report
-  \param [in,out] sec7 Pointer to the output buffer where section 7 will be written
-  \param [in] lmax Maximum length permitted for the output buffer
+  \param [in,out] out Growable buffer where section 7 is appended
   \param [in] t Pointer to struct \ref temp_chunks where the parse results are set
 
-  \return Number of characters written to the buffer
+  \return Number of characters appended to the buffer
 */
-size_t print_temp_a_sec7 ( char **sec7, size_t lmax, const struct temp_chunks *t )
+size_t print_temp_a_sec7 ( struct bufr2tac_buffer *out, const struct temp_chunks *t )
 {
   size_t used = 0;
-  char *c = *sec7;
 
-  used += snprintf ( c + used, lmax - used, " 31313" );
-  used += snprintf ( c + used, lmax - used, " %s%s%s", t->a.s7.sr, t->a.s7.rara, t->a.s7.sasa );
-  used += snprintf ( c + used, lmax - used, " 8%s%s", t->a.s7.GG, t->a.s7.gg );
+  used += bufr2tac_buffer_printf ( out, " 31313" );
+  used += bufr2tac_buffer_printf ( out, " %s%s%s", t->a.s7.sr, t->a.s7.rara, t->a.s7.sasa );
+  used += bufr2tac_buffer_printf ( out, " 8%s%s", t->a.s7.GG, t->a.s7.gg );
 
   if ( t->a.s7.TwTwTw[0] )
     {
-      used += snprintf ( c + used, lmax - used, " 9%s%s", t->a.s7.sn, t->a.s7.TwTwTw );
+      used += bufr2tac_buffer_printf ( out, " 9%s%s", t->a.s7.sn, t->a.s7.TwTwTw );
     }
-
-  *sec7 = c + used;
   return used;
 }
 
 /*!
-  \fn size_t print_temp_a (struct metreport *m )
-  \brief Prints the part A of a TEMP report into a string
+  \fn int print_temp_a (struct metreport *m )
+  \brief Prints the part A of a TEMP report into the buffer tac[0], with alphanum as a copy
   \param [in,out] m Pointer to struct \ref metreport where are both target and source
   
   \return 0 if successful, 1 otherwise
 */
 int print_temp_a (  struct metreport *m )
 {
-  char *c = &(m->alphanum[0]);
-  size_t used = 0;
-  size_t lmax = sizeof(m->alphanum);
+  struct bufr2tac_buffer *out = &m->tac[0];
   const struct temp_chunks *t = &m->temp;
 
+  bufr2tac_buffer_clean ( out );
 
   // Needs time extension
   if ( t->a.e.YYYY[0] == 0  || t->a.e.YYYY[0] == '0')
@@ -359,244 +338,224 @@ int print_temp_a (  struct metreport *m )
 
   if ( m->print_mask & PRINT_BITMASK_WIGOS )
     {
-      used += print_wigos_id ( &c, lmax, m );
+      print_wigos_id ( out, m );
     }
 
   if ( m->print_mask & PRINT_BITMASK_GEO )
     {
-      used += print_geo ( &c, lmax, m );
+      print_geo ( out, m );
     }
 
-  used += print_temp_a_sec1 ( &c, lmax - used, t );
-  used += print_temp_a_sec2 ( &c, lmax - used, t );
-  used += print_temp_a_sec3 ( &c, lmax - used, t );
-  used += print_temp_a_sec4 ( &c, lmax - used, t );
-  used += print_temp_a_sec7 ( &c, lmax - used, t );
-  snprintf ( c, lmax - used, "=" );
+  print_temp_a_sec1 ( out, t );
+  print_temp_a_sec2 ( out, t );
+  print_temp_a_sec3 ( out, t );
+  print_temp_a_sec4 ( out, t );
+  print_temp_a_sec7 ( out, t );
+  bufr2tac_buffer_printf ( out, "=" );
+  bufr2tac_set_alphanum ( m->alphanum, sizeof ( m->alphanum ), out );
   return 0;
 }
 
 /*!
-  \fn size_t print_temp_b_sec1 (char **sec1, size_t lmax, const struct temp_chunks *t)
+  \fn size_t print_temp_b_sec1 ( struct bufr2tac_buffer *out, const struct temp_chunks *t)
   \brief Prints the section 1 of part B of a TEMP report
-  \param [in,out] sec1 Pointer to the output buffer where section 1 will be written
-  \param [in] lmax Maximum length permitted for the output buffer
+  \param [in,out] out Growable buffer where section 1 is appended
   \param [in] t Pointer to struct \ref temp_chunks where the parse results are set
 
-  \return Number of characters written to the buffer
+  \return Number of characters appended to the buffer
 */
-size_t print_temp_b_sec1 ( char **sec1, size_t lmax, const struct temp_chunks *t )
+size_t print_temp_b_sec1 ( struct bufr2tac_buffer *out, const struct temp_chunks *t )
 {
   size_t used = 0;
-  char *c = *sec1;
 
-  used += snprintf ( c + used, lmax - used, "%s", t->t.datime );
+  used += bufr2tac_buffer_printf ( out, "%s", t->t.datime );
 
-  used += snprintf ( c + used, lmax - used, " %s%s", t->b.s1.MiMi, t->b.s1.MjMj );
+  used += bufr2tac_buffer_printf ( out, " %s%s", t->b.s1.MiMi, t->b.s1.MjMj );
 
   if ( t->b.s1.D_D[0] && t->a.s1.II[0] == 0 )
     {
-      used += snprintf ( c + used, lmax - used, " %s", t->b.s1.D_D );
+      used += bufr2tac_buffer_printf ( out, " %s", t->b.s1.D_D );
     }
 
-  used += snprintf ( c + used, lmax - used, " %s%s", t->b.s1.YYGG, t->b.s1.a4 );
+  used += bufr2tac_buffer_printf ( out, " %s%s", t->b.s1.YYGG, t->b.s1.a4 );
 
   // print IIiii
   if ( t->b.s1.II[0] )
     {
-      used += snprintf ( c + used, lmax - used, " %s%s", t->b.s1.II, t->b.s1.iii );
+      used += bufr2tac_buffer_printf ( out, " %s%s", t->b.s1.II, t->b.s1.iii );
     }
   else
     {
       if ( t->b.s1.LaLaLa[0] )
         {
-          used += snprintf ( c + used, lmax - used, " 99%s", t->b.s1.LaLaLa );
+          used += bufr2tac_buffer_printf ( out, " 99%s", t->b.s1.LaLaLa );
         }
       else
         {
-          used += snprintf ( c + used, lmax - used, " 99///" );
+          used += bufr2tac_buffer_printf ( out, " 99///" );
         }
 
       if ( t->b.s1.Qc[0] && t->b.s1.LoLoLoLo[0] )
         {
-          used += snprintf ( c + used, lmax - used, " %s%s", t->b.s1.Qc, t->b.s1.LoLoLoLo );
+          used += bufr2tac_buffer_printf ( out, " %s%s", t->b.s1.Qc, t->b.s1.LoLoLoLo );
         }
       else
         {
-          used += snprintf ( c + used, lmax - used, " /////" );
+          used += bufr2tac_buffer_printf ( out, " /////" );
         }
 
       if ( t->b.s1.MMM[0] && t->b.s1.Ula[0] && t->b.s1.Ulo[0] )
         {
-          used += snprintf ( c + used, lmax - used, " %s%s%s", t->b.s1.MMM, t->b.s1.Ula, t->b.s1.Ulo );
+          used += bufr2tac_buffer_printf ( out, " %s%s%s", t->b.s1.MMM, t->b.s1.Ula, t->b.s1.Ulo );
         }
 
       if ( t->b.s1.h0h0h0h0[0] )
         {
-          used += snprintf ( c + used, lmax - used, " %s%s", t->b.s1.h0h0h0h0, t->b.s1.im );
+          used += bufr2tac_buffer_printf ( out, " %s%s", t->b.s1.h0h0h0h0, t->b.s1.im );
         }
     }
-
-  *sec1= c + used;
   return used;
 }
 
 /*!
-  \fn size_t print_temp_b_sec5 (char **sec5, size_t lmax, const struct temp_chunks *t)
+  \fn size_t print_temp_b_sec5 ( struct bufr2tac_buffer *out, const struct temp_chunks *t)
   \brief Prints the section 5 of part B of a TEMP report
-  \param [in,out] sec5 Pointer to the output buffer where section 5 will be written
-  \param [in] lmax Maximum length permitted for the output buffer
+  \param [in,out] out Growable buffer where section 5 is appended
   \param [in] t Pointer to struct \ref temp_chunks where the parse results are set
 
-  \return Number of characters written to the buffer
+  \return Number of characters appended to the buffer
 */
-size_t print_temp_b_sec5 ( char **sec5, size_t lmax, const struct temp_chunks *t )
+size_t print_temp_b_sec5 ( struct bufr2tac_buffer *out, const struct temp_chunks *t )
 {
   size_t used = 0;
   size_t i;
-  char *c = *sec5;
 
   for ( i = 0; i < t->b.s5.n && i < TEMP_NMAX_POINTS ; i++ )
     {
-      used += snprintf ( c + used, lmax - used, " %s%s", t->b.s5.th[i].nini, t->b.s5.th[i].PnPnPn );
-      used += snprintf ( c + used, lmax - used, " %s%s", t->b.s5.th[i].TnTnTan, t->b.s5.th[i].DnDn );
+      used += bufr2tac_buffer_printf ( out, " %s%s", t->b.s5.th[i].nini, t->b.s5.th[i].PnPnPn );
+      used += bufr2tac_buffer_printf ( out, " %s%s", t->b.s5.th[i].TnTnTan, t->b.s5.th[i].DnDn );
     }
-
-  *sec5 = c + used;
   return used;
 }
 
 /*!
-  \fn size_t print_temp_b_sec6 (char **sec6, size_t lmax, const struct temp_chunks *t)
+  \fn size_t print_temp_b_sec6 ( struct bufr2tac_buffer *out, const struct temp_chunks *t)
   \brief Prints the section 6 of part B of a TEMP report
-  \param [in,out] sec6 Pointer to the output buffer where section 6 will be written
-  \param [in] lmax Maximum length permitted for the output buffer
+  \param [in,out] out Growable buffer where section 6 is appended
   \param [in] t Pointer to struct \ref temp_chunks where the parse results are set
 
-  \return Number of characters written to the buffer
+  \return Number of characters appended to the buffer
 */
-size_t print_temp_b_sec6 ( char **sec6, size_t lmax, const struct temp_chunks *t )
+size_t print_temp_b_sec6 ( struct bufr2tac_buffer *out, const struct temp_chunks *t )
 {
   size_t i;
   size_t used = 0;
-  char *c = *sec6;
 
-  used += snprintf ( c + used, lmax - used, " 21212" );
+  used += bufr2tac_buffer_printf ( out, " 21212" );
 
   for ( i = 0; i < t->b.s6.n && i < TEMP_NMAX_POINTS ; i++ )
     {
-      used += snprintf ( c + used, lmax - used, " %s%s", t->b.s6.wd[i].nini, t->b.s6.wd[i].PnPnPn );
-      used += snprintf ( c + used, lmax - used, " %s", t->b.s6.wd[i].dndnfnfnfn );
+      used += bufr2tac_buffer_printf ( out, " %s%s", t->b.s6.wd[i].nini, t->b.s6.wd[i].PnPnPn );
+      used += bufr2tac_buffer_printf ( out, " %s", t->b.s6.wd[i].dndnfnfnfn );
     }
-
-  *sec6 = c + used;
   return used;
 }
 
 /*!
-  \fn size_t print_temp_b_sec7 (char **sec7, size_t lmax, const struct temp_chunks *t)
+  \fn size_t print_temp_b_sec7 ( struct bufr2tac_buffer *out, const struct temp_chunks *t)
   \brief Prints the section 7 of part B of a TEMP report
-  \param [in,out] sec7 Pointer to the output buffer where section 7 will be written
-  \param [in] lmax Maximum length permitted for the output buffer
+  \param [in,out] out Growable buffer where section 7 is appended
   \param [in] t Pointer to struct \ref temp_chunks where the parse results are set
 
-  \return Number of characters written to the buffer
+  \return Number of characters appended to the buffer
 */
-size_t print_temp_b_sec7 ( char **sec7, size_t lmax, const struct temp_chunks *t )
+size_t print_temp_b_sec7 ( struct bufr2tac_buffer *out, const struct temp_chunks *t )
 {
   size_t used = 0;
-  char *c = *sec7;
 
-  used += snprintf ( c + used, lmax - used, " 31313" );
-  used += snprintf ( c + used, lmax - used, " %s%s%s", t->b.s7.sr, t->b.s7.rara, t->b.s7.sasa );
-  used += snprintf ( c + used, lmax - used, " 8%s%s", t->b.s7.GG, t->b.s7.gg );
+  used += bufr2tac_buffer_printf ( out, " 31313" );
+  used += bufr2tac_buffer_printf ( out, " %s%s%s", t->b.s7.sr, t->b.s7.rara, t->b.s7.sasa );
+  used += bufr2tac_buffer_printf ( out, " 8%s%s", t->b.s7.GG, t->b.s7.gg );
 
   if ( t->b.s7.TwTwTw[0] )
     {
-      used += snprintf ( c + used, lmax - used, " 9%s%s", t->b.s7.sn, t->b.s7.TwTwTw );
+      used += bufr2tac_buffer_printf ( out, " 9%s%s", t->b.s7.sn, t->b.s7.TwTwTw );
     }
-
-  *sec7 = c + used;
   return used;
 }
 
 /*!
-  \fn size_t print_temp_b_sec8 (char **sec8, size_t lmax, const struct temp_chunks *t)
+  \fn size_t print_temp_b_sec8 ( struct bufr2tac_buffer *out, const struct temp_chunks *t)
   \brief Prints the section 8 of part B of a TEMP report
-  \param [in,out] sec8 Pointer to the output buffer where section 8 will be written
-  \param [in] lmax Maximum length permitted for the output buffer
+  \param [in,out] out Growable buffer where section 8 is appended
   \param [in] t Pointer to struct \ref temp_chunks where the parse results are set
 
-  \return Number of characters written to the buffer
+  \return Number of characters appended to the buffer
 */
-size_t print_temp_b_sec8 ( char **sec8, size_t lmax, const struct temp_chunks *t )
+size_t print_temp_b_sec8 ( struct bufr2tac_buffer *out, const struct temp_chunks *t )
 {
   size_t used = 0;
-  char *c = *sec8;
 
   if ( t->b.s8.h[0] )
     {
-      used += snprintf ( c + used, lmax - used, " 41414 " );
+      used += bufr2tac_buffer_printf ( out, " 41414 " );
       if ( t->b.s8.Nh[0] )
         {
-          used += snprintf ( c + used, lmax - used, "%s", t->b.s8.Nh );
+          used += bufr2tac_buffer_printf ( out, "%s", t->b.s8.Nh );
         }
       else
         {
-          used += snprintf ( c + used, lmax - used, "/" );
+          used += bufr2tac_buffer_printf ( out, "/" );
         }
 
       if ( t->b.s8.Cl[0] )
         {
-          used += snprintf ( c + used, lmax - used, "%s", t->b.s8.Cl );
+          used += bufr2tac_buffer_printf ( out, "%s", t->b.s8.Cl );
         }
       else
         {
-          used += snprintf ( c + used, lmax - used, "/" );
+          used += bufr2tac_buffer_printf ( out, "/" );
         }
 
-      used += snprintf ( c + used, lmax - used, "%s", t->b.s8.h );
+      used += bufr2tac_buffer_printf ( out, "%s", t->b.s8.h );
 
       if ( t->b.s8.Cm[0] )
         {
-          used += snprintf ( c + used, lmax - used, "%s", t->b.s8.Cm );
+          used += bufr2tac_buffer_printf ( out, "%s", t->b.s8.Cm );
         }
       else
         {
-          used += snprintf ( c + used, lmax - used, "/" );
+          used += bufr2tac_buffer_printf ( out, "/" );
         }
 
       if ( t->b.s8.Ch[0] )
         {
-          used += snprintf ( c + used, lmax - used, "%s", t->b.s8.Ch );
+          used += bufr2tac_buffer_printf ( out, "%s", t->b.s8.Ch );
         }
       else
         {
-          used += snprintf ( c + used, lmax - used, "/" );
+          used += bufr2tac_buffer_printf ( out, "/" );
         }
 
-      //used += snprintf ( c + used, lmax - used, " %s%s%s%s%s", t->b.s8.Nh, t->b.s8.Cl, t->b.s8.h, t->b.s8.Cm, t->b.s8.Ch );
+      //used += bufr2tac_buffer_printf ( out, " %s%s%s%s%s", t->b.s8.Nh, t->b.s8.Cl, t->b.s8.h, t->b.s8.Cm, t->b.s8.Ch );
     }
-
-  *sec8 = c + used;
   return used;
 }
 
 
 /*!
   \fn int print_temp_b (struct metreport *m )
-  \brief Prints the part B of a TEMP report into a string
+  \brief Prints the part B of a TEMP report into the buffer tac[1], with alphanum2 as a copy
   \param [in,out] m Pointer to struct \ref metreport where are both target and source
 
   \return 0 if successful, 1 otherwise
  */
 int print_temp_b ( struct metreport *m )
 {
-  char *c = &(m->alphanum2[0]);
-  size_t used = 0;
-  size_t lmax = sizeof(m->alphanum);
+  struct bufr2tac_buffer *out = &m->tac[1];
   const struct temp_chunks *t = &m->temp;
 
+  bufr2tac_buffer_clean ( out );
 
   // Needs time extension
   if ( t->b.e.YYYY[0] == 0  || t->b.e.YYYY[0] == '0')
@@ -606,166 +565,153 @@ int print_temp_b ( struct metreport *m )
 
   if ( m->print_mask & PRINT_BITMASK_WIGOS )
     {
-      used += print_wigos_id ( &c, lmax, m );
+      print_wigos_id ( out, m );
     }
 
   if ( m->print_mask & PRINT_BITMASK_GEO )
     {
-      used += print_geo ( &c, lmax, m );
+      print_geo ( out, m );
     }
 
-  used += print_temp_b_sec1 ( &c, lmax - used, t );
-  used += print_temp_b_sec5 ( &c, lmax - used, t );
-  used += print_temp_b_sec6 ( &c, lmax - used, t );
-  used += print_temp_b_sec7 ( &c, lmax - used, t );
-  used += print_temp_b_sec8 ( &c, lmax - used, t );
-  snprintf ( c, lmax - used, "=" );
+  print_temp_b_sec1 ( out, t );
+  print_temp_b_sec5 ( out, t );
+  print_temp_b_sec6 ( out, t );
+  print_temp_b_sec7 ( out, t );
+  print_temp_b_sec8 ( out, t );
+  bufr2tac_buffer_printf ( out, "=" );
+  bufr2tac_set_alphanum ( m->alphanum2, sizeof ( m->alphanum2 ), out );
   return 0;
 }
 
 
 /*!
-  \fn size_t print_temp_c_sec1 (char **sec1, size_t lmax, const struct temp_chunks *t)
+  \fn size_t print_temp_c_sec1 ( struct bufr2tac_buffer *out, const struct temp_chunks *t)
   \brief Prints the section 1 of part C of a TEMP report
-  \param [in,out] sec1 Pointer to the output buffer where section 1 will be written
-  \param [in] lmax Maximum length permitted for the output buffer
+  \param [in,out] out Growable buffer where section 1 is appended
   \param [in] t Pointer to struct \ref temp_chunks where the parse results are set
 
-  \return Number of characters written to the buffer
+  \return Number of characters appended to the buffer
 */
-size_t print_temp_c_sec1 ( char **sec1, size_t lmax, const struct temp_chunks *t )
+size_t print_temp_c_sec1 ( struct bufr2tac_buffer *out, const struct temp_chunks *t )
 {
   size_t used = 0;
-  char *c = *sec1;
 
-  used += snprintf ( c + used, lmax - used, "%s", t->t.datime );
+  used += bufr2tac_buffer_printf ( out, "%s", t->t.datime );
 
-  used += snprintf ( c + used, lmax - used, " %s%s", t->c.s1.MiMi, t->c.s1.MjMj );
+  used += bufr2tac_buffer_printf ( out, " %s%s", t->c.s1.MiMi, t->c.s1.MjMj );
 
   if ( t->c.s1.D_D[0] && t->a.s1.II[0] == 0 )
     {
-      used += snprintf ( c + used, lmax - used, " %s", t->c.s1.D_D );
+      used += bufr2tac_buffer_printf ( out, " %s", t->c.s1.D_D );
     }
 
-  used += snprintf ( c + used, lmax - used, " %s%s", t->c.s1.YYGG, t->c.s1.id );
+  used += bufr2tac_buffer_printf ( out, " %s%s", t->c.s1.YYGG, t->c.s1.id );
 
   // print IIiii
   if ( t->c.s1.II[0] )
     {
-      used += snprintf ( c + used, lmax - used, " %s%s", t->c.s1.II, t->c.s1.iii );
+      used += bufr2tac_buffer_printf ( out, " %s%s", t->c.s1.II, t->c.s1.iii );
     }
   else
     {
       if ( t->c.s1.LaLaLa[0] )
         {
-          used += snprintf ( c + used, lmax - used, " 99%s", t->c.s1.LaLaLa );
+          used += bufr2tac_buffer_printf ( out, " 99%s", t->c.s1.LaLaLa );
         }
       else
         {
-          used += snprintf ( c + used, lmax - used, " 99///" );
+          used += bufr2tac_buffer_printf ( out, " 99///" );
         }
 
       if ( t->c.s1.Qc[0] && t->c.s1.LoLoLoLo[0] )
         {
-          used += snprintf ( c + used, lmax - used, " %s%s", t->c.s1.Qc, t->c.s1.LoLoLoLo );
+          used += bufr2tac_buffer_printf ( out, " %s%s", t->c.s1.Qc, t->c.s1.LoLoLoLo );
         }
       else
         {
-          used += snprintf ( c + used, lmax - used, " /////" );
+          used += bufr2tac_buffer_printf ( out, " /////" );
         }
 
       if ( t->c.s1.MMM[0] && t->c.s1.Ula[0] && t->c.s1.Ulo[0] )
         {
-          used += snprintf ( c + used, lmax - used, " %s%s%s", t->c.s1.MMM, t->c.s1.Ula, t->c.s1.Ulo );
+          used += bufr2tac_buffer_printf ( out, " %s%s%s", t->c.s1.MMM, t->c.s1.Ula, t->c.s1.Ulo );
         }
 
       if ( t->c.s1.h0h0h0h0[0] )
         {
-          used += snprintf ( c + used, lmax - used, " %s%s", t->c.s1.h0h0h0h0, t->c.s1.im );
+          used += bufr2tac_buffer_printf ( out, " %s%s", t->c.s1.h0h0h0h0, t->c.s1.im );
         }
     }
-
-  *sec1 = c + used;
   return used;
 }
 
 /*!
-  \fn size_t print_temp_c_sec2 (char **sec2, size_t lmax, const struct temp_chunks *t)
+  \fn size_t print_temp_c_sec2 ( struct bufr2tac_buffer *out, const struct temp_chunks *t)
   \brief Prints the section 2 of part C of a TEMP report
-  \param [in,out] sec2 Pointer to the output buffer where section 2 will be written
-  \param [in] lmax Maximum length permitted for the output buffer
+  \param [in,out] out Growable buffer where section 2 is appended
   \param [in] t Pointer to struct \ref temp_chunks where the parse results are set
 
-  \return Number of characters written to the buffer
+  \return Number of characters appended to the buffer
 */
-size_t print_temp_c_sec2 ( char **sec2, size_t lmax, const struct temp_chunks *t )
+size_t print_temp_c_sec2 ( struct bufr2tac_buffer *out, const struct temp_chunks *t )
 {
   size_t i;
   size_t used = 0;
-  char *c = *sec2;
 
   for ( i = 0; i < t->c.s2.n ; i++ )
     {
-      used += snprintf ( c + used, lmax - used, " %s%s", t->c.s2.std[i].PnPn, t->c.s2.std[i].hnhnhn );
-      used += snprintf ( c + used, lmax - used, " %s%s", t->c.s2.std[i].TnTnTan, t->c.s2.std[i].DnDn );
-      used += snprintf ( c + used, lmax - used, " %s", t->c.s2.std[i].dndnfnfnfn );
+      used += bufr2tac_buffer_printf ( out, " %s%s", t->c.s2.std[i].PnPn, t->c.s2.std[i].hnhnhn );
+      used += bufr2tac_buffer_printf ( out, " %s%s", t->c.s2.std[i].TnTnTan, t->c.s2.std[i].DnDn );
+      used += bufr2tac_buffer_printf ( out, " %s", t->c.s2.std[i].dndnfnfnfn );
     }
-
-  *sec2 = c + used;
   return used;
 
 }
 
 /*!
-  \fn size_t print_temp_c_sec3 (char **sec3, size_t lmax, const struct temp_chunks *t)
+  \fn size_t print_temp_c_sec3 ( struct bufr2tac_buffer *out, const struct temp_chunks *t)
   \brief Prints the section 3 of part C of a TEMP report
-  \param [in,out] sec3 Pointer to the output buffer where section 3 will be written
-  \param [in] lmax Maximum length permitted for the output buffer
+  \param [in,out] out Growable buffer where section 3 is appended
   \param [in] t Pointer to struct \ref temp_chunks where the parse results are set
 
-  \return Number of characters written to the buffer
+  \return Number of characters appended to the buffer
 */
-size_t print_temp_c_sec3 ( char **sec3, size_t lmax, const struct temp_chunks *t )
+size_t print_temp_c_sec3 ( struct bufr2tac_buffer *out, const struct temp_chunks *t )
 {
   size_t used = 0;
-  char *c = *sec3;
 
   if ( t->c.s3.n == 0 )
     {
-      used += snprintf ( c + used, lmax - used, " 88999" );
+      used += bufr2tac_buffer_printf ( out, " 88999" );
     }
   else
     {
       for ( size_t i = 0; i < t->c.s3.n ; i++ )
         {
-          used += snprintf ( c + used, lmax - used, " 88%s", t->c.s3.trop[i].PnPnPn );
-          used += snprintf ( c + used, lmax - used, " %s%s", t->c.s3.trop[i].TnTnTan, t->c.s3.trop[i].DnDn );
-          used += snprintf ( c + used, lmax - used, " %s", t->c.s3.trop[i].dndnfnfnfn );
+          used += bufr2tac_buffer_printf ( out, " 88%s", t->c.s3.trop[i].PnPnPn );
+          used += bufr2tac_buffer_printf ( out, " %s%s", t->c.s3.trop[i].TnTnTan, t->c.s3.trop[i].DnDn );
+          used += bufr2tac_buffer_printf ( out, " %s", t->c.s3.trop[i].dndnfnfnfn );
         }
     }
-
-  *sec3 = c + used;
   return used;
 
 }
 
 /*!
-  \fn size_t print_temp_c_sec4 (char **sec4, size_t lmax, const struct temp_chunks *t)
+  \fn size_t print_temp_c_sec4 ( struct bufr2tac_buffer *out, const struct temp_chunks *t)
   \brief Prints the section 4 of part C of a TEMP report
-  \param [in,out] sec4 Pointer to the output buffer where section 4 will be written
-  \param [in] lmax Maximum length permitted for the output buffer
+  \param [in,out] out Growable buffer where section 4 is appended
   \param [in] t Pointer to struct \ref temp_chunks where the parse results are set
 
-  \return Number of characters written to the buffer
+  \return Number of characters appended to the buffer
 */
-size_t print_temp_c_sec4 ( char **sec4, size_t lmax, const struct temp_chunks *t )
+size_t print_temp_c_sec4 ( struct bufr2tac_buffer *out, const struct temp_chunks *t )
 {
   size_t used = 0;
-  char *c = *sec4;
 
   if ( t->c.s4.n == 0 )
     {
-      used += snprintf ( c + used, lmax - used, " 77999" );
+      used += bufr2tac_buffer_printf ( out, " 77999" );
     }
   else
     {
@@ -773,66 +719,59 @@ size_t print_temp_c_sec4 ( char **sec4, size_t lmax, const struct temp_chunks *t
         {
           if ( t->c.s4.windx[i].no_last_wind )
             {
-              used += snprintf ( c + used, lmax - used, " 77%s", t->c.s4.windx[i].PmPmPm );
+              used += bufr2tac_buffer_printf ( out, " 77%s", t->c.s4.windx[i].PmPmPm );
             }
           else
             {
-              used += snprintf ( c + used, lmax - used, " 66%s", t->c.s4.windx[i].PmPmPm );
+              used += bufr2tac_buffer_printf ( out, " 66%s", t->c.s4.windx[i].PmPmPm );
             }
-          used += snprintf ( c + used, lmax - used, " %s", t->c.s4.windx[i].dmdmfmfmfm );
+          used += bufr2tac_buffer_printf ( out, " %s", t->c.s4.windx[i].dmdmfmfmfm );
           if ( t->c.s4.windx[i].vbvb[0] && t->c.s4.windx[i].vava[0] )
             {
-              used += snprintf ( c + used, lmax - used, " 4%s%s", t->c.s4.windx[i].vbvb, t->c.s4.windx[i].vava );
+              used += bufr2tac_buffer_printf ( out, " 4%s%s", t->c.s4.windx[i].vbvb, t->c.s4.windx[i].vava );
             }
         }
     }
-
-  *sec4 = c + used;
   return used;
 
 }
 
 /*!
-  \fn size_t print_temp_c_sec7 (char **sec7, size_t lmax, const struct temp_chunks *t)
+  \fn size_t print_temp_c_sec7 ( struct bufr2tac_buffer *out, const struct temp_chunks *t)
   \brief Prints the section 7 of part C of a TEMP report
-  \param [in,out] sec7 Pointer to the output buffer where section 7 will be written
-  \param [in] lmax Maximum length permitted for the output buffer
+  \param [in,out] out Growable buffer where section 7 is appended
   \param [in] t Pointer to struct \ref temp_chunks where the parse results are set
 
-  \return Number of characters written to the buffer
+  \return Number of characters appended to the buffer
 */
-size_t print_temp_c_sec7 ( char **sec7, size_t lmax, const struct temp_chunks *t )
+size_t print_temp_c_sec7 ( struct bufr2tac_buffer *out, const struct temp_chunks *t )
 {
   size_t used = 0;
-  char *c = *sec7;
 
-  used += snprintf ( c + used, lmax - used, " 31313" );
-  used += snprintf ( c + used, lmax - used, " %s%s%s", t->c.s7.sr, t->c.s7.rara, t->c.s7.sasa );
-  used += snprintf ( c + used, lmax - used, " 8%s%s", t->c.s7.GG, t->c.s7.gg );
+  used += bufr2tac_buffer_printf ( out, " 31313" );
+  used += bufr2tac_buffer_printf ( out, " %s%s%s", t->c.s7.sr, t->c.s7.rara, t->c.s7.sasa );
+  used += bufr2tac_buffer_printf ( out, " 8%s%s", t->c.s7.GG, t->c.s7.gg );
 
   if ( t->c.s7.TwTwTw[0] )
     {
-      used += snprintf ( c + used, lmax - used, " 9%s%s", t->c.s7.sn, t->c.s7.TwTwTw );
+      used += bufr2tac_buffer_printf ( out, " 9%s%s", t->c.s7.sn, t->c.s7.TwTwTw );
     }
-
-  *sec7 = c + used;
   return used;
 }
 
 /*!
   \fn int print_temp_c (struct metreport *m )
-  \brief Prints the part C of a TEMP report into a string
+  \brief Prints the part C of a TEMP report into the buffer tac[2], with alphanum3 as a copy
   \param [in,out] m Pointer to struct \ref metreport where are both target and source
 
   \return 0 if successful, 1 otherwise
 */
 int print_temp_c ( struct metreport *m )
 {
-  char *c = &(m->alphanum3[0]);
-  size_t used = 0;
-  size_t lmax = sizeof(m->alphanum);
+  struct bufr2tac_buffer *out = &m->tac[2];
   const struct temp_chunks *t = &m->temp;
 
+  bufr2tac_buffer_clean ( out );
 
   // Needs time extension
   if ( t->c.e.YYYY[0] == 0  || t->c.e.YYYY[0] == '0')
@@ -842,181 +781,166 @@ int print_temp_c ( struct metreport *m )
 
   if ( m->print_mask & PRINT_BITMASK_WIGOS )
     {
-      used += print_wigos_id ( &c, lmax, m );
+      print_wigos_id ( out, m );
     }
 
   if ( m->print_mask & PRINT_BITMASK_GEO )
     {
-      used += print_geo ( &c, lmax, m );
+      print_geo ( out, m );
     }
 
-  used += print_temp_c_sec1 ( &c, lmax - used, t );
-  used += print_temp_c_sec2 ( &c, lmax - used, t );
-  used += print_temp_c_sec3 ( &c, lmax - used, t );
-  used += print_temp_c_sec4 ( &c, lmax - used, t );
-  used += print_temp_c_sec7 ( &c, lmax - used, t );
-  snprintf ( c, lmax - used, "=" );
+  print_temp_c_sec1 ( out, t );
+  print_temp_c_sec2 ( out, t );
+  print_temp_c_sec3 ( out, t );
+  print_temp_c_sec4 ( out, t );
+  print_temp_c_sec7 ( out, t );
+  bufr2tac_buffer_printf ( out, "=" );
+  bufr2tac_set_alphanum ( m->alphanum3, sizeof ( m->alphanum3 ), out );
   return 0;
 }
 
 /*!
-  \fn size_t print_temp_d_sec1 (char **sec1, size_t lmax, const struct temp_chunks *t)
+  \fn size_t print_temp_d_sec1 ( struct bufr2tac_buffer *out, const struct temp_chunks *t)
   \brief Prints the section 1 of part D of a TEMP report
-  \param [in,out] sec1 Pointer to the output buffer where section 1 will be written
-  \param [in] lmax Maximum length permitted for the output buffer
+  \param [in,out] out Growable buffer where section 1 is appended
   \param [in] t Pointer to struct \ref temp_chunks where the parse results are set
 
-  \return Number of characters written to the buffer
+  \return Number of characters appended to the buffer
 */
-size_t print_temp_d_sec1 ( char **sec1, size_t lmax, const struct temp_chunks *t )
+size_t print_temp_d_sec1 ( struct bufr2tac_buffer *out, const struct temp_chunks *t )
 {
   size_t used = 0;
-  char *c = *sec1;
 
-  used += snprintf ( c + used, lmax - used, "%s", t->t.datime );
+  used += bufr2tac_buffer_printf ( out, "%s", t->t.datime );
 
-  used += snprintf ( c + used, lmax - used, " %s%s", t->d.s1.MiMi, t->d.s1.MjMj );
+  used += bufr2tac_buffer_printf ( out, " %s%s", t->d.s1.MiMi, t->d.s1.MjMj );
 
   if ( t->d.s1.D_D[0] && t->a.s1.II[0] == 0 )
     {
-      used += snprintf ( c + used, lmax - used, " %s", t->d.s1.D_D );
+      used += bufr2tac_buffer_printf ( out, " %s", t->d.s1.D_D );
     }
 
-  used += snprintf ( c + used, lmax - used, " %s/", t->d.s1.YYGG );
+  used += bufr2tac_buffer_printf ( out, " %s/", t->d.s1.YYGG );
 
   // print IIiii
   if ( t->d.s1.II[0] )
     {
-      used += snprintf ( c + used, lmax - used, " %s%s", t->d.s1.II, t->d.s1.iii );
+      used += bufr2tac_buffer_printf ( out, " %s%s", t->d.s1.II, t->d.s1.iii );
     }
   else
     {
       if ( t->d.s1.LaLaLa[0] )
         {
-          used += snprintf ( c + used, lmax - used, " 99%s", t->d.s1.LaLaLa );
+          used += bufr2tac_buffer_printf ( out, " 99%s", t->d.s1.LaLaLa );
         }
       else
         {
-          used += snprintf ( c + used, lmax - used, " 99///" );
+          used += bufr2tac_buffer_printf ( out, " 99///" );
         }
 
       if ( t->d.s1.Qc[0] && t->d.s1.LoLoLoLo[0] )
         {
-          used += snprintf ( c + used, lmax - used, " %s%s", t->d.s1.Qc, t->d.s1.LoLoLoLo );
+          used += bufr2tac_buffer_printf ( out, " %s%s", t->d.s1.Qc, t->d.s1.LoLoLoLo );
         }
       else
         {
-          used += snprintf ( c + used, lmax - used, " /////" );
+          used += bufr2tac_buffer_printf ( out, " /////" );
         }
 
       if ( t->d.s1.MMM[0] && t->d.s1.Ula[0] && t->d.s1.Ulo[0] )
         {
-          used += snprintf ( c + used, lmax - used, " %s%s%s", t->d.s1.MMM, t->d.s1.Ula, t->d.s1.Ulo );
+          used += bufr2tac_buffer_printf ( out, " %s%s%s", t->d.s1.MMM, t->d.s1.Ula, t->d.s1.Ulo );
         }
 
       if ( t->d.s1.h0h0h0h0[0] )
         {
-          used += snprintf ( c + used, lmax - used, " %s%s", t->d.s1.h0h0h0h0, t->d.s1.im );
+          used += bufr2tac_buffer_printf ( out, " %s%s", t->d.s1.h0h0h0h0, t->d.s1.im );
         }
     }
-
-  *sec1 = c + used;
   return used;
 }
 
 /*!
-  \fn size_t print_temp_d_sec5 (char **sec5, size_t lmax, const struct temp_chunks *t)
+  \fn size_t print_temp_d_sec5 ( struct bufr2tac_buffer *out, const struct temp_chunks *t)
   \brief Prints the section 5 of part D of a TEMP report
-  \param [in,out] sec5 Pointer to the output buffer where section 5 will be written
-  \param [in] lmax Maximum length permitted for the output buffer
+  \param [in,out] out Growable buffer where section 5 is appended
   \param [in] t Pointer to struct \ref temp_chunks where the parse results are set
 
-  \return Number of characters written to the buffer
+  \return Number of characters appended to the buffer
 */
-size_t print_temp_d_sec5 ( char **sec5, size_t lmax, const struct temp_chunks *t )
+size_t print_temp_d_sec5 ( struct bufr2tac_buffer *out, const struct temp_chunks *t )
 {
   size_t i;
   size_t used = 0;
-  char *c = *sec5;
 
   for ( i = 0; i < t->d.s5.n && i < TEMP_NMAX_POINTS ; i++ )
     {
-      used += snprintf ( c + used, lmax - used, " %s%s", t->d.s5.th[i].nini, t->d.s5.th[i].PnPnPn );
-      used += snprintf ( c + used, lmax - used, " %s%s", t->d.s5.th[i].TnTnTan, t->d.s5.th[i].DnDn );
+      used += bufr2tac_buffer_printf ( out, " %s%s", t->d.s5.th[i].nini, t->d.s5.th[i].PnPnPn );
+      used += bufr2tac_buffer_printf ( out, " %s%s", t->d.s5.th[i].TnTnTan, t->d.s5.th[i].DnDn );
     }
-
-  *sec5 = c + used;
   return used;
 }
 
 /*!
-  \fn size_t print_temp_d_sec6 (char **sec6, size_t lmax, const struct temp_chunks *t)
+  \fn size_t print_temp_d_sec6 ( struct bufr2tac_buffer *out, const struct temp_chunks *t)
   \brief Prints the section 6 of part D of a TEMP report
-  \param [in,out] sec6 Pointer to the output buffer where section 6 will be written
-  \param [in] lmax Maximum length permitted for the output buffer
+  \param [in,out] out Growable buffer where section 6 is appended
   \param [in] t Pointer to struct \ref temp_chunks where the parse results are set
 
-  \return Number of characters written to the buffer
+  \return Number of characters appended to the buffer
 */
-size_t print_temp_d_sec6 ( char **sec6, size_t lmax, const struct temp_chunks *t )
+size_t print_temp_d_sec6 ( struct bufr2tac_buffer *out, const struct temp_chunks *t )
 {
   size_t i;
   size_t used = 0;
-  char *c = *sec6;
 
-  used += snprintf ( c + used, lmax - used, " 21212" );
+  used += bufr2tac_buffer_printf ( out, " 21212" );
 
   for ( i = 0; i < t->d.s6.n && i < TEMP_NMAX_POINTS ; i++ )
     {
-      used += snprintf ( c + used, lmax - used, " %s%s", t->d.s6.wd[i].nini, t->d.s6.wd[i].PnPnPn );
-      used += snprintf ( c + used, lmax - used, " %s", t->d.s6.wd[i].dndnfnfnfn );
+      used += bufr2tac_buffer_printf ( out, " %s%s", t->d.s6.wd[i].nini, t->d.s6.wd[i].PnPnPn );
+      used += bufr2tac_buffer_printf ( out, " %s", t->d.s6.wd[i].dndnfnfnfn );
     }
-
-  *sec6 = c + used;
   return used;
 }
 
 /*!
-  \fn size_t print_temp_d_sec7 (char **sec7, size_t lmax, const struct temp_chunks *t)
+  \fn size_t print_temp_d_sec7 ( struct bufr2tac_buffer *out, const struct temp_chunks *t)
   \brief Prints the section 7 of part D of a TEMP report
-  \param [in,out] sec7 Pointer to the output buffer where section 7 will be written
-  \param [in] lmax Maximum length permitted for the output buffer
+  \param [in,out] out Growable buffer where section 7 is appended
   \param [in] t Pointer to struct \ref temp_chunks where the parse results are set
 
-  \return Number of characters written to the buffer
+  \return Number of characters appended to the buffer
 */
-size_t print_temp_d_sec7 ( char **sec7, size_t lmax, const struct temp_chunks *t )
+size_t print_temp_d_sec7 ( struct bufr2tac_buffer *out, const struct temp_chunks *t )
 {
   size_t used = 0;
-  char *c = *sec7;
 
-  used += snprintf ( c + used, lmax - used, " 31313" );
-  used += snprintf ( c + used, lmax - used, " %s%s%s", t->d.s7.sr, t->d.s7.rara, t->d.s7.sasa );
-  used += snprintf ( c + used, lmax - used, " 8%s%s", t->d.s7.GG, t->d.s7.gg );
+  used += bufr2tac_buffer_printf ( out, " 31313" );
+  used += bufr2tac_buffer_printf ( out, " %s%s%s", t->d.s7.sr, t->d.s7.rara, t->d.s7.sasa );
+  used += bufr2tac_buffer_printf ( out, " 8%s%s", t->d.s7.GG, t->d.s7.gg );
 
   if ( t->d.s7.TwTwTw[0] )
     {
-      used += snprintf ( c + used, lmax - used, " 9%s%s", t->d.s7.sn, t->d.s7.TwTwTw );
+      used += bufr2tac_buffer_printf ( out, " 9%s%s", t->d.s7.sn, t->d.s7.TwTwTw );
     }
-
-  *sec7 = c + used;
   return used;
 }
 
 /*!
   \fn int print_temp_d (struct metreport *m)
-  \brief Prints the part D of a TEMP report into a string
+  \brief Prints the part D of a TEMP report into the buffer tac[3], with alphanum4 as a copy
   \param [in,out] m Pointer to struct \ref metreport where are both target and source
 
   \return 0 if successful, 1 otherwise
 */
 int print_temp_d ( struct metreport *m )
 {
-  char *c = &(m->alphanum4[0]);
-  size_t used = 0;
-  size_t lmax = sizeof(m->alphanum);
+  struct bufr2tac_buffer *out = &m->tac[3];
   struct temp_chunks *t = &m->temp;
 
+  bufr2tac_buffer_clean ( out );
+
   // Needs time extension
   if ( t->d.e.YYYY[0] == 0  || t->d.e.YYYY[0] == '0')
     {
@@ -1025,26 +949,27 @@ int print_temp_d ( struct metreport *m )
 
   if ( m->print_mask & PRINT_BITMASK_WIGOS )
     {
-      used += print_wigos_id ( &c, lmax, m );
+      print_wigos_id ( out, m );
     }
 
   if ( m->print_mask & PRINT_BITMASK_GEO )
     {
-      used += print_geo ( &c, lmax, m );
+      print_geo ( out, m );
     }
 
-  used += print_temp_d_sec1 ( &c, lmax - used, t );
-  used += print_temp_d_sec5 ( &c, lmax - used, t );
-  used += print_temp_d_sec6 ( &c, lmax - used, t );
-  used += print_temp_d_sec7 ( &c, lmax - used, t );
-  snprintf ( c, lmax - used, "=" );
+  print_temp_d_sec1 ( out, t );
+  print_temp_d_sec5 ( out, t );
+  print_temp_d_sec6 ( out, t );
+  print_temp_d_sec7 ( out, t );
+  bufr2tac_buffer_printf ( out, "=" );
+  bufr2tac_set_alphanum ( m->alphanum4, sizeof ( m->alphanum4 ), out );
   return 0;
 }
 
 /*!
    \fn int print_temp_report ( struct metreport *m )
-   \brief Print the four parts of a decoded TEMP report from a BUFR file into strings
-   \param [in,out] m Pointer to struct \ref metreport in which alphanumeric string members stores the results
+   \brief Print the four parts of a decoded TEMP report from a BUFR file into the buffers tac[0..3]
+   \param [in,out] m Pointer to struct \ref metreport in which the tac buffers store the results
    
    \return 0 if successful, 1 otherwise
 */
@@ -0,0 +1,256 @@
+/***************************************************************************
+ *   Copyright (C) 2013-2026 by Guillermo Ballester Valor                  *
+ *   gbv@ogimet.com                                                        *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.             *
+ ***************************************************************************/
+/*!
+ \file bufr2tac_render_cache.c
+ \brief This file has the code of the bounded LRU cache of rendered reports
+
+ Entries are in a hash table to find them and in a double linked list ordered by use, so the least recently used is
+ the first freed when a limit is reached
+*/
+#include "bufr2tac.h"
+
+/*!
+  \fn static size_t bufr2tac_render_cache_bucket(const struct bufr2tac_render_cache* c, uint64_t hash, uint32_t subset, int format)
+  \brief Index in hash table of a key
+*/
+static size_t bufr2tac_render_cache_bucket(const struct bufr2tac_render_cache* c, uint64_t hash, uint32_t subset,
+    int format)
+{
+    uint64_t k = hash ^ ((uint64_t)subset * 0x9E3779B97F4A7C15ULL) ^ ((uint64_t)format << 56);
+
+    k ^= k >> 29;
+    return (size_t)(k ^ (k >> 32)) & (c->nbuckets - 1);
+}
+
+/*!
+  \fn static void bufr2tac_render_cache_unlink(struct bufr2tac_render_cache* c, struct bufr2tac_render_entry* e)
+  \brief Remove an entry from the list ordered by use
+*/
+static void bufr2tac_render_cache_unlink(struct bufr2tac_render_cache* c, struct bufr2tac_render_entry* e)
+{
+    if (e->prev != NULL)
+        e->prev->next = e->next;
+    else
+        c->first = e->next;
+    if (e->next != NULL)
+        e->next->prev = e->prev;
+    else
+        c->last = e->prev;
+    e->prev = e->next = NULL;
+}
+
+/*!
+  \fn static void bufr2tac_render_cache_push(struct bufr2tac_render_cache* c, struct bufr2tac_render_entry* e)
+  \brief Set an entry as the most recently used
+*/
+static void bufr2tac_render_cache_push(struct bufr2tac_render_cache* c, struct bufr2tac_render_entry* e)
+{
+    e->prev = NULL;
+    e->next = c->first;
+    if (c->first != NULL)
+        c->first->prev = e;
+    else
+        c->last = e;
+    c->first = e;
+}
+
+/*!
+  \fn static void bufr2tac_render_cache_remove(struct bufr2tac_render_cache* c, struct bufr2tac_render_entry* e)
+  \brief Remove an entry from cache and free it
+*/
+static void bufr2tac_render_cache_remove(struct bufr2tac_render_cache* c, struct bufr2tac_render_entry* e)
+{
+    struct bufr2tac_render_entry** p;
+
+    p = &c->bucket[bufr2tac_render_cache_bucket(c, e->hash, e->subset, e->format)];
+    while (*p != e)
+        p = &(*p)->chain;
+    *p = e->chain;
+
+    bufr2tac_render_cache_unlink(c, e);
+    c->nentries--;
+    c->bytes -= e->len;
+    free(e->data);
+    free(e);
+}
+
+/*!
+  \fn int bufr2tac_render_cache_init(struct bufr2tac_render_cache* c, size_t max_entries, size_t max_bytes)
+  \brief Init a struct \ref bufr2tac_render_cache
+  \param [out] c Pointer to the cache
+  \param [in] max_entries Max number of entries. If 0 then \ref BUFR2TAC_RENDER_CACHE_DEFAULT_ENTRIES
+  \param [in] max_bytes Max bytes of rendered texts. If 0 then \ref BUFR2TAC_RENDER_CACHE_DEFAULT_BYTES
+  \return 0 on success, 1 on error
+*/
+int bufr2tac_render_cache_init(struct bufr2tac_render_cache* c, size_t max_entries, size_t max_bytes)
+{
+    memset(c, 0, sizeof(struct bufr2tac_render_cache));
+    c->max_entries = max_entries ? max_entries : BUFR2TAC_RENDER_CACHE_DEFAULT_ENTRIES;
+    c->max_bytes = max_bytes ? max_bytes : BUFR2TAC_RENDER_CACHE_DEFAULT_BYTES;
+
+    // About one entry per bucket when full
+    for (c->nbuckets = 16; c->nbuckets < c->max_entries && c->nbuckets < (1U << 24); c->nbuckets <<= 1)
+        ;
+    if ((c->bucket = calloc(c->nbuckets, sizeof(struct bufr2tac_render_entry*))) == NULL) {
+        c->nbuckets = 0;
+        return 1;
+    }
+    return 0;
+}
+
+/*!
+  \fn void bufr2tac_render_cache_free(struct bufr2tac_render_cache* c)
+  \brief Free all the memory of a struct \ref bufr2tac_render_cache. Counters are also cleaned
+  \param [in,out] c Pointer to the cache
+*/
+void bufr2tac_render_cache_free(struct bufr2tac_render_cache* c)
+{
+    struct bufr2tac_render_entry *e, *n;
+
+    for (e = c->first; e != NULL; e = n) {
+        n = e->next;
+        free(e->data);
+        free(e);
+    }
+    free(c->bucket);
+    memset(c, 0, sizeof(struct bufr2tac_render_cache));
+}
+
+/*!
+  \fn struct bufr2tac_render_entry* bufr2tac_render_cache_find(const struct bufr2tac_render_cache* c, uint64_t hash, uint32_t subset, int format)
+  \brief Find a rendered report without changing the order of use nor the counters
+  \param [in] c Pointer to the cache
+  \param [in] hash Hash of message
+  \param [in] subset Index of subset
+  \param [in] format Output format
+  \return Pointer to the entry if found, NULL otherwise
+*/
+struct bufr2tac_render_entry* bufr2tac_render_cache_find(const struct bufr2tac_render_cache* c, uint64_t hash,
+    uint32_t subset, int format)
+{
+    struct bufr2tac_render_entry* e;
+
+    if (c->nbuckets == 0)
+        return NULL;
+
+    for (e = c->bucket[bufr2tac_render_cache_bucket(c, hash, subset, format)]; e != NULL; e = e->chain) {
+        if (e->hash == hash && e->subset == subset && e->format == format)
+            return e;
+    }
+    return NULL;
+}
+
+/*!
+  \fn struct bufr2tac_render_entry* bufr2tac_render_cache_get(struct bufr2tac_render_cache* c, uint64_t hash, uint32_t subset, int format)
+  \brief Get a rendered report, setting it as the most recently used and counting a hit or a miss
+  \param [in,out] c Pointer to the cache
+  \param [in] hash Hash of message
+  \param [in] subset Index of subset
+  \param [in] format Output format
+  \return Pointer to the entry if found, NULL otherwise. It is valid until next call to \ref bufr2tac_render_cache_put
+*/
+struct bufr2tac_render_entry* bufr2tac_render_cache_get(struct bufr2tac_render_cache* c, uint64_t hash,
+    uint32_t subset, int format)
+{
+    struct bufr2tac_render_entry* e;
+
+    if ((e = bufr2tac_render_cache_find(c, hash, subset, format)) == NULL) {
+        c->misses++;
+        return NULL;
+    }
+
+    c->hits++;
+    if (e != c->first) {
+        bufr2tac_render_cache_unlink(c, e);
+        bufr2tac_render_cache_push(c, e);
+    }
+    return e;
+}
+
+/*!
+  \fn int bufr2tac_render_cache_put(struct bufr2tac_render_cache* c, uint64_t hash, uint32_t subset, uint32_t subsets, int format, const char* data, size_t len)
+  \brief Add a rendered report to cache, freeing the least recently used ones if needed
+  \param [in,out] c Pointer to the cache
+  \param [in] hash Hash of message
+  \param [in] subset Index of subset
+  \param [in] subsets Number of subsets in message
+  \param [in] format Output format
+  \param [in] data Rendered text
+  \param [in] len Bytes of data
+  \return 0 on success, 1 if it cannot be added, as when len is over the limit of bytes
+*/
+int bufr2tac_render_cache_put(struct bufr2tac_render_cache* c, uint64_t hash, uint32_t subset, uint32_t subsets,
+    int format, const char* data, size_t len)
+{
+    struct bufr2tac_render_entry* e;
+    size_t ix;
+
+    if (c->nbuckets == 0 || len > c->max_bytes)
+        return 1;
+
+    // A new text for the same key replaces the old one
+    if ((e = bufr2tac_render_cache_find(c, hash, subset, format)) != NULL)
+        bufr2tac_render_cache_remove(c, e);
+
+    while (c->last != NULL && (c->nentries >= c->max_entries || c->bytes + len > c->max_bytes)) {
+        bufr2tac_render_cache_remove(c, c->last);
+        c->evictions++;
+    }
+
+    if ((e = calloc(1, sizeof(struct bufr2tac_render_entry))) == NULL)
+        return 1;
+    if ((e->data = malloc(len + 1)) == NULL) {
+        free(e);
+        return 1;
+    }
+    memcpy(e->data, data, len);
+    e->data[len] = '\0';
+    e->len = len;
+    e->hash = hash;
+    e->subset = subset;
+    e->subsets = subsets;
+    e->format = format;
+
+    ix = bufr2tac_render_cache_bucket(c, hash, subset, format);
+    e->chain = c->bucket[ix];
+    c->bucket[ix] = e;
+    bufr2tac_render_cache_push(c, e);
+    c->nentries++;
+    c->bytes += len;
+    return 0;
+}
+
+/*!
+  \fn size_t bufr2tac_print_json_render_cache_stats(FILE* out, const struct bufr2tac_render_cache* c)
+  \brief Print the size and counters of a struct \ref bufr2tac_render_cache as a json object in a single line
+  \param [in] out Stream opened by caller
+  \param [in] c Pointer to the cache
+  \return The amount of bytes sent to out
+*/
+size_t bufr2tac_print_json_render_cache_stats(FILE* out, const struct bufr2tac_render_cache* c)
+{
+    uint64_t n = c->hits + c->misses;
+
+    return fprintf(out,
+        "{\"Render cache\":{\"Entries\":%zu,\"Bytes\":%zu,\"Max entries\":%zu,\"Max bytes\":%zu,\"Hits\":%" PRIu64
+        ",\"Misses\":%" PRIu64 ",\"Evictions\":%" PRIu64 ",\"Hit ratio\":%.6lf}}\n",
+        c->nentries, c->bytes, c->max_entries, c->max_bytes, c->hits, c->misses, c->evictions,
+        n ? (double)c->hits / (double)n : 0.0);
+}
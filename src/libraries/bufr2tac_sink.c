@@ -0,0 +1,372 @@
+/***************************************************************************
+ *   Copyright (C) 2013-2026 by Guillermo Ballester Valor                  *
+ *   gbv@ogimet.com                                                        *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.             *
+ ***************************************************************************/
+/*!
+ \file bufr2tac_sink.c
+ \brief This file has the code of sinks, where formatted reports are written to
+*/
+#include "bufr2tac.h"
+
+/*!
+  \fn static int bufr2tac_file_write(void* ctx, const char* data, size_t len)
+  \brief Write callback for a sink set with \ref bufr2tac_sink_set_file
+*/
+static int bufr2tac_file_write(void* ctx, const char* data, size_t len)
+{
+    return (fwrite(data, 1, len, (FILE*)ctx) == len) ? 0 : 1;
+}
+
+/*!
+  \fn static int bufr2tac_file_flush(void* ctx)
+  \brief Flush callback for a sink set with \ref bufr2tac_sink_set_file
+*/
+static int bufr2tac_file_flush(void* ctx)
+{
+    return fflush((FILE*)ctx) ? 1 : 0;
+}
+
+/*!
+  \fn static int bufr2tac_buffer_write(void* ctx, const char* data, size_t len)
+  \brief Write callback for a sink set with \ref bufr2tac_sink_set_buffer
+*/
+static int bufr2tac_buffer_write(void* ctx, const char* data, size_t len)
+{
+    struct bufr2tac_buffer* b = (struct bufr2tac_buffer*)ctx;
+
+    if (bufr2tac_buffer_reserve(b, len))
+        return 1;
+    memcpy(b->s + b->len, data, len);
+    b->len += len;
+    b->s[b->len] = '\0';
+    return 0;
+}
+
+/*!
+  \fn static int bufr2tac_output_buffer_write(void* ctx, const char* data, size_t len)
+  \brief Write callback for a sink set with \ref bufr2tac_sink_set_output_buffer
+*/
+static int bufr2tac_output_buffer_write(void* ctx, const char* data, size_t len)
+{
+    struct bufrdeco_output_buffer* ob = (struct bufrdeco_output_buffer*)ctx;
+
+    bufrdeco_out_write(ob, data, len);
+    return ob->error;
+}
+
+/*!
+  \fn static int bufr2tac_output_buffer_flush(void* ctx)
+  \brief Flush callback for a sink set with \ref bufr2tac_sink_set_output_buffer
+*/
+static int bufr2tac_output_buffer_flush(void* ctx)
+{
+    return bufrdeco_out_flush((struct bufrdeco_output_buffer*)ctx);
+}
+
+/*!
+  \fn int bufr2tac_sink_set_callbacks(struct bufr2tac_sink* s, bufr2tac_sink_write_function write, bufr2tac_sink_flush_function flush, void* ctx)
+  \brief Set a sink writing through user callbacks
+  \param [out] s Pointer to struct \ref bufr2tac_sink to set
+  \param [in] write Function to write data
+  \param [in] flush Function to flush data. It can be NULL
+  \param [in] ctx Context passed to \a write and \a flush
+  \return 0 on success, 1 on error
+*/
+int bufr2tac_sink_set_callbacks(struct bufr2tac_sink* s, bufr2tac_sink_write_function write,
+    bufr2tac_sink_flush_function flush, void* ctx)
+{
+    if (s == NULL || write == NULL)
+        return 1;
+    s->write = write;
+    s->flush = flush;
+    s->ctx = ctx;
+    s->error = 0;
+    return 0;
+}
+
+/*!
+  \fn int bufr2tac_sink_set_file(struct bufr2tac_sink* s, FILE* f)
+  \brief Set a sink writing to a file already open
+  \param [out] s Pointer to struct \ref bufr2tac_sink to set
+  \param [in] f File pointer where to write output
+  \return 0 on success, 1 on error
+*/
+int bufr2tac_sink_set_file(struct bufr2tac_sink* s, FILE* f)
+{
+    if (f == NULL)
+        return 1;
+    return bufr2tac_sink_set_callbacks(s, bufr2tac_file_write, bufr2tac_file_flush, f);
+}
+
+/*!
+  \fn int bufr2tac_sink_set_buffer(struct bufr2tac_sink* s, struct bufr2tac_buffer* b)
+  \brief Set a sink appending to a growable buffer
+  \param [out] s Pointer to struct \ref bufr2tac_sink to set
+  \param [in,out] b Pointer to struct \ref bufr2tac_buffer where to append output
+
+  The buffer must be initialized, all zeroes for an empty one. The data already in buffer is kept
+  \return 0 on success, 1 on error
+*/
+int bufr2tac_sink_set_buffer(struct bufr2tac_sink* s, struct bufr2tac_buffer* b)
+{
+    if (b == NULL)
+        return 1;
+    return bufr2tac_sink_set_callbacks(s, bufr2tac_buffer_write, NULL, b);
+}
+
+/*!
+  \fn int bufr2tac_sink_set_output_buffer(struct bufr2tac_sink* s, struct bufrdeco_output_buffer* ob)
+  \brief Set a sink appending to a struct \ref bufrdeco_output_buffer, which writes to its stream in large blocks
+  \param [out] s Pointer to struct \ref bufr2tac_sink to set
+  \param [in,out] ob Pointer to struct \ref bufrdeco_output_buffer already inited
+  \return 0 on success, 1 on error
+
+  The caller must call \ref bufr2tac_sink_flush or \ref bufrdeco_out_flush when done
+*/
+int bufr2tac_sink_set_output_buffer(struct bufr2tac_sink* s, struct bufrdeco_output_buffer* ob)
+{
+    if (ob == NULL)
+        return 1;
+    return bufr2tac_sink_set_callbacks(s, bufr2tac_output_buffer_write, bufr2tac_output_buffer_flush, ob);
+}
+
+/*!
+  \fn int bufr2tac_sink_write(struct bufr2tac_sink* s, const char* data, size_t len)
+  \brief Write bytes into a sink
+  \param [in,out] s Pointer to struct \ref bufr2tac_sink
+  \param [in] data Bytes to write
+  \param [in] len Number of bytes to write
+  \return 0 on success, 1 on error
+*/
+int bufr2tac_sink_write(struct bufr2tac_sink* s, const char* data, size_t len)
+{
+    if (len == 0)
+        return 0;
+    if (s->write(s->ctx, data, len)) {
+        s->error = 1;
+        return 1;
+    }
+    return 0;
+}
+
+/*!
+  \fn int bufr2tac_sink_puts(struct bufr2tac_sink* s, const char* str)
+  \brief Write a nul terminated string into a sink
+  \param [in,out] s Pointer to struct \ref bufr2tac_sink
+  \param [in] str String to write
+  \return 0 on success, 1 on error
+*/
+int bufr2tac_sink_puts(struct bufr2tac_sink* s, const char* str)
+{
+    return bufr2tac_sink_write(s, str, strlen(str));
+}
+
+/*!
+  \fn int bufr2tac_sink_put_field(struct bufr2tac_sink* s, const char* before, const char* value, const char* after)
+  \brief Write a string value between two strings into a sink
+  \param [in,out] s Pointer to struct \ref bufr2tac_sink
+  \param [in] before String written before value
+  \param [in] value The value
+  \param [in] after String written after value
+  \return 0 on success, 1 on error
+*/
+int bufr2tac_sink_put_field(struct bufr2tac_sink* s, const char* before, const char* value, const char* after)
+{
+    bufr2tac_sink_puts(s, before);
+    bufr2tac_sink_puts(s, value);
+    bufr2tac_sink_puts(s, after);
+    return s->error;
+}
+
+/*!
+  \fn int bufr2tac_sink_put_fixed(struct bufr2tac_sink* s, const char* before, double value, int decimals, const char* after)
+  \brief Write a value in fixed point notation between two strings into a sink
+  \param [in,out] s Pointer to struct \ref bufr2tac_sink
+  \param [in] before String written before value
+  \param [in] value The value
+  \param [in] decimals Number of decimals, as in printf(3) format "%.*lf"
+  \param [in] after String written after value
+  \return 0 on success, 1 on error
+*/
+int bufr2tac_sink_put_fixed(struct bufr2tac_sink* s, const char* before, double value, int decimals, const char* after)
+{
+    char aux[512];
+
+    bufr2tac_sink_puts(s, before);
+    bufr2tac_sink_write(s, aux, bufrdeco_format_fixed(aux, sizeof(aux), value, decimals));
+    bufr2tac_sink_puts(s, after);
+    return s->error;
+}
+
+/*!
+  \fn int bufr2tac_sink_printf(struct bufr2tac_sink* s, const char* format, ...)
+  \brief Write formatted output into a sink, as printf(3)
+  \param [in,out] s Pointer to struct \ref bufr2tac_sink
+  \param [in] format Format string
+  \return 0 on success, 1 on error
+
+  Short outputs are formatted in the stack. Only the long ones need a temporary allocation
+*/
+int bufr2tac_sink_printf(struct bufr2tac_sink* s, const char* format, ...)
+{
+    char aux[512];
+    char* c;
+    va_list ap;
+    int n, res;
+
+    va_start(ap, format);
+    n = vsnprintf(aux, sizeof(aux), format, ap);
+    va_end(ap);
+    if (n < 0) {
+        s->error = 1;
+        return 1;
+    }
+    if ((size_t)n < sizeof(aux))
+        return bufr2tac_sink_write(s, aux, n);
+
+    if ((c = malloc(n + 1)) == NULL) {
+        s->error = 1;
+        return 1;
+    }
+    va_start(ap, format);
+    vsnprintf(c, n + 1, format, ap);
+    va_end(ap);
+    res = bufr2tac_sink_write(s, c, n);
+    free(c);
+    return res;
+}
+
+/*!
+  \fn int bufr2tac_sink_flush(struct bufr2tac_sink* s)
+  \brief Flush a sink
+  \param [in,out] s Pointer to struct \ref bufr2tac_sink
+  \return 0 on success, 1 on error
+*/
+int bufr2tac_sink_flush(struct bufr2tac_sink* s)
+{
+    if (s->flush == NULL)
+        return 0;
+    if (s->flush(s->ctx)) {
+        s->error = 1;
+        return 1;
+    }
+    return 0;
+}
+
+/*!
+  \fn int bufr2tac_buffer_reserve(struct bufr2tac_buffer* b, size_t n)
+  \brief Make room in a buffer for at least \a n more bytes and the final nul
+  \param [in,out] b Pointer to struct \ref bufr2tac_buffer
+  \param [in] n Bytes to add
+  \return 0 on success, 1 on error
+*/
+int bufr2tac_buffer_reserve(struct bufr2tac_buffer* b, size_t n)
+{
+    size_t dim;
+    char* s;
+
+    if (b->len + n < b->dim)
+        return 0;
+
+    // Grow geometrically so a sequence of small writes is amortized
+    dim = b->dim ? b->dim : REPORT_LENGTH;
+    while (dim <= b->len + n)
+        dim *= 2;
+    if ((s = realloc(b->s, dim)) == NULL)
+        return 1;
+    b->s = s;
+    b->dim = dim;
+    return 0;
+}
+
+/*!
+  \fn void bufr2tac_buffer_clean(struct bufr2tac_buffer* b)
+  \brief Set a buffer as empty, keeping allocated memory to be reused
+  \param [in,out] b Pointer to struct \ref bufr2tac_buffer
+*/
+void bufr2tac_buffer_clean(struct bufr2tac_buffer* b)
+{
+    b->len = 0;
+    if (b->s != NULL)
+        b->s[0] = '\0';
+}
+
+/*!
+  \fn void bufr2tac_buffer_truncate(struct bufr2tac_buffer* b, size_t len)
+  \brief Drop the data of a buffer from \a len on, keeping allocated memory
+  \param [in,out] b Pointer to struct \ref bufr2tac_buffer
+  \param [in] len New length. Nothing is done if it is not less than current one
+*/
+void bufr2tac_buffer_truncate(struct bufr2tac_buffer* b, size_t len)
+{
+    if (len >= b->len)
+        return;
+    b->len = len;
+    b->s[len] = '\0';
+}
+
+/*!
+  \fn size_t bufr2tac_buffer_printf(struct bufr2tac_buffer* b, const char* format, ...)
+  \brief Append formatted output to a buffer, as printf(3)
+  \param [in,out] b Pointer to struct \ref bufr2tac_buffer
+  \param [in] format Format string
+  \return Number of bytes appended, 0 on error
+
+  Most writes fit in the room already allocated, so they are formatted just once
+*/
+size_t bufr2tac_buffer_printf(struct bufr2tac_buffer* b, const char* format, ...)
+{
+    va_list ap;
+    size_t room;
+    int n;
+
+    if (bufr2tac_buffer_reserve(b, 0))
+        return 0;
+    room = b->dim - b->len;
+    va_start(ap, format);
+    n = vsnprintf(b->s + b->len, room, format, ap);
+    va_end(ap);
+    if (n < 0) {
+        b->s[b->len] = '\0';
+        return 0;
+    }
+    if ((size_t)n >= room) {
+        if (bufr2tac_buffer_reserve(b, n)) {
+            b->s[b->len] = '\0';
+            return 0;
+        }
+        va_start(ap, format);
+        vsnprintf(b->s + b->len, n + 1, format, ap);
+        va_end(ap);
+    }
+    b->len += n;
+    return n;
+}
+
+/*!
+  \fn void bufr2tac_buffer_free(struct bufr2tac_buffer* b)
+  \brief Free the memory of a buffer
+  \param [in,out] b Pointer to struct \ref bufr2tac_buffer
+*/
+void bufr2tac_buffer_free(struct bufr2tac_buffer* b)
+{
+    free(b->s);
+    b->s = NULL;
+    b->len = 0;
+    b->dim = 0;
+}
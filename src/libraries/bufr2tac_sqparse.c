@@ -63,29 +63,40 @@ int find_descriptor_interval ( const int *haystack, size_t nlst, int needlemin,
 }
 
 /*!
-  \fn int parse_subset_sequence(struct metreport *m, struct bufr_subset_sequence_data *sq, struct bufr2tac_subset_state *st,  const int *kdtlst, size_t nlst, const int *ksec1, char *err)
-  \brief Parse a sequence of expanded descriptors for a subset
-  \param [in,out] m Pointer to struct \ref metreport where to set the data
-  \param [in] sq Pointer to struct \ref bufr_subset_sequence_data where the values for sequence of descriptors for a subset has been decoded
-  \param [in,out] st Pointer to struct \ref bufr2tac_subset_state
+  \brief MiMiMjMj names of report types. Same order than enum \ref bufr2tac_report_type
+*/
+static const char *BUFR2TAC_REPORT_TYPE_NAME[BUFR2TAC_REPORT_TYPES] =
+{ "", "AAXX", "BBXX", "OOXX", "ZZYY", "TTXX", "PPXX", "CLIMAT", "CLIMAT SHIP" };
+
+/*!
+  \fn const char *bufr2tac_report_type_name(enum bufr2tac_report_type type)
+  \brief Get the MiMiMjMj string of a report type
+  \param [in] type The report type
+  \return Pointer to the name, an empty string if unknown
+*/
+const char *bufr2tac_report_type_name ( enum bufr2tac_report_type type )
+{
+  if ( type >= BUFR2TAC_REPORT_TYPES )
+    return "";
+  return BUFR2TAC_REPORT_TYPE_NAME[type];
+}
+
+/*!
+  \fn static enum bufr2tac_report_type get_report_type(const int *kdtlst, size_t nlst, const int *ksec1)
+  \brief Figure out the type of report from descriptors in Section 3 and data category in Section 1
   \param [in] kdtlst Array of integers with descriptors
   \param [in] nlst Number of descriptors in kdtlst
   \param [in] ksec1 Array of auxiliary integers decoded by bufrdc ECMWF library
-  \param [out] err String where to write errors if any
-  \return 0 on success, 1 on error
+  \return The report type, \ref BUFR2TAC_REPORT_UNKNOWN if not found
 */
-int parse_subset_sequence ( struct metreport *m, struct bufr_subset_sequence_data *sq, struct bufr2tac_subset_state *st,  const int *kdtlst, size_t nlst, const int *ksec1, char *err )
+static enum bufr2tac_report_type get_report_type ( const int *kdtlst, size_t nlst, const int *ksec1 )
 {
-  /* Clean the state */
-  memset ( st, 0, sizeof ( struct bufr2tac_subset_state ) );
-
-  /* First task to do is figure out the type of report */
   switch ( ksec1[5] )
     {
     case 0:
       if ( find_descriptor_interval ( kdtlst, nlst, 307071, 307073 ) )
         {
-          strcpy ( st->type_report, "CLIMAT" );  // FM-71 CLIMAT
+          return BUFR2TAC_REPORT_CLIMAT;  // FM-71 CLIMAT
         }
       else if ( find_descriptor_interval ( kdtlst, nlst, 307079, 307086 ) ||
                 find_descriptor ( kdtlst, nlst,307091 ) ||
@@ -95,20 +106,20 @@ int parse_subset_sequence ( struct metreport *m, struct bufr_subset_sequence_dat
                 ksec1[6] == 0 || ksec1[6] == 1 || ksec1[6] == 2 )
         {
           if ( find_descriptor (kdtlst, nlst, 1010 ) )
-             strcpy ( st->type_report,"BBXX" );  // Fixed Buoy platform as ship 
+             return BUFR2TAC_REPORT_BBXX;  // Fixed Buoy platform as ship 
           else  
-             strcpy ( st->type_report,"AAXX" );  // FM-12 synop
+             return BUFR2TAC_REPORT_AAXX;  // FM-12 synop
         }
       else if ( find_descriptor ( kdtlst, nlst,307090 ) ||
                 find_descriptor ( kdtlst, nlst,301092 ) ||
                 ksec1[6] == 3 || ksec1[6] == 4 || ksec1[6] == 5 )
         {
-          strcpy ( st->type_report,"OOXX" );  // FM-14 synop-mobil
+          return BUFR2TAC_REPORT_OOXX;  // FM-14 synop-mobil
         }
       // these descriptors should be in category 1, but some FM-13 are coded as category 0  
       else if ( find_descriptor ( kdtlst, nlst,308009 ) )
         {
-          strcpy ( st->type_report,"BBXX" );  // FM-13 ship
+          return BUFR2TAC_REPORT_BBXX;  // FM-13 ship
         }
       break;
     case 1:
@@ -117,7 +128,7 @@ int parse_subset_sequence ( struct metreport *m, struct bufr_subset_sequence_dat
            find_descriptor ( kdtlst, nlst,308009 ) || 
            find_descriptor ( kdtlst, nlst,1011 ) )
         {
-          strcpy ( st->type_report,"BBXX" );  // FM-13 ship
+          return BUFR2TAC_REPORT_BBXX;  // FM-13 ship
         }
       else if ( find_descriptor_interval ( kdtlst, nlst, 308001, 308003 ) ||
                 find_descriptor ( kdtlst, nlst,315008 ) ||
@@ -127,48 +138,104 @@ int parse_subset_sequence ( struct metreport *m, struct bufr_subset_sequence_dat
                 find_descriptor ( kdtlst, nlst,2149 ) ||
                 ksec1[6] == 25 )
         {
-          strcpy ( st->type_report,"ZZYY" );  // FM-18 buoy
+          return BUFR2TAC_REPORT_ZZYY;  // FM-18 buoy
         }
       else if ( find_descriptor_interval ( kdtlst, nlst, 308011, 308013 ) )
         {
-          strcpy ( st->type_report, "CLIMAT SHIP" );  // FM-71 CLIMAT SHIP
+          return BUFR2TAC_REPORT_CLIMAT_SHIP;  // FM-71 CLIMAT SHIP
         }
       else if ( find_descriptor ( kdtlst, nlst,307090 ) )
         {
           // FIXME Some FM-14 are coded as category 1
-          strcpy ( st->type_report,"OOXX" );  // FM-14 synop-mobil
+          return BUFR2TAC_REPORT_OOXX;  // FM-14 synop-mobil
         }
       break;
     case 2:
       if ( find_descriptor_interval ( kdtlst, nlst, 309050, 309051 ) )
         {
-          strcpy ( st->type_report,"PPXX" );  // PILOT, PILOT SHIP, PILOT DROP or PILOT MOBIL
+          return BUFR2TAC_REPORT_PPXX;  // PILOT, PILOT SHIP, PILOT DROP or PILOT MOBIL
         }
       else if ( find_descriptor ( kdtlst, nlst, 309052 ) ||
                 find_descriptor ( kdtlst, nlst, 309057 ) 
               )
         {
-          strcpy ( st->type_report,"TTXX" );  // TEMP, TEMP SHIP, TEMP MOBIL
+          return BUFR2TAC_REPORT_TTXX;  // TEMP, TEMP SHIP, TEMP MOBIL
         }
       break;
     default:
+      break;
+    }
+  return BUFR2TAC_REPORT_UNKNOWN;
+}
+
+/*!
+  \fn int bufr2tac_classify_report(struct bufr2tac_report_class *rc, const int *kdtlst, size_t nlst, const int *ksec1, char *err)
+  \brief Get the report type of a message, reusing the previous result if Section 1 and 3 are the same
+  \param [in,out] rc Pointer to the struct with the cached classification
+  \param [in] kdtlst Array of integers with descriptors
+  \param [in] nlst Number of descriptors in kdtlst
+  \param [in] ksec1 Array of auxiliary integers decoded by bufrdc ECMWF library
+  \param [out] err String where to write errors if any
+  \return 0 on success, 1 if the type cannot be parsed
+*/
+int bufr2tac_classify_report ( struct bufr2tac_report_class *rc, const int *kdtlst, size_t nlst, const int *ksec1, char *err )
+{
+  if ( rc->cached == 0 || rc->category != ksec1[5] || rc->subcategory != ksec1[6] || rc->nlst != nlst ||
+       memcmp ( rc->kdtlst, kdtlst, nlst * sizeof ( int ) ) )
+    {
+      rc->type = get_report_type ( kdtlst, nlst, ksec1 );
+      // A too long key is not cached
+      if ( nlst <= BUFR_LEN_UNEXPANDED_DESCRIPTOR )
+        {
+          rc->category = ksec1[5];
+          rc->subcategory = ksec1[6];
+          rc->nlst = nlst;
+          memcpy ( rc->kdtlst, kdtlst, nlst * sizeof ( int ) );
+          rc->cached = 1;
+        }
+      else
+        rc->cached = 0;
+    }
+
+  if ( ksec1[5] < 0 || ksec1[5] > 2 )
+    {
       snprintf ( err, ERR_SIZE, "The data category %d is not parsed at the moment", ksec1[5] );
       return 1;
     }
-  
-  
-  if ( st->type_report[0] == '\0' )
+
+  if ( rc->type == BUFR2TAC_REPORT_UNKNOWN )
     {
       snprintf ( err, ERR_SIZE, "Cannot find the report type\n" );
       return 1;
     }
+  return 0;
+}
+
+/*!
+  \fn int parse_subset_sequence_class(struct metreport *m, struct bufr_subset_sequence_data *sq, struct bufr2tac_subset_state *st, const struct bufr2tac_report_class *rc, char *err)
+  \brief Parse a sequence of expanded descriptors for a subset whose report type is already known
+  \param [in,out] m Pointer to struct \ref metreport where to set the data
+  \param [in] sq Pointer to struct \ref bufr_subset_sequence_data where the values for sequence of descriptors for a subset has been decoded
+  \param [in,out] st Pointer to struct \ref bufr2tac_subset_state
+  \param [in] rc Pointer to struct \ref bufr2tac_report_class got by \ref bufr2tac_classify_report
+  \param [out] err String where to write errors if any
+  \return 0 on success, 1 on error
+*/
+int parse_subset_sequence_class ( struct metreport *m, struct bufr_subset_sequence_data *sq, struct bufr2tac_subset_state *st,
+                                  const struct bufr2tac_report_class *rc, char *err )
+{
+  /* Clean the state */
+  bufr2tac_clean_subset_state ( st );
+  strcpy ( st->type_report, bufr2tac_report_type_name ( rc->type ) );
 
   //if(DEBUG)
   //  printf("Going to parse a %s report\n", st->type_report);
 
-
-  if ( strcmp ( st->type_report,"AAXX" ) == 0 || strcmp ( st->type_report,"BBXX" ) == 0 || strcmp ( st->type_report,"OOXX" ) == 0 )
+  switch ( rc->type )
     {
+    case BUFR2TAC_REPORT_AAXX:
+    case BUFR2TAC_REPORT_BBXX:
+    case BUFR2TAC_REPORT_OOXX:
       // Parse FM-12, FM-13 and FM-14
       if ( parse_subset_as_synop ( m, st, sq, err ) == 0 )
         {
@@ -176,10 +243,8 @@ int parse_subset_sequence ( struct metreport *m, struct bufr_subset_sequence_dat
             bufr2tac_print_error(&st->e);
           return print_synop_report ( m );
         }
-        
-    }
-  else if ( strcmp ( st->type_report,"ZZYY" ) == 0 )
-    {
+      break;
+    case BUFR2TAC_REPORT_ZZYY:
       // parse BUOY
       if ( parse_subset_as_buoy ( m, st, sq, err ) == 0 )
         {
@@ -187,9 +252,8 @@ int parse_subset_sequence ( struct metreport *m, struct bufr_subset_sequence_dat
             bufr2tac_print_error(&st->e);
           return print_buoy_report ( m );
         }
-    }
-  else if ( strcmp ( st->type_report,"TTXX" ) == 0 )
-    {
+      break;
+    case BUFR2TAC_REPORT_TTXX:
       // psrse TEMP
       if ( parse_subset_as_temp ( m, st, sq, err ) == 0 )
         {
@@ -197,9 +261,8 @@ int parse_subset_sequence ( struct metreport *m, struct bufr_subset_sequence_dat
             bufr2tac_print_error(&st->e);
           return print_temp_report ( m );
         }
-    }
-  else if ( strcmp ( st->type_report,"CLIMAT" ) == 0 )
-    {
+      break;
+    case BUFR2TAC_REPORT_CLIMAT:
       // psrse CLIMAT
       if ( parse_subset_as_climat ( m, st, sq, err ) == 0 )
         {
@@ -207,6 +270,9 @@ int parse_subset_sequence ( struct metreport *m, struct bufr_subset_sequence_dat
             bufr2tac_print_error(&st->e);
           return print_climat_report ( m );
         }
+      break;
+    default:
+      break;
     }
 
   // when reached this point we have han error
@@ -214,3 +280,31 @@ int parse_subset_sequence ( struct metreport *m, struct bufr_subset_sequence_dat
     bufr2tac_print_error(&st->e);
   return 1;
 }
+
+/*!
+  \fn int parse_subset_sequence(struct metreport *m, struct bufr_subset_sequence_data *sq, struct bufr2tac_subset_state *st,  const int *kdtlst, size_t nlst, const int *ksec1, char *err)
+  \brief Parse a sequence of expanded descriptors for a subset
+  \param [in,out] m Pointer to struct \ref metreport where to set the data
+  \param [in] sq Pointer to struct \ref bufr_subset_sequence_data where the values for sequence of descriptors for a subset has been decoded
+  \param [in,out] st Pointer to struct \ref bufr2tac_subset_state
+  \param [in] kdtlst Array of integers with descriptors
+  \param [in] nlst Number of descriptors in kdtlst
+  \param [in] ksec1 Array of auxiliary integers decoded by bufrdc ECMWF library
+  \param [out] err String where to write errors if any
+  \return 0 on success, 1 on error
+
+  The report type is figured out for every call. To parse many subsets of a message use \ref bufr2tac_classify_report
+  once and then \ref parse_subset_sequence_class
+*/
+int parse_subset_sequence ( struct metreport *m, struct bufr_subset_sequence_data *sq, struct bufr2tac_subset_state *st,  const int *kdtlst, size_t nlst, const int *ksec1, char *err )
+{
+  struct bufr2tac_report_class rc;
+
+  rc.cached = 0;
+  if ( bufr2tac_classify_report ( &rc, kdtlst, nlst, ksec1, err ) )
+    {
+      bufr2tac_clean_subset_state ( st );
+      return 1;
+    }
+  return parse_subset_sequence_class ( m, sq, st, &rc, err );
+}
@@ -0,0 +1,507 @@
+/***************************************************************************
+ *   Copyright (C) 2013-2026 by Guillermo Ballester Valor                  *
+ *   gbv@ogimet.com                                                        *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.             *
+ ***************************************************************************/
+/*!
+ \file bufr2tac_store.c
+ \brief This file has the code of the store of observations by station and time
+
+ A store is a log where records of fixed size are only appended, and an index with the entries sorted by station
+ and time. The index is rebuilt when the store is closed, so the last records of log may be not indexed yet if a
+ writer did not end. Queries search them one by one
+*/
+#include "bufr2tac.h"
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+
+/*!
+  \struct bufr2tac_store_source
+  \brief A descriptor where a core variable is got from. Descriptors of the same variable are in order of preference
+*/
+struct bufr2tac_store_source {
+    uint8_t x; /*!< X part of descriptor */
+    uint8_t y; /*!< Y part of descriptor */
+    enum bufr2tac_store_var var; /*!< The variable */
+};
+
+static const struct bufr2tac_store_source STORE_SOURCES[] = {
+    { 10, 4, BUFR2TAC_STORE_PRESSURE },
+    { 10, 51, BUFR2TAC_STORE_MSL_PRESSURE },
+    { 12, 101, BUFR2TAC_STORE_TEMPERATURE },
+    { 12, 1, BUFR2TAC_STORE_TEMPERATURE },
+    { 12, 4, BUFR2TAC_STORE_TEMPERATURE },
+    { 12, 103, BUFR2TAC_STORE_DEWPOINT },
+    { 12, 3, BUFR2TAC_STORE_DEWPOINT },
+    { 12, 6, BUFR2TAC_STORE_DEWPOINT },
+    { 13, 3, BUFR2TAC_STORE_HUMIDITY },
+    { 11, 1, BUFR2TAC_STORE_WIND_DIRECTION },
+    { 11, 11, BUFR2TAC_STORE_WIND_DIRECTION },
+    { 11, 2, BUFR2TAC_STORE_WIND_SPEED },
+    { 11, 12, BUFR2TAC_STORE_WIND_SPEED },
+    { 20, 1, BUFR2TAC_STORE_VISIBILITY }
+};
+
+#define STORE_NSOURCES (sizeof(STORE_SOURCES) / sizeof(STORE_SOURCES[0]))
+
+/*!
+  \fn int bufr2tac_store_set_record(struct bufr2tac_store_record *r, const struct metreport *m, const struct bufrdeco_subset_sequence_data *sq)
+  \brief Set a record of an observation store from a decoded report and its subset
+  \param [out] r Pointer to the record
+  \param [in] m Pointer to the decoded report, with the station in \a g and the time in \a t
+  \param [in] sq Pointer to the decoded subset, where the core variables are got from
+  \return 0 on success, 1 if the report has no station or no time
+*/
+int bufr2tac_store_set_record(struct bufr2tac_store_record* r, const struct metreport* m,
+    const struct bufrdeco_subset_sequence_data* sq)
+{
+    size_t rank[BUFR2TAC_STORE_NVARS], j;
+    const struct bufr_atom_data* a;
+    buf_t i;
+
+    memset(r, 0, sizeof(struct bufr2tac_store_record));
+    if (m->t.datime[0] == '\0')
+        return 1;
+
+    if (m->g.wid.local_id[0] && strcmp(m->g.wid.local_id, "MISSING"))
+        snprintf(r->wigos, sizeof(r->wigos), "%d-%d-%d-%s", m->g.wid.series, m->g.wid.issuer, m->g.wid.issue,
+            m->g.wid.local_id);
+    if (m->g.index[0])
+        snprintf(r->ident, sizeof(r->ident), "%s", m->g.index);
+    else if (r->wigos[0])
+        snprintf(r->ident, sizeof(r->ident), "%s", r->wigos);
+    else
+        return 1;
+
+    r->time = (int64_t)m->t.t;
+    r->lat = m->g.lat;
+    r->lon = m->g.lon;
+    r->alt = m->g.alt;
+    snprintf(r->type, sizeof(r->type), "%s", m->type);
+    r->subset = (uint32_t)m->subset;
+    for (j = 0; j < BUFR2TAC_STORE_NVARS; j++) {
+        r->var[j] = MISSING_REAL;
+        rank[j] = STORE_NSOURCES;
+    }
+
+    for (i = 0; i < sq->nd; i++) {
+        a = &sq->sequence[i];
+        if (a->desc.f != 0 || (a->mask & DESCRIPTOR_VALUE_MISSING))
+            continue;
+        for (j = 0; j < STORE_NSOURCES; j++) {
+            if (STORE_SOURCES[j].x != a->desc.x || STORE_SOURCES[j].y != a->desc.y)
+                continue;
+            // The first occurrence of the most preferred descriptor
+            if (j < rank[STORE_SOURCES[j].var]) {
+                rank[STORE_SOURCES[j].var] = j;
+                r->var[STORE_SOURCES[j].var] = a->val;
+            }
+            break;
+        }
+    }
+    return 0;
+}
+
+/*!
+  \fn static void bufr2tac_store_set_header(struct bufr2tac_store_header* h, const char* magic, uint32_t item_size, uint64_t nrecords)
+  \brief Set the header of a log or an index
+*/
+static void bufr2tac_store_set_header(struct bufr2tac_store_header* h, const char* magic, uint32_t item_size,
+    uint64_t nrecords)
+{
+    memset(h, 0, sizeof(struct bufr2tac_store_header));
+    memcpy(h->magic, magic, sizeof(h->magic));
+    h->version = BUFR2TAC_STORE_VERSION;
+    h->byte_order = BUFRDECO_INDEX_BYTE_ORDER;
+    h->header_size = sizeof(struct bufr2tac_store_header);
+    h->item_size = item_size;
+    h->nrecords = nrecords;
+}
+
+/*!
+  \fn static int bufr2tac_store_check_header(const struct bufr2tac_store_header* h, const char* magic, uint32_t item_size)
+  \brief Check the header of a log or an index was written by this version on a host with the same byte order
+  \return 0 if valid, 1 otherwise
+*/
+static int bufr2tac_store_check_header(const struct bufr2tac_store_header* h, const char* magic, uint32_t item_size)
+{
+    if (memcmp(h->magic, magic, sizeof(h->magic)) || h->version != BUFR2TAC_STORE_VERSION
+        || h->byte_order != BUFRDECO_INDEX_BYTE_ORDER || h->header_size != sizeof(struct bufr2tac_store_header)
+        || h->item_size != item_size)
+        return 1;
+    return 0;
+}
+
+/*!
+  \fn static int bufr2tac_store_paths(char* log, char* idx, size_t dim, const char* base)
+  \brief Set the pathnames of log and index of a store
+  \return 0 on success, 1 if \a base is too long
+*/
+static int bufr2tac_store_paths(char* log, char* idx, size_t dim, const char* base)
+{
+    if (base == NULL || base[0] == '\0' || strlen(base) >= BUFRDECO_PATH_LENGTH)
+        return 1;
+    snprintf(log, dim, "%s.log", base);
+    snprintf(idx, dim, "%s.idx", base);
+    return 0;
+}
+
+/*!
+  \fn int bufr2tac_store_open(struct bufr2tac_store *st, const char *base)
+  \brief Open an observation store to append records, creating its log if needed
+  \param [out] st Pointer to the store
+  \param [in] base Pathname of store, without the '.log' and '.idx' suffixes
+  \return 0 on success, 1 on error
+*/
+int bufr2tac_store_open(struct bufr2tac_store* st, const char* base)
+{
+    struct bufr2tac_store_header h;
+    struct stat s;
+    FILE* f;
+
+    memset(st, 0, sizeof(struct bufr2tac_store));
+    if (bufr2tac_store_paths(st->log, st->idx, sizeof(st->log), base))
+        return 1;
+
+    if (stat(st->log, &s) == 0 && s.st_size > 0) {
+        // An existing log must be a log of this version
+        if ((f = fopen(st->log, "rb")) == NULL)
+            return 1;
+        if (fread(&h, sizeof(h), 1, f) != 1
+            || bufr2tac_store_check_header(&h, BUFR2TAC_STORE_LOG_MAGIC, sizeof(struct bufr2tac_store_record))) {
+            fclose(f);
+            return 1;
+        }
+        fclose(f);
+        if ((st->f = fopen(st->log, "ab")) == NULL)
+            return 1;
+        return 0;
+    }
+
+    if ((st->f = fopen(st->log, "wb")) == NULL)
+        return 1;
+    bufr2tac_store_set_header(&h, BUFR2TAC_STORE_LOG_MAGIC, sizeof(struct bufr2tac_store_record), 0);
+    if (fwrite(&h, sizeof(h), 1, st->f) != 1) {
+        fclose(st->f);
+        st->f = NULL;
+        return 1;
+    }
+    return 0;
+}
+
+/*!
+  \fn int bufr2tac_store_append(struct bufr2tac_store *st, const struct bufr2tac_store_record *r)
+  \brief Append a record to the log of an observation store
+  \param [in,out] st Pointer to the store
+  \param [in] r Pointer to the record
+  \return 0 on success, 1 on error
+*/
+int bufr2tac_store_append(struct bufr2tac_store* st, const struct bufr2tac_store_record* r)
+{
+    if (st->f == NULL || fwrite(r, sizeof(struct bufr2tac_store_record), 1, st->f) != 1)
+        return 1;
+    st->appended++;
+    return 0;
+}
+
+/*!
+  \fn int bufr2tac_store_close(struct bufr2tac_store *st)
+  \brief Close the log of an observation store and add the records appended to its index
+  \param [in,out] st Pointer to the store
+  \return 0 on success, 1 on error
+*/
+int bufr2tac_store_close(struct bufr2tac_store* st)
+{
+    char base[BUFRDECO_PATH_LENGTH];
+    int res = 0;
+
+    if (st->f == NULL)
+        return 0;
+    if (fclose(st->f))
+        res = 1;
+    st->f = NULL;
+    if (st->appended) {
+        snprintf(base, sizeof(base), "%.*s", (int)(strlen(st->log) - 4), st->log);
+        if (bufr2tac_store_update_index(base))
+            res = 1;
+    }
+    return res;
+}
+
+/*!
+  \fn static int bufr2tac_store_entry_cmp(const void* a, const void* b)
+  \brief Order of entries in index: by station, then by time, then by record
+*/
+static int bufr2tac_store_entry_cmp(const void* a, const void* b)
+{
+    const struct bufr2tac_store_entry* ea = (const struct bufr2tac_store_entry*)a;
+    const struct bufr2tac_store_entry* eb = (const struct bufr2tac_store_entry*)b;
+    int c;
+
+    if ((c = strncmp(ea->ident, eb->ident, BUFR2TAC_STORE_IDENT_LENGTH)) != 0)
+        return c;
+    if (ea->time != eb->time)
+        return ea->time < eb->time ? -1 : 1;
+    if (ea->record != eb->record)
+        return ea->record < eb->record ? -1 : 1;
+    return 0;
+}
+
+/*!
+  \fn int bufr2tac_store_update_index(const char *base)
+  \brief Add to the index of an observation store the records of log not indexed yet
+  \param [in] base Pathname of store, without the '.log' and '.idx' suffixes
+  \return 0 on success, 1 on error
+
+  The new entries are sorted and merged with the old ones in a new index which replaces the old one at once
+*/
+int bufr2tac_store_update_index(const char* base)
+{
+    struct bufr2tac_store_reader rd;
+    struct bufr2tac_store_header h;
+    struct bufr2tac_store_entry* e;
+    char log[BUFRDECO_PATH_LENGTH + 8], idx[BUFRDECO_PATH_LENGTH + 8], tmp[BUFRDECO_PATH_LENGTH + 16];
+    uint64_t i, j, k, nnew;
+    FILE* f;
+    int res = 0;
+
+    if (bufr2tac_store_paths(log, idx, sizeof(log), base) || bufr2tac_store_reader_open(&rd, base))
+        return 1;
+    if (rd.nindexed == rd.nrecords) {
+        bufr2tac_store_reader_close(&rd);
+        return 0;
+    }
+
+    // Sort the entries of records not indexed yet
+    nnew = rd.nrecords - rd.nindexed;
+    if ((e = (struct bufr2tac_store_entry*)calloc(nnew, sizeof(struct bufr2tac_store_entry))) == NULL) {
+        bufr2tac_store_reader_close(&rd);
+        return 1;
+    }
+    for (i = 0; i < nnew; i++) {
+        memcpy(e[i].ident, rd.rec[rd.nindexed + i].ident, BUFR2TAC_STORE_IDENT_LENGTH);
+        e[i].ident[BUFR2TAC_STORE_IDENT_LENGTH - 1] = '\0';
+        e[i].time = rd.rec[rd.nindexed + i].time;
+        e[i].record = rd.nindexed + i;
+    }
+    qsort(e, nnew, sizeof(struct bufr2tac_store_entry), bufr2tac_store_entry_cmp);
+
+    // Merge them with the old ones in a new file, which replaces the old index at once
+    snprintf(tmp, sizeof(tmp), "%s.tmp", idx);
+    if ((f = fopen(tmp, "wb")) == NULL) {
+        free(e);
+        bufr2tac_store_reader_close(&rd);
+        return 1;
+    }
+    bufr2tac_store_set_header(&h, BUFR2TAC_STORE_INDEX_MAGIC, sizeof(struct bufr2tac_store_entry), rd.nrecords);
+    if (fwrite(&h, sizeof(h), 1, f) != 1)
+        res = 1;
+    for (i = 0, j = 0; res == 0 && (i < rd.nentries || j < nnew);) {
+        if (j == nnew || (i < rd.nentries && bufr2tac_store_entry_cmp(&rd.ent[i], &e[j]) <= 0))
+            k = fwrite(&rd.ent[i++], sizeof(struct bufr2tac_store_entry), 1, f);
+        else
+            k = fwrite(&e[j++], sizeof(struct bufr2tac_store_entry), 1, f);
+        if (k != 1)
+            res = 1;
+    }
+    if (fclose(f))
+        res = 1;
+    free(e);
+    bufr2tac_store_reader_close(&rd);
+
+    if (res || rename(tmp, idx)) {
+        unlink(tmp);
+        return 1;
+    }
+    return 0;
+}
+
+/*!
+  \fn static void* bufr2tac_store_map(const char* path, size_t* size)
+  \brief Map a whole file in memory to read it
+  \return Pointer to the map, NULL if the file cannot be mapped
+*/
+static void* bufr2tac_store_map(const char* path, size_t* size)
+{
+    struct stat s;
+    void* map;
+    int fd;
+
+    if ((fd = open(path, O_RDONLY)) < 0)
+        return NULL;
+    if (fstat(fd, &s) || (size_t)s.st_size < sizeof(struct bufr2tac_store_header)) {
+        close(fd);
+        return NULL;
+    }
+    map = mmap(NULL, s.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (map == MAP_FAILED)
+        return NULL;
+    *size = s.st_size;
+    return map;
+}
+
+/*!
+  \fn int bufr2tac_store_reader_open(struct bufr2tac_store_reader *rd, const char *base)
+  \brief Map an observation store in memory to query it
+  \param [out] rd Pointer to the reader
+  \param [in] base Pathname of store, without the '.log' and '.idx' suffixes
+  \return 0 on success, 1 on error. A store without index is valid, but all its records are searched one by one
+*/
+int bufr2tac_store_reader_open(struct bufr2tac_store_reader* rd, const char* base)
+{
+    const struct bufr2tac_store_header* h;
+    char log[BUFRDECO_PATH_LENGTH + 8], idx[BUFRDECO_PATH_LENGTH + 8];
+
+    memset(rd, 0, sizeof(struct bufr2tac_store_reader));
+    if (bufr2tac_store_paths(log, idx, sizeof(log), base))
+        return 1;
+
+    // The log. A record partially written at the end is not counted
+    if ((rd->log_map = bufr2tac_store_map(log, &rd->log_size)) == NULL)
+        return 1;
+    h = (const struct bufr2tac_store_header*)rd->log_map;
+    if (bufr2tac_store_check_header(h, BUFR2TAC_STORE_LOG_MAGIC, sizeof(struct bufr2tac_store_record))) {
+        bufr2tac_store_reader_close(rd);
+        return 1;
+    }
+    rd->rec = (const struct bufr2tac_store_record*)((const char*)rd->log_map + sizeof(struct bufr2tac_store_header));
+    rd->nrecords = (rd->log_size - sizeof(struct bufr2tac_store_header)) / sizeof(struct bufr2tac_store_record);
+
+    // The index, if any and valid. Else every record is searched one by one
+    if ((rd->idx_map = bufr2tac_store_map(idx, &rd->idx_size)) == NULL)
+        return 0;
+    h = (const struct bufr2tac_store_header*)rd->idx_map;
+    rd->nentries = (rd->idx_size - sizeof(struct bufr2tac_store_header)) / sizeof(struct bufr2tac_store_entry);
+    if (bufr2tac_store_check_header(h, BUFR2TAC_STORE_INDEX_MAGIC, sizeof(struct bufr2tac_store_entry))
+        || h->nrecords > rd->nrecords || rd->nentries != h->nrecords) {
+        munmap(rd->idx_map, rd->idx_size);
+        rd->idx_map = NULL;
+        rd->idx_size = 0;
+        rd->nentries = 0;
+        return 0;
+    }
+    rd->ent = (const struct bufr2tac_store_entry*)((const char*)rd->idx_map + sizeof(struct bufr2tac_store_header));
+    rd->nindexed = h->nrecords;
+    return 0;
+}
+
+/*!
+  \fn void bufr2tac_store_reader_close(struct bufr2tac_store_reader *rd)
+  \brief Unmap an observation store
+  \param [in,out] rd Pointer to the reader
+*/
+void bufr2tac_store_reader_close(struct bufr2tac_store_reader* rd)
+{
+    if (rd->log_map != NULL)
+        munmap(rd->log_map, rd->log_size);
+    if (rd->idx_map != NULL)
+        munmap(rd->idx_map, rd->idx_size);
+    memset(rd, 0, sizeof(struct bufr2tac_store_reader));
+}
+
+/*!
+  \fn static int bufr2tac_store_same_obs(const struct bufr2tac_store_record *a, const struct bufr2tac_store_record *b)
+  \brief Check if two records are copies of the same observation: same station, time and type of report
+  \return 1 if they are, 0 otherwise
+*/
+static int bufr2tac_store_same_obs(const struct bufr2tac_store_record* a, const struct bufr2tac_store_record* b)
+{
+    return a->time == b->time && strncmp(a->ident, b->ident, BUFR2TAC_STORE_IDENT_LENGTH) == 0
+        && strncmp(a->type, b->type, sizeof(a->type)) == 0;
+}
+
+/*!
+  \fn static size_t bufr2tac_store_insert(const struct bufr2tac_store_record** out, size_t nout, size_t n, const struct bufr2tac_store_record* r)
+  \brief Insert a record in an array sorted from the newest, keeping at most \a n records
+  \return The new number of records in array
+
+  Records are inserted from the last appended, so an observation stored more than once keeps the last copy.
+  Records of the same time but of other type of report, as a SYNOP and a TEMP, are all kept, the first inserted first
+*/
+static size_t bufr2tac_store_insert(const struct bufr2tac_store_record** out, size_t nout, size_t n,
+    const struct bufr2tac_store_record* r)
+{
+    size_t i, j;
+
+    for (i = 0; i < nout && out[i]->time > r->time; i++)
+        ;
+    for (; i < nout && out[i]->time == r->time; i++) {
+        if (bufr2tac_store_same_obs(out[i], r))
+            return nout;
+    }
+    if (i == n)
+        return nout;
+    if (nout == n)
+        nout--;
+    for (j = nout; j > i; j--)
+        out[j] = out[j - 1];
+    out[i] = r;
+    return nout + 1;
+}
+
+/*!
+  \fn size_t bufr2tac_store_last(const struct bufr2tac_store_reader *rd, const char *ident, const struct bufr2tac_store_record **out, size_t n)
+  \brief Get the last observations of a station, the newest first
+  \param [in] rd Pointer to the reader
+  \param [in] ident Key of station, as '08221' or a WIGOS id for stations without index
+  \param [out] out Array where to set the pointers to the records found
+  \param [in] n Max number of records to get, dimension of \a out
+  \return The number of records found
+
+  An observation stored more than once, same time and type of report, is got once, the last copy stored
+*/
+size_t bufr2tac_store_last(const struct bufr2tac_store_reader* rd, const char* ident,
+    const struct bufr2tac_store_record** out, size_t n)
+{
+    struct bufr2tac_store_entry key;
+    uint64_t lo, hi, mid, i;
+    size_t nout = 0;
+
+    if (n == 0 || ident == NULL)
+        return 0;
+    memset(&key, 0, sizeof(key));
+    snprintf(key.ident, sizeof(key.ident), "%s", ident);
+
+    // Records not indexed yet, from the last appended
+    for (i = rd->nrecords; i > rd->nindexed; i--) {
+        if (strncmp(rd->rec[i - 1].ident, key.ident, BUFR2TAC_STORE_IDENT_LENGTH) == 0)
+            nout = bufr2tac_store_insert(out, nout, n, &rd->rec[i - 1]);
+    }
+
+    // First entry after the ones of station, then back to get the newest
+    key.time = INT64_MAX;
+    key.record = UINT64_MAX;
+    for (lo = 0, hi = rd->nentries; lo < hi;) {
+        mid = lo + (hi - lo) / 2;
+        if (bufr2tac_store_entry_cmp(&rd->ent[mid], &key) <= 0)
+            lo = mid + 1;
+        else
+            hi = mid;
+    }
+    for (i = lo; i > 0 && strncmp(rd->ent[i - 1].ident, key.ident, BUFR2TAC_STORE_IDENT_LENGTH) == 0; i--) {
+        if (rd->ent[i - 1].record >= rd->nrecords)
+            continue;
+        // Older than all the records found, so the rest are too. One of the same time as the last found is
+        // either a copy of a record found or would be inserted after it, out of array, so it is also the end
+        if (nout == n && rd->ent[i - 1].time <= out[n - 1]->time)
+            break;
+        nout = bufr2tac_store_insert(out, nout, n, &rd->rec[rd->ent[i - 1].record]);
+    }
+    return nout;
+}
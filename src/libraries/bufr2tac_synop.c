@@ -76,25 +76,52 @@ char* guess_WMO_region_synop(struct synop_chunks* syn)
 }
 
 /*!
-  \fn int parse_subset_as_synop (struct metreport *m, struct bufr2tac_subset_state *s, struct bufr_subset_sequence_data *sq, char *err )
-  \brief parses a subset sequence as an Land fixed SYNOP FM-12, SHIP FM-13 or SYNOP-mobil FM-14 report
+  \brief Parsers of SYNOP descriptors indexed by class X. NULL for the classes not used in a SYNOP
+
+  Class 08 is not here because it is checked for every descriptor before this dispatch
+*/
+static const syn_parse_x_function syn_parse_x[BUFR2TAC_NUM_X_CLASSES] = {
+    [1] = syn_parse_x01, // localization descriptors
+    [2] = syn_parse_x02, // Type of station descriptors
+    [4] = syn_parse_x04, // Date and time descriptors
+    [5] = syn_parse_x05, // Horizontal position. Latitude
+    [6] = syn_parse_x06, // Horizontal position. Longitude
+    [7] = syn_parse_x07, // Vertical position
+    [10] = syn_parse_x10, // Air Pressure descriptors
+    [11] = syn_parse_x11, // wind  data
+    [12] = syn_parse_x12, // Temperature descriptors
+    [13] = syn_parse_x13, // Humidity and precipitation data
+    [14] = syn_parse_x14, // Radiation
+    [20] = syn_parse_x20, // Cloud data
+    [22] = syn_parse_x22, // Oceanographic data
+    [31] = syn_parse_x31, // Replicators
+};
+
+/*!
+  \fn int synop_first_pass(struct metreport *m, struct bufr2tac_subset_state *s, struct bufr_subset_sequence_data *sq, uint8_t *batch, char *err)
+  \brief First pass of the parse of a subset sequence as a SYNOP, the sequential analysis of its descriptors
   \param [in,out] m Pointer to a struct \ref metreport where set some results
   \param [in,out] s Pointer to a struct \ref bufr2tac_subset_state
   \param [in] sq Pointer to a struct \ref bufr_subset_sequence_data with the parsed sequence on input
+  \param [in,out] batch Array of SYNOP_BATCH_* marks for every descriptor of \a sq, or NULL
   \param [out] err String with detected errors, if any
   \return 0 if all is OK, 1 otherwise (also fills the \a err string)
+
+  The descriptors marked with SYNOP_BATCH_SKIP in \a batch are not parsed, they are left to a struct \ref bufr2tac_synop_batch.
+  Every marked descriptor reached out of a significance qualifier sequence is also marked with SYNOP_BATCH_ACTIVE
 */
-int parse_subset_as_synop(struct metreport* m, struct bufr2tac_subset_state* s, struct bufr_subset_sequence_data* sq, char* err)
+int synop_first_pass(struct metreport* m, struct bufr2tac_subset_state* s, struct bufr_subset_sequence_data* sq, uint8_t* batch, char* err)
 {
     size_t is;
-    char aux[32];
     struct synop_chunks* syn;
+    syn_parse_x_function parse_x;
 
     // An auxiliar pointer
     syn = &m->synop;
 
     // clean data
     bufr2tac_clean_synop_chunks(syn);
+    m->dirty |= METREPORT_DIRTY_SYNOP;
 
     // reject if still not coded type
     if (strcmp(s->type_report, "AAXX") && strcmp(s->type_report, "BBXX") && strcmp(s->type_report, "OOXX")) {
@@ -135,6 +162,12 @@ int parse_subset_as_synop(struct metreport* m, struct bufr2tac_subset_state* s,
             continue;
         }
 
+        if (batch != NULL && batch[is]) {
+            batch[is] |= SYNOP_BATCH_ACTIVE;
+            if (batch[is] & SYNOP_BATCH_SKIP)
+                continue;
+        }
+
         s->i = is;
         s->ival = (int)(sq->sequence[is].val);
         s->val = sq->sequence[is].val;
@@ -143,72 +176,31 @@ int parse_subset_as_synop(struct metreport* m, struct bufr2tac_subset_state* s,
             s->a1 = &sq->sequence[is - 1];
         }
 
-        switch (sq->sequence[is].desc.x) {
-        case 1: // localization descriptors
-            syn_parse_x01(syn, s);
-            break;
-
-        case 2: // Type of station descriptors
-            syn_parse_x02(syn, s);
-            break;
-
-        case 4: // Date and time descriptors
-            syn_parse_x04(syn, s);
-            break;
-
-        case 5: // Horizontal position. Latitude
-            syn_parse_x05(syn, s);
-            break;
-
-        case 6: // Horizontal position. Longitude
-            syn_parse_x06(syn, s);
-            break;
-
-        case 7: // Vertical position
-            syn_parse_x07(syn, s);
-            break;
-
-        case 10: // Air Pressure descriptors
-            syn_parse_x10(syn, s);
-            break;
-
-        case 11: // wind  data
-            syn_parse_x11(syn, s);
-            break;
-
-        case 12: // Temperature descriptors
-            syn_parse_x12(syn, s);
-            break;
-
-        case 13: // Humidity and precipitation data
-            syn_parse_x13(syn, s);
-            break;
-
-        case 14: // Radiation
-            syn_parse_x14(syn, s);
-            break;
-
-        case 20: // Cloud data
-            syn_parse_x20(syn, s);
-            break;
-
-        case 22: // Oceanographic data
-            syn_parse_x22(syn, s);
-            break;
-
-        case 31: // Replicators
-            syn_parse_x31(syn, s);
-            break;
-
-        default:
-            break;
+        if (sq->sequence[is].desc.x < BUFR2TAC_NUM_X_CLASSES && (parse_x = syn_parse_x[sq->sequence[is].desc.x]) != NULL) {
+            parse_x(syn, s);
         }
     }
 
+    return 0;
+}
+
+/*!
+  \fn int synop_second_pass(struct metreport *m, struct bufr2tac_subset_state *s, char *err)
+  \brief Second pass of the parse of a subset sequence as a SYNOP, with global results and consistence analysis
+  \param [in,out] m Pointer to a struct \ref metreport with the chunks set by \ref synop_first_pass
+  \param [in,out] s Pointer to a struct \ref bufr2tac_subset_state as left by \ref synop_first_pass
+  \param [out] err String with detected errors, if any
+  \return 0 if all is OK, 1 otherwise (also fills the \a err string)
+*/
+int synop_second_pass(struct metreport* m, struct bufr2tac_subset_state* s, char* err)
+{
+    char aux[32];
+    struct synop_chunks* syn = &m->synop;
+
     /* Check about needed descriptors */
     // Station identifier is mandatory, either WMO or WIGOS
     if (((s->mask & SUBSET_MASK_HAVE_WMO_ID) == 0) && ((s->mask & SUBSET_MASK_HAVE_WIGOS_ID) == 0)) {
-        snprintf(err, ERR_SIZE, "bufr2tac: %s(): lack of mandatory WMO or WIGOS station identifier", __func__);
+        snprintf(err, ERR_SIZE, "bufr2tac: parse_subset_as_synop(): lack of mandatory WMO or WIGOS station identifier");
         return 1;
     }
 
@@ -216,7 +208,7 @@ int parse_subset_as_synop(struct metreport* m, struct bufr2tac_subset_state* s,
     if (((s->mask & SUBSET_MASK_HAVE_LATITUDE) == 0) || 
         ((s->mask & SUBSET_MASK_HAVE_LONGITUDE) == 0))
     {
-        snprintf(err, ERR_SIZE, "bufr2tac: %s(): lack of mandatory station coordinates", __func__);
+        snprintf(err, ERR_SIZE, "bufr2tac: parse_subset_as_synop(): lack of mandatory station coordinates");
         return 1;
     }
 
@@ -226,7 +218,7 @@ int parse_subset_as_synop(struct metreport* m, struct bufr2tac_subset_state* s,
         ((s->mask & SUBSET_MASK_HAVE_DAY) == 0) || 
         ((s->mask & SUBSET_MASK_HAVE_HOUR) == 0) || 
         ((s->mask & SUBSET_MASK_HAVE_MINUTE) == 0)) {
-        snprintf(err, ERR_SIZE, "bufr2tac: %s(): lack of mandatory date/time descriptor in sequence", __func__);
+        snprintf(err, ERR_SIZE, "bufr2tac: parse_subset_as_synop(): lack of mandatory date/time descriptor in sequence");
         return 1;
     }
 
@@ -245,7 +237,7 @@ int parse_subset_as_synop(struct metreport* m, struct bufr2tac_subset_state* s,
             syn->s0.iii[2] = '0';
             syn->s0.iii[3] = 0;
         } else {
-            snprintf(err, ERR_SIZE, "bufr2tac: %s(): lack of mandatory index station for AAXX report", __func__);
+            snprintf(err, ERR_SIZE, "bufr2tac: parse_subset_as_synop(): lack of mandatory index station for AAXX report");
             return 1;
         }
     }
@@ -389,3 +381,19 @@ int parse_subset_as_synop(struct metreport* m, struct bufr2tac_subset_state* s,
     // If finally we arrive here, It succeded
     return 0;
 }
+
+/*!
+  \fn int parse_subset_as_synop (struct metreport *m, struct bufr2tac_subset_state *s, struct bufr_subset_sequence_data *sq, char *err )
+  \brief parses a subset sequence as an Land fixed SYNOP FM-12, SHIP FM-13 or SYNOP-mobil FM-14 report
+  \param [in,out] m Pointer to a struct \ref metreport where set some results
+  \param [in,out] s Pointer to a struct \ref bufr2tac_subset_state
+  \param [in] sq Pointer to a struct \ref bufr_subset_sequence_data with the parsed sequence on input
+  \param [out] err String with detected errors, if any
+  \return 0 if all is OK, 1 otherwise (also fills the \a err string)
+*/
+int parse_subset_as_synop(struct metreport* m, struct bufr2tac_subset_state* s, struct bufr_subset_sequence_data* sq, char* err)
+{
+    if (synop_first_pass(m, s, sq, NULL, err))
+        return 1;
+    return synop_second_pass(m, s, err);
+}
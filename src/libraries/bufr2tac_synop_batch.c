@@ -0,0 +1,566 @@
+/***************************************************************************
+ *   Copyright (C) 2013-2026 by Guillermo Ballester Valor                  *
+ *   gbv@ogimet.com                                                        *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.             *
+ ***************************************************************************/
+/*!
+ \file bufr2tac_synop_batch.c
+ \brief This file has the code to get the SYNOP reports of all subsets of a compressed BUFR from a template
+
+ In a compressed BUFR all subsets have the same descriptors, so a SYNOP template is got from the first pass of parse
+ of a subset. The descriptors with station identification and position are parsed again for every subset, and
+ temperatures, pressures, wind and cloud cover are coded for all subsets from the columns of values of compressed data.
+ If any other descriptor has not the same value in all subsets, the template is not used
+*/
+#include "bufr2tac.h"
+
+/*!
+  \fn static enum bufr2tac_synop_batch_kind synop_batch_kind(const struct bufr_descriptor *d, uint8_t *mark)
+  \brief Get how a descriptor of a SYNOP template is set for every subset
+  \param [in] d Pointer to the struct \ref bufr_descriptor
+  \param [out] mark SYNOP_BATCH_WATCH and SYNOP_BATCH_SKIP marks for the descriptor
+  \return The kind of item, SYNOP_BATCH_NONE if it is the same for all subsets
+*/
+static enum bufr2tac_synop_batch_kind synop_batch_kind(const struct bufr_descriptor* d, uint8_t* mark)
+{
+    *mark = SYNOP_BATCH_WATCH | SYNOP_BATCH_SKIP;
+    switch (d->x) {
+    case 1:
+        // The WMO index is also parsed in template, the WMO region is guessed from it
+        if (d->y == 1 || d->y == 2) {
+            *mark = SYNOP_BATCH_WATCH;
+            return SYNOP_BATCH_PARSE;
+        }
+        if (d->y == 15 || d->y == 18 || d->y == 19 || (d->y >= 125 && d->y <= 128))
+            return SYNOP_BATCH_PARSE;
+        break;
+    case 2:
+        // iw is needed to code ff
+        if (d->y == 2) {
+            *mark = SYNOP_BATCH_WATCH;
+            return SYNOP_BATCH_NONE;
+        }
+        break;
+    case 5:
+    case 6:
+        if (d->y == 1 || d->y == 2)
+            return SYNOP_BATCH_PARSE;
+        break;
+    case 7:
+        if (d->y == 1 || d->y == 30 || d->y == 31)
+            return SYNOP_BATCH_PARSE;
+        break;
+    case 10:
+        if (d->y == 4)
+            return SYNOP_BATCH_PO;
+        if (d->y == 51)
+            return SYNOP_BATCH_P;
+        break;
+    case 11:
+        if (d->y == 1 || d->y == 11)
+            return SYNOP_BATCH_DD;
+        if (d->y == 2 || d->y == 12)
+            return SYNOP_BATCH_FF;
+        // Also sets ff
+        if (d->y == 84) {
+            *mark = SYNOP_BATCH_WATCH;
+            return SYNOP_BATCH_NONE;
+        }
+        break;
+    case 12:
+        if (d->y == 1 || d->y == 4 || d->y == 101 || d->y == 104)
+            return SYNOP_BATCH_T;
+        if (d->y == 3 || d->y == 6 || d->y == 103 || d->y == 106)
+            return SYNOP_BATCH_TD;
+        break;
+    case 20:
+        if (d->y == 10)
+            return SYNOP_BATCH_N;
+        break;
+    default:
+        break;
+    }
+    *mark = 0;
+    return SYNOP_BATCH_NONE;
+}
+
+/*!
+  \fn static int synop_batch_is_constant(const struct bufrdeco_compressed_columns *c, const struct bufrdeco_compressed_ref *r, buf_t iref)
+  \brief Check if a compressed reference has the same value in all subsets
+  \param [in] c Pointer to the struct \ref bufrdeco_compressed_columns
+  \param [in] r Pointer to the struct \ref bufrdeco_compressed_ref
+  \param [in] iref Index of \a r in compressed references
+  \return 1 if the value is the same in all subsets, 0 otherwise
+*/
+static int synop_batch_is_constant(const struct bufrdeco_compressed_columns* c, const struct bufrdeco_compressed_ref* r, buf_t iref)
+{
+    buf_t k;
+    const double* v;
+
+    if (r->has_data == 0 || r->inc_bits == 0)
+        return 1;
+    if (c->kind[iref] == BUFRDECO_COLUMN_NONE)
+        return 0;
+
+    v = c->val + (size_t)iref * c->nsubsets;
+    for (k = 1; k < c->nsubsets; k++) {
+        if (v[k] != v[0])
+            return 0;
+    }
+    return 1;
+}
+
+/*!
+  \fn static int synop_batch_check_index(struct bufr2tac_synop_batch *sb, const struct bufrdeco_compressed_columns *c)
+  \brief Check if the WMO index of all subsets gives the same results in the template
+  \param [in] sb Pointer to the struct \ref bufr2tac_synop_batch with its items
+  \param [in] c Pointer to the struct \ref bufrdeco_compressed_columns
+  \return 0 if the template can be used for all subsets, 1 otherwise
+
+  The WMO region is guessed from II and iii in the first pass, and some x-class parsers depend on it and on the
+  index itself. Both must be the same for all subsets
+*/
+static int synop_batch_check_index(struct bufr2tac_synop_batch* sb, const struct bufrdeco_compressed_columns* c)
+{
+    size_t i, nII = 0, niii = 0;
+    buf_t k, iII = 0, iiii = 0;
+    const double *v, *vII, *viii;
+    char II[4], iii[4], A1[4], Reg[4], A10[4], Reg0[4];
+    int portugal0 = 0, portugal;
+
+    for (i = 0; i < sb->nitems; i++) {
+        if (sb->item[i].kind != SYNOP_BATCH_PARSE || sb->item[i].a.desc.x != 1 || sb->item[i].a.desc.y > 2)
+            continue;
+
+        // Present in all or no subsets
+        v = c->val + (size_t)sb->item[i].iref * c->nsubsets;
+        for (k = 1; k < c->nsubsets; k++) {
+            if ((v[k] == MISSING_REAL) != (v[0] == MISSING_REAL))
+                return 1;
+        }
+
+        if (sb->item[i].a.desc.y == 1) {
+            nII++;
+            iII = sb->item[i].iref;
+        } else {
+            niii++;
+            iiii = sb->item[i].iref;
+        }
+    }
+
+    if (nII > 1 || niii > 1)
+        return 1;
+    if (nII == 0 || niii == 0)
+        return 0;
+
+    vII = c->val + (size_t)iII * c->nsubsets;
+    viii = c->val + (size_t)iiii * c->nsubsets;
+    if (vII[0] == MISSING_REAL || viii[0] == MISSING_REAL)
+        return 0;
+
+    for (k = 0; k < c->nsubsets; k++) {
+        snprintf(II, sizeof(II), "%02d", (int)vII[k]);
+        snprintf(iii, sizeof(iii), "%03d", (int)viii[k]);
+        A1[0] = 0;
+        Reg[0] = 0;
+        guess_WMO_region(A1, Reg, II, iii);
+        portugal = (strcmp(II, "08") == 0 && iii[0] == '5');
+        if (k == 0) {
+            strcpy(A10, A1);
+            strcpy(Reg0, Reg);
+            portugal0 = portugal;
+        } else if (strcmp(A1, A10) || strcmp(Reg, Reg0) || portugal != portugal0) {
+            return 1;
+        }
+    }
+    return 0;
+}
+
+/*!
+  \fn static void synop_batch_code_column(struct bufr2tac_synop_batch *sb, size_t i, const double *v)
+  \brief Code the values of an item for all subsets
+  \param [in,out] sb Pointer to the struct \ref bufr2tac_synop_batch
+  \param [in] i Index of item
+  \param [in] v Column with the values of the item for all subsets
+
+  Codes are the same than the ones set by the x-class parsers. For ff, the code is ff in the first 4 chars and fff,
+  if any, in the last 4 ones
+*/
+static void synop_batch_code_column(struct bufr2tac_synop_batch* sb, size_t i, const double* v)
+{
+    buf_t k;
+    double ff;
+    char(*cd)[8] = sb->code + i * sb->nsubsets;
+
+    for (k = 0; k < sb->nsubsets; k++) {
+        cd[k][0] = 0;
+        if (v[k] == MISSING_REAL)
+            continue;
+
+        switch (sb->item[i].kind) {
+        case SYNOP_BATCH_T:
+        case SYNOP_BATCH_TD:
+            kelvin_to_snTTT(cd[k], sizeof(cd[k]), v[k]);
+            break;
+        case SYNOP_BATCH_PO:
+        case SYNOP_BATCH_P:
+            pascal_to_PPPP(cd[k], sizeof(cd[k]), v[k]);
+            break;
+        case SYNOP_BATCH_DD:
+            direction_to_0877(cd[k], sizeof(sb->syn.s1.dd), (int)v[k]);
+            break;
+        case SYNOP_BATCH_FF:
+            ff = v[k];
+            if (sb->syn.s0.iw[0] == '4')
+                ff *= 1.94384449;
+            cd[k][4] = 0;
+            if (ff < 100.0) {
+                snprintf(cd[k], sizeof(sb->syn.s1.ff), "%02d", (int)(ff + 0.5));
+            } else {
+                snprintf(cd[k], sizeof(sb->syn.s1.ff), "99");
+                snprintf(cd[k] + 4, sizeof(sb->syn.s1.fff), "%03d", (int)(ff + 0.5));
+            }
+            break;
+        case SYNOP_BATCH_N:
+            percent_to_okta(cd[k], sizeof(cd[k]), v[k]);
+            break;
+        default:
+            break;
+        }
+    }
+}
+
+/*!
+  \fn int bufr2tac_synop_batch_prepare(struct bufr2tac_synop_batch *sb, struct metreport *m, struct bufrdeco *b, const char *type_report, char *err)
+  \brief Prepare a SYNOP template for the subsets of a compressed BUFR whose current subset has been decoded
+  \param [out] sb Pointer to the struct \ref bufr2tac_synop_batch
+  \param [in,out] m Pointer to a struct \ref metreport used as work area. Its synop chunks are overwritten
+  \param [in,out] b Pointer to the struct \ref bufrdeco with a subset already decoded in its member \a seq
+  \param [in] type_report The type of report, AAXX, BBXX or OOXX
+  \param [out] err String with detected errors, if any
+  \return 0 if all is OK, 1 if the subsets have to be parsed one by one
+
+  The template is not used if any descriptor not set by subset has different values in the subsets, if the WMO index
+  of subsets is in different region, or if there are several descriptors for N or other than 0 11 002 and 0 11 012 for ff
+*/
+int bufr2tac_synop_batch_prepare(struct bufr2tac_synop_batch* sb, struct metreport* m, struct bufrdeco* b,
+    const char* type_report, char* err)
+{
+    size_t i, n, is, nn = 0, first_ff = (size_t)-1;
+    buf_t k, iref;
+    uint8_t mark;
+    enum bufr2tac_synop_batch_kind kind;
+    struct bufr_subset_sequence_data* sq = &b->seq;
+    const struct bufrdeco_compressed_columns* c = &b->cols;
+    struct bufrdeco_compressed_ref* r;
+
+    sb->ready = 0;
+    sb->nitems = 0;
+    if (b->sec3.compressed == 0 || b->sec3.subsets < 2 || sq->nd == 0)
+        return 1;
+
+    if (c->ready == 0 && bufrdeco_decode_compressed_columns(b)) {
+        snprintf(err, ERR_SIZE, "bufr2tac: %s(): %s", __func__, b->error);
+        return 1;
+    }
+
+    if (sb->dmark < sq->nd) {
+        free((void*)sb->mark);
+        if ((sb->mark = (uint8_t*)malloc(sq->nd)) == NULL) {
+            sb->dmark = 0;
+            snprintf(err, ERR_SIZE, "bufr2tac: %s(): Cannot allocate memory for marks", __func__);
+            return 1;
+        }
+        sb->dmark = sq->nd;
+    }
+    memset(sb->mark, 0, sq->nd);
+
+    // The atoms of subset are the references of the events of bitacora, except the associated fields
+    is = 0;
+    for (k = 0; k < b->bitacora.nd; k++) {
+        if (b->bitacora.event[k].ref_index < 0)
+            continue;
+        iref = (buf_t)b->bitacora.event[k].ref_index;
+        r = &b->refs.refs[iref];
+
+        kind = SYNOP_BATCH_NONE;
+        mark = 0;
+        if (r->is_associated == 0) {
+            if (is >= sq->nd)
+                return 1;
+            kind = synop_batch_kind(&sq->sequence[is].desc, &mark);
+            sb->mark[is] = mark;
+        }
+
+        if (kind == SYNOP_BATCH_NONE) {
+            if (synop_batch_is_constant(c, r, iref) == 0)
+                return 1;
+        } else {
+            if (sb->nitems == SYNOP_BATCH_NITEMS)
+                return 1;
+            // Codes are got from numeric columns
+            if (kind != SYNOP_BATCH_PARSE && c->kind[iref] != BUFRDECO_COLUMN_NUMERIC)
+                return 1;
+            sb->item[sb->nitems].is = is;
+            sb->item[sb->nitems].iref = iref;
+            sb->item[sb->nitems].kind = kind;
+            sb->item[sb->nitems].a.desc = sq->sequence[is].desc;
+            sb->nitems++;
+        }
+
+        if (r->is_associated == 0)
+            is++;
+    }
+    if (is != sq->nd)
+        return 1;
+
+    if (synop_batch_check_index(sb, c))
+        return 1;
+
+    // The template
+    bufr2tac_clean_subset_state(&sb->st);
+    snprintf(sb->st.type_report, sizeof(sb->st.type_report), "%s", type_report);
+    if (synop_first_pass(m, &sb->st, sq, sb->mark, err))
+        return 1;
+
+    // Only the items out of significance qualifier sequences are parsed
+    for (i = 0, n = 0; i < sb->nitems; i++) {
+        if ((sb->mark[sb->item[i].is] & SYNOP_BATCH_ACTIVE) == 0)
+            continue;
+        if (n < i)
+            sb->item[n] = sb->item[i];
+        memcpy(&sb->item[n].a, &sq->sequence[sb->item[n].is], sizeof(struct bufr_atom_data));
+        if (sb->item[n].kind == SYNOP_BATCH_FF && first_ff == (size_t)-1)
+            first_ff = sb->item[n].is;
+        else if (sb->item[n].kind == SYNOP_BATCH_N)
+            nn++;
+        n++;
+    }
+    sb->nitems = n;
+
+    // N sets h when is 0, so there must be just one
+    if (nn > 1)
+        return 1;
+
+    // ff is coded with the final iw of template, and no other descriptor can set it
+    for (is = 0; is < sq->nd && first_ff != (size_t)-1; is++) {
+        if ((sb->mark[is] & SYNOP_BATCH_ACTIVE) == 0 || (sb->mark[is] & SYNOP_BATCH_SKIP))
+            continue;
+        if (sq->sequence[is].desc.x == 11 && sq->sequence[is].desc.y == 84)
+            return 1;
+        if (sq->sequence[is].desc.x == 2 && sq->sequence[is].desc.y == 2 && is > first_ff)
+            return 1;
+    }
+
+    memcpy(&sb->syn, &m->synop, sizeof(struct synop_chunks));
+    memcpy(sb->type, m->type, sizeof(sb->type));
+    sb->mask = sb->st.mask;
+    sb->lat = sb->st.lat;
+    sb->lon = sb->st.lon;
+    sb->alt = sb->st.alt;
+    sb->altb = sb->st.altb;
+    memcpy(sb->name, sb->st.name, sizeof(sb->name));
+    sb->ne = sb->st.e.ne;
+    sb->full = sb->st.e.full;
+
+    // Now the codes of all subsets, item by item
+    sb->nsubsets = c->nsubsets;
+    if (sb->dcode < sb->nitems * sb->nsubsets) {
+        free((void*)sb->code);
+        if ((sb->code = (char(*)[8])malloc(sb->nitems * sb->nsubsets * sizeof(sb->code[0]))) == NULL) {
+            sb->dcode = 0;
+            snprintf(err, ERR_SIZE, "bufr2tac: %s(): Cannot allocate memory for codes", __func__);
+            return 1;
+        }
+        sb->dcode = sb->nitems * sb->nsubsets;
+    }
+    for (i = 0; i < sb->nitems; i++) {
+        if (sb->item[i].kind != SYNOP_BATCH_PARSE)
+            synop_batch_code_column(sb, i, c->val + (size_t)sb->item[i].iref * c->nsubsets);
+    }
+
+    sb->ready = 1;
+    return 0;
+}
+
+/*!
+  \fn int bufr2tac_synop_batch_report(struct bufr2tac_synop_batch *sb, struct metreport *m, buf_t subset, struct bufrdeco *b, char *err)
+  \brief Set and print the synop report of a subset from a template got by \ref bufr2tac_synop_batch_prepare
+  \param [in,out] sb Pointer to the struct \ref bufr2tac_synop_batch
+  \param [out] m Pointer to a struct \ref metreport where set the results
+  \param [in] subset Index of subset. First subset has index 0
+  \param [in,out] b Pointer to the struct \ref bufrdeco used in \ref bufr2tac_synop_batch_prepare
+  \param [out] err String with detected errors, if any
+  \return 0 if all is OK, 1 otherwise (also fills the \a err string)
+*/
+int bufr2tac_synop_batch_report(struct bufr2tac_synop_batch* sb, struct metreport* m, buf_t subset, struct bufrdeco* b,
+    char* err)
+{
+    size_t i;
+    const char* cd;
+    struct bufr2tac_synop_batch_item* it;
+    struct bufr2tac_subset_state* s = &sb->st;
+    struct synop_chunks* syn = &m->synop;
+
+    if (sb->ready == 0 || subset >= sb->nsubsets) {
+        snprintf(err, ERR_SIZE, "bufr2tac: %s(): No template for subset %u", __func__, (unsigned int)subset);
+        return 1;
+    }
+
+    memcpy(syn, &sb->syn, sizeof(struct synop_chunks));
+    m->dirty |= METREPORT_DIRTY_SYNOP;
+    memcpy(m->type, sb->type, sizeof(m->type));
+
+    s->mask = sb->mask;
+    s->lat = sb->lat;
+    s->lon = sb->lon;
+    s->alt = sb->alt;
+    s->altb = sb->altb;
+    memcpy(s->name, sb->name, sizeof(s->name));
+    s->e.ne = sb->ne;
+    s->e.full = sb->full;
+
+    // The items in order of sequence, as in the first pass
+    for (i = 0; i < sb->nitems; i++) {
+        it = &sb->item[i];
+        cd = sb->code[i * sb->nsubsets + subset];
+        switch (it->kind) {
+        case SYNOP_BATCH_PARSE:
+            if (bufrdeco_get_atom_data_from_compressed_column(&it->a, &b->refs.refs[it->iref], it->iref, subset, b)) {
+                snprintf(err, ERR_SIZE, "bufr2tac: %s(): %s", __func__, b->error);
+                return 1;
+            }
+            s->i = it->is;
+            s->a = &it->a;
+            s->ival = (int)it->a.val;
+            s->val = it->a.val;
+            if (it->a.desc.x == 1)
+                syn_parse_x01(syn, s);
+            else if (it->a.desc.x == 5)
+                syn_parse_x05(syn, s);
+            else if (it->a.desc.x == 6)
+                syn_parse_x06(syn, s);
+            else
+                syn_parse_x07(syn, s);
+            break;
+
+        case SYNOP_BATCH_T:
+        case SYNOP_BATCH_TD:
+            if ((it->kind == SYNOP_BATCH_T && syn->s1.TTT[0]) || (it->kind == SYNOP_BATCH_TD && syn->s1.TdTdTd[0]))
+                break;
+            if (cd[0] == 0) {
+                it->a.val = b->cols.val[(size_t)it->iref * sb->nsubsets + subset];
+                if (BUFR2TAC_DEBUG_LEVEL > 0 && it->a.val != MISSING_REAL) {
+                    it->a.mask = 0;
+                    s->a = &it->a;
+                    bufr2tac_set_error(s, 1, "syn_parse_x12()->kelvin_to_snTTT()", "Unspected parse problem");
+                }
+                break;
+            }
+            if (it->kind == SYNOP_BATCH_T) {
+                syn->s1.sn1[0] = cd[0];
+                memcpy(syn->s1.TTT, cd + 1, 4);
+            } else {
+                syn->s1.sn2[0] = cd[0];
+                memcpy(syn->s1.TdTdTd, cd + 1, 4);
+            }
+            syn->mask |= SYNOP_SEC1;
+            break;
+
+        case SYNOP_BATCH_PO:
+        case SYNOP_BATCH_P:
+            if (cd[0] == 0)
+                break;
+            memcpy(it->kind == SYNOP_BATCH_PO ? syn->s1.PoPoPoPo : syn->s1.PPPP, cd, 5);
+            syn->mask |= SYNOP_SEC1;
+            break;
+
+        case SYNOP_BATCH_DD:
+            if (cd[0] == 0)
+                break;
+            strcpy(syn->s1.dd, cd);
+            syn->mask |= SYNOP_SEC1;
+            break;
+
+        case SYNOP_BATCH_FF:
+            if (cd[0] == 0)
+                break;
+            strcpy(syn->s1.ff, cd);
+            if (cd[4])
+                strcpy(syn->s1.fff, cd + 4);
+            syn->mask |= SYNOP_SEC1;
+            if (strcmp(syn->s1.dd, "00") == 0 && strcmp(syn->s1.ff, "00") != 0)
+                strcpy(syn->s1.dd, "99");
+            break;
+
+        case SYNOP_BATCH_N:
+            if (cd[0])
+                strcpy(syn->s1.N, cd);
+            break;
+
+        default:
+            break;
+        }
+    }
+
+    // check about h, as done by syn_parse_x20()
+    if (syn->s1.h[0] == '/' && syn->s1.N[0] == '0')
+        syn->s1.h[0] = '9';
+
+    if (synop_second_pass(m, s, err)) {
+        if (BUFR2TAC_DEBUG_LEVEL)
+            bufr2tac_print_error(&s->e);
+        return 1;
+    }
+    if (BUFR2TAC_DEBUG_LEVEL)
+        bufr2tac_print_error(&s->e);
+    return print_synop_report(m);
+}
+
+/*!
+  \fn void bufr2tac_synop_batch_init(struct bufr2tac_synop_batch *sb)
+  \brief Init a struct \ref bufr2tac_synop_batch before its first use
+  \param [in,out] sb Pointer to the struct \ref bufr2tac_synop_batch
+*/
+void bufr2tac_synop_batch_init(struct bufr2tac_synop_batch* sb)
+{
+    if (sb == NULL)
+        return;
+
+    memset(sb, 0, sizeof(struct bufr2tac_synop_batch));
+    bufr2tac_init_subset_state(&sb->st);
+}
+
+/*!
+  \fn void bufr2tac_synop_batch_free(struct bufr2tac_synop_batch *sb)
+  \brief Free the memory allocated in a struct \ref bufr2tac_synop_batch
+  \param [in,out] sb Pointer to the struct \ref bufr2tac_synop_batch
+*/
+void bufr2tac_synop_batch_free(struct bufr2tac_synop_batch* sb)
+{
+    if (sb == NULL)
+        return;
+
+    free((void*)sb->mark);
+    free((void*)sb->code);
+    sb->mark = NULL;
+    sb->code = NULL;
+    sb->dmark = 0;
+    sb->dcode = 0;
+    sb->ready = 0;
+    bufr2tac_free_subset_state(&sb->st);
+}
@@ -53,6 +53,27 @@ char* guess_WMO_region_temp(struct temp_chunks* t)
     }
 }
 
+/*!
+  \brief Parsers of TEMP descriptors indexed by class X. NULL for the classes not used in a TEMP
+
+  Class 08 is not here because it is checked for every descriptor before this dispatch
+*/
+static const temp_parse_x_function temp_parse_x[BUFR2TAC_NUM_X_CLASSES] = {
+    [1] = temp_parse_x01, // localization descriptors
+    [2] = temp_parse_x02, // Type of station descriptors
+    [4] = temp_parse_x04, // Date and time descriptors
+    [5] = temp_parse_x05, // Horizontal position. Latitude
+    [6] = temp_parse_x06, // Horizontal position. Longitude
+    [7] = temp_parse_x07, // Vertical position
+    [10] = temp_parse_x10, // Air Pressure descriptors
+    [11] = temp_parse_x11, // wind  data
+    [12] = temp_parse_x12, // Temperature descriptors
+    [20] = temp_parse_x20, // Cloud data
+    [22] = temp_parse_x22, // Oceanographic data
+    [31] = temp_parse_x31, // Replicators
+    [33] = temp_parse_x33, // Quality data
+};
+
 /*!
   \fn int parse_subset_as_temp(struct metreport *m, char *type, struct bufr_subset_sequence_data *sq, char *err)
   \brief parses a subset sequence as an Land fixed TEMP FM-35, TEMP SHIP FM-36, TEMP DROP FM-37 or TEMP MOBIL FM-38 report
@@ -70,6 +91,7 @@ int parse_subset_as_temp(struct metreport* m, struct bufr2tac_subset_state* s, s
     struct met_datetime dtm;
     struct temp_raw_data* r;
     struct temp_raw_wind_shear_data* w;
+    temp_parse_x_function parse_x;
 
     if (sq == NULL) {
         return 1;
@@ -79,18 +101,17 @@ int parse_subset_as_temp(struct metreport* m, struct bufr2tac_subset_state* s, s
 
     // clean data
     bufr2tac_clean_temp_chunks(t);
+    m->dirty |= METREPORT_DIRTY_TEMP;
 
-    // allocate memory for array of points in raw form
-    if ((r = (struct temp_raw_data*)calloc(1, sizeof(struct temp_raw_data))) == NULL) {
+    // The arrays of points in raw form are in the state and reused from previous subsets
+    r = &s->raw;
+    w = &s->wind_shear;
+    if (bufr2tac_temp_raw_data_reserve(r, RAW_TEMP_NMAX_POINTS) || bufr2tac_temp_raw_wind_shear_data_reserve(w, TEMP_NMAX_POINTS)) {
         snprintf(err, ERR_SIZE, "bufr2tac: parse_subset_as_temp(): Cannot allocate memory for raw data");
         return 1;
     }
-
-    if ((w = (struct temp_raw_wind_shear_data*)calloc(1, sizeof(struct temp_raw_wind_shear_data))) == NULL) {
-        snprintf(err, ERR_SIZE, "bufr2tac: parse_subset_as_temp(): Cannot allocate memory for raw data");
-        free((void*)(r));
-        return 1;
-    }
+    r->n = 0;
+    w->n = 0;
 
     // set pointers
     s->r = r;
@@ -117,121 +138,16 @@ int parse_subset_as_temp(struct metreport* m, struct bufr2tac_subset_state* s, s
             temp_parse_x08(t, s);
         }
 
-        switch (sq->sequence[is].desc.x) {
-        case 1: // localization descriptors
-            if (temp_parse_x01(t, s)) {
-                free((void*)(r));
-                free((void*)(w));
-                return 1;
-            }
-            break;
-
-        case 2: // Type of station descriptors
-            if (temp_parse_x02(t, s)) {
-                free((void*)(r));
-                free((void*)(w));
-                return 1;
-            }
-            break;
-
-        case 4: // Date and time descriptors
-            if (temp_parse_x04(t, s)) {
-                free((void*)(r));
-                free((void*)(w));
-                return 1;
-            }
-            break;
-
-        case 5: // Horizontal position. Latitude
-            if (temp_parse_x05(t, s)) {
-                free((void*)(r));
-                free((void*)(w));
-                return 1;
-            }
-            break;
-
-        case 6: // Horizontal position. Longitude
-            if (temp_parse_x06(t, s)) {
-                free((void*)(r));
-                free((void*)(w));
-                return 1;
-            }
-            break;
-
-        case 7: // Vertical position
-            if (temp_parse_x07(t, s)) {
-                free((void*)(r));
-                free((void*)(w));
-                return 1;
-            }
-            break;
-
-        case 10: // Air Pressure descriptors
-            if (temp_parse_x10(t, s)) {
-                free((void*)(r));
-                free((void*)(w));
-                return 1;
-            }
-            break;
-
-        case 11: // wind  data
-            if (temp_parse_x11(t, s)) {
-                free((void*)(r));
-                free((void*)(w));
-                return 1;
-            }
-            break;
-
-        case 12: // Temperature descriptors
-            if (temp_parse_x12(t, s)) {
-                free((void*)(r));
-                free((void*)(w));
-                return 1;
-            }
-            break;
-
-        case 20: // Cloud data
-            if (temp_parse_x20(t, s)) {
-                free((void*)(r));
-                free((void*)(w));
+        if (sq->sequence[is].desc.x < BUFR2TAC_NUM_X_CLASSES && (parse_x = temp_parse_x[sq->sequence[is].desc.x]) != NULL) {
+            if (parse_x(t, s)) {
                 return 1;
             }
-            break;
-
-        case 22: // Oceanographic data
-            if (temp_parse_x22(t, s)) {
-                free((void*)(r));
-                free((void*)(w));
-                return 1;
-            }
-            break;
-
-        case 31: // Replicators
-            if (temp_parse_x31(t, s)) {
-                free((void*)(r));
-                free((void*)(w));
-                return 1;
-            }
-            break;
-
-        case 33: // Quality data
-            if (temp_parse_x33(t, s)) {
-                free((void*)(r));
-                free((void*)(w));
-                return 1;
-            }
-            break;
-
-        default:
-            break;
         }
     }
 
     /* Check about needed descriptors */
     if (((s->mask & SUBSET_MASK_HAVE_LATITUDE) == 0) || ((s->mask & SUBSET_MASK_HAVE_LONGITUDE) == 0) || ((s->mask & SUBSET_MASK_HAVE_YEAR) == 0) || ((s->mask & SUBSET_MASK_HAVE_MONTH) == 0) || ((s->mask & SUBSET_MASK_HAVE_DAY) == 0) || ((s->mask & SUBSET_MASK_HAVE_HOUR) == 0) || ((s->mask & SUBSET_MASK_HAVE_MINUTE) == 0)) {
         snprintf(err, ERR_SIZE, "bufr2tac: parse_subset_as_temp(): lack of mandatory descriptor in sequence");
-        free((void*)(r));
-        free((void*)(w));
         return 1;
     }
 
@@ -265,8 +181,6 @@ int parse_subset_as_temp(struct metreport* m, struct bufr2tac_subset_state* s, s
         strcpy(t->d.s1.MiMi, "XX");
     } else {
         snprintf(err, ERR_SIZE, "bufr2tac: parse_subset_as_temp(): Unknown type TEMP report");
-        free((void*)(r));
-        free((void*)(w));
         return 1;
     }
     snprintf(m->type, sizeof(m->type), "%s%s", t->a.s1.MiMi, t->a.s1.MjMj);
@@ -316,15 +230,55 @@ int parse_subset_as_temp(struct metreport* m, struct bufr2tac_subset_state* s, s
     // Finally parse raw data to fill all needed points for a TEMP
     if (parse_temp_raw_data(t, r)) {
         snprintf(err, ERR_SIZE, "bufr2tac: parse_temp_raw_data(): Too much significant points");
-        free((void*)(r));
-        free((void*)(w));
         return 1;
     }
     parse_temp_raw_wind_shear_data(t, w);
+    return 0;
+}
+
+/*!
+  \fn int bufr2tac_temp_raw_data_reserve(struct temp_raw_data *r, size_t n)
+  \brief Assures that array of raw points in a \ref temp_raw_data has room for at least \a n points
+  \param [in,out] r Pointer to the struct
+  \param [in] n Number of points needed
+  \return 0 on success, 1 if cannot allocate memory
+*/
+int bufr2tac_temp_raw_data_reserve(struct temp_raw_data* r, size_t n)
+{
+    struct temp_raw_point_data* p;
+
+    if (n <= r->dim) {
+        return 0;
+    }
 
-    // Free memory
-    free((void*)(r));
-    free((void*)(w));
+    if ((p = (struct temp_raw_point_data*)realloc((void*)r->raw, n * sizeof(struct temp_raw_point_data))) == NULL) {
+        return 1;
+    }
+    r->raw = p;
+    r->dim = n;
+    return 0;
+}
+
+/*!
+  \fn int bufr2tac_temp_raw_wind_shear_data_reserve(struct temp_raw_wind_shear_data *w, size_t n)
+  \brief Assures that array of points in a \ref temp_raw_wind_shear_data has room for at least \a n points
+  \param [in,out] w Pointer to the struct
+  \param [in] n Number of points needed
+  \return 0 on success, 1 if cannot allocate memory
+*/
+int bufr2tac_temp_raw_wind_shear_data_reserve(struct temp_raw_wind_shear_data* w, size_t n)
+{
+    struct temp_raw_wind_shear_point* p;
+
+    if (n <= w->dim) {
+        return 0;
+    }
+
+    if ((p = (struct temp_raw_wind_shear_point*)realloc((void*)w->raw, n * sizeof(struct temp_raw_wind_shear_point))) == NULL) {
+        return 1;
+    }
+    w->raw = p;
+    w->dim = n;
     return 0;
 }
 
@@ -335,10 +289,11 @@ int parse_subset_as_temp(struct metreport* m, struct bufr2tac_subset_state* s, s
 int parse_temp_raw_data(struct temp_chunks* t, struct temp_raw_data* r)
 {
     int ix, is_over_100;
-    size_t i, j, isa = 0, isc = 0, ita = 0, itc = 0; // level counters
+    size_t i, isa = 0, isc = 0, ita = 0, itc = 0; // level counters
     size_t iwxa = 0, iwxc = 0, itb = 0, itd = 0;
     size_t iwd = 0, iwb = 0;
     size_t isav = 0, iscv = 0; // valid data counters for standard levels
+    size_t nwind; // index of last point with wind data plus 1
 
     if (t == NULL || r == NULL) {
         return 1;
@@ -351,6 +306,11 @@ int parse_temp_raw_data(struct temp_chunks* t, struct temp_raw_data* r)
     // Some default
     t->a.s1.id[0] = '/';
     t->c.s1.id[0] = '/';
+
+    // To know if there is wind data over a max wind level without scanning the profile for every one
+    for (nwind = r->n; nwind > 0 && r->raw[nwind - 1].ff == MISSING_REAL; nwind--)
+        ;
+
     for (i = 0; i < r->n; i++) {
         const struct temp_raw_point_data* d = &(r->raw[i]); // to make code easy
 
@@ -472,11 +432,8 @@ int parse_temp_raw_data(struct temp_chunks* t, struct temp_raw_data* r)
                 snprintf(t->c.s4.windx[iwxc].PmPmPm, sizeof(t->c.s4.windx[iwxc].PmPmPm), "%03d", ix); // PnPnPn
                 wind_to_dndnfnfnfn(t->c.s4.windx[iwxc].dmdmfmfmfm, sizeof(t->c.s4.windx[iwxc].dmdmfmfmfm), d->dd, d->ff); // dndnfnfnfn
                 // check if more wind data
-                for (j = i + 1; j < r->n; j++) {
-                    if (r->raw[j].ff != MISSING_REAL) {
-                        t->c.s4.windx[iwxc].no_last_wind = 1;
-                        break;
-                    }
+                if (nwind > i + 1) {
+                    t->c.s4.windx[iwxc].no_last_wind = 1;
                 }
                 if (ix && iwxc < TEMP_NMAXWIND_MAX) {
                     iwxc += 1;
@@ -487,11 +444,8 @@ int parse_temp_raw_data(struct temp_chunks* t, struct temp_raw_data* r)
                 ix = (int)(d->p * 0.01 + 0.5);
                 snprintf(t->a.s4.windx[iwxa].PmPmPm, sizeof(t->a.s4.windx[iwxa].PmPmPm), "%03d", ix % 1000); // PnPnPn.
                 wind_to_dndnfnfnfn(t->a.s4.windx[iwxa].dmdmfmfmfm, sizeof(t->a.s4.windx[iwxa].dmdmfmfmfm), d->dd, d->ff); // dndnfnfnfn
-                for (j = i + 1; j < r->n; j++) {
-                    if (r->raw[j].ff != MISSING_REAL) {
-                        t->a.s4.windx[iwxa].no_last_wind = 1;
-                        break;
-                    }
+                if (nwind > i + 1) {
+                    t->a.s4.windx[iwxa].no_last_wind = 1;
                 }
                 if (ix && iwxa < TEMP_NMAXWIND_MAX) {
                     iwxa += 1;
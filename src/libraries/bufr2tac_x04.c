@@ -690,22 +690,27 @@ int temp_parse_x04 ( struct temp_chunks *t, struct bufr2tac_subset_state *s )
               // Because of there are bufr reports with a lot of not significant points
               // we only collect the first one and significant points, i.e. those that flags are non zero
               // When flags are zero we just overwrite points
-              if ( s->r->n < ( RAW_TEMP_NMAX_POINTS ) &&
+              // The array is reused from previous subsets, so a new point is cleaned here
+              if ( s->r->n < s->r->dim &&
                    ( s->r->n == 0 || s->r->raw[s->r->n - 1].flags ) )
                 {
+                  memset ( & ( s->r->raw[s->r->n] ), 0, sizeof ( struct temp_raw_point_data ) );
                   s->r->n += 1; // Here we update the index
                 }
             }
-          s->r->raw[s->r->n - 1].dt = s->ival;
+          if ( s->r->n )
+            s->r->raw[s->r->n - 1].dt = s->ival;
         }
       else
         {
           // case of wind shear point
-          if ( ( int ) s->w->n < s->itval )
+          if ( ( int ) s->w->n < s->itval && s->w->n < s->w->dim )
             {
+              memset ( & ( s->w->raw[s->w->n] ), 0, sizeof ( struct temp_raw_wind_shear_point ) );
               s->w->n += 1;
             }
-          s->w->raw[s->w->n - 1].dt = s->ival;
+          if ( s->w->n )
+            s->w->raw[s->w->n - 1].dt = s->ival;
         }
       break;
 
@@ -159,7 +159,7 @@ int buoy_parse_x05(struct buoy_chunks* b, struct bufr2tac_subset_state* s)
   \param [in,out] s Pointer to a struct \ref bufr2tac_subset_state where is stored needed information in sequential analysis
   \return 0 on success, 1 if problems when processing. If a descriptor is not processed returns 0 anyway
 */
-int climat_parse_x05(const struct climat_chunks* c, struct bufr2tac_subset_state* s)
+int climat_parse_x05(struct climat_chunks* c, struct bufr2tac_subset_state* s)
 {
     if (s->a->mask & DESCRIPTOR_VALUE_MISSING)
         return 0;
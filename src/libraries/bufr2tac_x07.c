@@ -143,13 +143,13 @@ int syn_parse_x07(struct synop_chunks* syn, struct bufr2tac_subset_state* s)
 }
 
 /*!
-  \fn int buoy_parse_x07 ( const struct buoy_chunks *b, struct bufr2tac_subset_state *s )
+  \fn int buoy_parse_x07 ( struct buoy_chunks *b, struct bufr2tac_subset_state *s )
   \brief Parse a expanded descriptor with X = 07 (Vertical position/depths)
   \param [in] b Pointer to a struct \ref buoy_chunks where to set the results
   \param [in,out] s Pointer to a struct \ref bufr2tac_subset_state where is stored needed information in sequential analysis
   \return 0 on success, 1 if problems when processing. If a descriptor is not processed returns 0 anyway
 */
-int buoy_parse_x07(const struct buoy_chunks* b, struct bufr2tac_subset_state* s)
+int buoy_parse_x07(struct buoy_chunks* b, struct bufr2tac_subset_state* s)
 {
 
     if (s->a->mask & DESCRIPTOR_VALUE_MISSING) {
@@ -181,13 +181,13 @@ int buoy_parse_x07(const struct buoy_chunks* b, struct bufr2tac_subset_state* s)
 }
 
 /*!
-  \fn int climat_parse_x07 ( const struct climat_chunks *c, struct bufr2tac_subset_state *s )
+  \fn int climat_parse_x07 ( struct climat_chunks *c, struct bufr2tac_subset_state *s )
   \brief Parse a expanded descriptor with X = 07 (Vertical position/heights)
   \param [in] c Pointer to a struct \ref climat_chunks where to set the results
   \param [in,out] s Pointer to a struct \ref bufr2tac_subset_state where is stored needed information in sequential analysis
   \return 0 on success, 1 if problems when processing. If a descriptor is not processed returns 0 anyway
 */
-int climat_parse_x07(const struct climat_chunks* c, struct bufr2tac_subset_state* s)
+int climat_parse_x07(struct climat_chunks* c, struct bufr2tac_subset_state* s)
 {
     if (s->a->mask & DESCRIPTOR_VALUE_MISSING) {
         return 0;
@@ -772,13 +772,13 @@ int climat_parse_x12 ( struct climat_chunks *c, struct bufr2tac_subset_state *s
 }
 
 /*!
-  \fn int temp_parse_x12 ( const struct temp_chunks *t, struct bufr2tac_subset_state *s )
+  \fn int temp_parse_x12 ( struct temp_chunks *t, struct bufr2tac_subset_state *s )
   \brief Parse a expanded descriptor with X = 12 (temperature)
   \param [in] t Pointer to struct \ref temp_chunks where to set the results
   \param [in,out] s Pointer to struct \ref bufr2tac_subset_state where is stored needed information in sequential analysis
   \return 0 if success, 1 if problems when processing. If a descriptor is not processed returns 0 anyway
 */
-int temp_parse_x12 ( const struct temp_chunks *t, struct bufr2tac_subset_state *s )
+int temp_parse_x12 ( struct temp_chunks *t, struct bufr2tac_subset_state *s )
 {
   if ( t == NULL )
     {
@@ -986,13 +986,13 @@ int syn_parse_x20(struct synop_chunks* syn, struct bufr2tac_subset_state* s)
 }
 
 /*!
-  \fn int buoy_parse_x20 ( const struct buoy_chunks *b, struct bufr2tac_subset_state *s )
+  \fn int buoy_parse_x20 ( struct buoy_chunks *b, struct bufr2tac_subset_state *s )
   \brief Parse a expanded descriptor with X = 20 (observed phenomena)
   \param [in] b Pointer to struct \ref buoy_chunks where to set the results
   \param [in,out] s Pointer to struct \ref bufr2tac_subset_state where is stored needed information in sequential analysis
   \return 0 if success, 1 if problems when processing. If a descriptor is not processed returns 0 anyway
 */
-int buoy_parse_x20(const struct buoy_chunks* b, struct bufr2tac_subset_state* s)
+int buoy_parse_x20(struct buoy_chunks* b, struct bufr2tac_subset_state* s)
 {
     if (s->a->mask & DESCRIPTOR_VALUE_MISSING) {
         return 0;
@@ -25,13 +25,13 @@
 
 
 /*!
-  \fn int syn_parse_x31 ( const struct synop_chunks *syn, struct bufr2tac_subset_state *s )
+  \fn int syn_parse_x31 ( struct synop_chunks *syn, struct bufr2tac_subset_state *s )
   \brief Parse a expanded descriptor with X = 31 (Control/Replication factors)
   \param [in] syn Pointer to a struct \ref synop_chunks where to set the results
   \param [in,out] s Pointer to a struct \ref bufr2tac_subset_state where is stored needed information in sequential analysis
   \return 0 on success, 1 if problems when processing. If a descriptor is not processed returns 0 anyway
 */
-int syn_parse_x31 ( const struct synop_chunks *syn, struct bufr2tac_subset_state *s )
+int syn_parse_x31 ( struct synop_chunks *syn, struct bufr2tac_subset_state *s )
 {
   
   if ( s->a->mask & DESCRIPTOR_VALUE_MISSING )
@@ -70,13 +70,13 @@ int syn_parse_x31 ( const struct synop_chunks *syn, struct bufr2tac_subset_state
 
 
 /*!
-  \fn int buoy_parse_x31 ( const struct buoy_chunks *b, struct bufr2tac_subset_state *s )
+  \fn int buoy_parse_x31 ( struct buoy_chunks *b, struct bufr2tac_subset_state *s )
   \brief Parse a expanded descriptor with X = 31 (Control/Replication factors)
   \param [in] b Pointer to a struct \ref buoy_chunks where to set the results
   \param [in,out] s Pointer to a struct \ref bufr2tac_subset_state where is stored needed information in sequential analysis
   \return 0 on success, 1 if problems when processing. If a descriptor is not processed returns 0 anyway
 */
-int buoy_parse_x31 ( const struct buoy_chunks *b, struct bufr2tac_subset_state *s )
+int buoy_parse_x31 ( struct buoy_chunks *b, struct bufr2tac_subset_state *s )
 {
   if ( s->a->mask & DESCRIPTOR_VALUE_MISSING )
     {
@@ -108,13 +108,13 @@ int buoy_parse_x31 ( const struct buoy_chunks *b, struct bufr2tac_subset_state *
 }
 
 /*!
-  \fn int temp_parse_x31 ( const struct temp_chunks *t, struct bufr2tac_subset_state *s )
+  \fn int temp_parse_x31 ( struct temp_chunks *t, struct bufr2tac_subset_state *s )
   \brief Parse a expanded descriptor with X = 31 (Control/Replication factors)
   \param [in] t Pointer to a struct \ref temp_chunks where to set the results
   \param [in,out] s Pointer to a struct \ref bufr2tac_subset_state where is stored needed information in sequential analysis
   \return 0 on success, 1 if problems when processing. If a descriptor is not processed returns 0 anyway
 */
-int temp_parse_x31 ( const struct temp_chunks *t, struct bufr2tac_subset_state *s )
+int temp_parse_x31 ( struct temp_chunks *t, struct bufr2tac_subset_state *s )
 {
   if ( s->a->mask & DESCRIPTOR_VALUE_MISSING )
     {
@@ -135,15 +135,12 @@ int temp_parse_x31 ( const struct temp_chunks *t, struct bufr2tac_subset_state *
       // It is supposed that it is the extended replicator used when describing
       // wind shear points in raiosonde
       // It is the amount of points of wind shear data at pressure level
-      if ( s->ival < TEMP_NMAX_POINTS )
+      if ( s->ival > 0 && bufr2tac_temp_raw_wind_shear_data_reserve ( s->w, ( size_t ) s->ival ) )
         {
-          s->itval = s->ival;
-          s->rep = 0;  // used to mark it is a share point in sequent descriptors
-        }
-      else
-        {
-          return 1;  // too much points
+          return 1;  // cannot allocate the points
         }
+      s->itval = s->ival;
+      s->rep = 0;  // used to mark it is a share point in sequent descriptors
       s->k_itval = s->i;
       s->w->n = 0;
       break;
@@ -153,6 +150,10 @@ int temp_parse_x31 ( const struct temp_chunks *t, struct bufr2tac_subset_state *
       // Temperature, dew-point and wind data at a pressure level with radiosonde position
       // So the integer value of repliactor IS the amount of points
       s->rep = s->ival; // replications and points we need. Also Used to mark this type of point
+      if ( s->rep > 0 && bufr2tac_temp_raw_data_reserve ( s->r, ( size_t ) s->rep ) )
+        {
+          return 1;  // cannot allocate the points
+        }
       s->itval = 0;
       s->k_rep = s->i;
       s->r->n = 0;
@@ -24,80 +24,103 @@
 #include "bufr2tac.h"
 
 /*!
-  \fn int print_xml_alphanum(FILE *f, const char *type, const char *alphanum, const struct metreport *m)
+  \fn static int print_xml_alphanum(struct bufr2tac_sink *s, const char *type, const struct bufr2tac_buffer *tac, const struct metreport *m)
   \brief Prints a single alphanumeric report in XML format
-  \param [in] f File pointer to output stream
+  \param [in,out] s Pointer to struct \ref bufr2tac_sink where to write
   \param [in] type Report type string
-  \param [in] alphanum Alphanumeric report string
+  \param [in] tac Pointer to struct \ref bufr2tac_buffer with the report
   \param [in] m Pointer to struct \ref metreport containing the data
   \return 0 on success
 */
-int print_xml_alphanum ( FILE *f, const char *type, const char *alphanum, const struct metreport *m )
+static int print_xml_alphanum ( struct bufr2tac_sink *s, const char *type, const struct bufr2tac_buffer *tac, const struct metreport *m )
 {
   // prints header
-  fprintf ( f, "<metreport type=%s>\n", type );
+  bufr2tac_sink_put_field ( s, "<metreport type=", type, ">\n" );
   // print GTS_HEADER
   if ( m->h != NULL )
     {
-      fprintf ( f, "<bufrfile>%s</bufrfile>\n",m->h->filename );
-      fprintf ( f, " <gts_header>%s %s %s %s</gts_header>\n",m->h->bname, m->h->center, m->h->dtrel, m->h->order );
+      bufr2tac_sink_put_field ( s, "<bufrfile>", m->h->filename, "</bufrfile>\n" );
+      bufr2tac_sink_put_field ( s, " <gts_header>", m->h->bname, " " );
+      bufr2tac_sink_put_field ( s, "", m->h->center, " " );
+      bufr2tac_sink_put_field ( s, "", m->h->dtrel, " " );
+      bufr2tac_sink_put_field ( s, "", m->h->order, "</gts_header>\n" );
     }
   // print DATE AND TIME
-  fprintf ( f, " <observation_datetime>%s</observation_datetime>\n",m->t.datime );
+  bufr2tac_sink_put_field ( s, " <observation_datetime>", m->t.datime, "</observation_datetime>\n" );
 
   // Geo data
-  fprintf ( f, " <geo>\n" );
+  bufr2tac_sink_puts ( s, " <geo>\n" );
   if ( strlen ( m->g.index ) )
     {
-      fprintf ( f, "  <index>%s</index>\n", m->g.index );
+      bufr2tac_sink_put_field ( s, "  <index>", m->g.index, "</index>\n" );
     }
   if ( strlen ( m->g.name ) )
     {
-      fprintf ( f, "  <name>%s</name>\n", m->g.name );
+      bufr2tac_sink_put_field ( s, "  <name>", m->g.name, "</name>\n" );
     }
   if ( strlen ( m->g.country ) )
     {
-      fprintf ( f, "  <country>%s</country>\n", m->g.country );
+      bufr2tac_sink_put_field ( s, "  <country>", m->g.country, "</country>\n" );
     }
-  fprintf ( f, "  <latitude>%.6lf</latitude>\n", m->g.lat );
-  fprintf ( f, "  <longitude>%.6lf</longitude>\n", m->g.lon );
-  fprintf ( f, "  <altitude>%.1lf</altitude>\n", m->g.alt );
-  fprintf ( f, " </geo>\n" );
-  fprintf ( f, " <report>%s=</report>\n", alphanum );
-  fprintf ( f, "</metreport>\n" );
-  return 0;
+  bufr2tac_sink_put_fixed ( s, "  <latitude>", m->g.lat, 6, "</latitude>\n" );
+  bufr2tac_sink_put_fixed ( s, "  <longitude>", m->g.lon, 6, "</longitude>\n" );
+  bufr2tac_sink_put_fixed ( s, "  <altitude>", m->g.alt, 1, "</altitude>\n" );
+  bufr2tac_sink_puts ( s, " </geo>\n" );
+  bufr2tac_sink_puts ( s, " <report>" );
+  bufr2tac_sink_write ( s, tac->s, tac->len );
+  bufr2tac_sink_puts ( s, "=</report>\n" );
+  bufr2tac_sink_puts ( s, "</metreport>\n" );
+  return s->error;
 }
 
 
 /*!
-  \fn int print_xml(FILE *f, const struct metreport *m)
+  \fn int bufr2tac_sink_print_xml(struct bufr2tac_sink *s, const struct metreport *m)
   \brief prints a struct \ref metreport in xml format
-  \param [in] f Pointer to a file already open by caller routine
+  \param [in,out] s Pointer to struct \ref bufr2tac_sink where to write
   \param [in] m Pointer to struct \ref metreport containing the data to print
   \return 0 on success
 */
-int print_xml ( FILE *f, const struct metreport *m )
+int bufr2tac_sink_print_xml ( struct bufr2tac_sink *s, const struct metreport *m )
 {
   // Single report
-  if ( m->alphanum[0] )
+  if ( m->tac[0].len )
     {
-      print_xml_alphanum ( f, m->type, m->alphanum, m );
+      print_xml_alphanum ( s, m->type, & ( m->tac[0] ), m );
     }
 
-  if ( m->alphanum2[0] ) //TTBB
+  if ( m->tac[1].len ) //TTBB
     {
-      print_xml_alphanum ( f, m->type2, m->alphanum2, m );
+      print_xml_alphanum ( s, m->type2, & ( m->tac[1] ), m );
     }
 
-  if ( m->alphanum3[0] ) //TTCC
+  if ( m->tac[2].len ) //TTCC
     {
-      print_xml_alphanum ( f, m->type3, m->alphanum3, m );
+      print_xml_alphanum ( s, m->type3, & ( m->tac[2] ), m );
     }
 
-  if ( m->alphanum4[0] ) //TTDD
+  if ( m->tac[3].len ) //TTDD
     {
-      print_xml_alphanum ( f, m->type4, m->alphanum4, m );
+      print_xml_alphanum ( s, m->type4, & ( m->tac[3] ), m );
     }
 
-  return 0;
+  return s->error;
+}
+
+/*!
+  \fn int print_xml(FILE *f, const struct metreport *m)
+  \brief prints a struct \ref metreport in xml format
+  \param [in] f Pointer to a file already open by caller routine
+  \param [in] m Pointer to struct \ref metreport containing the data to print
+  \return 0 on success
+*/
+int print_xml ( FILE *f, const struct metreport *m )
+{
+  struct bufrdeco_output_buffer ob;
+  struct bufr2tac_sink s;
+
+  if ( bufrdeco_out_init ( &ob, f ) || bufr2tac_sink_set_output_buffer ( &s, &ob ) )
+    return 1;
+  bufr2tac_sink_print_xml ( &s, m );
+  return bufr2tac_sink_flush ( &s ) || s.error;
 }
@@ -139,7 +139,7 @@
 
 /*!
   \def RAW_TEMP_NMAX_POINTS
-  \brief maximum number of raw points points
+  \brief Initial dimension of arrays of raw points. They grow when a replicator asks for more points
 */
 #define RAW_TEMP_NMAX_POINTS (TEMP_NMAX_POINTS * 4)
 
@@ -212,7 +212,8 @@ struct temp_raw_point_data
 struct temp_raw_data
 {
   size_t n; /*!< Current number of elements */
-  struct temp_raw_point_data raw[TEMP_NMAX_POINTS * 4]; /*!< Array of raw data points */
+  size_t dim; /*!< Allocated elements in \a raw */
+  struct temp_raw_point_data *raw; /*!< Array of raw data points */
 };
 
 /*!
@@ -237,7 +238,8 @@ struct temp_raw_wind_shear_point
 struct temp_raw_wind_shear_data
 {
   size_t n; /*!< Current number of elements */
-  struct temp_raw_wind_shear_point raw[TEMP_NMAX_POINTS];
+  size_t dim; /*!< Allocated elements in \a raw */
+  struct temp_raw_wind_shear_point *raw; /*!< Array of wind shear points */
 };
 
 /*!